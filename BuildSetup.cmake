@@ -71,6 +71,21 @@ else()
     message( ERROR "CMAKE_SYSTEM_NAME = ${CMAKE_SYSTEM_NAME}, not supported. Currently supported: Linux, Darwin, SunOS, Windows" )
 endif()
 
+#----------------------------------------
+# When doing a debug build, optionally enable the
+# thread sanitizer.  This is used to check code that is meant to be
+# used from multiple threads, e.g. a frozen NavLibrary.  It can't be
+# combined with the address sanitizer, which is disabled in this case.
+#----------------------------------------
+if( (${CMAKE_BUILD_TYPE} MATCHES "debug") AND (${THREAD_SANITIZER} MATCHES "ON") )
+    if (${CMAKE_CXX_COMPILER_ID} MATCHES "Clang"
+        OR ((${CMAKE_CXX_COMPILER_VERSION} VERSION_GREATER "4.9.0" ) AND CMAKE_COMPILER_IS_GNUCXX))
+        message(STATUS "Enabling thread sanitizer for debug build")
+        set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=thread -fno-omit-frame-pointer" )
+        set( ADDRESS_SANITIZER OFF )
+    endif()
+endif()
+
 #----------------------------------------
 # When doing a debug build, enable the
 # address sanitizer. This has a 2x slowdown
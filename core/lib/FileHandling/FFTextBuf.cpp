@@ -0,0 +1,266 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file FFTextBuf.cpp
+ * A read-only stream buffer for reading text files a line at a time.
+ */
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "FFTextBuf.hpp"
+
+namespace gnsstk
+{
+   FFTextBuf ::
+   FFTextBuf()
+         : blockPos(0), addr(nullptr), len(0)
+   {
+   }
+
+
+   FFTextBuf ::
+   ~FFTextBuf()
+   {
+      close();
+   }
+
+
+   bool FFTextBuf ::
+   open(const std::string& fn, bool mapFile)
+   {
+      close();
+#ifndef _WIN32
+      if (mapFile)
+      {
+         int fd = ::open(fn.c_str(), O_RDONLY);
+         if (fd < 0)
+            return false;
+         struct stat st;
+         if (::fstat(fd, &st) != 0)
+         {
+            ::close(fd);
+            return false;
+         }
+            // mmap refuses empty files, which are read normally instead
+         void *p = MAP_FAILED;
+         if (st.st_size > 0)
+         {
+               // MAP_PRIVATE as nothing is ever shared.  Note that
+               // this does not prevent SIGBUS on truncation.
+            p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         }
+            // the mapping remains valid after closing.
+         ::close(fd);
+         if (p != MAP_FAILED)
+         {
+            addr = static_cast<char*>(p);
+            len = st.st_size;
+               // lines are read front to back
+            ::madvise(p, len, MADV_SEQUENTIAL);
+               // The mapping is read-only, but std::streambuf wants
+               // char*.  There is no put area, so nothing is ever
+               // written to it.
+            setg(addr, addr, addr+len);
+            return true;
+         }
+         else if (st.st_size > 0)
+         {
+            return false;
+         }
+      }
+#endif
+         // Read the file directly into block rather than through
+         // the filebuf's own buffer.
+      file.pubsetbuf(nullptr, 0);
+      if (file.open(fn.c_str(), std::ios::in | std::ios::binary) == nullptr)
+         return false;
+      block.resize(blockSize);
+      setg(block.data(), block.data(), block.data());
+      return true;
+   }
+
+
+   void FFTextBuf ::
+   close()
+   {
+#ifndef _WIN32
+      if (addr != nullptr)
+         ::munmap(addr, len);
+#endif
+      addr = nullptr;
+      len = 0;
+      if (file.is_open())
+         file.close();
+      std::vector<char>().swap(block);
+      blockPos = 0;
+      setg(nullptr, nullptr, nullptr);
+   }
+
+
+   bool FFTextBuf ::
+   getLastLine(const char*& line, size_t& len, bool& terminated)
+   {
+      size_t scanned = egptr() - gptr();
+      while (fill())
+      {
+         char *nl = static_cast<char*>(
+            std::memchr(gptr()+scanned, '\n', egptr()-gptr()-scanned));
+         if (nl != nullptr)
+         {
+            terminated = true;
+            line = gptr();
+            len = nl - gptr();
+            setg(eback(), nl+1, egptr());
+            return true;
+         }
+         scanned = egptr() - gptr();
+      }
+      if (gptr() == egptr())
+         return false;
+      terminated = false;
+      line = gptr();
+      len = egptr() - gptr();
+      setg(eback(), egptr(), egptr());
+      return true;
+   }
+
+
+   bool FFTextBuf ::
+   fill()
+   {
+      if (!file.is_open())
+         return false;
+      size_t keep = egptr() - gptr();
+      blockPos += gptr() - eback();
+      std::memmove(block.data(), gptr(), keep);
+      if (keep == block.size())
+         block.resize(2 * block.size());
+      std::streamsize got = file.sgetn(block.data() + keep,
+                                       block.size() - keep);
+      if (got < 0)
+         got = 0;
+      setg(block.data(), block.data(), block.data() + keep + got);
+      return (got > 0);
+   }
+
+
+   FFTextBuf::int_type FFTextBuf ::
+   underflow()
+   {
+      if ((gptr() == egptr()) && !fill())
+         return traits_type::eof();
+      return traits_type::to_int_type(*gptr());
+   }
+
+
+   FFTextBuf::pos_type FFTextBuf ::
+   seekoff(off_type off, std::ios_base::seekdir dir,
+           std::ios_base::openmode which)
+   {
+      if (which & std::ios_base::out)
+         return pos_type(off_type(-1));
+      if (!isMapped() && !file.is_open())
+         return pos_type(off_type(-1));
+      off_type loaded = egptr() - eback();
+      off_type base;
+      switch (dir)
+      {
+         case std::ios_base::beg:
+            base = 0;
+            break;
+         case std::ios_base::cur:
+            base = blockPos + (gptr()-eback());
+            break;
+         case std::ios_base::end:
+            if (isMapped())
+            {
+               base = len;
+            }
+            else
+            {
+                  // The file position is left where the next block
+                  // will be read from.
+               base = file.pubseekoff(0, std::ios_base::end,
+                                      std::ios_base::in);
+               if ((base < 0) ||
+                   (file.pubseekoff(blockPos + loaded, std::ios_base::beg,
+                                    std::ios_base::in) < 0))
+               {
+                  return pos_type(off_type(-1));
+               }
+            }
+            break;
+         default:
+            return pos_type(off_type(-1));
+      }
+      off_type pos = base + off;
+      if ((pos < 0) || (isMapped() && (pos > off_type(len))))
+         return pos_type(off_type(-1));
+      if ((pos >= blockPos) && (pos <= blockPos + loaded))
+      {
+            // already in memory
+         setg(eback(), eback() + (pos-blockPos), egptr());
+         return pos_type(pos);
+      }
+      if (file.pubseekoff(pos, std::ios_base::beg, std::ios_base::in) < 0)
+         return pos_type(off_type(-1));
+      blockPos = pos;
+      setg(block.data(), block.data(), block.data());
+      return pos_type(pos);
+   }
+
+
+   FFTextBuf::pos_type FFTextBuf ::
+   seekpos(pos_type pos, std::ios_base::openmode which)
+   {
+      return seekoff(off_type(pos), std::ios_base::beg, which);
+   }
+
+
+   std::streamsize FFTextBuf ::
+   showmanyc()
+   {
+         // A mapping's get area already holds everything there is.
+      return (isMapped() ? -1 : 0);
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,182 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file FFTextBuf.hpp
+ * A read-only stream buffer for reading text files a line at a time.
+ */
+
+#ifndef GNSSTK_FFTEXTBUF_HPP
+#define GNSSTK_FFTEXTBUF_HPP
+
+#include <cstring>
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace gnsstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * A std::streambuf for reading a text file that can hand out
+       * lines in place with getLine(), so reading a line does not
+       * copy it through std::filebuf's buffer and then into a
+       * std::string.
+       *
+       * By default, the file is read in large blocks into memory
+       * owned by the buffer.  A line that crosses the end of a block
+       * is moved to the start of the next one, and the block grows
+       * as needed for lines longer than a block.  Data appended to
+       * the file while it is being read is seen as it would be with
+       * std::filebuf, and a file truncated while it is being read
+       * simply ends early.
+       *
+       * Optionally, the file can instead be memory mapped where the
+       * platform supports it, which saves copying the file into
+       * memory at all.  The mapping is made when open() is called
+       * and reflects the size of the file at that time.
+       * @warning A mapped file must not be truncated while it is
+       *   open.  The operating system signals SIGBUS (and so
+       *   terminates the program) on any access to a page of the
+       *   mapping that is past the new end of the file, which can't
+       *   be detected beforehand or reported as an error.  This is
+       *   why mapping is only used when requested.
+       *
+       * The buffer is input-only.  It is used by FFTextStream, see
+       * FFTextStream::bufferInput().
+       */
+   class FFTextBuf : public std::streambuf
+   {
+   public:
+         /// Size of the blocks the file is read in when not mapped.
+      static const size_t blockSize = 256 * 1024;
+
+         /// Create a buffer with no contents.
+      FFTextBuf();
+
+         /// Close the file, if any.
+      virtual ~FFTextBuf();
+
+         /** Open a file for reading, closing any previous file.
+          * @param[in] fn The path of the file to open.
+          * @param[in] mapFile If true, memory map the file rather
+          *   than reading it in blocks.  This is ignored on
+          *   platforms without mmap.  See the warning in the class
+          *   description.
+          * @return true if the file was opened, false if not, in
+          *   which case the buffer is left empty. */
+      bool open(const std::string& fn, bool mapFile = false);
+
+         /// Close the file, if any, leaving the buffer empty.
+      void close();
+
+         /// Return true if the open file is memory mapped.
+      bool isMapped() const
+      { return addr != nullptr; }
+
+         /** Get the next line from the buffer without copying it.
+          * @param[out] line Set to the start of the line.
+          * @param[out] len Set to the length of the line, not
+          *   including the terminating newline.
+          * @param[out] terminated Set to false if the line ended at
+          *   the end of the file rather than at a newline.
+          * @return false if there was nothing left to read. */
+      bool getLine(const char*& line, size_t& len, bool& terminated)
+      {
+         char *start = gptr(), *end = egptr();
+         char *nl = nullptr;
+         if (start != end)
+            nl = static_cast<char*>(std::memchr(start, '\n', end-start));
+         if (nl == nullptr)
+            return getLastLine(line, len, terminated);
+         terminated = true;
+         line = start;
+         len = nl - start;
+         setg(eback(), nl+1, end);
+         return true;
+      }
+
+   protected:
+         /** Read the next block of the file when the get area is
+          * exhausted, as std::streambuf::underflow. */
+      virtual int_type underflow();
+
+         /// Position the get area, as std::streambuf::seekoff.
+      virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                               std::ios_base::openmode which);
+
+         /// Position the get area, as std::streambuf::seekpos.
+      virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+         /** Indicate whether anything is available past the get
+          * area, as std::streambuf::showmanyc. */
+      virtual std::streamsize showmanyc();
+
+   private:
+         /** Handle the rest of getLine() when the get area holds no
+          * complete line, reading more of the file as needed. */
+      bool getLastLine(const char*& line, size_t& len, bool& terminated);
+
+         /** Keep the unread part of the get area, moving it to the
+          * start of block, and append as much of the file as fits
+          * after it, growing block if it is already full.
+          * @return false if nothing more could be read. */
+      bool fill();
+
+         /// The file being read in blocks, when not mapped.
+      std::filebuf file;
+         /// Storage for the blocks read from file.
+      std::vector<char> block;
+         /// The offset in the file of the start of the get area.
+      off_type blockPos;
+         /// The start of the mapped file, or nullptr if not mapped.
+      char *addr;
+         /// The size of the mapped file.
+      size_t len;
+         // no copying
+      FFTextBuf(const FFTextBuf&) = delete;
+      FFTextBuf& operator=(const FFTextBuf&) = delete;
+   }; // class FFTextBuf
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_FFTEXTBUF_HPP
@@ -0,0 +1,175 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file FFTextLine.hpp
+ * A non-owning view of a line of text read by FFTextStream.
+ */
+
+#ifndef GNSSTK_FFTEXTLINE_HPP
+#define GNSSTK_FFTEXTLINE_HPP
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "FixedField.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * A read-only view of a line of text, or of a range of columns
+       * in one.  The characters are not copied, so the view is only
+       * valid as long as the storage it refers to, which for lines
+       * returned by FFTextStream::formattedGetLine() is until the
+       * next line is read from the stream.
+       *
+       * This is meant for parsing fixed-width records without
+       * creating a temporary std::string for every field.  The
+       * numeric conversions are done by FixedField, which gives the
+       * same results as StringUtils::asDouble() and
+       * StringUtils::asInt() on the equivalent std::string, but
+       * also accepts FORTRAN 'D' exponents.
+       */
+   class FFTextLine
+   {
+   public:
+         /// Create an empty view.
+      FFTextLine()
+            : ptr(""), len(0)
+      {}
+
+         /** Create a view of a range of characters.
+          * @param[in] p The first character in the view.
+          * @param[in] n The number of characters in the view. */
+      FFTextLine(const char* p, size_t n)
+            : ptr(p), len(n)
+      {}
+
+         /** Create a view of the contents of a string.
+          * @param[in] s The string to refer to, which must outlive
+          *   the view and not be modified while it is in use. */
+      FFTextLine(const std::string& s)
+            : ptr(s.data()), len(s.size())
+      {}
+
+         /// Return a pointer to the first character in the view.
+      const char* data() const
+      { return ptr; }
+
+         /// Return the number of characters in the view.
+      size_t size() const
+      { return len; }
+
+         /// Return the number of characters in the view.
+      size_t length() const
+      { return len; }
+
+         /// Return true if the view contains no characters.
+      bool empty() const
+      { return len == 0; }
+
+         /// Return the character at index i, which is not range checked.
+      char operator[](size_t i) const
+      { return ptr[i]; }
+
+         /** Return a view of a range of columns, like std::string::substr.
+          * @param[in] pos The index of the first character.
+          * @param[in] n The maximum number of characters, which is
+          *   reduced to fit in the view.
+          * @throw std::out_of_range if pos is past the end of the view. */
+      FFTextLine substr(size_t pos, size_t n = std::string::npos) const
+      {
+         if (pos > len)
+            throw std::out_of_range("FFTextLine::substr");
+         return FFTextLine(ptr+pos, (n < len-pos) ? n : len-pos);
+      }
+
+         /// Return a copy of the contents of the view as a std::string.
+      std::string str() const
+      { return std::string(ptr, len); }
+
+         /// Remove the trailing blanks from the view.
+      FFTextLine& stripTrailing()
+      {
+         while ((len > 0) && (ptr[len-1] == ' '))
+            len--;
+         return *this;
+      }
+
+         /// Return true if the view contains nothing but blanks.
+      bool isBlank() const
+      {
+         for (size_t i = 0; i < len; i++)
+         {
+            if (ptr[i] != ' ')
+               return false;
+         }
+         return true;
+      }
+
+         /// Return true if the view has the same contents as s.
+      bool operator==(const char* s) const
+      { return (std::strlen(s) == len) && (std::memcmp(ptr, s, len) == 0); }
+
+         /** Convert the contents of the view to a double.
+          * @param[in] impliedDecimals The number of implied digits
+          *   to the right of the decimal point.
+          * @see FixedField::asDouble() */
+      double asDouble(unsigned impliedDecimals = 0) const
+      { return FixedField::asDouble(ptr, ptr+len, impliedDecimals); }
+
+         /// Convert the contents of the view to an integer, as strtol.
+      long asInt() const
+      { return FixedField::asInt(ptr, ptr+len); }
+
+   private:
+         /// The first character in the view.
+      const char *ptr;
+         /// The number of characters in the view.
+      size_t len;
+   }; // class FFTextLine
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_FFTEXTLINE_HPP
@@ -47,6 +47,7 @@ namespace gnsstk
 {
    FFTextStream ::
    FFTextStream()
+         : openMode(std::ios::in)
    {
       init();
    }
@@ -55,13 +56,15 @@ namespace gnsstk
    FFTextStream ::
    ~FFTextStream()
    {
+      unbufferInput();
    }
 
 
    FFTextStream ::
    FFTextStream( const char* fn,
                  std::ios::openmode mode )
-         : FFStream(fn, mode)
+         : FFStream(fn, mode),
+           openMode(mode)
    {
       init();
    }
@@ -70,7 +73,8 @@ namespace gnsstk
    FFTextStream ::
    FFTextStream( const std::string& fn,
                  std::ios::openmode mode )
-         : FFStream( fn.c_str(), mode )
+         : FFStream( fn.c_str(), mode ),
+           openMode(mode)
    {
       init();
    }
@@ -80,7 +84,10 @@ namespace gnsstk
    open( const char* fn,
          std::ios::openmode mode )
    {
+         // the file stream must be using its own buffer before reopening
+      unbufferInput();
       FFStream::open(fn, mode);
+      openMode = mode;
       init();
    }
 
@@ -100,6 +107,38 @@ namespace gnsstk
    }
 
 
+   bool FFTextStream ::
+   bufferInput(bool mapFile)
+   {
+      if (isInputBuffered())
+         return true;
+      if (!is_open() || (openMode & std::ios::out) || !good())
+         return false;
+      std::streampos pos = tellg();
+      if ((pos == std::streampos(-1)) || !textBuf.open(filename, mapFile))
+         return false;
+      if (textBuf.pubseekpos(pos, std::ios::in) != pos)
+      {
+         textBuf.close();
+         return false;
+      }
+         // std::fstream::rdbuf() can't be used to replace the buffer
+      std::ios::rdbuf(&textBuf);
+      return true;
+   }
+
+
+   void FFTextStream ::
+   unbufferInput()
+   {
+      if (isInputBuffered())
+      {
+         std::ios::rdbuf(std::fstream::rdbuf());
+      }
+      textBuf.close();
+   }
+
+
    void FFTextStream ::
    tryFFStreamGet(FFData& rec)
    {
@@ -149,6 +188,13 @@ namespace gnsstk
    formattedGetLine( std::string& line,
                      const bool expectEOF )
    {
+      if (isInputBuffered())
+      {
+         FFTextLine view;
+         formattedGetLine(view, expectEOF);
+         line.assign(view.data(), view.size());
+         return;
+      }
       try
       {
          std::getline(*this, line);
@@ -158,7 +204,10 @@ namespace gnsstk
             line.erase(crpos+1);
          for (int i=0; i<line.length(); i++)
          {
-            if (!isprint(line[i]))
+               // ' ' through '~' are printable in every locale,
+               // so only check anything else with isprint.
+            unsigned char c = line[i];
+            if (((c < ' ') || (c > '~')) && !isprint(line[i]))
             {
                FFStreamError err("Non-text data in file.");
                GNSSTK_THROW(err);
@@ -211,4 +260,93 @@ namespace gnsstk
       }
    }  // End of method 'FFTextStream::formattedGetLine()'
 
+
+      // This follows formattedGetLine(std::string&,const bool) as
+      // closely as possible, including the state of the stream
+      // afterwards, so that parsers may use either.
+   void FFTextStream ::
+   formattedGetLine( FFTextLine& line,
+                     const bool expectEOF )
+   {
+      if (!isInputBuffered())
+      {
+            // std::getline leaves the string alone at EOF
+         lineBuffer.clear();
+         formattedGetLine(lineBuffer, expectEOF);
+         line = FFTextLine(lineBuffer);
+         return;
+      }
+      line = FFTextLine();
+      try
+      {
+         const char *text;
+         size_t len;
+         bool terminated;
+         if (textBuf.getLine(text, len, terminated))
+         {
+               // Remove CR characters left over from windows files
+            while ((len > 0) && (text[len-1] == '\r'))
+               len--;
+            line = FFTextLine(text, len);
+               // std::getline sets eofbit when there's no newline
+            if (!terminated)
+               setstate(std::ios::eofbit);
+            for (size_t i = 0; i < len; i++)
+            {
+                  // ' ' through '~' are printable in every locale,
+                  // so only check anything else with isprint.
+               unsigned char c = text[i];
+               if (((c < ' ') || (c > '~')) && !isprint(text[i]))
+               {
+                  FFStreamError err("Non-text data in file.");
+                  GNSSTK_THROW(err);
+               }
+            }
+         }
+         else
+         {
+               // std::getline fails when there is nothing to extract
+            setstate(std::ios::eofbit | std::ios::failbit);
+         }
+         lineNumber++;
+            // catch EOF when stream exceptions are disabled
+         if ((line.size() == 0) && eof())
+         {
+            if (expectEOF)
+            {
+               EndOfFile err("EOF encountered");
+               GNSSTK_THROW(err);
+            }
+            else
+            {
+               FFStreamError err("Unexpected EOF encountered");
+               GNSSTK_THROW(err);
+            }
+         }
+      }
+      catch(std::exception &e)
+      {
+            // catch EOF when exceptions are enabled
+         if ( (line.size() == 0) && eof())
+         {
+            if (expectEOF)
+            {
+               EndOfFile err("EOF encountered");
+               GNSSTK_THROW(err);
+            }
+            else
+            {
+               FFStreamError err("Unexpected EOF");
+               GNSSTK_THROW(err);
+            }
+         }
+         else
+         {
+            FFStreamError err("Critical file error: " +
+                              std::string(e.what()));
+            GNSSTK_THROW(err);
+         }
+      }
+   }  // End of method 'FFTextStream::formattedGetLine()'
+
 }  // End of namespace gnsstk
@@ -45,6 +45,8 @@
 #define GNSSTK_FFTEXTSTREAM_HPP
 
 #include "FFStream.hpp"
+#include "FFTextBuf.hpp"
+#include "FFTextLine.hpp"
 
 namespace gnsstk
 {
@@ -59,6 +61,12 @@ namespace gnsstk
        * update the line number - the derived class or programmer
        * needs to make sure that the reader or writer increments
        * lineNumber in these cases.
+       *
+       * Input streams can optionally be switched to reading through
+       * an FFTextBuf with bufferInput(), and the FFTextLine overload
+       * of formattedGetLine() then returns lines without copying
+       * them, which together make parsing large files considerably
+       * cheaper.
        */
    class FFTextStream : public FFStream
    {
@@ -85,11 +93,11 @@ namespace gnsstk
       FFTextStream( const std::string& fn,
                     std::ios::openmode mode=std::ios::in );
 
-         /// Overrides open to reset the line number.
+         /// Overrides open to reset the line number and input buffer.
       virtual void open( const char* fn,
                          std::ios::openmode mode );
 
-         /// Overrides open to reset the line number.
+         /// Overrides open to reset the line number and input buffer.
       virtual void open( const std::string& fn,
                          std::ios::openmode mode );
 
@@ -118,6 +126,46 @@ namespace gnsstk
       void formattedGetLine( std::string& line,
                              const bool expectEOF = false );
 
+         /**
+          * As formattedGetLine(std::string&,const bool), but sets \a
+          * line to refer to the text of the line rather than copying
+          * it.  The view is only valid until the next line is read
+          * or the stream is reopened.
+          * @param[out] line is set to refer to the line read from the
+          *   file.
+          * @param[in] expectEOF set true if finding EOF on this read
+          *   is acceptable.
+          * @throw EndOfFile if \a expectEOF is true and an EOF is encountered.
+          * @throw FFStreamError if EOF is found and \a expectEOF is false
+          */
+      void formattedGetLine( FFTextLine& line,
+                             const bool expectEOF = false );
+
+         /**
+          * Switch an open input stream to read the remainder of the
+          * file through an FFTextBuf instead of through std::filebuf.
+          * Reading continues from the current position, and the
+          * stream otherwise behaves as before, including tellg() and
+          * seekg().  The FFTextBuf is closed when the stream is
+          * reopened.
+          * @param[in] mapFile If true, memory map the file rather
+          *   than reading it in blocks.  A mapped file must not be
+          *   truncated while it is being read, see FFTextBuf.
+          * @return true if the stream is now reading through an
+          *   FFTextBuf, false if the file could not be opened (or
+          *   mapped) again, in which case it is left reading through
+          *   std::filebuf.
+          */
+      bool bufferInput(bool mapFile = false);
+
+         /// Return true if the stream is reading through an FFTextBuf.
+      bool isInputBuffered() const
+      { return std::ios::rdbuf() == &textBuf; }
+
+         /// Return true if the stream is reading from a memory mapping.
+      bool isInputMapped() const
+      { return isInputBuffered() && textBuf.isMapped(); }
+
 
    protected:
 
@@ -137,6 +185,16 @@ namespace gnsstk
          /// Initialize internal data structures
       void init();
 
+         /// Revert to reading through std::filebuf and close textBuf.
+      void unbufferInput();
+
+         /// The mode the stream was last opened with.
+      std::ios::openmode openMode;
+         /// Buffer for the file, when bufferInput() has been used.
+      FFTextBuf textBuf;
+         /// Storage for lines returned as views when not buffered.
+      std::string lineBuffer;
+
    }; // End of class 'FFTextStream'
 
       //@}
@@ -46,6 +46,7 @@
 #include "RinexClockHeader.hpp"
 #include "RinexClockStream.hpp"
 #include "StringUtils.hpp"
+#include "FixedField.hpp"
 #include "FFStream.hpp"
 #include "FFStreamError.hpp"
 
@@ -183,7 +184,7 @@ namespace gnsstk
 
       epochTime = parseTime(line.substr(8,26));
 
-      dvCount = asInt(line.substr(34,3));
+      dvCount = FixedField::asInt(line, 34, 3);
       if ( dvCount < 1 || dvCount > 6 )
       {
             // invalid dvCount - throw
@@ -117,7 +117,7 @@ namespace gnsstk
 
       RinexMetHeader& hdr = strm.header;
 
-      string line;
+      FFTextLine line;
       data.clear();
 
          // this is to see whether or not we expect an EOF
@@ -147,7 +147,7 @@ namespace gnsstk
       }
    }
 
-   void RinexMetData::processFirstLine(const string& line,
+   void RinexMetData::processFirstLine(const FFTextLine& line,
                                        const RinexMetHeader& hdr,
                                        double version)
    {
@@ -163,7 +163,7 @@ namespace gnsstk
               i++)
          {
             int currPos = 7*i + yrLen;
-            data[hdr.obsTypeList[i]] = asDouble(line.substr(currPos,7));
+            data[hdr.obsTypeList[i]] = line.substr(currPos,7).asDouble();
          }
       }
       catch (std::exception &e)
@@ -173,7 +173,7 @@ namespace gnsstk
       }
    }
 
-   void RinexMetData::processContinuationLine(const string& line,
+   void RinexMetData::processContinuationLine(const FFTextLine& line,
                                               const RinexMetHeader& hdr)
    {
       try
@@ -185,7 +185,7 @@ namespace gnsstk
               i++)
          {
             int currPos = 7*((i - maxObsPerLine) % maxObsPerContinuationLine) + 4;
-            data[hdr.obsTypeList[i]] = asDouble(line.substr(currPos,7));
+            data[hdr.obsTypeList[i]] = line.substr(currPos,7).asDouble();
          }
       }
       catch (std::exception &e)
@@ -195,7 +195,8 @@ namespace gnsstk
       }
    }
 
-   CommonTime RinexMetData::parseTime(const string& line, double version) const
+   CommonTime RinexMetData::parseTime(const FFTextLine& line,
+                                      double version) const
    {
       int addYrLen = 0;
       if(version >=3.02)
@@ -226,12 +227,12 @@ namespace gnsstk
          int year, month, day, hour, min;
          double sec;
 
-         year  = asInt(line.substr(1, 2+addYrLen));
-         month = asInt(line.substr(3+addYrLen, 3));
-         day   = asInt(line.substr(6+addYrLen, 3));
-         hour  = asInt(line.substr(9+addYrLen, 3));
-         min   = asInt(line.substr(12+addYrLen,3));
-         sec   = asInt(line.substr(15+addYrLen,3));
+         year  = line.substr(1, 2+addYrLen).asInt();
+         month = line.substr(3+addYrLen, 3).asInt();
+         day   = line.substr(6+addYrLen, 3).asInt();
+         hour  = line.substr(9+addYrLen, 3).asInt();
+         min   = line.substr(12+addYrLen,3).asInt();
+         sec   = line.substr(15+addYrLen,3).asInt();
 
          if(!addYrLen)
          {
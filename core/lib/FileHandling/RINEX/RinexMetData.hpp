@@ -48,6 +48,7 @@
 
 #include "CommonTime.hpp"
 #include "FFStream.hpp"
+#include "FFTextLine.hpp"
 #include "RinexMetBase.hpp"
 #include "RinexMetHeader.hpp"
 #include "gnsstk_export.h"
@@ -137,21 +138,21 @@ namespace gnsstk
           * @param version of Rinex file (3.02, 3.01, 2.11, ...)
           * @throw FFStreamError
           */
-      void processFirstLine(const std::string& line,
+      void processFirstLine(const FFTextLine& line,
                             const RinexMetHeader& hdr,
                             double version);
 
          /** Parses string \a line to get data on continuation lines.
           * @throw FFStreamError
           */
-      void processContinuationLine(const std::string& line,
+      void processContinuationLine(const FFTextLine& line,
                                    const RinexMetHeader& hdr);
 
          /** Parses the time portion of a line into a CommonTime object.
           * @param version of Rinex file (3.02, 3.01, 2.11, ...)
           * @throw FFStreamError
           */
-      CommonTime parseTime(const std::string& line, double version) const;
+      CommonTime parseTime(const FFTextLine& line, double version) const;
 
          /** Writes the CommonTime object into RINEX format. If it's a
           * bad time, it will return blanks.
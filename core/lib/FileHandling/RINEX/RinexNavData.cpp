@@ -42,6 +42,7 @@
  */
 
 #include "StringUtils.hpp"
+#include "FixedField.hpp"
 
 #include "CommonTime.hpp"
 #include "CivilTime.hpp"
@@ -233,14 +234,14 @@ namespace gnsstk
             if (currentLine[i] != ' ')
                throw(FFStreamError("Badly formatted line"));
 
-         PRNID = asInt(currentLine.substr(0,2));
+         PRNID = FixedField::asInt(currentLine, 0, 2);
 
-         short yr = asInt(currentLine.substr(2,3));
-         short mo = asInt(currentLine.substr(5,3));
-         short day = asInt(currentLine.substr(8,3));
-         short hr = asInt(currentLine.substr(11,3));
-         short min = asInt(currentLine.substr(14,3));
-         double sec = asDouble(currentLine.substr(17,5));
+         short yr = FixedField::asInt(currentLine, 2, 3);
+         short mo = FixedField::asInt(currentLine, 5, 3);
+         short day = FixedField::asInt(currentLine, 8, 3);
+         short hr = FixedField::asInt(currentLine, 11, 3);
+         short min = FixedField::asInt(currentLine, 14, 3);
+         double sec = FixedField::asDouble(currentLine, 17, 5);
 
             // years 80-99 represent 1980-1999
          const int rolloverYear = 80;
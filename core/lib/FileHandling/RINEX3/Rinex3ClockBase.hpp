@@ -71,6 +71,10 @@ namespace gnsstk
             /// Assign a value by decoding a string using existing formatting.
          R3CDouble& operator=(const std::string& s)
          { FormattedDouble::operator=(s); return *this; }
+
+            /// Assign a value, keeping the existing formatting.
+         R3CDouble& operator=(double d)
+         { FormattedDouble::operator=(d); return *this; }
       };
 
          /// Destructor per the coding standards
@@ -127,17 +127,17 @@ namespace gnsstk
 
       clear();
 
-      string line;
+      FFTextLine line;
       strm.formattedGetLine(line,true);      // true means 'expect possible EOF'
-      stripTrailing(line);
+      line.stripTrailing();
       if (line.length() < 59) {
-         FFStreamError e("Short line : " + line);
+         FFStreamError e("Short line : " + line.str());
          GNSSTK_THROW(e);
       }
 
          //cout << "Data Line: /" << line << "/" << endl;
-      datatype = line.substr(0,2);
-      site = line.substr(3,4);
+      datatype = line.substr(0,2).str();
+      site = line.substr(3,4).str();
       if (datatype == string("AS"))
       {
          strip(site);
@@ -154,35 +154,35 @@ namespace gnsstk
          site = string();
       }
 
-      time = CivilTime(asInt(line.substr( 8,4)),
-                       asInt(line.substr(12,3)),
-                       asInt(line.substr(15,3)),
-                       asInt(line.substr(18,3)),
-                       asInt(line.substr(21,3)),
-                       asDouble(line.substr(24,10)),
+      time = CivilTime(line.substr(8,4).asInt(),
+                       line.substr(12,3).asInt(),
+                       line.substr(15,3).asInt(),
+                       line.substr(18,3).asInt(),
+                       line.substr(21,3).asInt(),
+                       line.substr(24,10).asDouble(),
                        TimeSystem::Any);
 
-      int n(asInt(line.substr(34,3)));
-      bias = line.substr(40,19);
+      int n(line.substr(34,3).asInt());
+      bias = line.substr(40,19).asDouble();
       if (n > 1 && line.length() >= 59)
-         sig_bias = line.substr(60,19);
+         sig_bias = line.substr(60,19).asDouble();
 
       if (n > 2)
       {
          strm.formattedGetLine(line,true);
-         stripTrailing(line);
+         line.stripTrailing();
          if (int(line.length()) < (n-2)*20-1)
          {
-            FFStreamError e("Short line : " + line);
+            FFStreamError e("Short line : " + line.str());
             GNSSTK_THROW(e);
          }
-         drift =     line.substr( 0,19);
+         drift =     line.substr( 0,19).asDouble();
          if (n > 3)
-            sig_drift = line.substr(20,19);
+            sig_drift = line.substr(20,19).asDouble();
          if (n > 4)
-            accel     = line.substr(40,19);
+            accel     = line.substr(40,19).asDouble();
          if (n > 5)
-            sig_accel = line.substr(60,19);
+            sig_accel = line.substr(60,19).asDouble();
       }
 
    }   // end reallyGetRecord()
@@ -749,7 +749,7 @@ namespace gnsstk
          short yr,mo,day,hr,min;
          double dsec;
 
-         string line;
+         FFTextLine line;
          while(line.empty()) // ignore blank lines in place of epoch lines
             strm.formattedGetLine(line, true);
 
@@ -766,16 +766,16 @@ namespace gnsstk
                }
             }
 
-            satSys = line.substr(0,1);
-            PRNID = asInt(line.substr(1,2));
-            sat.fromString(line.substr(0,3));
+            satSys = line.substr(0,1).str();
+            PRNID = line.substr(1,2).asInt();
+            sat.fromString(line.substr(0,3).str());
 
-            yr  = asInt(line.substr( 4,4));
-            mo  = asInt(line.substr( 9,2));
-            day = asInt(line.substr(12,2));
-            hr  = asInt(line.substr(15,2));
-            min = asInt(line.substr(18,2));
-            dsec = asDouble(line.substr(21,2));
+            yr  = line.substr(4,4).asInt();
+            mo  = line.substr(9,2).asInt();
+            day = line.substr(12,2).asInt();
+            hr  = line.substr(15,2).asInt();
+            min = line.substr(18,2).asInt();
+            dsec = line.substr(21,2).asDouble();
          }
          else
          {
@@ -789,18 +789,18 @@ namespace gnsstk
             }
 
             satSys = string(1,strm.header.fileSys[0]);
-            PRNID = asInt(line.substr(0,2));
-            sat.fromString(satSys + line.substr(0,2));
+            PRNID = line.substr(0,2).asInt();
+            sat.fromString(satSys + line.substr(0,2).str());
 
-            yr  = asInt(line.substr( 2,3));
+            yr  = line.substr(2,3).asInt();
             if (yr < 80)
                yr += 100;     // rollover is at 1980
             yr += 1900;
-            mo  = asInt(line.substr( 5,3));
-            day = asInt(line.substr( 8,3));
-            hr  = asInt(line.substr(11,3));
-            min = asInt(line.substr(14,3));
-            dsec = asDouble(line.substr(17,5));
+            mo  = line.substr(5,3).asInt();
+            day = line.substr(8,3).asInt();
+            hr  = line.substr(11,3).asInt();
+            min = line.substr(14,3).asInt();
+            dsec = line.substr(17,5).asDouble();
          }
 
          // Fix RINEX epochs of the form 'yy mm dd hr 59 60.0'
@@ -832,15 +832,15 @@ namespace gnsstk
                // Rinex 2.*
             if (satSys == "G")
             {
-               af0 = line.substr(22,19);
-               af1 = line.substr(41,19);
-               af2 = line.substr(60,19);
+               af0 = line.substr(22,19).asDouble();
+               af1 = line.substr(41,19).asDouble();
+               af2 = line.substr(60,19).asDouble();
             }
             else if (satSys == "R" || satSys == "S")
             {
-               TauN   =      line.substr(22,19);
-               GammaN =      line.substr(41,19);
-               MFtime =      RNDouble(line.substr(60,19));
+               TauN   =      line.substr(22,19).asDouble();
+               GammaN =      line.substr(41,19).asDouble();
+               MFtime =      line.substr(60,19).asDouble();
                if (satSys == "R")
                {
                      // make MFtime consistent with R3.02
@@ -851,15 +851,15 @@ namespace gnsstk
          else if (satSys == "G" || satSys == "E" || satSys == "C" ||
                   satSys == "J")
          {
-            af0 = line.substr(23,19);
-            af1 = line.substr(42,19);
-            af2 = line.substr(61,19);
+            af0 = line.substr(23,19).asDouble();
+            af1 = line.substr(42,19).asDouble();
+            af2 = line.substr(61,19).asDouble();
          }
          else if (satSys == "R" || satSys == "S")
          {
-            TauN   =      line.substr(23,19);
-            GammaN =      line.substr(42,19);
-            MFtime =      RNDouble(line.substr(61,19));
+            TauN   =      line.substr(23,19).asDouble();
+            GammaN =      line.substr(42,19).asDouble();
+            MFtime =      line.substr(61,19).asDouble();
          }
       }
       catch (std::exception &e)
@@ -881,31 +881,31 @@ namespace gnsstk
       try
       {
          int n(strm.header.version < 3 ? 3 : 4);
-         string line;
+         FFTextLine line;
          strm.formattedGetLine(line);
 
          if (nline == 1)
          {
             if (satSys == "G" || satSys == "J" || satSys == "C")
             {
-               IODE = line.substr(n,19); n+=19;
-               Crs  = line.substr(n,19); n+=19;
-               dn   = line.substr(n,19); n+=19;
-               M0   = line.substr(n,19);
+               IODE = line.substr(n,19).asDouble(); n+=19;
+               Crs  = line.substr(n,19).asDouble(); n+=19;
+               dn   = line.substr(n,19).asDouble(); n+=19;
+               M0   = line.substr(n,19).asDouble();
             }
             else if (satSys == "E")
             {
-               IODnav = line.substr(n,19); n+=19;
-               Crs    = line.substr(n,19); n+=19;
-               dn     = line.substr(n,19); n+=19;
-               M0     = line.substr(n,19);
+               IODnav = line.substr(n,19).asDouble(); n+=19;
+               Crs    = line.substr(n,19).asDouble(); n+=19;
+               dn     = line.substr(n,19).asDouble(); n+=19;
+               M0     = line.substr(n,19).asDouble();
             }
             else if (satSys == "R" || satSys == "S")
             {
-               px     =        line.substr(n,19); n+=19;
-               vx     =        line.substr(n,19); n+=19;
-               ax     =        line.substr(n,19); n+=19;
-               health =        RNDouble(line.substr(n,19));
+               px     =        line.substr(n,19).asDouble(); n+=19;
+               vx     =        line.substr(n,19).asDouble(); n+=19;
+               ax     =        line.substr(n,19).asDouble(); n+=19;
+               health =        line.substr(n,19).asDouble();
             }
          }
 
@@ -914,23 +914,23 @@ namespace gnsstk
             if (satSys == "G" || satSys == "E" || satSys == "J" ||
                 satSys == "C")
             {
-               Cuc   = line.substr(n,19); n+=19;
-               ecc   = line.substr(n,19); n+=19;
-               Cus   = line.substr(n,19); n+=19;
-               Ahalf = line.substr(n,19);
+               Cuc   = line.substr(n,19).asDouble(); n+=19;
+               ecc   = line.substr(n,19).asDouble(); n+=19;
+               Cus   = line.substr(n,19).asDouble(); n+=19;
+               Ahalf = line.substr(n,19).asDouble();
             }
             else if (satSys == "R" || satSys == "S")
             {
-               py      =        line.substr(n,19); n+=19;
-               vy      =        line.substr(n,19); n+=19;
-               ay      =        line.substr(n,19); n+=19;
+               py      =        line.substr(n,19).asDouble(); n+=19;
+               vy      =        line.substr(n,19).asDouble(); n+=19;
+               ay      =        line.substr(n,19).asDouble(); n+=19;
                if (satSys == "R")
                {
-                  freqNum = RNDouble(line.substr(n,19));
+                  freqNum = line.substr(n,19).asDouble();
                }
                else                       // GEO
                {
-                  accCode = line.substr(n,19);
+                  accCode = line.substr(n,19).asDouble();
                }
             }
          }
@@ -940,49 +940,49 @@ namespace gnsstk
             if (satSys == "G" || satSys == "E" || satSys == "J" ||
                 satSys == "C")
             {
-               Toe    = line.substr(n,19); n+=19;
-               Cic    = line.substr(n,19); n+=19;
-               OMEGA0 = line.substr(n,19); n+=19;
-               Cis    = line.substr(n,19);
+               Toe    = line.substr(n,19).asDouble(); n+=19;
+               Cic    = line.substr(n,19).asDouble(); n+=19;
+               OMEGA0 = line.substr(n,19).asDouble(); n+=19;
+               Cis    = line.substr(n,19).asDouble();
             }
             else if (satSys == "R" || satSys == "S")
             {
-               pz        = line.substr(n,19); n+=19;
-               vz        = line.substr(n,19); n+=19;
-               az        = line.substr(n,19); n+=19;
+               pz        = line.substr(n,19).asDouble(); n+=19;
+               vz        = line.substr(n,19).asDouble(); n+=19;
+               az        = line.substr(n,19).asDouble(); n+=19;
                if (satSys == "R")
                {
-                  ageOfInfo = line.substr(n,19);
+                  ageOfInfo = line.substr(n,19).asDouble();
                }
                else                       // GEO
                {
-                  IODN = line.substr(n,19);
+                  IODN = line.substr(n,19).asDouble();
                }
             }
          }
 
          else if (nline == 4)
          {
-            i0       = line.substr(n,19); n+=19;
-            Crc      = line.substr(n,19); n+=19;
-            w        = line.substr(n,19); n+=19;
-            OMEGAdot = line.substr(n,19);
+            i0       = line.substr(n,19).asDouble(); n+=19;
+            Crc      = line.substr(n,19).asDouble(); n+=19;
+            w        = line.substr(n,19).asDouble(); n+=19;
+            OMEGAdot = line.substr(n,19).asDouble();
          }
 
          else if (nline == 5)
          {
             if (satSys == "G" || satSys == "J" || satSys == "C")
             {
-               idot     =        line.substr(n,19); n+=19;
-               codeflgs = RNDouble(line.substr(n,19)); n+=19;
-               weeknum  = RNDouble(line.substr(n,19)); n+=19;
-               L2Pdata  = RNDouble(line.substr(n,19));
+               idot     =        line.substr(n,19).asDouble(); n+=19;
+               codeflgs = line.substr(n,19).asDouble(); n+=19;
+               weeknum  = line.substr(n,19).asDouble(); n+=19;
+               L2Pdata  = line.substr(n,19).asDouble();
             }
             else if (satSys == "E")
             {
-               idot        =       line.substr(n,19); n+=19;
-               datasources =RNDouble(line.substr(n,19)); n+=19;
-               weeknum     =RNDouble(line.substr(n,19)); n+=19;
+               idot        =       line.substr(n,19).asDouble(); n+=19;
+               datasources =line.substr(n,19).asDouble(); n+=19;
+               weeknum     =line.substr(n,19).asDouble(); n+=19;
             }
          }
 
@@ -991,37 +991,37 @@ namespace gnsstk
             Tgd2 = 0.0;
             if (satSys == "G" || satSys == "J")
             {
-               accuracy =       line.substr(n,19); n+=19;
-               health   = RNDouble(line.substr(n,19)); n+=19;
-               Tgd      =       line.substr(n,19); n+=19;
-               IODC     =       line.substr(n,19);
+               accuracy =       line.substr(n,19).asDouble(); n+=19;
+               health   = line.substr(n,19).asDouble(); n+=19;
+               Tgd      =       line.substr(n,19).asDouble(); n+=19;
+               IODC     =       line.substr(n,19).asDouble();
             }
             else if (satSys == "E")
             {
-               accuracy =       line.substr(n,19); n+=19;
-               health   = RNDouble(line.substr(n,19)); n+=19;
-               Tgd      =       line.substr(n,19); n+=19;
-               Tgd2     =       line.substr(n,19);
+               accuracy =       line.substr(n,19).asDouble(); n+=19;
+               health   = line.substr(n,19).asDouble(); n+=19;
+               Tgd      =       line.substr(n,19).asDouble(); n+=19;
+               Tgd2     =       line.substr(n,19).asDouble();
             }
             else if (satSys == "C")
             {
-               accuracy =       line.substr(n,19); n+=19;
-               health   = RNDouble(line.substr(n,19)); n+=19;
-               Tgd      =       line.substr(n,19); n+=19;
-               Tgd2     =       line.substr(n,19);
+               accuracy =       line.substr(n,19).asDouble(); n+=19;
+               health   = line.substr(n,19).asDouble(); n+=19;
+               Tgd      =       line.substr(n,19).asDouble(); n+=19;
+               Tgd2     =       line.substr(n,19).asDouble();
             }
          }
 
          else if (nline == 7)
          {
-            xmitTime = RNDouble(line.substr(n,19)); n+=19;
+            xmitTime = line.substr(n,19).asDouble(); n+=19;
             if (satSys == "C")
             {
-               IODC    =        line.substr(n,19); n+=19;
+               IODC    =        line.substr(n,19).asDouble(); n+=19;
             }
             else
             {
-               fitint  =        line.substr(n,19); n+=19;
+               fitint  =        line.substr(n,19).asDouble(); n+=19;
             }
 
             // Some RINEX files have xmitTime < 0.
@@ -392,19 +392,20 @@ namespace gnsstk
       static CommonTime previousTime(CommonTime::BEGINNING_OF_TIME);
 
          // get the epoch line and check
-      string line;
+      FFTextLine line;
       while(line.empty())        // ignore blank lines in place of epoch lines
          strm.formattedGetLine(line, true);
-      StringUtils::stripTrailing(line);
+      line.stripTrailing();
 
-      if(line.size()>80 || line[0] != ' ' || line[3] != ' ' || line[6] != ' ')
+      if(line.size()>80 || line.size() < 7 ||
+         line[0] != ' ' || line[3] != ' ' || line[6] != ' ')
       {
-         FFStreamError e("Bad epoch line: >" + line + "<");
+         FFStreamError e("Bad epoch line: >" + line.str() + "<");
          GNSSTK_THROW(e);
       }
 
          // process the epoch line, including SV list and clock bias
-      rod.epochFlag = asInt(line.substr(28,1));
+      rod.epochFlag = line.substr(28,1).asInt();
       if((rod.epochFlag < 0) || (rod.epochFlag > 6))
       {
          FFStreamError e("Invalid epoch flag: " + asString(rod.epochFlag));
@@ -418,11 +419,11 @@ namespace gnsstk
          // If epoch flag=0, 1, 5, or 6 and there is NO epoch time, then throw.
          // If epoch flag=2, 3, or 4 and there is no epoch time,
          // use the time of the previous record.
-      bool noEpochTime = (line.substr(0,26) == string(26, ' '));
+      bool noEpochTime = (line.size() >= 26) && line.substr(0,26).isBlank();
       if(noEpochTime && (rod.epochFlag==0 || rod.epochFlag==1 ||
                          rod.epochFlag==5 || rod.epochFlag==6 ))
       {
-         FFStreamError e("Required epoch time missing: " + line);
+         FFStreamError e("Required epoch time missing: " + line.str());
          GNSSTK_THROW(e);
       }
       else if(noEpochTime)
@@ -433,7 +434,8 @@ namespace gnsstk
          {
                // check if the spaces are in the right place - an easy
                // way to check if there's corruption in the file
-            if((line[0] != ' ') || (line[3] != ' ') || (line[6] != ' ') ||
+            if((line.size() < 16) ||
+               (line[0] != ' ') || (line[3] != ' ') || (line[6] != ' ') ||
                (line[9] != ' ') || (line[12] != ' ') || (line[15] != ' '))
             {
                FFStreamError e("Invalid time format");
@@ -441,7 +443,7 @@ namespace gnsstk
             }
 
                // if there's no time, just use a bad time
-            if(line.substr(0,26) == string(26, ' '))
+            if(line.substr(0,26).isBlank())
                rod.time = CommonTime::BEGINNING_OF_TIME;
                //rod.time = previousTime; ??
             else
@@ -451,12 +453,12 @@ namespace gnsstk
                int yy = (static_cast<CivilTime>(strm.header.firstObs)).year/100;
                yy *= 100;
 
-               year  = asInt(   line.substr(1,  2 ));
-               month = asInt(   line.substr(4,  2 ));
-               day   = asInt(   line.substr(7,  2 ));
-               hour  = asInt(   line.substr(10, 2 ));
-               min   = asInt(   line.substr(13, 2 ));
-               sec   = asDouble(line.substr(15, 11));
+               year  = line.substr(1,  2 ).asInt();
+               month = line.substr(4,  2 ).asInt();
+               day   = line.substr(7,  2 ).asInt();
+               hour  = line.substr(10, 2 ).asInt();
+               min   = line.substr(13, 2 ).asInt();
+               sec   = line.substr(15, 11).asDouble();
 
                   // Real Rinex has epochs 'yy mm dd hr 59 60.0'
                   // surprisingly often....
@@ -491,11 +493,11 @@ namespace gnsstk
       }
 
          // number of satellites
-      rod.numSVs = asInt(line.substr(29,3));
+      rod.numSVs = line.substr(29,3).asInt();
 
          // clock offset
       if(line.size() > 68 )
-         rod.clockOffset = asDouble(line.substr(68, 12));
+         rod.clockOffset = line.substr(68, 12).asDouble();
       else
          rod.clockOffset = 0.0;
 
@@ -504,15 +506,13 @@ namespace gnsstk
       {
             // first read the SatIDs off the epoch line
          int isv, ndx, line_ndx;
-         string satsys;
-         RinexSatID sat;
          vector<RinexSatID> satIndex(rod.numSVs);
          for(isv=1, ndx=0; ndx<rod.numSVs; isv++, ndx++)
          {
             if(!(isv % 13))
             {                   // get a new continuation line
                strm.formattedGetLine(line);
-               StringUtils::stripTrailing(line);
+               line.stripTrailing();
                isv = 1;
                if(line.size() > 80)
                {
@@ -525,8 +525,7 @@ namespace gnsstk
                // read the sat id
             try
             {
-               sat = RinexSatID(line.substr(30+isv*3-1, 3));
-               satIndex[ndx] = sat;
+               satIndex[ndx] = strm.getSatID(line.substr(30+isv*3-1, 3));
             }
             catch (Exception& e)
             {
@@ -537,40 +536,52 @@ namespace gnsstk
 
             // number of R2 OTs in header
          int numObs(strm.header.R2ObsTypes.size());
+            // Which R2 OTs map into a valid R3 ObsID for each system,
+            // looked up once per system rather than once per datum.
+         map<char, vector<bool> > mapped;
          rod.obs.clear();
             // loop over all sats, reading obs data
          for(isv=0; isv < rod.numSVs; isv++)
          {
-            sat = satIndex[isv];                   // sat for this data
-            satsys = asString(sat.systemChar());   // system for this sat
-            vector<RinexDatum> data;
+            const RinexSatID& sat(satIndex[isv]);   // sat for this data
+            vector<bool>& keep(mapped[sat.systemChar()]);
+            if(keep.empty())
+            {
+               string satsys(1, sat.systemChar());   // system for this sat
+               keep.resize(numObs);
+               for(ndx=0; ndx < numObs; ndx++)
+               {
+                     // does this R2 OT map into a valid R3 ObsID?
+                  string R2ot(strm.header.R2ObsTypes[ndx]);
+                  string R3ot(strm.header.mapSysR2toR3ObsID[satsys][R2ot].asString());
+                  keep[ndx] = (R3ot != string("   "));
+               }
+            }
+            vector<RinexDatum>& data(rod.obs[sat]);
+            data.clear();
                // loop over data in the line
             for(ndx=0, line_ndx=0; ndx < numObs; ndx++, line_ndx++)
             {
                if(! (line_ndx % 5))
                {              // get a new line
                   strm.formattedGetLine(line);
-                  StringUtils::stripTrailing(line);
-                  line.resize(80, ' ');            // pad just in case
+                  line.stripTrailing();
+                     // ignore anything past column 80
+                  line = line.substr(0, 80);
                   line_ndx = 0;
-                  if(line.size() > 80)
-                  {
-                     FFStreamError err("Invalid line size:" +
-                                       asString(line.size()));
-                     GNSSTK_THROW(err);
-                  }
                }
 
-                  // does this R2 OT map into a valid R3 ObsID?
-               string R2ot(strm.header.R2ObsTypes[ndx]);
-               string R3ot(strm.header.mapSysR2toR3ObsID[satsys][R2ot].asString());
-               if(R3ot != string("   "))
+               if(keep[ndx])
                {
-                  RinexDatum tempData(line.substr(line_ndx*16, 16));
-                  data.push_back(tempData);
+                     // short lines are padded with blanks by fromString
+                  size_t pos = line_ndx*16;
+                  data.push_back(RinexDatum());
+                  if(pos < line.size())
+                     data.back().fromString(line.substr(pos, 16));
+                  else
+                     data.back().fromString(FFTextLine());
                }
             }
-            rod.obs[sat] = data;
 
          }  // end loop over sats to read obs data
       }
@@ -582,10 +593,11 @@ namespace gnsstk
          for(int i=0; i<rod.numSVs; i++)
          {
             strm.formattedGetLine(line);
-            StringUtils::stripTrailing(line);
+            line.stripTrailing();
             try
             {
-               rod.auxHeader.parseHeaderRecord(line);
+               string text(line.str());
+               rod.auxHeader.parseHeaderRecord(text);
             }
             catch(FFStreamError& e)
             {
@@ -624,54 +636,29 @@ namespace gnsstk
          {
             GNSSTK_RETHROW(e);
          }
+         filterObs(strm);
          return;
       }
 
-      string line;
-
-         // read the first (epoch) line
-      strm.formattedGetLine(line, true);
-      StringUtils::stripTrailing(line, " ");
-
-         // Check and parse the epoch line -----------------------------------
-         // Check for epoch marker ('>') and following space.
-      if(line[0] != '>' || line[1] != ' ')
-      {
-         FFStreamError e("Bad epoch line: >" + line + "<");
-         GNSSTK_THROW(e);
-      }
-
-      epochFlag = asInt(line.substr(31,1));
-      if(epochFlag < 0 || epochFlag > 6)
-      {
-         FFStreamError e("Invalid epoch flag: " + asString(epochFlag));
-         GNSSTK_THROW(e);
-      }
-
-      time = parseTime(line, strm.header, strm.timesystem);
-
-      numSVs = asInt(line.substr(32,3));
-
-      if(line.size() > 41)
-         clockOffset = asDouble(line.substr(41,15));
-      else
-         clockOffset = 0.0;
+      getEpochLine(strm, time, epochFlag, numSVs, clockOffset);
 
          // Read the observations: SV ID and data ----------------------------
       if(epochFlag == 0 || epochFlag == 1 || epochFlag == 6)
       {
-         vector<RinexSatID> satIndex(numSVs);
-         map<RinexSatID, vector<RinexDatum> > tempDataMap;
-
-         for(int isv = 0; isv < numSVs; isv++)
+         FFTextLine line;
+         RinexDatum blank;
+         blank.fromString(FFTextLine());
+         short numFileSVs = numSVs;
+         for(int isv = 0; isv < numFileSVs; isv++)
          {
             strm.formattedGetLine(line);
-            StringUtils::stripTrailing(line, " ");
+            line.stripTrailing();
 
                // get the SV ID
+            RinexSatID sat;
             try
             {
-               satIndex[isv] = RinexSatID(line.substr(0,3));
+               sat = strm.getSatID(line.substr(0,3));
             }
             catch (Exception& e)
             {
@@ -679,75 +666,153 @@ namespace gnsstk
                GNSSTK_THROW(ffse);
             }
 
+               // skip the line if the stream is set to filter it out
+            if(!strm.isSatWanted(sat))
+            {
+               numSVs--;
+               continue;
+            }
+
                // get the # data items (# entries in ObsType map of
                // maps from header)
-            string gnss = asString(satIndex[isv].systemChar());
+            string gnss(1, sat.systemChar());
             int size = strm.header.mapObsTypes[gnss].size();
+            const vector<bool> *wanted = strm.getWantedObs(sat);
 
                // Some receivers leave blanks for missing Obs (which
                // is OK by RINEX 3).  If the last Obs are the ones
                // missing, it won't necessarily be padded with spaces,
-               // so the parser will break.  This adds the padding to
-               // let the parser do its job and interpret spaces as
-               // zeroes.
-            size_t minSize = 3 + 16*size;
-            if(line.size() < minSize)
-               line += string(minSize-line.size(), ' ');
+               // so fromString() treats what's missing as blanks.
 
                // get the data (# entries in ObsType map of maps from header)
-            vector<RinexDatum> data;
+            vector<RinexDatum>& data(obs[sat]);
+            data.resize(size);
             for(int i = 0; i < size; i++)
             {
                size_t pos = 3 + 16*i;
-               RinexDatum tempData(line.substr(pos,16));
-               data.push_back(tempData);
+               if(pos < line.size() && (!wanted || (*wanted)[i]))
+                  data[i].fromString(line.substr(pos,16));
+               else
+                  data[i] = blank;
             }
-            obs[satIndex[isv]] = data;
          }
       }
 
          // ... or the auxiliary header information
       else if(numSVs > 0)
       {
-         auxHeader.clear();
-         for(int i = 0; i < numSVs; i++)
+         getAuxHeader(strm, numSVs, auxHeader);
+      }
+
+      xmitAnt = strm.header.xmitAnt;
+      return;
+
+   } // end of reallyGetRecord()
+
+
+   void Rinex3ObsData::filterObs(Rinex3ObsStream& strm)
+   {
+      DataMap::iterator i = obs.begin();
+      while(i != obs.end())
+      {
+         if(!strm.isSatWanted(i->first))
          {
-            strm.formattedGetLine(line);
-            StringUtils::stripTrailing(line);
-            try
-            {
-               auxHeader.parseHeaderRecord(line);
-            }
-            catch(FFStreamError& e)
-            {
-               GNSSTK_RETHROW(e);
-            }
-            catch(StringException& e)
-            {
-               GNSSTK_RETHROW(e);
-            }
-            catch (Exception& e)
+            obs.erase(i++);
+            numSVs--;
+            continue;
+         }
+         const vector<bool> *wanted = strm.getWantedObs(i->first);
+         if(wanted)
+         {
+            RinexDatum blank;
+            blank.fromString(FFTextLine());
+            for(size_t j = 0; j < i->second.size() && j < wanted->size(); j++)
             {
-               GNSSTK_RETHROW(e);
+               if(!(*wanted)[j])
+                  i->second[j] = blank;
             }
          }
+         ++i;
       }
+   } // end of filterObs()
 
-      xmitAnt = strm.header.xmitAnt;
-      return;
 
-   } // end of reallyGetRecord()
+   void Rinex3ObsData::getEpochLine(Rinex3ObsStream& strm, CommonTime& time,
+                                    short& epochFlag, short& numSVs,
+                                    double& clockOffset)
+   {
+      FFTextLine line;
+
+         // read the first (epoch) line
+      strm.formattedGetLine(line, true);
+      line.stripTrailing();
+
+         // Check and parse the epoch line -----------------------------------
+         // Check for epoch marker ('>') and following space.
+      if(line.size() < 2 || line[0] != '>' || line[1] != ' ')
+      {
+         FFStreamError e("Bad epoch line: >" + line.str() + "<");
+         GNSSTK_THROW(e);
+      }
+
+      epochFlag = line.substr(31,1).asInt();
+      if(epochFlag < 0 || epochFlag > 6)
+      {
+         FFStreamError e("Invalid epoch flag: " + asString(epochFlag));
+         GNSSTK_THROW(e);
+      }
+
+      time = parseTime(line, strm.header, strm.timesystem);
+
+      numSVs = line.substr(32,3).asInt();
+
+      if(line.size() > 41)
+         clockOffset = line.substr(41,15).asDouble();
+      else
+         clockOffset = 0.0;
+   } // end of getEpochLine()
+
+
+   void Rinex3ObsData::getAuxHeader(Rinex3ObsStream& strm, short numSVs,
+                                    Rinex3ObsHeader& auxHeader)
+   {
+      FFTextLine line;
+      auxHeader.clear();
+      for(int i = 0; i < numSVs; i++)
+      {
+         strm.formattedGetLine(line);
+         line.stripTrailing();
+         try
+         {
+            string text(line.str());
+            auxHeader.parseHeaderRecord(text);
+         }
+         catch(FFStreamError& e)
+         {
+            GNSSTK_RETHROW(e);
+         }
+         catch(StringException& e)
+         {
+            GNSSTK_RETHROW(e);
+         }
+         catch (Exception& e)
+         {
+            GNSSTK_RETHROW(e);
+         }
+      }
+   } // end of getAuxHeader()
 
 
-   CommonTime Rinex3ObsData::parseTime(const string& line,
+   CommonTime Rinex3ObsData::parseTime(const FFTextLine& line,
                                        const Rinex3ObsHeader& hdr,
-                                       const TimeSystem& ts) const
+                                       const TimeSystem& ts)
    {
       try
       {
             // check if the spaces are in the right place - an easy
             // way to check if there's corruption in the file
-         if( (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
+         if( (line.size() < 31) ||
+             (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
              (line[12] != ' ') || (line[15] != ' ') || (line[18] != ' ') ||
              (line[29] != ' ') || (line[30] != ' '))
          {
@@ -756,18 +821,18 @@ namespace gnsstk
          }
 
             // if there's no time, just return a bad time
-         if(line.substr(2,27) == string(27, ' '))
+         if(line.substr(2,27).isBlank())
             return CommonTime::BEGINNING_OF_TIME;
 
          int year, month, day, hour, min;
          double sec;
 
-         year  = asInt(   line.substr( 2,  4));
-         month = asInt(   line.substr( 7,  2));
-         day   = asInt(   line.substr(10,  2));
-         hour  = asInt(   line.substr(13,  2));
-         min   = asInt(   line.substr(16,  2));
-         sec   = asDouble(line.substr(19, 11));
+         year  = line.substr( 2,  4).asInt();
+         month = line.substr( 7,  2).asInt();
+         day   = line.substr(10,  2).asInt();
+         hour  = line.substr(13,  2).asInt();
+         min   = line.substr(16,  2).asInt();
+         sec   = line.substr(19, 11).asDouble();
 
             // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
          double ds = 0;
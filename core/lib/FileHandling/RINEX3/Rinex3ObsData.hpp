@@ -50,6 +50,7 @@
 
 #include "CommonTime.hpp"
 #include "FFStream.hpp"
+#include "FFTextLine.hpp"
 #include "Rinex3ObsBase.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "RinexDatum.hpp"
@@ -57,6 +58,8 @@
 
 namespace gnsstk
 {
+   class Rinex3ObsStream;
+   class Rinex3ObsEpochBuffer;
 
       /// @ingroup FileHandling
       //@{
@@ -104,8 +107,15 @@ namespace gnsstk
       short epochFlag;
 
 
-         /// Number of satellites in this observation, except when
-         /// epochFlag=2-5, then number of auxiliary header records to follow.
+         /** Number of satellites in this observation, except when
+          * epochFlag=2-5, then number of auxiliary header records to
+          * follow.
+          * @note When the stream filters satellites (see
+          *   Rinex3ObsStream::setWantedObsTypes() and
+          *   Rinex3ObsStream::setExcludedSats()), numSVs is the number
+          *   of satellites kept, i.e. obs.size(), and not the number
+          *   given in the epoch line of the file.  A filtered record
+          *   is therefore written with the reduced count. */
       short numSVs;
 
 
@@ -212,6 +222,8 @@ namespace gnsstk
 
 
    private:
+         // Shares the parsing of epoch lines and auxiliary headers.
+      friend class Rinex3ObsEpochBuffer;
 
 
          /** Writes the CommonTime into RINEX 3 format.
@@ -229,9 +241,41 @@ namespace gnsstk
           *             RINEX file.
           * @throw FFStreamError
           */
-      CommonTime parseTime( const std::string& line,
-                            const Rinex3ObsHeader& hdr,
-                            const TimeSystem& ts) const;
+      static CommonTime parseTime( const FFTextLine& line,
+                                   const Rinex3ObsHeader& hdr,
+                                   const TimeSystem& ts);
+
+
+         /** Remove the satellites and blank the observations that
+          * strm is set to filter out, for records that were parsed
+          * in full.
+          * @param[in] strm The stream the record was read from. */
+      void filterObs(Rinex3ObsStream& strm);
+
+
+         /** Read and parse the epoch line of a RINEX 3 record.
+          * @param[in,out] strm The stream to read the line from.
+          * @param[out] time The time of the epoch.
+          * @param[out] epochFlag The epoch flag.
+          * @param[out] numSVs The number of satellites or auxiliary
+          *   header records that follow.
+          * @param[out] clockOffset The receiver clock offset, or 0.
+          * @throw FFStreamError if the line is not valid.
+          */
+      static void getEpochLine(Rinex3ObsStream& strm, CommonTime& time,
+                               short& epochFlag, short& numSVs,
+                               double& clockOffset);
+
+
+         /** Read the auxiliary header records of a RINEX 3 record
+          * with an epoch flag of 2 through 5.
+          * @param[in,out] strm The stream to read the records from.
+          * @param[in] numSVs The number of records to read.
+          * @param[out] auxHeader The header to parse the records into.
+          * @throw FFStreamError if a record is not valid.
+          */
+      static void getAuxHeader(Rinex3ObsStream& strm, short numSVs,
+                               Rinex3ObsHeader& auxHeader);
 
 
    }; // End of class 'Rinex3ObsData'
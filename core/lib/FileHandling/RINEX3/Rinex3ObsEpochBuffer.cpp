@@ -0,0 +1,389 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file Rinex3ObsEpochBuffer.cpp
+ * Reusable flat storage for the observations of a RINEX obs epoch.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include "TimeString.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsEpochBuffer.hpp"
+
+using namespace std;
+
+namespace gnsstk
+{
+   const unsigned char Rinex3ObsEpochBuffer::blankIndicator;
+
+
+   Rinex3ObsEpochBuffer ::
+   Rinex3ObsEpochBuffer()
+         : time(CommonTime::BEGINNING_OF_TIME),
+           epochFlag(-1),
+           numSVs(-1),
+           clockOffset(0.),
+           nSats(0),
+           width(0),
+           auxUsed(false)
+   {
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   reserve(const Rinex3ObsHeader& hdr, size_t numSats)
+   {
+      size_t maxObs = 0;
+      for (const auto& mi : hdr.mapObsTypes)
+      {
+         maxObs = std::max(maxObs, mi.second.size());
+      }
+      if (maxObs > width)
+      {
+         setWidth(maxObs);
+      }
+      growRows(numSats);
+   }
+
+
+   long Rinex3ObsEpochBuffer ::
+   findSat(const RinexSatID& sat) const
+   {
+      for (size_t row = 0; row < nSats; row++)
+      {
+         if (sats[row] == sat)
+            return row;
+      }
+      return -1;
+   }
+
+
+   size_t Rinex3ObsEpochBuffer ::
+   addSat(const RinexSatID& sat, size_t numObs)
+   {
+      if (numObs > width)
+      {
+         setWidth(numObs);
+      }
+      growRows(nSats+1);
+      size_t row = nSats++;
+      sats[row] = sat;
+      rowObs[row] = numObs;
+      size_t first = row * width;
+      std::fill_n(values.begin() + first, width,
+                  std::numeric_limits<double>::quiet_NaN());
+      std::fill_n(llis.begin() + first, width, blankIndicator);
+      std::fill_n(ssis.begin() + first, width, blankIndicator);
+      return row;
+   }
+
+
+   RinexDatum Rinex3ObsEpochBuffer ::
+   getDatum(size_t row, size_t col) const
+   {
+      RinexDatum rv;
+      size_t idx = row * width + col;
+      rv.dataBlank = std::isnan(values[idx]);
+      rv.data = (rv.dataBlank ? 0. : values[idx]);
+      rv.lliBlank = (llis[idx] == blankIndicator);
+      rv.lli = (rv.lliBlank ? 0 : llis[idx]);
+      rv.ssiBlank = (ssis[idx] == blankIndicator);
+      rv.ssi = (rv.ssiBlank ? 0 : ssis[idx]);
+      return rv;
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   setDatum(size_t row, size_t col, const RinexDatum& datum)
+   {
+      size_t idx = row * width + col;
+      values[idx] = (datum.dataBlank ? std::numeric_limits<double>::quiet_NaN()
+                     : datum.data);
+      llis[idx] = (datum.lliBlank ? blankIndicator : datum.lli);
+      ssis[idx] = (datum.ssiBlank ? blankIndicator : datum.ssi);
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   toDataMap(Rinex3ObsData::DataMap& dm) const
+   {
+      dm.clear();
+      for (size_t row = 0; row < nSats; row++)
+      {
+         vector<RinexDatum>& data(dm[sats[row]]);
+         data.resize(rowObs[row]);
+         for (size_t col = 0; col < rowObs[row]; col++)
+         {
+            data[col] = getDatum(row, col);
+         }
+      }
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   fromDataMap(const Rinex3ObsData::DataMap& dm)
+   {
+      clear();
+      size_t maxObs = 0;
+      for (const auto& di : dm)
+      {
+         maxObs = std::max(maxObs, di.second.size());
+      }
+      if (maxObs > width)
+      {
+         setWidth(maxObs);
+      }
+      growRows(dm.size());
+      for (const auto& di : dm)
+      {
+         size_t row = addSat(di.first, di.second.size());
+         for (size_t col = 0; col < di.second.size(); col++)
+         {
+            setDatum(row, col, di.second[col]);
+         }
+      }
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   toObsData(Rinex3ObsData& rod) const
+   {
+      rod.time = time;
+      rod.epochFlag = epochFlag;
+      rod.numSVs = numSVs;
+      rod.clockOffset = clockOffset;
+      toDataMap(rod.obs);
+      rod.auxHeader = auxHeader;
+      rod.xmitAnt = xmitAnt;
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   fromObsData(const Rinex3ObsData& rod)
+   {
+      time = rod.time;
+      epochFlag = rod.epochFlag;
+      numSVs = rod.numSVs;
+      clockOffset = rod.clockOffset;
+      fromDataMap(rod.obs);
+      auxHeader = rod.auxHeader;
+      auxUsed = true;
+      xmitAnt = rod.xmitAnt;
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   dump(std::ostream& s) const
+   {
+      s << "Dump of Rinex3ObsEpochBuffer - time: "
+        << printTime(time, "%04Y/%02m/%02d %02H:%02M:%09.6f")
+        << " epochFlag: " << epochFlag
+        << " numSVs: " << numSVs
+        << fixed << setprecision(9) << " clk offset: " << clockOffset
+        << endl;
+      if (epochFlag >= 2 && epochFlag <= 5)
+      {
+         s << "aux. header info:\n";
+         auxHeader.dump(s);
+         return;
+      }
+      for (size_t row = 0; row < nSats; row++)
+      {
+         s << " " << sats[row].toString() << ":" << fixed << setprecision(3);
+         for (size_t col = 0; col < rowObs[row]; col++)
+         {
+            RinexDatum datum(getDatum(row, col));
+            s << " " << setw(12) << datum.data
+              << "/" << datum.lli << "/" << datum.ssi;
+         }
+         s << endl;
+      }
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   reallyPutRecord(FFStream& ffs) const
+   {
+      Rinex3ObsData rod;
+      toObsData(rod);
+      rod.reallyPutRecord(ffs);
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   reallyGetRecord(FFStream& ffs)
+   {
+      Rinex3ObsStream& strm = dynamic_cast<Rinex3ObsStream&>(ffs);
+
+         // If the header hasn't been read, read it.
+      if (!strm.headerRead) strm >> strm.header;
+
+      clear();
+
+         // RINEX 2 records are parsed into a Rinex3ObsData and copied
+      if (strm.header.version < 3)
+      {
+         Rinex3ObsData rod;
+         rod.reallyGetRecord(strm);
+         fromObsData(rod);
+         return;
+      }
+
+      Rinex3ObsData::getEpochLine(strm, time, epochFlag, numSVs, clockOffset);
+
+      if (epochFlag == 0 || epochFlag == 1 || epochFlag == 6)
+      {
+            // Number of observation types of each system, looked up
+            // by system character.
+         unsigned short sysObs[128] = { 0 };
+         for (const auto& mi : strm.header.mapObsTypes)
+         {
+            if (mi.first.size() == 1 &&
+                static_cast<unsigned char>(mi.first[0]) < 128)
+            {
+               sysObs[static_cast<unsigned char>(mi.first[0])] =
+                  mi.second.size();
+            }
+         }
+         growRows(numSVs);
+         FFTextLine line;
+         RinexDatum datum;
+         short numFileSVs = numSVs;
+         for (int isv = 0; isv < numFileSVs; isv++)
+         {
+            strm.formattedGetLine(line);
+            line.stripTrailing();
+
+            RinexSatID sat;
+            try
+            {
+               sat = strm.getSatID(line.substr(0,3));
+            }
+            catch (Exception& e)
+            {
+               FFStreamError ffse(e);
+               GNSSTK_THROW(ffse);
+            }
+
+            if (!strm.isSatWanted(sat))
+            {
+               numSVs--;
+               continue;
+            }
+
+            unsigned char sys = sat.systemChar();
+            size_t size = (sys < 128 ? sysObs[sys] : 0);
+            const vector<bool> *wanted = strm.getWantedObs(sat);
+            size_t row = addSat(sat, size);
+               // Obs missing at the end of the line or not wanted
+               // are left blank.
+            for (size_t i = 0; i < size; i++)
+            {
+               size_t pos = 3 + 16*i;
+               if (pos >= line.size())
+                  break;
+               if (wanted && !(*wanted)[i])
+                  continue;
+               datum.fromString(line.substr(pos,16));
+               setDatum(row, i, datum);
+            }
+         }
+         if (auxUsed)
+         {
+            auxHeader.clear();
+            auxUsed = false;
+         }
+      }
+      else if (numSVs > 0)
+      {
+         Rinex3ObsData::getAuxHeader(strm, numSVs, auxHeader);
+         auxUsed = true;
+      }
+      else if (auxUsed)
+      {
+         auxHeader.clear();
+         auxUsed = false;
+      }
+
+      xmitAnt = strm.header.xmitAnt;
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   setWidth(size_t newWidth)
+   {
+      size_t rows = sats.size();
+      vector<double> newValues(rows * newWidth,
+                               std::numeric_limits<double>::quiet_NaN());
+      vector<unsigned char> newLLIs(rows * newWidth, blankIndicator);
+      vector<unsigned char> newSSIs(rows * newWidth, blankIndicator);
+      for (size_t row = 0; row < nSats; row++)
+      {
+         std::copy_n(values.begin() + row*width, rowObs[row],
+                     newValues.begin() + row*newWidth);
+         std::copy_n(llis.begin() + row*width, rowObs[row],
+                     newLLIs.begin() + row*newWidth);
+         std::copy_n(ssis.begin() + row*width, rowObs[row],
+                     newSSIs.begin() + row*newWidth);
+      }
+      values.swap(newValues);
+      llis.swap(newLLIs);
+      ssis.swap(newSSIs);
+      width = newWidth;
+   }
+
+
+   void Rinex3ObsEpochBuffer ::
+   growRows(size_t rows)
+   {
+      if (rows <= sats.size())
+         return;
+         // grow geometrically so adding one satellite at a time is cheap
+      rows = std::max(rows, 2 * sats.size());
+      sats.resize(rows);
+      rowObs.resize(rows);
+      values.resize(rows * width);
+      llis.resize(rows * width);
+      ssis.resize(rows * width);
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,252 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file Rinex3ObsEpochBuffer.hpp
+ * Reusable flat storage for the observations of a RINEX obs epoch.
+ */
+
+#ifndef GNSSTK_RINEX3OBSEPOCHBUFFER_HPP
+#define GNSSTK_RINEX3OBSEPOCHBUFFER_HPP
+
+#include <cmath>
+#include <vector>
+#include "Rinex3ObsData.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * The contents of a RINEX observation record, stored as a
+       * matrix with a row per satellite rather than as
+       * Rinex3ObsData's map of vectors.  The columns of a row are the
+       * observation types of the satellite's system, in header order,
+       * so column i of a GPS row is header.mapObsTypes["G"][i].
+       *
+       * The observation values are held in one contiguous array,
+       * row-major, with the LLI and SSI in parallel byte arrays.
+       * Rows are in the order the satellites appear in the record.
+       * Reading a record reuses the storage of the previous one, so
+       * once the buffer is big enough for the largest epoch, reading
+       * RINEX 3 records with
+       * @code
+       * Rinex3ObsEpochBuffer buf;
+       * while (strm >> buf)
+       * {
+       *    for (size_t row = 0; row < buf.getNumSats(); row++)
+       *       process(buf.getSat(row), buf.getData(row, 0));
+       * }
+       * @endcode
+       * allocates nothing per epoch.  Records of RINEX 2 files and
+       * records with auxiliary header information are still parsed
+       * as they are by Rinex3ObsData.  Satellites and observation
+       * types filtered out by the stream (see
+       * Rinex3ObsStream::setWantedObsTypes()) are skipped as they are
+       * by Rinex3ObsData.
+       *
+       * Blank observations are NaN, and blank LLI and SSI are
+       * blankIndicator.  toDataMap() and fromDataMap() convert to and
+       * from Rinex3ObsData::DataMap, turning these back into the
+       * RinexDatum blank flags.
+       */
+   class Rinex3ObsEpochBuffer : public Rinex3ObsBase
+   {
+   public:
+         /// The LLI or SSI value stored for a blank LLI or SSI.
+      static const unsigned char blankIndicator = 0xff;
+
+         /// Create an empty buffer.
+      Rinex3ObsEpochBuffer();
+
+         /// Destructor
+      virtual ~Rinex3ObsEpochBuffer() {}
+
+         /// Rinex3ObsEpochBuffer is data.
+      virtual bool isData() const
+      { return true; }
+
+         /** Make room for an epoch of a file without reallocating.
+          * @param[in] hdr The header of the file, whose mapObsTypes
+          *   determines the number of columns.
+          * @param[in] numSats The number of satellite rows. */
+      void reserve(const Rinex3ObsHeader& hdr, size_t numSats);
+
+         /// Remove all satellites, keeping the storage for reuse.
+      void clear()
+      { nSats = 0; }
+
+         /// Return the number of satellite rows.
+      size_t getNumSats() const
+      { return nSats; }
+
+         /// Return the number of columns allocated to each row.
+      size_t getWidth() const
+      { return width; }
+
+         /// Return the satellite of a row.
+      const RinexSatID& getSat(size_t row) const
+      { return sats[row]; }
+
+         /// Return the number of observations in a row.
+      size_t getNumObs(size_t row) const
+      { return rowObs[row]; }
+
+         /** Return the row of a satellite.
+          * @return the row index or -1 if the satellite isn't present. */
+      long findSat(const RinexSatID& sat) const;
+
+         /** Add a row for a satellite with all of its observations
+          * blank.
+          * @param[in] sat The satellite.
+          * @param[in] numObs The number of observations for the
+          *   satellite.
+          * @return the index of the new row. */
+      size_t addSat(const RinexSatID& sat, size_t numObs);
+
+         /// Return an observation value, which is NaN if blank.
+      double getData(size_t row, size_t col) const
+      { return values[row*width + col]; }
+
+         /// Return true if an observation is blank.
+      bool isDataBlank(size_t row, size_t col) const
+      { return std::isnan(values[row*width + col]); }
+
+         /// Return the LLI of an observation, or blankIndicator.
+      unsigned char getLLI(size_t row, size_t col) const
+      { return llis[row*width + col]; }
+
+         /// Return the SSI of an observation, or blankIndicator.
+      unsigned char getSSI(size_t row, size_t col) const
+      { return ssis[row*width + col]; }
+
+         /** Return the observation values of a row, getNumObs(row)
+          * of them, which are followed by the next row's at
+          * getWidth() intervals. */
+      const double* getDataRow(size_t row) const
+      { return &values[row*width]; }
+
+         /// Return an observation as a RinexDatum.
+      RinexDatum getDatum(size_t row, size_t col) const;
+
+         /// Set an observation from a RinexDatum.
+      void setDatum(size_t row, size_t col, const RinexDatum& datum);
+
+         /** Copy the observations into a Rinex3ObsData::DataMap.
+          * @param[out] dm The map, whose previous contents are
+          *   replaced. */
+      void toDataMap(Rinex3ObsData::DataMap& dm) const;
+
+         /** Replace the observations with those in a
+          * Rinex3ObsData::DataMap.  The rows are in satellite order.
+          * @param[in] dm The map to copy. */
+      void fromDataMap(const Rinex3ObsData::DataMap& dm);
+
+         /// Copy the whole record into a Rinex3ObsData.
+      void toObsData(Rinex3ObsData& rod) const;
+
+         /// Replace the whole record with the contents of a Rinex3ObsData.
+      void fromObsData(const Rinex3ObsData& rod);
+
+         /// Print the epoch and the observations of each satellite.
+      virtual void dump(std::ostream& s) const;
+
+         /// Time corresponding to the observations.
+      CommonTime time;
+         /// The epoch flag, see Rinex3ObsData::epochFlag.
+      short epochFlag;
+         /** Number of satellites in this observation, except when
+          * epochFlag=2-5, then number of auxiliary header records. */
+      short numSVs;
+         /// Optional clock offset in seconds.
+      double clockOffset;
+         /// Auxiliary header records (epochFlag 2-5).
+      Rinex3ObsHeader auxHeader;
+         /// Non-standard, transmitter ID.
+      XmitAnt xmitAnt;
+
+   protected:
+         /** Write the record, as Rinex3ObsData::reallyPutRecord().
+          * @throw std::exception
+          * @throw FFStreamError
+          * @throw StringUtils::StringException */
+      virtual void reallyPutRecord(FFStream& s) const;
+
+         /** Read a record, as Rinex3ObsData::reallyGetRecord().
+          * @throw std::exception
+          * @throw StringException When a StringUtils function fails
+          * @throw FFStreamError When exceptions(failbit) is set and
+          *   a read or formatting error occurs. */
+      virtual void reallyGetRecord(FFStream& s);
+
+   private:
+         /** Change the number of columns of each row, keeping the
+          * existing observations.
+          * @param[in] newWidth The new number of columns, which
+          *   must be at least the number of observations of any
+          *   existing row. */
+      void setWidth(size_t newWidth);
+
+         /// Make sure there is storage for at least rows rows.
+      void growRows(size_t rows);
+
+         /// The satellite of each row, of which the first nSats are used.
+      std::vector<RinexSatID> sats;
+         /// The number of observations in each row.
+      std::vector<unsigned short> rowObs;
+         /// Observation values, width per row.
+      std::vector<double> values;
+         /// LLI of each observation, parallel to values.
+      std::vector<unsigned char> llis;
+         /// SSI of each observation, parallel to values.
+      std::vector<unsigned char> ssis;
+         /// The number of rows in use.
+      size_t nSats;
+         /// The number of columns in each row.
+      size_t width;
+         /// True if auxHeader may contain records to clear.
+      bool auxUsed;
+   }; // class Rinex3ObsEpochBuffer
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_RINEX3OBSEPOCHBUFFER_HPP
@@ -1763,6 +1763,7 @@ namespace gnsstk
          // If we get here, we should have reached the end of header line.
       strm.header = *this;
       strm.headerRead = true;
+      strm.updateObsFilter();
 
          // determine the time system of epochs in this file; cf. R3.02 Table A2
          // 1.determine time system from time tag in TIME OF FIRST OBS record
@@ -0,0 +1,383 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file Rinex3ObsParallelReader.cpp
+ * Read RINEX 3 observation files using multiple threads.
+ */
+
+#include <algorithm>
+#include "Rinex3ObsParallelReader.hpp"
+#include "FFTextBuf.hpp"
+
+namespace gnsstk
+{
+      /** Return true if a line could be a RINEX 3 epoch line, which
+       * is all that is needed to choose the start of a chunk.
+       * @param[in] line The start of the line.
+       * @param[in] len The length of the line. */
+   static bool isEpochLine(const char *line, size_t len)
+   {
+      return ((len >= 35) && (line[0] == '>') && (line[1] == ' ') &&
+              (line[31] >= '0') && (line[31] <= '6'));
+   }
+
+
+   Rinex3ObsParallelReader ::
+   Rinex3ObsParallelReader(const std::string& fn, unsigned numThreads,
+                           size_t chunkSize)
+         : filename(fn), fileSize(0), nextChunk(0), prevEnd(0),
+           maxPending(0), failed(false), stopping(false)
+   {
+      strm.open(fn.c_str(), std::ios::in);
+      if (!strm)
+      {
+         FileMissingException exc("Unable to open " + fn);
+         GNSSTK_THROW(exc);
+      }
+      strm.bufferInput();
+      strm.exceptions(std::ios::failbit);
+      try
+      {
+         Rinex3ObsHeader hdr;
+         strm >> hdr;
+      }
+      catch (Exception& exc)
+      {
+         GNSSTK_RETHROW(exc);
+      }
+      if (numThreads == 0)
+      {
+         numThreads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      if ((numThreads == 1) || (strm.header.version < 3) ||
+          !split(strm.tellg(), chunkSize))
+      {
+         return;
+      }
+      prevEnd = bounds.front();
+         // Enough to keep every worker busy while the records of
+         // one chunk are being returned.
+      maxPending = 2 * numThreads;
+      for (unsigned t = 0; t < numThreads; t++)
+      {
+         workers.push_back(std::thread(&Rinex3ObsParallelReader::run, this));
+      }
+      submit();
+   }
+
+
+   Rinex3ObsParallelReader ::
+   ~Rinex3ObsParallelReader()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         stopping = true;
+      }
+      jobReady.notify_all();
+      for (auto& w : workers)
+      {
+         w.join();
+      }
+   }
+
+
+   const Rinex3ObsData* Rinex3ObsParallelReader ::
+   next()
+   {
+      if (failed)
+      {
+         return nullptr;
+      }
+      if (workers.empty())
+      {
+         try
+         {
+            strm >> current;
+         }
+         catch (...)
+         {
+            failed = true;
+            throw;
+         }
+         return strm.fail() ? nullptr : &current;
+      }
+      while (!chunks.empty())
+      {
+         Chunk& c(*chunks.front());
+         if (!c.checked)
+         {
+            {
+               std::unique_lock<std::mutex> lock(mtx);
+               chunkDone.wait(lock, [&c]() { return c.done; });
+            }
+            c.checked = true;
+            if (c.begin != prevEnd)
+            {
+                  // The previous chunk's last record ran past the
+                  // line that was taken to be the start of this one,
+                  // so parse it again from where that record ended.
+               Chunk redo(prevEnd, c.end);
+               parse(strm, redo);
+               c.begin = redo.begin;
+               c.parsedEnd = redo.parsedEnd;
+               c.data.swap(redo.data);
+               c.exc = redo.exc;
+            }
+         }
+         if (c.nextRec < c.data.size())
+         {
+            return &c.data[c.nextRec++];
+         }
+         if (c.exc)
+         {
+            std::exception_ptr exc(c.exc);
+            fail();
+            std::rethrow_exception(exc);
+         }
+         prevEnd = c.parsedEnd;
+         chunks.pop_front();
+         submit();
+      }
+      return nullptr;
+   }
+
+
+   bool Rinex3ObsParallelReader ::
+   read(const Callback& cb)
+   {
+      const Rinex3ObsData *rod;
+      while ((rod = next()) != nullptr)
+      {
+         if (!cb(*rod))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   run()
+   {
+      Rinex3ObsStream s;
+      bool opened = false;
+      std::unique_lock<std::mutex> lock(mtx);
+      while (true)
+      {
+         jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+         if (stopping)
+         {
+            return;
+         }
+         Chunk *c = jobs.front();
+         jobs.pop_front();
+         lock.unlock();
+         try
+         {
+            if (!opened)
+            {
+               openStream(s);
+               opened = true;
+            }
+            parse(s, *c);
+         }
+         catch (...)
+         {
+            c->exc = std::current_exception();
+         }
+         lock.lock();
+         c->done = true;
+         chunkDone.notify_all();
+      }
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   openStream(Rinex3ObsStream& s) const
+   {
+      s.open(filename.c_str(), std::ios::in);
+      if (!s)
+      {
+         FileMissingException exc("Unable to open " + filename);
+         GNSSTK_THROW(exc);
+      }
+      s.bufferInput();
+      s.exceptions(std::ios::failbit);
+      Rinex3ObsHeader hdr;
+      s >> hdr;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   parse(Rinex3ObsStream& s, Chunk& c) const
+   {
+      std::streamoff pos = c.begin;
+      try
+      {
+         s.clear();
+         s.seekg(c.begin);
+         while (pos < c.end)
+         {
+            c.data.emplace_back();
+            try
+            {
+               s >> c.data.back();
+            }
+            catch (...)
+            {
+               c.data.pop_back();
+               throw;
+            }
+            if (s.fail())
+            {
+                  // end of file
+               c.data.pop_back();
+               break;
+            }
+               // tellg fails once eofbit is set
+            pos = s.eof() ? fileSize : std::streamoff(s.tellg());
+         }
+      }
+      catch (...)
+      {
+         c.exc = std::current_exception();
+      }
+      c.parsedEnd = pos;
+   }
+
+
+   bool Rinex3ObsParallelReader ::
+   split(std::streamoff headerEnd, size_t chunkSize)
+   {
+      FFTextBuf buf;
+      if (!buf.open(filename))
+      {
+         return false;
+      }
+      fileSize = buf.pubseekoff(0, std::ios::end, std::ios::in);
+      bounds.push_back(headerEnd);
+      const char *line;
+      size_t len;
+      bool terminated;
+      std::streamoff target = headerEnd + chunkSize;
+      while (target < fileSize)
+      {
+            // Skip to the first epoch line after the end of the
+            // partial line at target.
+         buf.pubseekpos(target, std::ios::in);
+         buf.getLine(line, len, terminated);
+         std::streamoff pos = fileSize;
+         while (true)
+         {
+            std::streamoff lineStart = buf.pubseekoff(0, std::ios::cur,
+                                                      std::ios::in);
+            if (!buf.getLine(line, len, terminated))
+            {
+               break;
+            }
+            if (isEpochLine(line, len))
+            {
+               pos = lineStart;
+               break;
+            }
+         }
+         if (pos >= fileSize)
+         {
+            break;
+         }
+         bounds.push_back(pos);
+         target = pos + chunkSize;
+      }
+      bounds.push_back(fileSize);
+      return true;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   submit()
+   {
+      bool queued = false;
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         while ((chunks.size() < maxPending) &&
+                (nextChunk + 1 < bounds.size()))
+         {
+            chunks.push_back(std::unique_ptr<Chunk>(
+                                new Chunk(bounds[nextChunk],
+                                          bounds[nextChunk+1])));
+            jobs.push_back(chunks.back().get());
+            nextChunk++;
+            queued = true;
+         }
+      }
+      if (queued)
+      {
+         jobReady.notify_all();
+      }
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   fail()
+   {
+      failed = true;
+      std::unique_lock<std::mutex> lock(mtx);
+         // Chunks no worker has started on never will be.
+      for (auto c : jobs)
+      {
+         c->done = true;
+      }
+      jobs.clear();
+         // Wait for chunks being parsed before freeing them.
+      chunkDone.wait(lock, [this]()
+      {
+         for (const auto& c : chunks)
+         {
+            if (!c->done)
+            {
+               return false;
+            }
+         }
+         return true;
+      });
+      chunks.clear();
+   }
+} // namespace gnsstk
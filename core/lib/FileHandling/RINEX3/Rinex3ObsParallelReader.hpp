@@ -0,0 +1,243 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file Rinex3ObsParallelReader.hpp
+ * Read RINEX 3 observation files using multiple threads.
+ */
+
+#ifndef GNSSTK_RINEX3OBSPARALLELREADER_HPP
+#define GNSSTK_RINEX3OBSPARALLELREADER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Read the records of a RINEX 3 observation file, parsing
+       * them with a pool of worker threads.
+       *
+       * Every RINEX 3 epoch record starts with a '>' marker, so the
+       * body of the file can be split into chunks of about
+       * chunkSize bytes, each starting at an epoch record.  Each
+       * worker parses whole chunks with its own Rinex3ObsStream, and
+       * the records are returned by next() or read() in the order
+       * they appear in the file, which for a valid file is time
+       * order.  The records are the same as those read sequentially
+       * from a Rinex3ObsStream, including when a line in the
+       * auxiliary header of an event record happens to look like an
+       * epoch line: a chunk that does not start where the previous
+       * one ended is parsed again from the right place.
+       *
+       * RINEX 2 files have no such marker, so they are read
+       * sequentially with a single Rinex3ObsStream, as are readers
+       * created with one thread.
+       *
+       * @code
+       * Rinex3ObsParallelReader rdr("site0010.22o");
+       * const Rinex3ObsData *rod;
+       * while ((rod = rdr.next()) != nullptr)
+       * {
+       *    process(rdr.getHeader(), *rod);
+       * }
+       * @endcode
+       *
+       * @note The methods of this class must all be called from the
+       *   same thread.
+       * @note Line and record numbers in the text of exceptions
+       *   are relative to the start of the chunk being parsed.
+       */
+   class Rinex3ObsParallelReader
+   {
+   public:
+         /** Function given each record by read().  Return false to
+          * stop reading. */
+      typedef std::function<bool(const Rinex3ObsData&)> Callback;
+
+         /// Default size in bytes of the chunks given to the workers.
+      static const size_t defaultChunkSize = 1024 * 1024;
+
+         /** Open a file, read its header and start the worker threads.
+          * @param[in] fn The path of the RINEX obs file to read.
+          * @param[in] numThreads The number of worker threads to
+          *   use, where 0 means to use one per processor.  If 1, the
+          *   file is read sequentially with no worker threads.
+          * @param[in] chunkSize The approximate number of bytes of
+          *   the file to give to a worker at a time.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header can't be read. */
+      Rinex3ObsParallelReader(const std::string& fn,
+                              unsigned numThreads = 0,
+                              size_t chunkSize = defaultChunkSize);
+
+         /// Stop the worker threads, discarding any unread records.
+      ~Rinex3ObsParallelReader();
+
+         /// Return the header of the file.
+      const Rinex3ObsHeader& getHeader() const
+      { return strm.header; }
+
+         /** Get the next record in the file.
+          * @return A pointer to the record, which remains valid
+          *   until the next call, or nullptr at the end of the file.
+          * @throw Exception if the record can't be parsed, as
+          *   reading from a Rinex3ObsStream with the failbit
+          *   exception enabled would, after all of the records before
+          *   it have been returned.  Nothing more is returned after
+          *   that. */
+      const Rinex3ObsData* next();
+
+         /** Give each of the remaining records in the file to cb,
+          * in file order.
+          * @param[in] cb The function to give the records to.
+          * @return false if cb returned false, true otherwise.
+          * @throw Exception as next(). */
+      bool read(const Callback& cb);
+
+         /// Return the number of worker threads (0 if none).
+      unsigned getNumThreads() const
+      { return workers.size(); }
+
+   private:
+         /// A range of the file to be parsed by a worker.
+      struct Chunk
+      {
+         Chunk(std::streamoff b, std::streamoff e)
+               : begin(b), end(e), parsedEnd(b), done(false),
+                 checked(false), nextRec(0)
+         {}
+            /// Offset of the first epoch record in the chunk.
+         std::streamoff begin;
+            /// Offset of the end of the chunk.
+         std::streamoff end;
+            /** Offset of the end of the last record parsed, which is
+             * past end if that record continued into the next chunk. */
+         std::streamoff parsedEnd;
+            /// True once the worker has finished with the chunk.
+         bool done;
+            /// True once the chunk's start has been checked by next().
+         bool checked;
+            /// The records parsed, in a deque as they can't be moved.
+         std::deque<Rinex3ObsData> data;
+            /// Index in data of the next record to return.
+         size_t nextRec;
+            /// Any exception thrown while parsing.
+         std::exception_ptr exc;
+      };
+
+         /// Parse chunks in a worker thread until told to stop.
+      void run();
+
+         /** Open another stream on the file and read the header.
+          * @param[in,out] s The stream to open. */
+      void openStream(Rinex3ObsStream& s) const;
+
+         /** Parse the records of a chunk.  Any exception is stored in
+          * the chunk rather than thrown.
+          * @param[in,out] s The stream to read the records from.
+          * @param[in,out] c The chunk to parse. */
+      void parse(Rinex3ObsStream& s, Chunk& c) const;
+
+         /** Find the offsets of the chunks that the body of the file
+          * will be divided into.
+          * @param[in] headerEnd The offset of the end of the header.
+          * @param[in] chunkSize The target size of the chunks.
+          * @return false if the file can't be opened. */
+      bool split(std::streamoff headerEnd, size_t chunkSize);
+
+         /// Queue chunks for the workers, up to maxPending of them.
+      void submit();
+
+         /// Discard everything not yet returned, after an error.
+      void fail();
+
+         /// The path of the file being read.
+      std::string filename;
+         /** The stream used for the header and, when reading
+          * sequentially, for the records. */
+      Rinex3ObsStream strm;
+         /// The record returned by next() when reading sequentially.
+      Rinex3ObsData current;
+         /// Offsets of the chunk boundaries, starting with headerEnd.
+      std::vector<std::streamoff> bounds;
+         /// The size of the file.
+      std::streamoff fileSize;
+         /// Index in bounds of the start of the next chunk to queue.
+      size_t nextChunk;
+         /// Queued chunks not yet completely returned, in file order.
+      std::deque<std::unique_ptr<Chunk> > chunks;
+         /// Where the last chunk completely returned was parsed to.
+      std::streamoff prevEnd;
+         /// The most chunks that may be queued at once.
+      size_t maxPending;
+         /// Set once an exception has been thrown by next().
+      bool failed;
+         /// The worker threads, empty if reading sequentially.
+      std::vector<std::thread> workers;
+         /// Guards jobs, stopping and the done flags of chunks.
+      std::mutex mtx;
+         /// Chunks waiting for a worker.
+      std::deque<Chunk*> jobs;
+         /// Signalled when a job is queued or stopping is set.
+      std::condition_variable jobReady;
+         /// Signalled when a chunk is done.
+      std::condition_variable chunkDone;
+         /// Set to stop the workers.
+      bool stopping;
+   }; // class Rinex3ObsParallelReader
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_RINEX3OBSPARALLELREADER_HPP
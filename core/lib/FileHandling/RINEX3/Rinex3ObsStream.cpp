@@ -91,6 +91,8 @@ namespace gnsstk
       headerRead = false;
       header = Rinex3ObsHeader();
       timesystem = TimeSystem::GPS;
+      satIDCache.clear();
+      updateObsFilter();
    }
 
 
@@ -117,4 +119,79 @@ namespace gnsstk
       return true;
    }
 
+
+   const RinexSatID& Rinex3ObsStream ::
+   getSatID(const FFTextLine& text)
+   {
+      GNSSTK_ASSERT(text.size() <= 3);
+      unsigned long key = text.size();
+      for (size_t i = 0; i < text.size(); i++)
+      {
+         key = (key << 8) | static_cast<unsigned char>(text[i]);
+      }
+      std::map<unsigned long, RinexSatID>::iterator i = satIDCache.find(key);
+      if (i == satIDCache.end())
+      {
+         i = satIDCache.insert(std::make_pair(key,
+                                              RinexSatID(text.str()))).first;
+      }
+      return i->second;
+   }
+
+
+   void Rinex3ObsStream ::
+   setWantedObsTypes(const Rinex3ObsHeader::RinexObsMap& wanted)
+   {
+      wantedObsTypes = wanted;
+      updateObsFilter();
+   }
+
+
+   void Rinex3ObsStream ::
+   setExcludedSats(const std::set<RinexSatID>& sats)
+   {
+      excludedSats = sats;
+   }
+
+
+   bool Rinex3ObsStream ::
+   isSatWanted(const RinexSatID& sat) const
+   {
+      if (!excludedSats.empty() && excludedSats.count(sat))
+         return false;
+      return (wantedObsTypes.empty() ||
+              wantedObs.find(sat.systemChar()) != wantedObs.end());
+   }
+
+
+   void Rinex3ObsStream ::
+   updateObsFilter()
+   {
+      wantedObs.clear();
+      if (wantedObsTypes.empty())
+         return;
+      for (const auto& hi : header.mapObsTypes)
+      {
+         Rinex3ObsHeader::RinexObsMap::const_iterator wi =
+            wantedObsTypes.find(hi.first);
+         if (hi.first.empty() || wi == wantedObsTypes.end())
+            continue;
+         std::vector<bool> cols(hi.second.size(), false);
+         bool any = false;
+         for (size_t i = 0; i < hi.second.size(); i++)
+         {
+            for (const auto& w : wi->second)
+            {
+               if (w == hi.second[i])
+               {
+                  cols[i] = any = true;
+                  break;
+               }
+            }
+         }
+         if (any)
+            wantedObs[hi.first[0]].swap(cols);
+      }
+   }
+
 } // namespace gnsstk
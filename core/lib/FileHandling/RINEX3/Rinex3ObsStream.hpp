@@ -47,10 +47,12 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 
 #include "FFTextStream.hpp"
 #include "Rinex3ObsHeader.hpp"
+#include "RinexSatID.hpp"
 
 namespace gnsstk
 {
@@ -115,9 +117,70 @@ namespace gnsstk
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
+         /** Parse a satellite ID from an observation record.  This is
+          * equivalent to RinexSatID(text.str()), but the results are
+          * cached as the same few IDs appear in every epoch.
+          * @param[in] text The satellite ID field, at most 3 characters.
+          * @throw Exception if \a text is not a valid satellite ID.
+          * @throw AssertionFailure if \a text is too long.
+          */
+      const RinexSatID& getSatID(const FFTextLine& text);
+
+         /** Only parse the given observation types of records read
+          * from this stream.  Observations of other types are left
+          * blank, so the records keep the layout of the header's
+          * mapObsTypes, and satellites of systems with none of the
+          * wanted types are left out of the records entirely.
+          * @param[in] wanted The observation types to keep, keyed by
+          *   system as in Rinex3ObsHeader::mapObsTypes.  Types are
+          *   matched using RinexObsID::operator==().  An empty map
+          *   keeps all observations.
+          */
+      void setWantedObsTypes(const Rinex3ObsHeader::RinexObsMap& wanted);
+
+         /** Leave satellites out of records read from this stream.
+          * @param[in] sats The satellites to skip. */
+      void setExcludedSats(const std::set<RinexSatID>& sats);
+
+         /** Return true if records read from this stream should
+          * contain the given satellite, according to
+          * setWantedObsTypes() and setExcludedSats(). */
+      bool isSatWanted(const RinexSatID& sat) const;
+
+         /** Return which observations of a satellite to parse.
+          * @param[in] sat A satellite for which isSatWanted() is true.
+          * @return nullptr if all observations are wanted, otherwise
+          *   a vector parallel to header.mapObsTypes for the
+          *   satellite's system that is true for the wanted types. */
+      const std::vector<bool>* getWantedObs(const RinexSatID& sat) const
+      {
+         if (wantedObsTypes.empty())
+            return nullptr;
+         std::map<char, std::vector<bool> >::const_iterator i =
+            wantedObs.find(sat.systemChar());
+         return (i == wantedObs.end() ? nullptr : &i->second);
+      }
+
+         /** Match the header's observation types against the wanted
+          * ones.  This is called when the header is read and only
+          * needs to be called otherwise if header is changed
+          * directly. */
+      void updateObsFilter();
+
    private:
          /// Initialize internal data structures.
       void init();
+
+         /** Satellite IDs returned by getSatID(), keyed by the
+          * length and characters of their text. */
+      std::map<unsigned long, RinexSatID> satIDCache;
+         /// Observation types given to setWantedObsTypes().
+      Rinex3ObsHeader::RinexObsMap wantedObsTypes;
+         /// Satellites given to setExcludedSats().
+      std::set<RinexSatID> excludedSats;
+         /** For each system with at least one wanted observation
+          * type in the header, which header columns are wanted. */
+      std::map<char, std::vector<bool> > wantedObs;
    }; // class 'Rinex3ObsStream'
 
       //@}
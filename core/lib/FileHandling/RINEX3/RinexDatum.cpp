@@ -65,39 +65,47 @@ namespace gnsstk
    void RinexDatum ::
    fromString(const std::string& str)
    {
-      std::string tmpStr;
       GNSSTK_ASSERT(str.length() == 16);
-      tmpStr = str.substr(0, 14);
-      if (tmpStr.find_last_not_of(" ") == std::string::npos)
+      fromString(FFTextLine(str));
+   }
+
+
+   void RinexDatum ::
+   fromString(const FFTextLine& str)
+   {
+      GNSSTK_ASSERT(str.length() <= 16);
+      FFTextLine tmpStr(str.substr(0, 14));
+      if (tmpStr.isBlank())
       {
          data = 0.;
          dataBlank = true;
       }
       else
       {
-         data = StringUtils::asDouble(tmpStr);
+         data = tmpStr.asDouble();
          dataBlank = false;
       }
-      tmpStr = str.substr(14, 1);
-      if (tmpStr == " ")
+      char c = (str.length() > 14) ? str[14] : ' ';
+      if (c == ' ')
       {
          lli = 0.;
          lliBlank = true;
       }
       else
       {
-         lli = StringUtils::asInt(tmpStr);
+            // as StringUtils::asInt, anything but a digit is zero
+         lli = ((c >= '0') && (c <= '9')) ? (c - '0') : 0;
          lliBlank = false;
       }
-      tmpStr = str.substr(15, 1);
-      if (tmpStr == " ")
+      c = (str.length() > 15) ? str[15] : ' ';
+      if (c == ' ')
       {
          ssi = 0.;
          ssiBlank = true;
       }
       else
       {
-         ssi = StringUtils::asInt(tmpStr);
+         ssi = ((c >= '0') && (c <= '9')) ? (c - '0') : 0;
          ssiBlank = false;
       }
    }
@@ -45,6 +45,7 @@
 #define RINEXDATUM_HPP
 
 #include <string>
+#include "FFTextLine.hpp"
 
 namespace gnsstk
 {
@@ -70,6 +71,14 @@ namespace gnsstk
           * @throw AssertionFailure if str.length() != 16 */
       void fromString(const std::string& str);
 
+         /** Parse a RINEX OBS datum from a view of the record, without
+          * copying it.  Fields shorter than 16 characters are treated
+          * as though padded with blanks, as RINEX 3 allows.
+          * @param[in] str a RINEX-formatted datum, at most 16
+          *   characters in length.
+          * @throw AssertionFailure if str.length() > 16 */
+      void fromString(const FFTextLine& str);
+
          /// Turn this datum into a RINEX OBS formatted string
       std::string asString() const;
 
@@ -42,6 +42,7 @@
  */
 
 #include "StringUtils.hpp"
+#include "FixedField.hpp"
 #include "SinexTypes.hpp"
 
 using namespace gnsstk::StringUtils;
@@ -511,10 +512,10 @@ namespace Sinex
          longitudeDeg = asUnsigned(line.substr(44, 3) );
          longitudeMin = asUnsigned(line.substr(48, 2) );
          longitudeSec = asFloat(line.substr(51, 4) );
-         latitudeDeg  = asInt(line.substr(56, 3) );
+         latitudeDeg  = FixedField::asInt(line, 56, 3);
          latitudeMin  = asUnsigned(line.substr(60, 2) );
          latitudeSec  = asFloat(line.substr(63, 4) );
-         height       = asDouble(line.substr(68, 7) );
+         height       = FixedField::asDouble(line, 68, 7);
       }
       catch (Exception& exc)
       {
@@ -784,12 +785,12 @@ namespace Sinex
          isValidLineStructure(line, MIN_LINE_LEN, MAX_LINE_LEN, FIELD_DIVS);
          antennaType = line.substr(1, 20);
          antennaSerialNo = line.substr(22, 5);
-         offsetA[0] = asDouble(line.substr(28, 6) );
-         offsetA[1] = asDouble(line.substr(35, 6) );
-         offsetA[2] = asDouble(line.substr(42, 6) );
-         offsetB[0] = asDouble(line.substr(49, 6) );
-         offsetB[1] = asDouble(line.substr(56, 6) );
-         offsetB[2] = asDouble(line.substr(63, 6) );
+         offsetA[0] = FixedField::asDouble(line, 28, 6);
+         offsetA[1] = FixedField::asDouble(line, 35, 6);
+         offsetA[2] = FixedField::asDouble(line, 42, 6);
+         offsetB[0] = FixedField::asDouble(line, 49, 6);
+         offsetB[1] = FixedField::asDouble(line, 56, 6);
+         offsetB[2] = FixedField::asDouble(line, 63, 6);
          antennaCalibration = line.substr(70, 10);
       }
       catch (Exception& exc)
@@ -879,9 +880,9 @@ namespace Sinex
          timeSince = line.substr(16,12);
          timeUntil = line.substr(29,12);
          refSystem = line.substr(42, 3);
-         eccentricity[0] = asDouble(line.substr(46, 8) );
-         eccentricity[1] = asDouble(line.substr(55, 8) );
-         eccentricity[2] = asDouble(line.substr(64, 8) );
+         eccentricity[0] = FixedField::asDouble(line, 46, 8);
+         eccentricity[1] = FixedField::asDouble(line, 55, 8);
+         eccentricity[2] = FixedField::asDouble(line, 64, 8);
       }
       catch (Exception& exc)
       {
@@ -1008,13 +1009,13 @@ namespace Sinex
          isValidLineStructure(line, MIN_LINE_LEN, MAX_LINE_LEN, FIELD_DIVS);
          svCode     = line.substr(1, 4);
          freqCodeA  = line[6];
-         offsetA[2] = asDouble(line.substr(8, 6) );
-         offsetA[0] = asDouble(line.substr(15, 6) );
-         offsetA[1] = asDouble(line.substr(22, 6) );
+         offsetA[2] = FixedField::asDouble(line, 8, 6);
+         offsetA[0] = FixedField::asDouble(line, 15, 6);
+         offsetA[1] = FixedField::asDouble(line, 22, 6);
          freqCodeB  = line[29];
-         offsetB[2] = asDouble(line.substr(31, 6) );
-         offsetB[0] = asDouble(line.substr(38, 6) );
-         offsetB[1] = asDouble(line.substr(45, 6) );
+         offsetB[2] = FixedField::asDouble(line, 31, 6);
+         offsetB[0] = FixedField::asDouble(line, 38, 6);
+         offsetB[1] = FixedField::asDouble(line, 45, 6);
          antennaCalibration = line.substr(52, 10);
          pcvType    = line[63];
          pcvModel   = line[65];
@@ -1260,8 +1261,8 @@ namespace Sinex
          epoch = line.substr(27,12);
          paramUnits     = line.substr(40, 4);
          constraintCode = line[45];
-         paramEstimate  = asDouble(line.substr(47, 21) );
-         paramStdDev    = asDouble(line.substr(69, 11) );
+         paramEstimate  = FixedField::asDouble(line, 47, 21);
+         paramStdDev    = FixedField::asDouble(line, 69, 11);
       }
       catch (Exception& exc)
       {
@@ -1330,8 +1331,8 @@ namespace Sinex
          epoch      = line.substr(27,12);
          paramUnits     = line.substr(40, 4);
          constraintCode = line[45];
-         paramApriori   = asDouble(line.substr(47, 21) );
-         paramStdDev    = asDouble(line.substr(69, 11) );
+         paramApriori   = FixedField::asDouble(line, 47, 21);
+         paramStdDev    = FixedField::asDouble(line, 69, 11);
       }
       catch (Exception& exc)
       {
@@ -1387,9 +1388,9 @@ namespace Sinex
          isValidLineStructure(line, MIN_LINE_LEN, MAX_LINE_LEN, FIELD_DIVS);
          row  = asUnsigned(line.substr(1, 5) );
          col  = asUnsigned(line.substr(7, 5) );
-         val1 = asDouble(line.substr(13, 21) );
-         val2 = asDouble(line.substr(35, 21) );
-         val3 = asDouble(line.substr(57, 21) );
+         val1 = FixedField::asDouble(line, 13, 21);
+         val2 = FixedField::asDouble(line, 35, 21);
+         val3 = FixedField::asDouble(line, 57, 21);
       }
       catch (Exception& exc)
       {
@@ -1500,9 +1501,9 @@ namespace Sinex
          isValidLineStructure(line, MIN_LINE_LEN, MAX_LINE_LEN, FIELD_DIVS);
          row  = asUnsigned(line.substr(1, 5) );
          col  = asUnsigned(line.substr(7, 5) );
-         val1 = asDouble(line.substr(13, 21) );
-         val2 = asDouble(line.substr(35, 21) );
-         val3 = asDouble(line.substr(57, 21) );
+         val1 = FixedField::asDouble(line, 13, 21);
+         val2 = FixedField::asDouble(line, 35, 21);
+         val3 = FixedField::asDouble(line, 57, 21);
       }
       catch (Exception& exc)
       {
@@ -1624,7 +1625,7 @@ namespace Sinex
          epoch      = line.substr(27,12);
          paramUnits     = line.substr(40, 4);
          constraintCode = line[45];
-         value          = asDouble(line.substr(47, 21) );
+         value          = FixedField::asDouble(line, 47, 21);
       }
       catch (Exception& exc)
       {
@@ -1680,9 +1681,9 @@ namespace Sinex
          isValidLineStructure(line, MIN_LINE_LEN, MAX_LINE_LEN, FIELD_DIVS);
          row  = asUnsigned(line.substr(1, 5) );
          col  = asUnsigned(line.substr(7, 5) );
-         val1 = asDouble(line.substr(13, 21) );
-         val2 = asDouble(line.substr(35, 21) );
-         val3 = asDouble(line.substr(57, 21) );
+         val1 = FixedField::asDouble(line, 13, 21);
+         val2 = FixedField::asDouble(line, 35, 21);
+         val3 = FixedField::asDouble(line, 57, 21);
       }
       catch (Exception& exc)
       {
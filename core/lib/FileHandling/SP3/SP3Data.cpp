@@ -43,6 +43,7 @@
 #include "SP3Header.hpp"
 #include "SP3Data.hpp"
 #include "StringUtils.hpp"
+#include "FixedField.hpp"
 #include "CivilTime.hpp"
 #include "GPSWeekSecond.hpp"
 
@@ -158,12 +159,12 @@ namespace gnsstk
 
             // parse the epoch line
             RecType = strm.lastLine[0];
-            int year = asInt(strm.lastLine.substr(3,4));
-            int month = asInt(strm.lastLine.substr(8,2));
-            int dom = asInt(strm.lastLine.substr(11,2));
-            int hour = asInt(strm.lastLine.substr(14,2));
-            int minute = asInt(strm.lastLine.substr(17,2));
-            double second = asInt(strm.lastLine.substr(20,10));
+            int year = FixedField::asInt(strm.lastLine, 3, 4);
+            int month = FixedField::asInt(strm.lastLine, 8, 2);
+            int dom = FixedField::asInt(strm.lastLine, 11, 2);
+            int hour = FixedField::asInt(strm.lastLine, 14, 2);
+            int minute = FixedField::asInt(strm.lastLine, 17, 2);
+            double second = FixedField::asInt(strm.lastLine, 20, 10);
             CivilTime t;
             try {
                t = CivilTime(year, month, dom, hour, minute, second, timeSystem);
@@ -202,10 +203,10 @@ namespace gnsstk
             // parse the line
             sat = static_cast<SatID>(SP3SatID(strm.lastLine.substr(1,3)));
 
-            x[0] = asDouble(strm.lastLine.substr(4,14));             // XYZ
-            x[1] = asDouble(strm.lastLine.substr(18,14));
-            x[2] = asDouble(strm.lastLine.substr(32,14));
-            clk = asDouble(strm.lastLine.substr(46,14));             // Clock
+            x[0] = FixedField::asDouble(strm.lastLine, 4, 14); // XYZ
+            x[1] = FixedField::asDouble(strm.lastLine, 18, 14);
+            x[2] = FixedField::asDouble(strm.lastLine, 32, 14);
+            clk = FixedField::asDouble(strm.lastLine, 46, 14); // Clock
 
             // handle NGA extension to SP3a - the event flag
             eventFlag = false;
@@ -219,10 +220,10 @@ namespace gnsstk
 
             // the rest is version c only
             if(isVerC) {
-               sig[0] = asInt(strm.lastLine.substr(61,2));           // sigma XYZ
-               sig[1] = asInt(strm.lastLine.substr(64,2));
-               sig[2] = asInt(strm.lastLine.substr(67,2));
-               sig[3] = asInt(strm.lastLine.substr(70,3));           // sigma clock
+               sig[0] = FixedField::asInt(strm.lastLine, 61, 2); // sigma XYZ
+               sig[1] = FixedField::asInt(strm.lastLine, 64, 2);
+               sig[2] = FixedField::asInt(strm.lastLine, 67, 2);
+               sig[3] = FixedField::asInt(strm.lastLine, 70, 3); // sigma clock
 
                if(RecType == 'P') {                                  // P flags
                   clockEventFlag = clockPredFlag
@@ -257,16 +258,16 @@ namespace gnsstk
             }
 
             // parse the line
-            sdev[0] = abs(asInt(strm.lastLine.substr(4,4)));
-            sdev[1] = abs(asInt(strm.lastLine.substr(9,4)));
-            sdev[2] = abs(asInt(strm.lastLine.substr(14,4)));
-            sdev[3] = abs(asInt(strm.lastLine.substr(19,7)));
-            correlation[0] = asInt(strm.lastLine.substr(27,8));
-            correlation[1] = asInt(strm.lastLine.substr(36,8));
-            correlation[2] = asInt(strm.lastLine.substr(45,8));
-            correlation[3] = asInt(strm.lastLine.substr(54,8));
-            correlation[4] = asInt(strm.lastLine.substr(63,8));
-            correlation[5] = asInt(strm.lastLine.substr(72,8));
+            sdev[0] = abs(FixedField::asInt(strm.lastLine, 4, 4));
+            sdev[1] = abs(FixedField::asInt(strm.lastLine, 9, 4));
+            sdev[2] = abs(FixedField::asInt(strm.lastLine, 14, 4));
+            sdev[3] = abs(FixedField::asInt(strm.lastLine, 19, 7));
+            correlation[0] = FixedField::asInt(strm.lastLine, 27, 8);
+            correlation[1] = FixedField::asInt(strm.lastLine, 36, 8);
+            correlation[2] = FixedField::asInt(strm.lastLine, 45, 8);
+            correlation[3] = FixedField::asInt(strm.lastLine, 54, 8);
+            correlation[4] = FixedField::asInt(strm.lastLine, 63, 8);
+            correlation[5] = FixedField::asInt(strm.lastLine, 72, 8);
 
             // tell the caller that correlation data is now present
             correlationFlag = true;
@@ -0,0 +1,124 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file BDSBCH.cpp
+ * BCH(15,11,1) parity checking for BeiDou D1 and D2 navigation messages.
+ */
+
+#include "BDSBCH.hpp"
+#include "PackedNavBits.hpp"
+
+namespace gnsstk
+{
+      /** Lookup table for BDSBCH.  Entry i is the remainder of i
+       * followed by four zero bits, divided by the generator
+       * polynomial, i.e. the parity bits of information bits i. */
+   struct BDSBCHTable
+   {
+      BDSBCHTable()
+      {
+         for (uint32_t i = 0; i < 2048; i++)
+         {
+            uint32_t reg = i << 4;
+            for (int bit = 14; bit >= 4; bit--)
+            {
+               if (reg & (1 << bit))
+               {
+                  reg ^= BDSBCH::poly << (bit - 4);
+               }
+            }
+            table[i] = static_cast<uint8_t>(reg);
+         }
+      }
+      uint8_t table[2048];
+   };
+
+
+      /// Get the table, which is initialized on first use.
+   static const BDSBCHTable& bdsBCHTable()
+   {
+      static const BDSBCHTable table;
+      return table;
+   }
+
+
+   uint8_t BDSBCH ::
+   parity(uint16_t info)
+   {
+      return bdsBCHTable().table[info & 0x7ff];
+   }
+
+
+   bool BDSBCH ::
+   checkWord(uint32_t word, bool first)
+   {
+      if (first)
+      {
+         return checkCodeWord(word & 0x7fff);
+      }
+      return ((parity((word >> 19) & 0x7ff) == ((word >> 4) & 0x0f)) &&
+              (parity((word >> 8) & 0x7ff) == (word & 0x0f)));
+   }
+
+
+   bool BDSBCH ::
+   check(const PackedNavBits& pnb, std::size_t startBit)
+   {
+      if (startBit + subframeBits > pnb.getNumBits())
+      {
+         InvalidParameter exc("Subframe extends past the end of the"
+                              " message");
+         GNSSTK_THROW(exc);
+      }
+      if (!checkWord(pnb.asUnsignedLong(startBit, 30, 1), true))
+      {
+         return false;
+      }
+      for (std::size_t bit = startBit+30; bit < startBit+subframeBits;
+           bit += 30)
+      {
+         if (!checkWord(pnb.asUnsignedLong(bit, 30, 1), false))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,113 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file BDSBCH.hpp
+ * BCH(15,11,1) parity checking for BeiDou D1 and D2 navigation messages.
+ */
+
+#ifndef GNSSTK_BDSBCH_HPP
+#define GNSSTK_BDSBCH_HPP
+
+#include <cstddef>
+#include "gnsstkplatform.h"
+
+namespace gnsstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      // forward declaration
+   class PackedNavBits;
+
+      /** Check the BCH(15,11,1) error detection code of BeiDou D1
+       * and D2 navigation message subframes (BDS-SIS-ICD-2.1 section
+       * 5.1.3), using a table of the 4 parity bits for each value of
+       * the 11 information bits.
+       *
+       * The first 15 bits of the first word of a subframe are not
+       * encoded, the remaining 15 are one code word.  Each of the
+       * other nine words consists of two interleaved code words.
+       * PackedNavBits holds them de-interleaved, as they are stored
+       * by the receivers the data are collected from: the 11
+       * information bits of the first code word, the 11 information
+       * bits of the second, then the 4 parity bits of the first and
+       * the 4 parity bits of the second.
+       */
+   class BDSBCH
+   {
+   public:
+         /// Generator polynomial x^4+x+1.
+      static const uint32_t poly = 0x13;
+         /// Number of bits in a subframe.
+      static const std::size_t subframeBits = 300;
+
+         /** Get the parity bits of a code word.
+          * @param[in] info The 11 information bits, right-justified.
+          * @return The 4 parity bits, right-justified. */
+      static uint8_t parity(uint16_t info);
+
+         /** Check a single code word.
+          * @param[in] codeWord The 11 information bits followed by
+          *   the 4 parity bits, right-justified.
+          * @return true if the parity bits match. */
+      static bool checkCodeWord(uint16_t codeWord)
+      { return parity((codeWord >> 4) & 0x7ff) == (codeWord & 0x0f); }
+
+         /** Check the code words in a 30-bit subframe word.
+          * @param[in] word The word to check, right-justified.
+          * @param[in] first If true, word is the first word of a
+          *   subframe, which contains only one code word.
+          * @return true if the parity bits of all code words in
+          *   word match. */
+      static bool checkWord(uint32_t word, bool first);
+
+         /** Check all ten words of a subframe.
+          * @param[in] pnb The subframe to check.
+          * @param[in] startBit The 0-indexed first bit of the subframe.
+          * @return true if the parity bits of all code words match.
+          * @throw InvalidParameter if pnb does not contain the
+          *   whole subframe. */
+      static bool check(const PackedNavBits& pnb, std::size_t startBit = 0);
+   }; // class BDSBCH
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_BDSBCH_HPP
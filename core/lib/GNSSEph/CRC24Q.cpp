@@ -0,0 +1,176 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CRC24Q.cpp
+ * Table-driven CRC-24Q computation for navigation messages.
+ */
+
+#include "CRC24Q.hpp"
+#include "PackedNavBits.hpp"
+
+namespace gnsstk
+{
+      /** Lookup tables for CRC24Q.  The 24-bit CRC is computed as a
+       * 32-bit CRC with the remainder in the upper 24 bits, which
+       * allows the usual slicing-by-4 algorithm to be used.  Entry
+       * [k][i] is the register after processing byte i followed by k
+       * zero bytes. */
+   struct CRC24QTables
+   {
+      CRC24QTables()
+      {
+         const uint32_t poly32 = CRC24Q::poly << 8;
+         for (uint32_t i = 0; i < 256; i++)
+         {
+            uint32_t reg = i << 24;
+            for (unsigned bit = 0; bit < 8; bit++)
+            {
+               reg = (reg & 0x80000000) ? ((reg << 1) ^ poly32) : (reg << 1);
+            }
+            table[0][i] = reg;
+         }
+         for (unsigned k = 1; k < 4; k++)
+         {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+               uint32_t prev = table[k-1][i];
+               table[k][i] = (prev << 8) ^ table[0][prev >> 24];
+            }
+         }
+      }
+      uint32_t table[4][256];
+   };
+
+
+      /// Get the tables, which are initialized on first use.
+   static const CRC24QTables& crc24qTables()
+   {
+      static const CRC24QTables tables;
+      return tables;
+   }
+
+
+   void CRC24Q ::
+   process32(uint32_t word)
+   {
+      const CRC24QTables& t(crc24qTables());
+      uint32_t reg = (rem << 8) ^ word;
+      reg = t.table[3][reg >> 24] ^ t.table[2][(reg >> 16) & 0xff] ^
+         t.table[1][(reg >> 8) & 0xff] ^ t.table[0][reg & 0xff];
+      rem = reg >> 8;
+   }
+
+
+   void CRC24Q ::
+   process8(uint8_t byte)
+   {
+      const CRC24QTables& t(crc24qTables());
+      rem = ((rem << 8) & 0x00ffffff) ^ (t.table[0][(rem >> 16) ^ byte] >> 8);
+   }
+
+
+   void CRC24Q ::
+   process_bits(uint64_t bits, unsigned numBits)
+   {
+      while (numBits >= 32)
+      {
+         numBits -= 32;
+         process32(static_cast<uint32_t>(bits >> numBits));
+      }
+      while (numBits >= 8)
+      {
+         numBits -= 8;
+         process8(static_cast<uint8_t>(bits >> numBits));
+      }
+      while (numBits > 0)
+      {
+         numBits--;
+         process_bit((bits >> numBits) & 1);
+      }
+   }
+
+
+   void CRC24Q ::
+   process_bytes(void const *buffer, std::size_t byte_count)
+   {
+      uint8_t const *b = static_cast<uint8_t const *>(buffer);
+      for (; byte_count >= 4; byte_count -= 4, b += 4)
+      {
+         process32((uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) |
+                   (uint32_t(b[2]) << 8) | uint32_t(b[3]));
+      }
+      for (; byte_count > 0; byte_count--)
+      {
+         process8(*b++);
+      }
+   }
+
+
+   void CRC24Q ::
+   process(const PackedNavBits& pnb, std::size_t startBit,
+           std::size_t numBits)
+   {
+      for (; numBits >= 32; numBits -= 32, startBit += 32)
+      {
+         process32(pnb.asUnsignedLong(startBit, 32, 1));
+      }
+      if (numBits > 0)
+      {
+         process_bits(pnb.asUnsignedLong(startBit, numBits, 1), numBits);
+      }
+   }
+
+
+   void CRC24Q ::
+   process(const PackedNavBits& pnb)
+   {
+      process(pnb, 0, pnb.getNumBits());
+   }
+
+
+   bool CRC24Q ::
+   check(const PackedNavBits& pnb, std::size_t startBit, std::size_t numBits)
+   {
+      CRC24Q crc;
+      crc.process(pnb, startBit, numBits);
+      return crc.checksum() == 0;
+   }
+
+} // namespace gnsstk
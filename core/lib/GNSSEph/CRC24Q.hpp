@@ -0,0 +1,146 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CRC24Q.hpp
+ * Table-driven CRC-24Q computation for navigation messages.
+ */
+
+#ifndef GNSSTK_CRC24Q_HPP
+#define GNSSTK_CRC24Q_HPP
+
+#include <cstddef>
+#include "gnsstkplatform.h"
+
+namespace gnsstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      // forward declaration
+   class PackedNavBits;
+
+      /** Compute the CRC-24Q (Qualcomm) checksum used by GPS CNAV,
+       * CNAV-2 and Galileo I/NAV and F/NAV messages.  Data is
+       * processed most significant bit first with an initial value of
+       * zero, using a slicing-by-4 table for each 32 bits, a byte
+       * table for each remaining 8 bits and a bit at a time for
+       * anything left over.  Since the CRC of a message followed by
+       * its own CRC is zero, the usual way to check a message is
+       * process() over the whole message including the parity bits,
+       * followed by a test of checksum()==0.
+       */
+   class CRC24Q
+   {
+   public:
+         /// Number of bits in the checksum.
+      static const std::size_t bit_count = 24;
+         /// CRC-24Q polynomial, without the leading 1 bit.
+      static const uint32_t poly = 0x864cfb;
+
+         /// Initialize with a zero remainder.
+      CRC24Q()
+            : rem(0)
+      {}
+
+         /// Start a new computation.
+      void reset()
+      { rem = 0; }
+
+         /// Add a single bit to the CRC.
+      void process_bit(bool bit)
+      {
+         rem ^= (bit ? 0x00800000 : 0);
+         bool const pdiv = static_cast<bool>(rem & 0x00800000);
+         rem = (rem << 1) & 0x00ffffff;
+         if (pdiv)
+            rem ^= poly;
+      }
+
+         /** Add bits to the CRC.
+          * @param[in] bits The data to process, right-justified.
+          * @param[in] numBits The number of least significant bits
+          *   of bits to process, most significant first (0-64). */
+      void process_bits(uint64_t bits, unsigned numBits);
+
+         /** Add a buffer of bytes to the CRC, processing the most
+          * significant bit of each byte first. */
+      void process_bytes(void const *buffer, std::size_t byte_count);
+
+         /** Add a range of bits in a PackedNavBits object to the CRC.
+          * @param[in] pnb The bits to process.
+          * @param[in] startBit The 0-indexed first bit to process.
+          * @param[in] numBits The number of bits to process.
+          * @throw InvalidParameter if the bits are not present in pnb.
+          */
+      void process(const PackedNavBits& pnb, std::size_t startBit,
+                   std::size_t numBits);
+
+         /** Add all of the bits in a PackedNavBits object to the CRC.
+          * @param[in] pnb The bits to process. */
+      void process(const PackedNavBits& pnb);
+
+         /// Get the 24-bit CRC of the data processed so far.
+      uint32_t checksum() const
+      { return rem; }
+
+         /** Check the CRC of a range of bits, where the last 24 bits
+          * of the range are the CRC of the preceding bits.
+          * @param[in] pnb The message to check.
+          * @param[in] startBit The 0-indexed first bit of the message.
+          * @param[in] numBits The number of bits in the message,
+          *   including the 24 CRC bits.
+          * @return true if the CRC matches. */
+      static bool check(const PackedNavBits& pnb, std::size_t startBit,
+                        std::size_t numBits);
+
+   private:
+         /// Add 32 bits to the CRC using the slicing-by-4 tables.
+      void process32(uint32_t word);
+         /// Add 8 bits to the CRC using the byte table.
+      void process8(uint8_t byte);
+
+      uint32_t rem; ///< The current 24-bit remainder.
+   }; // class CRC24Q
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_CRC24Q_HPP
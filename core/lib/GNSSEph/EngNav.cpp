@@ -46,6 +46,7 @@
 #include <cmath>
 #include "EngNav.hpp"
 #include "GNSSconstants.hpp"
+#include "PackedNavBits.hpp"
 
 #ifdef _MSC_VER
 #define LDEXP(x,y) ldexp(x,y)
@@ -634,6 +635,18 @@ namespace gnsstk
    }
 
 
+      /** Return the modulo-2 sum of the bits of v, i.e. 1 if an odd
+       * number of bits are set.  Folding the word onto itself is
+       * considerably cheaper than counting the bits. */
+   static inline uint32_t bitParity(uint32_t v)
+   {
+      v ^= v >> 16;
+      v ^= v >> 8;
+      v ^= v >> 4;
+      return (0x6996 >> (v & 0x0f)) & 1;
+   }
+
+
    uint32_t EngNav :: computeParity(uint32_t sfword,
                                     uint32_t psfword,
                                     bool knownUpright)
@@ -658,8 +671,9 @@ namespace gnsstk
            D29    10 1011 1011 0001 1111 0011 0100 0000
            D30    00 1011 0111 1010 1000 1001 1100 0000
          */
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                            0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+      static const uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L,
+                                         0x2EC7CD00L, 0x1763E680L,
+                                         0x2BB1F340L, 0x0B7A89C0L };
 
       uint32_t D = 0;
       uint32_t d = sfword;
@@ -672,12 +686,12 @@ namespace gnsstk
          // new.
       if (D30 && !knownUpright)
          d = ~d;
-      D |= ((D29 + BinUtils::countBits(bmask[0] & d)) % 2) << 5;
-      D |= ((D30 + BinUtils::countBits(bmask[1] & d)) % 2) << 4;
-      D |= ((D29 + BinUtils::countBits(bmask[2] & d)) % 2) << 3;
-      D |= ((D30 + BinUtils::countBits(bmask[3] & d)) % 2) << 2;
-      D |= ((D30 + BinUtils::countBits(bmask[4] & d)) % 2) << 1;
-      D |= ((D29 + BinUtils::countBits(bmask[5] & d)) % 2);
+      D |= (D29 ^ bitParity(bmask[0] & d)) << 5;
+      D |= (D30 ^ bitParity(bmask[1] & d)) << 4;
+      D |= (D29 ^ bitParity(bmask[2] & d)) << 3;
+      D |= (D30 ^ bitParity(bmask[3] & d)) << 2;
+      D |= (D30 ^ bitParity(bmask[4] & d)) << 1;
+      D |= (D29 ^ bitParity(bmask[5] & d));
 
       return D;
    }
@@ -687,8 +701,9 @@ namespace gnsstk
                                 bool nib,
                                 bool knownUpright)
    {
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                                 0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+      static const uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L,
+                                         0x2EC7CD00L, 0x1763E680L,
+                                         0x2BB1F340L, 0x0B7A89C0L };
 
       uint32_t D = 0;
       uint32_t d = sfword;
@@ -699,9 +714,9 @@ namespace gnsstk
       {
             // make sure the non-information bits are zero to start with.
          d &= 0xffffff00;
-         if ((D30 + BinUtils::countBits(bmask[4] & d)) % 2)
+         if (D30 ^ bitParity(bmask[4] & d))
             d |= 0x00000040;
-         if ((D29 + BinUtils::countBits(bmask[5] & d)) % 2)
+         if (D29 ^ bitParity(bmask[5] & d))
             d |= 0x00000080;
       }
 
@@ -739,6 +754,16 @@ namespace gnsstk
          ((sf[9] & 0x0000003f) == computeParity(sf[9], sf[8], knownUpright));
    }
 
+   bool EngNav :: checkParity(const PackedNavBits& pnb, bool knownUpright)
+   {
+      uint32_t sf[10];
+      for (unsigned i = 0, j = 0; j < 10; i += 30, j++)
+      {
+         sf[j] = pnb.asUnsignedLong(i, 30, 1);
+      }
+      return checkParity(sf, knownUpright);
+   }
+
    void EngNav :: convertQuant(const uint32_t input[10],
                                double output[60],
                                const DecodeQuant& dq)
@@ -59,6 +59,7 @@ namespace gnsstk
       //@{
 
    struct DecodeQuant;
+   class PackedNavBits;
 
       /**
        * Base class for ICD-GPS-200 navigation messages.  This class
@@ -124,6 +125,14 @@ namespace gnsstk
       static bool checkParity(const uint32_t input[10], bool knownUpright=true);
       static bool checkParity(const std::vector<uint32_t>& v, bool knownUpright=true);
 
+         /**
+          * Perform a parity check on a navigation message subframe
+          * stored as the first 300 bits of a PackedNavBits object.
+          * @return true if the parity check is successful.
+          * @throw InvalidParameter if pnb has fewer than 300 bits.
+          */
+      static bool checkParity(const PackedNavBits& pnb, bool knownUpright=true);
+
 
          /// This is the old routine only left around for compatibility
       static bool subframeParity(const long input[10]);
@@ -59,10 +59,26 @@
 namespace gnsstk
 {
    using namespace std;
+
+      /// Largest unsigned value that fits in numBits bits.
+   static inline uint64_t maxUnsigned(int numBits)
+   {
+      if (numBits <= 0)
+         return 0;
+      return (numBits >= 64 ? ~UINT64_C(0) : (UINT64_C(1) << numBits) - 1);
+   }
+
+      /// Largest two's complement value that fits in numBits bits.
+   static inline int64_t maxSigned(int numBits)
+   {
+      return (int64_t)maxUnsigned(numBits - 1);
+   }
+
    PackedNavBits::PackedNavBits()
                  : transmitTime(CommonTime::BEGINNING_OF_TIME),
                    parityStatus(psUnknown),
-                   bits(900),
+                   words(15, 0),
+                   numBitsAlloc(900),
                    bits_used(0),
                    rxID(""),
                    xMitCoerced(false)
@@ -72,8 +88,9 @@ namespace gnsstk
    PackedNavBits::PackedNavBits(const SatID& satSysArg,
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
+                                : parityStatus(psUnknown),
+                                  words(15, 0),
+                                  numBitsAlloc(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -88,8 +105,9 @@ namespace gnsstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
+                                : parityStatus(psUnknown),
+                                  words(15, 0),
+                                  numBitsAlloc(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -106,8 +124,9 @@ namespace gnsstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
-                                  parityStatus(psUnknown),
+                                : parityStatus(psUnknown),
+                                  words(15, 0),
+                                  numBitsAlloc(900),
                                   bits_used(0),
                                   rxID(""),
                                   xMitCoerced(false)
@@ -134,15 +153,23 @@ namespace gnsstk
            navID(navIDArg),
            rxID(rxString),
            transmitTime(transmitTimeArg),
-           bits(numBits, fillValue),
+           numBitsAlloc(0),
            bits_used(numBits),
            xMitCoerced(false)
    {
+      resizeBits(numBits);
+      if (fillValue)
+      {
+         std::fill(words.begin(), words.end(), ~UINT64_C(0));
+            // keep the unallocated bits zero
+         resizeBits(numBits);
+      }
    }
 
 
       // Copy constructor
    PackedNavBits::PackedNavBits(const PackedNavBits& right)
+         : numBitsAlloc(0)
    {
       satSys = right.satSys;
       obsID  = right.obsID;
@@ -150,12 +177,14 @@ namespace gnsstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      ensureCapacity(bits_used);
       parityStatus = right.parityStatus;
-      for (int i=0;i<bits_used;i++)
-      {
-         bits.at(i) = right.bits.at(i);
-      }
+         // Only the used bits are copied, anything after that is
+         // left unallocated.
+      size_t numWords = std::min(right.words.size(),
+                                 size_t(bits_used + 63) / 64);
+      words.assign(right.words.begin(), right.words.begin() + numWords);
+      numBitsAlloc = words.size() * 64;
+      resizeBits(bits_used);
       xMitCoerced = right.xMitCoerced;
    }
 
@@ -213,7 +242,8 @@ namespace gnsstk
 
    void PackedNavBits::clearBits()
    {
-      bits.clear();
+      words.clear();
+      numBitsAlloc = 0;
       bits_used = 0;
    }
 
@@ -251,20 +281,21 @@ namespace gnsstk
    uint64_t PackedNavBits::asUint64_t(const int startBit,
                                       const int numBits ) const
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
-      size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if ((startBit < 0) || (startBit + numBits > (long)numBitsAlloc))
       {
          InvalidParameter exc("Requested bits not present.");
          GNSSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
+      if (numBits <= 0)
+      {
+         return 0;
+      }
+         // Any bits beyond the 64 LSBs would be shifted out anyway.
+      if (numBits > 64)
       {
-         temp <<= 1;
-         if (bits.at(i)) temp++;
+         return readBits(startBit + numBits - 64, 64);
       }
-      return( temp );
+      return readBits(startBit, numBits);
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit,
@@ -290,9 +321,7 @@ namespace gnsstk
       uint64_t uint = asUint64_t( startBit, numBits );
 
          // Convert to double and scale
-      double dval = (double) uint;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)uint, power2);
    }
 
    double PackedNavBits::asSignedDouble(const int startBit, const int numBits,
@@ -301,9 +330,7 @@ namespace gnsstk
       int64_t s = SignExtend( startBit, numBits);
 
          // Convert to double and scale
-      double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)s, power2);
    }
 
    double PackedNavBits::asDoubleSemiCircles(const int startBits, const int numBits,
@@ -478,9 +505,7 @@ namespace gnsstk
       //ulong |= temp2;
 
          // Convert to double and scale
-      double dval = (double) ulong;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)ulong, power2);
    }
 
 
@@ -496,9 +521,7 @@ namespace gnsstk
       ulong <<= numBits2;
       ulong |= temp2;
          // Convert to double and scale
-      double dval = (double) ulong;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)ulong, power2);
    }
 
       /* Unpack a split signed double */
@@ -521,9 +544,7 @@ namespace gnsstk
       //s |= temp2;
 
          // Convert to double and scale
-      double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)s, power2);
    }
 
 
@@ -581,9 +602,7 @@ namespace gnsstk
       s |= temp2;
 
          // Convert to double and scale
-      double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
-      return( dval );
+      return ldexp((double)s, power2);
    }
 
       /* Unpack a split double with units of semicircles */
@@ -610,7 +629,12 @@ namespace gnsstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits.at(bitNum);
+      if (bitNum >= numBitsAlloc)
+      {
+         InvalidParameter exc("Requested bits not present.");
+         GNSSTK_THROW(exc);
+      }
+      return getBit(bitNum);
    }
 
 
@@ -622,7 +646,7 @@ namespace gnsstk
       uint64_t out = (uint64_t) value;
       out /= scale;
 
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1;
+      uint64_t test = maxUnsigned(numBits);
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -641,7 +665,7 @@ namespace gnsstk
       out = (int64_t) value;
       out /= scale;
 
-      int64_t test = pow(static_cast<double>(2),numBits-1) - 1;
+      int64_t test = maxSigned(numBits);
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -654,7 +678,7 @@ namespace gnsstk
                                           const int power2 )
    {
       uint64_t out = (uint64_t) ScaleValue(value, power2);
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1;
+      uint64_t test = maxUnsigned(numBits);
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -673,7 +697,7 @@ namespace gnsstk
          int64_t out;
       };
       out = (int64_t) ScaleValue(value, power2);
-      int64_t test = pow(static_cast<double>(2),numBits-1) - 1;
+      int64_t test = maxSigned(numBits);
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -692,7 +716,7 @@ namespace gnsstk
       };
       double temp = Radians/PI;
       out = (int64_t) ScaleValue(temp, power2);
-      int64_t test = pow(static_cast<double>(2), numBits-1) - 1;
+      int64_t test = maxSigned(numBits);
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -778,32 +802,77 @@ namespace gnsstk
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
       ensureCapacity(bits_used);
+      copyBitRange(right, 0, old_bits_used, right.bits_used);
+   }
 
-      for (int i=0;i<right.bits_used;i++)
+   void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
+   {
+      if (numBits <= 0)
       {
-         bits.at(i+old_bits_used) = right.bits.at(i);
+         return;
       }
+      ensureCapacity(bits_used + numBits);
+      writeBits(bits_used, value, numBits);
+      bits_used += numBits;
    }
 
-   void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
+
+   uint64_t PackedNavBits::readBits(size_t startBit, unsigned numBits) const
    {
-      ensureCapacity(bits_used + numBits);
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
+      if (numBits == 0)
+      {
+         return 0;
+      }
+      size_t w = startBit >> 6;
+      unsigned off = startBit & 63;
+      uint64_t rv = words[w] << off;
+      if (off + numBits > 64)
+      {
+         rv |= words[w+1] >> (64 - off);
+      }
+      return rv >> (64 - numBits);
+   }
+
 
-      for (int i=0; i<numBits; ++i)
+   void PackedNavBits::writeBits(size_t startBit, uint64_t value,
+                                 unsigned numBits)
+   {
+      if (numBits == 0)
       {
-         bits.at(ndx) = false;
-         if (value & mask)
-         {
-             //set the bits to true
-            bits.at(ndx) = true;
-         }
-         mask>>= 1;
-         ndx++;
+         return;
+      }
+      value &= maxUnsigned(numBits);
+      size_t w = startBit >> 6;
+      unsigned off = startBit & 63;
+      if (off + numBits <= 64)
+      {
+         unsigned shift = 64 - off - numBits;
+         uint64_t mask = maxUnsigned(numBits) << shift;
+         words[w] = (words[w] & ~mask) | (value << shift);
+      }
+      else
+      {
+            // split across two words, off > 0
+         unsigned numBits2 = off + numBits - 64;
+         uint64_t mask1 = maxUnsigned(64 - off);
+         words[w] = (words[w] & ~mask1) | (value >> numBits2);
+         uint64_t mask2 = ~UINT64_C(0) << (64 - numBits2);
+         words[w+1] = (words[w+1] & ~mask2) | (value << (64 - numBits2));
+      }
+   }
+
+
+   void PackedNavBits::copyBitRange(const PackedNavBits& src, size_t srcBit,
+                                    size_t startBit, size_t numBits)
+   {
+      while (numBits > 0)
+      {
+         unsigned chunk = (numBits > 64 ? 64 : numBits);
+         writeBits(startBit, src.readBits(srcBit, chunk), chunk);
+         srcBit += chunk;
+         startBit += chunk;
+         numBits -= chunk;
       }
-      bits_used += numBits;
    }
 
    //--------------------------------------------------------------------------
@@ -813,9 +882,8 @@ namespace gnsstk
    // in which left has a FALSE whereas right has a TRUE starting at the
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation
-   // is probably not the fastest.  Since we are scanning a bit array rather
-   // than testing a series of unsigned ints.
+   // Since the bits are stored MSB first and the unallocated bits are always
+   // zero, comparing the words as unsigned integers gives the same order.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -823,22 +891,17 @@ namespace gnsstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (numBitsAlloc!=right.numBitsAlloc)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (numBitsAlloc<right.numBitsAlloc) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<words.size();i++)
       {
-         if (bits.at(i)==false && right.bits.at(i)==true)
-         //if (bits[i]<right.bits[i])
+         if (words[i]!=right.words[i])
          {
-            return true;
-         }
-         if (bits.at(i)==true && right.bits.at(i)==false)
-         {
-            return false;
+            return words[i]<right.words[i];
          }
       }
       return false;
@@ -846,20 +909,12 @@ namespace gnsstk
 
    void PackedNavBits::invert( )
    {
-         // Each bit is either 1 or 0.
-         // Starting with 1 and subtracting the
-         // current value will yield the inverse
-         //
-         //  Input    Equation     Result
-         //    1       1 - 1          0
-         //    0       1 - 0          1
-         //
-         // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<words.size();i++)
       {
-         bits.at(i) = 1 - bits.at(i);
+         words[i] = ~words[i];
       }
+         // clear the unallocated bits again
+      resizeBits(numBitsAlloc);
    }
 
       /**
@@ -883,10 +938,17 @@ namespace gnsstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
+      if (finalBit < startBit)
       {
-         bits.at(i) = src.bits.at(i);
+         return;
       }
+      if ((startBit < 0) || (size_t(finalBit) >= numBitsAlloc) ||
+          (size_t(finalBit) >= src.numBitsAlloc))
+      {
+         InvalidParameter ip("copyBits( ) requested bits not present.");
+         GNSSTK_THROW(ip);
+      }
+      copyBitRange(src, startBit, startBit, finalBit - startBit + 1);
    }
 
 
@@ -908,26 +970,17 @@ namespace gnsstk
       uint64_t out = (uint64_t) value;
       out /= scale;
 
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1;
+      uint64_t test = maxUnsigned(numBits);
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
          GNSSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L;
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
+      if (numBits > 0)
       {
-         bits.at(ndx) = false;
-         if (out & mask)
-         {
-            bits.at(ndx) = true;
-         }
-         mask >>= 1;
-         ndx++;
+         ensureCapacity(startBit + numBits);
+         writeBits(startBit, out, numBits);
       }
    }
 
@@ -943,7 +996,7 @@ namespace gnsstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -963,7 +1016,7 @@ namespace gnsstk
    double PackedNavBits::ScaleValue( const double value, const int power2) const
    {
       double temp = value;
-      temp /= pow(static_cast<double>(2), power2);
+      temp = ldexp(temp, -power2);
       if (temp >= 0) temp += 0.5; // Takes care of rounding
       else temp -= 0.5;
       return ( temp );
@@ -1006,10 +1059,10 @@ namespace gnsstk
       int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < numBitsAlloc; ++i)
       {
          word <<= 1;
-         if (bits.at(i)) word++;
+         if (getBit(i)) word++;
 
          numBitInWord++;
          if (numBitInWord >= 32)
@@ -1045,10 +1098,10 @@ namespace gnsstk
       int bit_count    = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < numBitsAlloc; ++i)
       {
          word <<= 1;
-         if (bits.at(i)) word++;
+         if (getBit(i)) word++;
 
          numBitInWord++;
          if (numBitInWord >= numBitsPerWord)
@@ -1062,7 +1115,7 @@ namespace gnsstk
             //but ONLY if there are more bits left to put on the next line.
             if (word_count>0 &&
                 word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;
+                (i+1) < numBitsAlloc) s << endl;
          }
       }
          // Need to check if there is a partial word in the buffer
@@ -1072,7 +1125,7 @@ namespace gnsstk
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size());
+      return(numBitsAlloc);
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -1125,22 +1178,25 @@ namespace gnsstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them.
-      if (bits.size()!=right.bits.size()) return false;
+      if (numBitsAlloc!=right.numBitsAlloc) return false;
+      if (numBitsAlloc==0) return true;
 
-      short startBit = startBitA;
-      short endBit = endBitA;
+      long startBit = startBitA;
+      long endBit = endBitA;
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=long(numBitsAlloc)) endBit = numBitsAlloc-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
+      if (startBit>=long(numBitsAlloc)) startBit = numBitsAlloc-1;
 
-      for (int i=startBit;i<=endBit;i++)
+      while (startBit <= endBit)
       {
-         if (bits.at(i)!=right.bits.at(i))
+         unsigned chunk = (endBit - startBit >= 63 ? 64 : endBit-startBit+1);
+         if (readBits(startBit, chunk) != right.readBits(startBit, chunk))
          {
             return false;
          }
+         startBit += chunk;
       }
       return true;
    }
@@ -1228,10 +1284,32 @@ namespace gnsstk
    
    void PackedNavBits::ensureCapacity(const size_t s)
    {
-      if (bits.size() < s)
+      if (numBitsAlloc < s)
+      {
+         resizeBits(s);
+      }
+   }
+
+
+   void PackedNavBits::resizeBits(const size_t s)
+   {
+      words.resize((s + 63) / 64, 0);
+      numBitsAlloc = s;
+      if (s & 63)
+      {
+         words.back() &= ~maxUnsigned(64 - (s & 63));
+      }
+   }
+
+
+   std::vector<bool> PackedNavBits::getBits() const
+   {
+      std::vector<bool> rv(numBitsAlloc);
+      for (size_t i = 0; i < numBitsAlloc; i++)
       {
-         bits.resize(s);
+         rv[i] = getBit(i);
       }
+      return rv;
    }
 
    ostream& operator<<(ostream& s, const PackedNavBits& pnb)
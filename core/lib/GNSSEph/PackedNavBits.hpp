@@ -455,20 +455,23 @@ namespace gnsstk
          const auto numBits{std::distance(begin, end)};
          ensureCapacity(bits_used + numBits);
 
-         std::transform(begin, end, bits.begin() + bits_used, [](it_datatype bit)
+         size_t ndx = bits_used;
+         for (It i = begin; i != end; ++i, ++ndx)
+         {
+            if (*i == 1)
+            {
+               setBit(ndx, true);
+            }
+            else if (*i == 0)
+            {
+               setBit(ndx, false);
+            }
+            else
             {
-               if (bit == 1)
-               {
-                  return true;
-               }
-               if (bit == 0)
-               {
-                  return false;
-               }
-
                gnsstk::InvalidParameter exc("Encountered data that is not 0 or 1");
                GNSSTK_THROW(exc);
-            });
+            }
+         }
 
          bits_used += numBits;
       }
@@ -483,9 +486,13 @@ namespace gnsstk
       template <size_t N>
       void addBitset(const std::bitset<N>& newbits)
       {
-         std::string binbits(newbits.to_string((char)0,(char)1));
-         bits.insert(bits.end(), &binbits[0], &binbits[binbits.length()]);
-         bits_used += binbits.length();
+         size_t ndx = numBitsAlloc;
+         resizeBits(numBitsAlloc + N);
+         for (size_t i = N; i > 0; i--, ndx++)
+         {
+            setBit(ndx, newbits[i-1]);
+         }
+         bits_used += N;
       }
 
          /**
@@ -657,8 +664,10 @@ namespace gnsstk
       void setXmitCoerced(bool tf=true) {xMitCoerced=tf;}
       bool isXmitCoerced() const {return xMitCoerced;}
 
-      const std::vector<bool>& getBits() const
-      { return bits; }
+         /** Return a copy of the packed data, one element per bit,
+          * including any allocated but unused bits beyond
+          * getNumBits(). */
+      std::vector<bool> getBits() const;
 
          /** Indicate the status of parity/CRC checking.  Must be
           * explicitly set after construction, no parity checking is
@@ -671,7 +680,12 @@ namespace gnsstk
       NavID navID;             /**< Defines the navigation message tracked */
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+         /** Holds the packed data, 64 bits per word with bit 0 in
+          * the MSB of words[0].  Bits beyond numBitsAlloc are always
+          * zero so whole words can be compared. */
+      std::vector<uint64_t> words;
+         /// Number of bits allocated in words, of which bits_used are set.
+      size_t numBitsAlloc;
       int bits_used;
 
       bool xMitCoerced;        /**< Used to indicate that the transmit
@@ -686,6 +700,38 @@ namespace gnsstk
          /** Pack the bits */
       void addUint64_t( const uint64_t value, const int numBits );
 
+         /** Get up to 64 bits starting at startBit, right-justified.
+          * @pre startBit+numBits <= numBitsAlloc, numBits <= 64. */
+      uint64_t readBits(size_t startBit, unsigned numBits) const;
+
+         /** Overwrite numBits bits starting at startBit with the
+          * numBits LSBs of value.
+          * @pre startBit+numBits <= numBitsAlloc, numBits <= 64. */
+      void writeBits(size_t startBit, uint64_t value, unsigned numBits);
+
+         /** Copy numBits bits from src starting at srcBit to this
+          * object starting at startBit, a word at a time. */
+      void copyBitRange(const PackedNavBits& src, size_t srcBit,
+                        size_t startBit, size_t numBits);
+
+         /// Get a single bit. @pre bitNum < numBitsAlloc
+      bool getBit(size_t bitNum) const
+      { return (words[bitNum >> 6] >> (63 - (bitNum & 63))) & 1; }
+
+         /// Set a single bit. @pre bitNum < numBitsAlloc
+      void setBit(size_t bitNum, bool value)
+      {
+         uint64_t mask = UINT64_C(1) << (63 - (bitNum & 63));
+         if (value)
+            words[bitNum >> 6] |= mask;
+         else
+            words[bitNum >> 6] &= ~mask;
+      }
+
+         /** Change the number of allocated bits to s, zeroing any
+          * newly allocated bits and any words beyond the end. */
+      void resizeBits(const size_t s);
+
          /** Extend the sign bit for signed values */
       int64_t SignExtend( const int startBit, const int numBits ) const;
 
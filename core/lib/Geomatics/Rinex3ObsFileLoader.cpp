@@ -43,6 +43,7 @@
 //------------------------------------------------------------------------------------
 // system includes
 #include <iostream>
+#include <set>
 
 // GNSSTk
 #include "Exception.hpp"
@@ -136,6 +137,8 @@ namespace gnsstk
                   oss << "Error - could not open file " << filename << endl;
                   break;
                }
+                  // read lines in place rather than through std::filebuf
+               strm.bufferInput(mapFiles);
                strm.exceptions(fstream::failbit);
 
                   // read header -------------------------------------------
@@ -222,6 +225,31 @@ namespace gnsstk
                      }
                   }
 
+                     /* have the stream parse only the wanted obs types
+                        of the wanted satellites, the rest is ignored below
+                        anyway */
+                  if (filterOnRead)
+                  {
+                     Rinex3ObsHeader::RinexObsMap parseObsTypes;
+                     for (kt = roh.mapObsTypes.begin();
+                          kt != roh.mapObsTypes.end(); kt++)
+                     {
+                        for (i = 0; i < kt->second.size(); i++)
+                        {
+                           string srot = kt->first +
+                              kt->second[i].asString(currVer);
+                           if (vectorindex(wantedObsTypes, srot) != -1)
+                           {
+                              parseObsTypes[kt->first].push_back(
+                                 kt->second[i]);
+                           }
+                        }
+                     }
+                     strm.setWantedObsTypes(parseObsTypes);
+                     strm.setExcludedSats(set<RinexSatID>(exSats.begin(),
+                                                          exSats.end()));
+                  }
+
                   headers.push_back(roh);
                }
                catch (Exception& e)
@@ -91,6 +91,8 @@ namespace gnsstk
       std::vector<std::string> filenames; ///< input RINEX obs file names
       int nepochsToRead;                  ///< number of epochs to read (default:all)
       bool saveData;                      ///< if true save the data (F)
+      bool mapFiles;                      ///< if true memory map files (F)
+      bool filterOnRead;                  ///< if true stream filters data (T)
       std::string timefmt;                ///< format for time tags in output
       // editing
       double dtdec;                       ///< decimate to this time step
@@ -141,6 +143,8 @@ namespace gnsstk
       void init()
       {
          saveData      = false;
+         mapFiles      = false;
+         filterOnRead  = true;
          nepochsToRead = -1;
          timefmt       = std::string("%04Y/%02m/%02d %02H:%02M:%02S");
          reset();
@@ -271,6 +275,24 @@ namespace gnsstk
          */
       inline bool dataSaved() { return saveData; }
 
+         /**
+          set the flag to memory map the files rather than read them in
+          blocks (see FFTextBuf); this is a little faster, but a file that
+          is truncated while it is being read terminates the program with
+          SIGBUS
+          @param b if true, then memory map the files
+         */
+      inline void setMapFiles(bool b) { mapFiles = b; }
+
+         /**
+          set the flag to have the stream skip unwanted obs types and
+          excluded satellites while parsing (see
+          Rinex3ObsStream::setWantedObsTypes()); the loaded data are the
+          same either way, turning it off only makes reading slower
+          @param b if true, then filter while parsing
+         */
+      inline void setFilterOnRead(bool b) { filterOnRead = b; }
+
          /**
           set the start time
           @param[in] tt start time, ignore data before this time
@@ -0,0 +1,139 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file LagrangeWeights.cpp
+ * Reusable Lagrange interpolation basis weights.
+ */
+
+#include <string>
+#include "LagrangeWeights.hpp"
+#include "Exception.hpp"
+
+namespace gnsstk
+{
+   const unsigned LagrangeWeights::maxPoints;
+
+
+   LagrangeWeights ::
+   LagrangeWeights()
+         : n(0), x(0), haveDeriv(false)
+   {
+   }
+
+
+   void LagrangeWeights ::
+   setPoints(const double *X, unsigned numPts, double atX, bool needDeriv)
+   {
+      if ((numPts < 2) || (numPts > maxPoints))
+      {
+         InvalidParameter exc("LagrangeWeights requires 2 to " +
+                              std::to_string(maxPoints) + " points");
+         GNSSTK_THROW(exc);
+      }
+      bool same = ((numPts == n) && (atX == x));
+      for (unsigned i = 0; same && (i < n); i++)
+      {
+         same = (X[i] == xs[i]);
+      }
+      if (same && (haveDeriv || !needDeriv))
+      {
+         return;
+      }
+      n = numPts;
+      x = atX;
+      for (unsigned i = 0; i < n; i++)
+      {
+         xs[i] = X[i];
+      }
+         // L_i(x) = prod(j!=i)(x-X[j]) / prod(j!=i)(X[i]-X[j])
+      double diff[maxPoints], denom[maxPoints];
+      for (unsigned i = 0; i < n; i++)
+      {
+         diff[i] = x - xs[i];
+      }
+      for (unsigned i = 0; i < n; i++)
+      {
+         double num = 1.0, den = 1.0;
+         for (unsigned j = 0; j < n; j++)
+         {
+            if (j != i)
+            {
+               num *= diff[j];
+               den *= xs[i] - xs[j];
+            }
+         }
+         w[i] = num / den;
+         denom[i] = den;
+      }
+      haveDeriv = needDeriv;
+      if (!needDeriv)
+      {
+         return;
+      }
+         // L'_i(x) = sum(k!=i) prod(j!=i,j!=k)(x-X[j]) / denom[i].
+         // The sum of products leaving out one term is computed
+         // with prefix and suffix products, which works even when x
+         // is one of the abscissae.
+      double prefix[maxPoints+1], suffix[maxPoints+1];
+      for (unsigned i = 0; i < n; i++)
+      {
+         prefix[0] = 1.0;
+         for (unsigned j = 0; j < n; j++)
+         {
+            prefix[j+1] = prefix[j] * (j == i ? 1.0 : diff[j]);
+         }
+         suffix[n] = 1.0;
+         for (unsigned j = n; j > 0; j--)
+         {
+            suffix[j-1] = suffix[j] * (j-1 == i ? 1.0 : diff[j-1]);
+         }
+         double sum = 0;
+         for (unsigned k = 0; k < n; k++)
+         {
+            if (k != i)
+            {
+               sum += prefix[k] * suffix[k+1];
+            }
+         }
+         dw[i] = sum / denom[i];
+      }
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,142 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file LagrangeWeights.hpp
+ * Reusable Lagrange interpolation basis weights.
+ */
+
+#ifndef GNSSTK_LAGRANGEWEIGHTS_HPP
+#define GNSSTK_LAGRANGEWEIGHTS_HPP
+
+#include <cstddef>
+
+namespace gnsstk
+{
+      /// @ingroup MathGroup
+      //@{
+
+      /** Lagrange interpolation expressed as weights on the data.
+       *
+       * The Lagrange interpolating polynomial through the points
+       * (X[i],Y[i]) evaluated at x is a weighted sum of the Y[i],
+       * where the weights depend only on X and x.  When several
+       * quantities are tabulated at the same abscissae, as is the
+       * case for the positions, velocities and clocks of all
+       * satellites in an SP3 file, the weights can be computed once
+       * and applied to each quantity as a dot product.
+       *
+       * All storage is fixed size, so no memory is allocated.
+       * setPoints() remembers the abscissae and x it was last given
+       * and does nothing if called again with the same values,
+       * allowing an object to be used as a cache by code that
+       * interpolates one quantity at a time.
+       *
+       * Interpolating at one of the abscissae returns the
+       * corresponding Y exactly. */
+   class LagrangeWeights
+   {
+   public:
+         /// Largest number of points that can be interpolated.
+      static const unsigned maxPoints = 32;
+
+         /// Initialize with no points.
+      LagrangeWeights();
+
+         /** Compute the weights for interpolating at x.
+          * @param[in] X The abscissae of the data, which must be
+          *   distinct.
+          * @param[in] n The number of elements in X.
+          * @param[in] x The abscissa to interpolate at.
+          * @param[in] needDeriv If true, also compute the weights
+          *   for the derivative (see deriv()).
+          * @throw InvalidParameter if n is less than 2 or greater
+          *   than maxPoints. */
+      void setPoints(const double *X, unsigned n, double x,
+                     bool needDeriv = false);
+
+         /** Interpolate data at the abscissae given to setPoints().
+          * @param[in] Y The data, with at least size() elements.
+          * @return The interpolated value. */
+      double interp(const double *Y) const
+      {
+         double rv = 0;
+         for (unsigned i = 0; i < n; i++)
+            rv += w[i] * Y[i];
+         return rv;
+      }
+
+         /** Compute the derivative of the interpolating polynomial.
+          * setPoints() must have been called with needDeriv true.
+          * @param[in] Y The data, with at least size() elements.
+          * @return The derivative with respect to x. */
+      double deriv(const double *Y) const
+      {
+         double rv = 0;
+         for (unsigned i = 0; i < n; i++)
+            rv += dw[i] * Y[i];
+         return rv;
+      }
+
+         /// Return the number of points.
+      unsigned size() const
+      { return n; }
+
+         /// Return the weight of point i.
+      double weight(unsigned i) const
+      { return w[i]; }
+
+         /// Return the derivative weight of point i.
+      double derivWeight(unsigned i) const
+      { return dw[i]; }
+
+   private:
+      unsigned n;             ///< Number of points.
+      double xs[maxPoints];   ///< Abscissae given to setPoints().
+      double x;               ///< Interpolation point.
+      bool haveDeriv;         ///< True if dw is up to date.
+      double w[maxPoints];    ///< Interpolation weights.
+      double dw[maxPoints];   ///< Derivative weights.
+   };
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_LAGRANGEWEIGHTS_HPP
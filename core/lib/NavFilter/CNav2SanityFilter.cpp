@@ -40,10 +40,12 @@
 //    - TOI + ITOW must equal transmit time.
 //    - PRN ID in subframe 3 must equal PRN of transmitting SV.
 //    - Page No. in subframe 3 must be in the valid range (1-6).
+//    - The CRCs of subframes 2 and 3 must be correct.
 //
 #include "CNav2SanityFilter.hpp"
 #include "CNavFilterData.hpp"
 #include "GPSWeekSecond.hpp"
+#include "CRC24Q.hpp"
 
 namespace gnsstk
 {
@@ -59,6 +61,11 @@ namespace gnsstk
       for (i = msgBitsIn.begin(); i != msgBitsIn.end(); i++)
       {
          CNavFilterData *fd = dynamic_cast<CNavFilterData*>(*i);
+         if (fd->pnb->getNumBits() < frameBits)
+         {
+            reject(fd);
+            continue;
+         }
          uint32_t msgWeek = (uint32_t) fd->pnb->asUnsignedLong(9,13,1);
          uint32_t TOI   = (uint32_t) fd->pnb->asUnsignedLong(0,9,1);
          uint32_t ITOW  = (uint32_t) fd->pnb->asUnsignedLong(22,8,1);
@@ -82,7 +89,10 @@ namespace gnsstk
                // check PRN is consistent
               PRN == fd->pnb->getsatSys().id &&
                // check subframe 3 page number is valid
-             (pageNum>=1 && pageNum<=6) );
+             (pageNum>=1 && pageNum<=6) &&
+               // check the CRC of subframes 2 and 3
+              CRC24Q::check(*fd->pnb, sf2Start, sf2Bits) &&
+              CRC24Q::check(*fd->pnb, sf3Start, sf3Bits) );
          if (valid)
             accept(fd, msgBitsOut);
          else
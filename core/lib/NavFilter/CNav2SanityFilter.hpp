@@ -46,16 +46,31 @@ namespace gnsstk
       /// @ingroup NavFilter
       //@{
 
-      /** Filter GPS CNAV messages with
-       * 1. a bad preamble
-       * 2. an invalid TOW count, or
-       * 3. an invalid message ID.
-       * Input data is assumed to be upright.
+      /** Filter GPS CNAV-2 frames with
+       * 1. a TOI and ITOW inconsistent with the transmit time,
+       * 2. a week number inconsistent with the transmit time,
+       * 3. a subframe 3 PRN that doesn't match the transmitting
+       *    satellite,
+       * 4. an invalid subframe 3 page number, or
+       * 5. a bad CRC in subframe 2 or 3.
+       * Input data is assumed to be a complete frame (subframes 1-3,
+       * 883 bits), decoded and upright.
        *
        * @attention Processing depth = 1 epoch. */
    class CNav2SanityFilter : public NavFilter
    {
    public:
+         /// Number of bits in a frame of subframes 1-3.
+      static const unsigned frameBits = 883;
+         /// First bit of subframe 2 in the frame.
+      static const unsigned sf2Start = 9;
+         /// Number of bits in subframe 2, including the CRC.
+      static const unsigned sf2Bits = 600;
+         /// First bit of subframe 3 in the frame.
+      static const unsigned sf3Start = 609;
+         /// Number of bits in subframe 3, including the CRC.
+      static const unsigned sf3Bits = 274;
+
       CNav2SanityFilter();
 
          /** Check the TLM and HOW of GPS legacy nav messages
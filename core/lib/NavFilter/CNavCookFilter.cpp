@@ -54,7 +54,7 @@ namespace gnsstk
       {
          CNavFilterData *fd = dynamic_cast<CNavFilterData*>(*i);
          cookSubframe(fd);
-         msgBitsOut.push_back(fd);
+         accept(fd, msgBitsOut);
       }
    }
 
@@ -38,54 +38,11 @@
 
 #include "CNavParityFilter.hpp"
 #include "CNavFilterData.hpp"
+#include "CRC24Q.hpp"
 
 namespace gnsstk
 {
 
-   class CRC24Q
-   {
-   public:
-      static const std::size_t bit_count = 24;
-
-      // 0,1,3,4,5,6,7,10,11,14,17,18,23,24
-      //1000 0110 0100 1100 1111 1011: 0x864cfb
-      CRC24Q()
-         : rem(0) , poly(0x864cfb)
-      {};
-
-      void process_bit( bool bit)
-      {
-         rem ^= ( bit ? 0x00800000 : 0 );
-         bool const  pdiv = static_cast<bool>( rem & 0x00800000 );
-         rem <<= 1;
-         if ( pdiv )
-            rem ^= poly;
-      };
-
-      void process_bits( uint8_t bits, std::size_t bit_count = 8)
-      {
-         bits <<= 8 - bit_count;
-
-         for ( std::size_t i = bit_count ; i > 0u ; --i, bits <<= 1u )
-            process_bit( static_cast<bool>(bits & 0x80) );
-      };
-
-      void process_bytes( void const *buffer, std::size_t byte_count)
-      {
-         uint8_t const *b = static_cast<uint8_t const *>(buffer);
-         for (int i=0; i<byte_count; i++)
-            process_bits(*b++);
-      };
-
-      uint32_t checksum() const
-      { return rem & 0x00ffffff; };
-
-   private:
-      uint32_t  rem;
-      const uint32_t poly;
-   };
-
-
    CNavParityFilter ::
    CNavParityFilter()
    {
@@ -102,9 +59,7 @@ namespace gnsstk
          CNavFilterData *fd = dynamic_cast<CNavFilterData*>(*i);
 
          CRC24Q crc;
-         int numBits = fd->pnb->getNumBits();
-         for (int n=0; n < numBits; n++)
-            crc.process_bit(fd->pnb->asBool(n));
+         crc.process(*fd->pnb);
 
          if (crc.checksum()==0)
             accept(*i, msgBitsOut);
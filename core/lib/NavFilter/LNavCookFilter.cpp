@@ -55,7 +55,7 @@ namespace gnsstk
       {
          LNavFilterData *fd = dynamic_cast<LNavFilterData*>(*i);
          cookSubframe(fd);
-         msgBitsOut.push_back(fd);
+         accept(fd, msgBitsOut);
       }
    }
 
@@ -43,6 +43,7 @@ namespace gnsstk
 {
    NavFilter ::
    NavFilter()
+         : spareNodes(nullptr)
    {
    }
 
@@ -164,34 +164,65 @@ namespace gnsstk
           * ONLY once the nav data is no longer being internally
           * stored by the derived filter class. */
       inline void reject(const NavMsgList& invalid);
+
+   private:
+      friend class NavFilterMgr;
+
+         /** Move a list node from spareNodes, if there are any, to
+          * the end of a list, otherwise append a new node.
+          * @param[in] data The value to store in the node.
+          * @param[in,out] msgList The list to append data to. */
+      inline void append(NavFilterKey* data, NavMsgList& msgList);
+
+         /** Unused list nodes that accept() and reject() take from
+          * before allocating new ones.  This is set by NavFilterMgr
+          * only for the duration of a validate() call and is
+          * otherwise nullptr. */
+      NavMsgList *spareNodes;
    };
 
       //@}
 
+   void NavFilter ::
+   append(NavFilterKey* data, NavMsgList& msgList)
+   {
+      if ((spareNodes == nullptr) || spareNodes->empty())
+      {
+         msgList.push_back(data);
+         return;
+      }
+      spareNodes->front() = data;
+      msgList.splice(msgList.end(), *spareNodes, spareNodes->begin());
+   }
+
    void NavFilter ::
    accept(NavFilterKey* data, NavMsgList& msgBitsOut)
    {
-      msgBitsOut.push_back(data);
+      append(data, msgBitsOut);
    }
 
    void NavFilter ::
    accept(const NavMsgList& valid, NavMsgList& msgBitsOut)
    {
-      std::copy(valid.begin(), valid.end(),
-                std::back_insert_iterator<NavMsgList>(msgBitsOut));
+      for (NavFilterKey* data : valid)
+      {
+         append(data, msgBitsOut);
+      }
    }
 
    void NavFilter ::
    reject(NavFilterKey* data)
    {
-      rejected.push_back(data);
+      append(data, rejected);
    }
 
    void NavFilter ::
    reject(const NavMsgList& invalid)
    {
-      std::copy(invalid.begin(), invalid.end(),
-                std::back_insert_iterator<NavMsgList>(rejected));
+      for (NavFilterKey* data : invalid)
+      {
+         append(data, rejected);
+      }
    }
 
 } // namepace gnsstk
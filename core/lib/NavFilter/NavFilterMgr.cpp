@@ -56,21 +56,55 @@ namespace gnsstk
    NavFilter::NavMsgList NavFilterMgr ::
    validate(NavFilterKey* msgBits)
    {
-      NavFilter::NavMsgList rv, newrv;
-      rv.push_back(msgBits);
+      return validateBatch(&msgBits, 1);
+   }
+
+
+   const NavFilter::NavMsgList& NavFilterMgr ::
+   validateBatch(NavFilterKey* const* msgs, size_t count)
+   {
+         // Recycle the nodes from the previous call.
+      spare.splice(spare.end(), passed);
+      for (NavFilter* filt : filters)
+      {
+         spare.splice(spare.end(), filt->rejected);
+      }
       rejected.clear();
-      for (FilterList::iterator i = filters.begin(); i != filters.end(); i++)
+      for (size_t i = 0; i < count; i++)
       {
-         if (rv.empty())
+         if (spare.empty())
+         {
+            passed.push_back(msgs[i]);
+         }
+         else
+         {
+            spare.front() = msgs[i];
+            passed.splice(passed.end(), spare, spare.begin());
+         }
+      }
+      for (NavFilter* filt : filters)
+      {
+         if (passed.empty())
             break;
-         (*i)->rejected.clear();
-         newrv.clear();
-         (*i)->validate(rv, newrv);
-         if (!(*i)->rejected.empty())
-            rejected.insert(*i);
-         rv = newrv;
+         filt->spareNodes = &spare;
+         try
+         {
+            filt->validate(passed, stageOut);
+         }
+         catch (...)
+         {
+            filt->spareNodes = nullptr;
+            spare.splice(spare.end(), stageOut);
+            throw;
+         }
+         filt->spareNodes = nullptr;
+         if (!filt->rejected.empty())
+            rejected.insert(filt);
+            // The input has been consumed, keep only the output.
+         spare.splice(spare.end(), passed);
+         passed.swap(stageOut);
       }
-      return rv;
+      return passed;
    }
 
 
@@ -41,6 +41,7 @@
 
 #include <list>
 #include <set>
+#include <vector>
 #include "NavFilter.hpp"
 
 namespace gnsstk
@@ -201,6 +202,31 @@ namespace gnsstk
           *   configured filters. */
       NavFilter::NavMsgList validate(NavFilterKey* msgBits);
 
+         /** Validate a batch of navigation messages, e.g. all of the
+          * messages received at one epoch.  Each filter is given the
+          * whole batch in a single NavFilter::validate() call, which
+          * is how filters of depth greater than zero expect to see
+          * the data for an epoch anyway.  The list nodes used to pass
+          * messages between filters, and those of the filters'
+          * rejected lists, are recycled from one call to the next,
+          * so after the first few calls no memory is allocated
+          * (other than any allocated by the filters themselves for
+          * their internal storage).
+          * @param[in] msgs An array of count navigation messages to
+          *   validate/filter.  @see validate(NavFilterKey*)
+          * @param[in] count The number of messages in msgs.
+          * @return Any messages that have successfully passed all
+          *   configured filters.  The list is reused by the next call
+          *   to validate() or validateBatch(). */
+      const NavFilter::NavMsgList& validateBatch(NavFilterKey* const* msgs,
+                                                 size_t count);
+
+         /** Validate a batch of navigation messages.
+          * @see validateBatch(NavFilterKey* const*, size_t) */
+      const NavFilter::NavMsgList& validateBatch(
+         const std::vector<NavFilterKey*>& msgs)
+      { return validateBatch(msgs.data(), msgs.size()); }
+
          /** Flush the stored data for all known filters.  This method
           * should be called by the user after all data has been added
           * to the filter manager via validate().
@@ -235,6 +261,12 @@ namespace gnsstk
    private:
          /// The collection of navigation message filters to apply.
       FilterList filters;
+         /// Unused list nodes for recycling, see NavFilter::spareNodes.
+      NavFilter::NavMsgList spare;
+         /// Messages passing the filters in the last validateBatch().
+      NavFilter::NavMsgList passed;
+         /// The output of the current filter in validateBatch().
+      NavFilter::NavMsgList stageOut;
    };
 
       //@}
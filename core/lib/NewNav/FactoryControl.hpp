@@ -39,6 +39,7 @@
 #ifndef GNSSTK_FACTORYCONTROL_HPP
 #define GNSSTK_FACTORYCONTROL_HPP
 
+#include <cstddef>
 #include "TimeOffsetFilter.hpp"
 
 namespace gnsstk
@@ -54,7 +55,9 @@ namespace gnsstk
    public:
          /// Initialize data to reasonable defaults.
       FactoryControl()
-            : bdsTimeZZfilt(false), timeOffsFilt(TimeOffsetFilter::NoFilt)
+            : bdsTimeZZfilt(false), timeOffsFilt(TimeOffsetFilter::NoFilt),
+              retainMaxAge(0.0), retainMaxPerSat(0), retainValidEph(0),
+              mapFiles(false)
       {}
 
          /** If true, ignore BeiDou time offsets with A0 and A1 terms
@@ -71,6 +74,46 @@ namespace gnsstk
           *   or at the very least can/should be filtered via
           *   TimeOffsetUnique in NavDataFactoryWithStore. */
       TimeOffsetFilter timeOffsFilt;
+
+         /** @name Retention policy
+          * Limit the data kept by NavDataFactoryWithStore, which
+          * would otherwise grow without bound when decoding data in
+          * real time.  Each time addNavData() adds a record to the
+          * internal store, expired records are removed, at the cost
+          * of an amortized constant number of map operations per
+          * record added.  The policy only applies to data added
+          * while it is in effect, and a value of zero disables each
+          * part of it.
+          */
+         //@{
+
+         /** Remove records whose user time (NavData::getUserTime())
+          * is more than this many seconds before that of the newest
+          * record added.  Records are expired in the order they were
+          * added, so this works best when data is added in roughly
+          * time order, as it is when decoding in real time. */
+      double retainMaxAge;
+
+         /** Keep at most this many records for each combination of
+          * message type and signal (NavMessageID), removing the
+          * oldest by user time first. */
+      size_t retainMaxPerSat;
+
+         /** Keep only this many of the most recent valid ephemerides
+          * for each signal, along with any invalid ones newer than
+          * them, removing anything older.  These ephemerides are
+          * never removed due to retainMaxAge, so a satellite that
+          * is not seen for a while still has ephemerides to use. */
+      size_t retainValidEph;
+
+         //@}
+
+         /** If true, factories that read text files
+          * (RinexNavDataFactory, SP3NavDataFactory) memory map them
+          * rather than reading them in blocks (see FFTextBuf).  This
+          * is a little faster, but a file that is truncated while it
+          * is being loaded will terminate the program with SIGBUS. */
+      bool mapFiles;
    };
 
       //@}
@@ -52,6 +52,8 @@ namespace gnsstk
          fsbType = 0, ///< page type start bit
          fnbType = 6, ///< page type number of bits
          fscType = 1, ///< page type scale factor
+         fsbCRC = 214, ///< CRC start bit (covers all bits before it)
+         fnbCRC = 24,  ///< CRC number of bits
       };
 
          // This enum is only used in PNBGalFNavDataFactory and it's
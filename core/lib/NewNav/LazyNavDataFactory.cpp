@@ -0,0 +1,590 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <cmath>
+#include "LazyNavDataFactory.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "NavDataFactoryListCallback.hpp"
+#include "FileSpecFind.hpp"
+
+namespace gnsstk
+{
+   LazyNavDataFactory ::
+   LazyNavDataFactory(
+      const std::shared_ptr<NavDataFactoryWithStoreFile>& factory,
+      const std::string& fileSpec,
+      const FileSpec::FSTStringMap& fsts)
+         : fact(factory),
+           spec(fileSpec),
+           specValues(fsts),
+           fileSpan(86400.0),
+           lookBehind(86400.0),
+           lookAhead(86400.0),
+           maxBytes(0),
+           cacheBytes(0),
+           loadCount(0),
+           lastWindow(0),
+           haveLastWindow(false)
+   {
+      if (!fact)
+      {
+         InvalidParameter exc("LazyNavDataFactory requires a factory");
+         GNSSTK_THROW(exc);
+      }
+      if (dynamic_cast<MultiFormatNavDataFactory*>(fact.get()) != nullptr)
+      {
+         InvalidParameter exc("LazyNavDataFactory can't use"
+                              " MultiFormatNavDataFactory");
+         GNSSTK_THROW(exc);
+      }
+      supportedSignals = fact->supportedSignals;
+      procNavTypes = fact->getTypeFilter();
+   }
+
+
+   bool LazyNavDataFactory ::
+   find(const NavMessageID& nmid, const CommonTime& when,
+        NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+        NavSearchOrder order)
+   {
+      ensureLoaded(when);
+      return fact->find(nmid, when, navOut, xmitHealth, valid, order);
+   }
+
+
+   bool LazyNavDataFactory ::
+   find(const NavMessageID& nmid, const CommonTime& when,
+        NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+        NavFindCursor& cursor)
+   {
+      ensureLoaded(when);
+      return fact->find(nmid, when, navOut, xmitHealth, valid, cursor);
+   }
+
+
+   const NavData* LazyNavDataFactory ::
+   findRecord(const NavMessageID& nmid, const CommonTime& when,
+              SVHealth xmitHealth, NavValidityType valid,
+              NavFindCursor& cursor)
+   {
+      ensureLoaded(when);
+      return fact->findRecord(nmid, when, xmitHealth, valid, cursor);
+   }
+
+
+   bool LazyNavDataFactory ::
+   getOffset(TimeSystem fromSys, TimeSystem toSys,
+             const CommonTime& when, NavDataPtr& offset,
+             SVHealth xmitHealth, NavValidityType valid)
+   {
+      ensureLoaded(when);
+      return fact->getOffset(fromSys, toSys, when, offset, xmitHealth, valid);
+   }
+
+
+   void LazyNavDataFactory ::
+   setValidityFilter(NavValidityType nvt)
+   {
+      NavDataFactory::setValidityFilter(nvt);
+      fact->setValidityFilter(nvt);
+   }
+
+
+   void LazyNavDataFactory ::
+   setTypeFilter(const NavMessageTypeSet& nmts)
+   {
+      NavDataFactory::setTypeFilter(nmts);
+      fact->setTypeFilter(nmts);
+   }
+
+
+   void LazyNavDataFactory ::
+   clearTypeFilter()
+   {
+      NavDataFactory::clearTypeFilter();
+      fact->clearTypeFilter();
+   }
+
+
+   void LazyNavDataFactory ::
+   addTypeFilter(NavMessageType nmt)
+   {
+      NavDataFactory::addTypeFilter(nmt);
+      fact->addTypeFilter(nmt);
+   }
+
+
+   bool LazyNavDataFactory ::
+   preload(const CommonTime& fromTime, const CommonTime& toTime)
+   {
+      if (frozen)
+      {
+         return false;
+      }
+      for (CommonTime when(fromTime); when <= toTime; when += fileSpan)
+      {
+         ensureLoaded(when);
+      }
+         // The stepping above may skip the window containing toTime.
+      ensureLoaded(toTime);
+      return true;
+   }
+
+
+   bool LazyNavDataFactory ::
+   addDataSource(const std::string& source)
+   {
+      if (frozen)
+      {
+         return false;
+      }
+      auto cfi = cache.find(source);
+      if (cfi != cache.end())
+      {
+            // Already loaded from the archive, just stop it from
+            // being evicted.
+         cfi->second.pinned = true;
+         return !cfi->second.records.empty();
+      }
+      bool wasCompact = fact->isCompact();
+      bool rv = loadFile(source, true);
+      std::vector<std::string> keep;
+      if (haveLastWindow)
+      {
+         keep = windows[lastWindow];
+      }
+      if (evict(keep))
+      {
+         rebuild();
+      }
+      if (wasCompact)
+      {
+         fact->compact();
+      }
+      return rv;
+   }
+
+
+   void LazyNavDataFactory ::
+   dump(std::ostream& s, DumpDetail dl) const
+   {
+      fact->dump(s, dl);
+      if (dl == DumpDetail::Full)
+      {
+         s << "Loaded files (" << cacheBytes << " bytes):" << std::endl;
+         for (const auto& fn : lru)
+         {
+            const CachedFile& cf(cache.find(fn)->second);
+            s << "  " << fn << " " << cf.records.size() << " records "
+              << cf.bytes << " bytes" << (cf.pinned ? " pinned" : "")
+              << std::endl;
+         }
+      }
+   }
+
+
+   void LazyNavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime)
+   {
+      addEdit(CacheEdit(fromTime, toTime, nullptr, loadCount));
+   }
+
+
+   void LazyNavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime,
+        const NavSatelliteID& satID)
+   {
+      addEdit(CacheEdit(fromTime, toTime, &satID, loadCount));
+   }
+
+
+   void LazyNavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime,
+        const NavSignalID& signal)
+   {
+         // Same as the store, which edits signals as satellites.
+      NavSatelliteID satMatch(signal);
+      addEdit(CacheEdit(fromTime, toTime, &satMatch, loadCount));
+   }
+
+
+   void LazyNavDataFactory ::
+   clear()
+   {
+      fact->clear();
+      cache.clear();
+      lru.clear();
+      windows.clear();
+      edits.clear();
+      cacheBytes = 0;
+      haveLastWindow = false;
+   }
+
+
+   void LazyNavDataFactory ::
+   compact()
+   {
+      fact->compact();
+   }
+
+
+   void LazyNavDataFactory ::
+   setMetricsEnabled(bool enable)
+   {
+      fact->setMetricsEnabled(enable);
+   }
+
+
+   void LazyNavDataFactory ::
+   getMetrics(std::vector<NavFactoryMetrics>& metricsOut) const
+   {
+      fact->getMetrics(metricsOut);
+   }
+
+
+   void LazyNavDataFactory ::
+   resetMetrics()
+   {
+      fact->resetMetrics();
+   }
+
+
+   void LazyNavDataFactory ::
+   freeze()
+   {
+      fact->freeze();
+      frozen = true;
+   }
+
+
+   void LazyNavDataFactory ::
+   thaw()
+   {
+      fact->thaw();
+      frozen = false;
+   }
+
+
+   void LazyNavDataFactory ::
+   setControl(const FactoryControl& ctrl)
+   {
+      NavDataFactory::setControl(ctrl);
+      fact->setControl(ctrl);
+   }
+
+
+   void LazyNavDataFactory ::
+   setFileSpan(double seconds)
+   {
+      if (!(seconds > 0))
+      {
+         InvalidParameter exc("File span must be positive");
+         GNSSTK_THROW(exc);
+      }
+      fileSpan = seconds;
+      lookBehind = seconds;
+      lookAhead = seconds;
+         // The window indices are no longer meaningful.
+      windows.clear();
+      haveLastWindow = false;
+   }
+
+
+   void LazyNavDataFactory ::
+   setMaxBytes(size_t bytes)
+   {
+      maxBytes = bytes;
+      if (frozen)
+      {
+         return;
+      }
+      std::vector<std::string> keep;
+      if (haveLastWindow)
+      {
+         keep = windows[lastWindow];
+      }
+      bool wasCompact = fact->isCompact();
+      if (evict(keep))
+      {
+         rebuild();
+         if (wasCompact)
+         {
+            fact->compact();
+         }
+      }
+   }
+
+
+   std::vector<std::string> LazyNavDataFactory ::
+   getLoadedFiles() const
+   {
+      return std::vector<std::string>(lru.begin(), lru.end());
+   }
+
+
+   void LazyNavDataFactory ::
+   ensureLoaded(const CommonTime& when)
+   {
+      if (frozen)
+      {
+         return;
+      }
+      long day;
+      double sod;
+      TimeSystem ts;
+      when.get(day, sod, ts);
+      long window = (long)std::floor(((double)day * 86400.0 + sod) /
+                                     fileSpan);
+      if (haveLastWindow && (window == lastWindow))
+      {
+            // Consecutive searches are usually for the same window,
+            // and nothing has changed since the last one.
+         return;
+      }
+      bool wasCompact = fact->isCompact();
+      bool changed = false;
+      auto wi = windows.find(window);
+      if (wi == windows.end())
+      {
+            // Files in this window haven't been looked for yet.
+         double start = (double)window * fileSpan;
+         long startDay = (long)std::floor(start / 86400.0);
+         CommonTime winStart;
+         winStart.set(startDay, start - (double)startDay * 86400.0, ts);
+         std::list<std::string> found = FileSpecFind::find(
+            spec, winStart - lookBehind, winStart + fileSpan + lookAhead,
+            specValues);
+            // Load (and later evict) the files in name order, which
+            // is time order for any sensible archive.
+         found.sort();
+         for (const auto& fn : found)
+         {
+            if (cache.find(fn) == cache.end())
+            {
+               loadFile(fn, false);
+               changed = true;
+            }
+         }
+            // Only record the window once all its files are loaded,
+            // so that it's tried again if loading throws.
+         wi = windows.insert(
+            WindowMap::value_type(
+               window, std::vector<std::string>(found.begin(), found.end())))
+            .first;
+      }
+      lastWindow = window;
+      haveLastWindow = true;
+      for (const auto& fn : wi->second)
+      {
+         touch(cache[fn]);
+      }
+      if (evict(wi->second))
+      {
+         rebuild();
+         changed = true;
+      }
+      if (changed && wasCompact)
+      {
+         fact->compact();
+      }
+   }
+
+
+   bool LazyNavDataFactory ::
+   loadFile(const std::string& source, bool pinned)
+   {
+      CachedFile& cf(cache[source]);
+      cf.arena = std::make_shared<NavDataArena>();
+      cf.seq = loadCount++;
+      cf.pinned = pinned;
+      lru.push_front(source);
+      cf.lruPos = lru.begin();
+      NavDataFactoryListCallback cb(cf.records);
+      bool rv;
+      try
+      {
+         NavDataArena::Use useArena(cf.arena);
+         rv = fact->process(source, cb);
+      }
+      catch (...)
+      {
+         lru.erase(cf.lruPos);
+         cache.erase(source);
+         throw;
+      }
+         // Add the data the same way addDataSource() would, keeping
+         // only what the store accepted so a rebuild is identical.
+      for (auto ndpi = cf.records.begin(); ndpi != cf.records.end(); ++ndpi)
+      {
+         if (!fact->addNavData(*ndpi))
+         {
+            cf.records.erase(ndpi, cf.records.end());
+            rv = false;
+            break;
+         }
+      }
+      cf.bytes = cf.arena->capacity();
+      cacheBytes += cf.bytes;
+      return rv;
+   }
+
+
+   void LazyNavDataFactory ::
+   touch(CachedFile& cf)
+   {
+      lru.splice(lru.begin(), lru, cf.lruPos);
+   }
+
+
+   bool LazyNavDataFactory ::
+   evict(const std::vector<std::string>& keep)
+   {
+      if ((maxBytes == 0) || (cacheBytes <= maxBytes))
+      {
+         return false;
+      }
+      bool rv = false;
+      for (auto lri = lru.end(); (lri != lru.begin()) &&
+              (cacheBytes > maxBytes);)
+      {
+         --lri;
+         CachedFile& cf(cache[*lri]);
+         if (cf.pinned ||
+             (std::find(keep.begin(), keep.end(), *lri) != keep.end()))
+         {
+            continue;
+         }
+         cacheBytes -= cf.bytes;
+         cache.erase(*lri);
+         lri = lru.erase(lri);
+         rv = true;
+      }
+      if (rv)
+      {
+            // Forget the windows that used the evicted files, so
+            // they'll be reloaded if needed.
+         for (auto wi = windows.begin(); wi != windows.end();)
+         {
+            bool complete = true;
+            for (const auto& fn : wi->second)
+            {
+               if (cache.find(fn) == cache.end())
+               {
+                  complete = false;
+                  break;
+               }
+            }
+            if (complete)
+            {
+               ++wi;
+            }
+            else
+            {
+               wi = windows.erase(wi);
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   void LazyNavDataFactory ::
+   rebuild()
+   {
+      std::vector<const CachedFile*> files;
+      for (const auto& cfi : cache)
+      {
+         files.push_back(&cfi.second);
+      }
+      std::sort(files.begin(), files.end(),
+                [](const CachedFile* a, const CachedFile* b)
+                { return a->seq < b->seq; });
+         // Edits made before the oldest remaining file was loaded
+         // have nothing left to apply to.
+      auto firstEdit = edits.begin();
+      while ((firstEdit != edits.end()) &&
+             (files.empty() || (firstEdit->loadSeq <= files[0]->seq)))
+      {
+         ++firstEdit;
+      }
+      edits.erase(edits.begin(), firstEdit);
+      fact->clear();
+      size_t ei = 0;
+      for (const CachedFile* cf : files)
+      {
+            // Repeat the edits that were made before this file was
+            // loaded, so they only affect the files that preceded it.
+         for (; (ei < edits.size()) && (edits[ei].loadSeq <= cf->seq); ei++)
+         {
+            applyEdit(edits[ei]);
+         }
+         for (const auto& ndp : cf->records)
+         {
+            fact->addNavData(ndp);
+         }
+      }
+      for (; ei < edits.size(); ei++)
+      {
+         applyEdit(edits[ei]);
+      }
+   }
+
+
+   void LazyNavDataFactory ::
+   addEdit(const CacheEdit& edit)
+   {
+      applyEdit(edit);
+      edits.push_back(edit);
+   }
+
+
+   void LazyNavDataFactory ::
+   applyEdit(const CacheEdit& edit)
+   {
+      if (edit.haveSat)
+      {
+         fact->edit(edit.fromTime, edit.toTime, edit.satID);
+      }
+      else
+      {
+         fact->edit(edit.fromTime, edit.toTime);
+      }
+   }
+
+}
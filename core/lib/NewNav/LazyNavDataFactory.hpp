@@ -0,0 +1,498 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_LAZYNAVDATAFACTORY_HPP
+#define GNSSTK_LAZYNAVDATAFACTORY_HPP
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FileSpec.hpp"
+#include "NavDataFactoryWithStoreFile.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Load navigation data from an archive of files on demand.
+       *
+       * Rather than being given files to load up front, this
+       * factory is given a FileSpec pattern (e.g.
+       * "/archive/%04Y/%03j/brdc%03j0.%02yn") and a
+       * NavDataFactoryWithStoreFile to load the files with.  The
+       * archive is divided into windows of time (by default one
+       * day, see setFileSpan()), and the first time find() or
+       * getOffset() is called for a time in a given window, the
+       * files covering that window are located using
+       * FileSpecFind::find() and loaded into the wrapped factory,
+       * which then performs the search.  This allows an
+       * application to use a long span of data while only paying
+       * to load the parts of it that are actually used.
+       *
+       * The files located for a window are those whose time (as
+       * determined by the FileSpec) is in [start-lookBehind,
+       * end+lookAhead), where start and end are the bounds of the
+       * window.  By default, both are one window, i.e. the files
+       * for the preceding and following windows are loaded as
+       * well.  Broadcast data is typically filed by its epoch
+       * rather than when it was transmitted, so the first messages
+       * of the following file may be transmitted within the
+       * window, and NavSearchOrder::User searches early in the
+       * window need the data transmitted before it.
+       *
+       * Each file's data is allocated from its own NavDataArena, so
+       * the memory it uses is measured rather than estimated, and
+       * evicting the file frees it a chunk at a time.  When a
+       * memory budget is set with setMaxBytes(), the least
+       * recently used files are evicted from the wrapped factory
+       * once the budget is exceeded, except for the files covering
+       * the window that is currently being searched and files
+       * loaded with addDataSource().  Evicted files are simply
+       * loaded again if they are needed later.
+       *
+       * Methods that query the contents of the store, such as
+       * getAvailableSats() and getInitialTime(), report on the data
+       * currently loaded rather than the entire archive.
+       *
+       * @warning Loading files, evicting them and rebuilding the
+       *   search index are side effects of find() and getOffset(),
+       *   so unlike other factories, searching modifies this
+       *   factory and is not safe to do from multiple threads at
+       *   once.  To search without side effects, load the windows
+       *   of interest explicitly with preload() and then call
+       *   freeze(), after which searches are limited to the data
+       *   already loaded.
+       *
+       * @note The wrapped factory should not be modified directly
+       *   while in use by this class, as those changes will not be
+       *   reflected in the cache and may be undone by an eviction.
+       *   Type and validity filters set via this class only affect
+       *   files loaded after they are set.
+       * @note MultiFormatNavDataFactory may not be used as the
+       *   wrapped factory as it stores data in its child
+       *   factories rather than itself.  Use the specific factory
+       *   for the archive's format instead. */
+   class LazyNavDataFactory : public NavDataFactory
+   {
+   public:
+         /** Set up the factory to load data on demand.
+          * @param[in] factory The factory used to load and search
+          *   the data.
+          * @param[in] fileSpec The FileSpec describing the file
+          *   names in the archive.
+          * @param[in] fsts Values for any fileSpec tokens that don't
+          *   represent time (see FileSpecFind::find()).
+          * @throw InvalidParameter if factory is null or is a
+          *   MultiFormatNavDataFactory. */
+      LazyNavDataFactory(
+         const std::shared_ptr<NavDataFactoryWithStoreFile>& factory,
+         const std::string& fileSpec,
+         const FileSpec::FSTStringMap& fsts = FileSpec::FSTStringMap());
+
+         /** Load the files for the window containing when, if not
+          * already loaded, then search the wrapped factory.
+          * @note Unless the factory is frozen, this may load and
+          *   evict files and rebuild the search index, see preload().
+          * @copydetails NavDataFactory::find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavSearchOrder) */
+      bool find(const NavMessageID& nmid, const CommonTime& when,
+                NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+                NavSearchOrder order) override;
+
+         /** Load the files for the window containing when, if not
+          * already loaded, then search the wrapped factory.
+          * @note Unless the factory is frozen, this may load and
+          *   evict files and rebuild the search index, see preload().
+          * @copydetails NavDataFactory::find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavFindCursor&) */
+      bool find(const NavMessageID& nmid, const CommonTime& when,
+                NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+                NavFindCursor& cursor) override;
+
+         /** Load the files for the window containing when, if not
+          * already loaded, then search the wrapped factory.
+          * @note Loading and evicting files changes the wrapped
+          *   factory's data, which invalidates the pointers
+          *   returned by earlier searches.
+          * @copydetails NavDataFactory::findRecord() */
+      const NavData* findRecord(const NavMessageID& nmid,
+                                const CommonTime& when,
+                                SVHealth xmitHealth, NavValidityType valid,
+                                NavFindCursor& cursor) override;
+
+         /** Load the files for the window containing when, if not
+          * already loaded, then get the offset from the wrapped
+          * factory.
+          * @note Unless the factory is frozen, this may load and
+          *   evict files and rebuild the search index, see preload().
+          * @copydetails NavDataFactory::getOffset() */
+      bool getOffset(TimeSystem fromSys, TimeSystem toSys,
+                     const CommonTime& when, NavDataPtr& offset,
+                     SVHealth xmitHealth = SVHealth::Any,
+                     NavValidityType valid = NavValidityType::ValidOnly)
+         override;
+
+         /// Set the validity filter of this and the wrapped factory.
+      void setValidityFilter(NavValidityType nvt) override;
+
+         /// Set the type filter of this and the wrapped factory.
+      void setTypeFilter(const NavMessageTypeSet& nmts) override;
+
+         /// Clear the type filter of this and the wrapped factory.
+      void clearTypeFilter() override;
+
+         /// Add to the type filter of this and the wrapped factory.
+      void addTypeFilter(NavMessageType nmt) override;
+
+         /** Load the files for the windows covering the span of
+          * time [fromTime,toTime], as find() would when searching
+          * those times, evicting other files if over budget.  This
+          * makes the loading that find() otherwise does as a side
+          * effect explicit, e.g. before calling freeze().
+          * @note If the files for all of the windows don't fit in
+          *   the memory budget, the earlier windows may be evicted
+          *   again by the later ones.
+          * @param[in] fromTime The start of the span to load.
+          * @param[in] toTime The end of the span to load.
+          * @return false if the factory is frozen, true otherwise. */
+      bool preload(const CommonTime& fromTime, const CommonTime& toTime);
+
+         /** Load a file into the wrapped factory in addition to
+          * those found in the archive.  Files loaded this way are
+          * never evicted.
+          * @param[in] source The path to the file to load.
+          * @return true on success, false on failure or if the
+          *   factory is frozen. */
+      bool addDataSource(const std::string& source) override;
+
+         /** Print the contents of the wrapped factory, followed by
+          * the files currently loaded if dl is Full. */
+      void dump(std::ostream& s, DumpDetail dl) const override;
+
+         /** Remove data in the time span [fromTime,toTime) from the
+          * wrapped factory.  The edit is repeated whenever the
+          * wrapped factory is rebuilt after an eviction, so the data
+          * isn't restored.  Files loaded after the edit, including
+          * evicted files that are loaded again, are not edited.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @throw InvalidRequest if the factory is frozen. */
+      void edit(const CommonTime& fromTime, const CommonTime& toTime) override;
+
+         /** Remove data for a specific satellite signal from the
+          * wrapped factory in the time span [fromTime,toTime).  As
+          * with edit(const CommonTime&,const CommonTime&), the edit
+          * is repeated whenever the wrapped factory is rebuilt.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @param[in] satID The complete signal specification for the
+          *   data to be removed (subject satellite, transmit
+          *   satellite, system, carrier, code, nav type).
+          * @throw InvalidRequest if the factory is frozen. */
+      void edit(const CommonTime& fromTime, const CommonTime& toTime,
+                const NavSatelliteID& satID) override;
+
+         /** Remove data for a signal from the wrapped factory in
+          * the time span [fromTime,toTime).  As with
+          * edit(const CommonTime&,const CommonTime&), the edit is
+          * repeated whenever the wrapped factory is rebuilt.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @param[in] signal The signal for the data to be removed
+          *   (system, carrier, code, nav type).
+          * @throw InvalidRequest if the factory is frozen. */
+      void edit(const CommonTime& fromTime, const CommonTime& toTime,
+                const NavSignalID& signal) override;
+
+         /** Remove all data from the wrapped factory and forget
+          * which files have been loaded, so they will be loaded
+          * again as needed. */
+      void clear() override;
+
+         /** Build the wrapped factory's search index.  The index is
+          * rebuilt whenever files are loaded or evicted. */
+      void compact() override;
+
+         /// Start or stop recording metrics for the wrapped factory.
+      void setMetricsEnabled(bool enable) override;
+
+         /** Get the metrics of the wrapped factory.
+          * @param[in,out] metricsOut The metrics are appended to
+          *   this list. */
+      void getMetrics(std::vector<NavFactoryMetrics>& metricsOut)
+         const override;
+
+         /// Set the metrics of the wrapped factory to zero.
+      void resetMetrics() override;
+
+         /// Get the metrics recorder of the wrapped factory.
+      NavFactoryMetricsRecorder& getMetricsRecorder() override
+      { return fact->getMetricsRecorder(); }
+
+         /** Prevent any further files from being loaded or evicted
+          * and freeze the wrapped factory.  Searches are then
+          * limited to the data already loaded. */
+      void freeze() override;
+
+         /// Undo freeze().
+      void thaw() override;
+
+         /// Return the start time of the data currently loaded.
+      CommonTime getInitialTime() const override
+      { return fact->getInitialTime(); }
+
+         /// Return the end time of the data currently loaded.
+      CommonTime getFinalTime() const override
+      { return fact->getFinalTime(); }
+
+         /// Return the satellites in the data currently loaded.
+      NavSatelliteIDSet getAvailableSats(const CommonTime& fromTime,
+                                         const CommonTime& toTime)
+         const override
+      { return fact->getAvailableSats(fromTime, toTime); }
+
+         /// Return the satellites in the data currently loaded.
+      NavSatelliteIDSet getAvailableSats(NavMessageType nmt,
+                                         const CommonTime& fromTime,
+                                         const CommonTime& toTime)
+         const override
+      { return fact->getAvailableSats(nmt, fromTime, toTime); }
+
+         /// Return the messages in the data currently loaded.
+      NavMessageIDSet getAvailableMsgs(const CommonTime& fromTime,
+                                       const CommonTime& toTime)
+         const override
+      { return fact->getAvailableMsgs(fromTime, toTime); }
+
+         /// Return the formats supported by the wrapped factory.
+      std::string getFactoryFormats() const override
+      { return fact->getFactoryFormats(); }
+
+         /// Set the control of this and the wrapped factory.
+      void setControl(const FactoryControl& ctrl) override;
+
+         /** Set the length of the windows of time that files are
+          * loaded for, which should match the span of time covered
+          * by each file in the archive.  Windows start at midnight
+          * and at multiples of this length after it, so it should
+          * evenly divide a day.  Setting this also resets the
+          * look-behind and look-ahead to one window.  This does not
+          * affect files that have already been loaded.
+          * @param[in] seconds The length of a window, in seconds.
+          * @throw InvalidParameter if seconds is not positive. */
+      void setFileSpan(double seconds);
+
+         /// Get the length of the windows of time files are loaded for.
+      double getFileSpan() const
+      { return fileSpan; }
+
+         /** Set how far before the start of a window to look for
+          * files to load for it.
+          * @param[in] seconds The look-behind, in seconds. */
+      void setLookBehind(double seconds)
+      { lookBehind = seconds; }
+
+         /// Get how far before the start of a window files are loaded.
+      double getLookBehind() const
+      { return lookBehind; }
+
+         /** Set how far after the end of a window to look for files
+          * to load for it.
+          * @param[in] seconds The look-ahead, in seconds. */
+      void setLookAhead(double seconds)
+      { lookAhead = seconds; }
+
+         /// Get how far after the end of a window files are loaded.
+      double getLookAhead() const
+      { return lookAhead; }
+
+         /** Set the memory budget for the loaded files.  Files are
+          * evicted, least recently used first, to keep the memory
+          * used by the loaded data within this budget.  The budget
+          * may be exceeded if the files needed for a single window
+          * don't fit.
+          * @param[in] bytes The budget in bytes, or 0 for no limit. */
+      void setMaxBytes(size_t bytes);
+
+         /// Get the memory budget for the loaded files (0 = no limit).
+      size_t getMaxBytes() const
+      { return maxBytes; }
+
+         /// Get the memory currently used by the loaded files.
+      size_t getCacheBytes() const
+      { return cacheBytes; }
+
+         /** Get the paths of the files currently loaded, most
+          * recently used first. */
+      std::vector<std::string> getLoadedFiles() const;
+
+         /// Get the number of times a file has been loaded.
+      unsigned long getLoadCount() const
+      { return loadCount; }
+
+         /// Get the factory that loads and searches the data.
+      std::shared_ptr<NavDataFactoryWithStoreFile> getFactory() const
+      { return fact; }
+
+         /// Get the FileSpec describing the archive.
+      const std::string& getFileSpec() const
+      { return spec; }
+
+   private:
+         /// The contents of a file loaded into fact.
+      class CachedFile
+      {
+      public:
+         CachedFile()
+               : bytes(0), seq(0), pinned(false)
+         {}
+            /// The records added to fact from the file, in order.
+         NavDataPtrList records;
+            /// The arena the records were allocated from.
+         NavDataArenaPtr arena;
+            /// The memory used by the records.
+         size_t bytes;
+            /// Order in which the file was loaded.
+         unsigned long seq;
+            /// If true, the file was loaded by addDataSource().
+         bool pinned;
+            /// The position of the file in lru.
+         std::list<std::string>::iterator lruPos;
+      };
+
+         /** An edit() of the wrapped factory, to be repeated when
+          * the factory is rebuilt so that each of the store's maps
+          * is edited by its own criteria. */
+      class CacheEdit
+      {
+      public:
+         CacheEdit(const CommonTime& from, const CommonTime& to,
+                   const NavSatelliteID *sat, unsigned long seq)
+               : fromTime(from), toTime(to), haveSat(sat != nullptr),
+                 loadSeq(seq)
+         {
+            if (haveSat)
+               satID = *sat;
+         }
+            /// The earliest time to be removed.
+         CommonTime fromTime;
+            /// The earliest time that will NOT be removed.
+         CommonTime toTime;
+            /// If true, only data for satID is removed.
+         bool haveSat;
+            /// The satellite signal to remove data for.
+         NavSatelliteID satID;
+            /** The value of loadCount at the time of the edit.  The
+             * edit only applies to files with a smaller seq. */
+         unsigned long loadSeq;
+      };
+
+         /// Map file path to its contents.
+      typedef std::map<std::string, CachedFile> FileMap;
+         /// Map window index to the paths of the files covering it.
+      typedef std::map<long, std::vector<std::string> > WindowMap;
+
+         /** Make sure the files for the window containing when have
+          * been loaded, and evict files if over budget.
+          * @param[in] when The time that will be searched for. */
+      void ensureLoaded(const CommonTime& when);
+
+         /** Load a file into fact and add it to the cache.
+          * @param[in] source The path of the file to load.
+          * @param[in] pinned If true, never evict the file.
+          * @return true if the file was loaded successfully. */
+      bool loadFile(const std::string& source, bool pinned);
+
+         /// Move a file to the front of lru.
+      void touch(CachedFile& cf);
+
+         /** Evict the least recently used files until the cache is
+          * within budget.
+          * @param[in] keep The files that must not be evicted.
+          * @return true if any files were evicted. */
+      bool evict(const std::vector<std::string>& keep);
+
+         /** Reload fact with the records of the cached files, in
+          * the order the files were originally loaded, repeating
+          * each edit after the files that preceded it. */
+      void rebuild();
+
+         /** Edit fact and remember the edit for rebuild().
+          * @param[in] edit The edit to apply. */
+      void addEdit(const CacheEdit& edit);
+
+         /// Apply an edit to fact.
+      void applyEdit(const CacheEdit& edit);
+
+         /// The factory that loads and searches the data.
+      std::shared_ptr<NavDataFactoryWithStoreFile> fact;
+         /// FileSpec describing the archive.
+      std::string spec;
+         /// Values for non-time tokens in spec.
+      FileSpec::FSTStringMap specValues;
+         /// Length of each window in seconds.
+      double fileSpan;
+         /// How far before a window to look for files, in seconds.
+      double lookBehind;
+         /// How far after a window to look for files, in seconds.
+      double lookAhead;
+         /// Memory budget in bytes, 0 for no limit.
+      size_t maxBytes;
+         /// Memory used by the files in cache.
+      size_t cacheBytes;
+         /// Number of times a file has been loaded.
+      unsigned long loadCount;
+         /// Files loaded into fact.
+      FileMap cache;
+         /// Paths of the files in cache, most recently used first.
+      std::list<std::string> lru;
+         /// Windows whose files have been loaded.
+      WindowMap windows;
+         /// Edits made to fact, in order, see rebuild().
+      std::vector<CacheEdit> edits;
+         /// The window most recently passed to ensureLoaded().
+      long lastWindow;
+         /// If false, lastWindow has not been set.
+      bool haveLastWindow;
+   };
+
+      //@}
+}
+
+#endif // GNSSTK_LAZYNAVDATAFACTORY_HPP
@@ -39,6 +39,7 @@
 #include "MultiFormatNavDataFactory.hpp"
 #include "BasicTimeSystemConverter.hpp"
 #include "NDFUniqConstIterator.hpp"
+#include "NavSnapshot.hpp"
 
 namespace gnsstk
 {
@@ -58,6 +59,7 @@ namespace gnsstk
    MultiFormatNavDataFactory ::
    ~MultiFormatNavDataFactory()
    {
+      thaw();
       clear();
    }
 
@@ -66,6 +68,16 @@ namespace gnsstk
    find(const NavMessageID& nmid, const CommonTime& when,
         NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
         NavSearchOrder order)
+   {
+      return (findSource(nmid, when, navOut, xmitHealth, valid, order) !=
+              nullptr);
+   }
+
+
+   NavDataFactory* MultiFormatNavDataFactory ::
+   findSource(const NavMessageID& nmid, const CommonTime& when,
+              NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+              NavSearchOrder order)
    {
          // Don't use factories.equal_range(nmid), as it can result in
          // range.first and range.second being the same iterator, in
@@ -80,15 +92,87 @@ namespace gnsstk
          // std::cerr << "fi.first = " << fi.first << "   nmid = " << nmid << std::endl;
          if ((fi.first == nmid) && (uniques.count(fi.second.get()) == 0))
          {
-            if (fi.second->find(nmid, when, navOut, xmitHealth, valid, order))
+            NavDataFactory *src = fi.second->findSource(
+               nmid, when, navOut, xmitHealth, valid, order);
+            if (src != nullptr)
+               return src;
+            uniques.insert(fi.second.get());
+         }
+      }
+      return nullptr;
+   }
+
+
+   bool MultiFormatNavDataFactory ::
+   find(const NavMessageID& nmid, const CommonTime& when,
+        NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+        NavFindCursor& cursor)
+   {
+         // Same logic as the non-cursor find(), but each factory
+         // searched gets its own cursor so a miss in one doesn't
+         // throw away the search state of the others.
+      std::set<NavDataFactory*> uniques;
+      size_t childIdx = 0;
+      for (auto& fi : *myFactories)
+      {
+         if ((fi.first == nmid) && (uniques.count(fi.second.get()) == 0))
+         {
+            if (fi.second->find(nmid, when, navOut, xmitHealth, valid,
+                                cursor.child(childIdx)))
+            {
                return true;
+            }
             uniques.insert(fi.second.get());
+            childIdx++;
          }
       }
       return false;
    }
 
 
+   const NavData* MultiFormatNavDataFactory ::
+   findRecord(const NavMessageID& nmid, const CommonTime& when,
+              SVHealth xmitHealth, NavValidityType valid,
+              NavFindCursor& cursor)
+   {
+         // Same logic as the cursor find().
+      std::set<NavDataFactory*> uniques;
+      size_t childIdx = 0;
+      for (auto& fi : *myFactories)
+      {
+         if ((fi.first == nmid) && (uniques.count(fi.second.get()) == 0))
+         {
+            const NavData *rv = fi.second->findRecord(
+               nmid, when, xmitHealth, valid, cursor.child(childIdx));
+            if (rv != nullptr)
+            {
+               return rv;
+            }
+            uniques.insert(fi.second.get());
+            childIdx++;
+         }
+      }
+      return nullptr;
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   getSearchFactories(const NavSignalID& signal,
+                      std::vector<NavDataFactory*>& facts)
+   {
+         // Same logic as find().
+      std::set<NavDataFactory*> uniques;
+      for (auto& fi : *myFactories)
+      {
+         if ((fi.first == signal) && (uniques.count(fi.second.get()) == 0))
+         {
+            fi.second->getSearchFactories(signal, facts);
+            uniques.insert(fi.second.get());
+         }
+      }
+   }
+
+
    bool MultiFormatNavDataFactory ::
    getOffset(TimeSystem fromSys, TimeSystem toSys,
              const CommonTime& when, NavDataPtr& offset,
@@ -148,6 +232,121 @@ namespace gnsstk
    }
 
 
+   void MultiFormatNavDataFactory ::
+   compact()
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->compact();
+      }
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   setMetricsEnabled(bool enable)
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->setMetricsEnabled(enable);
+      }
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   getMetrics(std::vector<NavFactoryMetrics>& metricsOut) const
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->getMetrics(metricsOut);
+      }
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   resetMetrics()
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->resetMetrics();
+      }
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   freeze()
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->freeze();
+      }
+      frozen = true;
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   thaw()
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         fi.second->thaw();
+      }
+      frozen = false;
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   setUseArena(bool use)
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         NavDataFactoryWithStore *fact =
+            dynamic_cast<NavDataFactoryWithStore*>(fi.second.get());
+         if (fact != nullptr)
+         {
+            fact->setUseArena(use);
+         }
+      }
+   }
+
+
+   bool MultiFormatNavDataFactory ::
+   writeSnapshot(const std::string& filename) const
+   {
+      std::vector<const NavDataFactoryWithStore*> facts;
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         NavDataFactoryWithStore *fact =
+            dynamic_cast<NavDataFactoryWithStore*>(fi.second.get());
+         if (fact != nullptr)
+         {
+            facts.push_back(fact);
+         }
+      }
+      return NavSnapshot::write(filename, facts);
+   }
+
+
+   bool MultiFormatNavDataFactory ::
+   readSnapshot(const std::string& filename)
+   {
+      if (frozen)
+      {
+         return false;
+      }
+      std::vector<NavDataFactoryWithStore*> facts;
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         NavDataFactoryWithStore *fact =
+            dynamic_cast<NavDataFactoryWithStore*>(fi.second.get());
+         if (fact != nullptr)
+         {
+            facts.push_back(fact);
+         }
+      }
+      return NavSnapshot::read(filename, facts);
+   }
+
+
    CommonTime MultiFormatNavDataFactory ::
    getInitialTime() const
    {
@@ -315,9 +514,9 @@ namespace gnsstk
 
 
    size_t MultiFormatNavDataFactory ::
-   numSignals() const
+   count(SatelliteSystem sys, NavMessageType nmt) const
    {
-      std::set<NavSignalID> uniqueSig;
+      size_t rv = 0;
       for (const auto& fi : NDFUniqConstIterator<NavDataFactoryMap>(*myFactories))
       {
          NavDataFactory *ndfp = fi.second.get();
@@ -325,15 +524,19 @@ namespace gnsstk
             dynamic_cast<NavDataFactoryWithStore*>(ndfp);
          if (ndfs != nullptr)
          {
-            for (const auto& mti : ndfs->data)
-            {
-               for (const auto& sigIt : mti.second)
-               {
-                  uniqueSig.insert(sigIt.first);
-               }
-            }
+            rv += ndfs->count(sys, nmt);
          }
       }
+      return rv;
+   }
+
+
+   size_t MultiFormatNavDataFactory ::
+   numSignals() const
+   {
+      NavSatelliteIDSet uniqueSat;
+      getSatellites(uniqueSat);
+      std::set<NavSignalID> uniqueSig(uniqueSat.begin(), uniqueSat.end());
       return uniqueSig.size();
    }
 
@@ -341,7 +544,15 @@ namespace gnsstk
    size_t MultiFormatNavDataFactory ::
    numSatellites() const
    {
-      std::set<NavSatelliteID> uniqueSat;
+      NavSatelliteIDSet uniqueSat;
+      getSatellites(uniqueSat);
+      return uniqueSat.size();
+   }
+
+
+   void MultiFormatNavDataFactory ::
+   getSatellites(NavSatelliteIDSet& sats) const
+   {
       for (const auto& fi : NDFUniqConstIterator<NavDataFactoryMap>(*myFactories))
       {
          NavDataFactory *ndfp = fi.second.get();
@@ -349,16 +560,9 @@ namespace gnsstk
             dynamic_cast<NavDataFactoryWithStore*>(ndfp);
          if (ndfs != nullptr)
          {
-            for (const auto& mti : ndfs->data)
-            {
-               for (const auto& satIt : mti.second)
-               {
-                  uniqueSat.insert(satIt.first);
-               }
-            }
+            ndfs->getSatellites(sats);
          }
       }
-      return uniqueSat.size();
    }
 
 
@@ -440,6 +644,10 @@ namespace gnsstk
    bool MultiFormatNavDataFactory ::
    addDataSource(const std::string& source)
    {
+      if (frozen)
+      {
+         return false;
+      }
       for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
       {
          NavDataFactory *ptr = fi.second.get();
@@ -458,6 +666,30 @@ namespace gnsstk
    }
 
 
+   bool MultiFormatNavDataFactory ::
+   addDataSources(const std::vector<std::string>& sources,
+                  unsigned numThreads)
+   {
+      if (frozen)
+      {
+         return false;
+      }
+         // Same factories in the same order as addDataSource().
+      std::vector<NavDataFactoryWithStoreFile*> facts;
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(*myFactories))
+      {
+         NavDataFactory *ptr = fi.second.get();
+         NavDataFactoryWithStoreFile *fact =
+            dynamic_cast<NavDataFactoryWithStoreFile*>(ptr);
+         if (fact != nullptr)
+         {
+            facts.push_back(fact);
+         }
+      }
+      return loadSources(facts, sources, numThreads);
+   }
+
+
    bool MultiFormatNavDataFactory ::
    process(const std::string& filename,
            NavDataFactoryCallback& cb)
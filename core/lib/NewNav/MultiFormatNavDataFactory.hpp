@@ -100,6 +100,36 @@ namespace gnsstk
                 NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
                 NavSearchOrder order) override;
 
+         /** Search the store of each factory in factories in the
+          * same manner as find(), returning the factory the
+          * navigation message came from.
+          * @copydetails NavDataFactory::findSource() */
+      NavDataFactory* findSource(const NavMessageID& nmid,
+                                 const CommonTime& when, NavDataPtr& navOut,
+                                 SVHealth xmitHealth, NavValidityType valid,
+                                 NavSearchOrder order) override;
+
+         /** Search the store of each factory in factories to find the
+          * navigation message that meets the specified criteria
+          * using NavSearchOrder::User.  Each factory searched is
+          * given its own child cursor (see NavFindCursor::child()),
+          * so the search state of each factory is kept from one
+          * search to the next even when the data comes from more
+          * than one factory.
+          * @copydetails NavDataFactory::find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavFindCursor&) */
+      bool find(const NavMessageID& nmid, const CommonTime& when,
+                NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+                NavFindCursor& cursor) override;
+
+         /** Search the store of each factory in factories in the
+          * same manner as the cursor form of find(), returning a
+          * pointer to the navigation message.
+          * @copydetails NavDataFactory::findRecord() */
+      const NavData* findRecord(const NavMessageID& nmid,
+                                const CommonTime& when,
+                                SVHealth xmitHealth, NavValidityType valid,
+                                NavFindCursor& cursor) override;
+
          /// @copydoc NavDataFactory::getOffset()
       bool getOffset(TimeSystem fromSys, TimeSystem toSys,
                      const CommonTime& when, NavDataPtr& offset,
@@ -139,6 +169,67 @@ namespace gnsstk
          /// Remove all data from the internal store.
       void clear() override;
 
+         /** Get the factories that find() searches for data of a
+          * given signal, in the order they are searched.
+          * @param[in] signal The signal that will be searched for.
+          * @param[in,out] facts The factories to search are appended
+          *   to this list. */
+      void getSearchFactories(const NavSignalID& signal,
+                              std::vector<NavDataFactory*>& facts) override;
+
+         /// Build the flat search index of each of the factories.
+      void compact() override;
+
+         /// Start or stop recording metrics for each of the factories.
+      void setMetricsEnabled(bool enable) override;
+
+         /** Get the metrics of each of the factories.
+          * @param[in,out] metricsOut The metrics are appended to
+          *   this list. */
+      void getMetrics(std::vector<NavFactoryMetrics>& metricsOut)
+         const override;
+
+         /// Set the metrics of each of the factories to zero.
+      void resetMetrics() override;
+
+         /** Freeze each of the factories (see NavDataFactory::freeze()).
+          * @warning The factories are shared by every
+          *   MultiFormatNavDataFactory in the process (see
+          *   factories()), so this freezes the data of all of them,
+          *   not just this one.  Other instances will refuse to
+          *   modify the data while it is frozen even though their
+          *   own isFrozen() returns false.  Only freeze when no
+          *   other thread is using any MultiFormatNavDataFactory. */
+      void freeze() override;
+
+         /** Thaw each of the factories (see NavDataFactory::thaw()).
+          * @warning As with freeze(), this affects every
+          *   MultiFormatNavDataFactory in the process. */
+      void thaw() override;
+
+         /** Enable or disable arena allocation in each of the
+          * factories (see NavDataFactoryWithStore::setUseArena()).
+          * @param[in] use If true, allocate from an arena. */
+      void setUseArena(bool use) override;
+
+         /** Write the contents of all of the factories to a single
+          * snapshot file, one section per factory (see
+          * NavDataFactoryWithStore::writeSnapshot()).
+          * @param[in] filename The path of the snapshot file to write.
+          * @return true on success, false if the file could not be
+          *   written or any of the factories contains a type of nav
+          *   data that snapshots do not support. */
+      bool writeSnapshot(const std::string& filename) const override;
+
+         /** Load a snapshot written by writeSnapshot() into the
+          * factories, each section going to the factory of the same
+          * class.
+          * @param[in] filename The path of the snapshot file to read.
+          * @return true on success, false if the file could not be
+          *   read, contains data for a factory that isn't present, or
+          *   if the factory is frozen. */
+      bool readSnapshot(const std::string& filename) override;
+
          /** Determine the earliest time for which this object can successfully
           * determine the Xvt for any object.
           * @note In the case that data from multiple systems is
@@ -236,8 +327,7 @@ namespace gnsstk
          /// @copydoc NavDataFactoryWithStore::count(SatelliteSystem,NavMessageType) const
       size_t count(SatelliteSystem sys,
                    NavMessageType nmt = NavMessageType::Unknown)
-         const override
-      { return NavDataFactoryWithStore::count(sys,nmt); }
+         const override;
          /// @copydoc NavDataFactoryWithStore::count(const SatID&,NavMessageType) const
       size_t count(const SatID& satID,
                    NavMessageType nmt = NavMessageType::Unknown)
@@ -289,9 +379,23 @@ namespace gnsstk
           * input.
           * @param[in] source The path of the file to load.
           * @return true on success, false if none of the available
-          *   factories succeeded. */
+          *   factories succeeded or if the factory is frozen. */
       bool addDataSource(const std::string& source) override;
 
+         /** Load multiple files, in parallel where possible (see
+          * NavDataFactoryWithStoreFile::addDataSources()).  Each file
+          * is loaded by the first factory that is able to, as with
+          * addDataSource(), and the result is identical to calling
+          * addDataSource() for each of the files in order.
+          * @param[in] sources The paths of the files to load.
+          * @param[in] numThreads The number of threads to use to
+          *   read files, where 0 means to use one per processor.
+          * @return true if all of the files were loaded by one of
+          *   the factories, false if any of them could not be loaded
+          *   or if the factory is frozen. */
+      bool addDataSources(const std::vector<std::string>& sources,
+                          unsigned numThreads = 0) override;
+
          /// @copydoc NavDataFactoryWithStoreFile::process(const std::string&,NavDataFactoryCallback&)
       bool process(const std::string& filename,
                    NavDataFactoryCallback& cb) override;
@@ -324,6 +428,9 @@ namespace gnsstk
       void setControl(const FactoryControl& ctrl) override;
 
    protected:
+         /// @copydoc NavDataFactoryWithStore::getSatellites()
+      void getSatellites(NavSatelliteIDSet& sats) const override;
+
          /** Known nav data factories, organized by signal to make
           * searches simpler and/or quicker.  Declared static so that
           * other libraries can transparently add factories. */
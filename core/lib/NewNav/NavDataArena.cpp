@@ -0,0 +1,162 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <cstdlib>
+#include "NavDataArena.hpp"
+
+namespace gnsstk
+{
+      /// Round n up to a multiple of the fundamental alignment.
+   static size_t alignSize(size_t n)
+   {
+      const size_t a = alignof(std::max_align_t);
+      return (n + a - 1) & ~(a - 1);
+   }
+
+      /// The arena used by makeNavData() in each thread.
+   static thread_local NavDataArenaPtr currentArena;
+
+
+   class NavDataArena::Chunk
+   {
+   public:
+         /// Total size of the chunk including this header.
+      size_t size;
+         /// Offset of the first unused byte from the start of the chunk.
+      size_t used;
+         /// Usage of the arena the chunk belongs to.
+      std::shared_ptr<Usage> usage;
+         /// Offset of the first record from the start of a chunk.
+      static size_t headerSize()
+      { return alignSize(sizeof(Chunk)); }
+         /// Get the record header at offset pos from the start of the chunk.
+      Record* record(size_t pos)
+      { return reinterpret_cast<Record*>(reinterpret_cast<char*>(this)+pos); }
+         /** Destroy the records in a chunk and free its memory, once
+          * nothing refers to the chunk any longer. */
+      static void release(Chunk *chunk);
+   };
+
+
+   void NavDataArena::Chunk ::
+   release(Chunk *chunk)
+   {
+      for (size_t pos = headerSize(); pos < chunk->used; )
+      {
+         Record *rec = chunk->record(pos);
+         if (rec->destroy != nullptr)
+         {
+            rec->destroy(rec+1);
+         }
+         pos += rec->next;
+      }
+      chunk->usage->chunks--;
+      chunk->usage->bytes -= chunk->size;
+      chunk->~Chunk();
+      std::free(chunk);
+   }
+
+
+   NavDataArena::Use ::
+   Use(const NavDataArenaPtr& arena)
+         : prev(currentArena)
+   {
+      currentArena = arena;
+   }
+
+
+   NavDataArena::Use ::
+   ~Use()
+   {
+      currentArena = prev;
+   }
+
+
+   NavDataArena ::
+   NavDataArena(size_t theChunkSize)
+         : chunkSize(theChunkSize),
+           usage(std::make_shared<Usage>())
+   {
+   }
+
+
+   NavDataArena ::
+   ~NavDataArena()
+   {
+   }
+
+
+   NavDataArena::Record* NavDataArena ::
+   allocate(size_t bytes, std::shared_ptr<Chunk>& chunk)
+   {
+      size_t need = sizeof(Record) + alignSize(bytes);
+      std::lock_guard<std::mutex> lock(mtx);
+      if (!active || (active->used + need > active->size))
+      {
+         size_t size = std::max(chunkSize, Chunk::headerSize() + need);
+         void *mem = std::malloc(size);
+         if (mem == nullptr)
+         {
+            throw std::bad_alloc();
+         }
+         Chunk *newChunk = new(mem) Chunk;
+         newChunk->size = size;
+         newChunk->used = Chunk::headerSize();
+         newChunk->usage = usage;
+         usage->chunks++;
+         usage->bytes += size;
+            // The previous chunk is freed once its records are no
+            // longer referenced, which may be right now.
+         active = std::shared_ptr<Chunk>(newChunk, &Chunk::release);
+      }
+      Record *rec = active->record(active->used);
+      rec->destroy = nullptr;
+      rec->next = need;
+      active->used += need;
+      chunk = active;
+      return rec;
+   }
+
+
+   const NavDataArenaPtr& NavDataArena ::
+   current()
+   {
+      return currentArena;
+   }
+}
@@ -0,0 +1,232 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_NAVDATAARENA_HPP
+#define GNSSTK_NAVDATAARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Chunked memory pool for navigation message records.
+       *
+       * Decoding a large amount of navigation data produces a very
+       * large number of small NavData objects.  Allocated
+       * individually with std::make_shared(), each one is a separate
+       * trip through the heap with its own reference count, and
+       * records that are searched together end up scattered
+       * throughout memory.  An arena instead constructs records one
+       * after the other in large chunks, so records loaded together
+       * are stored together.
+       *
+       * All of the records in a chunk share a single reference
+       * count.  The NavDataPtr returned by create() is an aliasing
+       * pointer that refers to the record but owns the chunk, so
+       * there is no per-record control block, and a chunk, along
+       * with all of the records in it, is destroyed in one go once
+       * nothing refers to any record in it.  Records may safely
+       * outlive both the arena and the store they were loaded into.
+       *
+       * Factories create records using makeNavData(), which
+       * allocates from the arena that is current for the calling
+       * thread, if any (see NavDataArena::Use), and falls back to
+       * std::make_shared() otherwise.  NavDataFactoryWithStore
+       * makes its arena current while loading data sources, when
+       * enabled with NavDataFactoryWithStore::setUseArena().
+       *
+       * @note Records are only destroyed a chunk at a time, so a
+       *   store that has had scattered records removed (e.g. by
+       *   edit() of a single satellite, or retention limits) may
+       *   hold considerably more memory than it would with
+       *   individual allocation.  clear(), and edit() of data
+       *   that was loaded together, release whole chunks. */
+   class NavDataArena
+   {
+   public:
+         /// Default size of each chunk of memory in bytes.
+      static const size_t defaultChunkSize = 65536;
+
+         /** Make an arena the current one for this thread for the
+          * lifetime of the Use object, restoring the previous one on
+          * destruction. */
+      class Use
+      {
+      public:
+            /** Make an arena current.
+             * @param[in] arena The arena to allocate records from,
+             *   which may be nullptr to use regular heap allocation. */
+         Use(const std::shared_ptr<NavDataArena>& arena);
+            /// Restore the previously current arena.
+         ~Use();
+      private:
+            /// The arena that was current when this object was created.
+         std::shared_ptr<NavDataArena> prev;
+      };
+
+         /** Create an empty arena.
+          * @param[in] chunkSize The size of the chunks of memory to
+          *   allocate from the heap. */
+      NavDataArena(size_t chunkSize = defaultChunkSize);
+
+         /** Release the arena's reference to the chunk currently
+          * being filled.  Chunks are freed once no records in them
+          * are referenced. */
+      ~NavDataArena();
+
+         /** Construct a record in the arena.  This may be used from
+          * multiple threads at once.
+          * @param[in] args The arguments to pass to T's constructor.
+          * @return A pointer to the new record, which shares the
+          *   reference count of the chunk containing it. */
+      template <class T, class... Args>
+      std::shared_ptr<T> create(Args&&... args)
+      {
+         static_assert(alignof(T) <= alignof(std::max_align_t),
+                       "NavDataArena does not support over-aligned types");
+         std::shared_ptr<Chunk> chunk;
+         Record *rec = allocate(sizeof(T), chunk);
+         T *obj = new(rec+1) T(std::forward<Args>(args)...);
+            // Only records that were successfully constructed are
+            // destroyed with the chunk.
+         rec->destroy = &destroyRecord<T>;
+         return std::shared_ptr<T>(chunk, obj);
+      }
+
+         /// Return the number of chunks currently allocated.
+      size_t numChunks() const
+      { return usage->chunks; }
+
+         /** Return the number of bytes currently allocated, including
+          * chunks that are no longer being filled but still contain
+          * referenced records. */
+      size_t capacity() const
+      { return usage->bytes; }
+
+         /** Get the arena that makeNavData() allocates from in the
+          * calling thread, or nullptr if none. */
+      static const std::shared_ptr<NavDataArena>& current();
+
+   private:
+         /// Header of a chunk of memory.
+      class Chunk;
+
+         /** Header preceding each record in a chunk, aligned for any
+          * type, used to destroy the records with the chunk. */
+      class alignas(std::max_align_t) Record
+      {
+      public:
+            /** Function that destroys the record following this
+             * header, or nullptr if the record's constructor threw. */
+         void (*destroy)(void*);
+            /// Offset from this header to the next one.
+         size_t next;
+      };
+
+         /** Chunk counts shared with the chunks, which may outlive
+          * the arena. */
+      class Usage
+      {
+      public:
+         Usage()
+               : chunks(0), bytes(0)
+         {}
+            /// Number of chunks currently allocated.
+         std::atomic<size_t> chunks;
+            /// Total size of the chunks currently allocated.
+         std::atomic<size_t> bytes;
+      };
+
+         /** Reserve memory for a record, starting a new chunk if the
+          * current one is full.
+          * @param[in] bytes The size of the record.
+          * @param[out] chunk The chunk containing the record.
+          * @return The header of the record, whose destroy function
+          *   is nullptr and which is followed by bytes of memory. */
+      Record* allocate(size_t bytes, std::shared_ptr<Chunk>& chunk);
+
+         /// Destroy a record of type T.
+      template <class T>
+      static void destroyRecord(void *p)
+      { static_cast<T*>(p)->~T(); }
+
+         /// Chunk that records are currently being constructed in.
+      std::shared_ptr<Chunk> active;
+         /// Size of new chunks, including the header.
+      size_t chunkSize;
+         /// Number and size of the chunks allocated.
+      std::shared_ptr<Usage> usage;
+         /// Protect the active chunk from simultaneous modification.
+      std::mutex mtx;
+
+      NavDataArena(const NavDataArena&) = delete;
+      NavDataArena& operator=(const NavDataArena&) = delete;
+   };
+
+      /// Shared pointer to a NavDataArena.
+   typedef std::shared_ptr<NavDataArena> NavDataArenaPtr;
+
+      /** Create a navigation message record, allocating it from the
+       * current NavDataArena if there is one.  Factories should use
+       * this in place of std::make_shared() for records that may be
+       * stored.
+       * @param[in] args The arguments to pass to T's constructor.
+       * @return A pointer to the new record. */
+   template <class T, class... Args>
+   std::shared_ptr<T> makeNavData(Args&&... args)
+   {
+      const NavDataArenaPtr& arena(NavDataArena::current());
+      if (arena)
+      {
+         return arena->create<T>(std::forward<Args>(args)...);
+      }
+      return std::make_shared<T>(std::forward<Args>(args)...);
+   }
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_NAVDATAARENA_HPP
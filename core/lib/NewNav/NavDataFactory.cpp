@@ -118,4 +118,13 @@ namespace gnsstk
    {
       return demangle(typeid(*this).name());
    }
+
+
+   void NavDataFactory ::
+   getMetrics(std::vector<NavFactoryMetrics>& metricsOut) const
+   {
+      metricsOut.push_back(NavFactoryMetrics());
+      metricsOut.back().factory = getClassName();
+      metrics.get(metricsOut.back());
+   }
 }
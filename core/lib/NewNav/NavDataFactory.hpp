@@ -41,6 +41,7 @@
 
 #include <memory>
 #include <map>
+#include <vector>
 #include "NavSignalID.hpp"
 #include "CommonTime.hpp"
 #include "NavData.hpp"
@@ -49,6 +50,8 @@
 #include "NavSearchOrder.hpp"
 #include "SVHealth.hpp"
 #include "FactoryControl.hpp"
+#include "NavFindCursor.hpp"
+#include "NavFactoryMetrics.hpp"
 
 namespace gnsstk
 {
@@ -64,7 +67,8 @@ namespace gnsstk
           * known message types. */
       NavDataFactory()
             : navValidity(NavValidityType::Any),
-              procNavTypes(allNavMessageTypes)
+              procNavTypes(allNavMessageTypes),
+              frozen(false)
       {}
 
          /// Clean up.
@@ -93,6 +97,103 @@ namespace gnsstk
                         NavDataPtr& navOut, SVHealth xmitHealth,
                         NavValidityType valid, NavSearchOrder order) = 0;
 
+         /** Search for the navigation message that meets the
+          * specified criteria in the same manner as find() with
+          * NavSearchOrder::User, using a cursor to speed up repeated
+          * searches for the same message at successive times.  See
+          * NavFindCursor for details.  This default implementation
+          * ignores the cursor.
+          * @param[in] nmid Specify the message type, satellite and
+          *   codes to match.
+          * @param[in] when The time of interest to search for data.
+          * @param[out] navOut The resulting navigation message.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in,out] cursor The state of the last search, which
+          *   is updated to reflect this one.
+          * @return true if successful.  If false, navOut will be untouched. */
+      virtual bool find(const NavMessageID& nmid, const CommonTime& when,
+                        NavDataPtr& navOut, SVHealth xmitHealth,
+                        NavValidityType valid, NavFindCursor& cursor)
+      {
+         return find(nmid, when, navOut, xmitHealth, valid,
+                     NavSearchOrder::User);
+      }
+
+         /** Search for the navigation message in the same manner as
+          * the cursor form of find(), but return a plain pointer to
+          * it.  Factories that store their messages (see
+          * NavDataFactoryWithStore) return the stored record itself
+          * when compacted, so that searching doesn't copy a
+          * NavDataPtr, which for records allocated from a
+          * NavDataArena means contention on the reference count
+          * shared by every record in the same chunk.  This default
+          * implementation keeps the result of find() in the cursor.
+          * @param[in] nmid Specify the message type, satellite and
+          *   codes to match.
+          * @param[in] when The time of interest to search for data.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in,out] cursor The state of the last search, which
+          *   is updated to reflect this one.
+          * @return The resulting navigation message, or nullptr if
+          *   not found.  The pointer remains valid until the cursor
+          *   is used again or reset, or the factory's data changes.
+          *   Use the NavDataPtr form of find() to keep the message
+          *   any longer. */
+      virtual const NavData* findRecord(const NavMessageID& nmid,
+                                        const CommonTime& when,
+                                        SVHealth xmitHealth,
+                                        NavValidityType valid,
+                                        NavFindCursor& cursor)
+      {
+         NavDataPtr& result(cursor.result);
+         result.reset();
+         if (find(nmid, when, result, xmitHealth, valid, cursor))
+         {
+            return result.get();
+         }
+         return nullptr;
+      }
+
+         /** Search for the navigation message in the same manner as
+          * find(), and return the factory that the message came
+          * from.  This allows NavLibrary to attribute the time spent
+          * using the message to the factory in NavFactoryMetrics.
+          * Unless a child class delegates find() to other factories,
+          * this is just the factory itself.
+          * @copydetails find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavSearchOrder)
+          * @return The factory that navOut came from, or nullptr if
+          *   no match was found. */
+      virtual NavDataFactory* findSource(const NavMessageID& nmid,
+                                         const CommonTime& when,
+                                         NavDataPtr& navOut,
+                                         SVHealth xmitHealth,
+                                         NavValidityType valid,
+                                         NavSearchOrder order)
+      {
+         return (find(nmid, when, navOut, xmitHealth, valid, order)
+                 ? this : nullptr);
+      }
+
+         /** Get the factories that find() searches for data of a
+          * given signal, in the order they are searched.  This
+          * allows code doing many searches for the same signal
+          * (e.g. the batch NavLibrary::getXvt() methods) to resolve
+          * the factories once rather than once per search.  Unless
+          * a child class delegates find() to other factories, this
+          * is just the factory itself.
+          * @param[in] signal The signal that will be searched for.
+          * @param[in,out] facts The factories to search are appended
+          *   to this list. */
+      virtual void getSearchFactories(const NavSignalID& signal,
+                                      std::vector<NavDataFactory*>& facts)
+      { facts.push_back(this); }
+
          /** Get the offset, in seconds, to apply to times when
           * converting them from fromSys to toSys.
           * @pre If xmithHealth is set to anything other than "Any",
@@ -216,6 +317,33 @@ namespace gnsstk
       virtual void clear()
       {}
 
+         /** Prepare the factory's internal storage for searching,
+          * e.g. by building a flat search index.  This is meant to
+          * be called after all data have been loaded and is a no-op
+          * for factories that don't support it. */
+      virtual void compact()
+      {}
+
+         /** Put the factory into a read-only state in which it is
+          * safe to call the search methods (find, getOffset,
+          * etc.) from multiple threads concurrently.  The store is
+          * compacted first.  While frozen, methods that would modify
+          * the store either fail (addDataSource returns false) or
+          * throw InvalidRequest (edit, clear).
+          * @note freeze() and thaw() themselves are not thread-safe
+          *   and must be called while no other thread is using the
+          *   factory. */
+      virtual void freeze()
+      { compact(); frozen = true; }
+
+         /// Undo freeze(), allowing the store to be modified again.
+      virtual void thaw()
+      { frozen = false; }
+
+         /// Return true if the factory is in the read-only state.
+      bool isFrozen() const
+      { return frozen; }
+
          /** Determine the earliest time for which this object can successfully
           * determine the Xvt for any object.
           * @return The initial time, or CommonTime::END_OF_TIME if no
@@ -372,6 +500,31 @@ namespace gnsstk
       virtual void setControl(const FactoryControl& ctrl)
       { factControl = ctrl; }
 
+         /** Start or stop recording NavFactoryMetrics for this
+          * factory, or for each of the factories it contains.
+          * Recording is disabled by default and costs little more
+          * than a test of a flag when disabled.
+          * @param[in] enable true to start recording. */
+      virtual void setMetricsEnabled(bool enable)
+      { metrics.setEnabled(enable); }
+
+         /** Get the metrics recorded for this factory, or for each
+          * of the factories it contains.
+          * @param[in,out] metricsOut The metrics are appended to
+          *   this list. */
+      virtual void getMetrics(std::vector<NavFactoryMetrics>& metricsOut)
+         const;
+
+         /// Set all recorded metrics to zero.
+      virtual void resetMetrics()
+      { metrics.reset(); }
+
+         /** Get the recorder for this factory's metrics, so that
+          * users of the data found, i.e. NavLibrary, can record the
+          * time they spend on it. */
+      virtual NavFactoryMetricsRecorder& getMetricsRecorder()
+      { return metrics; }
+
          /** Define which signals this factory supports.  This will be
           * empty by default, which means that NavLibrary would not
           * use this factory, so it is up to the derived classes to
@@ -392,6 +545,12 @@ namespace gnsstk
          /** Determines which types of navigation message data the
           * factory should be processing. */
       NavMessageTypeSet procNavTypes;
+
+         /// If true, the store may not be modified (see freeze()).
+      bool frozen;
+
+         /// Usage metrics, see setMetricsEnabled().
+      NavFactoryMetricsRecorder metrics;
    };
 
       /// Managed pointer to NavDataFactory.
@@ -36,8 +36,13 @@
 //                            release, distribution is unlimited.
 //
 //==============================================================================
+#include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <limits>
+#include <set>
 #include "NavDataFactoryWithStore.hpp"
+#include "NavSnapshot.hpp"
 #include "TimeString.hpp"
 #include "OrbitDataKepler.hpp"
 #include "NavHealthData.hpp"
@@ -48,11 +53,49 @@
 
 /// debug time string
 static const std::string dts("%Y/%03j/%02H:%02M:%02S %P");
+   /** Source of NavDataFactoryWithStore::indexGeneration values.
+    * This is shared by all factories so that a NavFindCursor can't
+    * mistake one factory's index for another's. */
+static std::atomic<unsigned long> lastIndexGeneration(0);
+
+/** Add delta to the count for a message type and to the count over
+ * all message types (NavMessageType::Unknown), removing any count
+ * that drops to zero.
+ * @param[in,out] counts The record counts to update.
+ * @param[in] nmt The message type of the records added or removed.
+ * @param[in] delta The number of records added (or removed, if
+ *   negative).
+ * @return true if counts is now empty. */
+static bool adjustCounts(std::map<gnsstk::NavMessageType,size_t>& counts,
+                         gnsstk::NavMessageType nmt, long delta)
+{
+   auto adjust = [&counts, delta](gnsstk::NavMessageType key)
+   {
+      auto ci = counts.find(key);
+      if (ci == counts.end())
+      {
+         ci = counts.insert(std::make_pair(key, 0)).first;
+      }
+      ci->second += delta;
+      if (ci->second == 0)
+      {
+         counts.erase(ci);
+      }
+   };
+   adjust(gnsstk::NavMessageType::Unknown);
+   if (nmt != gnsstk::NavMessageType::Unknown)
+   {
+      adjust(nmt);
+   }
+   return counts.empty();
+}
 
 namespace gnsstk
 {
    NavDataFactoryWithStore ::
    NavDataFactoryWithStore()
+         : compacted(false), indexGeneration(0), timeIndexed(false),
+           boundsIndexed(false)
    {
          // We are NOT using END_OF_TIME or BEGINNING_OF_TIME here
          // because of issues with static initialization order.  As
@@ -61,6 +104,7 @@ namespace gnsstk
          // this class) will be initialized prior to this constructor.
       initialTime.set(3442448L,0,0.0,TimeSystem::Any);
       finalTime.set(0,0,0.0,TimeSystem::Any);
+      retainNewest.set(0,0,0.0,TimeSystem::Any);
    }
 
 
@@ -69,14 +113,21 @@ namespace gnsstk
         NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
         NavSearchOrder order)
    {
+      NavFactoryMetricsRecorder::FindTimer timer(metrics, nmid);
       bool rv = false;
       switch (order)
       {
          case NavSearchOrder::User:
-            rv = findUser(nmid, when, navOut, xmitHealth, valid);
+            if (compacted)
+               rv = findUserIndex(nmid, when, navOut, xmitHealth, valid);
+            else
+               rv = findUser(nmid, when, navOut, xmitHealth, valid);
             break;
          case NavSearchOrder::Nearest:
-            rv = findNearest(nmid, when, navOut, xmitHealth, valid);
+            if (compacted)
+               rv = findNearestIndex(nmid, when, navOut, xmitHealth, valid);
+            else
+               rv = findNearest(nmid, when, navOut, xmitHealth, valid);
             break;
          default:
                // requested an invalid search order
@@ -92,11 +143,156 @@ namespace gnsstk
             if ((when < nf->beginFit) || (when > nf->endFit))
             {
                   // not a valid match, so clear the results.
+               metrics.addReject(nmid.messageType,
+                                 NavFactoryMetricsRecorder::Reject::Fit);
                navOut.reset();
                rv = false;
             }
          }
       }
+      timer.hit = rv;
+      return rv;
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   find(const NavMessageID& nmid, const CommonTime& when,
+        NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+        NavFindCursor& cursor)
+   {
+      if (!compacted)
+      {
+         cursor.reset();
+         return find(nmid, when, navOut, xmitHealth, valid,
+                     NavSearchOrder::User);
+      }
+      const NavDataPtr *ndp = findCursor(nmid, when, xmitHealth, valid,
+                                         cursor);
+      if (ndp == nullptr)
+      {
+         return false;
+      }
+      navOut = *ndp;
+      return true;
+   }
+
+
+   const NavData* NavDataFactoryWithStore ::
+   findRecord(const NavMessageID& nmid, const CommonTime& when,
+              SVHealth xmitHealth, NavValidityType valid,
+              NavFindCursor& cursor)
+   {
+      if (!compacted)
+      {
+            // Searching the maps copies the result anyway.
+         return NavDataFactory::findRecord(nmid, when, xmitHealth, valid,
+                                           cursor);
+      }
+      const NavDataPtr *ndp = findCursor(nmid, when, xmitHealth, valid,
+                                         cursor);
+      return (ndp == nullptr ? nullptr : ndp->get());
+   }
+
+
+   const NavDataPtr* NavDataFactoryWithStore ::
+   findCursor(const NavMessageID& nmid, const CommonTime& when,
+              SVHealth xmitHealth, NavValidityType valid,
+              NavFindCursor& cursor)
+   {
+      NavFactoryMetricsRecorder::FindTimer timer(metrics, nmid);
+      NavTimeIndex::Key whenKey(when);
+      bool moved = false;
+      if ((cursor.generation != indexGeneration) ||
+          !cursor.sameSearch(nmid, xmitHealth, valid))
+      {
+            // Different search or the index has been rebuilt, start over.
+         cursor.reset();
+         cursor.generation = indexGeneration;
+         cursor.nmid = nmid;
+         cursor.xmitHealth = xmitHealth;
+         cursor.valid = valid;
+         getUserMatches(nmid, whenKey, cursor.matches, true);
+         moved = true;
+      }
+      else
+      {
+            // Move the top of each match to the last record at or
+            // before when.  Moving forward to the next record is
+            // done in place, anything else needs a binary search.
+         for (auto& mi : cursor.matches)
+         {
+            const std::vector<NavTimeIndex::Key>& keys(mi.idx->keys);
+            long next = mi.top + 1;
+            if ((next < (long)keys.size()) && !(whenKey < keys[next]))
+            {
+               if ((next+1 < (long)keys.size()) && !(whenKey < keys[next+1]))
+                  mi.top = (long)mi.idx->upperBound(whenKey) - 1;
+               else
+                  mi.top = next;
+               moved = true;
+            }
+            else if ((mi.top >= 0) && (whenKey < keys[mi.top]))
+            {
+               mi.top = (long)mi.idx->upperBound(whenKey) - 1;
+               moved = true;
+            }
+         }
+      }
+      if (!moved && cursor.reusable && !(whenKey < cursor.beginFit) &&
+          !(cursor.endFit < whenKey))
+      {
+            // Nothing newer is available and the last result is
+            // still in its fit interval, so it's still the answer.
+            // The index hasn't changed, so neither has its position.
+         const NavFindCursor::Match& rm(cursor.matches[cursor.matched]);
+         timer.hit = true;
+         return &rm.idx->records[rm.i];
+      }
+      cursor.matched = selectUser(cursor.matches, whenKey, when, xmitHealth,
+                                  valid);
+      cursor.reusable = false;
+      if (cursor.matched < 0)
+      {
+         return nullptr;
+      }
+      timer.hit = true;
+      const NavFindCursor::Match& rm(cursor.matches[cursor.matched]);
+      const NavDataPtr *rv = &rm.idx->records[rm.i];
+      NavFit *nf = dynamic_cast<NavFit*>(rv->get());
+      if (nf != nullptr)
+      {
+         cursor.beginFit = NavTimeIndex::Key(nf->beginFit);
+         cursor.endFit = NavTimeIndex::Key(nf->endFit);
+      }
+      else
+      {
+         cursor.beginFit = NavTimeIndex::Key();
+         cursor.endFit = NavTimeIndex::Key();
+         cursor.endFit.msec = std::numeric_limits<int64_t>::max();
+      }
+         // The result can only be reused if it's the newest record of
+         // its match and no other match has a newer record that
+         // might become valid (e.g. by entering its fit interval).
+         // Records with the same time stamp in earlier matches take
+         // precedence, as in selectUser().
+      if (rm.i != rm.top)
+      {
+         return rv;
+      }
+      const NavTimeIndex::Key& resultKey(rm.idx->keys[rm.i]);
+      for (long mi = 0; mi < (long)cursor.matches.size(); mi++)
+      {
+         const NavFindCursor::Match& om(cursor.matches[mi]);
+         if ((mi == cursor.matched) || (om.top < 0))
+            continue;
+         const NavTimeIndex::Key& topKey(om.idx->keys[om.top]);
+         if ((resultKey < topKey) ||
+             ((mi < cursor.matched) && !(topKey < resultKey)))
+         {
+            return rv;
+         }
+      }
+      cursor.reusable = true;
       return rv;
    }
 
@@ -435,6 +631,260 @@ namespace gnsstk
    }
 
 
+   bool NavDataFactoryWithStore ::
+   findUserIndex(const NavMessageID& nmid, const CommonTime& when,
+                 NavDataPtr& navData, SVHealth xmitHealth,
+                 NavValidityType valid)
+   {
+      DEBUGTRACE_FUNCTION();
+      DEBUGTRACE("class: " << getClassName());
+      NavTimeIndex::Key whenKey(when);
+      NavFindCursor::MatchList itList;
+      getUserMatches(nmid, whenKey, itList, false);
+      DEBUGTRACE("itList.size() = " << itList.size());
+      long mi = selectUser(itList, whenKey, when, xmitHealth, valid);
+      if (mi < 0)
+      {
+         return false;
+      }
+      navData = itList[mi].idx->records[itList[mi].i];
+      return true;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   getUserMatches(const NavMessageID& nmid, const NavTimeIndex::Key& whenKey,
+                  NavFindCursor::MatchList& matches, bool all)
+   {
+      matches.clear();
+      auto dataIt = dataIndex.find(nmid.messageType);
+      if (dataIt == dataIndex.end())
+      {
+         DEBUGTRACE("not found");
+         return;
+      }
+      if (nmid.isWild())
+      {
+         DEBUGTRACE("wildcard search: " << nmid);
+         for (const auto& sati : dataIt->second)
+         {
+            if (sati.first != nmid)
+               continue; // skip non matches
+               // most recent record with a user time <= when
+            long i = (long)sati.second.upperBound(whenKey) - 1;
+            if (all || (i >= 0))
+               matches.push_back(NavFindCursor::Match(&sati.second, i));
+         }
+      }
+      else
+      {
+         DEBUGTRACE("non-wildcard search: " << nmid);
+         const NavTimeIndex *nti = findSatIndex(dataIt->second, nmid);
+         if (nti != nullptr)
+         {
+            long i = (long)nti->upperBound(whenKey) - 1;
+            if (all || (i >= 0))
+               matches.push_back(NavFindCursor::Match(nti, i));
+         }
+      }
+   }
+
+
+   long NavDataFactoryWithStore ::
+   selectUser(NavFindCursor::MatchList& matches,
+              const NavTimeIndex::Key& whenKey, const CommonTime& when,
+              SVHealth xmitHealth, NavValidityType valid)
+   {
+      bool done = true;
+      for (auto& imi : matches)
+      {
+         imi.i = imi.top;
+         imi.finished = false;
+         if (imi.top >= 0)
+            done = false;
+      }
+         // See findUser() for a description of the logic.  The index
+         // i takes the place of the iterator, where -1 takes the
+         // place of end().
+      NavTimeIndex::Key mostRecent;
+      long rv = -1;
+      while (!done)
+      {
+         for (size_t mi = 0; mi < matches.size(); mi++)
+         {
+            NavFindCursor::Match& imi(matches[mi]);
+            if (imi.top < 0)
+            {
+                  // No data at or before when, equivalent to not
+                  // being in the list at all.
+               continue;
+            }
+            done = true; // default to being done.  Gets reset to false below.
+            if (imi.finished)
+            {
+               continue;
+            }
+            else if ((imi.i >= 0) && (imi.idx->keys[imi.i] < mostRecent))
+            {
+               imi.finished = true;
+            }
+            else if (((imi.i >= 0) && (whenKey < imi.idx->keys[imi.i])) ||
+                     ((imi.i >= 0) &&
+                      !validityCheck(imi.idx->records[imi.i], valid,
+                                     xmitHealth, when)))
+            {
+               imi.i--;
+               done = false;
+            }
+            else if (imi.i < 0)
+            {
+               imi.finished = true;
+            }
+            else
+            {
+               if (mostRecent < imi.idx->keys[imi.i])
+               {
+                  mostRecent = imi.idx->keys[imi.i];
+                  rv = (long)mi;
+                  DEBUGTRACE("result is now "
+                             << imi.idx->records[imi.i]->signal);
+               }
+               imi.finished = true;
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   findNearestIndex(const NavMessageID& nmid, const CommonTime& when,
+                    NavDataPtr& navData, SVHealth xmitHealth,
+                    NavValidityType valid)
+   {
+      DEBUGTRACE_FUNCTION();
+      DEBUGTRACE("class: " << getClassName());
+         /** Class for gathering matches in findNearestIndex().  The
+          * NavTimeIndex contains one record per element where
+          * NavNearMap contains a list per time stamp, so the
+          * iterators of findNearest() become index ranges here.
+          * [gtBegin,gtEnd) is the group of records nearest to and
+          * not before the time of interest, and [ltBegin,ltEnd) is
+          * the group of records nearest to and before the time of
+          * interest.  Empty ranges take the place of end(). */
+      class FindMatches
+      {
+      public:
+         FindMatches(const NavTimeIndex *theIdx, size_t theI)
+               : idx(theIdx), gtBegin(theI), gtEnd(theI), ltBegin(theI),
+                 ltEnd(theI)
+         {
+            nextGT();
+            prevLT();
+         }
+            /// Advance [gtBegin,gtEnd) to the next group of equal times.
+         void nextGT()
+         {
+            gtBegin = gtEnd;
+            while ((gtEnd < idx->size()) &&
+                   !(idx->keys[gtBegin] < idx->keys[gtEnd]))
+            {
+               gtEnd++;
+            }
+         }
+            /// Back up [ltBegin,ltEnd) to the previous group of equal times.
+         void prevLT()
+         {
+            ltEnd = ltBegin;
+            while ((ltBegin > 0) &&
+                   !(idx->keys[ltBegin-1] < idx->keys[ltEnd-1]))
+            {
+               ltBegin--;
+            }
+         }
+         const NavTimeIndex *idx;
+         size_t gtBegin, gtEnd, ltBegin, ltEnd;
+      };
+      typedef std::vector<FindMatches> MatchList;
+
+      auto dataIt = nearestIndex.find(nmid.messageType);
+      if (dataIt == nearestIndex.end())
+      {
+         DEBUGTRACE(" false = not found 1");
+         return false; // not found.
+      }
+      NavTimeIndex::Key whenKey(when);
+      MatchList itList;
+      if (nmid.isWild())
+      {
+         DEBUGTRACE("wildcard search: " << nmid);
+         for (const auto& sati : dataIt->second)
+         {
+            if (sati.first != nmid)
+               continue; // skip non matches
+            itList.push_back(FindMatches(&sati.second,
+                                         sati.second.lowerBound(whenKey)));
+         }
+      }
+      else
+      {
+         DEBUGTRACE("non-wildcard search: " << nmid);
+         const NavTimeIndex *nti = findSatIndex(dataIt->second, nmid);
+         if (nti != nullptr)
+         {
+            itList.push_back(FindMatches(nti, nti->lowerBound(whenKey)));
+         }
+      }
+         // See findNearest() for a description of the logic.
+      bool done = itList.empty();
+      while (!done)
+      {
+         for (auto& imi : itList)
+         {
+            done = true; // default to being done.  Gets reset to false below.
+            bool haveGT = (imi.gtBegin != imi.gtEnd);
+            bool haveLT = (imi.ltBegin != imi.ltEnd);
+            if (!haveGT && !haveLT)
+            {
+               break;
+            }
+            if (haveGT &&
+                (!haveLT ||
+                 (fabs(imi.idx->keys[imi.gtBegin] - whenKey) <
+                  fabs(imi.idx->keys[imi.ltBegin] - whenKey))))
+            {
+               for (size_t i = imi.gtBegin; i < imi.gtEnd; i++)
+               {
+                  if (validityCheck(imi.idx->records[i], valid, xmitHealth,
+                                    when))
+                  {
+                     navData = imi.idx->records[i];
+                     return true;
+                  }
+               }
+               done = false;
+               imi.nextGT();
+            }
+            else
+            {
+               for (size_t i = imi.ltBegin; i < imi.ltEnd; i++)
+               {
+                  if (validityCheck(imi.idx->records[i], valid, xmitHealth,
+                                    when))
+                  {
+                     navData = imi.idx->records[i];
+                     return true;
+                  }
+               }
+               done = false;
+               imi.prevLT();
+            }
+         }
+      }
+      return false;
+   }
+
+
    bool NavDataFactoryWithStore ::
    getOffset(TimeSystem fromSys, TimeSystem toSys,
              const CommonTime& when, NavDataPtr& offset,
@@ -555,295 +1005,156 @@ namespace gnsstk
    void NavDataFactoryWithStore ::
    edit(const CommonTime& fromTime, const CommonTime& toTime)
    {
-         // edit transmit time storage
-      for (auto mti = data.begin(); mti != data.end();)
-      {
-         for (auto sati = mti->second.begin(); sati != mti->second.end();)
-         {
-            auto ti1 = sati->second.lower_bound(fromTime);
-            auto ti2 = sati->second.lower_bound(toTime);
-            sati->second.erase(ti1,ti2);
-               // clean out empty maps
-            if (sati->second.empty())
-            {
-               sati = mti->second.erase(sati);
-            }
-            else
-            {
-               ++sati;
-            }
-         }
-            // clean out empty maps
-         if (mti->second.empty())
-         {
-            mti = data.erase(mti);
-         }
-         else
-         {
-            ++mti;
-         }
-      } // for (auto& mti : data)
-         // edit nearest storage
-         // iterate over message types
-      for (auto mti = nearestData.begin(); mti != nearestData.end();)
+      if (frozen)
       {
-            // iterate over NavSatelliteIDs
-         for (auto sati = mti->second.begin(); sati != mti->second.end();)
-         {
-               // iterate over CommonTimes
-            for (auto cti = sati->second.begin(); cti != sati->second.end();)
-            {
-                  // and iterate over the list.
-               for (auto ndpli = cti->second.begin();
-                    ndpli != cti->second.end();)
-               {
-                  if (((*ndpli)->timeStamp < toTime) &&
-                      ((*ndpli)->timeStamp >= fromTime))
-                  {
-                     ndpli = cti->second.erase(ndpli);
-                  }
-                  else
-                  {
-                     ++ndpli;
-                  }
-               }
-                  // clean out empty maps
-               if (cti->second.empty())
-               {
-                  cti = sati->second.erase(cti);
-               }
-               else
-               {
-                  ++cti;
-               }
-            }
-               // clean out empty maps
-            if (sati->second.empty())
-            {
-               sati = mti->second.erase(sati);
-            }
-            else
-            {
-               ++sati;
-            }
-         }
-            // clean out empty maps
-         if (mti->second.empty())
-         {
-            mti = nearestData.erase(mti);
-         }
-         else
-         {
-            ++mti;
-         }
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
       }
-         // edit time offset storage
-         // iterate over TimeCvtKey
-      for (auto ocmi = offsetData.begin(); ocmi != offsetData.end();)
+      discardIndex();
+      editTimeIndex(fromTime, toTime, nullptr);
+   }
+
+
+   void NavDataFactoryWithStore ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime,
+        const NavSatelliteID& satID)
+   {
+      if (frozen)
       {
-            // iterate over CommonTimes
-         for (auto cti = ocmi->second.begin(); cti != ocmi->second.end();)
-         {
-               // iterate over NavSatelliteIDs
-            for (auto sati = cti->second.begin(); sati != cti->second.end();)
-            {
-               if ((sati->second->timeStamp < toTime) &&
-                   (sati->second->timeStamp >= fromTime))
-               {
-                  sati = cti->second.erase(sati);
-               }
-               else
-               {
-                  ++sati;
-               }
-            }
-               // clean out empty maps
-            if (cti->second.empty())
-            {
-               cti = ocmi->second.erase(cti);
-            }
-            else
-            {
-               ++cti;
-            }
-         }
-            // clean out empty maps
-         if (ocmi->second.empty())
-         {
-            ocmi = offsetData.erase(ocmi);
-         }
-         else
-         {
-            ++ocmi;
-         }
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
       }
+      discardIndex();
+      editTimeIndex(fromTime, toTime, &satID);
    }
 
 
    void NavDataFactoryWithStore ::
    edit(const CommonTime& fromTime, const CommonTime& toTime,
-        const NavSatelliteID& satID)
+        const NavSignalID& signal)
    {
-         // edit transmit time storage
-      for (auto mti = data.begin(); mti != data.end();)
+      NavSatelliteID satMatch(signal);
+      return edit(fromTime, toTime, satMatch);
+   }
+
+
+   void NavDataFactoryWithStore ::
+   clear()
+   {
+      if (frozen)
       {
-         for (auto sati = mti->second.begin(); sati != mti->second.end();)
-         {
-            if (sati->first != satID)
-            {
-                  // not a match
-               ++sati;
-               continue;
-            }
-            auto ti1 = sati->second.lower_bound(fromTime);
-            auto ti2 = sati->second.lower_bound(toTime);
-            sati->second.erase(ti1,ti2);
-               // clean out empty maps
-            if (sati->second.empty())
-            {
-               sati = mti->second.erase(sati);
-            }
-            else
-            {
-               ++sati;
-            }
-         }
-            // clean out empty maps
-         if (mti->second.empty())
-         {
-            mti = data.erase(mti);
-         }
-         else
-         {
-            ++mti;
-         }
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
       }
-         // edit nearest storage
-         // iterate over message types
-      for (auto mti = nearestData.begin(); mti != nearestData.end();)
+      discardIndex();
+      data.clear();
+      nearestData.clear();
+      offsetData.clear();
+      retainQueue.clear();
+      discardTimeIndex();
+      typeCounts.clear();
+      sysCounts.clear();
+      satCounts.clear();
+      signalCounts.clear();
+      retainNewest.set(0,0,0.0,TimeSystem::Any);
+      initialTime = gnsstk::CommonTime::END_OF_TIME;
+      finalTime = gnsstk::CommonTime::BEGINNING_OF_TIME;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   setUseArena(bool use)
+   {
+      if (!use)
       {
-            // iterate over NavSatelliteIDs
-         for (auto sati = mti->second.begin(); sati != mti->second.end();)
-         {
-            if (sati->first != satID)
-            {
-                  // not a match
-               ++sati;
-               continue;
-            }
-               // iterate over CommonTimes
-            for (auto cti = sati->second.begin(); cti != sati->second.end();)
-            {
-                  // and iterate over the list.
-               for (auto ndpli = cti->second.begin();
-                    ndpli != cti->second.end();)
-               {
-                  if (((*ndpli)->timeStamp < toTime) &&
-                      ((*ndpli)->timeStamp >= fromTime))
-                  {
-                     ndpli = cti->second.erase(ndpli);
-                  }
-                  else
-                  {
-                     ++ndpli;
-                  }
-               }
-                  // clean out empty maps
-               if (cti->second.empty())
-               {
-                  cti = sati->second.erase(cti);
-               }
-               else
-               {
-                  ++cti;
-               }
-            }
-               // clean out empty maps
-            if (sati->second.empty())
-            {
-               sati = mti->second.erase(sati);
-            }
-            else
-            {
-               ++sati;
-            }
-         }
-            // clean out empty maps
-         if (mti->second.empty())
-         {
-            mti = nearestData.erase(mti);
-         }
-         else
-         {
-            ++mti;
-         }
+         arena.reset();
       }
-         // edit time offset storage
-         // iterate over TimeCvtKey
-      for (auto ocmi = offsetData.begin(); ocmi != offsetData.end();)
+      else if (!arena)
       {
-            // iterate over CommonTimes
-         for (auto cti = ocmi->second.begin(); cti != ocmi->second.end();)
-         {
-               // iterate over NavSatelliteIDs
-            for (auto sati = cti->second.begin(); sati != cti->second.end();)
-            {
-               if (sati->first != satID)
-               {
-                     // not a match
-                  ++sati;
-                  continue;
-               }
-               if ((sati->second->timeStamp < toTime) &&
-                   (sati->second->timeStamp >= fromTime))
-               {
-                  sati = cti->second.erase(sati);
-               }
-               else
-               {
-                  ++sati;
-               }
-            }
-               // clean out empty maps
-            if (cti->second.empty())
-            {
-               cti = ocmi->second.erase(cti);
-            }
-            else
-            {
-               ++cti;
-            }
-         }
-            // clean out empty maps
-         if (ocmi->second.empty())
+         arena = std::make_shared<NavDataArena>();
+      }
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   writeSnapshot(const std::string& filename) const
+   {
+      return NavSnapshot::write(filename, {this});
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   readSnapshot(const std::string& filename)
+   {
+      return NavSnapshot::read(filename, {this});
+   }
+
+
+   void NavDataFactoryWithStore ::
+   compact()
+   {
+      if (frozen)
+      {
+         return;
+      }
+      discardIndex();
+      for (const auto& nmmi : data)
+      {
+         NavSatIndex& nsi(dataIndex[nmmi.first]);
+         nsi.resize(nmmi.second.size());
+         size_t i = 0;
+            // NavSatMap is already sorted, so NavSatIndex will be too.
+         for (const auto& nsmi : nmmi.second)
          {
-            ocmi = offsetData.erase(ocmi);
+            nsi[i].first = nsmi.first;
+            nsi[i].second.assign(nsmi.second);
+            i++;
          }
-         else
+      }
+      for (const auto& nnmmi : nearestData)
+      {
+         NavSatIndex& nsi(nearestIndex[nnmmi.first]);
+         nsi.resize(nnmmi.second.size());
+         size_t i = 0;
+         for (const auto& nnsmi : nnmmi.second)
          {
-            ++ocmi;
+            nsi[i].first = nnsmi.first;
+            nsi[i].second.assign(nnsmi.second);
+            i++;
          }
       }
+      indexGeneration = ++lastIndexGeneration;
+      compacted = true;
    }
 
 
-   void NavDataFactoryWithStore ::
-   edit(const CommonTime& fromTime, const CommonTime& toTime,
-        const NavSignalID& signal)
+   bool NavDataFactoryWithStore ::
+   recordLoad(const std::string& source, const std::function<bool()>& load)
    {
-      NavSatelliteID satMatch(signal);
-      return edit(fromTime, toTime, satMatch);
+      if (!metrics.isEnabled())
+      {
+         return load();
+      }
+      size_t before = size();
+      NavFactoryMetricsRecorder::Clock::time_point start =
+         NavFactoryMetricsRecorder::Clock::now();
+      bool rv = load();
+      size_t after = size();
+      metrics.addLoad(source, (after > before ? after - before : 0),
+                      NavFactoryMetricsRecorder::Clock::now() - start, rv);
+      return rv;
    }
 
 
    void NavDataFactoryWithStore ::
-   clear()
+   discardIndex()
    {
-      data.clear();
-      nearestData.clear();
-      offsetData.clear();
-      initialTime = gnsstk::CommonTime::END_OF_TIME;
-      finalTime = gnsstk::CommonTime::BEGINNING_OF_TIME;
+      if (compacted)
+      {
+         dataIndex.clear();
+         nearestIndex.clear();
+         compacted = false;
+      }
    }
 
 
@@ -853,8 +1164,10 @@ namespace gnsstk
    {
       DEBUGTRACE_FUNCTION();
       DEBUGTRACE("class: " << getClassName());
-      NavFit *nf = nullptr;
-      OrbitData *odp = nullptr;
+      if (frozen)
+      {
+         return false;
+      }
       TimeOffsetData *todp = nullptr;
       DEBUGTRACE("addNavData user = " << nd->getUserTime()
                  << "  nearest = " << nd->getNearTime());
@@ -895,126 +1208,703 @@ namespace gnsstk
          default:
             break;
       }
-         // TimeOffset data doesn't have an associated satellite, so
-         // ignore those to avoid time system conflicts in this block
-         // of code.
-      if (satID.system != SatelliteSystem::Unknown)
+         // TimeOffset data doesn't have an associated satellite, so
+         // ignore those to avoid time system conflicts in this block
+         // of code.
+      if (satID.system != SatelliteSystem::Unknown)
+      {
+         updateFirstLast(nd);
+      }
+      if (!updateInitialFinal(nd))
+      {
+         return false;
+      }
+         // The flat index doesn't support incremental updates.
+      if (&navMap == &data)
+      {
+         discardIndex();
+      }
+         // always add to navMap/navNearMap
+      NavMap& nm(navMap[nd->signal.messageType][nd->signal]);
+      CommonTime userTime(nd->getUserTime());
+      auto nmi = nm.find(userTime);
+      if (nmi == nm.end())
+      {
+         nm[userTime] = nd;
+         if (&navMap == &data)
+         {
+            countNavData(nd->signal, nd->signal.messageType, 1);
+         }
+      }
+      else
+      {
+         if (timeIndexed && (&navMap == &data))
+         {
+               // The record being replaced is no longer in data.
+            removeFromBucket(userBuckets, userTime, nmi->second);
+         }
+         if (boundsIndexed && (&navMap == &data))
+         {
+            indexBounds(nmi->second, false);
+         }
+         nmi->second = nd;
+      }
+      if (boundsIndexed && (&navMap == &data))
+      {
+         indexBounds(nd, true);
+      }
+      if (timeIndexed && (&navMap == &data))
+      {
+         addToBucket(userBuckets, userTime, nd);
+         addToBucket(stampBuckets, nd->timeStamp, nd);
+      }
+      navNearMap[nd->signal.messageType][nd->signal][nd->getNearTime()]
+         .push_back(nd);
+         // TimeOffsetData has its own special map for look-up.
+      if ((todp = dynamic_cast<TimeOffsetData*>(nd.get())) != nullptr)
+      {
+         TimeCvtSet conversions = todp->getConversions();
+         for (const auto& ci : conversions)
+         {
+            ofsMap[ci][nd->getUserTime()][nd->signal] = nd;
+         }
+      }
+      if (&navMap == &data)
+      {
+         applyRetention(nd);
+      }
+      return true;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   applyRetention(const NavDataPtr& nd)
+   {
+      const NavMessageType nmt = nd->signal.messageType;
+      if ((factControl.retainValidEph == 0) &&
+          (factControl.retainMaxPerSat == 0) &&
+          (factControl.retainMaxAge <= 0))
+      {
+         return;
+      }
+      if (!boundsIndexed)
+      {
+            // Done once, after which the index is kept up to date
+            // as records are added and removed.
+         buildBoundsIndex();
+      }
+         // Records removed here, for updating the time bounds.
+      NavDataPtrList removed;
+      if ((factControl.retainValidEph > 0) &&
+          (nmt == NavMessageType::Ephemeris) && nd->validate())
+      {
+            // Find the oldest of the retainValidEph most recent
+            // valid ephemerides and remove everything before it.
+            // Only a valid ephemeris can change which ones those
+            // are.  Each record is removed only once, so the cost
+            // is amortized over the records added.
+         NavMap& navMap(data[nmt][nd->signal]);
+         size_t numValid = 0;
+         for (auto nmi = navMap.rbegin(); nmi != navMap.rend(); ++nmi)
+         {
+            if (nmi->second->validate() &&
+                (++numValid == factControl.retainValidEph))
+            {
+               auto end = std::prev(nmi.base());
+               for (auto old = navMap.begin(); old != end;)
+               {
+                  removed.push_back(old->second);
+                  removeNavData(old->second, false);
+                  indexBounds(old->second, false);
+                  countNavData(nd->signal, nmt, -1);
+                  old = navMap.erase(old);
+               }
+               break;
+            }
+         }
+      }
+      if (factControl.retainMaxPerSat > 0)
+      {
+            // nd was just added, so the map exists and won't be
+            // emptied here.
+         NavMap& navMap(data[nmt][nd->signal]);
+         while (navMap.size() > factControl.retainMaxPerSat)
+         {
+            removed.push_back(navMap.begin()->second);
+            removeNavData(navMap.begin()->second, false);
+            indexBounds(navMap.begin()->second, false);
+            countNavData(nd->signal, nmt, -1);
+            navMap.erase(navMap.begin());
+         }
+      }
+      if (factControl.retainMaxAge > 0)
+      {
+         CommonTime userTime(nd->getUserTime());
+         userTime.setTimeSystem(TimeSystem::Any);
+         if (userTime > retainNewest)
+         {
+            retainNewest = userTime;
+         }
+         retainQueue.push_back(nd);
+         CommonTime cutoff(retainNewest - factControl.retainMaxAge);
+         while (!retainQueue.empty())
+         {
+               // Records that have already been removed some other
+               // way (trimming, edit()) have expired.
+            NavDataPtr old(retainQueue.front().lock());
+            if (!old)
+            {
+               retainQueue.pop_front();
+               continue;
+            }
+            CommonTime oldTime(old->getUserTime());
+            oldTime.setTimeSystem(TimeSystem::Any);
+            if (oldTime >= cutoff)
+            {
+               break;
+            }
+               // Records still held elsewhere after being removed
+               // are simply not found by removeNavData().
+            if ((factControl.retainValidEph == 0) ||
+                (old->signal.messageType != NavMessageType::Ephemeris) ||
+                !old->validate())
+            {
+               removed.push_back(old);
+               removeNavData(old, true);
+            }
+            retainQueue.pop_front();
+         }
+      }
+      if (!removed.empty())
+      {
+         refreshBounds(removed);
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   removeNavData(const NavDataPtr& nd, bool fromData)
+   {
+      if (fromData)
+      {
+         eraseUserData(nd);
+      }
+      eraseNearestData(nd);
+      if (timeIndexed)
+      {
+         removeFromBucket(userBuckets, nd->getUserTime(), nd);
+         removeFromBucket(stampBuckets, nd->timeStamp, nd);
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   eraseUserData(const NavDataPtr& nd)
+   {
+      const NavMessageType nmt = nd->signal.messageType;
+      auto mti = data.find(nmt);
+      if (mti != data.end())
+      {
+         auto sati = mti->second.find(nd->signal);
+         if (sati != mti->second.end())
+         {
+            auto ti = sati->second.find(nd->getUserTime());
+            if ((ti != sati->second.end()) && (ti->second == nd))
+            {
+               if (boundsIndexed)
+               {
+                  indexBounds(nd, false);
+               }
+               countNavData(sati->first, nmt, -1);
+               sati->second.erase(ti);
+               if (sati->second.empty())
+               {
+                  mti->second.erase(sati);
+                  if (mti->second.empty())
+                  {
+                     data.erase(mti);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   eraseNearestData(const NavDataPtr& nd)
+   {
+      const NavMessageType nmt = nd->signal.messageType;
+      auto nmti = nearestData.find(nmt);
+      if (nmti != nearestData.end())
+      {
+         auto sati = nmti->second.find(nd->signal);
+         if (sati != nmti->second.end())
+         {
+            auto ti = sati->second.find(nd->getNearTime());
+            if (ti != sati->second.end())
+            {
+               ti->second.remove(nd);
+               if (ti->second.empty())
+               {
+                  sati->second.erase(ti);
+                  if (sati->second.empty())
+                  {
+                     nmti->second.erase(sati);
+                     if (nmti->second.empty())
+                     {
+                        nearestData.erase(nmti);
+                     }
+                  }
+               }
+            }
+         }
+      }
+      TimeOffsetData *todp = dynamic_cast<TimeOffsetData*>(nd.get());
+      if (todp == nullptr)
+      {
+         return;
+      }
+      for (const auto& ci : todp->getConversions())
+      {
+         auto ocmi = offsetData.find(ci);
+         if (ocmi == offsetData.end())
+         {
+            continue;
+         }
+         auto cti = ocmi->second.find(nd->getUserTime());
+         if (cti == ocmi->second.end())
+         {
+            continue;
+         }
+         auto sati = cti->second.find(nd->signal);
+         if ((sati != cti->second.end()) && (sati->second == nd))
+         {
+            cti->second.erase(sati);
+            if (cti->second.empty())
+            {
+               ocmi->second.erase(cti);
+               if (ocmi->second.empty())
+               {
+                  offsetData.erase(ocmi);
+               }
+            }
+         }
+      }
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   updateInitialFinal(const CommonTime& begin, const CommonTime& end)
+   {
+      if (((initialTime.getTimeSystem() != begin.getTimeSystem()) &&
+           (initialTime.getTimeSystem() != TimeSystem::Any)) ||
+          ((finalTime.getTimeSystem() != end.getTimeSystem()) &&
+           (finalTime.getTimeSystem() != TimeSystem::Any)))
+      {
+            // different time systems, convert to UTC first.
+         CommonTime t0(initialTime), t1(finalTime), f0(begin),
+            f1(end);
+         BasicTimeSystemConverter btsc;
+         if ((t0.getTimeSystem() != TimeSystem::Any) &&
+             !t0.changeTimeSystem(TimeSystem::UTC, &btsc))
+         {
+            return false;
+         }
+         if ((t1.getTimeSystem() != TimeSystem::Any) &&
+             !t1.changeTimeSystem(TimeSystem::UTC, &btsc))
+         {
+            return false;
+         }
+         if ((f0.getTimeSystem() != TimeSystem::Any) &&
+             !f0.changeTimeSystem(TimeSystem::UTC, &btsc))
+         {
+            return false;
+         }
+         if ((f1.getTimeSystem() != TimeSystem::Any) &&
+             !f1.changeTimeSystem(TimeSystem::UTC, &btsc))
+         {
+            return false;
+         }
+            // Compare UTC times, but set initialTime/finalTime to
+            // original time system
+         if (f0 < t0)
+            initialTime = begin;
+         if (f1 > t1)
+            finalTime = end;
+      }
+      else
+      {
+         initialTime = std::min(initialTime, begin);
+         finalTime = std::max(finalTime, end);
+      }
+      return true;
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   getOrbitBounds(const NavDataPtr& nd, CommonTime& begin, CommonTime& end)
+   {
+      NavFit *nf = nullptr;
+      OrbitData *odp = nullptr;
+      if ((nf = dynamic_cast<NavFit*>(nd.get())) != nullptr)
+      {
+         begin = nf->beginFit;
+         end = nf->endFit;
+         return true;
+      }
+      else if ((odp = dynamic_cast<OrbitData*>(nd.get())) != nullptr)
+      {
+            // Non-Keplerian orbit data. Tabular, usually.  Use the
+            // reference time to update initial/final time.
+         begin = end = odp->timeStamp;
+         return true;
+      }
+      return false;
+   }
+
+
+   bool NavDataFactoryWithStore ::
+   updateInitialFinal(const NavDataPtr& nd)
+   {
+      CommonTime begin, end;
+      if (getOrbitBounds(nd, begin, end))
+      {
+         return updateInitialFinal(begin, end);
+      }
+      return true;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   updateFirstLast(const NavDataPtr& nd)
+   {
+      const SatID& satID(nd->signal.sat);
+      auto fli = firstLastMap.find(satID);
+      if (fli == firstLastMap.end())
+      {
+         firstLastMap[satID] = std::pair<CommonTime,CommonTime>(
+            nd->timeStamp,nd->timeStamp);
+      }
+      else
+      {
+            // Ignore time systems when comparing, because I'm
+            // lazy.  The few seconds difference in time systems
+            // isn't going to have a big effect on this information
+            // anyway.
+         CommonTime anyFirst(fli->second.first),
+            anyLast(fli->second.second),
+            anyTimeStamp(nd->timeStamp);
+         anyFirst.setTimeSystem(TimeSystem::Any);
+         anyLast.setTimeSystem(TimeSystem::Any);
+         anyTimeStamp.setTimeSystem(TimeSystem::Any);
+            // set the stored time stamps using the original time system.
+         if (anyTimeStamp < anyFirst)
+            fli->second.first = nd->timeStamp;
+         if (anyTimeStamp > anyLast)
+            fli->second.second = nd->timeStamp;
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   refreshBounds(const NavDataPtrList& removed)
+   {
+         // The bounds can only shrink, and only if a removed record
+         // was sitting on one of them.
+      bool times = false;
+      std::set<SatID> sats;
+      CommonTime anyInitial(initialTime), anyFinal(finalTime);
+      anyInitial.setTimeSystem(TimeSystem::Any);
+      anyFinal.setTimeSystem(TimeSystem::Any);
+      for (const auto& nd : removed)
       {
-         if (firstLastMap.find(satID) == firstLastMap.end())
+         CommonTime begin, end;
+         if (getOrbitBounds(nd, begin, end))
          {
-            firstLastMap[satID] = std::pair<CommonTime,CommonTime>(
-               nd->timeStamp,nd->timeStamp);
+            begin.setTimeSystem(TimeSystem::Any);
+            end.setTimeSystem(TimeSystem::Any);
+            if ((begin <= anyInitial) || (end >= anyFinal))
+            {
+               times = true;
+            }
          }
-         else
+         auto fli = firstLastMap.find(nd->signal.sat);
+         if (fli != firstLastMap.end())
          {
-               // Ignore time systems when comparing, because I'm
-               // lazy.  The few seconds difference in time systems
-               // isn't going to have a big effect on this information
-               // anyway.
-            CommonTime anyFirst(firstLastMap[satID].first),
-               anyLast(firstLastMap[satID].second),
+            CommonTime anyFirst(fli->second.first),
+               anyLast(fli->second.second),
                anyTimeStamp(nd->timeStamp);
             anyFirst.setTimeSystem(TimeSystem::Any);
             anyLast.setTimeSystem(TimeSystem::Any);
             anyTimeStamp.setTimeSystem(TimeSystem::Any);
-               // set the stored time stamps using the original time system.
-            if (anyTimeStamp < anyFirst)
-               firstLastMap[satID].first = nd->timeStamp;
-            if (anyTimeStamp > anyLast)
-               firstLastMap[satID].second = nd->timeStamp;
+            if ((anyTimeStamp <= anyFirst) || (anyTimeStamp >= anyLast))
+            {
+               sats.insert(nd->signal.sat);
+            }
          }
       }
-      if ((nf = dynamic_cast<NavFit*>(nd.get())) != nullptr)
+      if (times)
       {
-         if (!updateInitialFinal(nf->beginFit, nf->endFit))
-            return false;
+         initialTime = (orbitBegins.empty()
+                        ? gnsstk::CommonTime::END_OF_TIME
+                        : orbitBegins.begin()->second);
+         finalTime = (orbitEnds.empty()
+                      ? gnsstk::CommonTime::BEGINNING_OF_TIME
+                      : orbitEnds.rbegin()->second);
       }
-      else if ((odp = dynamic_cast<OrbitData*>(nd.get())) != nullptr)
+      for (const auto& sat : sats)
       {
-            // Non-Keplerian orbit data. Tabular, usually.  Use the
-            // reference time to update initial/final time.
-         if (!updateInitialFinal(odp->timeStamp,odp->timeStamp))
-            return false;
+         auto ssi = satStamps.find(sat);
+         if (ssi == satStamps.end())
+         {
+            firstLastMap.erase(sat);
+         }
+         else
+         {
+            firstLastMap[sat] = std::pair<CommonTime,CommonTime>(
+               ssi->second.begin()->second, ssi->second.rbegin()->second);
+         }
       }
-         // always add to navMap/navNearMap
-      navMap[nd->signal.messageType][nd->signal][nd->getUserTime()] = nd;
-      navNearMap[nd->signal.messageType][nd->signal][nd->getNearTime()]
-         .push_back(nd);
-         // TimeOffsetData has its own special map for look-up.
-      if ((todp = dynamic_cast<TimeOffsetData*>(nd.get())) != nullptr)
+   }
+
+
+   void NavDataFactoryWithStore ::
+   buildBoundsIndex()
+   {
+      satStamps.clear();
+      orbitBegins.clear();
+      orbitEnds.clear();
+      boundsIndexed = true;
+      for (const auto& nmmi : data)
       {
-         TimeCvtSet conversions = todp->getConversions();
-         for (const auto& ci : conversions)
+         for (const auto& nsmi : nmmi.second)
          {
-            ofsMap[ci][nd->getUserTime()][nd->signal] = nd;
+            for (const auto& nmi : nsmi.second)
+            {
+               indexBounds(nmi.second, true);
+            }
          }
       }
-      return true;
    }
 
 
-   bool NavDataFactoryWithStore ::
-   updateInitialFinal(const CommonTime& begin, const CommonTime& end)
+   void NavDataFactoryWithStore ::
+   indexBounds(const NavDataPtr& nd, bool add)
    {
-      if (((initialTime.getTimeSystem() != begin.getTimeSystem()) &&
-           (initialTime.getTimeSystem() != TimeSystem::Any)) ||
-          ((finalTime.getTimeSystem() != end.getTimeSystem()) &&
-           (finalTime.getTimeSystem() != TimeSystem::Any)))
+         // Add or remove one entry with the given time.
+      auto update = [add](BoundTimes& times, const CommonTime& when)
       {
-            // different time systems, convert to UTC first.
-         CommonTime t0(initialTime), t1(finalTime), f0(begin),
-            f1(end);
-         BasicTimeSystemConverter btsc;
-         if ((t0.getTimeSystem() != TimeSystem::Any) &&
-             !t0.changeTimeSystem(TimeSystem::UTC, &btsc))
+         CommonTime key(when);
+         key.setTimeSystem(TimeSystem::Any);
+         if (add)
          {
-            return false;
+            times.insert(BoundTimes::value_type(key, when));
+            return;
          }
-         if ((t1.getTimeSystem() != TimeSystem::Any) &&
-             !t1.changeTimeSystem(TimeSystem::UTC, &btsc))
+         auto range = times.equal_range(key);
+         for (auto i = range.first; i != range.second; ++i)
          {
-            return false;
+            if (i->second.getTimeSystem() == when.getTimeSystem())
+            {
+               times.erase(i);
+               return;
+            }
          }
-         if ((f0.getTimeSystem() != TimeSystem::Any) &&
-             !f0.changeTimeSystem(TimeSystem::UTC, &btsc))
+         if (range.first != range.second)
          {
-            return false;
+            times.erase(range.first);
          }
-         if ((f1.getTimeSystem() != TimeSystem::Any) &&
-             !f1.changeTimeSystem(TimeSystem::UTC, &btsc))
+      };
+      if (nd->signal.sat.system != SatelliteSystem::Unknown)
+      {
+         BoundTimes& stamps(satStamps[nd->signal.sat]);
+         update(stamps, nd->timeStamp);
+         if (stamps.empty())
          {
-            return false;
+            satStamps.erase(nd->signal.sat);
          }
-            // Compare UTC times, but set initialTime/finalTime to
-            // original time system
-         if (f0 < t0)
-            initialTime = begin;
-         if (f1 > t1)
-            finalTime = end;
       }
-      else
+      CommonTime begin, end;
+      if (getOrbitBounds(nd, begin, end))
       {
-         initialTime = std::min(initialTime, begin);
-         finalTime = std::max(finalTime, end);
+         update(orbitBegins, begin);
+         update(orbitEnds, end);
       }
-      return true;
    }
 
 
-   size_t NavDataFactoryWithStore ::
-   size() const
+   void NavDataFactoryWithStore ::
+   editTimeIndex(const CommonTime& fromTime, const CommonTime& toTime,
+                 const NavSatelliteID *satID)
    {
-      size_t rv = 0;
+      if (!timeIndexed)
+      {
+         buildTimeIndex();
+      }
+      auto matches = [satID](const NavDataPtr& nd)
+      {
+         const NavSatelliteID& sat(nd->signal);
+         return ((satID == nullptr) || (sat == *satID));
+      };
+      long lastBucket = timeBucket(toTime);
+         // edit transmit time storage, by user time
+      for (auto bi = userBuckets.lower_bound(timeBucket(fromTime));
+           (bi != userBuckets.end()) && (bi->first <= lastBucket);)
+      {
+         std::vector<NavDataPtr>& bucket(bi->second);
+         for (size_t i = 0; i < bucket.size();)
+         {
+            CommonTime userTime(bucket[i]->getUserTime());
+            if (matches(bucket[i]) &&
+                (userTime >= fromTime) && (userTime < toTime))
+            {
+               eraseUserData(bucket[i]);
+               bucket[i] = bucket.back();
+               bucket.pop_back();
+            }
+            else
+            {
+               i++;
+            }
+         }
+            // clean out empty buckets
+         if (bucket.empty())
+         {
+            bi = userBuckets.erase(bi);
+         }
+         else
+         {
+            ++bi;
+         }
+      }
+         // edit nearest and time offset storage, by time stamp
+      for (auto bi = stampBuckets.lower_bound(timeBucket(fromTime));
+           (bi != stampBuckets.end()) && (bi->first <= lastBucket);)
+      {
+         std::vector<NavDataPtr>& bucket(bi->second);
+         for (size_t i = 0; i < bucket.size();)
+         {
+            if (matches(bucket[i]) &&
+                (bucket[i]->timeStamp >= fromTime) &&
+                (bucket[i]->timeStamp < toTime))
+            {
+               eraseNearestData(bucket[i]);
+               bucket[i] = bucket.back();
+               bucket.pop_back();
+            }
+            else
+            {
+               i++;
+            }
+         }
+            // clean out empty buckets
+         if (bucket.empty())
+         {
+            bi = stampBuckets.erase(bi);
+         }
+         else
+         {
+            ++bi;
+         }
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   buildTimeIndex()
+   {
+      userBuckets.clear();
+      stampBuckets.clear();
       for (const auto& mti : data)
       {
-         for (const auto& satIt : mti.second)
+         for (const auto& sati : mti.second)
+         {
+            for (const auto& ti : sati.second)
+            {
+               addToBucket(userBuckets, ti.first, ti.second);
+            }
+         }
+      }
+         // Every record in offsetData is also in nearestData.
+      for (const auto& mti : nearestData)
+      {
+         for (const auto& sati : mti.second)
+         {
+            for (const auto& ti : sati.second)
+            {
+               for (const auto& ndp : ti.second)
+               {
+                  addToBucket(stampBuckets, ndp->timeStamp, ndp);
+               }
+            }
+         }
+      }
+      timeIndexed = true;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   discardTimeIndex()
+   {
+      userBuckets.clear();
+      stampBuckets.clear();
+      timeIndexed = false;
+      satStamps.clear();
+      orbitBegins.clear();
+      orbitEnds.clear();
+      boundsIndexed = false;
+   }
+
+
+   long NavDataFactoryWithStore ::
+   timeBucket(const CommonTime& when)
+   {
+      long day, sod;
+      double fsod;
+      when.get(day, sod, fsod);
+      return day * (SEC_PER_DAY / timeBucketSeconds) + sod / timeBucketSeconds;
+   }
+
+
+   void NavDataFactoryWithStore ::
+   addToBucket(NavTimeBuckets& buckets, const CommonTime& when,
+               const NavDataPtr& nd)
+   {
+      buckets[timeBucket(when)].push_back(nd);
+   }
+
+
+   void NavDataFactoryWithStore ::
+   removeFromBucket(NavTimeBuckets& buckets, const CommonTime& when,
+                    const NavDataPtr& nd)
+   {
+      auto bi = buckets.find(timeBucket(when));
+      if (bi == buckets.end())
+      {
+         return;
+      }
+      std::vector<NavDataPtr>& bucket(bi->second);
+      auto ndi = std::find(bucket.begin(), bucket.end(), nd);
+      if (ndi != bucket.end())
+      {
+         *ndi = bucket.back();
+         bucket.pop_back();
+         if (bucket.empty())
          {
-            rv += satIt.second.size();
+            buckets.erase(bi);
          }
       }
+   }
+
+
+   size_t NavDataFactoryWithStore ::
+   size() const
+   {
          // OffsetCvtMap doesn't need to be counted because the data
          // is now also being stored in the data above.
-      return rv;
+      auto tci = typeCounts.find(NavMessageType::Unknown);
+      return (tci == typeCounts.end() ? 0 : tci->second);
    }
 
 
@@ -1027,45 +1917,30 @@ namespace gnsstk
          // Make a copy of the key that can be modified so that values
          // that are otherwise not wildcards e.g. SatelliteSystem can
          // be managed like wildcards.
-      NavMessageID key(nmid);
-         // Iterate over all nav message types.  Skip anything that
-         // doesn't match, treating "Unknown" as a wildcard.
-      for (NavMessageType i : NavMessageTypeIterator())
+      NavSatelliteID key(nmid);
+         // There are no non-wildcard searches because we treat
+         // SatelliteSystem::Unknown as a wildcard when it normally
+         // is not.
+      DEBUGTRACE("wildcard search: " << nmid);
+      for (const auto& sci : satCounts)
       {
-         if ((nmid.messageType != NavMessageType::Unknown) &&
-             (nmid.messageType != i))
+            // treat the SatelliteSystem::Unknown like a wildcard
+         if (nmid.system == SatelliteSystem::Unknown)
          {
-            DEBUGTRACE("skipping message type " << StringUtils::asString(i));
-            continue;
+            key.system = sci.first.system;
          }
-         DEBUGTRACE("counting message type " << StringUtils::asString(i));
-         auto dataIt = data.find(i);
-         if (dataIt == data.end())
+         if (sci.first != key)
          {
-               // no data for this message type, move on
+            DEBUGTRACE(sci.first << " != " << nmid);
             continue;
          }
-            // There are no non-wildcard searches because we treat
-            // SatelliteSystem::Unknown as a wildcard when it normally
-            // is not.
-         DEBUGTRACE("wildcard search: " << nmid);
-         for (const auto& sati : dataIt->second)
+            // NavMessageType::Unknown is the count over all types,
+            // which is what we want for a wildcard message type.
+         auto tci = sci.second.find(nmid.messageType);
+         if (tci != sci.second.end())
          {
-               // treat the SatelliteSystem::Unknown like a wildcard
-            if (nmid.system == SatelliteSystem::Unknown)
-            {
-               key.system = sati.first.system;
-            }
-            if (sati.first == key)
-            {
-               DEBUGTRACE("matches " << sati.second.size() << " x "
-                          << sati.first);
-               rv += sati.second.size();
-            }
-            else
-            {
-               DEBUGTRACE(sati.first << " != " << nmid);
-            }
+            DEBUGTRACE("matches " << tci->second << " x " << sci.first);
+            rv += tci->second;
          }
       }
       return rv;
@@ -1075,19 +1950,18 @@ namespace gnsstk
    size_t NavDataFactoryWithStore ::
    count(SatelliteSystem sys, NavMessageType nmt) const
    {
-      NavMessageID key(
-         NavSatelliteID(gnsstk::SatID(gnsstk::SatelliteSystem::Unknown),
-                        gnsstk::SatID(gnsstk::SatelliteSystem::Unknown),
-                        gnsstk::ObsID(gnsstk::ObservationType::Any,
-                                      gnsstk::CarrierBand::Any,
-                                      gnsstk::TrackingCode::Any,
-                                      gnsstk::XmitAnt::Any),
-                        gnsstk::NavID(gnsstk::NavType::Any)),
-         nmt);
-      key.sat.makeWild();
-      key.xmitSat.makeWild();
-      key.system = sys;
-      return count(key);
+      const NavTypeCounts *counts = &typeCounts;
+      if (sys != SatelliteSystem::Unknown)
+      {
+         auto sci = sysCounts.find(sys);
+         if (sci == sysCounts.end())
+         {
+            return 0;
+         }
+         counts = &sci->second;
+      }
+      auto tci = counts->find(nmt);
+      return (tci == counts->end() ? 0 : tci->second);
    }
 
 
@@ -1111,48 +1985,84 @@ namespace gnsstk
    size_t NavDataFactoryWithStore ::
    count(NavMessageType nmt) const
    {
-      NavMessageID key(
-         NavSatelliteID(gnsstk::SatID(gnsstk::SatelliteSystem::Unknown),
-                        gnsstk::SatID(gnsstk::SatelliteSystem::Unknown),
-                        gnsstk::ObsID(gnsstk::ObservationType::Any,
-                                      gnsstk::CarrierBand::Any,
-                                      gnsstk::TrackingCode::Any,
-                                      gnsstk::XmitAnt::Any),
-                        gnsstk::NavID(gnsstk::NavType::Any)),
-         nmt);
-      key.sat.makeWild();
-      key.xmitSat.makeWild();
-      return count(key);
+      return count(SatelliteSystem::Unknown, nmt);
    }
 
 
    size_t NavDataFactoryWithStore ::
    numSignals() const
    {
-      std::set<NavSignalID> uniques;
-      for (const auto& mti : data)
+      return signalCounts.size();
+   }
+
+
+   size_t NavDataFactoryWithStore ::
+   numSatellites() const
+   {
+      return satCounts.size();
+   }
+
+
+   void NavDataFactoryWithStore ::
+   getSatellites(NavSatelliteIDSet& sats) const
+   {
+      for (const auto& sci : satCounts)
+      {
+         sats.insert(sats.end(), sci.first);
+      }
+   }
+
+
+   void NavDataFactoryWithStore ::
+   countNavData(const NavSatelliteID& sat, NavMessageType nmt, long delta)
+   {
+      if (delta == 0)
       {
-         for (const auto& satIt : mti.second)
+         return;
+      }
+      adjustCounts(typeCounts, nmt, delta);
+      auto syci = sysCounts.find(sat.system);
+      if (syci == sysCounts.end())
+      {
+         syci = sysCounts.insert(
+            std::make_pair(sat.system, NavTypeCounts())).first;
+      }
+      if (adjustCounts(syci->second, nmt, delta))
+      {
+         sysCounts.erase(syci);
+      }
+      auto sci = satCounts.find(sat);
+      if (sci == satCounts.end())
+      {
+         sci = satCounts.insert(std::make_pair(sat, NavTypeCounts())).first;
+         signalCounts[sat]++;
+      }
+      if (adjustCounts(sci->second, nmt, delta))
+      {
+         satCounts.erase(sci);
+         auto sgi = signalCounts.find(sat);
+         if (--sgi->second == 0)
          {
-            uniques.insert(satIt.first);
+            signalCounts.erase(sgi);
          }
       }
-      return uniques.size();
    }
 
 
-   size_t NavDataFactoryWithStore ::
-   numSatellites() const
+   void NavDataFactoryWithStore ::
+   recountNavData()
    {
-      std::set<NavSatelliteID> uniques;
+      typeCounts.clear();
+      sysCounts.clear();
+      satCounts.clear();
+      signalCounts.clear();
       for (const auto& mti : data)
       {
-         for (const auto& satIt : mti.second)
+         for (const auto& sati : mti.second)
          {
-            uniques.insert(satIt.first);
+            countNavData(sati.first, mti.first, sati.second.size());
          }
       }
-      return uniques.size();
    }
 
 
@@ -1188,6 +2098,8 @@ namespace gnsstk
       {
          if ((when < nf->beginFit) || (when > nf->endFit))
          {
+            metrics.addReject(ndp->signal.messageType,
+                              NavFactoryMetricsRecorder::Reject::Fit);
             return false;
          }
       }
@@ -1207,6 +2119,8 @@ namespace gnsstk
       {
             // already determined to be invalid, don't bother doing
             // further checking
+         metrics.addReject(ndp->signal.messageType,
+                           NavFactoryMetricsRecorder::Reject::Validity);
          return false;
       }
          // We're already trying to get health information, seems like
@@ -1216,7 +2130,13 @@ namespace gnsstk
       {
          return rv;
       }
-      return matchHealth(ndp.get(), xmitHealth);
+      if (!matchHealth(ndp.get(), xmitHealth))
+      {
+         metrics.addReject(ndp->signal.messageType,
+                           NavFactoryMetricsRecorder::Reject::Health);
+         return false;
+      }
+      return true;
    }
 
 
@@ -1381,16 +2301,11 @@ namespace gnsstk
                const CommonTime& toTime) const
    {
       std::set<SatID> rv;
-      for (const auto& nmmi : data)
+         // Use the virtual methods so that derived classes that
+         // store data elsewhere are accounted for.
+      for (const auto& nmid : getAvailableMsgs(fromTime, toTime))
       {
-         for (const auto& nsmi : nmmi.second)
-         {
-            auto ti1 = nsmi.second.lower_bound(fromTime);
-            if ((ti1 != nsmi.second.end()) && (ti1->first < toTime))
-            {
-               rv.insert(nsmi.first.sat);
-            }
-         }
+         rv.insert(nmid.sat);
       }
       return rv;
    }
@@ -1402,17 +2317,9 @@ namespace gnsstk
                const CommonTime& toTime) const
    {
       std::set<SatID> rv;
-      auto nmmi = data.find(nmt);
-      if (nmmi != data.end())
+      for (const auto& nsid : getAvailableSats(nmt, fromTime, toTime))
       {
-         for (const auto& nsmi : nmmi->second)
-         {
-            auto ti1 = nsmi.second.lower_bound(fromTime);
-            if ((ti1 != nsmi.second.end()) && (ti1->first < toTime))
-            {
-               rv.insert(nsmi.first.sat);
-            }
-         }
+         rv.insert(nsid.sat);
       }
       return rv;
    }
@@ -39,9 +39,14 @@
 #ifndef GNSSTK_NAVDATAFACTORYWITHSTORE_HPP
 #define GNSSTK_NAVDATAFACTORYWITHSTORE_HPP
 
+#include <deque>
+#include <functional>
+#include <map>
 #include "NavDataFactory.hpp"
 #include "TimeOffsetData.hpp"
 #include "StdNavTimeOffset.hpp"
+#include "NavTimeIndex.hpp"
+#include "NavDataArena.hpp"
 
 namespace gnsstk
 {
@@ -104,6 +109,28 @@ namespace gnsstk
                 NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
                 NavSearchOrder order) override;
 
+         /** Search the store to find the navigation message that meets
+          * the specified criteria, using a cursor to avoid repeating
+          * the search when the time of interest moves forward
+          * through the data.  The result is always the same as that
+          * of find() with NavSearchOrder::User.
+          * @note The cursor is only used when the store is
+          *   compacted (see compact()).  Otherwise this is
+          *   equivalent to calling find().
+          * @copydetails NavDataFactory::find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavFindCursor&) */
+      bool find(const NavMessageID& nmid, const CommonTime& when,
+                NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+                NavFindCursor& cursor) override;
+
+         /** Search the store in the same manner as the cursor form
+          * of find(), returning the stored record itself.  When the
+          * store is compacted, no reference counts are touched.
+          * @copydetails NavDataFactory::findRecord() */
+      const NavData* findRecord(const NavMessageID& nmid,
+                                const CommonTime& when,
+                                SVHealth xmitHealth, NavValidityType valid,
+                                NavFindCursor& cursor) override;
+
          /// @copydoc NavDataFactory::getOffset()
       bool getOffset(TimeSystem fromSys, TimeSystem toSys,
                      const CommonTime& when, NavDataPtr& offset,
@@ -115,6 +142,7 @@ namespace gnsstk
           * span [fromTime,toTime).
           * @param[in] fromTime The earliest time to be removed.
           * @param[in] toTime The earliest time that will NOT be removed.
+          * @throw InvalidRequest if the factory is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime) override;
 
@@ -125,6 +153,7 @@ namespace gnsstk
           * @param[in] satID The complete signal specification for the
           *   data to be removed (subject satellite, transmit
           *   satellite, system, carrier, code, nav).
+          * @throw InvalidRequest if the factory is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime,
                 const NavSatelliteID& satID) override;
@@ -136,28 +165,87 @@ namespace gnsstk
           * @param[in] toTime The earliest time that will NOT be removed.
           * @param[in] signal The signal for the data to be removed
           *   (system, carrier, code, nav).
+          * @throw InvalidRequest if the factory is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime,
                 const NavSignalID& signal) override;
 
-         /// Remove all data from the internal store.
+         /** Remove all data from the internal store.
+          * @throw InvalidRequest if the factory is frozen. */
       void clear() override;
 
+         /** Build the flat, time-sorted index (see NavTimeIndex) of
+          * the data currently in the store.  Once built, find() uses
+          * the index instead of descending through the maps.  Adding
+          * data to the internal store, editing or clearing it
+          * discards the index, at which point find() falls back to
+          * the maps until compact() is called again.  The typical
+          * use is to call compact() once after all the data sources
+          * have been loaded.  This is a no-op while the factory is
+          * frozen, as freeze() has already built the index. */
+      void compact() override;
+
+         /** Return true if the flat index is current, i.e. compact()
+          * was called and the store has not changed since. */
+      bool isCompact() const
+      { return compacted; }
+
+         /** Enable or disable allocation of the records loaded by
+          * addDataSource() from a NavDataArena belonging to this
+          * store, rather than individually from the heap.  Records
+          * loaded together are stored together, without a
+          * reference count of their own, and clear() or edit() of
+          * data that was loaded together frees whole chunks.  Use
+          * findRecord() to search without touching the reference
+          * counts at all.  Data that has already been loaded is not
+          * affected.  Records decoded outside of addDataSource()
+          * (e.g. by PNBNavDataFactory) can be allocated from the
+          * same arena by creating a NavDataArena::Use object with
+          * getArena() while decoding.
+          * @param[in] use If true, allocate from an arena. */
+      virtual void setUseArena(bool use);
+
+         /** Get the arena records are allocated from, or nullptr if
+          * setUseArena() has not been used to enable it. */
+      const NavDataArenaPtr& getArena() const
+      { return arena; }
+
+         /** Write the contents of the store to a binary snapshot file
+          * (see NavSnapshot), which readSnapshot() can load far more
+          * quickly than the original data sources.
+          * @param[in] filename The path of the snapshot file to write.
+          * @return true on success, false if the file could not be
+          *   written or the store contains a type of nav data that
+          *   snapshots do not support. */
+      virtual bool writeSnapshot(const std::string& filename) const;
+
+         /** Add the contents of a snapshot file written by
+          * writeSnapshot() to the store.  The snapshot must have been
+          * written by a factory of the same class.
+          * @param[in] filename The path of the snapshot file to read.
+          * @return true on success, false if the file could not be
+          *   read or is not a snapshot for this class of factory, or
+          *   if the factory is frozen. */
+      virtual bool readSnapshot(const std::string& filename);
+
          /** Add a nav message to the internal store (data).
           * @param[in] nd The nav data to add.
-          * @return true if successful. */
+          * @return true if successful, false if the factory is frozen. */
       bool addNavData(const NavDataPtr& nd)
       { return addNavData(nd, data, nearestData, offsetData); }
 
-         /** Add a nav message to the given store.
+         /** Add a nav message to the given store.  Derived classes
+          * that keep some of their data outside of the maps can
+          * override this to move it there.
           * @param[in] nd The nav data to add.
           * @param[out] navMap The map to load the data in.
           * @param[out] navNearMap The map to load the data in
           *   for use by "Nearest" (as opposed to "User") searches.
           * @param[out] ofsMap The map to load TimeOffsetData into.
-          * @return true if successful. */
-      bool addNavData(const NavDataPtr& nd, NavMessageMap& navMap,
-                      NavNearMessageMap& navNearMap, OffsetCvtMap& ofsMap);
+          * @return true if successful, false if the factory is frozen. */
+      virtual bool addNavData(const NavDataPtr& nd, NavMessageMap& navMap,
+                              NavNearMessageMap& navNearMap,
+                              OffsetCvtMap& ofsMap);
 
          /** Determine the earliest time for which this object can successfully
           * determine the Xvt for any object.
@@ -302,15 +390,15 @@ namespace gnsstk
           * doesn't make SatID a wildcard, that requires the
           * SatID::makeWild() method calls.
           *
-          * @note This method has a bit of overhead, though no more
-          *   than find(). */
+          * @note The time this takes is proportional to the number
+          *   of distinct satellites in the store, not the number of
+          *   messages. */
       virtual size_t count(const NavMessageID& nmid) const;
          /** Return a count of messages matching the given
           * SatelliteSystem and NavMessageType.
           * @param[in] sys The SatelliteSystem to match when counting.
           * @param[in] nmt The NavMessageType to match (default Unknown=all).
-          * @note This method has a bit of overhead, though no more
-          *   than find().
+          * @note This method takes constant time.
           * @note Only NavSignalID::system is checked, if you need to
           *   explicitly check NavSatelliteID::SatID::system, use the
           *   count(constNavMessageID&). */
@@ -321,14 +409,13 @@ namespace gnsstk
           * matches the given SatID and message type.
           * @param[in] satID The subject satellite ID to match.
           * @param[in] nmt The NavMessageType to match (default Unknown=all).
-          * @note This method has a bit of overhead, though no more
-          *   than find(). */
+          * @note The time this takes is proportional to the number
+          *   of distinct satellites in the store. */
       virtual size_t count(const SatID& satID,
                            NavMessageType nmt = NavMessageType::Unknown)
          const;
          /** Return a count of messages matching the given NavMessageType.
-          * @note This method has a bit of overhead, though no more
-          *   than find(). */
+          * @note This method takes constant time. */
       virtual size_t count(NavMessageType nmt) const;
          /// Return the number of distinct signals (ignoring PRN) in the data.
       virtual size_t numSignals() const;
@@ -397,6 +484,88 @@ namespace gnsstk
                                NavDataPtr& navData, SVHealth xmitHealth,
                                NavValidityType valid);
 
+         /** Equivalent to findUser() but using the flat index built
+          * by compact() rather than the maps.
+          * @pre compact() has been called.
+          * @copydetails findUser() */
+      bool findUserIndex(const NavMessageID& nmid, const CommonTime& when,
+                         NavDataPtr& navData, SVHealth xmitHealth,
+                         NavValidityType valid);
+
+         /** Equivalent to findNearest() but using the flat index
+          * built by compact() rather than the maps.
+          * @pre compact() has been called.
+          * @copydetails findNearest() */
+      bool findNearestIndex(const NavMessageID& nmid, const CommonTime& when,
+                            NavDataPtr& navData, SVHealth xmitHealth,
+                            NavValidityType valid);
+
+         /** Search a set of matching indices for the most recent
+          * record with a time stamp at or before \a when that meets
+          * the validity and health criteria.  This is the search
+          * algorithm used by findUserIndex().
+          * @param[in,out] matches The indices to search, where the
+          *   top of each is the last record with a time stamp at or
+          *   before \a when.  Elements with a top of -1 are ignored.
+          * @param[in] whenKey \a when, packed into a key.
+          * @param[in] when The time of interest to search for data.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @return The element of matches containing the result, or
+          *   -1 if nothing was found.  The result is the record at
+          *   position i of the element's index. */
+      long selectUser(NavFindCursor::MatchList& matches,
+                      const NavTimeIndex::Key& whenKey,
+                      const CommonTime& when, SVHealth xmitHealth,
+                      NavValidityType valid);
+
+         /** Search the flat index using a cursor, as for the cursor
+          * form of find().
+          * @pre compact() has been called.
+          * @param[in] nmid Specify the message type, satellite and
+          *   codes to match.
+          * @param[in] when The time of interest to search for data.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in,out] cursor The state of the last search, which
+          *   is updated to reflect this one.
+          * @return The stored pointer to the resulting navigation
+          *   message, or nullptr if nothing was found. */
+      const NavDataPtr* findCursor(const NavMessageID& nmid,
+                                   const CommonTime& when,
+                                   SVHealth xmitHealth,
+                                   NavValidityType valid,
+                                   NavFindCursor& cursor);
+
+         /** Find the indices in dataIndex that match a NavMessageID.
+          * @param[in] nmid The message ID to match, wildcards allowed.
+          * @param[in] whenKey The time of interest, used to set the
+          *   top of each of the matches.
+          * @param[out] matches The matching indices, which will only
+          *   contain matches that have data at or before whenKey
+          *   unless \a all is true.
+          * @param[in] all If true, include matching indices that
+          *   have no data at or before whenKey. */
+      void getUserMatches(const NavMessageID& nmid,
+                          const NavTimeIndex::Key& whenKey,
+                          NavFindCursor::MatchList& matches, bool all);
+
+         /// Discard the flat index, if any, built by compact().
+      void discardIndex();
+
+         /** Call load() and, if metrics are enabled, record the time
+          * it took and the number of records it added to the store
+          * as the loading of source.
+          * @param[in] source The data source being loaded.
+          * @param[in] load The function that loads source.
+          * @return The return value of load(). */
+      bool recordLoad(const std::string& source,
+                      const std::function<bool()>& load);
+
          /** Performs an appropriate validity check based on the
           * desired validity.
           * @param[in] ti A container iterator pointing to the nav
@@ -452,6 +621,106 @@ namespace gnsstk
           * @post initialTime and/or finalTime may be updated. */
       bool updateInitialFinal(const CommonTime& begin, const CommonTime& end);
 
+         /** Update initialTime and finalTime for a single record
+          * using its fit interval or time stamp, as appropriate.
+          * Records that are not orbit data are ignored.
+          * @param[in] nd The record being processed.
+          * @return false if the time systems could not be compared. */
+      bool updateInitialFinal(const NavDataPtr& nd);
+
+         /** Update firstLastMap for the subject satellite of nd.
+          * @param[in] nd The record being processed. */
+      void updateFirstLast(const NavDataPtr& nd);
+
+         /** Get the time span used for initialTime/finalTime of a
+          * record.
+          * @param[in] nd The record to get the time span of.
+          * @param[out] begin The start of the fit interval, or the
+          *   time stamp for tabular orbit data.
+          * @param[out] end The end of the fit interval, or the time
+          *   stamp for tabular orbit data.
+          * @return false if nd is not orbit data. */
+      static bool getOrbitBounds(const NavDataPtr& nd, CommonTime& begin,
+                                 CommonTime& end);
+
+         /** Update initialTime, finalTime and firstLastMap after
+          * records have been removed from data.  Only the bounds that
+          * a removed record was on are changed, and the new bounds
+          * are taken from the bounds index (see buildBoundsIndex()).
+          * @pre boundsIndexed is true.
+          * @param[in] removed The records that were removed. */
+      void refreshBounds(const NavDataPtrList& removed);
+
+         /// Build satStamps, orbitBegins and orbitEnds from data.
+      void buildBoundsIndex();
+
+         /** Add a record to, or remove it from, the bounds index.
+          * @param[in] nd The record being added to or removed from data.
+          * @param[in] add If true, nd is being added, otherwise removed. */
+      void indexBounds(const NavDataPtr& nd, bool add);
+
+         /** Remove records from the internal store according to the
+          * retention policy in factControl (see FactoryControl).
+          * @param[in] nd A record that was just added to the
+          *   internal store. */
+      void applyRetention(const NavDataPtr& nd);
+
+         /** Remove a record from nearestData and offsetData, and
+          * optionally from data.  Only the record itself is removed,
+          * not any other record with the same time stamp.
+          * @param[in] nd The record to remove.
+          * @param[in] fromData If false, the caller has already
+          *   removed nd from data. */
+      void removeNavData(const NavDataPtr& nd, bool fromData);
+
+         /** Remove a record from data, if present.  Only the record
+          * itself is removed, not any other record with the same
+          * time stamp.  The time index is not updated.
+          * @param[in] nd The record to remove. */
+      void eraseUserData(const NavDataPtr& nd);
+
+         /** Remove a record from nearestData and offsetData, if
+          * present.  The time index is not updated.
+          * @param[in] nd The record to remove. */
+      void eraseNearestData(const NavDataPtr& nd);
+
+         /** Remove data in the time span [fromTime,toTime) using the
+          * time index, building the index first if necessary.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @param[in] satID If not null, only remove data for
+          *   satellites matching this. */
+      void editTimeIndex(const CommonTime& fromTime, const CommonTime& toTime,
+                         const NavSatelliteID *satID);
+
+         /// Build userBuckets and stampBuckets from the store.
+      void buildTimeIndex();
+
+         /** Discard the time index and the bounds index.  Derived
+          * classes that modify data or nearestData directly, rather
+          * than via addNavData(), edit() or clear(), must call this. */
+      void discardTimeIndex();
+
+         /** Update the record counts used by size(), count() and
+          * friends for records added to or removed from data.
+          * @param[in] sat The key of the records in data.
+          * @param[in] nmt The message type of the records.
+          * @param[in] delta The number of records added to data
+          *   (positive) or removed from data (negative). */
+      void countNavData(const NavSatelliteID& sat, NavMessageType nmt,
+                        long delta);
+
+         /** Rebuild the record counts from the contents of data.
+          * Derived classes that modify data directly, rather than via
+          * addNavData(), edit() or clear(), must call this
+          * afterwards. */
+      void recountNavData();
+
+         /** Add the satellites for which there is data in this store
+          * to sats.
+          * @param[in,out] sats The set to add the satellites to. */
+      virtual void getSatellites(NavSatelliteIDSet& sats) const;
+
          /// Internal storage of navigation data for User searches
       NavMessageMap data;
          /// Internal storage of navigation data for Nearest searches
@@ -459,17 +728,88 @@ namespace gnsstk
          /** Store the time offset data separate from the other nav
           * data because searching is very different. */
       OffsetCvtMap offsetData;
+         /// Flat index of data for User searches, built by compact().
+      NavMessageIndex dataIndex;
+         /// Flat index of nearestData for Nearest searches, built by compact().
+      NavMessageIndex nearestIndex;
+         /// True if dataIndex and nearestIndex reflect the current store.
+      bool compacted;
+         /// Arena for records loaded by addDataSource(), if enabled.
+      NavDataArenaPtr arena;
+         /** Uniquely identifies the current dataIndex among all
+          * factories, for detecting stale NavFindCursor objects. */
+      unsigned long indexGeneration;
          /// Store the earliest applicable orbit time here, by addNavData
       CommonTime initialTime;
          /// Store the latest applicable orbit time here, by addNavData
       CommonTime finalTime;
          /// Map subject satellite ID to time stamp pair (oldest,newest).
       std::map<SatID,std::pair<CommonTime,CommonTime> > firstLastMap;
+         /** Records added while FactoryControl::retainMaxAge is set,
+          * in the order they were added, for expiring by age.  Weak
+          * references, so that records removed from the store by
+          * other means are released rather than kept alive here. */
+      std::deque<std::weak_ptr<NavData> > retainQueue;
+         /** The latest user time of the records in retainQueue, with
+          * the time system set to Any. */
+      CommonTime retainNewest;
+         /** Record counts by message type.  NavMessageType::Unknown
+          * is used as the key for the count over all message types. */
+      typedef std::map<NavMessageType, size_t> NavTypeCounts;
+         /// Number of records in data, by message type.
+      NavTypeCounts typeCounts;
+         /// Number of records in data, by NavSignalID::system.
+      std::map<SatelliteSystem, NavTypeCounts> sysCounts;
+         /// Number of records in data, by key (satellite).
+      std::map<NavSatelliteID, NavTypeCounts> satCounts;
+         /// Number of satCounts keys with each NavSignalID.
+      std::map<NavSignalID, size_t> signalCounts;
+
+         /// Width of each time index bucket, in seconds.
+      static const long timeBucketSeconds = 3600;
+         /** Records organized by timeBucket() of a time, so that
+          * edit() only has to look at the records in the time span
+          * being removed. */
+      typedef std::map<long, std::vector<NavDataPtr> > NavTimeBuckets;
+         /// Return the index into a NavTimeBuckets map for a time.
+      static long timeBucket(const CommonTime& when);
+         /// Add nd to buckets at the given time.
+      static void addToBucket(NavTimeBuckets& buckets, const CommonTime& when,
+                              const NavDataPtr& nd);
+         /// Remove nd from buckets at the given time, if present.
+      static void removeFromBucket(NavTimeBuckets& buckets,
+                                   const CommonTime& when,
+                                   const NavDataPtr& nd);
+         /** The records in data, by user time.  Only maintained
+          * once timeIndexed is set, i.e. after the first edit(). */
+      NavTimeBuckets userBuckets;
+         /// The records in nearestData, by time stamp.
+      NavTimeBuckets stampBuckets;
+         /// True if userBuckets and stampBuckets reflect the store.
+      bool timeIndexed;
+
+         /** Times of the records in data, keyed by the time with the
+          * time system set to Any and mapped to the original time. */
+      typedef std::multimap<CommonTime, CommonTime> BoundTimes;
+         /** The time stamps of the records in data, by subject
+          * satellite, so that the retention policy can keep
+          * firstLastMap up to date without rescanning the store.
+          * Only maintained once boundsIndexed is set, i.e. after the
+          * retention policy first applies. */
+      std::map<SatID, BoundTimes> satStamps;
+         /// The beginning of the bounds (getOrbitBounds()) of the records.
+      BoundTimes orbitBegins;
+         /// The end of the bounds (getOrbitBounds()) of the records.
+      BoundTimes orbitEnds;
+         /// True if satStamps, orbitBegins and orbitEnds reflect data.
+      bool boundsIndexed;
 
          /// Grant access to MultiFormatNavDataFactory for various functions.
       friend class MultiFormatNavDataFactory;
          /// Grant access to NavDataFactoryStoreCallback to data maps.
       friend class NavDataFactoryStoreCallback;
+         /// Grant access to NavSnapshot to data maps.
+      friend class NavSnapshot;
 
    private:
          /** Class used to keep track of which StdNavTimeOffset
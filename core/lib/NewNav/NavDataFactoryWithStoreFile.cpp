@@ -0,0 +1,274 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include "NavDataFactoryWithStoreFile.hpp"
+#include "NavDataFactoryListCallback.hpp"
+
+namespace gnsstk
+{
+      /// The result of reading a file with a single factory.
+   class NavDataLoadAttempt
+   {
+   public:
+      NavDataLoadAttempt(NavDataFactoryWithStoreFile *theFact)
+            : fact(theFact), serial(false), rv(false), elapsed(0)
+      {}
+         /// The factory that read the file.
+      NavDataFactoryWithStoreFile *fact;
+         /** If true, the factory can't read files in parallel and
+          * has to load the file with addDataSource() when merging. */
+      bool serial;
+         /// The data produced by fact->readSource().
+      NavDataFactoryWithStoreFile::SourceDataPtr srcData;
+         /// The return value of fact->readSource().
+      bool rv;
+         /// Any exception thrown by fact->readSource().
+      std::exception_ptr exc;
+         /// The time taken by fact->readSource().
+      NavFactoryMetricsRecorder::Clock::duration elapsed;
+   };
+
+
+      /// The results of reading a file with each factory that was tried.
+   class NavDataSourceLoad
+   {
+   public:
+      NavDataSourceLoad()
+            : next(0)
+      {}
+         /// Each of the factories tried, in order.
+      std::vector<NavDataLoadAttempt> attempts;
+         /** Index of the first factory that has yet to be tried,
+          * which will have to be tried when merging the results. */
+      size_t next;
+   };
+
+
+      /** Read files in a worker thread until there are none left.
+       * Each file is read by each factory in turn until one of them
+       * succeeds.  Factories that can't read files in parallel are
+       * skipped and left for the merge, and the factories after
+       * them are tried anyway in case they turn out to be needed.
+       * @param[in] facts The factories to try, in order.
+       * @param[in] sources The paths of the files to read.
+       * @param[out] loads The results for each of sources.
+       * @param[in,out] nextSource The index of the next file to read,
+       *   shared by all of the workers. */
+   static void readSources(
+      const std::vector<NavDataFactoryWithStoreFile*>& facts,
+      const std::vector<std::string>& sources,
+      std::vector<NavDataSourceLoad>& loads,
+      std::atomic<size_t>& nextSource)
+   {
+      size_t i;
+      while ((i = nextSource++) < sources.size())
+      {
+         NavDataSourceLoad& load(loads[i]);
+         while (load.next < facts.size())
+         {
+            NavDataFactoryWithStoreFile *fact = facts[load.next++];
+            load.attempts.push_back(NavDataLoadAttempt(fact));
+            NavDataLoadAttempt& attempt(load.attempts.back());
+            if (!fact->isProcessConcurrent())
+            {
+                  // Load it with addDataSource() in the merge.
+               attempt.serial = true;
+               continue;
+            }
+            if (fact->isFrozen())
+            {
+                  // addDataSource() would fail.
+               continue;
+            }
+            NavDataArena::Use useArena(fact->getArena());
+            NavFactoryMetricsRecorder::Clock::time_point start =
+               NavFactoryMetricsRecorder::Clock::now();
+            try
+            {
+               attempt.rv = fact->readSource(sources[i], attempt.srcData);
+            }
+            catch (...)
+            {
+               attempt.exc = std::current_exception();
+            }
+            attempt.elapsed = NavFactoryMetricsRecorder::Clock::now() - start;
+            if (attempt.rv || attempt.exc)
+            {
+                  // Any factories after this one are only needed if
+                  // mergeSource() rejects the data.
+               break;
+            }
+         }
+      }
+   }
+
+
+   bool NavDataFactoryWithStoreFile ::
+   readSource(const std::string& source, SourceDataPtr& srcData)
+   {
+      srcData = std::make_shared<SourceData>();
+      NavDataFactoryListCallback cb(srcData->navList);
+      return process(source, cb);
+   }
+
+
+   bool NavDataFactoryWithStoreFile ::
+   mergeSource(SourceData& srcData, bool readOK)
+   {
+      bool rv = readOK;
+      for (const auto& ndp : srcData.navList)
+      {
+            // If the store rejects any data, process() would have
+            // returned false at that point.
+         if (!addNavData(ndp))
+         {
+            rv = false;
+            break;
+         }
+      }
+      srcData.navList.clear();
+      return rv;
+   }
+
+
+   bool NavDataFactoryWithStoreFile ::
+   addDataSources(const std::vector<std::string>& sources,
+                  unsigned numThreads)
+   {
+      if (frozen)
+      {
+         return false;
+      }
+      std::vector<NavDataFactoryWithStoreFile*> facts(1, this);
+      return loadSources(facts, sources, numThreads);
+   }
+
+
+   bool NavDataFactoryWithStoreFile ::
+   loadSources(const std::vector<NavDataFactoryWithStoreFile*>& facts,
+               const std::vector<std::string>& sources,
+               unsigned numThreads)
+   {
+      std::vector<NavDataSourceLoad> loads(sources.size());
+      std::atomic<size_t> nextSource(0);
+      if (numThreads == 0)
+      {
+         numThreads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      numThreads = std::min((size_t)numThreads, sources.size());
+      if (numThreads <= 1)
+      {
+         readSources(facts, sources, loads, nextSource);
+      }
+      else
+      {
+         std::vector<std::thread> workers;
+         for (unsigned t = 0; t < numThreads; t++)
+         {
+            workers.push_back(std::thread(readSources, std::cref(facts),
+                                          std::cref(sources), std::ref(loads),
+                                          std::ref(nextSource)));
+         }
+         for (auto& worker : workers)
+         {
+            worker.join();
+         }
+      }
+         // Add the data to the stores in the same order that
+         // addDataSource() would have.
+      bool rv = true;
+      for (size_t i = 0; i < sources.size(); i++)
+      {
+         bool loaded = false;
+            // The first factory to accept the file gets it, whether
+            // it was read in parallel or not.
+         for (NavDataLoadAttempt& attempt : loads[i].attempts)
+         {
+            NavDataFactoryWithStoreFile *fact = attempt.fact;
+            if (attempt.serial)
+            {
+               if (fact->addDataSource(sources[i]))
+               {
+                  loaded = true;
+                  break;
+               }
+               continue;
+            }
+            size_t before = (fact->metrics.isEnabled() ? fact->size() : 0);
+            bool merged = false;
+            if (attempt.srcData)
+            {
+               NavFactoryMetricsRecorder::Clock::time_point start =
+                  NavFactoryMetricsRecorder::Clock::now();
+               merged = fact->mergeSource(*attempt.srcData, attempt.rv);
+               attempt.elapsed += NavFactoryMetricsRecorder::Clock::now() -
+                  start;
+               attempt.srcData.reset();
+            }
+            if (fact->metrics.isEnabled())
+            {
+               size_t after = fact->size();
+               fact->metrics.addLoad(
+                  sources[i], (after > before ? after - before : 0),
+                  attempt.elapsed, merged && !attempt.exc);
+            }
+            if (attempt.exc)
+            {
+               std::rethrow_exception(attempt.exc);
+            }
+            if (merged)
+            {
+               loaded = true;
+               break;
+            }
+         }
+            // Factories that weren't needed until a merge failed.
+         for (size_t j = loads[i].next; !loaded && (j < facts.size()); j++)
+         {
+            loaded = facts[j]->addDataSource(sources[i]);
+         }
+         rv &= loaded;
+      }
+      return rv;
+   }
+}
@@ -39,6 +39,8 @@
 #ifndef GNSSTK_NAVDATAFACTORYWITHSTOREFILE_HPP
 #define GNSSTK_NAVDATAFACTORYWITHSTOREFILE_HPP
 
+#include <memory>
+#include <vector>
 #include "NavDataFactoryWithStore.hpp"
 #include "NavDataFactoryCallback.hpp"
 
@@ -58,11 +60,91 @@ namespace gnsstk
       virtual ~NavDataFactoryWithStoreFile()
       {
       }
-         /** Load a file into the default map, NavDataFactoryWithStore::data.
+         /** Load a file into the default map,
+          * NavDataFactoryWithStore::data.  If enabled, the records
+          * are allocated from the store's arena (see setUseArena()).
           * @param[in] source The path to the file to load.
-          * @return true on success, false on failure. */
+          * @return true on success, false on failure or if the
+          *   factory is frozen. */
       bool addDataSource(const std::string& source) override
-      { return loadIntoMap(source, data, nearestData, offsetData); }
+      {
+         if (frozen)
+         {
+            return false;
+         }
+         return recordLoad(source, [&]()
+         {
+            NavDataArena::Use useArena(arena);
+            return loadIntoMap(source, data, nearestData, offsetData);
+         });
+      }
+
+         /** Load multiple files into the default map, reading the
+          * files in parallel.  The files are read by a pool of
+          * worker threads, then the data from each file is added to
+          * the store in the order the files are listed, so the
+          * result (including which of any duplicate messages is
+          * kept) is the same as calling addDataSource() for each
+          * file in turn.  Factories whose readSource() method is not
+          * safe to run in parallel (see isProcessConcurrent()) load
+          * the files one at a time.
+          * @param[in] sources The paths of the files to load.
+          * @param[in] numThreads The number of threads to use to
+          *   read files, where 0 means to use one per processor.
+          * @return true if all of the files were loaded
+          *   successfully, false if any of them failed or if the
+          *   factory is frozen.  A failure to load one file does not
+          *   prevent the remaining files from being loaded.
+          * @throw Any exception that would be thrown by
+          *   addDataSource() for one of the files, after the files
+          *   preceding it have been loaded. */
+      virtual bool addDataSources(const std::vector<std::string>& sources,
+                                  unsigned numThreads = 0);
+
+         /** Return true if readSource() only reads the factory's
+          * state, so that it can be called from multiple threads at
+          * once, and readSource() followed by mergeSource() has the
+          * same effect as addDataSource().  This allows
+          * addDataSources() to read files in parallel.  The default
+          * is false, as that is always safe. */
+      virtual bool isProcessConcurrent() const
+      { return false; }
+
+         /** Data read from a file by readSource(), waiting to be
+          * added to the store by mergeSource().  Factories that need
+          * to know more about a file than the data it contains in
+          * order to add it to the store derive from this class. */
+      class SourceData
+      {
+      public:
+         virtual ~SourceData()
+         {}
+            /// The data read from the file, in order.
+         NavDataPtrList navList;
+      };
+         /// Managed pointer to SourceData.
+      typedef std::shared_ptr<SourceData> SourceDataPtr;
+
+         /** Read a file without changing the store.  This is called
+          * by addDataSources() from worker threads when
+          * isProcessConcurrent() is true.  The default collects the
+          * output of process().
+          * @param[in] source The path of the file to read.
+          * @param[out] srcData The data read from the file, which
+          *   is set even when reading fails.
+          * @return The same as process(). */
+      virtual bool readSource(const std::string& source,
+                              SourceDataPtr& srcData);
+
+         /** Add data read by readSource() to the store.  This is
+          * called by addDataSources() for each file, in order.  The
+          * default adds each of srcData.navList with addNavData().
+          * @param[in,out] srcData The data read from a file, which
+          *   may be emptied.
+          * @param[in] readOK The value returned by readSource().
+          * @return true if the file was loaded, as addDataSource()
+          *   would have returned. */
+      virtual bool mergeSource(SourceData& srcData, bool readOK);
 
          /** Abstract method that should be overridden by specific
           * file-reading factory classes in order to load the data
@@ -91,6 +173,27 @@ namespace gnsstk
           * @return true on success, false on failure. */
       virtual bool process(const std::string& filename,
                            NavDataFactoryCallback& cb) = 0;
+
+   protected:
+         /** Load files into the stores of a set of factories as
+          * MultiFormatNavDataFactory::addDataSource() does, that
+          * is, each file is loaded by the first factory in facts
+          * that successfully loads it.  The files are processed in
+          * parallel by factories that support it, and the results
+          * are added to the stores in the same order as if
+          * addDataSource() was called for each factory and file in
+          * turn.
+          * @param[in] facts The factories to load the files with, in
+          *   order of preference.
+          * @param[in] sources The paths of the files to load.
+          * @param[in] numThreads The number of threads to use to
+          *   read files, where 0 means to use one per processor.
+          * @return true if all of the files were loaded by one of
+          *   the factories. */
+      static bool loadSources(
+         const std::vector<NavDataFactoryWithStoreFile*>& facts,
+         const std::vector<std::string>& sources,
+         unsigned numThreads);
    };
 
       //@}
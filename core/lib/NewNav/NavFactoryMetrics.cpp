@@ -0,0 +1,387 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include "NavFactoryMetrics.hpp"
+
+   /** Write str as a JSON string.
+    * @param[in,out] s The stream to write to.
+    * @param[in] str The string to write, with quotes and escapes. */
+static void writeJSONString(std::ostream& s, const std::string& str)
+{
+   s << '"';
+   for (char c : str)
+   {
+      switch (c)
+      {
+         case '"':  s << "\\\""; break;
+         case '\\': s << "\\\\"; break;
+         case '\n': s << "\\n"; break;
+         case '\t': s << "\\t"; break;
+         default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+               s << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                 << static_cast<int>(c) << std::dec << std::setfill(' ');
+            }
+            else
+            {
+               s << c;
+            }
+            break;
+      }
+   }
+   s << '"';
+}
+
+
+   /** Write the counters as the members of a JSON object.
+    * @param[in,out] s The stream to write to.
+    * @param[in] c The counters to write. */
+static void writeJSONCounts(std::ostream& s,
+                            const gnsstk::NavFactoryMetrics::Counts& c)
+{
+   s << "\"finds\":" << c.finds
+     << ",\"hits\":" << c.hits
+     << ",\"misses\":" << c.misses
+     << ",\"wildScans\":" << c.wildScans
+     << ",\"fitRejects\":" << c.fitRejects
+     << ",\"validityRejects\":" << c.validityRejects
+     << ",\"healthRejects\":" << c.healthRejects
+     << ",\"findSeconds\":" << std::setprecision(9) << c.findSeconds
+     << ",\"xvts\":" << c.xvts
+     << ",\"xvtSeconds\":" << c.xvtSeconds;
+}
+
+
+namespace gnsstk
+{
+   NavFactoryMetrics::Counts ::
+   Counts()
+         : finds(0), hits(0), misses(0), wildScans(0), fitRejects(0),
+           validityRejects(0), healthRejects(0), findSeconds(0), xvts(0),
+           xvtSeconds(0)
+   {
+   }
+
+
+   NavFactoryMetrics::Counts& NavFactoryMetrics::Counts ::
+   operator+=(const Counts& right)
+   {
+      finds += right.finds;
+      hits += right.hits;
+      misses += right.misses;
+      wildScans += right.wildScans;
+      fitRejects += right.fitRejects;
+      validityRejects += right.validityRejects;
+      healthRejects += right.healthRejects;
+      findSeconds += right.findSeconds;
+      xvts += right.xvts;
+      xvtSeconds += right.xvtSeconds;
+      return *this;
+   }
+
+
+   NavFactoryMetrics::Counts NavFactoryMetrics ::
+   total() const
+   {
+      Counts rv;
+      for (const auto& bti : byType)
+      {
+         rv += bti.second;
+      }
+      return rv;
+   }
+
+
+   void NavFactoryMetrics ::
+   dump(std::ostream& s) const
+   {
+      std::ios::fmtflags oldFlags = s.flags();
+      s << factory << std::endl
+        << "  " << std::left << std::setw(11) << "Type" << std::right
+        << std::setw(11) << "finds" << std::setw(11) << "hits"
+        << std::setw(11) << "misses" << std::setw(11) << "wild"
+        << std::setw(11) << "rej fit" << std::setw(11) << "rej valid"
+        << std::setw(11) << "rej health" << std::setw(13) << "seconds"
+        << std::setw(11) << "xvts" << std::setw(13) << "xvt seconds"
+        << std::endl;
+      for (const auto& ri : byType)
+      {
+         const Counts& c(ri.second);
+         s << "  " << std::left << std::setw(11)
+           << StringUtils::asString(ri.first) << std::right
+           << std::setw(11) << c.finds << std::setw(11) << c.hits
+           << std::setw(11) << c.misses << std::setw(11) << c.wildScans
+           << std::setw(11) << c.fitRejects
+           << std::setw(11) << c.validityRejects
+           << std::setw(11) << c.healthRejects
+           << std::fixed << std::setprecision(6) << std::setw(13)
+           << c.findSeconds << std::setw(11) << c.xvts << std::setw(13)
+           << c.xvtSeconds << std::endl;
+         s.flags(oldFlags);
+      }
+      for (const auto& si : sources)
+      {
+         s << "  load " << si.source << ": " << si.bytes << " bytes, "
+           << si.records << " records, " << std::fixed
+           << std::setprecision(6) << si.seconds << " s"
+           << (si.success ? "" : " (failed)") << std::endl;
+         s.flags(oldFlags);
+      }
+   }
+
+
+   void NavFactoryMetrics ::
+   dumpJSON(std::ostream& s) const
+   {
+      std::ios::fmtflags oldFlags = s.flags();
+      std::streamsize oldPrec = s.precision();
+      s << "{\"factory\":";
+      writeJSONString(s, factory);
+      s << ",\"total\":{";
+      writeJSONCounts(s, total());
+      s << "},\"byType\":{";
+      bool first = true;
+      for (const auto& bti : byType)
+      {
+         s << (first ? "" : ",");
+         writeJSONString(s, StringUtils::asString(bti.first));
+         s << ":{";
+         writeJSONCounts(s, bti.second);
+         s << "}";
+         first = false;
+      }
+      s << "},\"sources\":[";
+      first = true;
+      for (const auto& si : sources)
+      {
+         s << (first ? "" : ",") << "{\"source\":";
+         writeJSONString(s, si.source);
+         s << ",\"bytes\":" << si.bytes << ",\"records\":" << si.records
+           << ",\"seconds\":" << std::setprecision(9) << si.seconds
+           << ",\"success\":" << (si.success ? "true" : "false") << "}";
+         first = false;
+      }
+      s << "]}";
+      s.flags(oldFlags);
+      s.precision(oldPrec);
+   }
+
+
+   void NavFactoryMetrics ::
+   dumpJSON(std::ostream& s, const std::vector<NavFactoryMetrics>& metrics)
+   {
+      s << "[";
+      for (size_t i = 0; i < metrics.size(); i++)
+      {
+         s << (i == 0 ? "" : ",");
+         metrics[i].dumpJSON(s);
+      }
+      s << "]";
+   }
+
+
+   NavFactoryMetricsRecorder::AtomicCounts ::
+   AtomicCounts()
+   {
+      reset();
+   }
+
+
+   void NavFactoryMetricsRecorder::AtomicCounts ::
+   set(const AtomicCounts& right)
+   {
+      finds.store(right.finds.load());
+      hits.store(right.hits.load());
+      wildScans.store(right.wildScans.load());
+      for (unsigned i = 0; i < 3; i++)
+      {
+         rejects[i].store(right.rejects[i].load());
+      }
+      findTicks.store(right.findTicks.load());
+      xvts.store(right.xvts.load());
+      xvtTicks.store(right.xvtTicks.load());
+   }
+
+
+   void NavFactoryMetricsRecorder::AtomicCounts ::
+   reset()
+   {
+      finds.store(0);
+      hits.store(0);
+      wildScans.store(0);
+      for (unsigned i = 0; i < 3; i++)
+      {
+         rejects[i].store(0);
+      }
+      findTicks.store(0);
+      xvts.store(0);
+      xvtTicks.store(0);
+   }
+
+
+   NavFactoryMetricsRecorder ::
+   NavFactoryMetricsRecorder()
+         : enabled(false)
+   {
+   }
+
+
+   NavFactoryMetricsRecorder ::
+   NavFactoryMetricsRecorder(const NavFactoryMetricsRecorder& right)
+         : enabled(right.isEnabled())
+   {
+      *this = right;
+   }
+
+
+   NavFactoryMetricsRecorder& NavFactoryMetricsRecorder ::
+   operator=(const NavFactoryMetricsRecorder& right)
+   {
+      if (this == &right)
+         return *this;
+      setEnabled(right.isEnabled());
+      for (size_t i = 0; i < numTypes; i++)
+      {
+         byType[i].set(right.byType[i]);
+      }
+      std::lock(sourcesMutex, right.sourcesMutex);
+      std::lock_guard<std::mutex> lock1(sourcesMutex, std::adopt_lock);
+      std::lock_guard<std::mutex> lock2(right.sourcesMutex, std::adopt_lock);
+      sources = right.sources;
+      return *this;
+   }
+
+
+   void NavFactoryMetricsRecorder ::
+   reset()
+   {
+      for (size_t i = 0; i < numTypes; i++)
+      {
+         byType[i].reset();
+      }
+      std::lock_guard<std::mutex> lock(sourcesMutex);
+      sources.clear();
+   }
+
+
+   void NavFactoryMetricsRecorder ::
+   addFind(const NavMessageID& nmid, bool hit, Clock::duration elapsed)
+   {
+      AtomicCounts& c(counters(nmid.messageType));
+      c.finds.fetch_add(1, std::memory_order_relaxed);
+      if (hit)
+         c.hits.fetch_add(1, std::memory_order_relaxed);
+      if (nmid.isWild())
+         c.wildScans.fetch_add(1, std::memory_order_relaxed);
+      c.findTicks.fetch_add(elapsed.count(), std::memory_order_relaxed);
+   }
+
+
+   void NavFactoryMetricsRecorder ::
+   addXvt(NavMessageType nmt, Clock::duration elapsed)
+   {
+      AtomicCounts& c(counters(nmt));
+      c.xvts.fetch_add(1, std::memory_order_relaxed);
+      c.xvtTicks.fetch_add(elapsed.count(), std::memory_order_relaxed);
+   }
+
+
+   void NavFactoryMetricsRecorder ::
+   addLoad(const std::string& source, unsigned long records,
+           Clock::duration elapsed, bool success)
+   {
+      if (!isEnabled())
+         return;
+      NavFactoryMetrics::SourceLoad load;
+      load.source = source;
+      std::ifstream file(source, std::ios::binary | std::ios::ate);
+      if (file)
+      {
+         std::streamoff size = file.tellg();
+         load.bytes = (size > 0 ? size : 0);
+      }
+      load.records = records;
+      load.seconds = std::chrono::duration<double>(elapsed).count();
+      load.success = success;
+      std::lock_guard<std::mutex> lock(sourcesMutex);
+      sources.push_back(load);
+   }
+
+
+   void NavFactoryMetricsRecorder ::
+   get(NavFactoryMetrics& metrics) const
+   {
+      metrics.byType.clear();
+      for (size_t i = 0; i < numTypes; i++)
+      {
+         const AtomicCounts& ac(byType[i]);
+         NavFactoryMetrics::Counts c;
+         c.finds = ac.finds.load(std::memory_order_relaxed);
+         c.hits = ac.hits.load(std::memory_order_relaxed);
+         c.misses = c.finds - std::min(c.hits, c.finds);
+         c.wildScans = ac.wildScans.load(std::memory_order_relaxed);
+         c.fitRejects = ac.rejects[static_cast<int>(Reject::Fit)].load(
+            std::memory_order_relaxed);
+         c.validityRejects =
+            ac.rejects[static_cast<int>(Reject::Validity)].load(
+               std::memory_order_relaxed);
+         c.healthRejects = ac.rejects[static_cast<int>(Reject::Health)].load(
+            std::memory_order_relaxed);
+         c.findSeconds = std::chrono::duration<double>(
+            Clock::duration(ac.findTicks.load(std::memory_order_relaxed)))
+            .count();
+         c.xvts = ac.xvts.load(std::memory_order_relaxed);
+         c.xvtSeconds = std::chrono::duration<double>(
+            Clock::duration(ac.xvtTicks.load(std::memory_order_relaxed)))
+            .count();
+         if ((c.finds != 0) || (c.fitRejects != 0) ||
+             (c.validityRejects != 0) || (c.healthRejects != 0) ||
+             (c.xvts != 0))
+         {
+            metrics.byType[static_cast<NavMessageType>(i)] = c;
+         }
+      }
+      std::lock_guard<std::mutex> lock(sourcesMutex);
+      metrics.sources = sources;
+   }
+
+} // namespace gnsstk
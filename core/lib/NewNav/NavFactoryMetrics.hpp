@@ -0,0 +1,329 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_NAVFACTORYMETRICS_HPP
+#define GNSSTK_NAVFACTORYMETRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "NavMessageID.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Counters describing how a NavDataFactory has been used,
+       * as returned by NavDataFactory::getMetrics() and
+       * NavLibrary::getMetrics().  This is a snapshot of the
+       * NavFactoryMetricsRecorder of a factory, which only counts
+       * anything while enabled (see NavLibrary::setMetricsEnabled()).
+       */
+   class NavFactoryMetrics
+   {
+   public:
+         /** Counters for the find() calls for one NavMessageType, and
+          * for the Xvt computations by NavLibrary using the records
+          * found. */
+      class Counts
+      {
+      public:
+            /// Set all counters to zero.
+         Counts();
+            /// Add the counters in right to this.
+         Counts& operator+=(const Counts& right);
+            /// Number of calls to find().
+         unsigned long finds;
+            /// Number of finds that returned true.
+         unsigned long hits;
+            /// Number of finds that returned false.
+         unsigned long misses;
+            /// Number of finds with wildcards, requiring a linear search.
+         unsigned long wildScans;
+            /// Records skipped because they were outside their fit interval.
+         unsigned long fitRejects;
+            /// Records skipped because of the NavValidityType.
+         unsigned long validityRejects;
+            /// Records skipped because of the transmit health status.
+         unsigned long healthRejects;
+            /// Total time spent in find(), in seconds.
+         double findSeconds;
+            /** Number of Xvt computations by NavLibrary from records
+             * found in this factory. */
+         unsigned long xvts;
+            /** Total time spent computing Xvt, in seconds, not
+             * including the time spent in find(). */
+         double xvtSeconds;
+      };
+
+         /// Statistics for one data source loaded by addDataSource().
+      class SourceLoad
+      {
+      public:
+         SourceLoad()
+               : bytes(0), records(0), seconds(0), success(false)
+         {}
+            /// The source as given to addDataSource().
+         std::string source;
+            /// The size of the source if it is a file, otherwise 0.
+         unsigned long long bytes;
+            /// The number of records added to the store.
+         unsigned long records;
+            /// The time taken to load the source, in seconds.
+         double seconds;
+            /// The return value of addDataSource().
+         bool success;
+      };
+
+         /// Counters by message type.
+      typedef std::map<NavMessageType, Counts> CountsMap;
+
+         /// Return the sum of the counters for all message types.
+      Counts total() const;
+
+         /** Print the metrics in a human-readable table.
+          * @param[in,out] s The stream to write to. */
+      void dump(std::ostream& s) const;
+
+         /** Print the metrics as a JSON object.
+          * @param[in,out] s The stream to write to. */
+      void dumpJSON(std::ostream& s) const;
+
+         /** Print the metrics of several factories as a JSON array.
+          * @param[in,out] s The stream to write to.
+          * @param[in] metrics The metrics to print. */
+      static void dumpJSON(std::ostream& s,
+                           const std::vector<NavFactoryMetrics>& metrics);
+
+         /// The class name of the factory (see getClassName()).
+      std::string factory;
+         /// Counters for each message type that has been searched for.
+      CountsMap byType;
+         /// Each data source loaded, in order.
+      std::vector<SourceLoad> sources;
+   };
+
+
+      /** Collect NavFactoryMetrics for a factory.  All of the
+       * recording methods do nothing unless enabled, and are safe to
+       * call from multiple threads at once, as concurrent searches
+       * of a frozen NavLibrary are allowed. */
+   class NavFactoryMetricsRecorder
+   {
+   public:
+         /** Clock used to time find(), addDataSource() and the
+          * computation of Xvt. */
+      typedef std::chrono::steady_clock Clock;
+
+         /** Time a call to find(), recording it on destruction.  The
+          * result defaults to a miss; set hit before returning. */
+      class FindTimer
+      {
+      public:
+            /** Start timing if rec is enabled.
+             * @param[in] rec The recorder to record the find in.
+             * @param[in] nmid The message being searched for. */
+         FindTimer(NavFactoryMetricsRecorder& rec, const NavMessageID& nmid)
+               : hit(false), recorder(rec.isEnabled() ? &rec : nullptr),
+                 msgID(nmid)
+         {
+            if (recorder != nullptr)
+               start = Clock::now();
+         }
+            /// Record the find.
+         ~FindTimer()
+         {
+            if (recorder != nullptr)
+               recorder->addFind(msgID, hit, Clock::now() - start);
+         }
+            /// Set to the return value of find().
+         bool hit;
+      private:
+            /// Where to record the find, nullptr if disabled.
+         NavFactoryMetricsRecorder *recorder;
+            /// The message being searched for.
+         const NavMessageID& msgID;
+            /// When find() was called.
+         Clock::time_point start;
+      };
+
+         /** Time the computation of an Xvt from a record found in
+          * the factory, recording it on destruction. */
+      class XvtTimer
+      {
+      public:
+            /** Start timing if rec is enabled.
+             * @param[in] rec The recorder to record the computation in.
+             * @param[in] nmt The type of the record (Ephemeris or
+             *   Almanac). */
+         XvtTimer(NavFactoryMetricsRecorder& rec, NavMessageType nmt)
+               : recorder(rec.isEnabled() ? &rec : nullptr), msgType(nmt)
+         {
+            if (recorder != nullptr)
+               start = Clock::now();
+         }
+            /// Record the computation.
+         ~XvtTimer()
+         {
+            if (recorder != nullptr)
+               recorder->addXvt(msgType, Clock::now() - start);
+         }
+      private:
+            /// Where to record the computation, nullptr if disabled.
+         NavFactoryMetricsRecorder *recorder;
+            /// The type of the record the Xvt is computed from.
+         NavMessageType msgType;
+            /// When the computation started.
+         Clock::time_point start;
+      };
+
+         /// Reasons for rejecting a record in find().
+      enum class Reject
+      {
+         Fit,      ///< Outside the fit interval.
+         Validity, ///< Excluded by the NavValidityType.
+         Health    ///< Excluded by the transmit health status.
+      };
+
+         /// Initialize with all counters zero and recording disabled.
+      NavFactoryMetricsRecorder();
+         /// Copy the current counter values and enabled state.
+      NavFactoryMetricsRecorder(const NavFactoryMetricsRecorder& right);
+         /// Copy the current counter values and enabled state.
+      NavFactoryMetricsRecorder& operator=(
+         const NavFactoryMetricsRecorder& right);
+
+         /// Start or stop recording.
+      void setEnabled(bool enable)
+      { enabled.store(enable, std::memory_order_relaxed); }
+         /// Return true if recording.
+      bool isEnabled() const
+      { return enabled.load(std::memory_order_relaxed); }
+
+         /// Set all counters to zero and forget all sources.
+      void reset();
+
+         /** Record a call to find().
+          * @param[in] nmid The message being searched for.
+          * @param[in] hit The return value of find().
+          * @param[in] elapsed The time spent in find(). */
+      void addFind(const NavMessageID& nmid, bool hit,
+                   Clock::duration elapsed);
+
+         /** Record the computation of an Xvt.
+          * @param[in] nmt The type of the record the Xvt was
+          *   computed from.
+          * @param[in] elapsed The time spent computing. */
+      void addXvt(NavMessageType nmt, Clock::duration elapsed);
+
+         /** Record a record being skipped in find().
+          * @param[in] nmt The type of the record.
+          * @param[in] why The reason it was skipped. */
+      void addReject(NavMessageType nmt, Reject why)
+      {
+         if (isEnabled())
+            counters(nmt).rejects[static_cast<int>(why)].fetch_add(
+               1, std::memory_order_relaxed);
+      }
+
+         /** Record the loading of a data source.
+          * @param[in] source The source as given to addDataSource().
+          * @param[in] records The number of records added.
+          * @param[in] elapsed The time taken to load the source.
+          * @param[in] success The return value of addDataSource(). */
+      void addLoad(const std::string& source, unsigned long records,
+                   Clock::duration elapsed, bool success);
+
+         /** Copy the current counters to metrics.
+          * @param[out] metrics The counters, with all but the
+          *   factory field replaced. */
+      void get(NavFactoryMetrics& metrics) const;
+
+   private:
+         /// Counters for one message type.
+      class AtomicCounts
+      {
+      public:
+         AtomicCounts();
+            /// Set the counters to the values in right.
+         void set(const AtomicCounts& right);
+            /// Set the counters to zero.
+         void reset();
+         std::atomic<unsigned long> finds;
+         std::atomic<unsigned long> hits;
+         std::atomic<unsigned long> wildScans;
+            /// Indexed by Reject.
+         std::atomic<unsigned long> rejects[3];
+            /// Total time in find(), in Clock ticks.
+         std::atomic<long long> findTicks;
+         std::atomic<unsigned long> xvts;
+            /// Total time computing Xvt, in Clock ticks.
+         std::atomic<long long> xvtTicks;
+      };
+
+         /// Get the counters for nmt.
+      AtomicCounts& counters(NavMessageType nmt)
+      {
+         size_t idx = static_cast<size_t>(nmt);
+         return byType[idx < numTypes ? idx : 0];
+      }
+
+         /// The number of NavMessageType values.
+      static const size_t numTypes =
+         static_cast<size_t>(NavMessageType::Last);
+
+         /// True if recording.
+      std::atomic<bool> enabled;
+         /// Counters indexed by NavMessageType.
+      AtomicCounts byType[numTypes];
+         /// Guards sources.
+      mutable std::mutex sourcesMutex;
+         /// The sources loaded.
+      std::vector<NavFactoryMetrics::SourceLoad> sources;
+   };
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_NAVFACTORYMETRICS_HPP
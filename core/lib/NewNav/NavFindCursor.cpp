@@ -0,0 +1,108 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "NavFindCursor.hpp"
+
+namespace gnsstk
+{
+      /// Compare every field of two SatID objects, including wildcards.
+   static bool sameSat(const SatID& left, const SatID& right)
+   {
+      return ((left.id == right.id) &&
+              (left.wildId == right.wildId) &&
+              (left.system == right.system) &&
+              (left.wildSys == right.wildSys));
+   }
+
+
+   NavFindCursor ::
+   NavFindCursor()
+         : generation(0),
+           xmitHealth(SVHealth::Any),
+           valid(NavValidityType::Any),
+           matched(-1),
+           reusable(false)
+   {
+   }
+
+
+   void NavFindCursor ::
+   reset()
+   {
+      generation = 0;
+      matches.clear();
+      matched = -1;
+      reusable = false;
+      result.reset();
+      children.clear();
+   }
+
+
+   NavFindCursor& NavFindCursor ::
+   child(size_t i)
+   {
+      if (i >= children.size())
+      {
+         children.resize(i+1);
+      }
+      return children[i];
+   }
+
+
+   bool NavFindCursor ::
+   sameSearch(const NavMessageID& search, SVHealth searchHealth,
+              NavValidityType searchValid) const
+   {
+      const ObsID& so(search.obs);
+      return ((xmitHealth == searchHealth) &&
+              (valid == searchValid) &&
+              (nmid.messageType == search.messageType) &&
+              (nmid.system == search.system) &&
+              (nmid.nav == search.nav) &&
+              sameSat(nmid.sat, search.sat) &&
+              sameSat(nmid.xmitSat, search.xmitSat) &&
+              (nmid.obs.type == so.type) &&
+              (nmid.obs.band == so.band) &&
+              (nmid.obs.code == so.code) &&
+              (nmid.obs.xmitAnt == so.xmitAnt) &&
+              (nmid.obs.freqOffs == so.freqOffs) &&
+              (nmid.obs.freqOffsWild == so.freqOffsWild) &&
+              (nmid.obs.getMcodeBits() == so.getMcodeBits()) &&
+              (nmid.obs.getMcodeMask() == so.getMcodeMask()));
+   }
+}
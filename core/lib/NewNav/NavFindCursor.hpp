@@ -0,0 +1,172 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_NAVFINDCURSOR_HPP
+#define GNSSTK_NAVFINDCURSOR_HPP
+
+#include <vector>
+#include "NavMessageID.hpp"
+#include "NavValidityType.hpp"
+#include "SVHealth.hpp"
+#include "NavTimeIndex.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Search state carried between calls to the cursor form of
+       * NavDataFactory::find(), for processing that steps through
+       * time one epoch after another.
+       *
+       * A cursor remembers which records in the compacted index
+       * (see NavDataFactoryWithStore::compact()) match the requested
+       * NavMessageID, where in those records the last search ended
+       * up, and which record was returned along with its fit
+       * interval.  As long as the search time stays in the fit
+       * interval of that record and no newer record has become
+       * available, the next search returns the same record without
+       * searching at all.  When the search time moves past the next
+       * record, the cursor moves forward by one record rather than
+       * starting over with a binary search.
+       *
+       * The results are always identical to those of find() with
+       * NavSearchOrder::User.  If any of the search parameters
+       * change between calls, or the factory's store is changed
+       * (e.g. by edit(), clear() or loading more data) the cursor
+       * is discarded and the search starts over, so it's always
+       * safe to reuse a cursor.  It is only efficient, however, to
+       * use a cursor for repeated searches of the same parameters,
+       * so use one cursor per satellite when processing multiple
+       * satellites.
+       *
+       * @note A cursor is modified by each search, so a cursor must
+       *   not be shared between threads.
+       * @note Only factories with a compacted store make use of the
+       *   cursor.  Other factories simply perform a User search. */
+   class NavFindCursor
+   {
+   public:
+         /// Create a cursor that is not yet associated with a search.
+      NavFindCursor();
+
+         /** Forget any state from prior searches.  This is never
+          * required for correctness, but it does release the
+          * cursor's reference to the last matched record, including
+          * those of any child cursors. */
+      void reset();
+
+         /** Get the cursor to use for the i-th factory searched by a
+          * factory that passes searches on to other factories
+          * (e.g. MultiFormatNavDataFactory), so that each of those
+          * factories keeps its own search state.
+          * @param[in] i The index of the factory, in the order searched.
+          * @return A reference to the cursor for factory i, which
+          *   remains valid until the next call to child() or reset(). */
+      NavFindCursor& child(size_t i);
+
+   private:
+         /** State of the search of a single NavTimeIndex that matches
+          * the requested NavMessageID.  This is also used for the
+          * non-cursor searches in
+          * NavDataFactoryWithStore::findUserIndex(). */
+      class Match
+      {
+      public:
+         Match(const NavTimeIndex *theIdx, long theTop)
+               : idx(theIdx), top(theTop), i(theTop), finished(false)
+         {}
+            /// The index being searched.
+         const NavTimeIndex *idx;
+            /// The last record with a time stamp <= the search time.
+         long top;
+            /// The record currently being examined, -1 if none.
+         long i;
+            /// True if there's no point in examining more records.
+         bool finished;
+      };
+         /// Collection of the matching indices for a search.
+      typedef std::vector<Match> MatchList;
+
+         /** Return true if the parameters of a search are exactly the
+          * same as the last one.  Unlike NavMessageID::operator==(),
+          * wildcards are only equal to identical wildcards.
+          * @param[in] nmid The message ID being searched for.
+          * @param[in] xmitHealth The desired transmit health status.
+          * @param[in] valid The desired message validity. */
+      bool sameSearch(const NavMessageID& nmid, SVHealth xmitHealth,
+                      NavValidityType valid) const;
+
+         /** Identifies the compacted index the state refers to, 0
+          * if the cursor is not associated with any search. */
+      unsigned long generation;
+         /// The message ID of the last search.
+      NavMessageID nmid;
+         /// The desired transmit health status of the last search.
+      SVHealth xmitHealth;
+         /// The desired validity of the last search.
+      NavValidityType valid;
+         /// All of the indices that match nmid.
+      MatchList matches;
+         /// The element of matches that contains the last result, or -1.
+      long matched;
+         /** True if the last result can be returned again as long as
+          * the search time is in its fit interval and none of the
+          * matches have moved to a different top record. */
+      bool reusable;
+         /** The result of the last NavDataFactory::findRecord()
+          * search of a factory that doesn't store its results. */
+      NavDataPtr result;
+         /// The start of the fit interval of result.
+      NavTimeIndex::Key beginFit;
+         /// The end of the fit interval of result.
+      NavTimeIndex::Key endFit;
+         /// Cursors for the factories searched by this one, see child().
+      std::vector<NavFindCursor> children;
+
+         /// The store is the only thing that manages the search state.
+      friend class NavDataFactoryWithStore;
+         /// Holds the results of findRecord() in the cursor.
+      friend class NavDataFactory;
+   };
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_NAVFINDCURSOR_HPP
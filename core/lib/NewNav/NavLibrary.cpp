@@ -69,10 +69,12 @@ namespace gnsstk
       NavMessageID nmid(sat, useAlm ? NavMessageType::Almanac :
                         NavMessageType::Ephemeris);
       NavDataPtr ndp;
-      if (!find(nmid, when, ndp, xmitHealth, valid, order))
+      NavDataFactory *src = findSource(nmid, when, ndp, xmitHealth, valid,
+                                       order);
+      if (src == nullptr)
          return false;
       OrbitData *orb = dynamic_cast<OrbitData*>(ndp.get());
-      return orb->getXvt(when, xvt, oid);
+      return computeXvt(src, orb, when, xvt, oid);
    }
 
 
@@ -95,16 +97,79 @@ namespace gnsstk
       DEBUGTRACE_FUNCTION();
       NavMessageID nmid(sat, NavMessageType::Ephemeris);
       NavDataPtr ndp;
-      if (!find(nmid, when, ndp, xmitHealth, valid, order))
+      NavDataFactory *src = findSource(nmid, when, ndp, xmitHealth, valid,
+                                       order);
+      if (src == nullptr)
       {
          NavMessageID nmida(sat, NavMessageType::Almanac);
-         if (!find(nmida, when, ndp, xmitHealth, valid, order))
+         src = findSource(nmida, when, ndp, xmitHealth, valid, order);
+         if (src == nullptr)
          {
             return false;
          }
       }
       OrbitData *orb = dynamic_cast<OrbitData*>(ndp.get());
-      return orb->getXvt(when, xvt, oid);
+      return computeXvt(src, orb, when, xvt, oid);
+   }
+
+
+   size_t NavLibrary ::
+   getXvt(const std::vector<NavSatelliteID>& sats, const CommonTime& when,
+          XvtBatch& xvts, bool useAlm, SVHealth xmitHealth,
+          NavValidityType valid, NavSearchOrder order)
+   {
+      DEBUGTRACE_FUNCTION();
+      NavMessageType nmt = (useAlm ? NavMessageType::Almanac :
+                            NavMessageType::Ephemeris);
+      ObsID oid;
+      Xvt xvt;
+      SearchFactoryCache cache;
+      size_t rv = 0;
+      xvts.resize(sats.size());
+      xvts.cursors.resize(sats.size());
+      for (size_t i = 0; i < sats.size(); i++)
+      {
+         NavMessageID nmid(sats[i], nmt);
+         if (findXvt(getSearchFactories(nmid, cache), xvts.cursors[i], nmid,
+                     when, xvt, oid, xmitHealth, valid, order))
+         {
+            xvts.setXvt(i, xvt);
+            rv++;
+         }
+      }
+      return rv;
+   }
+
+
+   size_t NavLibrary ::
+   getXvt(const NavSatelliteID& sat, const std::vector<CommonTime>& times,
+          XvtBatch& xvts, bool useAlm, SVHealth xmitHealth,
+          NavValidityType valid, NavSearchOrder order)
+   {
+      DEBUGTRACE_FUNCTION();
+      NavMessageID nmid(sat, useAlm ? NavMessageType::Almanac :
+                        NavMessageType::Ephemeris);
+      ObsID oid;
+      Xvt xvt;
+      SearchFactoryCache cache;
+      const std::vector<NavDataFactory*>& searchFacts(
+         getSearchFactories(nmid, cache));
+      size_t rv = 0;
+      xvts.resize(times.size());
+         // All of the searches are for the same satellite, so they
+         // share one set of cursors.
+      xvts.cursors.resize(1);
+      std::vector<NavFindCursor>& cursors(xvts.cursors[0]);
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         if (findXvt(searchFacts, cursors, nmid, times[i], xvt, oid,
+                     xmitHealth, valid, order))
+         {
+            xvts.setXvt(i, xvt);
+            rv++;
+         }
+      }
+      return rv;
    }
 
 
@@ -391,6 +456,16 @@ namespace gnsstk
         SVHealth xmitHealth, NavValidityType valid, NavSearchOrder order)
    {
       DEBUGTRACE_FUNCTION();
+      return (findSource(nmid, when, navOut, xmitHealth, valid, order) !=
+              nullptr);
+   }
+
+
+   NavDataFactory* NavLibrary ::
+   findSource(const NavMessageID& nmid, const CommonTime& when,
+              NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+              NavSearchOrder order)
+   {
          // Don't use factories.equal_range(nmid), as it can result in
          // range.first and range.second being the same iterator, in
          // which case the loop won't process anything at all.
@@ -406,9 +481,11 @@ namespace gnsstk
          {
             try
             {
-               if (fi.second->find(nmid, when, navOut, xmitHealth, valid, order))
+               NavDataFactory *src = fi.second->findSource(
+                  nmid, when, navOut, xmitHealth, valid, order);
+               if (src != nullptr)
                {
-                  return true;
+                  return src;
                }
             }
             catch (gnsstk::Exception& exc)
@@ -418,7 +495,7 @@ namespace gnsstk
             uniques.insert(fi.second.get());
          }
       }
-      return false;
+      return nullptr;
    }
 
 
@@ -426,6 +503,7 @@ namespace gnsstk
    setValidityFilter(NavValidityType nvt)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& i : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          i.second->setValidityFilter(nvt);
@@ -437,6 +515,7 @@ namespace gnsstk
    setTypeFilter(const NavMessageTypeSet& nmts)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& i : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          i.second->setTypeFilter(nmts);
@@ -448,6 +527,7 @@ namespace gnsstk
    clearTypeFilter()
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& i : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          i.second->clearTypeFilter();
@@ -459,6 +539,7 @@ namespace gnsstk
    addTypeFilter(NavMessageType nmt)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& i : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          i.second->addTypeFilter(nmt);
@@ -470,6 +551,7 @@ namespace gnsstk
    addFactory(NavDataFactoryPtr& fact)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
          // Yes, we do add multiple copies of the NavDataFactoryPtr to
          // the map, it's a convenience.
       for (const auto& si : fact->supportedSignals)
@@ -495,6 +577,7 @@ namespace gnsstk
    edit(const CommonTime& fromTime, const CommonTime& toTime)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          fi.second->edit(fromTime, toTime);
@@ -507,6 +590,7 @@ namespace gnsstk
         const NavSatelliteID& satID)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          fi.second->edit(fromTime, toTime, satID);
@@ -519,6 +603,7 @@ namespace gnsstk
         const NavSignalID& signal)
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          fi.second->edit(fromTime, toTime, signal);
@@ -530,6 +615,7 @@ namespace gnsstk
    clear()
    {
       DEBUGTRACE_FUNCTION();
+      assertThawed();
       for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
       {
          fi.second->clear();
@@ -537,6 +623,189 @@ namespace gnsstk
    }
 
 
+   void NavLibrary ::
+   compact()
+   {
+      DEBUGTRACE_FUNCTION();
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->compact();
+      }
+   }
+
+
+   void NavLibrary ::
+   setMetricsEnabled(bool enable)
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->setMetricsEnabled(enable);
+      }
+   }
+
+
+   std::vector<NavFactoryMetrics> NavLibrary ::
+   getMetrics() const
+   {
+      std::vector<NavFactoryMetrics> rv;
+      for (const auto& fi : NDFUniqConstIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->getMetrics(rv);
+      }
+      return rv;
+   }
+
+
+   void NavLibrary ::
+   resetMetrics()
+   {
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->resetMetrics();
+      }
+   }
+
+
+   void NavLibrary ::
+   dumpMetrics(std::ostream& s, bool json) const
+   {
+      std::vector<NavFactoryMetrics> metrics(getMetrics());
+      if (json)
+      {
+         NavFactoryMetrics::dumpJSON(s, metrics);
+      }
+      else
+      {
+         for (const auto& m : metrics)
+         {
+            m.dump(s);
+         }
+      }
+   }
+
+
+   void NavLibrary ::
+   freeze()
+   {
+      DEBUGTRACE_FUNCTION();
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->freeze();
+      }
+      frozen = true;
+   }
+
+
+   void NavLibrary ::
+   thaw()
+   {
+      DEBUGTRACE_FUNCTION();
+      for (auto& fi : NDFUniqIterator<NavDataFactoryMap>(factories))
+      {
+         fi.second->thaw();
+      }
+      frozen = false;
+   }
+
+
+   const std::vector<NavDataFactory*>& NavLibrary ::
+   getSearchFactories(const NavSignalID& signal, SearchFactoryCache& cache)
+   {
+         // The equality operator treats wildcards as matching
+         // anything, so compare the fields exactly, as the list of
+         // factories only depends on their values.
+      for (const auto& ci : cache)
+      {
+         const ObsID& co(ci.first.obs);
+         if ((ci.first.system == signal.system) &&
+             (ci.first.nav == signal.nav) &&
+             (co.type == signal.obs.type) &&
+             (co.band == signal.obs.band) &&
+             (co.code == signal.obs.code) &&
+             (co.xmitAnt == signal.obs.xmitAnt) &&
+             (co.freqOffs == signal.obs.freqOffs) &&
+             (co.freqOffsWild == signal.obs.freqOffsWild) &&
+             (co.getMcodeBits() == signal.obs.getMcodeBits()) &&
+             (co.getMcodeMask() == signal.obs.getMcodeMask()))
+         {
+            return ci.second;
+         }
+      }
+         // Same logic as find().
+      std::vector<NavDataFactory*> facts;
+      std::set<NavDataFactory*> uniques;
+      for (auto& fi : factories)
+      {
+         if ((fi.first == signal) && (uniques.count(fi.second.get()) == 0))
+         {
+            fi.second->getSearchFactories(signal, facts);
+            uniques.insert(fi.second.get());
+         }
+      }
+      cache.push_back(SearchFactoryCache::value_type(signal, facts));
+      return cache.back().second;
+   }
+
+
+   bool NavLibrary ::
+   findXvt(const std::vector<NavDataFactory*>& facts,
+           std::vector<NavFindCursor>& cursors,
+           const NavMessageID& nmid, const CommonTime& when, Xvt& xvt,
+           const ObsID& oid, SVHealth xmitHealth, NavValidityType valid,
+           NavSearchOrder order) const
+   {
+      NavDataPtr ndp;
+      bool useCursors = (order == NavSearchOrder::User);
+      if (useCursors)
+      {
+         cursors.resize(facts.size());
+      }
+      for (size_t fi = 0; fi < facts.size(); fi++)
+      {
+         if (useCursors
+             ? facts[fi]->find(nmid, when, ndp, xmitHealth, valid,
+                               cursors[fi])
+             : facts[fi]->find(nmid, when, ndp, xmitHealth, valid, order))
+         {
+               // Reset xvt to the default state without reallocating
+               // the Triples, in case getXvt doesn't set everything.
+            xvt.x[0] = xvt.x[1] = xvt.x[2] = 0.0;
+            xvt.v[0] = xvt.v[1] = xvt.v[2] = 0.0;
+            xvt.clkbias = xvt.clkdrift = xvt.relcorr = 0.0;
+            xvt.frame = RefFrame();
+            xvt.health = Xvt::Uninitialized;
+               // Only OrbitData is stored as Ephemeris or Almanac.
+            OrbitData *orb = static_cast<OrbitData*>(ndp.get());
+            return computeXvt(facts[fi], orb, when, xvt, oid);
+         }
+      }
+      return false;
+   }
+
+
+   bool NavLibrary ::
+   computeXvt(NavDataFactory *src, OrbitData *orb, const CommonTime& when,
+              Xvt& xvt, const ObsID& oid) const
+   {
+      NavFactoryMetricsRecorder::XvtTimer timer(src->getMetricsRecorder(),
+                                                orb->signal.messageType);
+      if (xvtFit)
+         return orb->getXvtFitted(when, xvt, oid);
+      return orb->getXvt(when, xvt, oid);
+   }
+
+
+   void NavLibrary ::
+   assertThawed() const
+   {
+      if (frozen)
+      {
+         InvalidRequest exc("Can't modify a frozen NavLibrary");
+         GNSSTK_THROW(exc);
+      }
+   }
+
+
    CommonTime NavLibrary ::
    getInitialTime() const
    {
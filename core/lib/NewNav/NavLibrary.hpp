@@ -40,7 +40,9 @@
 #define GNSSTK_NAVLIBRARY_HPP
 
 #include "NavDataFactory.hpp"
+#include "OrbitData.hpp"
 #include "Xvt.hpp"
+#include "XvtBatch.hpp"
 #include "SVHealth.hpp"
 #include "Position.hpp"
 
@@ -903,6 +905,46 @@ namespace gnsstk
        * PNBMultiGNSSNavDataFactory you also implement a test in your
        * code to make sure it actually is adding the factory properly.
        *
+       * @section NavFactoryThreads Concurrent Access
+       *
+       * NavLibrary and the factories are not generally thread-safe.
+       * Loading data, editing, clearing and changing filters all
+       * modify the internal store and must not happen while another
+       * thread is using the same objects.  However, once all data
+       * has been loaded, the library may be frozen, after which any
+       * number of threads may call the search methods (getXvt,
+       * getHealth, getOffset, find, etc.) on the same NavLibrary
+       * object concurrently, without locking:
+       *
+       * \code
+       * NavLibrary navLib;
+       * NavDataFactoryPtr ndfp(std::make_shared<MultiFormatNavDataFactory>());
+       * navLib.addFactory(ndfp);
+       * ndfp->addDataSource(filename);
+       * navLib.freeze();
+       * // start worker threads that call navLib.getXvt() etc.
+       * // join the worker threads
+       * navLib.thaw();
+       * ndfp->addDataSource(anotherFilename);
+       * \endcode
+       *
+       * Freezing builds the flat search index (see
+       * NavLibrary::compact()) and switches the library and the
+       * factories to a read-only state.  While frozen, attempting to
+       * modify the store either throws InvalidRequest
+       * (e.g. NavLibrary::edit(), NavLibrary::clear(),
+       * NavLibrary::addFactory()) or fails (addDataSource() returns
+       * false).  freeze() and thaw() themselves must be called while
+       * no other threads are using the library, typically before
+       * starting and after joining the worker threads.
+       *
+       * Concurrent searches are only supported by the factories that
+       * store their data in memory (the NavDataFactoryWithStore
+       * classes, including MultiFormatNavDataFactory).  Configuration
+       * setters that are not part of NavLibrary's interface
+       * (e.g. SP3NavDataFactory::setClockInterpOrder()) must also not
+       * be used while other threads are searching.
+       *
        * @section KnownIssues Known Issues
        *
        * @subsection BeiDouKnownIssues BeiDou Known Issues
@@ -944,6 +986,11 @@ namespace gnsstk
    class NavLibrary
    {
    public:
+         /// Initialize an empty, unfrozen library.
+      NavLibrary()
+            : frozen(false), xvtFit(false)
+      {}
+
          /** Get the position and velocity of a satellite at a
           * specific time, searching either almanac or ephemeris, as
           * dictated by \a useAlm.
@@ -1043,6 +1090,74 @@ namespace gnsstk
                   NavValidityType valid = NavValidityType::ValidOnly,
                   NavSearchOrder order = NavSearchOrder::User);
 
+         /** Get the positions and velocities of a set of satellites
+          * at a specific time, searching either almanac or
+          * ephemeris, as dictated by \a useAlm.  The results are
+          * identical to calling the single-satellite getXvt() for
+          * each element of \a sats, but the work of locating the
+          * factories for each signal and of constructing the Xvt is
+          * shared across elements.  For NavSearchOrder::User, the
+          * search for each satellite continues from the state left
+          * in \a xvts by the previous call (see NavFindCursor), so
+          * when stepping through time it is most efficient to reuse
+          * the same \a xvts with the same \a sats for each epoch.
+          * @param[in] sats Satellites to get the position/velocity for.
+          * @param[in] when The time that the positions should be
+          *   computed for.
+          * @param[out] xvts The computed positions and velocities,
+          *   resized to the size of \a sats.  xvts.status[i] is
+          *   nonzero if the Xvt for sats[i] was successfully
+          *   computed.
+          * @param[in] useAlm If true, search for and use almanac
+          *   orbital elements.  If false, search for and use
+          *   ephemeris data instead.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in] order Specify whether to search by receiver
+          *   behavior or by nearest to when in time.
+          * @return the number of satellites for which the Xvt was
+          *   successfully computed. */
+      size_t getXvt(const std::vector<NavSatelliteID>& sats,
+                    const CommonTime& when, XvtBatch& xvts, bool useAlm,
+                    SVHealth xmitHealth = SVHealth::Any,
+                    NavValidityType valid = NavValidityType::ValidOnly,
+                    NavSearchOrder order = NavSearchOrder::User);
+
+         /** Get the position and velocity of a single satellite at a
+          * series of times, searching either almanac or ephemeris,
+          * as dictated by \a useAlm.  The results are identical to
+          * calling the single-satellite getXvt() for each element of
+          * \a times, but the work of locating the factories and of
+          * constructing the Xvt is shared across elements.  For
+          * NavSearchOrder::User, each search continues from where the
+          * search of the previous time ended up (see NavFindCursor),
+          * so \a times is best given in increasing order.
+          * @param[in] sat Satellite to get the position/velocity for.
+          * @param[in] times The times that the position should be
+          *   computed for.
+          * @param[out] xvts The computed positions and velocities,
+          *   resized to the size of \a times.  xvts.status[i] is
+          *   nonzero if the Xvt at times[i] was successfully
+          *   computed.
+          * @param[in] useAlm If true, search for and use almanac
+          *   orbital elements.  If false, search for and use
+          *   ephemeris data instead.
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in] order Specify whether to search by receiver
+          *   behavior or by nearest to when in time.
+          * @return the number of times for which the Xvt was
+          *   successfully computed. */
+      size_t getXvt(const NavSatelliteID& sat,
+                    const std::vector<CommonTime>& times, XvtBatch& xvts,
+                    bool useAlm, SVHealth xmitHealth = SVHealth::Any,
+                    NavValidityType valid = NavValidityType::ValidOnly,
+                    NavSearchOrder order = NavSearchOrder::User);
+
          /** Get the health status of a satellite at a specific time.
           * @param[in] sat Satellite to get the health status for.
           * @param[in] when The time that the health should be retrieved.
@@ -1234,7 +1349,8 @@ namespace gnsstk
          /** Set the factories' handling of valid and invalid
           * navigation data.  This should be called before any find()
           * calls.
-          * @param[in] nvt The new nav data loading filter method. */
+          * @param[in] nvt The new nav data loading filter method.
+          * @throw InvalidRequest if the library is frozen. */
       void setValidityFilter(NavValidityType nvt);
 
          /** Indicate what nav message types the factories should be
@@ -1248,24 +1364,28 @@ namespace gnsstk
           *   than "Any" (exceptions: if you're ONLY looking up orbit
           *   data that has self-contained health status).
           * @param[in] nmts The set of nav message types to be
-          *   processed by the factories. */
+          *   processed by the factories.
+          * @throw InvalidRequest if the library is frozen. */
       void setTypeFilter(const NavMessageTypeSet& nmts);
 
          /** Clear the type filters of each of the factories.  This
           * should be used prior to loading data, and prior to using
           * addTypeFilter(), if that API is going to be used instead
-          * of setTypeFilter(). */
+          * of setTypeFilter().
+          * @throw InvalidRequest if the library is frozen. */
       void clearTypeFilter();
 
          /** Add a NavMessageType to be processed to each of the
           * factories.  This should be used prior to loading data and
           * as an alternate approach to setTypeFilter().
           * @param[in] nmt The NavMessageType to be processed on the
-          *   next load. */
+          *   next load.
+          * @throw InvalidRequest if the library is frozen. */
       void addTypeFilter(NavMessageType nmt);
 
          /** Add a new factory to the library.
           * @param[in] fact The NavDataFactory object to add to the library.
+          * @throw InvalidRequest if the library is frozen.
           */
       void addFactory(NavDataFactoryPtr& fact);
 
@@ -1279,6 +1399,7 @@ namespace gnsstk
           * span [fromTime,toTime).
           * @param[in] fromTime The earliest time to be removed.
           * @param[in] toTime The earliest time that will NOT be removed.
+          * @throw InvalidRequest if the library is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime);
 
@@ -1289,6 +1410,7 @@ namespace gnsstk
           * @param[in] satID The complete signal specification for the
           *   data to be removed (subject satellite, transmit
           *   satellite, system, carrier, code, nav).
+          * @throw InvalidRequest if the library is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime,
                 const NavSatelliteID& satID);
@@ -1300,13 +1422,84 @@ namespace gnsstk
           * @param[in] toTime The earliest time that will NOT be removed.
           * @param[in] signal The signal for the data to be removed
           *   (system, carrier, code, nav).
+          * @throw InvalidRequest if the library is frozen.
           */
       void edit(const CommonTime& fromTime, const CommonTime& toTime,
                 const NavSignalID& signal);
 
-         /// Remove all data from the library's factories.
+         /** Remove all data from the library's factories.
+          * @throw InvalidRequest if the library is frozen. */
       void clear();
 
+         /** Prepare the library's factories for searching, e.g. by
+          * building flat search indices (see
+          * NavDataFactoryWithStore::compact()).  Call this after all
+          * data sources have been loaded.  Loading additional data or
+          * editing afterwards is allowed but undoes the effect until
+          * compact() is called again. */
+      void compact();
+
+         /** Enable or disable collection of search and load metrics
+          * (see NavFactoryMetrics) in all of the library's
+          * factories.  Metrics are disabled by default.  Enable
+          * them prior to loading data to get load statistics.
+          * @param[in] enable If true, collect metrics. */
+      void setMetricsEnabled(bool enable);
+
+         /** Get a snapshot of the metrics of each of the library's
+          * factories.  Factories that contain other factories
+          * (e.g. MultiFormatNavDataFactory) report each contained
+          * factory separately.
+          * @return One NavFactoryMetrics object per factory. */
+      std::vector<NavFactoryMetrics> getMetrics() const;
+
+         /// Zero the metrics of all of the library's factories.
+      void resetMetrics();
+
+         /** Print the metrics of all of the library's factories.
+          * @param[in,out] s The stream to write the metrics to.
+          * @param[in] json If true, write the metrics as a JSON
+          *   array, otherwise in a human-readable format. */
+      void dumpMetrics(std::ostream& s, bool json = false) const;
+
+         /** Put the library and all of its factories into a
+          * read-only state (see NavDataFactory::freeze()) in which
+          * the search methods (getXvt, getHealth, getOffset, find,
+          * etc.) may be called concurrently from multiple threads.
+          * While frozen, the methods that modify the library or its
+          * factories throw InvalidRequest, and addDataSource() on
+          * the factories returns false.  See \ref NavFactoryThreads.
+          * @note This method is not itself thread-safe and must be
+          *   called before starting the threads that use the
+          *   library. */
+      void freeze();
+
+         /** Return the library and its factories to the modifiable
+          * state.  As with freeze(), this must not be called while
+          * other threads are using the library. */
+      void thaw();
+
+         /// Return true if the library is in the read-only state.
+      bool isFrozen() const
+      { return frozen; }
+
+         /** Enable or disable computing Xvt from polynomial fits of
+          * the orbit data (see OrbitData::getXvtFitted() and
+          * XvtFit) in the getXvt() methods.  This is disabled by
+          * default.  When enabled, the first getXvt() for a given
+          * ephemeris or almanac is more expensive, and subsequent
+          * calls for the same data are much cheaper, which pays off
+          * when the same satellites are evaluated at many times.
+          * Results differ from the analytic model by no more than
+          * XvtFit's default tolerances.
+          * @param[in] enable true to use fitted Xvt. */
+      void setXvtFit(bool enable)
+      { xvtFit = enable; }
+
+         /// Return true if getXvt() uses fitted Xvt (see setXvtFit()).
+      bool getXvtFit() const
+      { return xvtFit; }
+
          /** Determine the earliest time for which this object can successfully
           * determine the Xvt for any object.
           * @return The initial time, or CommonTime::END_OF_TIME if no
@@ -1443,6 +1636,73 @@ namespace gnsstk
          /** Known nav data factories, organized by signal to make
           * searches simpler and/or quicker. */
       NavDataFactoryMap factories;
+         /// If true, modifying the library is not allowed (see freeze()).
+      bool frozen;
+         /// If true, getXvt() uses fitted Xvt (see setXvtFit()).
+      bool xvtFit;
+
+   private:
+         /// Factories to search for a list of signals, see getXvt().
+      typedef std::vector<std::pair<NavSignalID,
+                                    std::vector<NavDataFactory*> > >
+      SearchFactoryCache;
+
+         /// Throw an InvalidRequest exception if frozen is true.
+      void assertThawed() const;
+
+         /** Get the factories that find() would search for signal,
+          * in the same order.
+          * @param[in] signal The signal to find factories for.
+          * @param[in,out] cache Previously found lists of factories.
+          *   The list for signal is added to cache if it's not
+          *   already there.
+          * @return A reference to the list of factories for signal
+          *   in cache, which remains valid until cache is next
+          *   modified. */
+      const std::vector<NavDataFactory*>& getSearchFactories(
+         const NavSignalID& signal, SearchFactoryCache& cache);
+
+         /** Search the given factories for orbit data and compute the
+          * Xvt, as is done by the single-satellite getXvt().
+          * @param[in] facts The factories to search, in order.
+          * @param[in,out] cursors The search state for each element
+          *   of facts, used when order is NavSearchOrder::User and
+          *   resized to match facts as needed.
+          * @param[in] nmid The message to search for.
+          * @param[in] when The time that the position should be
+          *   computed for.
+          * @param[out] xvt The computed position and velocity at when.
+          * @param[in] oid The ObsID passed to OrbitData::getXvt().
+          * @param[in] xmitHealth The desired health status of the
+          *   transmitting satellite.
+          * @param[in] valid Specify whether to search only for valid
+          *   or invalid messages, or both.
+          * @param[in] order Specify whether to search by receiver
+          *   behavior or by nearest to when in time.
+          * @return true if successful. */
+      bool findXvt(const std::vector<NavDataFactory*>& facts,
+                   std::vector<NavFindCursor>& cursors,
+                   const NavMessageID& nmid, const CommonTime& when,
+                   Xvt& xvt, const ObsID& oid, SVHealth xmitHealth,
+                   NavValidityType valid, NavSearchOrder order) const;
+
+         /** Search the factories in the same manner as find(),
+          * returning the factory that navOut came from, or nullptr
+          * if no match was found. */
+      NavDataFactory* findSource(const NavMessageID& nmid,
+                                 const CommonTime& when, NavDataPtr& navOut,
+                                 SVHealth xmitHealth, NavValidityType valid,
+                                 NavSearchOrder order);
+
+         /** Compute the Xvt from orbit data using either
+          * OrbitData::getXvt() or OrbitData::getXvtFitted()
+          * according to xvtFit.  The time spent is recorded in the
+          * NavFactoryMetrics of src, separately from the time spent
+          * finding orb.
+          * @param[in] src The factory that orb came from. */
+      bool computeXvt(NavDataFactory *src, OrbitData *orb,
+                      const CommonTime& when, Xvt& xvt,
+                      const ObsID& oid) const;
    };
 
       //@}
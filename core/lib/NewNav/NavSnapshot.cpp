@@ -0,0 +1,1167 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <typeindex>
+#include <type_traits>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "NavSnapshot.hpp"
+#include "NavDataFactoryWithStore.hpp"
+#include "GPSLNavEph.hpp"
+#include "GPSLNavAlm.hpp"
+#include "GPSLNavHealth.hpp"
+#include "GPSLNavISC.hpp"
+#include "GPSLNavIono.hpp"
+#include "GPSNavConfig.hpp"
+#include "GalINavEph.hpp"
+#include "GalFNavEph.hpp"
+#include "GalINavHealth.hpp"
+#include "GalFNavHealth.hpp"
+#include "GalINavISC.hpp"
+#include "GalINavIono.hpp"
+#include "BDSD1NavEph.hpp"
+#include "BDSD1NavHealth.hpp"
+#include "BDSD1NavIono.hpp"
+#include "BDSD1NavISC.hpp"
+#include "BDSD2NavEph.hpp"
+#include "BDSD2NavHealth.hpp"
+#include "BDSD2NavISC.hpp"
+#include "GLOFNavEph.hpp"
+#include "GLOFNavHealth.hpp"
+#include "RinexTimeOffset.hpp"
+#include "OrbitDataSP3.hpp"
+
+namespace gnsstk
+{
+   const char NavSnapshot::magic[8] = {'G','N','S','S','T','K','N','S'};
+   const uint32_t NavSnapshot::formatVersion = 1;
+
+      /// Value written to the file header to identify the byte order.
+   static const uint32_t navSnapshotByteOrder = 0x01020304;
+      /// Alignment of sections and records in bytes.
+   static const size_t navSnapshotAlign = 8;
+
+      /** Type codes for the supported record types.  These are
+       * stored in snapshot files, so existing values must never be
+       * changed. */
+   enum class NavSnapshotType : uint32_t
+   {
+      GPSLNavEph = 1,
+      GPSLNavAlm = 2,
+      GPSLNavHealth = 3,
+      GPSLNavISC = 4,
+      GPSLNavIono = 5,
+      GPSNavConfig = 6,
+      GalINavEph = 7,
+      GalFNavEph = 8,
+      GalINavHealth = 9,
+      GalFNavHealth = 10,
+      GalINavISC = 11,
+      GalINavIono = 12,
+      BDSD1NavEph = 13,
+      BDSD1NavHealth = 14,
+      BDSD1NavIono = 15,
+      BDSD1NavISC = 16,
+      BDSD2NavEph = 17,
+      BDSD2NavHealth = 18,
+      BDSD2NavISC = 19,
+      GLOFNavEph = 20,
+      GLOFNavHealth = 21,
+      RinexTimeOffset = 22,
+      OrbitDataSP3 = 23,
+   };
+
+
+      /** Append values to a buffer in snapshot form.  This and
+       * NavSnapshotDecoder have the same io() interface so that a
+       * single set of ioFields() functions both encodes and decodes
+       * each record type. */
+   class NavSnapshotEncoder
+   {
+   public:
+         /** Append to the given buffer.
+          * @param[in,out] theBuf The buffer to append to. */
+      NavSnapshotEncoder(std::string& theBuf)
+            : buf(theBuf)
+      {}
+         /// Append the bytes of an integer, floating point or enum value.
+      template <class T>
+      void io(const T& v)
+      {
+         static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                       "No snapshot encoding for type");
+         raw(&v, sizeof(v));
+      }
+         /// Append a bool as a single byte.
+      void io(const bool& v)
+      { uint8_t b = v; raw(&b, sizeof(b)); }
+         /// Append a long as 64 bits, whatever its native size.
+      void io(const long& v)
+      { int64_t i = v; raw(&i, sizeof(i)); }
+         /// Append an unsigned long as 64 bits, whatever its native size.
+      void io(const unsigned long& v)
+      { uint64_t i = v; raw(&i, sizeof(i)); }
+      void io(const std::string& v)
+      {
+         uint32_t len = v.size();
+         io(len);
+         raw(v.data(), len);
+      }
+      void io(const CommonTime& v)
+      {
+         long day, msod;
+         double fsod;
+         TimeSystem ts;
+         v.getInternal(day, msod, fsod, ts);
+         io(day);
+         io(msod);
+         io(fsod);
+         io(ts);
+      }
+      void io(const ObsID& v)
+      {
+         io(v.type);
+         io(v.band);
+         io(v.code);
+         io(v.xmitAnt);
+         io(v.freqOffs);
+         io(v.freqOffsWild);
+         io(v.getMcodeBits());
+         io(v.getMcodeMask());
+      }
+      void io(const RefFrame& v)
+      {
+         io(v.getSystem());
+         io(v.getRealization());
+      }
+      template <class T>
+      void io(const ValidType<T>& v)
+      {
+         io(v.is_valid());
+         io(v.get_value());
+      }
+         /// Pad with zeroes to a multiple of navSnapshotAlign.
+      void align()
+      {
+         buf.append((navSnapshotAlign - buf.size() % navSnapshotAlign) %
+                    navSnapshotAlign, '\0');
+      }
+         /// Append len bytes from src.
+      void raw(const void *src, size_t len)
+      { buf.append(static_cast<const char*>(src), len); }
+         /// Buffer being appended to.
+      std::string& buf;
+   };
+
+
+      /** Read values in snapshot form from a buffer, with bounds
+       * checking.  Values that can't be read are zeroed and ok is
+       * set to false. */
+   class NavSnapshotDecoder
+   {
+   public:
+         /** Decode len bytes at theBuf.
+          * @param[in] theBuf The start of the buffer to decode.
+          * @param[in] theLen The number of bytes available at theBuf. */
+      NavSnapshotDecoder(const char *theBuf, size_t theLen)
+            : buf(theBuf), len(theLen), pos(0), ok(true)
+      {}
+         /// Read an integer, floating point or enum value.
+      template <class T>
+      void io(T& v)
+      {
+         static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                       "No snapshot encoding for type");
+         raw(&v, sizeof(v));
+      }
+         /// Read a bool stored as a single byte.
+      void io(bool& v)
+      { uint8_t b = 0; raw(&b, sizeof(b)); v = (b != 0); }
+         /// Read a long stored as 64 bits.
+      void io(long& v)
+      { int64_t i = 0; raw(&i, sizeof(i)); v = i; }
+         /// Read an unsigned long stored as 64 bits.
+      void io(unsigned long& v)
+      { uint64_t i = 0; raw(&i, sizeof(i)); v = i; }
+      void io(std::string& v)
+      {
+         uint32_t strLen = 0;
+         io(strLen);
+         if (!check(strLen))
+         {
+            v.clear();
+            return;
+         }
+         v.assign(buf + pos, strLen);
+         pos += strLen;
+      }
+      void io(CommonTime& v)
+      {
+         long day = 0, msod = 0;
+         double fsod = 0;
+         TimeSystem ts = TimeSystem::Unknown;
+         io(day);
+         io(msod);
+         io(fsod);
+         io(ts);
+         try
+         {
+            v.setInternal(day, msod, fsod, ts);
+         }
+         catch (Exception&)
+         {
+            ok = false;
+         }
+      }
+      void io(ObsID& v)
+      {
+         uint32_t mcode = 0, mcodeMask = 0;
+         io(v.type);
+         io(v.band);
+         io(v.code);
+         io(v.xmitAnt);
+         io(v.freqOffs);
+         io(v.freqOffsWild);
+         io(mcode);
+         io(mcodeMask);
+         v.setMcodeBits(mcode, mcodeMask);
+      }
+      void io(RefFrame& v)
+      {
+         RefFrameSys sys = RefFrameSys::Unknown;
+         RefFrameRlz rlz = RefFrameRlz::Unknown;
+         io(sys);
+         io(rlz);
+         v = RefFrame(rlz);
+      }
+      template <class T>
+      void io(ValidType<T>& v)
+      {
+         bool valid = false;
+         T value = T();
+         io(valid);
+         io(value);
+         v = value;
+         v.set_valid(valid);
+      }
+         /// Skip padding up to a multiple of navSnapshotAlign.
+      void align()
+      {
+         size_t pad = (navSnapshotAlign - pos % navSnapshotAlign) %
+            navSnapshotAlign;
+         if (check(pad))
+            pos += pad;
+      }
+         /// Copy n bytes to dest, or zero dest if there aren't enough.
+      void raw(void *dest, size_t n)
+      {
+         if (check(n))
+         {
+            std::memcpy(dest, buf + pos, n);
+            pos += n;
+         }
+         else
+         {
+            std::memset(dest, 0, n);
+         }
+      }
+         /// Return true if n more bytes are available, otherwise clear ok.
+      bool check(size_t n)
+      {
+         if (ok && (len - pos >= n))
+            return true;
+         ok = false;
+         return false;
+      }
+         /// Buffer being decoded.
+      const char *buf;
+         /// Number of bytes available in buf.
+      size_t len;
+         /// Offset of the next byte to decode.
+      size_t pos;
+         /// Set to false if any value could not be decoded.
+      bool ok;
+   };
+
+
+      // Composite field types are built from the above, and are the
+      // same in both directions.
+
+   template <class Coder, class T>
+   static void ioFields(Coder& c, T *v, size_t n)
+   {
+      for (size_t i = 0; i < n; i++)
+         c.io(v[i]);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, SatID& v)
+   {
+      c.io(v.id);
+      c.io(v.wildId);
+      c.io(v.system);
+      c.io(v.wildSys);
+      c.io(v.norad);
+      c.io(v.hasNorad);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, NavMessageID& v)
+   {
+      c.io(v.system);
+      c.io(v.obs);
+      c.io(v.nav);
+      ioFields(c, v.sat);
+      ioFields(c, v.xmitSat);
+      c.io(v.messageType);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, Triple& v)
+   {
+      c.io(v[0]);
+      c.io(v[1]);
+      c.io(v[2]);
+   }
+
+      // Fields of each class in the hierarchy, parents first.
+
+   template <class Coder>
+   static void ioFields(Coder& c, NavData& v)
+   {
+      c.io(v.timeStamp);
+      ioFields(c, v.signal);
+      c.io(v.weekFmt);
+         // msgLenSec is fixed by the constructor of each supported type.
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, NavFit& v)
+   {
+      c.io(v.beginFit);
+      c.io(v.endFit);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, OrbitDataKepler& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      ioFields(c, static_cast<NavFit&>(v));
+      c.io(v.xmitTime);
+      c.io(v.Toe);
+      c.io(v.Toc);
+      c.io(v.health);
+      c.io(v.Cuc);
+      c.io(v.Cus);
+      c.io(v.Crc);
+      c.io(v.Crs);
+      c.io(v.Cic);
+      c.io(v.Cis);
+      c.io(v.M0);
+      c.io(v.dn);
+      c.io(v.dndot);
+      c.io(v.ecc);
+      c.io(v.A);
+      c.io(v.Ahalf);
+      c.io(v.Adot);
+      c.io(v.OMEGA0);
+      c.io(v.i0);
+      c.io(v.w);
+      c.io(v.OMEGAdot);
+      c.io(v.idot);
+      c.io(v.af0);
+      c.io(v.af1);
+      c.io(v.af2);
+      c.io(v.frame);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, InterSigCorr& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.isc);
+      c.io(v.iscLabel);
+         // refOids and validOids are fixed by the constructor of each
+         // supported type.
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, KlobucharIonoNavData& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      ioFields(c, v.alpha, 4);
+      ioFields(c, v.beta, 4);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, NeQuickIonoNavData& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      ioFields(c, v.ai, 3);
+      ioFields(c, v.idf, 5);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavData& v)
+   {
+      ioFields(c, static_cast<OrbitDataKepler&>(v));
+      c.io(v.pre);
+      c.io(v.tlm);
+      c.io(v.isf);
+      c.io(v.alert);
+      c.io(v.asFlag);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavEph& v)
+   {
+      ioFields(c, static_cast<GPSLNavData&>(v));
+      c.io(v.xmit2);
+      c.io(v.xmit3);
+      c.io(v.pre2);
+      c.io(v.pre3);
+      c.io(v.tlm2);
+      c.io(v.tlm3);
+      c.io(v.isf2);
+      c.io(v.isf3);
+      c.io(v.iodc);
+      c.io(v.iode);
+      c.io(v.fitIntFlag);
+      c.io(v.healthBits);
+      c.io(v.uraIndex);
+      c.io(v.tgd);
+      c.io(v.alert2);
+      c.io(v.alert3);
+      c.io(v.asFlag2);
+      c.io(v.asFlag3);
+      c.io(v.codesL2);
+      c.io(v.L2Pdata);
+      c.io(v.aodo);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavAlm& v)
+   {
+      ioFields(c, static_cast<GPSLNavData&>(v));
+      c.io(v.healthBits);
+      c.io(v.deltai);
+      c.io(v.toa);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.svHealth);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavISC& v)
+   {
+      ioFields(c, static_cast<InterSigCorr&>(v));
+      c.io(v.pre);
+      c.io(v.tlm);
+      c.io(v.isf);
+      c.io(v.alert);
+      c.io(v.asFlag);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSLNavIono& v)
+   {
+      ioFields(c, static_cast<KlobucharIonoNavData&>(v));
+      c.io(v.pre);
+      c.io(v.tlm);
+      c.io(v.isf);
+      c.io(v.alert);
+      c.io(v.asFlag);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GPSNavConfig& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.antispoofOn);
+      c.io(v.svConfig);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalINavEph& v)
+   {
+      ioFields(c, static_cast<OrbitDataKepler&>(v));
+      c.io(v.bgdE5aE1);
+      c.io(v.bgdE5bE1);
+      c.io(v.sisaIndex);
+      c.io(v.svid);
+      c.io(v.xmit2);
+      c.io(v.xmit3);
+      c.io(v.xmit4);
+      c.io(v.xmit5);
+      c.io(v.iodnav1);
+      c.io(v.iodnav2);
+      c.io(v.iodnav3);
+      c.io(v.iodnav4);
+      c.io(v.hsE5b);
+      c.io(v.hsE1B);
+      c.io(v.dvsE5b);
+      c.io(v.dvsE1B);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalFNavEph& v)
+   {
+      ioFields(c, static_cast<OrbitDataKepler&>(v));
+      c.io(v.bgdE5aE1);
+      c.io(v.sisaIndex);
+      c.io(v.svid);
+      c.io(v.xmit2);
+      c.io(v.xmit3);
+      c.io(v.xmit4);
+      c.io(v.iodnav1);
+      c.io(v.iodnav2);
+      c.io(v.iodnav3);
+      c.io(v.iodnav4);
+      c.io(v.hsE5a);
+      c.io(v.dvsE5a);
+      c.io(v.wn1);
+      c.io(v.tow1);
+      c.io(v.wn2);
+      c.io(v.tow2);
+      c.io(v.wn3);
+      c.io(v.tow3);
+      c.io(v.tow4);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalINavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.sigHealthStatus);
+      c.io(v.dataValidityStatus);
+      c.io(v.sisaIndex);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalFNavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.sigHealthStatus);
+      c.io(v.dataValidityStatus);
+      c.io(v.sisaIndex);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalINavISC& v)
+   {
+      ioFields(c, static_cast<InterSigCorr&>(v));
+      c.io(v.bgdE1E5a);
+      c.io(v.bgdE1E5b);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GalINavIono& v)
+   {
+      ioFields(c, static_cast<NeQuickIonoNavData&>(v));
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD1NavData& v)
+   {
+      ioFields(c, static_cast<OrbitDataKepler&>(v));
+      c.io(v.pre);
+      c.io(v.rev);
+      c.io(v.fraID);
+      c.io(v.sow);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD1NavEph& v)
+   {
+      ioFields(c, static_cast<BDSD1NavData&>(v));
+      c.io(v.pre2);
+      c.io(v.pre3);
+      c.io(v.rev2);
+      c.io(v.rev3);
+      c.io(v.sow2);
+      c.io(v.sow3);
+      c.io(v.satH1);
+      c.io(v.aodc);
+      c.io(v.aode);
+      c.io(v.uraIndex);
+      c.io(v.xmit2);
+      c.io(v.xmit3);
+      c.io(v.tgd1);
+      c.io(v.tgd2);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD1NavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.isAlmHealth);
+      c.io(v.satH1);
+      c.io(v.svHealth);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD1NavIono& v)
+   {
+      ioFields(c, static_cast<KlobucharIonoNavData&>(v));
+      c.io(v.pre);
+      c.io(v.rev);
+      c.io(v.fraID);
+      c.io(v.sow);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD1NavISC& v)
+   {
+      ioFields(c, static_cast<InterSigCorr&>(v));
+      c.io(v.pre);
+      c.io(v.rev);
+      c.io(v.fraID);
+      c.io(v.sow);
+      c.io(v.tgd1);
+      c.io(v.tgd2);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD2NavData& v)
+   {
+      ioFields(c, static_cast<OrbitDataKepler&>(v));
+      c.io(v.pre);
+      c.io(v.rev);
+      c.io(v.fraID);
+      c.io(v.sow);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD2NavEph& v)
+   {
+      ioFields(c, static_cast<BDSD2NavData&>(v));
+      c.io(v.satH1);
+      c.io(v.aodc);
+      c.io(v.aode);
+      c.io(v.uraIndex);
+      c.io(v.tgd1);
+      c.io(v.tgd2);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD2NavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.isAlmHealth);
+      c.io(v.satH1);
+      c.io(v.svHealth);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, BDSD2NavISC& v)
+   {
+      ioFields(c, static_cast<InterSigCorr&>(v));
+      c.io(v.pre);
+      c.io(v.rev);
+      c.io(v.fraID);
+      c.io(v.sow);
+      c.io(v.tgd1);
+      c.io(v.tgd2);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GLOFNavData& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      ioFields(c, static_cast<NavFit&>(v));
+      c.io(v.xmit2);
+      c.io(v.satType);
+      c.io(v.slot);
+      c.io(v.lhealth);
+      c.io(v.health);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GLOFNavEph& v)
+   {
+      ioFields(c, static_cast<GLOFNavData&>(v));
+      c.io(v.ref);
+      c.io(v.xmit3);
+      c.io(v.xmit4);
+      ioFields(c, v.pos);
+      ioFields(c, v.vel);
+      ioFields(c, v.acc);
+      c.io(v.clkBias);
+      c.io(v.freqBias);
+      c.io(v.healthBits);
+      c.io(v.tb);
+      c.io(v.P1);
+      c.io(v.P2);
+      c.io(v.P3);
+      c.io(v.P4);
+      c.io(v.interval);
+      c.io(v.opStatus);
+      c.io(v.tauDelta);
+      c.io(v.aod);
+      c.io(v.accIndex);
+      c.io(v.dayCount);
+      c.io(v.Toe);
+      c.io(v.step);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, GLOFNavHealth& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.healthBits);
+      c.io(v.ln);
+      c.io(v.Cn);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, RinexTimeOffset& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      c.io(v.type);
+      c.io(v.frTS);
+      c.io(v.toTS);
+      c.io(v.A0);
+      c.io(v.A1);
+      c.io(v.refTime);
+      c.io(v.geoProvider);
+      c.io(v.geoUTCid);
+      c.io(v.deltatLS);
+   }
+
+   template <class Coder>
+   static void ioFields(Coder& c, OrbitDataSP3& v)
+   {
+      ioFields(c, static_cast<NavData&>(v));
+      ioFields(c, v.pos);
+      ioFields(c, v.posSig);
+      ioFields(c, v.vel);
+      ioFields(c, v.velSig);
+      ioFields(c, v.acc);
+      ioFields(c, v.accSig);
+      c.io(v.clkBias);
+      c.io(v.biasSig);
+      c.io(v.clkDrift);
+      c.io(v.driftSig);
+      c.io(v.clkDrRate);
+      c.io(v.drRateSig);
+      c.io(v.coordSystem);
+      c.io(v.frame);
+   }
+
+
+      /// Encode a record of type T.
+   template <class T>
+   static void encodeRecord(NavSnapshotEncoder& enc, const NavData& nd)
+   {
+         // The encoder only reads the fields, the cast just allows
+         // the same ioFields() to be used for decoding.
+      ioFields(enc, const_cast<T&>(static_cast<const T&>(nd)));
+   }
+
+      /// Decode a record of type T.
+   template <class T>
+   static NavDataPtr decodeRecord(NavSnapshotDecoder& dec)
+   {
+      std::shared_ptr<T> rv = makeNavData<T>();
+      ioFields(dec, *rv);
+      return rv;
+   }
+
+      /// Encoding and decoding functions for one record type.
+   struct NavSnapshotCodec
+   {
+      NavSnapshotType type;
+      std::type_index ti;
+      void (*encode)(NavSnapshotEncoder& enc, const NavData& nd);
+      NavDataPtr (*decode)(NavSnapshotDecoder& dec);
+   };
+
+#define NAVSNAPSHOT_CODEC(T)                                            \
+   { NavSnapshotType::T, std::type_index(typeid(T)), encodeRecord<T>,   \
+         decodeRecord<T> }
+
+      /// All supported record types, in type code order.
+   static const NavSnapshotCodec navSnapshotCodecs[] =
+   {
+      NAVSNAPSHOT_CODEC(GPSLNavEph),
+      NAVSNAPSHOT_CODEC(GPSLNavAlm),
+      NAVSNAPSHOT_CODEC(GPSLNavHealth),
+      NAVSNAPSHOT_CODEC(GPSLNavISC),
+      NAVSNAPSHOT_CODEC(GPSLNavIono),
+      NAVSNAPSHOT_CODEC(GPSNavConfig),
+      NAVSNAPSHOT_CODEC(GalINavEph),
+      NAVSNAPSHOT_CODEC(GalFNavEph),
+      NAVSNAPSHOT_CODEC(GalINavHealth),
+      NAVSNAPSHOT_CODEC(GalFNavHealth),
+      NAVSNAPSHOT_CODEC(GalINavISC),
+      NAVSNAPSHOT_CODEC(GalINavIono),
+      NAVSNAPSHOT_CODEC(BDSD1NavEph),
+      NAVSNAPSHOT_CODEC(BDSD1NavHealth),
+      NAVSNAPSHOT_CODEC(BDSD1NavIono),
+      NAVSNAPSHOT_CODEC(BDSD1NavISC),
+      NAVSNAPSHOT_CODEC(BDSD2NavEph),
+      NAVSNAPSHOT_CODEC(BDSD2NavHealth),
+      NAVSNAPSHOT_CODEC(BDSD2NavISC),
+      NAVSNAPSHOT_CODEC(GLOFNavEph),
+      NAVSNAPSHOT_CODEC(GLOFNavHealth),
+      NAVSNAPSHOT_CODEC(RinexTimeOffset),
+      NAVSNAPSHOT_CODEC(OrbitDataSP3),
+   };
+
+#undef NAVSNAPSHOT_CODEC
+
+      /// Number of entries in navSnapshotCodecs.
+   static const size_t navSnapshotNumCodecs =
+      sizeof(navSnapshotCodecs) / sizeof(navSnapshotCodecs[0]);
+
+
+      /** Read-only view of the contents of a file, memory mapped
+       * where the platform supports it. */
+   class NavSnapshotMapping
+   {
+   public:
+         /** Map the contents of a file.
+          * @param[in] filename The path of the file to map. */
+      NavSnapshotMapping(const std::string& filename)
+            : addr(nullptr), len(0)
+      {
+#ifdef _WIN32
+         std::ifstream s(filename.c_str(), std::ios::binary);
+         if (s)
+         {
+            contents.assign(std::istreambuf_iterator<char>(s),
+                            std::istreambuf_iterator<char>());
+            addr = contents.data();
+            len = contents.size();
+         }
+#else
+         int fd = ::open(filename.c_str(), O_RDONLY);
+         if (fd < 0)
+            return;
+         struct stat st;
+         if ((::fstat(fd, &st) == 0) && (st.st_size > 0))
+         {
+            void *p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd,
+                             0);
+            if (p != MAP_FAILED)
+            {
+               addr = static_cast<const char*>(p);
+               len = st.st_size;
+            }
+         }
+            // the mapping remains valid after closing.
+         ::close(fd);
+#endif
+      }
+         /// Unmap the file.
+      ~NavSnapshotMapping()
+      {
+#ifndef _WIN32
+         if (addr != nullptr)
+            ::munmap(const_cast<char*>(addr), len);
+#endif
+      }
+         /// Start of the file contents, or nullptr if it couldn't be mapped.
+      const char *addr;
+         /// Size of the file contents.
+      size_t len;
+   private:
+#ifdef _WIN32
+         /// Contents of the file, read in full as there is no mmap.
+      std::vector<char> contents;
+#endif
+         // no copying
+      NavSnapshotMapping(const NavSnapshotMapping&) = delete;
+      NavSnapshotMapping& operator=(const NavSnapshotMapping&) = delete;
+   };
+
+
+   bool NavSnapshot ::
+   encode(const NavData& nd, std::string& buf)
+   {
+      static const std::map<std::type_index, const NavSnapshotCodec*> byType =
+         []()
+         {
+            std::map<std::type_index, const NavSnapshotCodec*> rv;
+            for (size_t i = 0; i < navSnapshotNumCodecs; i++)
+            {
+               rv[navSnapshotCodecs[i].ti] = &navSnapshotCodecs[i];
+            }
+            return rv;
+         }();
+      auto ci = byType.find(std::type_index(typeid(nd)));
+      if (ci == byType.end())
+      {
+         return false;
+      }
+         // header is the type code and the padded length, which is
+         // filled in once the record is encoded.
+      size_t start = buf.size();
+      NavSnapshotEncoder enc(buf);
+      uint32_t length = 0;
+      enc.io(ci->second->type);
+      enc.io(length);
+      ci->second->encode(enc, nd);
+      enc.align();
+      length = buf.size() - start;
+      std::memcpy(&buf[start + sizeof(uint32_t)], &length, sizeof(length));
+      return true;
+   }
+
+
+   NavDataPtr NavSnapshot ::
+   decode(const char *buf, size_t len, size_t& used)
+   {
+      NavSnapshotDecoder hdr(buf, len);
+      uint32_t type = 0, length = 0;
+      hdr.io(type);
+      hdr.io(length);
+      used = length;
+      if (!hdr.ok || (length > len) || (length < hdr.pos) ||
+          (type < 1) || (type > navSnapshotNumCodecs))
+      {
+         return nullptr;
+      }
+      NavSnapshotDecoder dec(buf, length);
+      dec.pos = hdr.pos;
+      NavDataPtr rv = navSnapshotCodecs[type-1].decode(dec);
+      if (!dec.ok)
+      {
+         return nullptr;
+      }
+      return rv;
+   }
+
+
+   bool NavSnapshot ::
+   write(const std::string& filename,
+         const std::vector<const NavDataFactoryWithStore*>& facts)
+   {
+      std::ofstream s(filename.c_str(), std::ios::binary | std::ios::trunc);
+      if (!s)
+      {
+         return false;
+      }
+      std::string buf;
+      NavSnapshotEncoder enc(buf);
+      enc.raw(magic, sizeof(magic));
+      enc.io(formatVersion);
+      enc.io(navSnapshotByteOrder);
+      enc.io(static_cast<uint32_t>(facts.size()));
+      enc.io(static_cast<uint32_t>(0));
+      for (const auto fact : facts)
+      {
+            // Records that were replaced in the user map by a later
+            // record with the same time are only in the nearest map.
+            // Write those first so that loading the records in order
+            // gives the same user map.
+         std::set<const NavData*> inUserMap;
+         uint64_t numRecords = 0;
+         for (const auto& mti : fact->data)
+         {
+            for (const auto& sati : mti.second)
+            {
+               for (const auto& ti : sati.second)
+               {
+                  inUserMap.insert(ti.second.get());
+                  numRecords++;
+               }
+            }
+         }
+         NavDataPtrList records;
+         for (const auto& mti : fact->nearestData)
+         {
+            for (const auto& sati : mti.second)
+            {
+               for (const auto& ti : sati.second)
+               {
+                  for (const auto& ndp : ti.second)
+                  {
+                     if (inUserMap.count(ndp.get()) == 0)
+                     {
+                        records.push_back(ndp);
+                     }
+                  }
+               }
+            }
+         }
+         numRecords += records.size();
+         enc.io(fact->getClassName());
+         enc.io(fact->initialTime);
+         enc.io(fact->finalTime);
+         enc.io(numRecords);
+         enc.align();
+         for (const auto& mti : fact->data)
+         {
+            for (const auto& sati : mti.second)
+            {
+               for (const auto& ti : sati.second)
+               {
+                  records.push_back(ti.second);
+               }
+            }
+         }
+         for (const auto& ndp : records)
+         {
+            if (!encode(*ndp, buf))
+            {
+               s.close();
+               std::remove(filename.c_str());
+               return false;
+            }
+            if (buf.size() >= 65536)
+            {
+               s.write(buf.data(), buf.size());
+               buf.clear();
+            }
+         }
+      }
+      s.write(buf.data(), buf.size());
+      s.close();
+      return !s.fail();
+   }
+
+
+   bool NavSnapshot ::
+   read(const std::string& filename,
+        const std::vector<NavDataFactoryWithStore*>& facts)
+   {
+      NavSnapshotMapping map(filename);
+      if (map.addr == nullptr)
+      {
+         return false;
+      }
+      NavSnapshotDecoder dec(map.addr, map.len);
+      char fileMagic[sizeof(magic)];
+      uint32_t version = 0, byteOrder = 0, numSections = 0, reserved = 0;
+      dec.raw(fileMagic, sizeof(fileMagic));
+      dec.io(version);
+      dec.io(byteOrder);
+      dec.io(numSections);
+      dec.io(reserved);
+      if (!dec.ok || (std::memcmp(fileMagic, magic, sizeof(magic)) != 0) ||
+          (version != formatVersion) || (byteOrder != navSnapshotByteOrder))
+      {
+         return false;
+      }
+         /// A decoded section, waiting to be added to its store.
+      struct Section
+      {
+         NavDataFactoryWithStore *fact;
+         CommonTime initialTime, finalTime;
+         NavDataPtrList records;
+      };
+      std::vector<Section> sections(numSections);
+      std::vector<bool> used(facts.size(), false);
+         // Decode everything before touching any of the stores.
+      for (auto& sect : sections)
+      {
+         std::string className;
+         uint64_t numRecords = 0;
+         dec.io(className);
+         dec.io(sect.initialTime);
+         dec.io(sect.finalTime);
+         dec.io(numRecords);
+         dec.align();
+         if (!dec.ok)
+         {
+            return false;
+         }
+         sect.fact = nullptr;
+         for (size_t i = 0; i < facts.size(); i++)
+         {
+            if (!used[i] && (facts[i]->getClassName() == className))
+            {
+               used[i] = true;
+               sect.fact = facts[i];
+               break;
+            }
+         }
+         if ((sect.fact == nullptr) || sect.fact->isFrozen())
+         {
+            return false;
+         }
+         NavDataArena::Use useArena(sect.fact->getArena());
+         for (uint64_t i = 0; i < numRecords; i++)
+         {
+            size_t recLen = 0;
+            NavDataPtr ndp = decode(dec.buf + dec.pos, dec.len - dec.pos,
+                                    recLen);
+            if (!ndp)
+            {
+               return false;
+            }
+            dec.pos += recLen;
+            sect.records.push_back(ndp);
+         }
+      }
+      for (auto& sect : sections)
+      {
+         for (const auto& ndp : sect.records)
+         {
+            if (!sect.fact->addNavData(ndp))
+            {
+               return false;
+            }
+         }
+            // The stored times may be wider than the records if the
+            // store was edited.
+         if (!sect.records.empty() &&
+             !sect.fact->updateInitialFinal(sect.initialTime,
+                                            sect.finalTime))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+}
@@ -0,0 +1,140 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_NAVSNAPSHOT_HPP
+#define GNSSTK_NAVSNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "NavData.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      // forward declaration
+   class NavDataFactoryWithStore;
+
+      /** Binary snapshots of the contents of NavDataFactoryWithStore
+       * objects.
+       *
+       * Loading navigation data from its original formats means
+       * parsing text, decoding subframes and so on, every time a
+       * program starts.  A snapshot stores the decoded records, so
+       * a store that was loaded once can be restored without any of
+       * that (see NavDataFactoryWithStore::writeSnapshot() and
+       * NavDataFactoryWithStore::readSnapshot()).
+       *
+       * A snapshot file contains a header identifying the file
+       * format version and byte order, followed by one section per
+       * factory.  Each section contains the factory class name, the
+       * initial and final times of the store, and the records,
+       * each of which is a type code and length followed by the
+       * fields of the record in native byte order, aligned to 8
+       * bytes.  Files are read via a read-only memory mapping, so
+       * the pages of a snapshot being loaded by several processes
+       * at once are only read from disk once.
+       *
+       * Snapshots support the record types produced by the
+       * file-reading factories, i.e. RINEX NAV, SP3, RINEX clock,
+       * SEM and Yuma.  Other types cause writing to fail.
+       *
+       * @note Snapshots are intended as a cache of a store for a
+       *   specific build of the library on a specific platform.
+       *   Files written by a different version of the format or on
+       *   a platform with different byte order are rejected.
+       * @note A record's reference frame is restored from its
+       *   realization, so a record whose frame has a known system
+       *   and unknown realization is restored with an unknown
+       *   frame. */
+   class NavSnapshot
+   {
+   public:
+         /// Identifies the file as a snapshot.
+      static const char magic[8];
+         /// Version of the file format, changed whenever it changes.
+      static const uint32_t formatVersion;
+
+         /** Write the contents of one or more stores to a snapshot
+          * file.
+          * @param[in] filename The path of the file to write.
+          * @param[in] facts The stores to write, one section each.
+          * @return true on success, false if the file could not be
+          *   written or any of the stores contains a record type
+          *   that is not supported. */
+      static bool write(const std::string& filename,
+                        const std::vector<const NavDataFactoryWithStore*>&
+                        facts);
+
+         /** Load the contents of a snapshot file into stores.  Each
+          * section is loaded into the first store in facts with
+          * the same class name that has not already been loaded.
+          * Nothing is loaded unless the whole file can be decoded.
+          * @param[in] filename The path of the snapshot file to read.
+          * @param[in] facts The stores to load the sections into.
+          * @return true on success, false if the file could not be
+          *   read, is not a snapshot of this format version and byte
+          *   order, contains a section for which there is no
+          *   matching store, or if a matching store is frozen. */
+      static bool read(const std::string& filename,
+                       const std::vector<NavDataFactoryWithStore*>& facts);
+
+         /** Append the encoded form of a record to buf.
+          * @param[in] nd The record to encode.
+          * @param[in,out] buf The buffer to append the record to.
+          * @return false if the type of nd is not supported, in
+          *   which case buf is unchanged. */
+      static bool encode(const NavData& nd, std::string& buf);
+
+         /** Decode a record produced by encode().
+          * @param[in] buf The start of the encoded record.
+          * @param[in] len The number of bytes available at buf.
+          * @param[out] used The number of bytes of buf that were
+          *   decoded, including any padding.
+          * @return The decoded record, or a null pointer if the
+          *   record is of an unknown type or is truncated. */
+      static NavDataPtr decode(const char *buf, size_t len, size_t& used);
+   };
+
+      //@}
+
+}
+
+#endif // GNSSTK_NAVSNAPSHOT_HPP
@@ -45,15 +45,6 @@
 #include "RinexNavDataFactory.hpp"
 #include "SP3NavDataFactory.hpp"
 #include "PNBMultiGNSSNavDataFactory.hpp"
-#include "PNBGPSLNavDataFactory.hpp"
-#include "PNBGPSCNavDataFactory.hpp"
-#include "PNBGPSCNav2DataFactory.hpp"
-#include "PNBGalINavDataFactory.hpp"
-#include "PNBGalFNavDataFactory.hpp"
-#include "PNBBDSD1NavDataFactory.hpp"
-#include "PNBBDSD2NavDataFactory.hpp"
-#include "PNBGLOFNavDataFactory.hpp"
-#include "PNBGLOCNavDataFactory.hpp"
 #include "YumaNavDataFactory.hpp"
 #include "SEMNavDataFactory.hpp"
 
@@ -106,45 +97,12 @@ namespace gnsstk
          MultiFormatNavDataFactory::addFactory(ndfp3);
          MultiFormatNavDataFactory::addFactory(ndfp4);
 
-         gnsstk::PNBNavDataFactoryPtr
-            lnav(std::make_shared<gnsstk::PNBGPSLNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GPSLNAV,lnav);
-
-         gnsstk::PNBNavDataFactoryPtr
-            cnavL2(std::make_shared<gnsstk::PNBGPSCNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GPSCNAVL2,cnavL2);
-
-         gnsstk::PNBNavDataFactoryPtr
-            cnavL5(std::make_shared<gnsstk::PNBGPSCNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GPSCNAVL5,cnavL5);
-
-         gnsstk::PNBNavDataFactoryPtr
-            cnav2(std::make_shared<gnsstk::PNBGPSCNav2DataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GPSCNAV2,cnav2);
-
-         gnsstk::PNBNavDataFactoryPtr
-            gali(std::make_shared<gnsstk::PNBGalINavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GalINAV,gali);
-
-         gnsstk::PNBNavDataFactoryPtr
-            galf(std::make_shared<gnsstk::PNBGalFNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GalFNAV,galf);
-
-         gnsstk::PNBNavDataFactoryPtr
-            bd1(std::make_shared<gnsstk::PNBBDSD1NavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::BeiDou_D1,bd1);
-
-         gnsstk::PNBNavDataFactoryPtr
-            bd2(std::make_shared<gnsstk::PNBBDSD2NavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::BeiDou_D2,bd2);
-
-         gnsstk::PNBNavDataFactoryPtr
-            glof(std::make_shared<gnsstk::PNBGLOFNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GloCivilF,glof);
-
-         gnsstk::PNBNavDataFactoryPtr
-            gloc(std::make_shared<gnsstk::PNBGLOCNavDataFactory>());
-         PNBMultiGNSSNavDataFactory::addFactory(NavType::GloCivilC,gloc);
+         std::shared_ptr<PNBNavDataFactoryMap> pnbFacts =
+            PNBMultiGNSSNavDataFactory::newFactories();
+         for (auto& fi : *pnbFacts)
+         {
+            PNBMultiGNSSNavDataFactory::addFactory(fi.first, fi.second);
+         }
       }
    };
 
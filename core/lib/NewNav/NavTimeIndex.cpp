@@ -0,0 +1,129 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include "NavTimeIndex.hpp"
+#include "StringUtils.hpp"
+#include "TimeConstants.hpp"
+
+namespace gnsstk
+{
+   NavTimeIndex::Key ::
+   Key(const CommonTime& ct)
+   {
+      long day, msod;
+      ct.getInternal(day, msod, fsod);
+      msec = (int64_t)day * MS_PER_DAY + msod;
+      ts = ct.getTimeSystem();
+   }
+
+
+   void NavTimeIndex::Key ::
+   throwTimeSystemMismatch(const Key& right) const
+   {
+      InvalidRequest ir(
+         "CommonTime objects not in same time system, cannot be compared: " +
+         StringUtils::asString(ts) + " != " +
+         StringUtils::asString(right.ts));
+      GNSSTK_THROW(ir);
+   }
+
+
+   void NavTimeIndex ::
+   assign(const NavMap& nm)
+   {
+      clear();
+      keys.reserve(nm.size());
+      records.reserve(nm.size());
+      for (const auto& nmi : nm)
+      {
+         keys.push_back(Key(nmi.first));
+         records.push_back(nmi.second);
+      }
+   }
+
+
+   void NavTimeIndex ::
+   assign(const NavNearMap& nnm)
+   {
+      clear();
+      size_t total = 0;
+      for (const auto& nnmi : nnm)
+      {
+         total += nnmi.second.size();
+      }
+      keys.reserve(total);
+      records.reserve(total);
+      for (const auto& nnmi : nnm)
+      {
+         Key key(nnmi.first);
+         for (const auto& ndpli : nnmi.second)
+         {
+            keys.push_back(key);
+            records.push_back(ndpli);
+         }
+      }
+   }
+
+
+   size_t NavTimeIndex ::
+   lowerBound(const Key& when) const
+   {
+      return std::lower_bound(keys.begin(), keys.end(), when) - keys.begin();
+   }
+
+
+   size_t NavTimeIndex ::
+   upperBound(const Key& when) const
+   {
+      return std::upper_bound(keys.begin(), keys.end(), when) - keys.begin();
+   }
+
+
+   const NavTimeIndex* findSatIndex(const NavSatIndex& nsi,
+                                    const NavSatelliteID& sat)
+   {
+      auto i = std::lower_bound(
+         nsi.begin(), nsi.end(), sat,
+         [](const NavSatIndex::value_type& left, const NavSatelliteID& right)
+         { return left.first < right; });
+      if ((i == nsi.end()) || (sat < i->first))
+         return nullptr;
+      return &(i->second);
+   }
+} // namespace gnsstk
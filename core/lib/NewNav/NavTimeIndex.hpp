@@ -0,0 +1,175 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_NAVTIMEINDEX_HPP
+#define GNSSTK_NAVTIMEINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include "NavData.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Flat, time-sorted storage of the navigation data for a
+       * single message type and satellite/signal.  This is the
+       * compacted equivalent of a NavMap or NavNearMap.  The time
+       * stamps are stored as packed keys in one contiguous array and
+       * the records they refer to in a parallel array, so that
+       * searches are a binary search over contiguous memory rather
+       * than a descent through a red-black tree.
+       *
+       * Unlike NavMap, duplicate keys are allowed, which is how the
+       * contents of a NavNearMap (where each time stamp refers to a
+       * list of records) are represented.  Records with equal keys
+       * are kept in the order they appear in the list.
+       *
+       * The packed keys keep the time system, and as with
+       * searches of a NavMap, comparing keys in different time
+       * systems (neither of which is TimeSystem::Any) throws an
+       * InvalidRequest exception. */
+   class NavTimeIndex
+   {
+   public:
+         /// Packed representation of a CommonTime used for searching.
+      class Key
+      {
+      public:
+            /// Initialize to the earliest representable time.
+         Key()
+               : msec(0), fsod(0), ts(TimeSystem::Any)
+         {}
+            /** Pack a CommonTime.
+             * @param[in] ct The time to pack into a key. */
+         Key(const CommonTime& ct);
+            /** Ordering that matches CommonTime::operator<().
+             * @throw InvalidRequest if the time systems differ and
+             *   neither is TimeSystem::Any. */
+         bool operator<(const Key& right) const
+         {
+            checkTimeSystem(right);
+            if (msec < right.msec) return true;
+            if (msec > right.msec) return false;
+            return fsod < right.fsod;
+         }
+            /** Return the difference (this-right) in seconds.
+             * @throw InvalidRequest if the time systems differ and
+             *   neither is TimeSystem::Any. */
+         double operator-(const Key& right) const
+         {
+            checkTimeSystem(right);
+            return (double)(msec - right.msec) * 0.001 + (fsod - right.fsod);
+         }
+            /** Make sure two keys may be compared.
+             * @throw InvalidRequest if the time systems differ and
+             *   neither is TimeSystem::Any. */
+         void checkTimeSystem(const Key& right) const
+         {
+            if ((ts != right.ts) && (ts != TimeSystem::Any) &&
+                (right.ts != TimeSystem::Any))
+            {
+               throwTimeSystemMismatch(right);
+            }
+         }
+            /// Integer milliseconds since the CommonTime epoch.
+         int64_t msec;
+            /// Sub-millisecond part of the time in seconds (< 0.001).
+         double fsod;
+            /// The time system of the packed time.
+         TimeSystem ts;
+      private:
+            /// Throw the exception for keys in different time systems.
+         void throwTimeSystemMismatch(const Key& right) const;
+      };
+
+         /** Fill the index with the contents of a NavMap.
+          * @param[in] nm The map to copy the records from. */
+      void assign(const NavMap& nm);
+         /** Fill the index with the contents of a NavNearMap.
+          * @param[in] nnm The map to copy the records from. */
+      void assign(const NavNearMap& nnm);
+
+         /// Remove all records.
+      void clear()
+      { keys.clear(); records.clear(); }
+         /// Return the number of records in the index.
+      size_t size() const
+      { return keys.size(); }
+         /// Return true if there are no records in the index.
+      bool empty() const
+      { return keys.empty(); }
+
+         /** Find the first record whose key is not less than \a when.
+          * @param[in] when The time to search for.
+          * @return The index of the first record at or after when,
+          *   or size() if there are no such records. */
+      size_t lowerBound(const Key& when) const;
+         /** Find the first record whose key is greater than \a when.
+          * @param[in] when The time to search for.
+          * @return The index of the first record after when, or
+          *   size() if there are no such records. */
+      size_t upperBound(const Key& when) const;
+
+         /// Sorted packed time stamps.
+      std::vector<Key> keys;
+         /// The records referred to by keys, in the same order.
+      std::vector<NavDataPtr> records;
+   };
+
+      /** Compacted equivalent of NavSatMap.  The elements are sorted
+       * by NavSatelliteID so that exact matches can be found with a
+       * binary search and wildcard matches with a linear scan over
+       * contiguous memory. */
+   typedef std::vector<std::pair<NavSatelliteID, NavTimeIndex> > NavSatIndex;
+      /// Compacted equivalent of NavMessageMap and NavNearMessageMap.
+   typedef std::map<NavMessageType, NavSatIndex> NavMessageIndex;
+
+      /** Find the index for a specific satellite/signal.
+       * @param[in] nsi The satellite index to search.
+       * @param[in] sat The satellite/signal to look for (no wildcards).
+       * @return A pointer to the matching index or nullptr if not found. */
+   const NavTimeIndex* findSatIndex(const NavSatIndex& nsi,
+                                    const NavSatelliteID& sat);
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_NAVTIMEINDEX_HPP
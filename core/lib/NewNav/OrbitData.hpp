@@ -39,6 +39,7 @@
 #ifndef GNSSTK_ORBITDATA_HPP
 #define GNSSTK_ORBITDATA_HPP
 
+#include <memory>
 #include "NavData.hpp"
 #include "Xvt.hpp"
 
@@ -47,12 +48,29 @@ namespace gnsstk
       /// @ingroup NavFactory
       //@{
 
+   class XvtFit;
+
       /** Abstract base class for classes that compute satellite
        * positions.  Only the interface is defined as some systems use
        * Keplerian orbital elements, while others use tables. */
    class OrbitData : public NavData
    {
    public:
+         /// Initialize with no fitted Xvt.
+      OrbitData() = default;
+         /** Copy the orbit data but not the fitted Xvt, which is
+          * created again when needed by the copy. */
+      OrbitData(const OrbitData& right)
+            : NavData(right)
+      {}
+         /// Assign the orbit data and discard the fitted Xvt.
+      OrbitData& operator=(const OrbitData& right)
+      {
+         NavData::operator=(right);
+         clearXvtFit();
+         return *this;
+      }
+
          /** Compute the satellites position and velocity at a time.
           * @param[in] when The time at which to compute the xvt.
           * @param[out] xvt The resulting computed position/velocity.
@@ -65,6 +83,29 @@ namespace gnsstk
       virtual bool getXvt(const CommonTime& when, Xvt& xvt,
                           const ObsID& oid = ObsID()) = 0;
 
+         /** Compute the satellite position and velocity at a time
+          * using a polynomial fit of getXvt() over the fit interval
+          * (see XvtFit).  The fit is made on the first call and
+          * kept with this object, so this is intended for orbit
+          * data that is evaluated many times.  This falls back to
+          * getXvt() when the orbit doesn't have a fit interval
+          * (i.e. isn't derived from NavFit), when can't be fitted
+          * within XvtFit's default tolerances, when "when" is
+          * outside the fit interval, or when oid is not the
+          * default ObsID.
+          * @note The fit is not updated when the object is
+          *   modified.  Call clearXvtFit() after changing orbit
+          *   parameters.
+          * @note This method may be called concurrently from
+          *   multiple threads, although each may do the work of
+          *   fitting on the first call.
+          * @copydetails getXvt */
+      bool getXvtFitted(const CommonTime& when, Xvt& xvt,
+                        const ObsID& oid = ObsID());
+
+         /// Discard the fit made by getXvtFitted().
+      void clearXvtFit();
+
          /// @copydoc NavData::isSameData
       bool isSameData(const NavDataPtr& right) const override
       {
@@ -78,6 +119,12 @@ namespace gnsstk
          Exception exc("Unimplemented function");
          GNSSTK_THROW(exc);
       }
+
+   private:
+         /** The fit used by getXvtFitted(), accessed atomically.
+          * This refers to an invalid fit if fitting was attempted
+          * and failed, so that it's not attempted again. */
+      std::shared_ptr<const XvtFit> xvtFit;
    };
 
       //@}
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBBDSD1NavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "BDSD1NavEph.hpp"
 #include "BDSD1NavTimeOffset.hpp"
 #include "BDSD1NavHealth.hpp"
@@ -44,6 +45,7 @@
 #include "BDSD1NavISC.hpp"
 #include "TimeCorrection.hpp"
 #include "TimeString.hpp"
+#include "BDSBCH.hpp"
 #include "BDSD1Bits.hpp"
 
 using namespace std;
@@ -90,9 +92,9 @@ namespace gnsstk
                expParity = false;
                break;
          }
-         if (checkParity)
+         if (checkParity && (BDSBCH::check(*navIn) != expParity))
          {
-               /// @todo Implement a parity check
+            return true;
          }
          switch (sfid)
          {
@@ -263,7 +265,7 @@ namespace gnsstk
          }
       }
       NavSatelliteID sat(svid, xmitSat, navIn->getobsID(), navIn->getNavID());
-      auto alm = std::make_shared<BDSD1NavAlm>();
+      auto alm = makeNavData<BDSD1NavAlm>();
       alm->isDefault = isAlmDefault(navIn);
       // cerr << "  svid=" << svid << "  default=" << alm->isDefault;
          // NavData
@@ -326,7 +328,7 @@ namespace gnsstk
          if (processHea)
          {
             std::shared_ptr<BDSD1NavHealth> hea  =
-               std::make_shared<BDSD1NavHealth>();
+               makeNavData<BDSD1NavHealth>();
             hea->timeStamp = navIn->getTransmitTime();
             hea->signal = NavMessageID(key, NavMessageType::Health);
             hea->isAlmHealth = false;
@@ -337,7 +339,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processIono)
          {
             std::shared_ptr<BDSD1NavIono> iono =
-               std::make_shared<BDSD1NavIono>();
+               makeNavData<BDSD1NavIono>();
             iono->timeStamp = navIn->getTransmitTime();
             iono->signal = NavMessageID(
                NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -366,7 +368,7 @@ namespace gnsstk
          }
          if (PNBNavDataFactory::processISC)
          {
-            std::shared_ptr<BDSD1NavISC> isc = std::make_shared<BDSD1NavISC>();
+            std::shared_ptr<BDSD1NavISC> isc = makeNavData<BDSD1NavISC>();
             isc->timeStamp = navIn->getTransmitTime();
             isc->signal = NavMessageID(
                NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -430,7 +432,7 @@ namespace gnsstk
             // consider it as a "valid" but unprocessable data set.
          return true;
       }
-      std::shared_ptr<BDSD1NavEph> eph = std::make_shared<BDSD1NavEph>();
+      std::shared_ptr<BDSD1NavEph> eph = makeNavData<BDSD1NavEph>();
          // NavData
       eph->timeStamp = ephSF[sf1]->getTransmitTime();
       eph->signal = NavMessageID(key, NavMessageType::Ephemeris);
@@ -643,7 +645,7 @@ namespace gnsstk
          ref.sow = 0;
             // BDT-GPS time offset
          std::shared_ptr<BDSD1NavTimeOffset> gps =
-            std::make_shared<BDSD1NavTimeOffset>();
+            makeNavData<BDSD1NavTimeOffset>();
          gps->timeStamp = navIn->getTransmitTime();
          gps->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -662,7 +664,7 @@ namespace gnsstk
 
             // BDT-Galileo time offset
          std::shared_ptr<BDSD1NavTimeOffset> gal =
-            std::make_shared<BDSD1NavTimeOffset>();
+            makeNavData<BDSD1NavTimeOffset>();
          gal->timeStamp = navIn->getTransmitTime();
          gal->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -681,7 +683,7 @@ namespace gnsstk
 
             // BDT-GLONASS time offset
          std::shared_ptr<BDSD1NavTimeOffset> glo =
-            std::make_shared<BDSD1NavTimeOffset>();
+            makeNavData<BDSD1NavTimeOffset>();
          glo->timeStamp = navIn->getTransmitTime();
          glo->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -708,7 +710,7 @@ namespace gnsstk
       if (PNBNavDataFactory::processTim)
       {
          std::shared_ptr<BDSD1NavTimeOffset> to =
-            std::make_shared<BDSD1NavTimeOffset>();
+            makeNavData<BDSD1NavTimeOffset>();
          to->timeStamp = navIn->getTransmitTime();
          to->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -810,7 +812,7 @@ namespace gnsstk
               unsigned startBit1, unsigned numBits1,
               unsigned startBit2, unsigned numBits2)
    {
-      std::shared_ptr<BDSD1NavHealth> hea = std::make_shared<BDSD1NavHealth>();
+      std::shared_ptr<BDSD1NavHealth> hea = makeNavData<BDSD1NavHealth>();
       hea->timeStamp = navIn->getTransmitTime();
       hea->signal = NavMessageID(
          NavSatelliteID(subjID, navIn->getsatSys(), navIn->getobsID(),
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBBDSD2NavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "BDSD2NavEph.hpp"
 #include "BDSD2NavTimeOffset.hpp"
 #include "BDSD2NavHealth.hpp"
@@ -44,6 +45,7 @@
 #include "BDSD2NavISC.hpp"
 #include "TimeCorrection.hpp"
 #include "TimeString.hpp"
+#include "BDSBCH.hpp"
 #include "BDSD2Bits.hpp"
 
 using namespace std;
@@ -98,9 +100,9 @@ namespace gnsstk
                expParity = false;
                break;
          }
-         if (checkParity)
+         if (checkParity && (BDSBCH::check(*navIn) != expParity))
          {
-               /// @todo Implement a parity check
+            return true;
          }
          switch (sfid)
          {
@@ -250,7 +252,7 @@ namespace gnsstk
          }
       }
       NavSatelliteID sat(svid, xmitSat, navIn->getobsID(), navIn->getNavID());
-      auto alm = std::make_shared<BDSD2NavAlm>();
+      auto alm = makeNavData<BDSD2NavAlm>();
       alm->isDefault = isAlmDefault(navIn);
       // cerr << "  svid=" << svid << "  default=" << alm->isDefault;
          // NavData
@@ -312,7 +314,7 @@ namespace gnsstk
       {
          if (PNBNavDataFactory::processISC)
          {
-            std::shared_ptr<BDSD2NavISC> isc = std::make_shared<BDSD2NavISC>();
+            std::shared_ptr<BDSD2NavISC> isc = makeNavData<BDSD2NavISC>();
             isc->timeStamp = navIn->getTransmitTime();
             isc->signal = NavMessageID(
                NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -330,7 +332,7 @@ namespace gnsstk
          if (processHea)
          {
             std::shared_ptr<BDSD2NavHealth> hea  =
-               std::make_shared<BDSD2NavHealth>();
+               makeNavData<BDSD2NavHealth>();
             hea->timeStamp = navIn->getTransmitTime();
             hea->signal = NavMessageID(key, NavMessageType::Health);
             hea->isAlmHealth = false;
@@ -342,7 +344,7 @@ namespace gnsstk
       else if ((pgid == 2) && PNBNavDataFactory::processIono)
       {
          std::shared_ptr<BDSD2NavIono> iono =
-            std::make_shared<BDSD2NavIono>();
+            makeNavData<BDSD2NavIono>();
          iono->timeStamp = navIn->getTransmitTime();
          iono->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -442,7 +444,7 @@ namespace gnsstk
             }
          }
       }
-      std::shared_ptr<BDSD2NavEph> eph = std::make_shared<BDSD2NavEph>();
+      std::shared_ptr<BDSD2NavEph> eph = makeNavData<BDSD2NavEph>();
          // NavData
       eph->timeStamp = ephSF[pg1]->getTransmitTime();
       eph->signal = NavMessageID(key, NavMessageType::Ephemeris);
@@ -667,7 +669,7 @@ namespace gnsstk
          ref.sow = 0;
             // BDT-GPS time offset
          std::shared_ptr<BDSD2NavTimeOffset> gps =
-            std::make_shared<BDSD2NavTimeOffset>();
+            makeNavData<BDSD2NavTimeOffset>();
          gps->timeStamp = navIn->getTransmitTime();
          gps->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -686,7 +688,7 @@ namespace gnsstk
 
             // BDT-Galileo time offset
          std::shared_ptr<BDSD2NavTimeOffset> gal =
-            std::make_shared<BDSD2NavTimeOffset>();
+            makeNavData<BDSD2NavTimeOffset>();
          gal->timeStamp = navIn->getTransmitTime();
          gal->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -705,7 +707,7 @@ namespace gnsstk
 
             // BDT-GLONASS time offset
          std::shared_ptr<BDSD2NavTimeOffset> glo =
-            std::make_shared<BDSD2NavTimeOffset>();
+            makeNavData<BDSD2NavTimeOffset>();
          glo->timeStamp = navIn->getTransmitTime();
          glo->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -732,7 +734,7 @@ namespace gnsstk
       if (PNBNavDataFactory::processTim)
       {
          std::shared_ptr<BDSD2NavTimeOffset> to =
-            std::make_shared<BDSD2NavTimeOffset>();
+            makeNavData<BDSD2NavTimeOffset>();
          to->timeStamp = navIn->getTransmitTime();
          to->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -834,7 +836,7 @@ namespace gnsstk
               unsigned startBit1, unsigned numBits1,
               unsigned startBit2, unsigned numBits2)
    {
-      std::shared_ptr<BDSD2NavHealth> hea = std::make_shared<BDSD2NavHealth>();
+      std::shared_ptr<BDSD2NavHealth> hea = makeNavData<BDSD2NavHealth>();
       hea->timeStamp = navIn->getTransmitTime();
       hea->signal = NavMessageID(
          NavSatelliteID(subjID, navIn->getsatSys(), navIn->getobsID(),
@@ -38,6 +38,7 @@
 //==============================================================================
 #include "DebugTrace.hpp"
 #include "PNBGLOCNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "GLOCBits.hpp"
 #include "GLOCNavAlm.hpp"
 #include "GLOCNavEph.hpp"
@@ -208,7 +209,7 @@ namespace gnsstk
       if (processIono)
       {
          DEBUGTRACE("iono");
-         NavDataPtr p0 = std::make_shared<GLOCNavIono>();
+         NavDataPtr p0 = makeNavData<GLOCNavIono>();
          p0->timeStamp = navIn->getTransmitTime();
          p0->signal = NavMessageID(key, NavMessageType::Iono);
          GLOCNavIono *iono = dynamic_cast<GLOCNavIono*>(p0.get());
@@ -220,7 +221,7 @@ namespace gnsstk
       if (processTim && timeAcc[key].isValid())
       {
          DEBUGTRACE("time");
-         NavDataPtr p0 = std::make_shared<GLOCNavUT1TimeOffset>();
+         NavDataPtr p0 = makeNavData<GLOCNavUT1TimeOffset>();
          GLOCNavUT1TimeOffset *to = dynamic_cast<GLOCNavUT1TimeOffset*>(
             p0.get());
          to->NB = navIn->asUnsignedLong(isbNB, inbNB, iscNB);
@@ -247,7 +248,7 @@ namespace gnsstk
       {
          NavSatelliteID key(navIn->getsatSys().id, navIn->getsatSys(),
                             navIn->getobsID(), navIn->getNavID());
-         NavDataPtr p0 = std::make_shared<GLOCNavHealth>();
+         NavDataPtr p0 = makeNavData<GLOCNavHealth>();
          key.sat.id = navIn->asUnsignedLong(fsbj, fnbj, fscj);
          p0->timeStamp = navIn->getTransmitTime();
          p0->signal = NavMessageID(key, NavMessageType::Health);
@@ -276,7 +277,7 @@ namespace gnsstk
       {
       //    if (PNBNavDataFactory::processISC)
       //    {
-      //       NavDataPtr p2 = std::make_shared<GLOCNavISC>();
+      //       NavDataPtr p2 = makeNavData<GLOCNavISC>();
       //       GLOCNavISC *isc = dynamic_cast<GLOCNavISC*>(p2.get());
       //       isc->timeStamp = navIn->getTransmitTime();
       //       isc->signal = NavMessageID(key, NavMessageType::ISC);
@@ -336,7 +337,7 @@ namespace gnsstk
          return true;
       }
       DEBUGTRACE("Sufficient data for ephemeris. Proceeding");
-      NavDataPtr p0 = std::make_shared<GLOCNavEph>();
+      NavDataPtr p0 = makeNavData<GLOCNavEph>();
       GLOCNavEph *eph = dynamic_cast<GLOCNavEph*>(p0.get());
       eph->signal = NavMessageID(key, NavMessageType::Ephemeris);
       if (!processHeader(ephS[str10], eph->header))
@@ -452,7 +453,7 @@ namespace gnsstk
             // User doesn't want almanacs so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GLOCNavAlm>();
+      NavDataPtr p0 = makeNavData<GLOCNavAlm>();
       GLOCNavAlm *alm = dynamic_cast<GLOCNavAlm*>(p0.get());
       alm->signal = NavMessageID(key, NavMessageType::Almanac);
       if (!processHeader(navIn, alm->header))
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBGLOFNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "GLOFBits.hpp"
 #include "GLOFNavAlm.hpp"
 #include "GLOFNavEph.hpp"
@@ -152,7 +153,7 @@ namespace gnsstk
       {
          if (PNBNavDataFactory::processISC)
          {
-            NavDataPtr p2 = std::make_shared<GLOFNavISC>();
+            NavDataPtr p2 = makeNavData<GLOFNavISC>();
             GLOFNavISC *isc = dynamic_cast<GLOFNavISC*>(p2.get());
             isc->timeStamp = navIn->getTransmitTime();
             isc->signal = NavMessageID(key, NavMessageType::ISC);
@@ -198,7 +199,7 @@ namespace gnsstk
          /// @todo Maybe make it so we can still get the health w/o strings 1&4
       if (PNBNavDataFactory::processHea)
       {
-         NavDataPtr p1 = std::make_shared<GLOFNavHealth>();
+         NavDataPtr p1 = makeNavData<GLOFNavHealth>();
          p1->timeStamp = navIn->getTransmitTime();
          p1->signal = NavMessageID(key, NavMessageType::Health);
          DEBUGTRACE("Health signal = " << p1->signal);
@@ -211,7 +212,7 @@ namespace gnsstk
       {
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GLOFNavEph>();
+      NavDataPtr p0 = makeNavData<GLOFNavEph>();
       GLOFNavEph *eph = dynamic_cast<GLOFNavEph*>(p0.get());
       eph->timeStamp = ephS[str1]->getTransmitTime();
       eph->signal = NavMessageID(key, NavMessageType::Ephemeris);
@@ -421,7 +422,7 @@ namespace gnsstk
                          almS[almIdx]->getNavID());
       if (PNBNavDataFactory::processHea)
       {
-         NavDataPtr p1 = std::make_shared<GLOFNavHealth>();
+         NavDataPtr p1 = makeNavData<GLOFNavHealth>();
          p1->timeStamp = almS[almIdx]->getTransmitTime();
          p1->signal = NavMessageID(sat, NavMessageType::Health);
          DEBUGTRACE("Health signal = " << p1->signal);
@@ -435,7 +436,7 @@ namespace gnsstk
             // nothing more to do here
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GLOFNavAlm>();
+      NavDataPtr p0 = makeNavData<GLOFNavAlm>();
       GLOFNavAlm *alm = dynamic_cast<GLOFNavAlm*>(p0.get());
       alm->timeStamp = almS[almIdx]->getTransmitTime();
       alm->xmit2 = almS[almIdx+1]->getTransmitTime();
@@ -490,7 +491,7 @@ namespace gnsstk
                          navIn->getobsID(), navIn->getNavID());
       if (PNBNavDataFactory::processHea)
       {
-         NavDataPtr p1 = std::make_shared<GLOFNavHealth>();
+         NavDataPtr p1 = makeNavData<GLOFNavHealth>();
          p1->timeStamp = navIn->getTransmitTime();
          p1->signal = NavMessageID(key, NavMessageType::Health);
          DEBUGTRACE("Health signal = " << p1->signal);
@@ -526,7 +527,7 @@ namespace gnsstk
       }
       if (PNBNavDataFactory::processTim)
       {
-         NavDataPtr p0 = std::make_shared<GLOFNavTimeOffset>();
+         NavDataPtr p0 = makeNavData<GLOFNavTimeOffset>();
          p0->timeStamp = navIn->getTransmitTime();
          p0->signal = NavMessageID(key, NavMessageType::TimeOffset);
          DEBUGTRACE("Time signal = " << p0->signal);
@@ -616,7 +617,7 @@ namespace gnsstk
    PNBGLOFNavDataFactory::TimeMeta ::
    operator NavDataPtr() const
    {
-      NavDataPtr p0 = std::make_shared<GLOFNavUT1TimeOffset>();
+      NavDataPtr p0 = makeNavData<GLOFNavUT1TimeOffset>();
       GLOFNavUT1TimeOffset *to = dynamic_cast<GLOFNavUT1TimeOffset*>(p0.get());
       to->tauc = tauc;
       to->B1 = B1;
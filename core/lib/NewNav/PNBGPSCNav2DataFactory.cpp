@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBGPSCNav2DataFactory.hpp"
+#include "NavDataArena.hpp"
 
 #include <cmath>
 #include <memory>
@@ -124,7 +125,7 @@ namespace gnsstk
       if (processHea)
       {
             // Add ephemeris health bit
-         NavDataPtr p1 = std::make_shared<GPSCNav2Health>();
+         NavDataPtr p1 = makeNavData<GPSCNav2Health>();
          p1->timeStamp = getSF2Time(navIn->getTransmitTime());
          p1->signal = NavMessageID(
             NavSatelliteID(prn, prn, navIn->getsatSys().system,
@@ -142,7 +143,7 @@ namespace gnsstk
             // User doesn't want ephemerides so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNav2Eph>();
+      NavDataPtr p0 = makeNavData<GPSCNav2Eph>();
       GPSCNav2Eph *eph = dynamic_cast<GPSCNav2Eph*>(p0.get());
          // NavData
       eph->timeStamp = getSF2Time(navIn->getTransmitTime());
@@ -272,9 +273,9 @@ namespace gnsstk
       if (processHea)
       {
             // Add almanac health bits from message type 37.
-         NavDataPtr p1L1 = std::make_shared<GPSCNav2Health>();
-         NavDataPtr p1L2 = std::make_shared<GPSCNav2Health>();
-         NavDataPtr p1L5 = std::make_shared<GPSCNav2Health>();
+         NavDataPtr p1L1 = makeNavData<GPSCNav2Health>();
+         NavDataPtr p1L2 = makeNavData<GPSCNav2Health>();
+         NavDataPtr p1L5 = makeNavData<GPSCNav2Health>();
          p1L1->timeStamp =
             p1L2->timeStamp =
             p1L5->timeStamp = getSF3Time(navIn->getTransmitTime());
@@ -319,7 +320,7 @@ namespace gnsstk
             // User doesn't want almanacs so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNav2Alm>();
+      NavDataPtr p0 = makeNavData<GPSCNav2Alm>();
       GPSCNav2Alm *alm = dynamic_cast<GPSCNav2Alm*>(p0.get());
          // NavData
       alm->timeStamp = getSF3Time(navIn->getTransmitTime());
@@ -383,7 +384,7 @@ namespace gnsstk
    {
       if (PNBNavDataFactory::processIono)
       {
-         NavDataPtr p1 = std::make_shared<GPSCNav2Iono>();
+         NavDataPtr p1 = makeNavData<GPSCNav2Iono>();
          GPSCNav2Iono *iono = dynamic_cast<GPSCNav2Iono*>(p1.get());
             // NavData
          p1->timeStamp = getSF3Time(navIn->getTransmitTime());
@@ -416,7 +417,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNav2TimeOffset>();
+      NavDataPtr p0 = makeNavData<GPSCNav2TimeOffset>();
       p0->timeStamp = getSF3Time(navIn->getTransmitTime());
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -456,7 +457,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNav2TimeOffset>();
+      NavDataPtr p0 = makeNavData<GPSCNav2TimeOffset>();
       p0->timeStamp = getSF3Time(navIn->getTransmitTime());
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -516,7 +517,7 @@ namespace gnsstk
 
       for (unsigned prn = 1; prn <= numSVConfs; ++prn)
       {
-         auto configPtr{std::make_shared<GPSNavConfig>()};
+         auto configPtr{makeNavData<GPSNavConfig>()};
          configPtr->timeStamp = getSF3Time(navIn->getTransmitTime());
          configPtr->signal = NavMessageID{
             NavSatelliteID{
@@ -552,7 +553,7 @@ namespace gnsstk
             {
                   // Two sequential subframe 2 with no subframe 3,
                   // publish the previous subframe 2 data.
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             isc->timeStamp = isc->xmit2 = getSF2Time(navIn->getTransmitTime());
             isc->haveSF2 = true;
@@ -563,7 +564,7 @@ namespace gnsstk
             {
                   // We have a complete set of ISCs, so immediately
                   // add it to the output
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             break;
          case nnbSF3:
@@ -584,7 +585,7 @@ namespace gnsstk
             {
                   // We have a complete set of ISCs, so immediately
                   // add it to the output
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             break;
          case nnbComplete:
@@ -592,7 +593,7 @@ namespace gnsstk
             {
                   // Two sequential subframe 2 with no subframe 3,
                   // publish the previous subframe 2 data.
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             isc->timeStamp = getSF3Time(navIn->getTransmitTime());
             isc->xmit2 = getSF2Time(navIn->getTransmitTime());
@@ -607,7 +608,7 @@ namespace gnsstk
                   // We have a complete set of ISCs and the subframe 3
                   // page for the complete message isn't page 1, so
                   // immediately add it to the output
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             else if (navIn->asUnsignedLong(offs+asbPage,anbPage,ascPage) == 1)
             {
@@ -619,7 +620,7 @@ namespace gnsstk
                isc->iscL2C = InterSigCorr::getGPSISC(navIn, offs+csbISCL2C);
                isc->iscL5I5 = InterSigCorr::getGPSISC(navIn, offs+csbISCL5I5);
                isc->iscL5Q5 = InterSigCorr::getGPSISC(navIn, offs+csbISCL5Q5);
-               navOut.push_back(std::make_shared<GPSCNav2ISC>(*isc));
+               navOut.push_back(makeNavData<GPSCNav2ISC>(*isc));
             }
             break;
          default:
@@ -634,7 +635,7 @@ namespace gnsstk
    {
       if (iscAcc.find(nsid) == iscAcc.end())
       {
-         iscAcc[nsid] = std::make_shared<GPSCNav2ISC>();
+         iscAcc[nsid] = makeNavData<GPSCNav2ISC>();
          GPSCNav2ISCPtr &isc(iscAcc[nsid]);
          isc->signal = NavMessageID(nsid, NavMessageType::ISC);
       }
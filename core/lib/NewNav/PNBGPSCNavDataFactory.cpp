@@ -38,6 +38,7 @@
 //==============================================================================
 #include <math.h>
 #include "PNBGPSCNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "GPSCNavAlm.hpp"
 #include "GPSCNavRedAlm.hpp"
 #include "GPSCNavEph.hpp"
@@ -176,9 +177,9 @@ namespace gnsstk
       if ((msgType == 10) && processHea)
       {
             // Add ephemeris health bits from message type 10.
-         NavDataPtr p1L1 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L2 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L5 = std::make_shared<GPSCNavHealth>();
+         NavDataPtr p1L1 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L2 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L5 = makeNavData<GPSCNavHealth>();
          p1L1->timeStamp = navIn->getTransmitTime();
          p1L2->timeStamp = navIn->getTransmitTime();
          p1L5->timeStamp = navIn->getTransmitTime();
@@ -272,7 +273,7 @@ namespace gnsstk
             // consider it as a "valid" but unprocessable data set.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNavEph>();
+      NavDataPtr p0 = makeNavData<GPSCNavEph>();
       GPSCNavEph *eph = dynamic_cast<GPSCNavEph*>(p0.get());
          // NavData
       eph->timeStamp = ephSF[ephM10]->getTransmitTime();
@@ -425,9 +426,9 @@ namespace gnsstk
       if (processHea)
       {
             // Add almanac health bits from message type 37.
-         NavDataPtr p1L1 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L2 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L5 = std::make_shared<GPSCNavHealth>();
+         NavDataPtr p1L1 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L2 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L5 = makeNavData<GPSCNavHealth>();
          p1L1->timeStamp = navIn->getTransmitTime();
          p1L2->timeStamp = navIn->getTransmitTime();
          p1L5->timeStamp = navIn->getTransmitTime();
@@ -486,7 +487,7 @@ namespace gnsstk
             // User doesn't want almanacs so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNavAlm>();
+      NavDataPtr p0 = makeNavData<GPSCNavAlm>();
       GPSCNavAlm *alm = dynamic_cast<GPSCNavAlm*>(p0.get());
          // NavData
       alm->timeStamp = navIn->getTransmitTime();
@@ -579,7 +580,7 @@ namespace gnsstk
    {
       if (PNBNavDataFactory::processIono)
       {
-         NavDataPtr p0 = std::make_shared<GPSCNavIono>();
+         NavDataPtr p0 = makeNavData<GPSCNavIono>();
          GPSCNavIono *iono = dynamic_cast<GPSCNavIono*>(p0.get());
             // NavData
          p0->timeStamp = navIn->getTransmitTime();
@@ -603,7 +604,7 @@ namespace gnsstk
       }
       if (PNBNavDataFactory::processISC)
       {
-         NavDataPtr p1 = std::make_shared<GPSCNavISC>();
+         NavDataPtr p1 = makeNavData<GPSCNavISC>();
          GPSCNavISC *isc = dynamic_cast<GPSCNavISC*>(p1.get());
             // NavData
          p1->timeStamp = navIn->getTransmitTime();
@@ -679,9 +680,9 @@ namespace gnsstk
       if (PNBNavDataFactory::processHea)
       {
             // Add reduced almanac health bits
-         NavDataPtr p1L1 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L2 = std::make_shared<GPSCNavHealth>();
-         NavDataPtr p1L5 = std::make_shared<GPSCNavHealth>();
+         NavDataPtr p1L1 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L2 = makeNavData<GPSCNavHealth>();
+         NavDataPtr p1L5 = makeNavData<GPSCNavHealth>();
          p1L1->timeStamp = navIn->getTransmitTime();
          p1L2->timeStamp = navIn->getTransmitTime();
          p1L5->timeStamp = navIn->getTransmitTime();
@@ -740,7 +741,7 @@ namespace gnsstk
             // User doesn't want almanac data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNavRedAlm>();
+      NavDataPtr p0 = makeNavData<GPSCNavRedAlm>();
       GPSCNavRedAlm *alm = dynamic_cast<GPSCNavRedAlm*>(p0.get());
          // NavData
       alm->timeStamp = navIn->getTransmitTime();
@@ -803,7 +804,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNavTimeOffset>();
+      NavDataPtr p0 = makeNavData<GPSCNavTimeOffset>();
       p0->timeStamp = navIn->getTransmitTime();
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -843,7 +844,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSCNavTimeOffset>();
+      NavDataPtr p0 = makeNavData<GPSCNavTimeOffset>();
       p0->timeStamp = navIn->getTransmitTime();
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
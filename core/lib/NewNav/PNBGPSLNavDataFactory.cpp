@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBGPSLNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 
 #include <memory>
 
@@ -94,16 +95,8 @@ namespace gnsstk
          }
          if (checkParity)
          {
-               /// @todo maybe someday add a parity check to PackedNavBits
-               // Convert the PackedNavBits into 10 30-bit words so we
-               // can use EngNav::checkParity.
-            uint32_t sf[10];
-            for (unsigned i = 0, j = 0; i < 300; i += 30, j++)
-            {
-               sf[j] = navIn->asUnsignedLong(i, 30, 1);
-            }
                /// @todo Are the nav subframes really known to be upright?
-            bool parity = EngNav::checkParity(sf);
+            bool parity = EngNav::checkParity(*navIn);
             if (parity != expParity)
                return true;
          }
@@ -197,7 +190,7 @@ namespace gnsstk
          if (processHea)
          {
                // Add ephemeris health bits from subframe 1.
-            NavDataPtr p1 = std::make_shared<GPSLNavHealth>();
+            NavDataPtr p1 = makeNavData<GPSLNavHealth>();
             p1->timeStamp = navIn->getTransmitTime();
             p1->signal = NavMessageID(key, NavMessageType::Health);
             dynamic_cast<GPSLNavHealth*>(p1.get())->svHealth =
@@ -208,7 +201,7 @@ namespace gnsstk
          if (processISC)
          {
                // Add ephemeris Tgd bits from subframe 1.
-            NavDataPtr p2 = std::make_shared<GPSLNavISC>();
+            NavDataPtr p2 = makeNavData<GPSLNavISC>();
             GPSLNavISC *isc = dynamic_cast<GPSLNavISC*>(p2.get());
             isc->timeStamp = navIn->getTransmitTime();
             isc->signal = NavMessageID(key, NavMessageType::ISC);
@@ -272,7 +265,7 @@ namespace gnsstk
             // consider it as a "valid" but unprocessable data set.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSLNavEph>();
+      NavDataPtr p0 = makeNavData<GPSLNavEph>();
       GPSLNavEph *eph = dynamic_cast<GPSLNavEph*>(p0.get());
          // NavData
       eph->timeStamp = ephSF[sf1]->getTransmitTime();
@@ -399,7 +392,7 @@ namespace gnsstk
       if (processHea)
       {
             // Add almanac orbit page health bits.
-         NavDataPtr p1 = std::make_shared<GPSLNavHealth>();
+         NavDataPtr p1 = makeNavData<GPSLNavHealth>();
          p1->timeStamp = navIn->getTransmitTime();
          p1->signal = NavMessageID(sat, NavMessageType::Health);
          dynamic_cast<GPSLNavHealth*>(p1.get())->svHealth =
@@ -415,7 +408,7 @@ namespace gnsstk
          // SVID 1-32 contain the almanac orbital elements as well as
          // health information (Figure 20-1 sheet 4), so we'll end up
          // returning two items in navOut.
-      NavDataPtr p0 = std::make_shared<GPSLNavAlm>();
+      NavDataPtr p0 = makeNavData<GPSLNavAlm>();
       p0->timeStamp = navIn->getTransmitTime();
       p0->signal = NavMessageID(sat, NavMessageType::Almanac);
       GPSLNavAlm *alm = dynamic_cast<GPSLNavAlm*>(p0.get());
@@ -560,10 +553,10 @@ namespace gnsstk
       for (unsigned prn = startPRN, bit = 90; prn <= endPRN;
            prn += 4, bit += 30)
       {
-         NavDataPtr p1 = std::make_shared<GPSLNavHealth>();
-         NavDataPtr p2 = std::make_shared<GPSLNavHealth>();
-         NavDataPtr p3 = std::make_shared<GPSLNavHealth>();
-         NavDataPtr p4 = std::make_shared<GPSLNavHealth>();
+         NavDataPtr p1 = makeNavData<GPSLNavHealth>();
+         NavDataPtr p2 = makeNavData<GPSLNavHealth>();
+         NavDataPtr p3 = makeNavData<GPSLNavHealth>();
+         NavDataPtr p4 = makeNavData<GPSLNavHealth>();
          p1->timeStamp = navIn->getTransmitTime();
          p1->signal = NavMessageID(
             NavSatelliteID(prn+0, xmitSat, oid, navid),
@@ -631,7 +624,7 @@ namespace gnsstk
             const unsigned word{((prn + 1) / 6) + 2}; // zero-indexed
             const unsigned bitInWord{((prn + 1) % 6) * 4}; // counting from MSB
 
-            auto configPtr{std::make_shared<GPSNavConfig>()};
+            auto configPtr{makeNavData<GPSNavConfig>()};
             configPtr->timeStamp = navIn->getTransmitTime();
             configPtr->signal = NavMessageID{
                NavSatelliteID{prn, xmitSat, oid, navid},
@@ -654,7 +647,7 @@ namespace gnsstk
             const unsigned word{((prn + 2) / 4) + 1}; // zero-indexed
             const unsigned bitInWord{((prn + 2) % 4) * 6}; // counting from MSB
 
-            auto healthPtr{std::make_shared<GPSLNavHealth>()};
+            auto healthPtr{makeNavData<GPSLNavHealth>()};
             healthPtr->timeStamp = navIn->getTransmitTime();
             healthPtr->signal = NavMessageID{
                NavSatelliteID{prn, xmitSat, oid, navid},
@@ -678,7 +671,7 @@ namespace gnsstk
          // svid 56 = sf 4 page 18.
       if (PNBNavDataFactory::processIono)
       {
-         NavDataPtr p1 = std::make_shared<GPSLNavIono>();
+         NavDataPtr p1 = makeNavData<GPSLNavIono>();
          p1->timeStamp = navIn->getTransmitTime();
          p1->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -709,7 +702,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GPSLNavTimeOffset>();
+      NavDataPtr p0 = makeNavData<GPSLNavTimeOffset>();
       p0->timeStamp = navIn->getTransmitTime();
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "PNBGalFNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "GalFNavEph.hpp"
 #include "GalFNavTimeOffset.hpp"
 #include "GalFNavIono.hpp"
@@ -47,6 +48,7 @@
 #include "EngNav.hpp"
 #include "TimeString.hpp"
 #include "GalFBits.hpp"
+#include "CRC24Q.hpp"
 
 using namespace std;
 using namespace gnsstk::galfnav;
@@ -65,9 +67,27 @@ namespace gnsstk
       bool rv = true;
       try
       {
+            // The CRC covers the page type and data, and can only be
+            // checked if navIn contains it.
+         bool checkCRC = false, expCRC = false;
+         switch (navValidity)
+         {
+            case NavValidityType::ValidOnly:
+               checkCRC = true;
+               expCRC = true;
+               break;
+            case NavValidityType::InvalidOnly:
+               checkCRC = true;
+               expCRC = false;
+               break;
+         }
+         if (checkCRC && (navIn->getNumBits() >= fsbCRC+fnbCRC) &&
+             (CRC24Q::check(*navIn, 0, fsbCRC+fnbCRC) != expCRC))
+         {
+            return true;
+         }
          unsigned long pageType = navIn->asUnsignedLong(
             fsbType,fnbType,fscType);
-            /// @todo implement validity checks if there are any.
          switch (pageType)
          {
                /** @note While the ICD doesn't label page type 1 as
@@ -143,7 +163,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processIono)
          {
                // Add iono data from word type 5
-            NavDataPtr p2 = std::make_shared<GalFNavIono>();
+            NavDataPtr p2 = makeNavData<GalFNavIono>();
             GalFNavIono *ip2 = dynamic_cast<GalFNavIono*>(p2.get());
             ip2->timeStamp = navIn->getTransmitTime();
             ip2->signal = NavMessageID(key, NavMessageType::Iono);
@@ -160,7 +180,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processHea)
          {
                // Add health bits from page type 1.
-            NavDataPtr p1 = std::make_shared<GalFNavHealth>();
+            NavDataPtr p1 = makeNavData<GalFNavHealth>();
             GalFNavHealth *hp1 = dynamic_cast<GalFNavHealth*>(p1.get());
             hp1->timeStamp = navIn->getTransmitTime();
             hp1->signal = NavMessageID(key, NavMessageType::Health);
@@ -178,7 +198,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processISC)
          {
                // Add ISC data from page type 1.
-            NavDataPtr p4 = std::make_shared<GalFNavISC>();
+            NavDataPtr p4 = makeNavData<GalFNavISC>();
             p4->timeStamp = navIn->getTransmitTime();
             p4->signal = NavMessageID(
                NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -192,7 +212,7 @@ namespace gnsstk
       else if ((pageType == 4) && PNBNavDataFactory::processTim)
       {
             // GST-UTC offset
-         NavDataPtr p3 = std::make_shared<GalFNavTimeOffset>();
+         NavDataPtr p3 = makeNavData<GalFNavTimeOffset>();
          p3->timeStamp = navIn->getTransmitTime();
          p3->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -218,7 +238,7 @@ namespace gnsstk
          // cerr << "gws.week=" << gws.week << "  gws.sow=" << gws.sow << "  refTime=" << to->refTime << endl;
          navOut.push_back(p3);
             // GST-GPS offset
-         p3 = std::make_shared<GalFNavTimeOffset>();
+         p3 = makeNavData<GalFNavTimeOffset>();
          p3->timeStamp = navIn->getTransmitTime();
          p3->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -279,7 +299,7 @@ namespace gnsstk
             // consider it as a "valid" but unprocessable data set.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GalFNavEph>();
+      NavDataPtr p0 = makeNavData<GalFNavEph>();
       GalFNavEph *eph = dynamic_cast<GalFNavEph*>(p0.get());
          // NavData
       eph->timeStamp = ephPage[pt1]->getTransmitTime();
@@ -414,8 +434,8 @@ namespace gnsstk
          // OMEGA0 is split in SV(SVID2) but not in SVID1 or SVID3 so
          // we process it separately.
          // SVID1
-      NavDataPtr p0 = std::make_shared<GalFNavAlm>();
-      NavDataPtr p1 = std::make_shared<GalFNavHealth>();
+      NavDataPtr p0 = makeNavData<GalFNavAlm>();
+      NavDataPtr p1 = makeNavData<GalFNavHealth>();
       GalFNavAlm *alm = dynamic_cast<GalFNavAlm*>(p0.get());
       GalFNavHealth *hp1 = dynamic_cast<GalFNavHealth*>(p1.get());
       if (processAlmOrb(almPage, alm, hp1,  pt5, pt5, asiSVID_1, asbSVID_1,
@@ -440,8 +460,8 @@ namespace gnsstk
          }
       }
          // SVID2
-      p0 = std::make_shared<GalFNavAlm>();
-      p1 = std::make_shared<GalFNavHealth>();
+      p0 = makeNavData<GalFNavAlm>();
+      p1 = makeNavData<GalFNavHealth>();
       alm = dynamic_cast<GalFNavAlm*>(p0.get());
       hp1 = dynamic_cast<GalFNavHealth*>(p1.get());
       if (processAlmOrb(almPage, alm, hp1,  pt5, pt6, asiSVID_2, asbSVID_2,
@@ -479,8 +499,8 @@ namespace gnsstk
          }
       }
          // SVID3
-      p0 = std::make_shared<GalFNavAlm>();
-      p1 = std::make_shared<GalFNavHealth>();
+      p0 = makeNavData<GalFNavAlm>();
+      p1 = makeNavData<GalFNavHealth>();
       alm = dynamic_cast<GalFNavAlm*>(p0.get());
       hp1 = dynamic_cast<GalFNavHealth*>(p1.get());
       if (processAlmOrb(almPage, alm, hp1,  pt6, pt6, asiSVID_3, asbSVID_3,
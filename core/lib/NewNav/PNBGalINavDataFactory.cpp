@@ -39,6 +39,7 @@
 #include <memory>
 
 #include "PNBGalINavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "GalINavEph.hpp"
 #include "GalINavTimeOffset.hpp"
 #include "GalINavIono.hpp"
@@ -48,6 +49,7 @@
 #include "EngNav.hpp"
 #include "TimeString.hpp"
 #include "GalIBits.hpp"
+#include "CRC24Q.hpp"
 
 using namespace std;
 using namespace gnsstk::galinav;
@@ -70,6 +72,24 @@ namespace gnsstk
          // extract the data word.
       if (navFlex->getNumBits() == 240)
       {
+            // Only page pairs contain the CRC, so the validity
+            // filter can't be applied to bare data words.
+         bool checkCRC = false, expCRC = false;
+         switch (navValidity)
+         {
+            case NavValidityType::ValidOnly:
+               checkCRC = true;
+               expCRC = true;
+               break;
+            case NavValidityType::InvalidOnly:
+               checkCRC = true;
+               expCRC = false;
+               break;
+         }
+         if (checkCRC && (checkPagePairCRC(*navIn) != expCRC))
+         {
+            return true;
+         }
          navFlex->reset_num_bits(0);
          if(!wordFromPagePair(*navIn, *navFlex))
          {
@@ -186,6 +206,24 @@ namespace gnsstk
    }
 
 
+   bool PNBGalINavDataFactory ::
+   checkPagePairCRC(const PackedNavBits& navIn)
+   {
+         // The CRC covers the first 114 bits of the even page
+         // followed by the first 82 bits of the odd page, and is
+         // stored in the 24 bits after that in the odd page.
+      unsigned evenStart = 0, oddStart = 120;
+      if (navIn.asUnsignedLong(0,1,1) != 0)
+      {
+         std::swap(evenStart, oddStart);
+      }
+      CRC24Q crc;
+      crc.process(navIn, evenStart, 114);
+      crc.process(navIn, oddStart, 106);
+      return crc.checksum() == 0;
+   }
+
+
    bool PNBGalINavDataFactory ::
    processEph(unsigned wordType, const PackedNavBitsPtr& navIn,
               NavDataPtrList& navOut)
@@ -216,7 +254,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processIono)
          {
                // Add iono data from word type 5
-            NavDataPtr p3 = std::make_shared<GalINavIono>();
+            NavDataPtr p3 = makeNavData<GalINavIono>();
             GalINavIono *ip3 = dynamic_cast<GalINavIono*>(p3.get());
             ip3->timeStamp = navIn->getTransmitTime();
             ip3->signal = NavMessageID(key, NavMessageType::Iono);
@@ -233,7 +271,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processISC)
          {
                // Add ISC data from word type 5
-            NavDataPtr p4 = std::make_shared<GalINavISC>();
+            NavDataPtr p4 = makeNavData<GalINavISC>();
             GalINavISC *ip4 = dynamic_cast<GalINavISC*>(p4.get());
             ip4->timeStamp = navIn->getTransmitTime();
             ip4->signal = NavMessageID(key, NavMessageType::ISC);
@@ -247,7 +285,7 @@ namespace gnsstk
          if (PNBNavDataFactory::processHea && ephWord[wt3])
          {
                // Add health bits from word type 5.
-            NavDataPtr p1 = std::make_shared<GalINavHealth>();
+            NavDataPtr p1 = makeNavData<GalINavHealth>();
             GalINavHealth *hp1 = dynamic_cast<GalINavHealth*>(p1.get());
             hp1->timeStamp = navIn->getTransmitTime();
             hp1->signal = NavMessageID(key, NavMessageType::Health);
@@ -260,7 +298,7 @@ namespace gnsstk
                   isbE5bdvs,inbE5bdvs,iscE5bdvs));
             hp1->sisaIndex = ephWord[esiSISA]->asUnsignedLong(esbSISA,enbSISA,
                                                               escSISA);
-            NavDataPtr p2 = std::make_shared<GalINavHealth>();
+            NavDataPtr p2 = makeNavData<GalINavHealth>();
             GalINavHealth *hp2 = dynamic_cast<GalINavHealth*>(p2.get());
             *hp2 = *hp1; // copy data
             hp2->signal.obs.band = CarrierBand::L1;
@@ -321,7 +359,7 @@ namespace gnsstk
             // consider it as a "valid" but unprocessable data set.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GalINavEph>();
+      NavDataPtr p0 = makeNavData<GalINavEph>();
       GalINavEph *eph = dynamic_cast<GalINavEph*>(p0.get());
          // NavData
       eph->timeStamp = ephWord[wt1]->getTransmitTime();
@@ -441,7 +479,7 @@ namespace gnsstk
       almWord[wordType-7] = navIn;
       if ((wordType == 10) && PNBNavDataFactory::processTim)
       {
-         NavDataPtr p3 = std::make_shared<GalINavTimeOffset>();
+         NavDataPtr p3 = makeNavData<GalINavTimeOffset>();
          p3->timeStamp = navIn->getTransmitTime();
          p3->signal = NavMessageID(
             NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
@@ -497,9 +535,9 @@ namespace gnsstk
          return true;
       }
          // SVID1
-      NavDataPtr p0 = std::make_shared<GalINavAlm>();
-      NavDataPtr p1 = std::make_shared<GalINavHealth>();
-      NavDataPtr p2 = std::make_shared<GalINavHealth>();
+      NavDataPtr p0 = makeNavData<GalINavAlm>();
+      NavDataPtr p1 = makeNavData<GalINavHealth>();
+      NavDataPtr p2 = makeNavData<GalINavHealth>();
       GalINavAlm *alm = dynamic_cast<GalINavAlm*>(p0.get());
       GalINavHealth *hp1 = dynamic_cast<GalINavHealth*>(p1.get());
       GalINavHealth *hp2 = dynamic_cast<GalINavHealth*>(p2.get());
@@ -525,9 +563,9 @@ namespace gnsstk
          }
       }
          // SVID2
-      p0 = std::make_shared<GalINavAlm>();
-      p1 = std::make_shared<GalINavHealth>();
-      p2 = std::make_shared<GalINavHealth>();
+      p0 = makeNavData<GalINavAlm>();
+      p1 = makeNavData<GalINavHealth>();
+      p2 = makeNavData<GalINavHealth>();
       alm = dynamic_cast<GalINavAlm*>(p0.get());
       hp1 = dynamic_cast<GalINavHealth*>(p1.get());
       hp2 = dynamic_cast<GalINavHealth*>(p2.get());
@@ -553,9 +591,9 @@ namespace gnsstk
          }
       }
          // SVID3
-      p0 = std::make_shared<GalINavAlm>();
-      p1 = std::make_shared<GalINavHealth>();
-      p2 = std::make_shared<GalINavHealth>();
+      p0 = makeNavData<GalINavAlm>();
+      p1 = makeNavData<GalINavHealth>();
+      p2 = makeNavData<GalINavHealth>();
       alm = dynamic_cast<GalINavAlm*>(p0.get());
       hp1 = dynamic_cast<GalINavHealth*>(p1.get());
       hp2 = dynamic_cast<GalINavHealth*>(p2.get());
@@ -686,7 +724,7 @@ namespace gnsstk
             // User doesn't want time offset data so don't do any processing.
          return true;
       }
-      NavDataPtr p0 = std::make_shared<GalINavTimeOffset>();
+      NavDataPtr p0 = makeNavData<GalINavTimeOffset>();
       p0->timeStamp = navIn->getTransmitTime();
       p0->signal = NavMessageID(
          NavSatelliteID(navIn->getsatSys().id, navIn->getsatSys(),
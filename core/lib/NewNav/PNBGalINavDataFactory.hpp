@@ -84,6 +84,12 @@ namespace gnsstk
       static bool wordFromPagePair(const PackedNavBits& navIn,
                                    PackedNavBits& navOut);
 
+         /** Check the CRC-24Q of a nominal page pair.
+          * @param[in] navIn An even and odd page pair of 240 bits in
+          *   either order, as accepted by wordFromPagePair().
+          * @return true if the CRC matches. */
+      static bool checkPagePairCRC(const PackedNavBits& navIn);
+
          /** Process word types 1-5.  When a complete ephemeris of
           * word types 1,2,3,4,5 and consistent IODnav are accumulated
           * in ephAcc, that ephemeris is placed in navOut, along with
@@ -37,6 +37,15 @@
 //
 //==============================================================================
 #include "PNBMultiGNSSNavDataFactory.hpp"
+#include "PNBGPSLNavDataFactory.hpp"
+#include "PNBGPSCNavDataFactory.hpp"
+#include "PNBGPSCNav2DataFactory.hpp"
+#include "PNBGalINavDataFactory.hpp"
+#include "PNBGalFNavDataFactory.hpp"
+#include "PNBBDSD1NavDataFactory.hpp"
+#include "PNBBDSD2NavDataFactory.hpp"
+#include "PNBGLOFNavDataFactory.hpp"
+#include "PNBGLOCNavDataFactory.hpp"
 #include "DebugTrace.hpp"
 
 namespace gnsstk
@@ -49,6 +58,14 @@ namespace gnsstk
    }
 
 
+   PNBMultiGNSSNavDataFactory ::
+   PNBMultiGNSSNavDataFactory(
+      const std::shared_ptr<PNBNavDataFactoryMap>& facts)
+         : myFactories(facts)
+   {
+   }
+
+
    void PNBMultiGNSSNavDataFactory ::
    setValidityFilter(NavValidityType nvt)
    {
@@ -105,6 +122,25 @@ namespace gnsstk
    }
 
 
+   std::shared_ptr<PNBNavDataFactoryMap> PNBMultiGNSSNavDataFactory ::
+   newFactories()
+   {
+      std::shared_ptr<PNBNavDataFactoryMap> rv =
+         std::make_shared<PNBNavDataFactoryMap>();
+      (*rv)[NavType::GPSLNAV] = std::make_shared<PNBGPSLNavDataFactory>();
+      (*rv)[NavType::GPSCNAVL2] = std::make_shared<PNBGPSCNavDataFactory>();
+      (*rv)[NavType::GPSCNAVL5] = std::make_shared<PNBGPSCNavDataFactory>();
+      (*rv)[NavType::GPSCNAV2] = std::make_shared<PNBGPSCNav2DataFactory>();
+      (*rv)[NavType::GalINAV] = std::make_shared<PNBGalINavDataFactory>();
+      (*rv)[NavType::GalFNAV] = std::make_shared<PNBGalFNavDataFactory>();
+      (*rv)[NavType::BeiDou_D1] = std::make_shared<PNBBDSD1NavDataFactory>();
+      (*rv)[NavType::BeiDou_D2] = std::make_shared<PNBBDSD2NavDataFactory>();
+      (*rv)[NavType::GloCivilF] = std::make_shared<PNBGLOFNavDataFactory>();
+      (*rv)[NavType::GloCivilC] = std::make_shared<PNBGLOCNavDataFactory>();
+      return rv;
+   }
+
+
    void PNBMultiGNSSNavDataFactory ::
    resetState()
    {
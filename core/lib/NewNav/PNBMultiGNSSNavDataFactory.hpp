@@ -69,6 +69,15 @@ namespace gnsstk
          /// Initialize myFactories.
       PNBMultiGNSSNavDataFactory();
 
+         /** Initialize myFactories with a set of factories that is
+          * not shared with other PNBMultiGNSSNavDataFactory objects,
+          * e.g. one returned by newFactories().  The filter settings
+          * and state of such an object are then independent of all
+          * others.
+          * @param[in] facts The factories to use. */
+      explicit PNBMultiGNSSNavDataFactory(
+         const std::shared_ptr<PNBNavDataFactoryMap>& facts);
+
          /** Set the factories' handling of valid and invalid
           * navigation data.  This should be called before any addData()
           * calls.
@@ -110,6 +119,13 @@ namespace gnsstk
           */
       static bool addFactory(NavType navType, PNBNavDataFactoryPtr& fact);
 
+         /** Create a new instance of each of the gnsstk
+          * PNBNavDataFactory classes.  This is the set of factories
+          * that is added to the shared map at start-up.  Factories
+          * added by the user through addFactory() are not included.
+          * @return A new map of new factories. */
+      static std::shared_ptr<PNBNavDataFactoryMap> newFactories();
+
          /** Reset the state of the data accumulator.  Most
           * PNBNavDataFactory child classes will maintain some state
           * to assemble data prior to processing.  This method is
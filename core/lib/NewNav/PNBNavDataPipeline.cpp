@@ -0,0 +1,291 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include "PNBNavDataPipeline.hpp"
+#include "PNBMultiGNSSNavDataFactory.hpp"
+
+namespace gnsstk
+{
+   PNBNavDataPipeline ::
+   PNBNavDataPipeline(NavDataFactoryCallback& cb, unsigned numThreads,
+                      const FactoryCreator& creator)
+         : callback(cb), firstSeq(0), stopping(false), ok(true)
+   {
+      FactoryCreator create(creator);
+      if (!create)
+      {
+         create = []()
+         {
+            return std::make_shared<PNBMultiGNSSNavDataFactory>(
+               PNBMultiGNSSNavDataFactory::newFactories());
+         };
+      }
+      if (numThreads == 0)
+      {
+         numThreads = std::max(1u, std::thread::hardware_concurrency());
+      }
+         // Enough to keep the workers busy without letting the
+         // results of a stalled satellite pile up indefinitely.
+      maxPending = 1024 * numThreads;
+      if (numThreads == 1)
+      {
+         localFact = create();
+         return;
+      }
+      for (unsigned t = 0; t < numThreads; t++)
+      {
+         workers.push_back(std::unique_ptr<Worker>(new Worker));
+         workers.back()->fact = create();
+      }
+      for (auto& w : workers)
+      {
+         w->thread = std::thread(&PNBNavDataPipeline::run, this,
+                                 std::ref(*w));
+      }
+   }
+
+
+   PNBNavDataPipeline ::
+   ~PNBNavDataPipeline()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         stopping = true;
+      }
+      for (auto& w : workers)
+      {
+         w->jobReady.notify_one();
+      }
+      for (auto& w : workers)
+      {
+         w->thread.join();
+      }
+   }
+
+
+   void PNBNavDataPipeline ::
+   setValidityFilter(NavValidityType nvt)
+   {
+      deliver(0);
+      if (localFact)
+      {
+         localFact->setValidityFilter(nvt);
+      }
+      for (auto& w : workers)
+      {
+         w->fact->setValidityFilter(nvt);
+      }
+   }
+
+
+   void PNBNavDataPipeline ::
+   setTypeFilter(const NavMessageTypeSet& nmts)
+   {
+      deliver(0);
+      if (localFact)
+      {
+         localFact->setTypeFilter(nmts);
+      }
+      for (auto& w : workers)
+      {
+         w->fact->setTypeFilter(nmts);
+      }
+   }
+
+
+   void PNBNavDataPipeline ::
+   setControl(const FactoryControl& ctrl)
+   {
+      deliver(0);
+      if (localFact)
+      {
+         localFact->setControl(ctrl);
+      }
+      for (auto& w : workers)
+      {
+         w->fact->setControl(ctrl);
+      }
+   }
+
+
+   void PNBNavDataPipeline ::
+   resetState()
+   {
+      deliver(0);
+      if (localFact)
+      {
+         localFact->resetState();
+      }
+      for (auto& w : workers)
+      {
+         w->fact->resetState();
+      }
+   }
+
+
+   bool PNBNavDataPipeline ::
+   addData(const PackedNavBitsPtr& navIn, double cadence)
+   {
+      if (localFact)
+      {
+         NavDataPtrList navOut;
+         if (!localFact->addData(navIn, navOut, cadence))
+         {
+            ok = false;
+         }
+         for (const auto& ndp : navOut)
+         {
+            if (!callback.process(ndp))
+            {
+               ok = false;
+            }
+         }
+         return ok;
+      }
+      Worker& w(pickWorker(navIn));
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         Job job;
+         job.seq = firstSeq + results.size();
+         job.navIn = navIn;
+         job.cadence = cadence;
+         results.push_back(Result());
+         w.jobs.push_back(job);
+      }
+      w.jobReady.notify_one();
+      deliver(maxPending);
+      return ok;
+   }
+
+
+   bool PNBNavDataPipeline ::
+   flush()
+   {
+      deliver(0);
+      bool rv = ok;
+      ok = true;
+      return rv;
+   }
+
+
+   void PNBNavDataPipeline ::
+   run(Worker& w)
+   {
+      std::unique_lock<std::mutex> lock(mtx);
+      while (true)
+      {
+         w.jobReady.wait(lock,
+                         [&]() { return stopping || !w.jobs.empty(); });
+         if (stopping)
+         {
+            return;
+         }
+         Job job(w.jobs.front());
+         w.jobs.pop_front();
+         lock.unlock();
+         Result res;
+         try
+         {
+            res.rv = w.fact->addData(job.navIn, res.navOut, job.cadence);
+         }
+         catch (...)
+         {
+            res.exc = std::current_exception();
+         }
+         res.done = true;
+         lock.lock();
+         Result& slot(results[job.seq - firstSeq]);
+         slot = std::move(res);
+         if (job.seq == firstSeq)
+         {
+               // Only the oldest result can be delivered.
+            resultReady.notify_one();
+         }
+      }
+   }
+
+
+   void PNBNavDataPipeline ::
+   deliver(size_t maxLeft)
+   {
+      while (true)
+      {
+         Result res;
+         {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (results.size() > maxLeft)
+            {
+               resultReady.wait(lock,
+                                [this]() { return results.front().done; });
+            }
+            if (results.empty() || !results.front().done)
+            {
+               return;
+            }
+            res = std::move(results.front());
+            results.pop_front();
+            firstSeq++;
+         }
+         if (res.exc)
+         {
+            std::rethrow_exception(res.exc);
+         }
+         if (!res.rv)
+         {
+            ok = false;
+         }
+         for (const auto& ndp : res.navOut)
+         {
+            if (!callback.process(ndp))
+            {
+               ok = false;
+            }
+         }
+      }
+   }
+
+
+   PNBNavDataPipeline::Worker& PNBNavDataPipeline ::
+   pickWorker(const PackedNavBitsPtr& navIn)
+   {
+      SatID sat(navIn->getsatSys());
+      size_t key = static_cast<size_t>(sat.system) * 1024 + sat.id;
+      return *workers[key % workers.size()];
+   }
+}
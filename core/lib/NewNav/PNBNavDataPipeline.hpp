@@ -0,0 +1,240 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_PNBNAVDATAPIPELINE_HPP
+#define GNSSTK_PNBNAVDATAPIPELINE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PNBNavDataFactory.hpp"
+#include "NavDataFactoryCallback.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Decode PackedNavBits objects using a pool of worker threads.
+       * Each worker has its own set of PNBNavDataFactory objects,
+       * and each message is given to a worker chosen by its
+       * transmitting satellite.  Messages from a given satellite are
+       * therefore always decoded by the same factories, in the order
+       * in which they were added, so subframe and page assembly
+       * behave just as they would for a single factory.
+       *
+       * The NavData objects produced are given to the
+       * NavDataFactoryCallback on the thread calling addData() and
+       * flush(), in input order.  That is, everything produced by a
+       * given message is delivered, in the order the factory
+       * produced it, after everything produced by messages added
+       * before it.  The output is thus the same regardless of the
+       * number of threads.
+       *
+       * @code
+       * NavDataPtrList navOut;
+       * NavDataFactoryListCallback cb(navOut);
+       * PNBNavDataPipeline pipe(cb);
+       * pipe.setTypeFilter({NavMessageType::Ephemeris});
+       * while (getMoreData(pnb))
+       *    pipe.addData(pnb);
+       * pipe.flush();
+       * @endcode
+       *
+       * @note The methods of this class must all be called from the
+       *   same thread.
+       * @note Messages whose output depends on messages from other
+       *   satellites (none of the gnsstk factories do this) will not
+       *   be decoded correctly. */
+   class PNBNavDataPipeline
+   {
+   public:
+         /// Function that creates a new factory for a worker.
+      typedef std::function<PNBNavDataFactoryPtr()> FactoryCreator;
+
+         /** Start the worker threads.
+          * @param[in] cb The callback to give decoded data to.
+          * @param[in] numThreads The number of worker threads to
+          *   use, where 0 means to use one per processor.  If 1,
+          *   messages are decoded by addData() with no worker
+          *   threads.
+          * @param[in] creator The function used to create each
+          *   worker's factory.  If empty, each worker uses a
+          *   PNBMultiGNSSNavDataFactory with its own
+          *   PNBMultiGNSSNavDataFactory::newFactories(). */
+      PNBNavDataPipeline(NavDataFactoryCallback& cb,
+                         unsigned numThreads = 0,
+                         const FactoryCreator& creator = FactoryCreator());
+
+         /// Stop the worker threads, discarding any undelivered data.
+      ~PNBNavDataPipeline();
+
+         /** Set every worker factory's handling of valid and invalid
+          * navigation data.  Any data already added is flushed first.
+          * @param[in] nvt The new nav data loading filter method. */
+      void setValidityFilter(NavValidityType nvt);
+
+         /** Indicate what nav message types the worker factories
+          * should be loading.  Any data already added is flushed
+          * first.
+          * @param[in] nmts The set of nav message types to be
+          *   processed by the factories. */
+      void setTypeFilter(const NavMessageTypeSet& nmts);
+
+         /** Set the configuration parameters for every worker
+          * factory.  Any data already added is flushed first.
+          * @param[in] ctrl The configuration for the factories. */
+      void setControl(const FactoryControl& ctrl);
+
+         /** Reset the state of every worker factory's data
+          * accumulator.  Any data already added is flushed first.
+          * @see PNBNavDataFactory::resetState() */
+      void resetState();
+
+         /** Queue a PackedNavBits object for decoding.  Any data
+          * that is ready is given to the callback before returning.
+          * If too many messages are waiting to be decoded, this
+          * waits until some have been.
+          * @param[in] navIn The PackedNavBits data to process.
+          * @param[in] cadence The data rate of the navigation
+          *   messages being processed.
+          *   @see PNBNavDataFactory::addData()
+          * @return false if the decoding of any earlier message
+          *   failed, or if the callback returned false.
+          * @throw Any exception thrown by a worker factory for an
+          *   earlier message.  @see flush() */
+      bool addData(const PackedNavBitsPtr& navIn, double cadence = -1);
+
+         /** Wait for all of the messages added so far to be decoded
+          * and give the results to the callback.
+          * @return false if the decoding of any of the messages
+          *   failed, or if the callback returned false.  The error
+          *   state is cleared afterwards.
+          * @throw Any exception thrown by a worker factory, after
+          *   delivering the data of the messages added before the
+          *   one that caused it. */
+      bool flush();
+
+         /// Return the number of worker threads (0 if none).
+      unsigned getNumThreads() const
+      { return workers.size(); }
+
+   private:
+         /// A message waiting to be decoded.
+      struct Job
+      {
+            /// Index of the result in results.
+         unsigned long seq;
+            /// The message to decode.
+         PackedNavBitsPtr navIn;
+            /// The cadence to give to addData().
+         double cadence;
+      };
+
+         /// The outcome of decoding one message.
+      struct Result
+      {
+         Result()
+               : done(false), rv(false)
+         {}
+            /// True once the worker has finished with the message.
+         bool done;
+            /// The return value of addData().
+         bool rv;
+            /// The data produced.
+         NavDataPtrList navOut;
+            /// Any exception thrown by addData().
+         std::exception_ptr exc;
+      };
+
+         /// A worker thread, its factory and its queue.
+      struct Worker
+      {
+            /// The factory that decodes this worker's messages.
+         PNBNavDataFactoryPtr fact;
+            /// Messages waiting to be decoded, guarded by mtx.
+         std::deque<Job> jobs;
+            /// Signalled when a job is queued or stopping is set.
+         std::condition_variable jobReady;
+            /// The thread running run().
+         std::thread thread;
+      };
+
+         /// Decode messages for one worker until told to stop.
+      void run(Worker& w);
+
+         /** Give completed results to the callback, in order.
+          * @param[in] maxLeft Wait for results until no more than
+          *   this many remain undelivered. */
+      void deliver(size_t maxLeft);
+
+         /// Pick the worker to decode a message.
+      Worker& pickWorker(const PackedNavBitsPtr& navIn);
+
+         /// Where the decoded data goes.
+      NavDataFactoryCallback& callback;
+         /// The workers.  Empty if decoding is done in addData().
+      std::vector<std::unique_ptr<Worker> > workers;
+         /// The factory used when there are no worker threads.
+      PNBNavDataFactoryPtr localFact;
+         /// Guards jobs, results and stopping.
+      std::mutex mtx;
+         /// Signalled when a result is done.
+      std::condition_variable resultReady;
+         /// Results, indexed by Job::seq - firstSeq.
+      std::deque<Result> results;
+         /// Sequence number of results.front().
+      unsigned long firstSeq;
+         /// Set to stop the workers.
+      bool stopping;
+         /// Cleared when an addData() or callback fails.
+      bool ok;
+         /// The most results that may be outstanding before blocking.
+      size_t maxPending;
+   }; // class PNBNavDataPipeline
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_PNBNAVDATAPIPELINE_HPP
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "RinexNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "Rinex3NavStream.hpp"
 #include "Rinex3NavHeader.hpp"
 #include "GPSLNavHealth.hpp"
@@ -148,6 +149,8 @@ namespace gnsstk
          Rinex3NavData data;
          if (!is)
             return false;
+            // read the lines in place, see FactoryControl::mapFiles
+         is.bufferInput(factControl.mapFiles);
          is >> head;
          if (processTim)
          {
@@ -336,7 +339,7 @@ namespace gnsstk
       {
          case SatelliteSystem::GPS:
          case SatelliteSystem::QZSS:
-            navOut = std::make_shared<GPSLNavEph>();
+            navOut = makeNavData<GPSLNavEph>();
             gps = dynamic_cast<GPSLNavEph*>(navOut.get());
                // NavData
             fillNavData(navIn, navOut);
@@ -375,7 +378,7 @@ namespace gnsstk
             if (((navIn.datasources & 0x01) == 0x01) ||
                 ((navIn.datasources & 0x04) == 0x04))
             {
-               navOut = std::make_shared<GalINavEph>();
+               navOut = makeNavData<GalINavEph>();
                galINav = dynamic_cast<GalINavEph*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
@@ -425,7 +428,7 @@ namespace gnsstk
             }
             else if (navIn.datasources & 0x02)
             {
-               navOut = std::make_shared<GalFNavEph>();
+               navOut = makeNavData<GalFNavEph>();
                galFNav = dynamic_cast<GalFNavEph*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
@@ -469,7 +472,7 @@ namespace gnsstk
          case SatelliteSystem::BeiDou:
             if (isBeiDouGEO(navIn.sat))
             {
-               navOut = std::make_shared<BDSD2NavEph>();
+               navOut = makeNavData<BDSD2NavEph>();
                bdsD2Nav = dynamic_cast<BDSD2NavEph*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
@@ -499,7 +502,7 @@ namespace gnsstk
             }
             else
             {
-               navOut = std::make_shared<BDSD1NavEph>();
+               navOut = makeNavData<BDSD1NavEph>();
                bdsD1Nav = dynamic_cast<BDSD1NavEph*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
@@ -533,7 +536,7 @@ namespace gnsstk
             }
             break;
          case SatelliteSystem::Glonass:
-            navOut = std::make_shared<GLOFNavEph>();
+            navOut = makeNavData<GLOFNavEph>();
             glo = dynamic_cast<GLOFNavEph*>(navOut.get());
                // NavData
             fillNavData(navIn, navOut);
@@ -644,7 +647,7 @@ namespace gnsstk
       {
          case SatelliteSystem::GPS:
          case SatelliteSystem::QZSS:
-            health = std::make_shared<GPSLNavHealth>();
+            health = makeNavData<GPSLNavHealth>();
             gps = dynamic_cast<GPSLNavHealth*>(health.get());
                // NavData
             fillNavData(navIn, health);
@@ -667,7 +670,7 @@ namespace gnsstk
          case SatelliteSystem::BeiDou:
             if (isBeiDouGEO(navIn.sat))
             {
-               health = std::make_shared<BDSD2NavHealth>();
+               health = makeNavData<BDSD2NavHealth>();
                bdsD2Nav = dynamic_cast<BDSD2NavHealth*>(health.get());
                   // NavData
                fillNavData(navIn, health);
@@ -678,7 +681,7 @@ namespace gnsstk
             }
             else
             {
-               health = std::make_shared<BDSD1NavHealth>();
+               health = makeNavData<BDSD1NavHealth>();
                bdsD1Nav = dynamic_cast<BDSD1NavHealth*>(health.get());
                   // NavData
                fillNavData(navIn, health);
@@ -689,7 +692,7 @@ namespace gnsstk
             }
             break;
          case SatelliteSystem::Glonass:
-            health = std::make_shared<GLOFNavHealth>();
+            health = makeNavData<GLOFNavHealth>();
             glo = dynamic_cast<GLOFNavHealth*>(health.get());
                // NavData
             fillNavData(navIn, health);
@@ -726,7 +729,7 @@ namespace gnsstk
       if ((navIn.datasources & 0x01) ||
           ((navIn.datasources & 0x04) == 0))
       {
-         NavDataPtr health = std::make_shared<GalINavHealth>();
+         NavDataPtr health = makeNavData<GalINavHealth>();
          GalINavHealth *galNav = dynamic_cast<GalINavHealth*>(health.get());
             // NavData
          fillNavData(navIn, health);
@@ -754,7 +757,7 @@ namespace gnsstk
    {
       DEBUGTRACE_FUNCTION();
          // Always output F/NAV health.
-      NavDataPtr health = std::make_shared<GalFNavHealth>();
+      NavDataPtr health = makeNavData<GalFNavHealth>();
       GalFNavHealth *galNav = dynamic_cast<GalFNavHealth*>(health.get());
          // NavData
       fillNavData(navIn, health);
@@ -788,7 +791,7 @@ namespace gnsstk
       DEBUGTRACE_FUNCTION();
       if (navIn.datasources & 0x04)
       {
-         NavDataPtr health = std::make_shared<GalINavHealth>();
+         NavDataPtr health = makeNavData<GalINavHealth>();
          GalINavHealth *galNav = dynamic_cast<GalINavHealth*>(health.get());
             // NavData
          fillNavData(navIn, health);
@@ -821,7 +824,7 @@ namespace gnsstk
       for (const auto& mti : navIn.mapTimeCorr)
       {
          std::shared_ptr<RinexTimeOffset> rto =
-            std::make_shared<RinexTimeOffset>(mti.second, navIn.leapSeconds);
+            makeNavData<RinexTimeOffset>(mti.second, navIn.leapSeconds);
             // We have no idea what the signal was, but that doesn't
             // matter for TimeOffset.
             // We use the reference time as our timeStamp because we
@@ -874,7 +877,7 @@ namespace gnsstk
           ((bi = navIn.mapIonoCorr.find("GPSB")) != navIn.mapIonoCorr.end()))
       {
             // we have the GPS alpha and beta terms.
-         std::shared_ptr<GPSLNavIono> iono(std::make_shared<GPSLNavIono>());
+         std::shared_ptr<GPSLNavIono> iono(makeNavData<GPSLNavIono>());
          iono->timeStamp = when;
             // We don't know the satellite ID from which the iono data
             // came from so just set it to 0.  If someone is using the
@@ -905,7 +908,7 @@ namespace gnsstk
             // the RINEX header came from a healthy satellite, and
             // stuff a fake satellite 0 health record in the data.
          std::shared_ptr<GPSLNavHealth> health(
-            std::make_shared<GPSLNavHealth>());
+            makeNavData<GPSLNavHealth>());
             // NavData
             // further kludge to set fake health time stamp to beginning of day
          YDSTime bod(when);
@@ -932,7 +935,7 @@ namespace gnsstk
              * as I/NAV.  Probably the best thing to do would be to
              * update the find() method in the future so that it hides
              * all of these assumptions from the user. */
-         std::shared_ptr<GalINavIono> iono(std::make_shared<GalINavIono>());
+         std::shared_ptr<GalINavIono> iono(makeNavData<GalINavIono>());
          iono->timeStamp = when;
             // We don't know the satellite ID from which the iono data
             // came from so just set it to 0.  If someone is using the
@@ -954,7 +957,7 @@ namespace gnsstk
          navOut.push_back(iono);
             // THIS IS A KLUDGE, see full explanation in GPS section
          std::shared_ptr<GalINavHealth> health(
-            std::make_shared<GalINavHealth>());
+            makeNavData<GalINavHealth>());
             // NavData
             // further kludge to set fake health time stamp to beginning of day
          YDSTime bod(when);
@@ -981,7 +984,7 @@ namespace gnsstk
       {
             // we have the BDS alpha and beta terms.
             // we *don't* have any idea if these came from D1 or D2, so assume.
-         std::shared_ptr<BDSD1NavIono> iono(std::make_shared<BDSD1NavIono>());
+         std::shared_ptr<BDSD1NavIono> iono(makeNavData<BDSD1NavIono>());
          iono->timeStamp = when;
             // We don't know the satellite ID from which the iono data
             // came from so just set it to 0.  If someone is using the
@@ -1012,7 +1015,7 @@ namespace gnsstk
             // the RINEX header came from a healthy satellite, and
             // stuff a fake satellite 0 health record in the data.
          std::shared_ptr<BDSD1NavHealth> health(
-            std::make_shared<BDSD1NavHealth>());
+            makeNavData<BDSD1NavHealth>());
             // NavData
             // further kludge to set fake health time stamp to beginning of day
          YDSTime bod(when);
@@ -1048,7 +1051,7 @@ namespace gnsstk
       {
          case SatelliteSystem::GPS:
          case SatelliteSystem::QZSS:
-            navOut = std::make_shared<GPSLNavISC>();
+            navOut = makeNavData<GPSLNavISC>();
             gps = dynamic_cast<GPSLNavISC*>(navOut.get());
                // NavData
             fillNavData(navIn, navOut);
@@ -1075,7 +1078,7 @@ namespace gnsstk
                 * F/NAV data, i.e. BGD(E1,E5a), so there's no reason
                 * to output a separate GalFNavISC object from RINEX
                 * NAV data. */
-            navOut = std::make_shared<GalINavISC>();
+            navOut = makeNavData<GalINavISC>();
             galI = dynamic_cast<GalINavISC*>(navOut.get());
                // NavData
             fillNavData(navIn, navOut);
@@ -1087,7 +1090,7 @@ namespace gnsstk
          case SatelliteSystem::BeiDou:
             if (isBeiDouGEO(navIn.sat))
             {
-               navOut = std::make_shared<BDSD2NavISC>();
+               navOut = makeNavData<BDSD2NavISC>();
                bdsD2 = dynamic_cast<BDSD2NavISC*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
@@ -1097,7 +1100,7 @@ namespace gnsstk
             }
             else
             {
-               navOut = std::make_shared<BDSD1NavISC>();
+               navOut = makeNavData<BDSD1NavISC>();
                bdsD1 = dynamic_cast<BDSD1NavISC*>(navOut.get());
                   // NavData
                fillNavData(navIn, navOut);
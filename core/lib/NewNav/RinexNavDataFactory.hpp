@@ -81,6 +81,12 @@ namespace gnsstk
       bool process(const std::string& filename,
                    NavDataFactoryCallback& cb) override;
 
+         /** process() only reads the factory's configuration, so
+          * files can be read in parallel by addDataSources().
+          * @return true */
+      bool isProcessConcurrent() const override
+      { return true; }
+
          /// Return a comma-separated list of formats supported by this factory.
       std::string getFactoryFormats() const override;
 
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "SEMNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 
 #include <memory>
 
@@ -225,7 +226,7 @@ namespace gnsstk
    {
       bool rv = true;
       GPSLNavAlm *gps;
-      navOut = std::make_shared<GPSLNavAlm>();
+      navOut = makeNavData<GPSLNavAlm>();
       gps = dynamic_cast<GPSLNavAlm*>(navOut.get());
          // NavData
       fillNavData(navIn, navOut);
@@ -276,7 +277,7 @@ namespace gnsstk
    {
       bool rv = true;
       GPSLNavHealth *gps;
-      healthOut = std::make_shared<GPSLNavHealth>();
+      healthOut = makeNavData<GPSLNavHealth>();
       gps = dynamic_cast<GPSLNavHealth*>(healthOut.get());
          // NavData
       fillNavData(navIn, healthOut);
@@ -295,7 +296,7 @@ namespace gnsstk
    bool SEMNavDataFactory ::
    convertToSystem(const SEMData &navIn, NavDataPtr &systemOut)
    {
-     systemOut = std::make_shared<GPSNavConfig>();
+     systemOut = makeNavData<GPSNavConfig>();
      fillNavData(navIn, systemOut);
 
      // Dynamically cast to a GPSNavConfig pointer.
@@ -38,6 +38,7 @@
 //==============================================================================
 #include <iterator>
 #include "SP3NavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "SP3Stream.hpp"
 #include "SP3Header.hpp"
 #include "SP3Data.hpp"
@@ -47,8 +48,10 @@
 #include "Rinex3ClockData.hpp"
 #include "TimeString.hpp"
 #include "MiscMath.hpp"
+#include "LagrangeWeights.hpp"
 #include "DebugTrace.hpp"
-#include "NavDataFactoryStoreCallback.hpp"
+#include "NavDataFactoryListCallback.hpp"
+#include "NavSnapshot.hpp"
 
 using namespace std;
 
@@ -79,6 +82,174 @@ namespace gnsstk
       /// A clock bias >= this is considered bad.
    const double maxBias = 999999.0;
 
+      /** Adapts a NavMap to the sequence interface used by
+       * SP3NavDataFactory::findSeq().  Positions are map
+       * iterators, with end() used for "no such position". */
+   class SP3MapSeq
+   {
+   public:
+      typedef NavMap::iterator Pos;
+      SP3MapSeq(NavMap& nm)
+            : navMap(nm)
+      {}
+      Pos end() const
+      { return navMap.end(); }
+      bool isBegin(const Pos& pos) const
+      { return pos == navMap.begin(); }
+         /// First position after when.
+      Pos upperBound(const CommonTime& when) const
+      { return navMap.upper_bound(when); }
+         /// Previous position, end() for begin(), last for end().
+      Pos prev(const Pos& pos) const
+      { return isBegin(pos) ? navMap.end() : std::prev(pos); }
+      Pos next(const Pos& pos) const
+      { return std::next(pos); }
+         /// The map key at pos.
+      CommonTime key(const Pos& pos) const
+      { return pos->first; }
+         /// Difference in seconds between the keys at two positions.
+      double keyDiff(const Pos& a, const Pos& b) const
+      { return a->first - b->first; }
+      CommonTime timeStamp(const Pos& pos) const
+      { return pos->second->timeStamp; }
+         /// Difference in seconds between the records at two positions.
+      double stampDiff(const Pos& a, const Pos& b) const
+      { return a->second->timeStamp - b->second->timeStamp; }
+         /// Return true if the record at pos is at time when.
+      bool isAt(const Pos& pos, const CommonTime& when) const
+      { return pos->second->timeStamp == when; }
+         // This factory only stores OrbitDataSP3.
+      const OrbitDataSP3& record(const Pos& pos) const
+      { return static_cast<const OrbitDataSP3&>(*pos->second); }
+         /// Make a copy of the record at pos.
+      NavDataPtr makeRecord(const Pos& pos) const
+      { return std::make_shared<OrbitDataSP3>(record(pos)); }
+      void copyXV(const Pos& pos, OrbitDataSP3& od) const
+      { od.copyXV(record(pos)); }
+      void copyT(const Pos& pos, OrbitDataSP3& od) const
+      { od.copyT(record(pos)); }
+      double value(const Pos& pos, unsigned col) const
+      { return SP3NavGrid::getValue(record(pos), col); }
+   private:
+      NavMap& navMap;
+   };
+
+
+      /** Adapts one satellite of an SP3NavGrid to the sequence
+       * interface used by SP3NavDataFactory::findSeq().  Positions
+       * are the epoch indices with a sample for the satellite,
+       * with -1 used for "no such position".  Times are computed
+       * from the epoch indices, so the only time arithmetic
+       * needed is in upperBound(). */
+   class SP3GridSeq
+   {
+   public:
+      typedef long Pos;
+      SP3GridSeq(const SP3NavGrid& g, unsigned s)
+            : grid(g), sat(s), first(g.nextPresent(s, 0)), whenEpoch(-1)
+      {}
+      Pos end() const
+      { return -1; }
+      bool isBegin(Pos pos) const
+      { return pos == first; }
+         /** First position after when.  This must be called before
+          * isAt(), which only works for this value of when. */
+      Pos upperBound(const CommonTime& when)
+      {
+         whenEpoch = grid.findEpoch(when);
+         return grid.nextPresent(sat, grid.upperBound(when));
+      }
+      Pos prev(Pos pos) const
+      {
+         return grid.prevPresent(sat, (pos < 0) ? grid.numEpochs()-1 : pos-1);
+      }
+      Pos next(Pos pos) const
+      { return grid.nextPresent(sat, pos+1); }
+      CommonTime key(Pos pos) const
+      { return grid.getTime(pos); }
+      double keyDiff(Pos a, Pos b) const
+      { return (a - b) * grid.getStep(); }
+      CommonTime timeStamp(Pos pos) const
+      { return grid.getTime(pos); }
+      double stampDiff(Pos a, Pos b) const
+      { return (a - b) * grid.getStep(); }
+      bool isAt(Pos pos, const CommonTime& when) const
+      { return (pos >= 0) && (pos == whenEpoch); }
+      NavDataPtr makeRecord(Pos pos) const
+      { return grid.getRecord(sat, pos); }
+      void copyXV(Pos pos, OrbitDataSP3& od) const
+      {
+         for (unsigned col = SP3NavGrid::PosX; col < SP3NavGrid::ClkBias;
+              col++)
+         {
+            SP3NavGrid::setValue(od, col, grid.getValue(sat, pos, col));
+         }
+      }
+      void copyT(Pos pos, OrbitDataSP3& od) const
+      {
+         for (unsigned col = SP3NavGrid::ClkBias;
+              col < SP3NavGrid::NumColumns; col++)
+         {
+            SP3NavGrid::setValue(od, col, grid.getValue(sat, pos, col));
+         }
+      }
+      double value(Pos pos, unsigned col) const
+      { return grid.getValue(sat, pos, col); }
+   private:
+      const SP3NavGrid& grid;
+      unsigned sat;
+         /// First epoch with a sample.
+      Pos first;
+         /// Epoch of the time given to upperBound(), or -1.
+      Pos whenEpoch;
+   };
+
+
+      /** The values gathered from the interpolation points.  The
+       * value and sigma indices are position X,Y,Z, velocity X,Y,Z
+       * and acceleration X,Y,Z for ephemeris data, and bias, drift
+       * and drift rate for clock data. */
+   struct SP3NavDataFactory::InterpWindow
+   {
+         /// Number of interpolation points.
+      unsigned size;
+         /// Time of the first point.
+      CommonTime firstTime;
+         /// True if the point after the middle is at the time of interest.
+      bool isExact;
+         /// Time of each point in seconds since firstTime.
+      double t[LagrangeWeights::maxPoints];
+         /// Values at each point.
+      double val[9][LagrangeWeights::maxPoints];
+         /// Sigmas of the points on either side of the time of interest.
+      double sigLow[9], sigHigh[9];
+   };
+
+      /// Columns gathered into InterpWindow::val for ephemeris data.
+   static const unsigned ephValCols[9] =
+   {
+      SP3NavGrid::PosX, SP3NavGrid::PosY, SP3NavGrid::PosZ,
+      SP3NavGrid::VelX, SP3NavGrid::VelY, SP3NavGrid::VelZ,
+      SP3NavGrid::AccX, SP3NavGrid::AccY, SP3NavGrid::AccZ
+   };
+      /// Columns gathered into InterpWindow::sigLow/High for ephemeris data.
+   static const unsigned ephSigCols[9] =
+   {
+      SP3NavGrid::PosSigX, SP3NavGrid::PosSigY, SP3NavGrid::PosSigZ,
+      SP3NavGrid::VelSigX, SP3NavGrid::VelSigY, SP3NavGrid::VelSigZ,
+      SP3NavGrid::AccSigX, SP3NavGrid::AccSigY, SP3NavGrid::AccSigZ
+   };
+      /// Columns gathered into InterpWindow::val for clock data.
+   static const unsigned clkValCols[3] =
+   {
+      SP3NavGrid::ClkBias, SP3NavGrid::ClkDrift, SP3NavGrid::ClkDrRate
+   };
+      /// Columns gathered into InterpWindow::sigLow/High for clock data.
+   static const unsigned clkSigCols[3] =
+   {
+      SP3NavGrid::BiasSig, SP3NavGrid::DriftSig, SP3NavGrid::DrRateSig
+   };
+
    SP3NavDataFactory ::
    SP3NavDataFactory()
          : storeTimeSystem(TimeSystem::Any),
@@ -98,7 +269,9 @@ namespace gnsstk
            interpType(ClkInterpType::Lagrange),
            halfOrderClk(5),
            halfOrderPos(5),
-           initOrbitDataVal(0.0)
+           initOrbitDataVal(0.0),
+           denseStorage(false),
+           deferPack(false)
    {
       supportedSignals.insert(NavSignalID(SatelliteSystem::BeiDou,
                                           CarrierBand::B1,
@@ -241,6 +414,7 @@ namespace gnsstk
         NavSearchOrder order)
    {
       DEBUGTRACE_FUNCTION();
+      NavFactoryMetricsRecorder::FindTimer timer(metrics, nmid);
       bool rv;
       NavMessageID genericID;
       if (nmid.messageType != NavMessageType::Ephemeris)
@@ -258,7 +432,8 @@ namespace gnsstk
           * filter to exclude clock, no clock data will be stored and
           * this will end up returning false.  I'm not sure if this is
           * valid behavior. */
-      return findGeneric(NavMessageType::Clock, genericID, when, navOut);
+      timer.hit = findGeneric(NavMessageType::Clock, genericID, when, navOut);
+      return timer.hit;
    }
 
 
@@ -302,6 +477,38 @@ namespace gnsstk
       {
          return false;
       }
+      auto gridIt = grids.find(nmt);
+      if (gridIt != grids.end())
+      {
+         const SP3NavGrid& grid(gridIt->second);
+         if (!nsid.isWild())
+         {
+            long sat = grid.findSat(nsid);
+            if (sat < 0)
+            {
+               DEBUGTRACE("no data!");
+               return false;
+            }
+            SP3GridSeq seq(grid, sat);
+            return findSeq(seq, when, navData, halfOrder, findEph,
+                           checkDataGap, checkInterval, gapInterval,
+                           maxInterval);
+         }
+            // Same search order as for the maps below.
+         for (unsigned sat = 0; sat < grid.numSats(); sat++)
+         {
+            if (grid.getSat(sat) != nsid)
+               continue; // skip non matches
+            SP3GridSeq seq(grid, sat);
+            if (findSeq(seq, when, navData, halfOrder, findEph,
+                        checkDataGap, checkInterval, gapInterval,
+                        maxInterval))
+            {
+               return true;
+            }
+         }
+         return false;
+      }
       auto dataIt = data.find(nmt);
       if (dataIt == data.end())
       {
@@ -321,9 +528,10 @@ namespace gnsstk
             DEBUGTRACE("no data!");
             return false;
          }
-         return findIterator(sati, when, navData, halfOrder, findEph,
-                             checkDataGap, checkInterval, gapInterval,
-                             maxInterval);
+         SP3MapSeq seq(sati->second);
+         return findSeq(seq, when, navData, halfOrder, findEph,
+                        checkDataGap, checkInterval, gapInterval,
+                        maxInterval);
       }
       else
       {
@@ -334,9 +542,10 @@ namespace gnsstk
          {
             if (sati->first != nsid)
                continue; // skip non matches
-            rv = findIterator(sati, when, navData, halfOrder, findEph,
-                              checkDataGap, checkInterval, gapInterval,
-                              maxInterval);
+            SP3MapSeq seq(sati->second);
+            rv = findSeq(seq, when, navData, halfOrder, findEph,
+                         checkDataGap, checkInterval, gapInterval,
+                         maxInterval);
             if (rv)
                break;
          }
@@ -345,19 +554,20 @@ namespace gnsstk
    }
 
 
+   template <class Seq>
    bool SP3NavDataFactory ::
-   findIterator(NavSatMap::iterator& sati,
-                const CommonTime& when, NavDataPtr& navData,
-                unsigned halfOrder, bool findEph,
-                bool checkDataGap, bool checkInterval,
-                double gapInterval, double maxInterval)
+   findSeq(Seq& seq, const CommonTime& when, NavDataPtr& navData,
+           unsigned halfOrder, bool findEph,
+           bool checkDataGap, bool checkInterval,
+           double gapInterval, double maxInterval)
    {
+      typedef typename Seq::Pos Pos;
       bool giveUp = false;
          // This is not the entry we want, but it is instead the first
          // entry we probably (depending on order) *don't* want.
-      auto ti2 = sati->second.upper_bound(when);
-      auto ti1 = ti2, ti3 = ti2;
-      if (ti2 == sati->second.end())
+      Pos ti2 = seq.upperBound(when);
+      Pos ti1 = ti2, ti3 = ti2;
+      if (ti2 == seq.end())
       {
             // Since we're at the end we can't do interpolation,
             // but we can still check for an exact match.
@@ -366,29 +576,26 @@ namespace gnsstk
       }
       else
       {
-         DEBUGTRACE(printTime(ti2->first,"  ti2 has been set to "+dts));
+         DEBUGTRACE(printTime(seq.key(ti2),"  ti2 has been set to "+dts));
             // I wouldn't have done this except that I'm trying to
             // match the behavior of SP3EphemerisStore.  Basically,
             // for exact matches, the interpolation interval is
             // shifted "left" by one, but not when the time match
             // is not exact.
-         auto tiTmp = std::prev(ti2);
+         Pos tiTmp = seq.prev(ti2);
          unsigned offs = 0;
-         bool exactMatch = false;
-         if ((tiTmp != sati->second.end()) &&
-             (tiTmp->second->timeStamp == when))
+         if ((tiTmp != seq.end()) && seq.isAt(tiTmp, when))
          {
-            exactMatch = true;
             offs = 1;
          }
-         if (DebugTrace::enabled)
+         if (DebugTrace::enabled && (tiTmp != seq.end()))
          {
-            CommonTime dt2(ti2->first);
+            CommonTime dt2(seq.key(ti2));
             dt2.setTimeSystem(TimeSystem::Any);
-            DEBUGTRACE("gap = " << (dt2 - tiTmp->first));
+            DEBUGTRACE("gap = " << (dt2 - seq.key(tiTmp)));
          }
-         if (checkDataGap && (tiTmp != sati->second.end()) &&
-             ((ti2->first - tiTmp->first) > gapInterval))
+         if (checkDataGap && (tiTmp != seq.end()) &&
+             (seq.keyDiff(ti2, tiTmp) > gapInterval))
          {
             DEBUGTRACE("giving up because the gap interval is too big");
             giveUp = true;
@@ -409,10 +616,10 @@ namespace gnsstk
                {
                   break;
                }
-               if ((ti1 == sati->second.end()) ||
-                   ((ti3 == sati->second.end()) &&
+               if ((ti1 == seq.end()) ||
+                   ((ti3 == seq.end()) &&
                     (count <= halfOrder-offs)) ||
-                   ((ti1 == sati->second.begin()) &&
+                   (seq.isBegin(ti1) &&
                     (count <= halfOrder+offs)))
                {
                      // give up and reset the iterators to the starting point.
@@ -422,98 +629,74 @@ namespace gnsstk
                }
                if (count <= halfOrder+offs)
                {
-                  --ti1;
+                  ti1 = seq.prev(ti1);
                }
                if (count <= halfOrder-offs)
                {
-                  ++ti3;
+                  ti3 = seq.next(ti3);
                }
             }
          }
       }
          // always back up one which allows us to check for exact match.
-      ti2 = std::prev(ti2);
-      if (ti2 == sati->second.end())
+      ti2 = seq.prev(ti2);
+      if (ti2 == seq.end())
       {
          DEBUGTRACE("ti2 is now end?");
             // Nothing available that's even close.
          return false;
       }
-      DEBUGTRACE(printTime(ti2->first,"  ti2 has been set to "+dts));
+      DEBUGTRACE(printTime(seq.key(ti2),"  ti2 has been set to "+dts));
       if (!giveUp)
       {
             // Need a copy of ti3 to move it back 1, as otherwise
             // the interval check will give the wrong results since
             // it's 1 beyond the actual last interpolated item.
-         auto iti3 = std::prev(ti3);
-         DEBUGTRACE("distance from ti1 to ti2 = " << std::distance(ti1,ti2));
-         DEBUGTRACE("distance from ti2 to ti3 = " << std::distance(ti2,ti3));
-         DEBUGTRACE("interval = " << (iti3->first - ti1->first));
-         if (checkInterval && ((iti3->first - ti1->first) > maxInterval))
+         Pos iti3 = seq.prev(ti3);
+         DEBUGTRACE("interval = " << seq.keyDiff(iti3, ti1));
+         if (checkInterval && (seq.keyDiff(iti3, ti1) > maxInterval))
          {
             DEBUGTRACE("giving up because the interpolation interval is too"
                        " big");
             giveUp = true;
          }
       }
-      if (ti2->second->timeStamp == when)
+      if (seq.isAt(ti2, when))
       {
             // Even though it's an exact match, we still need to
             // make a new object so that we can fill in clock
             // information without affecting the internal store.
          if (!navData)
          {
-            OrbitDataSP3 *stored = dynamic_cast<OrbitDataSP3*>(
-               ti2->second.get());
-            navData = std::make_shared<OrbitDataSP3>(*stored);
-               // ti2->second->dump(std::cerr, DumpDetail::Full);
-               // navData->dump(std::cerr, DumpDetail::Full);
+            navData = seq.makeRecord(ti2);
                // If giveUp is not set, then we can do some
                // interpolation to fill in any missing data.
             if (!giveUp)
             {
-               if (findEph)
-               {
-                  DEBUGTRACE("interpolating ephemeris for exact match");
-                  interpolateEph(ti1, ti3, when, navData);
-               }
-               else
-               {
-                  DEBUGTRACE("interpolating clock for exact match");
-                  interpolateClk(ti1, ti3, when, navData);
-               }
+               DEBUGTRACE("interpolating for exact match");
+               interpolate(seq, ti1, ti3, when, findEph, navData);
             }
             DEBUGTRACE("found an exact match");
             return true;
          }
          else
          {
-            OrbitDataSP3 *stored = dynamic_cast<OrbitDataSP3*>(
-               ti2->second.get());
             OrbitDataSP3 *navOut = dynamic_cast<OrbitDataSP3*>(
                navData.get());
             if (findEph)
             {
-               navOut->copyXV(*stored);
-                  // fill in missing data if we can
-               if (!giveUp)
-               {
-                  DEBUGTRACE("interpolating ephemeris for exact match (2)");
-                  interpolateEph(ti1, ti3, when, navData);
-               }
+               seq.copyXV(ti2, *navOut);
             }
             else
             {
-               navOut->copyT(*stored);
-                  // fill in missing data if we can
-               if (!giveUp)
-               {
-                  DEBUGTRACE("interpolating clock for exact match (2)");
-                  interpolateClk(ti1, ti3, when, navData);
-               }
+               seq.copyT(ti2, *navOut);
+            }
+               // fill in missing data if we can
+            if (!giveUp)
+            {
+               DEBUGTRACE("interpolating for exact match (2)");
+               interpolate(seq, ti1, ti3, when, findEph, navData);
             }
-               // stored->dump(std::cerr, DumpDetail::Full);
-               // navOut->dump(std::cerr, DumpDetail::Full);
             DEBUGTRACE("found an exact match with existing data");
             return true;
          }
@@ -524,37 +707,71 @@ namespace gnsstk
          DEBUGTRACE("giving up, insufficient data for interpolation");
          return false;
       }
+      DEBUGTRACE("faking interpolation");
+      if (!navData)
+      {
+         DEBUGTRACE("creating new empty navData");
+         navData = seq.makeRecord(ti2);
+         navData->timeStamp = when;
+      }
       else
       {
-         DEBUGTRACE("faking interpolation");
-         if (!navData)
-         {
-            DEBUGTRACE("creating new empty navData");
-            OrbitDataSP3 *stored = dynamic_cast<OrbitDataSP3*>(
-               ti2->second.get());
-            navData = std::make_shared<OrbitDataSP3>(*stored);
-            navData->timeStamp = when;
-         }
-         else
+         DEBUGTRACE("already have valid navData");
+      }
+      DEBUGTRACE("OK, have interval " << printTime(seq.key(ti1),""+dts)
+                 << " <= " <<printTime(when,""+dts));
+      interpolate(seq, ti1, ti3, when, findEph, navData);
+      return true;
+   }
+
+
+   template <class Seq>
+   void SP3NavDataFactory ::
+   interpolate(Seq& seq, const typename Seq::Pos& ti1,
+               const typename Seq::Pos& ti3,
+               const CommonTime& when, bool findEph, NavDataPtr& navData)
+   {
+      InterpWindow win;
+      unsigned halfOrder = (findEph ? halfOrderPos : halfOrderClk);
+      const unsigned *valCols = (findEph ? ephValCols : clkValCols);
+      const unsigned *sigCols = (findEph ? ephSigCols : clkSigCols);
+      unsigned numCols = (findEph ? 9 : 3);
+      std::fill(win.sigLow, win.sigLow+9, 0.0);
+      std::fill(win.sigHigh, win.sigHigh+9, 0.0);
+      win.firstTime = seq.timeStamp(ti1);
+      win.isExact = false;
+      unsigned idx = 0;
+      for (typename Seq::Pos ti2 = ti1;
+           (ti2 != ti3) && (idx < LagrangeWeights::maxPoints);
+           ti2 = seq.next(ti2), ++idx)
+      {
+         win.t[idx] = seq.stampDiff(ti2, ti1);
+         if ((idx == halfOrder) && seq.isAt(ti2, when))
+            win.isExact = true;
+         for (unsigned col = 0; col < numCols; col++)
          {
-            DEBUGTRACE("already have valid navData");
+            win.val[col][idx] = seq.value(ti2, valCols[col]);
          }
-         DEBUGTRACE("OK, have interval " << printTime(ti1->first,""+dts)
-                    << " <= " <<printTime(when,""+dts)<< " < "
-                    << printTime(ti3->first,dts));
-         if (findEph)
+         if (idx == halfOrder-1)
          {
-            interpolateEph(ti1, ti3, when, navData);
-            return true;
+            for (unsigned col = 0; col < numCols; col++)
+               win.sigLow[col] = seq.value(ti2, sigCols[col]);
          }
-         else
+         else if (idx == halfOrder)
          {
-            interpolateClk(ti1, ti3, when, navData);
-            return true;
+            for (unsigned col = 0; col < numCols; col++)
+               win.sigHigh[col] = seq.value(ti2, sigCols[col]);
          }
-      } // else (do interpolation)
-      DEBUGTRACE("giving up at the end");
-      return false;
+      }
+      win.size = idx;
+      if (findEph)
+      {
+         interpolateEph(win, when, navData);
+      }
+      else
+      {
+         interpolateClk(win, when, navData);
+      }
    }
 
 
@@ -562,15 +779,121 @@ namespace gnsstk
    addDataSource(const std::string& source)
    {
       DEBUGTRACE_FUNCTION();
-      gnsstk::NavDataFactoryStoreCallback cb(this, data, nearestData,
-                                             offsetData);
-      return process(source, cb);
+      if (frozen)
+      {
+         return false;
+      }
+      return recordLoad(source, [&]()
+      {
+            // Same as addDataSources() so the results can't differ.
+         NavDataArena::Use useArena(arena);
+         SourceDataPtr srcData;
+         bool rv = readSource(source, srcData);
+         return mergeSource(*srcData, rv);
+      });
+   }
+
+
+   bool SP3NavDataFactory ::
+   readSource(const std::string& source, SourceDataPtr& srcData)
+   {
+      std::shared_ptr<SP3SourceData> info = std::make_shared<SP3SourceData>();
+      srcData = info;
+      NavDataFactoryListCallback cb(info->navList);
+      return readFile(source, cb, *info, true, TimeSystem::Any);
+   }
+
+
+   bool SP3NavDataFactory ::
+   mergeSource(SourceData& srcData, bool readOK)
+   {
+      SP3SourceData& info(dynamic_cast<SP3SourceData&>(srcData));
+      if (info.sp3 || info.rinexClock)
+      {
+         if (!checkTimeSystem(storeTimeSystem, info.timeSystem,
+                              info.sp3 ? "SP3" : "SP3/RINEX clock"))
+         {
+               // Don't load a file with a differing time system
+            info.navList.clear();
+            return false;
+         }
+         if ((info.timeSystem != TimeSystem::Any) &&
+             (info.timeSystem != TimeSystem::Unknown))
+         {
+            if (storeTimeSystem == TimeSystem::Any)
+            {
+                  /// @note store TimeSystem must be consistent.
+               storeTimeSystem = info.timeSystem;
+            }
+         }
+         else if (info.rinexClock)
+         {
+               // readRinexClock() assumed GPS.
+            storeTimeSystem = TimeSystem::GPS;
+         }
+      }
+      if (info.rinexClock)
+      {
+            // Valid RINEX clock data with appropriate time system, go
+            // ahead and switch to using RINEX clock instead of SP3
+            // clock.
+         useRinexClockData();
+      }
+      bool rv = readOK;
+      deferPack = true;
+      for (const auto& ndp : info.navList)
+      {
+         if (info.sp3 && !useSP3clock &&
+             (ndp->signal.messageType == NavMessageType::Clock))
+         {
+            continue;
+         }
+         if (!addNavData(ndp))
+         {
+            rv = false;
+            break;
+         }
+      }
+      deferPack = false;
+      info.navList.clear();
+      if (denseStorage)
+      {
+         packData();
+      }
+      return rv;
+   }
+
+
+   bool SP3NavDataFactory ::
+   checkTimeSystem(TimeSystem storeTS, TimeSystem fileTS,
+                   const std::string& what)
+   {
+      if ((storeTS == TimeSystem::Any) || (fileTS == TimeSystem::Any) ||
+          (fileTS == TimeSystem::Unknown) || (storeTS == fileTS))
+      {
+         return true;
+      }
+      cerr << "Time system mismatch in " << what << " data, "
+           << gnsstk::StringUtils::asString(storeTS)
+           << " (store) != "
+           << gnsstk::StringUtils::asString(fileTS)
+           << " (file)" << endl;
+      return false;
    }
 
 
    bool SP3NavDataFactory ::
    process(const std::string& filename,
            NavDataFactoryCallback& cb)
+   {
+      SP3SourceData info;
+      return readFile(filename, cb, info, useSP3clock, storeTimeSystem);
+   }
+
+
+   bool SP3NavDataFactory ::
+   readFile(const std::string& filename, NavDataFactoryCallback& cb,
+            SP3SourceData& info, bool sp3Clock, TimeSystem storeTS)
    {
       DEBUGTRACE_FUNCTION();
       bool rv = true;
@@ -590,34 +913,22 @@ namespace gnsstk
          {
             return false;
          }
+            // read the lines in place, see FactoryControl::mapFiles
+         is.bufferInput(factControl.mapFiles);
          is >> head;
          if (!is)
          {
-            return addRinexClock(filename, cb);
+            return readRinexClock(filename, cb, info, storeTS);
          }
 
             // know whether to look for the extra info contained in SP3c
          bool isC = (head.version==SP3Header::SP3c);
-            // check/save TimeSystem to storeTimeSystem
-         if ((head.timeSystem != TimeSystem::Any) &&
-             (head.timeSystem != TimeSystem::Unknown))
+         info.sp3 = true;
+         info.timeSystem = head.timeSystem;
+            // Don't load an SP3 file with a differing time system
+         if (!checkTimeSystem(storeTS, head.timeSystem, "SP3"))
          {
-               // if store time system has not been set, do so
-            if (storeTimeSystem == TimeSystem::Any)
-            {
-                  /// @note store TimeSystem must be consistent.
-               storeTimeSystem = head.timeSystem;
-            }
-            else if (storeTimeSystem != head.timeSystem)
-            {
-                  // Don't load an SP3 file with a differing time system
-               cerr << "Time system mismatch in SP3 data, "
-                    << gnsstk::StringUtils::asString(storeTimeSystem)
-                    << " (store) != "
-                    << gnsstk::StringUtils::asString(head.timeSystem)
-                    << " (file)" << endl;
-               return false;
-            }
+            return false;
          }
 
          while (is)
@@ -639,7 +950,7 @@ namespace gnsstk
                if (!store(processEph, cb, eph))
                   return false;
                DEBUGTRACE("storing clk");
-               if (!store(processClk && useSP3clock, cb, clk))
+               if (!store(processClk && sp3Clock, cb, clk))
                   return false;
             }
                // Don't process time records otherwise we'll end up
@@ -689,7 +1000,7 @@ namespace gnsstk
          if (!store(processEph, cb, eph))
             return false;
          DEBUGTRACE("storing last clk");
-         if (!store(processClk, cb, clk))
+         if (!store(processClk && sp3Clock, cb, clk))
             return false;
       }
       catch (gnsstk::Exception& exc)
@@ -712,7 +1023,8 @@ namespace gnsstk
 
 
    bool SP3NavDataFactory ::
-   addRinexClock(const std::string& source, NavDataFactoryCallback& cb)
+   readRinexClock(const std::string& source, NavDataFactoryCallback& cb,
+                  SP3SourceData& info, TimeSystem storeTS)
    {
       bool rv = true;
          // We have to handle this a bit carefully.  If we're not
@@ -729,6 +1041,7 @@ namespace gnsstk
          {
             return false;
          }
+         is.bufferInput(factControl.mapFiles);
          is >> head;
          if (!is)
          {
@@ -739,38 +1052,19 @@ namespace gnsstk
          if (!processClk)
             return true; // ...but the user doesn't want it.
 
-            // check/save TimeSystem to storeTimeSystem
-         if(head.timeSystem != TimeSystem::Any &&
-            head.timeSystem != TimeSystem::Unknown)
+         info.rinexClock = true;
+         info.timeSystem = head.timeSystem;
+            // Don't load a RINEX clock file with a differing time system
+         if (!checkTimeSystem(storeTS, head.timeSystem, "SP3/RINEX clock"))
          {
-               // if store time system has not been set, do so
-            if(storeTimeSystem == TimeSystem::Any)
-            {
-                  /// @note store TimeSystem must be consistent.
-               storeTimeSystem = head.timeSystem;
-            }
-            else if (storeTimeSystem != head.timeSystem)
-            {
-                  // Don't load a RINEX clock file with a differing time system
-               cerr << "Time system mismatch in SP3/RINEX clock data "
-                    << gnsstk::StringUtils::asString(storeTimeSystem)
-                    << " (store) != "
-                    << gnsstk::StringUtils::asString(head.timeSystem)
-                    << " (file)" << endl;
-               return false;
-            }
+            return false;
          }
-         else
+         if ((head.timeSystem == TimeSystem::Any) ||
+             (head.timeSystem == TimeSystem::Unknown))
          {
             head.timeSystem = TimeSystem::GPS;
-            storeTimeSystem = head.timeSystem;
          }
 
-            // Valid RINEX clock data with appropriate time system, go
-            // ahead and switch to using RINEX clock instead of SP3
-            // clock.
-         useRinexClockData();
-
          while (is)
          {
             is >> data;
@@ -785,7 +1079,7 @@ namespace gnsstk
             {
                data.time.setTimeSystem(head.timeSystem);
                OrbitDataSP3 *gps;
-               NavDataPtr clk = std::make_shared<OrbitDataSP3>(
+               NavDataPtr clk = makeNavData<OrbitDataSP3>(
                   initOrbitDataVal);
                   // Force the message type to clock because
                   // OrbitDataSP3 defaults to Ephemeris.
@@ -826,6 +1120,414 @@ namespace gnsstk
    }
 
 
+   bool SP3NavDataFactory ::
+   readSnapshot(const std::string& filename)
+   {
+      deferPack = true;
+      bool rv = NavDataFactoryWithStore::readSnapshot(filename);
+      deferPack = false;
+      if (!rv)
+      {
+         return false;
+      }
+      if ((storeTimeSystem == TimeSystem::Any) && (size() > 0))
+      {
+         storeTimeSystem = initialTime.getTimeSystem();
+      }
+      if (denseStorage)
+      {
+         packData();
+      }
+      return true;
+   }
+
+
+   bool SP3NavDataFactory ::
+   writeSnapshot(const std::string& filename) const
+   {
+      if (grids.empty())
+      {
+         return NavDataFactoryWithStore::writeSnapshot(filename);
+      }
+      SP3NavDataFactory tmp;
+      unpackCopy(tmp);
+      return NavSnapshot::write(filename, {&tmp});
+   }
+
+
+   void SP3NavDataFactory ::
+   setDenseStorage(bool dense)
+   {
+      if (frozen)
+      {
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
+      }
+      denseStorage = dense;
+      if (denseStorage)
+      {
+         packData();
+      }
+      else
+      {
+         unpackData();
+      }
+   }
+
+
+   bool SP3NavDataFactory ::
+   addNavData(const NavDataPtr& nd, NavMessageMap& navMap,
+              NavNearMessageMap& navNearMap, OffsetCvtMap& ofsMap)
+   {
+      if (!NavDataFactoryWithStore::addNavData(nd, navMap, navNearMap,
+                                               ofsMap))
+      {
+         return false;
+      }
+      const NavMessageType nmt = nd->signal.messageType;
+      auto gridIt = grids.find(nmt);
+      if (deferPack || (&navMap != &data) || (gridIt == grids.end()))
+      {
+         return true;
+      }
+      auto dataIt = data.find(nmt);
+      if ((dataIt != data.end()) && (dataIt->second.size() == 1) &&
+          (dataIt->second.begin()->second.size() == 1) &&
+          gridIt->second.merge(nmt, dataIt->second))
+      {
+            // Only nd was in the maps, so move it to the grid without
+            // disturbing the counts or time index of the rest.
+         removeNavData(nd, true);
+         return true;
+      }
+      packData(nmt);
+      return true;
+   }
+
+
+   void SP3NavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime)
+   {
+      NavDataFactoryWithStore::edit(fromTime, toTime);
+      for (auto gi = grids.begin(); gi != grids.end();)
+      {
+         gi->second.erase(fromTime, toTime);
+         if (gi->second.empty())
+         {
+            gi = grids.erase(gi);
+         }
+         else
+         {
+            ++gi;
+         }
+      }
+   }
+
+
+   void SP3NavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime,
+        const NavSatelliteID& satID)
+   {
+      NavDataFactoryWithStore::edit(fromTime, toTime, satID);
+      for (auto gi = grids.begin(); gi != grids.end();)
+      {
+         gi->second.erase(fromTime, toTime, satID);
+         if (gi->second.empty())
+         {
+            gi = grids.erase(gi);
+         }
+         else
+         {
+            ++gi;
+         }
+      }
+   }
+
+
+   void SP3NavDataFactory ::
+   edit(const CommonTime& fromTime, const CommonTime& toTime,
+        const NavSignalID& signal)
+   {
+      edit(fromTime, toTime, NavSatelliteID(signal));
+   }
+
+
+   void SP3NavDataFactory ::
+   clear()
+   {
+      NavDataFactoryWithStore::clear();
+      grids.clear();
+   }
+
+
+   void SP3NavDataFactory ::
+   compact()
+   {
+      if (!frozen && denseStorage)
+      {
+         packData();
+      }
+      NavDataFactoryWithStore::compact();
+   }
+
+
+   NavSatelliteIDSet SP3NavDataFactory ::
+   getAvailableSats(NavMessageType nmt, const CommonTime& fromTime,
+                    const CommonTime& toTime)
+      const
+   {
+      NavSatelliteIDSet rv(
+         NavDataFactoryWithStore::getAvailableSats(nmt, fromTime, toTime));
+      auto gridIt = grids.find(nmt);
+      if (gridIt != grids.end())
+      {
+         const SP3NavGrid& grid(gridIt->second);
+         for (unsigned sat = 0; sat < grid.numSats(); sat++)
+         {
+            if (grid.hasData(sat, fromTime, toTime))
+            {
+               rv.insert(grid.getSat(sat));
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   NavMessageIDSet SP3NavDataFactory ::
+   getAvailableMsgs(const CommonTime& fromTime, const CommonTime& toTime)
+      const
+   {
+      NavMessageIDSet rv(
+         NavDataFactoryWithStore::getAvailableMsgs(fromTime, toTime));
+      for (const auto& gi : grids)
+      {
+         for (unsigned sat = 0; sat < gi.second.numSats(); sat++)
+         {
+            if (gi.second.hasData(sat, fromTime, toTime))
+            {
+               rv.insert(NavMessageID(gi.second.getSat(sat), gi.first));
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   size_t SP3NavDataFactory ::
+   size() const
+   {
+      size_t rv = NavDataFactoryWithStore::size();
+      for (const auto& gi : grids)
+      {
+         rv += gi.second.size();
+      }
+      return rv;
+   }
+
+
+   size_t SP3NavDataFactory ::
+   count(const NavMessageID& nmid) const
+   {
+      size_t rv = NavDataFactoryWithStore::count(nmid);
+         // Match the same way NavDataFactoryWithStore does.
+      NavMessageID key(nmid);
+      for (const auto& gi : grids)
+      {
+         if ((nmid.messageType != NavMessageType::Unknown) &&
+             (nmid.messageType != gi.first))
+         {
+            continue;
+         }
+         for (unsigned sat = 0; sat < gi.second.numSats(); sat++)
+         {
+            const NavSatelliteID& nsid(gi.second.getSat(sat));
+            if (nmid.system == SatelliteSystem::Unknown)
+            {
+               key.system = nsid.system;
+            }
+            if (nsid == key)
+            {
+               rv += gi.second.count(sat);
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   size_t SP3NavDataFactory ::
+   count(SatelliteSystem sys, NavMessageType nmt) const
+   {
+      size_t rv = NavDataFactoryWithStore::count(sys, nmt);
+      for (const auto& gi : grids)
+      {
+         if ((nmt != NavMessageType::Unknown) && (nmt != gi.first))
+         {
+            continue;
+         }
+         for (unsigned sat = 0; sat < gi.second.numSats(); sat++)
+         {
+            if ((sys == SatelliteSystem::Unknown) ||
+                (sys == gi.second.getSat(sat).system))
+            {
+               rv += gi.second.count(sat);
+            }
+         }
+      }
+      return rv;
+   }
+
+
+   size_t SP3NavDataFactory ::
+   numSignals() const
+   {
+      NavSatelliteIDSet sats;
+      getSatellites(sats);
+      std::set<NavSignalID> uniques(sats.begin(), sats.end());
+      return uniques.size();
+   }
+
+
+   size_t SP3NavDataFactory ::
+   numSatellites() const
+   {
+      NavSatelliteIDSet sats;
+      getSatellites(sats);
+      return sats.size();
+   }
+
+
+   void SP3NavDataFactory ::
+   getSatellites(NavSatelliteIDSet& sats) const
+   {
+      NavDataFactoryWithStore::getSatellites(sats);
+      for (const auto& gi : grids)
+      {
+         for (unsigned sat = 0; sat < gi.second.numSats(); sat++)
+         {
+            sats.insert(gi.second.getSat(sat));
+         }
+      }
+   }
+
+
+   void SP3NavDataFactory ::
+   dump(std::ostream& s, DumpDetail dl) const
+   {
+      if (grids.empty())
+      {
+         NavDataFactoryWithStore::dump(s, dl);
+         return;
+      }
+      SP3NavDataFactory tmp;
+      unpackCopy(tmp);
+      tmp.NavDataFactoryWithStore::dump(s, dl);
+   }
+
+
+   void SP3NavDataFactory ::
+   packData()
+   {
+      packData(NavMessageType::Ephemeris);
+      packData(NavMessageType::Clock);
+   }
+
+
+   bool SP3NavDataFactory ::
+   packData(NavMessageType nmt)
+   {
+      auto dataIt = data.find(nmt);
+      if (dataIt == data.end())
+      {
+         return false;
+      }
+      discardIndex();
+      SP3NavGrid& grid(grids[nmt]);
+      if (grid.merge(nmt, dataIt->second))
+      {
+         data.erase(dataIt);
+         nearestData.erase(nmt);
+      }
+      else
+      {
+            // Can't be stored densely, put everything in the maps.
+         unpackGrid(grid, data, nearestData);
+         grid.clear();
+      }
+      if (grid.empty())
+      {
+         grids.erase(nmt);
+      }
+      recountNavData();
+      discardTimeIndex();
+      return true;
+   }
+
+
+   void SP3NavDataFactory ::
+   unpackData()
+   {
+      if (grids.empty())
+      {
+         return;
+      }
+      if (frozen)
+      {
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
+      }
+      discardIndex();
+      for (const auto& gi : grids)
+      {
+         unpackGrid(gi.second, data, nearestData);
+      }
+      grids.clear();
+      recountNavData();
+      discardTimeIndex();
+   }
+
+
+   void SP3NavDataFactory ::
+   unpackGrid(const SP3NavGrid& grid, NavMessageMap& navMap,
+              NavNearMessageMap& navNearMap)
+   {
+      if (grid.empty())
+      {
+         return;
+      }
+      NavSatMap& nsm(navMap[grid.getMessageType()]);
+      NavNearSatMap& nnsm(navNearMap[grid.getMessageType()]);
+      for (unsigned sat = 0; sat < grid.numSats(); sat++)
+      {
+         NavMap& nm(nsm[grid.getSat(sat)]);
+         NavNearMap& nnm(nnsm[grid.getSat(sat)]);
+         for (long epoch = grid.nextPresent(sat, 0); epoch >= 0;
+              epoch = grid.nextPresent(sat, epoch+1))
+         {
+            NavDataPtr od = grid.getRecord(sat, epoch);
+            if (nm.insert(NavMap::value_type(od->getUserTime(), od)).second)
+            {
+               nnm[od->getNearTime()].push_back(od);
+            }
+         }
+      }
+   }
+
+
+   void SP3NavDataFactory ::
+   unpackCopy(SP3NavDataFactory& tmp) const
+   {
+      tmp.data = data;
+      tmp.nearestData = nearestData;
+      for (const auto& gi : grids)
+      {
+         unpackGrid(gi.second, tmp.data, tmp.nearestData);
+      }
+      tmp.recountNavData();
+   }
+
+
    std::string SP3NavDataFactory ::
    getFactoryFormats() const
    {
@@ -850,7 +1552,7 @@ namespace gnsstk
       if (!navOut)
       {
          DEBUGTRACE("creating OrbitDataSP3");
-         navOut = std::make_shared<OrbitDataSP3>(initVal);
+         navOut = makeNavData<OrbitDataSP3>(initVal);
       }
       gps = dynamic_cast<OrbitDataSP3*>(navOut.get());
       DEBUGTRACE("navIn.RecType=" << navIn.RecType);
@@ -916,7 +1618,7 @@ namespace gnsstk
          // velocity, so we only create new objects as needed.
       if (!clkOut)
       {
-         clkOut = std::make_shared<OrbitDataSP3>(initVal);
+         clkOut = makeNavData<OrbitDataSP3>(initVal);
             // Force the message type to clock because OrbitDataSP3
             // defaults to Ephemeris.
          clkOut->signal.messageType = NavMessageType::Clock;
@@ -1014,72 +1716,47 @@ namespace gnsstk
       // This method is roughly equivalent to the deprecated
       // PositionSatStore::getValue().
    void SP3NavDataFactory ::
-   interpolateEph(const NavMap::iterator& ti1, const NavMap::iterator& ti3,
-                  const CommonTime& when, NavDataPtr& navData)
+   interpolateEph(const InterpWindow& win, const CommonTime& when,
+                  NavDataPtr& navData)
    {
       DEBUGTRACE_FUNCTION();
-      DEBUGTRACE("start interpolating ephemeris, distance = "
-                 << std::distance(ti1,ti3));
-      std::vector<double> tdata(2*halfOrderPos);
-      std::vector<std::vector<double>> posData(3), posSigData(3), velData(3),
-         velSigData(3), accData(3), accSigData(3);
-      CommonTime firstTime(ti1->second->timeStamp);
+      DEBUGTRACE("start interpolating ephemeris, size = " << win.size);
+         // SP3 epochs are usually the same for all satellites, so
+         // the interpolation weights computed for one satellite can
+         // be used for the rest.  setPoints() only recomputes them
+         // when the epochs or time change.
+      static thread_local LagrangeWeights weights;
+         // posData etc are 2D arrays, where the first dimension
+         // is positional, x=0,y=1,z=2 and the 2nd dimension is
+         // the data index for the fit.
+      const double (*posData)[LagrangeWeights::maxPoints] = &win.val[0];
+      const double (*velData)[LagrangeWeights::maxPoints] = &win.val[3];
+      const double (*accData)[LagrangeWeights::maxPoints] = &win.val[6];
+      const double *tdata = win.t;
+      const CommonTime& firstTime(win.firstTime);
          // This flag is only used to decide whether to compute sigmas
          // or use existing ones.  It is expected that for exact time
          // matches, navData will already have any sigma data filled
          // in.
-      bool isExact = false;
-      unsigned idx = 0;
-         // posData etc are 2D arrays, where the first dimension
-         // is positional, x=0,y=1,z=2 and the 2nd dimension is
-         // the data index for the fit.
-      for (unsigned i = 0; i < 3; i++)
-      {
-         posData[i].resize(2*halfOrderPos);
-         posSigData[i].resize(2*halfOrderPos);
-         velData[i].resize(2*halfOrderPos);
-         velSigData[i].resize(2*halfOrderPos);
-         accData[i].resize(2*halfOrderPos);
-         accSigData[i].resize(2*halfOrderPos);
-      }
-      DEBUGTRACE("resized");
+      bool isExact = win.isExact;
+      unsigned idx = win.size;
       bool haveVel = false, haveAcc = false;
-      NavMap::iterator ti2;
-      for (ti2 = ti1, idx=0; ti2 != ti3; ++ti2, ++idx)
-      {
-         DEBUGTRACE("idx=" << idx);
-         tdata[idx] = ti2->second->timeStamp - firstTime;
-         if ((idx == halfOrderPos) && (ti2->second->timeStamp == when))
-            isExact = true;
-         OrbitDataSP3 *nav = dynamic_cast<OrbitDataSP3*>(
-            ti2->second.get());
-         DEBUGTRACE("nav=" << nav);
-         // ti2->second->dump(cerr, DumpDetail::Full);
+      for (unsigned j = 0; j < idx; j++)
+      {
          for (unsigned i = 0; i < 3; i++)
          {
-            DEBUGTRACE("i=" << i);
-            DEBUGTRACE(posData.size() << " " << velData.size() << " "
-                       << accData.size());
-            DEBUGTRACE(nav->pos.size() << " " << nav->vel.size() << " "
-                       << nav->acc.size());
-            posData[i][idx] = nav->pos[i];
-            velData[i][idx] = nav->vel[i];
-            accData[i][idx] = nav->acc[i];
-            posSigData[i][idx] = nav->posSig[i];
-            velSigData[i][idx] = nav->velSig[i];
-            accSigData[i][idx] = nav->accSig[i];
-            haveVel |= (nav->vel[i] != 0.0);
-            haveAcc |= (nav->acc[i] != 0.0);
-         }
-      }
-      double dt = when - firstTime, err;
+            haveVel |= (velData[i][j] != 0.0);
+            haveAcc |= (accData[i][j] != 0.0);
+         }
+      }
+      double dt = when - firstTime;
       OrbitDataSP3 *osp3 = dynamic_cast<OrbitDataSP3*>(navData.get());
       DEBUGTRACE(printTime(when, "when=%Y/%02m/%02d %02H:%02M:%02S"));
       DEBUGTRACE(printTime(firstTime, "firstTime=%Y/%02m/%02d %02H:%02M:%02S"));
       DEBUGTRACE(setprecision(20) << "  dt=" << dt);
       if (DebugTrace::enabled)
       {
-         for (unsigned i = 0; i < tdata.size(); i++)
+         for (unsigned i = 0; i < idx; i++)
          {
             DEBUGTRACE("i=" << i << " times=" << tdata[i]);
             DEBUGTRACE("P=" << posData[0][i] << " " << posData[1][i] << " "
@@ -1092,87 +1769,49 @@ namespace gnsstk
       }
       DEBUGTRACE("haveVelocity=" << haveVel << "  haveAcceleration="
                  << haveAcc);
+         // Velocity is derived from position when not available,
+         // and acceleration from velocity.
+      weights.setPoints(tdata, idx, dt, !(haveVel && haveAcc));
          // Interpolate XYZ position/velocity/acceleration.
       for (unsigned i = 0; i < 3; i++)
       {
+         osp3->pos[i] = weights.interp(posData[i]);
          if (haveVel && haveAcc)
          {
-            osp3->pos[i] = LagrangeInterpolation(tdata,posData[i],dt,err);
-            osp3->vel[i] = LagrangeInterpolation(tdata,velData[i],dt,err);
-            osp3->acc[i] = LagrangeInterpolation(tdata,accData[i],dt,err);
-            unsigned Nhi = halfOrderPos, Nlow=halfOrderPos-1;
-            DEBUGTRACE("!isExact sigP[" << i << "][" << Nhi << "] = "
-                       << posSigData[i][Nhi]);
-            DEBUGTRACE("         sigP[" << i << "][" << Nlow << "] = "
-                       << posSigData[i][Nlow]);
-            DEBUGTRACE("         sigV[" << i << "][" << Nhi << "] = "
-                       << velSigData[i][Nhi]);
-            DEBUGTRACE("         sigV[" << i << "][" << Nlow << "] = "
-                       << velSigData[i][Nlow]);
-            DEBUGTRACE("         sigA[" << i << "][" << Nhi << "] = "
-                       << accSigData[i][Nhi]);
-            DEBUGTRACE("         sigA[" << i << "][" << Nlow << "] = "
-                       << accSigData[i][Nlow]);
+            osp3->vel[i] = weights.interp(velData[i]);
+            osp3->acc[i] = weights.interp(accData[i]);
             if (!isExact)
             {
-               osp3->posSig[i] = RSS(posSigData[i][halfOrderPos-1],
-                                     posSigData[i][halfOrderPos]);
-               osp3->velSig[i] = RSS(velSigData[i][halfOrderPos-1],
-                                     velSigData[i][halfOrderPos]);
-               osp3->accSig[i] = RSS(accSigData[i][halfOrderPos-1],
-                                     accSigData[i][halfOrderPos]);
-               DEBUGTRACE("1 RSS(posSigData[" << i << "][" << (halfOrderPos-1)
-                          << "],posSigData[" << i << "][" << halfOrderPos
-                          << "]) = " << osp3->posSig[i]);
+               osp3->posSig[i] = RSS(win.sigLow[i], win.sigHigh[i]);
+               osp3->velSig[i] = RSS(win.sigLow[3+i], win.sigHigh[3+i]);
+               osp3->accSig[i] = RSS(win.sigLow[6+i], win.sigHigh[6+i]);
+               DEBUGTRACE("1 RSS(posSig) = " << osp3->posSig[i]);
             }
          }
          else if (haveVel && !haveAcc)
          {
-            osp3->pos[i] = LagrangeInterpolation(tdata,posData[i],dt,err);
-            LagrangeInterpolation(tdata, velData[i], dt, osp3->vel[i],
-                                  osp3->acc[i]);
-            osp3->acc[i] *= 0.1;
-            unsigned Nhi = halfOrderPos, Nlow=halfOrderPos-1;
-            DEBUGTRACE("!isExact sigP[" << i << "][" << Nhi << "] = "
-                       << posSigData[i][Nhi]);
-            DEBUGTRACE("         sigP[" << i << "][" << Nlow << "] = "
-                       << posSigData[i][Nlow]);
-            DEBUGTRACE("         sigV[" << i << "][" << Nhi << "] = "
-                       << velSigData[i][Nhi]);
-            DEBUGTRACE("         sigV[" << i << "][" << Nlow << "] = "
-                       << velSigData[i][Nlow]);
-            DEBUGTRACE("         sigA[" << i << "][" << Nhi << "] = "
-                       << accSigData[i][Nhi]);
-            DEBUGTRACE("         sigA[" << i << "][" << Nlow << "] = "
-                       << accSigData[i][Nlow]);
+            osp3->vel[i] = weights.interp(velData[i]);
+            osp3->acc[i] = weights.deriv(velData[i]) * 0.1;
             if (!isExact)
             {
-               osp3->posSig[i] = RSS(posSigData[i][halfOrderPos-1],
-                                     posSigData[i][halfOrderPos]);
-               osp3->velSig[i] = RSS(velSigData[i][halfOrderPos-1],
-                                     velSigData[i][halfOrderPos]);
+               osp3->posSig[i] = RSS(win.sigLow[i], win.sigHigh[i]);
+               osp3->velSig[i] = RSS(win.sigLow[3+i], win.sigHigh[3+i]);
             }
-            DEBUGTRACE("2 RSS(posSigData[" << i << "][" << (halfOrderPos-1)
-                       << "],posSigData[" << i << "][" << halfOrderPos
-                       << "]) = " << osp3->posSig[i]);
+            DEBUGTRACE("2 RSS(posSig) = " << osp3->posSig[i]);
          }
          else
          {
                // have position, must derive velocity and acceleration
-            LagrangeInterpolation(tdata, posData[i], dt, osp3->pos[i],
-                                  osp3->vel[i]);
+            osp3->vel[i] = weights.deriv(posData[i]);
             osp3->vel[i] *= 10000.; // km/sec to dm/sec
                // PositionSatStore doesn't derive
                // acceleration in this case, near as I can
                // tell.
             if (!isExact)
             {
-               osp3->posSig[i] = RSS(posSigData[i][halfOrderPos-1],
-                                     posSigData[i][halfOrderPos]);
+               osp3->posSig[i] = RSS(win.sigLow[i], win.sigHigh[i]);
             }
-            DEBUGTRACE("3 RSS(posSigData[" << i << "][" << (halfOrderPos-1)
-                       << "],posSigData[" << i << "][" << halfOrderPos
-                       << "]) = " << osp3->posSig[i]);
+            DEBUGTRACE("3 RSS(posSig) = " << osp3->posSig[i]);
          }
       } // for (unsigned i = 0; i < 3; i++)
       if (DebugTrace::enabled)
@@ -1188,103 +1827,91 @@ namespace gnsstk
 
 
    void SP3NavDataFactory ::
-   interpolateClk(const NavMap::iterator& ti1, const NavMap::iterator& ti3,
-                  const CommonTime& when, NavDataPtr& navData)
+   interpolateClk(const InterpWindow& win, const CommonTime& when,
+                  NavDataPtr& navData)
    {
       DEBUGTRACE_FUNCTION();
-      DEBUGTRACE("start interpolating clock, distance = "
-                 << std::distance(ti1,ti3));
+      DEBUGTRACE("start interpolating clock, size = " << win.size);
+         // See interpolateEph.
+      static thread_local LagrangeWeights weights;
       unsigned Nhi = halfOrderClk, Nlow = halfOrderClk-1;
-      std::vector<double> tdata(2*halfOrderClk),
-         biasData(2*halfOrderClk), biasSigData(2*halfOrderClk),
-         driftData(2*halfOrderClk), driftSigData(2*halfOrderClk),
-         drRateData(2*halfOrderClk), drRateSigData(2*halfOrderClk);
-      CommonTime firstTime(ti1->second->timeStamp);
+      const double *tdata = win.t, *biasData = win.val[0],
+         *driftData = win.val[1], *drRateData = win.val[2];
+      const CommonTime& firstTime(win.firstTime);
          // This flag is only used to decide whether to compute sigmas
          // or use existing ones.  It is expected that for exact time
          // matches, navData will already have any sigma data filled
          // in.
-      bool isExact = false;
-      unsigned idx = 0;
+      bool isExact = win.isExact;
+      unsigned idx = win.size;
       bool haveDrift = false, haveDriftRate = false;
-      NavMap::iterator ti2;
-      for (ti2 = ti1, idx=0; ti2 != ti3; ++ti2, ++idx)
-      {
-         DEBUGTRACE("idx=" << idx);
-         tdata[idx] = ti2->second->timeStamp - firstTime;
-         if ((idx == halfOrderClk) && (ti2->second->timeStamp == when))
-            isExact = true;
-         OrbitDataSP3 *nav = dynamic_cast<OrbitDataSP3*>(
-            ti2->second.get());
-         DEBUGTRACE("nav=" << nav);
-         // ti2->second->dump(cerr, DumpDetail::Full);
-         biasData[idx] = nav->clkBias;
-         driftData[idx] = nav->clkDrift;
-         drRateData[idx] = nav->clkDrRate;
-         biasSigData[idx] = nav->biasSig;
-         driftSigData[idx] = nav->driftSig;
-         drRateSigData[idx] = nav->drRateSig;
-         haveDrift |= (nav->clkDrift != 0.0);
-         haveDriftRate |= (nav->clkDrRate != 0.0);
-      }
-      double dt = when - firstTime, err, slope,
+      for (unsigned j = 0; j < idx; j++)
+      {
+         haveDrift |= (driftData[j] != 0.0);
+         haveDriftRate |= (drRateData[j] != 0.0);
+      }
+      double dt = when - firstTime, slope,
          slopedt = tdata[Nhi]-tdata[Nlow];
       OrbitDataSP3 *osp3 = dynamic_cast<OrbitDataSP3*>(navData.get());
       DEBUGTRACE(setprecision(20) << "  dt=" << dt);
-      gnsstk::InvalidRequest unkType(
-         "Clock interpolation type " +
-         StringUtils::asString(static_cast<int>(interpType)) +
-         " is not supported");
+      if ((interpType != ClkInterpType::Lagrange) &&
+          (interpType != ClkInterpType::Linear))
+      {
+         gnsstk::InvalidRequest unkType(
+            "Clock interpolation type " +
+            StringUtils::asString(static_cast<int>(interpType)) +
+            " is not supported");
+         GNSSTK_THROW(unkType);
+      }
+      bool lagrange = (interpType == ClkInterpType::Lagrange);
+      if (lagrange)
+      {
+            // Drift is derived from bias when not available, and
+            // drift rate from drift.
+         weights.setPoints(tdata, idx, dt, !(haveDrift && haveDriftRate));
+      }
       if (haveDrift)
       {
-         switch (interpType)
+         if (lagrange)
          {
-            case ClkInterpType::Lagrange:
-               osp3->clkBias = LagrangeInterpolation(tdata,biasData,dt,err);
-               osp3->clkDrift = LagrangeInterpolation(tdata,driftData,dt,err);
-               break;
-            case ClkInterpType::Linear:
-               slope = (biasData[Nhi]-biasData[Nlow]) / slopedt;
-               osp3->clkBias = biasData[Nlow] + slope*(dt-tdata[Nlow]);
-               slope = (driftData[Nhi]-driftData[Nlow]) / slopedt;
-               osp3->clkDrift = driftData[Nlow] + slope*(dt-tdata[Nlow]);
-               break;
-            default:
-               GNSSTK_THROW(unkType);
-               break;
+            osp3->clkBias = weights.interp(biasData);
+            osp3->clkDrift = weights.interp(driftData);
+         }
+         else
+         {
+            slope = (biasData[Nhi]-biasData[Nlow]) / slopedt;
+            osp3->clkBias = biasData[Nlow] + slope*(dt-tdata[Nlow]);
+            slope = (driftData[Nhi]-driftData[Nlow]) / slopedt;
+            osp3->clkDrift = driftData[Nlow] + slope*(dt-tdata[Nlow]);
          }
             // if isExact, we just use the already populated values.
          if (!isExact)
          {
-            osp3->biasSig = RSS(biasSigData[Nlow], biasSigData[Nhi]);
+            osp3->biasSig = RSS(win.sigLow[0], win.sigHigh[0]);
             DEBUGTRACE("biasSig = " << osp3->biasSig)
             DEBUGTRACE(" driftSig = " << osp3->driftSig)
             DEBUGTRACE(" drRateSig = " << osp3->drRateSig);
          }
-         osp3->driftSig = RSS(driftSigData[Nlow], driftSigData[Nhi]);
+         osp3->driftSig = RSS(win.sigLow[1], win.sigHigh[1]);
       }
       else
       {
             // No drift, we have to derive it numerically
-         switch (interpType)
+         if (lagrange)
          {
-            case ClkInterpType::Lagrange:
-               LagrangeInterpolation(tdata, biasData, dt, osp3->clkBias,
-                                     osp3->clkDrift);
-               break;
-            case ClkInterpType::Linear:
-               slope = (biasData[Nhi]-biasData[Nlow]) / slopedt;
-               osp3->clkDrift = slope;
-               osp3->clkBias = biasData[Nlow] + slope*(dt-tdata[Nlow]);
-               break;
-            default:
-               GNSSTK_THROW(unkType);
-               break;
+            osp3->clkBias = weights.interp(biasData);
+            osp3->clkDrift = weights.deriv(biasData);
+         }
+         else
+         {
+            slope = (biasData[Nhi]-biasData[Nlow]) / slopedt;
+            osp3->clkDrift = slope;
+            osp3->clkBias = biasData[Nlow] + slope*(dt-tdata[Nlow]);
          }
             // if isExact, we just use the already populated values.
          if (!isExact)
          {
-            osp3->biasSig = RSS(biasSigData[Nlow], biasSigData[Nhi]);
+            osp3->biasSig = RSS(win.sigLow[0], win.sigHigh[0]);
             DEBUGTRACE("biasSig = " << osp3->biasSig);
          }
             // linear interpolation of drift
@@ -1297,39 +1924,31 @@ namespace gnsstk
 
       if (haveDriftRate)
       {
-         switch (interpType)
+         if (lagrange)
          {
-            case ClkInterpType::Lagrange:
-               osp3->clkDrRate = LagrangeInterpolation(tdata,drRateData,dt,err);
-               break;
-            case ClkInterpType::Linear:
-               slope = (drRateData[Nhi]-drRateData[Nlow]) / slopedt;
-               osp3->clkDrRate = drRateData[Nlow] + slope*(dt-tdata[Nlow]);
-               break;
-            default:
-               GNSSTK_THROW(unkType);
-               break;
+            osp3->clkDrRate = weights.interp(drRateData);
+         }
+         else
+         {
+            slope = (drRateData[Nhi]-drRateData[Nlow]) / slopedt;
+            osp3->clkDrRate = drRateData[Nlow] + slope*(dt-tdata[Nlow]);
          }
             // if isExact, we just use the already populated values.
          if (!isExact)
          {
-            osp3->drRateSig = RSS(drRateSigData[Nlow], drRateSigData[Nhi]);
+            osp3->drRateSig = RSS(win.sigLow[2], win.sigHigh[2]);
          }
       }
       else if (haveDrift)
       {
             // must interpolate drift to get drift rate
-         switch (interpType)
+         if (lagrange)
          {
-            case ClkInterpType::Lagrange:
-               LagrangeInterpolation(tdata,driftData,dt,err,osp3->clkDrRate);
-               break;
-            case ClkInterpType::Linear:
-               osp3->clkDrRate = (driftData[Nhi]-driftData[Nlow]) / slopedt;
-               break;
-            default:
-               GNSSTK_THROW(unkType);
-               break;
+            osp3->clkDrRate = weights.deriv(driftData);
+         }
+         else
+         {
+            osp3->clkDrRate = (driftData[Nhi]-driftData[Nlow]) / slopedt;
          }
          osp3->drRateSig = osp3->driftSig / slopedt;
       }
@@ -1395,14 +2014,40 @@ namespace gnsstk
    {
       if (useRC == !useSP3clock)
          return;
+      if (frozen)
+      {
+         InvalidRequest exc("Can't modify a frozen factory");
+         GNSSTK_THROW(exc);
+      }
       useSP3clock = !useRC;
       clearClock();
    }
 
 
+   void SP3NavDataFactory ::
+   setPositionInterpOrder(unsigned int order)
+   {
+      if (order > LagrangeWeights::maxPoints)
+      {
+         InvalidParameter exc("Interpolation order " +
+                              StringUtils::asString(order) +
+                              " is too large");
+         GNSSTK_THROW(exc);
+      }
+      halfOrderPos = (order+1)/2;
+   }
+
+
    void SP3NavDataFactory ::
    setClockInterpOrder(unsigned int order)
    {
+      if (order > LagrangeWeights::maxPoints)
+      {
+         InvalidParameter exc("Interpolation order " +
+                              StringUtils::asString(order) +
+                              " is too large");
+         GNSSTK_THROW(exc);
+      }
       if (interpType == ClkInterpType::Lagrange)
          halfOrderClk = (order+1)/2;
       else
@@ -1451,7 +2096,24 @@ namespace gnsstk
       std::map<long,unsigned long> stepCount;
          // reverse of stepCount
       std::map<unsigned long,long> countStep;
-      if (dataIt == data.end())
+      auto gridIt = grids.find(nmid.messageType);
+      if (gridIt != grids.end())
+      {
+         const SP3NavGrid& grid(gridIt->second);
+         for (unsigned sat = 0; sat < grid.numSats(); sat++)
+         {
+            if (grid.getSat(sat) != nmid)
+               continue; // skip non matches
+            long e1 = grid.nextPresent(sat, 0);
+            for (long e2 = grid.nextPresent(sat, e1+1); e2 >= 0;
+                 e1 = e2, e2 = grid.nextPresent(sat, e2+1))
+            {
+               double diff = (e2 - e1) * grid.getStep();
+               stepCount[(long)(diff*100)]++;
+            }
+         }
+      }
+      else if (dataIt == data.end())
       {
          DEBUGTRACE("NO data for nav message type "
                     << StringUtils::asString(nmid.messageType));
@@ -1462,20 +2124,23 @@ namespace gnsstk
          return false;
       }
          // To support wildcard signals, we need to do a linear search.
-      for (const auto& sati : dataIt->second)
-      {
-         if (sati.first != nmid)
-            continue; // skip non matches
-         DEBUGTRACE("found a match");
-         auto ti1 = sati.second.begin();
-         auto ti2 = std::next(ti1);
-         while (ti2 != sati.second.end())
-         {
-            double diff = ti2->first - ti1->first;
-            DEBUGTRACE("diff=" << diff);
-            stepCount[(long)(diff*100)]++;
-            ++ti1;
-            ++ti2;
+      if (gridIt == grids.end())
+      {
+         for (const auto& sati : dataIt->second)
+         {
+            if (sati.first != nmid)
+               continue; // skip non matches
+            DEBUGTRACE("found a match");
+            auto ti1 = sati.second.begin();
+            auto ti2 = std::next(ti1);
+            while (ti2 != sati.second.end())
+            {
+               double diff = ti2->first - ti1->first;
+               DEBUGTRACE("diff=" << diff);
+               stepCount[(long)(diff*100)]++;
+               ++ti1;
+               ++ti2;
+            }
          }
       }
          // Remap stepCount to countStep, which puts the steps in
@@ -42,6 +42,7 @@
 #include "NavDataFactoryWithStoreFile.hpp"
 #include "SP3Data.hpp"
 #include "SP3Header.hpp"
+#include "SP3NavGrid.hpp"
 #include "gnsstk_export.h"
 
 namespace gnsstk
@@ -107,10 +108,61 @@ namespace gnsstk
                 NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
                 NavSearchOrder order) override;
 
-         /// @copydoc NavDataFactoryWithStoreFile::process(const std::string&,NavDataFactoryCallback&)
+         /** Search the store to find the navigation message that
+          * meets the specified criteria.  SP3 data is interpolated
+          * rather than looked up, so the cursor is not used and this
+          * is equivalent to find() with NavSearchOrder::User.
+          * @copydetails NavDataFactory::find(const NavMessageID&,const CommonTime&,NavDataPtr&,SVHealth,NavValidityType,NavFindCursor&) */
+      bool find(const NavMessageID& nmid, const CommonTime& when,
+                NavDataPtr& navOut, SVHealth xmitHealth, NavValidityType valid,
+                NavFindCursor& cursor) override
+      {
+         return find(nmid, when, navOut, xmitHealth, valid,
+                     NavSearchOrder::User);
+      }
+
+         /** Search for the navigation message that meets the
+          * specified criteria.  The results are interpolated rather
+          * than stored, so the result is kept in the cursor as for
+          * NavDataFactory::findRecord().
+          * @copydetails NavDataFactory::findRecord() */
+      const NavData* findRecord(const NavMessageID& nmid,
+                                const CommonTime& when,
+                                SVHealth xmitHealth, NavValidityType valid,
+                                NavFindCursor& cursor) override
+      {
+         return NavDataFactory::findRecord(nmid, when, xmitHealth, valid,
+                                           cursor);
+      }
+
+         /** @copydoc NavDataFactoryWithStoreFile::process(const std::string&,NavDataFactoryCallback&)
+          * @note Files with a time system that differs from that of
+          *   the store are rejected, but unlike addDataSource(),
+          *   this does not set the store's time system or switch to
+          *   RINEX clock data. */
       bool process(const std::string& filename,
                    NavDataFactoryCallback& cb) override;
 
+         /// SP3 and RINEX clock files can be read in parallel.
+      bool isProcessConcurrent() const override
+      { return true; }
+
+         /** Read an SP3 or RINEX clock file without changing the
+          * store.  Checking the time system and switching to RINEX
+          * clock data are left to mergeSource(), and SP3 clock data
+          * is read even if RINEX clock data is in use.
+          * @copydetails NavDataFactoryWithStoreFile::readSource() */
+      bool readSource(const std::string& source,
+                      SourceDataPtr& srcData) override;
+
+         /** Add data read by readSource() to the store, doing
+          * everything else that addDataSource() would, i.e. checking
+          * and setting the time system, switching to RINEX clock
+          * data for RINEX clock files, dropping SP3 clock data when
+          * RINEX clock data is in use and packing dense storage.
+          * @copydetails NavDataFactoryWithStoreFile::mergeSource() */
+      bool mergeSource(SourceData& srcData, bool readOK) override;
+
          /** Load a file into internal store.
           * @post If RINEX clock data is successfully loaded, the
           *   factory will be automatically switched to use RINEX
@@ -119,9 +171,117 @@ namespace gnsstk
           *   and any subsequent attempts to load SP3 data will not
           *   include the clock data from those SP3 files.
           * @param[in] source The path to the SP3 file to load.
-          * @return true on success, false on failure. */
+          * @return true on success, false on failure or if the
+          *   factory is frozen. */
       bool addDataSource(const std::string& source) override;
 
+         /** Load a snapshot written by writeSnapshot() into the
+          * internal store (see
+          * NavDataFactoryWithStore::readSnapshot()).  Files loaded
+          * afterwards must use the same time system as the snapshot.
+          * @note The choice of SP3 or RINEX clock data is not part of
+          *   the snapshot.  If the snapshot contains RINEX clock data
+          *   and more SP3 files are to be loaded, call
+          *   useRinexClockData() first.
+          * @param[in] filename The path of the snapshot file to read.
+          * @return true on success, false on failure or if the
+          *   factory is frozen. */
+      bool readSnapshot(const std::string& filename) override;
+
+         /** Write the contents of the store, including any data in
+          * dense storage (see setDenseStorage()), to a snapshot
+          * file (see NavDataFactoryWithStore::writeSnapshot()).
+          * @param[in] filename The path of the snapshot file to write.
+          * @return true on success, false on failure. */
+      bool writeSnapshot(const std::string& filename) const override;
+
+         /** Enable or disable dense storage of the ephemeris and
+          * clock data (see SP3NavGrid).  In dense mode, data loaded
+          * by addDataSource() or readSnapshot() is moved from the
+          * maps into arrays indexed by satellite and epoch, which
+          * takes roughly a tenth of the memory and lets find()
+          * locate the interpolation points by index arithmetic
+          * rather than by searching the maps.  The results of
+          * find() are unchanged.  Data that doesn't fit on a
+          * regular time grid, e.g. a mixture of 5 and 15 minute
+          * SP3 files, is kept in the maps.
+          * @note In dense mode, getNavMessageMap() and
+          *   getNavNearMessageMap() only contain the data that is
+          *   not in dense storage.  Data added with addNavData() is
+          *   merged into dense storage straight away if there is
+          *   already dense storage for its message type, otherwise
+          *   by the next call to compact() or addDataSource().
+          * @param[in] dense If true, use dense storage, converting
+          *   any data already loaded.  If false, move any data in
+          *   dense storage back to the maps.
+          * @throw InvalidRequest if the factory is frozen. */
+      void setDenseStorage(bool dense);
+
+         /// Return true if dense storage is enabled.
+      bool getDenseStorage() const
+      { return denseStorage; }
+
+      using NavDataFactoryWithStore::addNavData;
+         /** Add a nav message to the given store, merging it into
+          * dense storage if there is already dense storage for its
+          * message type, so that find() never has to look in both.
+          * @copydetails NavDataFactoryWithStore::addNavData(const NavDataPtr&,NavMessageMap&,NavNearMessageMap&,OffsetCvtMap&) */
+      bool addNavData(const NavDataPtr& nd, NavMessageMap& navMap,
+                      NavNearMessageMap& navNearMap,
+                      OffsetCvtMap& ofsMap) override;
+
+         /// @copydoc NavDataFactoryWithStore::edit(const CommonTime&,const CommonTime&)
+      void edit(const CommonTime& fromTime, const CommonTime& toTime) override;
+
+         /// @copydoc NavDataFactoryWithStore::edit(const CommonTime&,const CommonTime&,const NavSatelliteID&)
+      void edit(const CommonTime& fromTime, const CommonTime& toTime,
+                const NavSatelliteID& satID) override;
+
+         /// @copydoc NavDataFactoryWithStore::edit(const CommonTime&,const CommonTime&,const NavSignalID&)
+      void edit(const CommonTime& fromTime, const CommonTime& toTime,
+                const NavSignalID& signal) override;
+
+         /// @copydoc NavDataFactoryWithStore::clear()
+      void clear() override;
+
+         /** Move the data into dense storage if it is enabled (see
+          * setDenseStorage()), then build the flat index of what
+          * remains in the maps (see
+          * NavDataFactoryWithStore::compact()). */
+      void compact() override;
+
+      using NavDataFactoryWithStore::getAvailableSats;
+         /// @copydoc NavDataFactoryWithStore::getAvailableSats(NavMessageType,const CommonTime&,const CommonTime&) const
+      NavSatelliteIDSet getAvailableSats(NavMessageType nmt,
+                                         const CommonTime& fromTime,
+                                         const CommonTime& toTime)
+         const override;
+
+         /// @copydoc NavDataFactoryWithStore::getAvailableMsgs()
+      NavMessageIDSet getAvailableMsgs(const CommonTime& fromTime,
+                                       const CommonTime& toTime) const override;
+
+         /// Return the number of nav messages in the store.
+      size_t size() const override;
+
+      using NavDataFactoryWithStore::count;
+         /// @copydoc NavDataFactoryWithStore::count(const NavMessageID&) const
+      size_t count(const NavMessageID& nmid) const override;
+
+         /// @copydoc NavDataFactoryWithStore::count(SatelliteSystem,NavMessageType) const
+      size_t count(SatelliteSystem sys,
+                   NavMessageType nmt = NavMessageType::Unknown)
+         const override;
+
+         /// @copydoc NavDataFactoryWithStore::numSignals()
+      size_t numSignals() const override;
+
+         /// @copydoc NavDataFactoryWithStore::numSatellites()
+      size_t numSatellites() const override;
+
+         /// @copydoc NavDataFactoryWithStore::dump()
+      void dump(std::ostream& s, DumpDetail dl) const override;
+
          /// Return a comma-separated list of formats supported by this factory.
       std::string getFactoryFormats() const override;
 
@@ -172,9 +332,21 @@ namespace gnsstk
                                 NavMessageID& nmidOut);
 
          /** Clear the clock dataset only, meaning remove all clock
-          * data from the internal store. */
+          * data from the internal store.
+          * @throw InvalidRequest if the factory is frozen. */
       void clearClock()
-      { data.erase(NavMessageType::Clock); }
+      {
+         if (frozen)
+         {
+            InvalidRequest exc("Can't modify a frozen factory");
+            GNSSTK_THROW(exc);
+         }
+         discardIndex();
+         data.erase(NavMessageType::Clock);
+         grids.erase(NavMessageType::Clock);
+         recountNavData();
+         discardTimeIndex();
+      }
 
          /** Choose to load the clock data tables from RINEX clock
           * files. This will clear the clock store if the state
@@ -186,7 +358,9 @@ namespace gnsstk
           *   with an SP3 file, the SP3 clock data will not be loaded.
           *   But if it's called after loading SP3 or RINEX clock
           *   data, that data will be cleared from the internal
-          *   storage. */
+          *   storage.
+          * @throw InvalidRequest if the state changes while the
+          *   factory is frozen. */
       void useRinexClockData(bool useRC = true);
 
          /// Return the time system of the loaded data.
@@ -303,9 +477,10 @@ namespace gnsstk
       { return 2*halfOrderPos; }
 
          /** Set the interpolation order for the position table; it is
-          * forced to be even. */
-      void setPositionInterpOrder(unsigned int order)
-      { halfOrderPos = (order+1)/2; }
+          * forced to be even.
+          * @throw InvalidParameter if order is greater than
+          *   LagrangeWeights::maxPoints. */
+      void setPositionInterpOrder(unsigned int order);
 
          /** Get current interpolation order for the clock data
           * (meaningless if the interpolation type is linear). */
@@ -314,7 +489,9 @@ namespace gnsstk
 
          /** Set the interpolation order for the clock table; it is
           * forced to be even.  This is ignored if the clock
-          * interpolation type is linear. */
+          * interpolation type is linear.
+          * @throw InvalidParameter if order is greater than
+          *   LagrangeWeights::maxPoints. */
       void setClockInterpOrder(unsigned int order);
 
          /** Set the type of clock interpolation to Lagrange (the
@@ -344,16 +521,65 @@ namespace gnsstk
           * @return true if successful, false if the system is unsupported. */
       static bool setSignal(const SatID& sat, NavMessageID& signal);
 
+         /// @copydoc NavDataFactoryWithStore::getSatellites()
+      void getSatellites(NavSatelliteIDSet& sats) const override;
+
    private:
-         /** Load a RINEX clock file into internal store.
-          * @post If RINEX clock data is successfully loaded, the
-          *   factory will be automatically switched to use RINEX
-          *   clock data in place of SP3 clock.
-          * @param[in] source The path to the RINEX clock file to load.
+         /// Interpolation points gathered for interpolateEph/Clk.
+      struct InterpWindow;
+
+         /// What readSource() found out about a file, for mergeSource().
+      class SP3SourceData : public SourceData
+      {
+      public:
+         SP3SourceData()
+               : sp3(false), rinexClock(false),
+                 timeSystem(TimeSystem::Unknown)
+         {}
+            /// True if the file has a valid SP3 header.
+         bool sp3;
+            /** True if the file has a valid RINEX clock header and
+             * clock data is being processed. */
+         bool rinexClock;
+            /// The time system in the file header.
+         TimeSystem timeSystem;
+      };
+
+         /** Read an SP3 file, or a RINEX clock file using
+          * readRinexClock(), without changing the factory.
+          * @param[in] filename The path to the file to read.
           * @param[in] cb The callback object that stores or otherwise
-          *   processes the given data (obj).
+          *   processes the data in the file.
+          * @param[out] info What was found out about the file.
+          * @param[in] sp3Clock If false, clock data in SP3 files is
+          *   not processed.
+          * @param[in] storeTS Reject files whose time system differs
+          *   from this, unless it is TimeSystem::Any.
+          * @return true on success, false on failure. */
+      bool readFile(const std::string& filename, NavDataFactoryCallback& cb,
+                    SP3SourceData& info, bool sp3Clock, TimeSystem storeTS);
+
+         /** Read a RINEX clock file without changing the factory.
+          * @param[in] source The path to the RINEX clock file to read.
+          * @param[in] cb The callback object that stores or otherwise
+          *   processes the data in the file.
+          * @param[out] info What was found out about the file.
+          * @param[in] storeTS Reject files whose time system differs
+          *   from this, unless it is TimeSystem::Any.
           * @return true on success, false on failure. */
-      bool addRinexClock(const std::string& source, NavDataFactoryCallback& cb);
+      bool readRinexClock(const std::string& source,
+                          NavDataFactoryCallback& cb, SP3SourceData& info,
+                          TimeSystem storeTS);
+
+         /** Check that a file's time system is consistent with the
+          * store, printing an error to cerr if not.
+          * @param[in] storeTS The time system of the store.
+          * @param[in] fileTS The time system in the file header.
+          * @param[in] what A description of the file type for the
+          *   error message.
+          * @return false if both time systems are set and differ. */
+      static bool checkTimeSystem(TimeSystem storeTS, TimeSystem fileTS,
+                                  const std::string& what);
       
          /** Store the given NavDataPtr object internally, provided it
           * passes any requested valditity checking. 
@@ -386,44 +612,86 @@ namespace gnsstk
       bool findGeneric(NavMessageType nmt, const NavSatelliteID& nsid,
                        const CommonTime& when, NavDataPtr& navData);
 
-      bool findIterator(NavSatMap::iterator& sati,
-                        const CommonTime& when, NavDataPtr& navData,
-                        unsigned halfOrder, bool findEph,
-                        bool checkDataGap, bool checkInterval,
-                        double gapInterval, double maxInterval);
+         /** Search one satellite's data for the time of interest,
+          * and copy or interpolate the result into navData.
+          * @param[in] seq The satellite's data, either a NavMap or
+          *   an SP3NavGrid, via the adapter classes in the
+          *   implementation.
+          * @param[in] when The time for which the data should be
+          *   retrieved (and interpolated, if appropriate).
+          * @param[in,out] navData The navData object, in the form of
+          *   an OrbitDataSP3, to contain the results.  If navData is
+          *   not allocated, it will be.
+          * @param[in] halfOrder Half the number of interpolation points.
+          * @param[in] findEph If true, look for ephemeris data,
+          *   otherwise clock data.
+          * @param[in] checkDataGap If true, fail when the data
+          *   around when is more than gapInterval apart.
+          * @param[in] checkInterval If true, fail when the
+          *   interpolation points span more than maxInterval.
+          * @param[in] gapInterval See checkDataGap.
+          * @param[in] maxInterval See checkInterval.
+          * @return true on success, false if unable to find data or
+          *   interpolate. */
+      template <class Seq>
+      bool findSeq(Seq& seq, const CommonTime& when, NavDataPtr& navData,
+                   unsigned halfOrder, bool findEph,
+                   bool checkDataGap, bool checkInterval,
+                   double gapInterval, double maxInterval);
+
+         /** Interpolate ephemeris or clock data from the sequence
+          * [ti1,ti3) of seq into navData. */
+      template <class Seq>
+      void interpolate(Seq& seq, const typename Seq::Pos& ti1,
+                       const typename Seq::Pos& ti3,
+                       const CommonTime& when, bool findEph,
+                       NavDataPtr& navData);
 
          /** Interpolate the ephemeris data
-          * (position/velocity/acceleration) from the data in the
-          * sequence [ti1,ti3).
-          * @param[in] ti1 The iterator marking the first OrbitDataSP3
-          *   object in the internal store to be used in interpolation.
-          * @param[in] ti3 The iterator marking the first OrbitDataSP3
-          *   object in the internal store after ti1 to NOT be used
-          *   interpolation (use like end() in typical iterator
-          *   usage).
+          * (position/velocity/acceleration) from the gathered
+          * interpolation points.
+          * @param[in] win The interpolation points.
           * @param[in] when The time at which to interpolate the data.
           * @param[in,out] navData The pre-allocated NavDataPtr object
           *   that stores the interpolated OrbitDataSP3. */
-      void interpolateEph(const NavMap::iterator& ti1,
-                          const NavMap::iterator& ti3,
+      void interpolateEph(const InterpWindow& win,
                           const CommonTime& when, NavDataPtr& navData);
 
          /** Interpolate the SV clock correction data
-          * (bias/drift/drift rate) from the data in the sequence
-          * [ti1,ti3).
-          * @param[in] ti1 The iterator marking the first OrbitDataSP3
-          *   object in the internal store to be used in interpolation.
-          * @param[in] ti3 The iterator marking the first OrbitDataSP3
-          *   object in the internal store after ti1 to NOT be used
-          *   interpolation (use like end() in typical iterator
-          *   usage).
+          * (bias/drift/drift rate) from the gathered interpolation
+          * points.
+          * @param[in] win The interpolation points.
           * @param[in] when The time at which to interpolate the data.
           * @param[in,out] navData The pre-allocated NavDataPtr object
           *   that stores the interpolated OrbitDataSP3. */
-      void interpolateClk(const NavMap::iterator& ti1,
-                          const NavMap::iterator& ti3,
+      void interpolateClk(const InterpWindow& win,
                           const CommonTime& when, NavDataPtr& navData);
 
+         /** Move the contents of the maps into dense storage.  Data
+          * of a message type that can't be stored densely is left
+          * in (or returned to) the maps. */
+      void packData();
+
+         /** Move the contents of the maps of one message type into
+          * dense storage, as packData() does.
+          * @param[in] nmt The message type to pack.
+          * @return true if anything was moved. */
+      bool packData(NavMessageType nmt);
+
+         /** Move the contents of dense storage back into the maps.
+          * @throw InvalidRequest if the factory is frozen. */
+      void unpackData();
+
+         /** Copy the samples in grid into navMap and navNearMap as
+          * OrbitDataSP3 objects.  Samples for which navMap already
+          * has a record are skipped. */
+      static void unpackGrid(const SP3NavGrid& grid, NavMessageMap& navMap,
+                             NavNearMessageMap& navNearMap);
+
+         /** Fill tmp with a copy of all the data in this store,
+          * with none of it in dense storage. */
+      void unpackCopy(SP3NavDataFactory& tmp) const;
+
          /** Load SP3 nav data into a map.
           * @note This method is unused, in favor of overriding
           *   addDataSource directly and using its own store rather
@@ -534,6 +802,19 @@ namespace gnsstk
 
          /// Clock data interpolation method.
       ClkInterpType interpType;
+
+         /// If true, store data in grids rather than in data.
+      bool denseStorage;
+
+         /** If true, addNavData() leaves data in the maps for
+          * packData() to merge in one go once a whole file has been
+          * added. */
+      bool deferPack;
+
+         /** Dense storage of the data by message type, used instead
+          * of data when denseStorage is set.  Only contains
+          * non-empty grids. */
+      std::map<NavMessageType, SP3NavGrid> grids;
    };
 
       //@}
@@ -0,0 +1,761 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <limits>
+#include "SP3NavGrid.hpp"
+
+namespace gnsstk
+{
+   const unsigned SP3NavGrid::maxCellsPerSample;
+
+
+      /** Return true if two values are the same, treating NaNs as
+       * equal to each other. */
+   static bool sameValue(double a, double b)
+   {
+      return (a == b) || (std::isnan(a) && std::isnan(b));
+   }
+
+
+      /** Compute the epoch index of a time on a grid.
+       * @param[in] when The time to compute the index of.
+       * @param[in] start The time of epoch 0.
+       * @param[in] step The time step between epochs.
+       * @param[out] epoch The index of when on the grid.
+       * @return true if when is exactly on the grid. */
+   static bool gridEpoch(const CommonTime& when, const CommonTime& start,
+                         double step, long& epoch)
+   {
+      if (when.getTimeSystem() != start.getTimeSystem())
+      {
+         return false;
+      }
+      epoch = std::lround((when - start) / step);
+      return (start + epoch * step) == when;
+   }
+
+
+   SP3NavGrid ::
+   SP3NavGrid()
+         : msgType(NavMessageType::Unknown),
+           primary(PosX),
+           step(0.0),
+           nEpochs(0)
+   {
+      std::fill(constant, constant+NumColumns, 0.0);
+   }
+
+
+   bool SP3NavGrid ::
+   merge(NavMessageType nmt, const NavSatMap& recs)
+   {
+      if (!empty() && (nmt != msgType))
+      {
+         return false;
+      }
+      Column prim;
+      if (nmt == NavMessageType::Ephemeris)
+      {
+         prim = PosX;
+      }
+      else if (nmt == NavMessageType::Clock)
+      {
+         prim = ClkBias;
+      }
+      else
+      {
+         return false;
+      }
+      if (mergeInPlace(nmt, recs))
+      {
+         return true;
+      }
+         // Check the records and determine the extent of the new
+         // grid.  The time step of an existing grid can't change.
+      size_t nRecs = 0;
+      double newStep = empty() ? 0.0 : step;
+      CommonTime tMin, tMax;
+      if (!empty())
+      {
+         tMin = t0;
+         tMax = getTime(nEpochs-1);
+      }
+      std::map<NavSatelliteID, SatInfo> newSats;
+      for (const auto& si : sats)
+      {
+         newSats[si.id] = si;
+      }
+      for (const auto& sati : recs)
+      {
+         auto nsi = newSats.find(sati.first);
+         bool known = (nsi != newSats.end());
+         const CommonTime *prev = nullptr;
+         for (const auto& ti : sati.second)
+         {
+            const OrbitDataSP3 *od = dynamic_cast<const OrbitDataSP3*>(
+               ti.second.get());
+            if ((od == nullptr) || (od->getMsgLenSec() != 0.0) ||
+                (od->signal.messageType != nmt) ||
+                std::isnan(getValue(*od, prim)))
+            {
+               return false;
+            }
+            if (!known)
+            {
+               SatInfo& info(newSats[sati.first]);
+               info.id = sati.first;
+               info.proto.signal = od->signal;
+               info.proto.weekFmt = od->weekFmt;
+               info.proto.coordSystem = od->coordSystem;
+               info.proto.frame = od->frame;
+               nsi = newSats.find(sati.first);
+               known = true;
+            }
+            else if ((od->signal != nsi->second.proto.signal) ||
+                     (od->weekFmt != nsi->second.proto.weekFmt) ||
+                     (od->coordSystem != nsi->second.proto.coordSystem) ||
+                     (od->frame != nsi->second.proto.frame))
+            {
+               return false;
+            }
+            if ((nRecs == 0) && empty())
+            {
+               tMin = tMax = ti.first;
+            }
+            else if (ti.first.getTimeSystem() != tMin.getTimeSystem())
+            {
+               return false;
+            }
+            else
+            {
+               tMin = std::min(tMin, ti.first);
+               tMax = std::max(tMax, ti.first);
+            }
+            if ((prev != nullptr) && empty())
+            {
+               double diff = ti.first - *prev;
+               if ((newStep == 0.0) || (diff < newStep))
+               {
+                  newStep = diff;
+               }
+            }
+            prev = &ti.first;
+            nRecs++;
+         }
+      }
+      if (nRecs == 0)
+      {
+         return true;
+      }
+      if (!(newStep > 0.0))
+      {
+         return false;
+      }
+      long lastEpoch, shift = 0;
+      if (!gridEpoch(tMax, tMin, newStep, lastEpoch) ||
+          (!empty() && !gridEpoch(t0, tMin, newStep, shift)))
+      {
+         return false;
+      }
+      double cells = static_cast<double>(lastEpoch+1) * newSats.size();
+      if (cells > static_cast<double>(maxCellsPerSample) * (size() + nRecs))
+      {
+         return false;
+      }
+         // Check that every record is on the grid and find which
+         // columns actually need to be stored.
+      bool varies[NumColumns], known[NumColumns];
+      double value[NumColumns];
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         varies[col] = (col == prim) || (!empty() && !values[col].empty());
+         known[col] = !empty();
+         value[col] = constant[col];
+      }
+      for (const auto& sati : recs)
+      {
+         for (const auto& ti : sati.second)
+         {
+            long epoch;
+            if (!gridEpoch(ti.first, tMin, newStep, epoch))
+            {
+               return false;
+            }
+            const OrbitDataSP3& od(
+               static_cast<const OrbitDataSP3&>(*ti.second));
+            for (unsigned col = 0; col < NumColumns; col++)
+            {
+               double val = getValue(od, col);
+               if (!known[col])
+               {
+                  value[col] = val;
+                  known[col] = true;
+               }
+               else if (!sameValue(val, value[col]))
+               {
+                  varies[col] = true;
+               }
+            }
+         }
+      }
+         // Everything checks out, build the new grid.
+      SP3NavGrid ng;
+      ng.msgType = nmt;
+      ng.primary = prim;
+      ng.t0 = tMin;
+      ng.step = newStep;
+      ng.nEpochs = lastEpoch+1;
+      for (auto& nsi : newSats)
+      {
+         ng.satIndex[nsi.first] = ng.sats.size();
+         ng.sats.push_back(nsi.second);
+      }
+      size_t cellCount = ng.sats.size() * ng.nEpochs;
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         ng.constant[col] = value[col];
+         if (varies[col])
+         {
+            ng.values[col].resize(cellCount,
+                                  std::numeric_limits<double>::quiet_NaN());
+         }
+      }
+      for (unsigned sat = 0; sat < sats.size(); sat++)
+      {
+         size_t base = ng.satIndex[sats[sat].id] * ng.nEpochs + shift;
+         for (long epoch = 0; epoch < nEpochs; epoch++)
+         {
+            if (!isPresent(sat, epoch))
+               continue;
+            for (unsigned col = 0; col < NumColumns; col++)
+            {
+               if (varies[col])
+               {
+                  ng.values[col][base+epoch] = getValue(sat, epoch, col);
+               }
+            }
+         }
+      }
+      for (const auto& sati : recs)
+      {
+         size_t base = ng.satIndex[sati.first] * ng.nEpochs;
+         for (const auto& ti : sati.second)
+         {
+            long epoch;
+            gridEpoch(ti.first, tMin, newStep, epoch);
+            const OrbitDataSP3& od(
+               static_cast<const OrbitDataSP3&>(*ti.second));
+            for (unsigned col = 0; col < NumColumns; col++)
+            {
+               if (varies[col])
+               {
+                  ng.values[col][base+epoch] = getValue(od, col);
+               }
+            }
+         }
+      }
+      for (unsigned sat = 0; sat < ng.sats.size(); sat++)
+      {
+         ng.sats[sat].count = 0;
+         for (long epoch = 0; epoch < ng.nEpochs; epoch++)
+         {
+            if (ng.isPresent(sat, epoch))
+               ng.sats[sat].count++;
+         }
+      }
+      *this = std::move(ng);
+      return true;
+   }
+
+
+   bool SP3NavGrid ::
+   mergeInPlace(NavMessageType nmt, const NavSatMap& recs)
+   {
+      if (empty())
+      {
+         return false;
+      }
+         // Check everything before changing anything.
+      for (const auto& sati : recs)
+      {
+         long sat = findSat(sati.first);
+         if (sat < 0)
+         {
+            return false;
+         }
+         const OrbitDataSP3& proto(sats[sat].proto);
+         for (const auto& ti : sati.second)
+         {
+            const OrbitDataSP3 *od = dynamic_cast<const OrbitDataSP3*>(
+               ti.second.get());
+            if ((od == nullptr) || (od->getMsgLenSec() != 0.0) ||
+                (od->signal.messageType != nmt) ||
+                std::isnan(getValue(*od, primary)) ||
+                (od->signal != proto.signal) ||
+                (od->weekFmt != proto.weekFmt) ||
+                (od->coordSystem != proto.coordSystem) ||
+                (od->frame != proto.frame) ||
+                (ti.first.getTimeSystem() != t0.getTimeSystem()) ||
+                (findEpoch(ti.first) < 0))
+            {
+               return false;
+            }
+            for (unsigned col = 0; col < NumColumns; col++)
+            {
+               if (values[col].empty() &&
+                   !sameValue(getValue(*od, col), constant[col]))
+               {
+                  return false;
+               }
+            }
+         }
+      }
+      for (const auto& sati : recs)
+      {
+         unsigned sat = satIndex[sati.first];
+         for (const auto& ti : sati.second)
+         {
+            long epoch = findEpoch(ti.first);
+            if (!isPresent(sat, epoch))
+            {
+               sats[sat].count++;
+            }
+            const OrbitDataSP3& od(
+               static_cast<const OrbitDataSP3&>(*ti.second));
+            for (unsigned col = 0; col < NumColumns; col++)
+            {
+               if (!values[col].empty())
+               {
+                  values[col][sat * nEpochs + epoch] = getValue(od, col);
+               }
+            }
+         }
+      }
+      return true;
+   }
+
+
+   void SP3NavGrid ::
+   erase(const CommonTime& fromTime, const CommonTime& toTime)
+   {
+      eraseSamples(fromTime, toTime, nullptr);
+   }
+
+
+   void SP3NavGrid ::
+   erase(const CommonTime& fromTime, const CommonTime& toTime,
+         const NavSatelliteID& satID)
+   {
+      eraseSamples(fromTime, toTime, &satID);
+   }
+
+
+   void SP3NavGrid ::
+   eraseSamples(const CommonTime& fromTime, const CommonTime& toTime,
+                const NavSatelliteID *satID)
+   {
+      if (empty())
+      {
+         return;
+      }
+      long from = lowerBound(fromTime), to = lowerBound(toTime);
+      if (from >= to)
+      {
+         return;
+      }
+      bool emptied = false;
+      for (unsigned sat = 0; sat < sats.size(); sat++)
+      {
+         if ((satID != nullptr) && !(sats[sat].id == *satID))
+            continue;
+         double *prim = &values[primary][sat * nEpochs];
+         for (long epoch = from; epoch < to; epoch++)
+         {
+            if (!std::isnan(prim[epoch]))
+            {
+               prim[epoch] = std::numeric_limits<double>::quiet_NaN();
+               sats[sat].count--;
+            }
+         }
+         emptied |= (sats[sat].count == 0);
+      }
+         // The epochs at the ends of the grid always have samples,
+         // so only the ends that were edited can move.
+      long first = 0, last = nEpochs-1;
+      auto anyPresent = [this](long epoch)
+      {
+         for (unsigned sat = 0; sat < sats.size(); sat++)
+         {
+            if (isPresent(sat, epoch))
+               return true;
+         }
+         return false;
+      };
+      if (from == 0)
+      {
+         while ((first < nEpochs) && !anyPresent(first))
+            first++;
+      }
+      if (first == nEpochs)
+      {
+         clear();
+         return;
+      }
+      if (to == nEpochs)
+      {
+         while (!anyPresent(last))
+            last--;
+      }
+      if (emptied || (first > 0) || (last < nEpochs-1))
+      {
+         trim(first, last);
+      }
+   }
+
+
+   void SP3NavGrid ::
+   trim(long first, long last)
+   {
+      long newEpochs = last - first + 1;
+      std::vector<SatInfo> newSats;
+      std::vector<unsigned> keep;
+      for (unsigned sat = 0; sat < sats.size(); sat++)
+      {
+         if (sats[sat].count > 0)
+         {
+            keep.push_back(sat);
+            newSats.push_back(sats[sat]);
+         }
+      }
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         if (values[col].empty())
+            continue;
+            // Rows only move towards the start, so this can be done
+            // in place.
+         double *vals = values[col].data();
+         for (size_t i = 0; i < keep.size(); i++)
+         {
+            const double *src = vals + keep[i] * nEpochs + first;
+            std::copy(src, src + newEpochs, vals + i * newEpochs);
+         }
+         values[col].resize(keep.size() * newEpochs);
+         values[col].shrink_to_fit();
+      }
+      t0 = getTime(first);
+      nEpochs = newEpochs;
+      sats.swap(newSats);
+      satIndex.clear();
+      for (unsigned sat = 0; sat < sats.size(); sat++)
+      {
+         satIndex[sats[sat].id] = sat;
+      }
+   }
+
+
+   void SP3NavGrid ::
+   clear()
+   {
+      *this = SP3NavGrid();
+   }
+
+
+   size_t SP3NavGrid ::
+   size() const
+   {
+      size_t rv = 0;
+      for (const auto& si : sats)
+      {
+         rv += si.count;
+      }
+      return rv;
+   }
+
+
+   size_t SP3NavGrid ::
+   storedValues() const
+   {
+      size_t rv = 0;
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         rv += values[col].size();
+      }
+      return rv;
+   }
+
+
+   long SP3NavGrid ::
+   findSat(const NavSatelliteID& nsid) const
+   {
+      auto sii = satIndex.find(nsid);
+      if (sii == satIndex.end())
+      {
+         return -1;
+      }
+      return sii->second;
+   }
+
+
+   long SP3NavGrid ::
+   lowerBound(const CommonTime& when) const
+   {
+      if (nEpochs == 0)
+      {
+         return 0;
+      }
+      double d = (when - t0) / step;
+      if (d <= 0)
+      {
+         return 0;
+      }
+      if (d >= nEpochs)
+      {
+         return nEpochs;
+      }
+      long rv = std::ceil(d);
+      if (nearInteger(d))
+      {
+            // Take care of any rounding error in the division.
+         while ((rv > 0) && !(getTime(rv-1) < when))
+            rv--;
+         while ((rv < nEpochs) && (getTime(rv) < when))
+            rv++;
+      }
+      return rv;
+   }
+
+
+   long SP3NavGrid ::
+   upperBound(const CommonTime& when) const
+   {
+      if (nEpochs == 0)
+      {
+         return 0;
+      }
+      double d = (when - t0) / step;
+      if (d < -1)
+      {
+         return 0;
+      }
+      if (d >= nEpochs)
+      {
+         return nEpochs;
+      }
+      long rv = std::floor(d) + 1;
+      if (nearInteger(d))
+      {
+            // Take care of any rounding error in the division.
+         while ((rv > 0) && (when < getTime(rv-1)))
+            rv--;
+         while ((rv < nEpochs) && !(when < getTime(rv)))
+            rv++;
+      }
+      return rv;
+   }
+
+
+   long SP3NavGrid ::
+   findEpoch(const CommonTime& when) const
+   {
+      if (nEpochs == 0)
+      {
+         return -1;
+      }
+      double d = (when - t0) / step;
+      if (!nearInteger(d) || (d < -1) || (d > nEpochs))
+      {
+         return -1;
+      }
+      long rv = std::lround(d);
+      if ((rv < 0) || (rv >= nEpochs) || (getTime(rv) != when))
+      {
+         return -1;
+      }
+      return rv;
+   }
+
+
+   bool SP3NavGrid ::
+   nearInteger(double d)
+   {
+      return std::fabs(d - std::round(d)) < 1e-6;
+   }
+
+
+   bool SP3NavGrid ::
+   hasData(unsigned sat, const CommonTime& fromTime,
+           const CommonTime& toTime) const
+   {
+      long epoch = nextPresent(sat, lowerBound(fromTime));
+      return (epoch >= 0) && (getTime(epoch) < toTime);
+   }
+
+
+   long SP3NavGrid ::
+   nextPresent(unsigned sat, long epoch) const
+   {
+      for (epoch = std::max(epoch, 0L); epoch < nEpochs; epoch++)
+      {
+         if (isPresent(sat, epoch))
+            return epoch;
+      }
+      return -1;
+   }
+
+
+   long SP3NavGrid ::
+   prevPresent(unsigned sat, long epoch) const
+   {
+      for (epoch = std::min(epoch, nEpochs-1); epoch >= 0; epoch--)
+      {
+         if (isPresent(sat, epoch))
+            return epoch;
+      }
+      return -1;
+   }
+
+
+   void SP3NavGrid ::
+   getRecord(unsigned sat, long epoch, OrbitDataSP3& od) const
+   {
+      od = sats[sat].proto;
+      od.timeStamp = getTime(epoch);
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         setValue(od, col, getValue(sat, epoch, col));
+      }
+   }
+
+
+   std::shared_ptr<OrbitDataSP3> SP3NavGrid ::
+   getRecord(unsigned sat, long epoch) const
+   {
+      std::shared_ptr<OrbitDataSP3> rv =
+         std::make_shared<OrbitDataSP3>(sats[sat].proto);
+      rv->timeStamp = getTime(epoch);
+      for (unsigned col = 0; col < NumColumns; col++)
+      {
+         setValue(*rv, col, getValue(sat, epoch, col));
+      }
+      return rv;
+   }
+
+
+   double SP3NavGrid ::
+   getValue(const OrbitDataSP3& od, unsigned col)
+   {
+      switch (col)
+      {
+         case PosX: case PosY: case PosZ:
+            return od.pos[col-PosX];
+         case PosSigX: case PosSigY: case PosSigZ:
+            return od.posSig[col-PosSigX];
+         case VelX: case VelY: case VelZ:
+            return od.vel[col-VelX];
+         case VelSigX: case VelSigY: case VelSigZ:
+            return od.velSig[col-VelSigX];
+         case AccX: case AccY: case AccZ:
+            return od.acc[col-AccX];
+         case AccSigX: case AccSigY: case AccSigZ:
+            return od.accSig[col-AccSigX];
+         case ClkBias:
+            return od.clkBias;
+         case BiasSig:
+            return od.biasSig;
+         case ClkDrift:
+            return od.clkDrift;
+         case DriftSig:
+            return od.driftSig;
+         case ClkDrRate:
+            return od.clkDrRate;
+         case DrRateSig:
+            return od.drRateSig;
+         default:
+            return std::numeric_limits<double>::quiet_NaN();
+      }
+   }
+
+
+   void SP3NavGrid ::
+   setValue(OrbitDataSP3& od, unsigned col, double val)
+   {
+      switch (col)
+      {
+         case PosX: case PosY: case PosZ:
+            od.pos[col-PosX] = val;
+            break;
+         case PosSigX: case PosSigY: case PosSigZ:
+            od.posSig[col-PosSigX] = val;
+            break;
+         case VelX: case VelY: case VelZ:
+            od.vel[col-VelX] = val;
+            break;
+         case VelSigX: case VelSigY: case VelSigZ:
+            od.velSig[col-VelSigX] = val;
+            break;
+         case AccX: case AccY: case AccZ:
+            od.acc[col-AccX] = val;
+            break;
+         case AccSigX: case AccSigY: case AccSigZ:
+            od.accSig[col-AccSigX] = val;
+            break;
+         case ClkBias:
+            od.clkBias = val;
+            break;
+         case BiasSig:
+            od.biasSig = val;
+            break;
+         case ClkDrift:
+            od.clkDrift = val;
+            break;
+         case DriftSig:
+            od.driftSig = val;
+            break;
+         case ClkDrRate:
+            od.clkDrRate = val;
+            break;
+         case DrRateSig:
+            od.drRateSig = val;
+            break;
+         default:
+            break;
+      }
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,299 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_SP3NAVGRID_HPP
+#define GNSSTK_SP3NAVGRID_HPP
+
+#include <cmath>
+#include <map>
+#include <vector>
+#include "OrbitDataSP3.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Dense, epoch-by-satellite storage for tabular SP3 or RINEX
+       * clock data of a single message type (ephemeris or clock).
+       *
+       * Tabular orbit and clock products have (nearly) every
+       * satellite at every epoch of a fixed time step.  Storing
+       * each sample as an individually allocated OrbitDataSP3 in
+       * nested maps costs several hundred bytes per sample, and
+       * looking up the samples around a time of interest means
+       * walking a tree.  SP3NavGrid instead keeps each value
+       * (position X, clock bias, etc.) in an array indexed by
+       * satellite and epoch, so the samples needed for
+       * interpolation are located by index arithmetic.  Values
+       * that are the same for every sample, such as the unused
+       * clock fields of ephemeris samples or absent velocities,
+       * are stored once rather than per sample.
+       *
+       * A NaN in the primary value of a sample (position X for
+       * ephemeris, clock bias for clock) marks a satellite
+       * missing at that epoch.  Data that can't be represented,
+       * e.g. because the sample times aren't on a single regular
+       * grid or the grid would be mostly empty, is rejected by
+       * merge(), in which case the caller is expected to keep it
+       * in its original form. */
+   class SP3NavGrid
+   {
+   public:
+         /// Values of OrbitDataSP3 stored in the grid.
+      enum Column
+      {
+         PosX, PosY, PosZ,
+         PosSigX, PosSigY, PosSigZ,
+         VelX, VelY, VelZ,
+         VelSigX, VelSigY, VelSigZ,
+         AccX, AccY, AccZ,
+         AccSigX, AccSigY, AccSigZ,
+         ClkBias, BiasSig,
+         ClkDrift, DriftSig,
+         ClkDrRate, DrRateSig,
+         NumColumns ///< Not a column, the number of columns.
+      };
+
+         /** merge() refuses to create a grid with more than this
+          * many cells (epochs times satellites) per sample. */
+      static const unsigned maxCellsPerSample = 4;
+
+         /// Create an empty grid.
+      SP3NavGrid();
+
+         /** Add records to the grid.  Records for an epoch that is
+          * already in the grid replace the existing sample.
+          * @param[in] nmt The message type of the records, which
+          *   must be the same for all merges into a given grid.
+          * @param[in] recs The records (OrbitDataSP3 objects) to add.
+          * @return true if the records were added, false if the
+          *   grid can't represent them, in which case the grid is
+          *   unchanged.  This happens when the records are not all
+          *   OrbitDataSP3, don't all lie on a regular time grid
+          *   shared with the existing contents, have a missing
+          *   primary value, have a non-zero message length, have a
+          *   different coordinate system, frame or week format than
+          *   other records of the same satellite, or would make
+          *   the grid too sparse (see maxCellsPerSample). */
+      bool merge(NavMessageType nmt, const NavSatMap& recs);
+
+         /** Remove the samples in the time span [fromTime,toTime).
+          * Epochs at either end of the grid and satellites that are
+          * left with no samples are trimmed from the grid.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed. */
+      void erase(const CommonTime& fromTime, const CommonTime& toTime);
+
+         /** Remove the samples in the time span [fromTime,toTime)
+          * for satellites matching satID, trimming the grid as
+          * erase(const CommonTime&,const CommonTime&) does.
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @param[in] satID The satellites to remove samples of,
+          *   which may contain wildcards. */
+      void erase(const CommonTime& fromTime, const CommonTime& toTime,
+                 const NavSatelliteID& satID);
+
+         /// Remove all data from the grid.
+      void clear();
+
+         /// Return true if the grid contains no data.
+      bool empty() const
+      { return sats.empty(); }
+
+         /// Return the message type of the data in the grid.
+      NavMessageType getMessageType() const
+      { return msgType; }
+
+         /// Return the total number of samples in the grid.
+      size_t size() const;
+
+         /** Return the number of values actually stored by the
+          * grid, i.e. excluding values that are the same for all
+          * samples. */
+      size_t storedValues() const;
+
+         /// Return the number of satellites in the grid.
+      unsigned numSats() const
+      { return sats.size(); }
+
+         /** Return the satellite at index sat in [0,numSats()).
+          * Satellites are in ascending order of NavSatelliteID. */
+      const NavSatelliteID& getSat(unsigned sat) const
+      { return sats[sat].id; }
+
+         /** Find the index of a satellite.
+          * @return the index of the satellite, or -1 if it is not
+          *   in the grid. */
+      long findSat(const NavSatelliteID& nsid) const;
+
+         /// Return the number of samples for the satellite at index sat.
+      size_t count(unsigned sat) const
+      { return sats[sat].count; }
+
+         /// Return the number of epochs in the grid.
+      long numEpochs() const
+      { return nEpochs; }
+
+         /// Return the time of the given epoch index.
+      CommonTime getTime(long epoch) const
+      { return t0 + epoch * step; }
+
+         /// Return the time step between epochs in seconds.
+      double getStep() const
+      { return step; }
+
+         /** Return the index of the first epoch that is at or after
+          * when, or numEpochs() if there is none. */
+      long lowerBound(const CommonTime& when) const;
+
+         /** Return the index of the first epoch that is after when,
+          * or numEpochs() if there is none. */
+      long upperBound(const CommonTime& when) const;
+
+         /** Return the index of the epoch at when, or -1 if when
+          * is not the time of an epoch. */
+      long findEpoch(const CommonTime& when) const;
+
+         /// Return true if there is a sample for sat at epoch.
+      bool isPresent(unsigned sat, long epoch) const
+      { return !std::isnan(getValue(sat, epoch, primary)); }
+
+         /** Return true if there is a sample for sat in the time
+          * span [fromTime,toTime). */
+      bool hasData(unsigned sat, const CommonTime& fromTime,
+                   const CommonTime& toTime) const;
+
+         /** Return the index of the first epoch at or after epoch
+          * with a sample for sat, or -1 if there is none. */
+      long nextPresent(unsigned sat, long epoch) const;
+
+         /** Return the index of the last epoch at or before epoch
+          * with a sample for sat, or -1 if there is none. */
+      long prevPresent(unsigned sat, long epoch) const;
+
+         /// Return a value of the sample for sat at epoch.
+      double getValue(unsigned sat, long epoch, unsigned col) const
+      {
+         return values[col].empty() ? constant[col]
+            : values[col][sat * nEpochs + epoch];
+      }
+
+         /** Set the contents of an OrbitDataSP3 to the sample for
+          * sat at epoch, as it was when it was merged.
+          * @pre isPresent(sat,epoch) */
+      void getRecord(unsigned sat, long epoch, OrbitDataSP3& od) const;
+
+         /** Create a copy of the sample for sat at epoch, as it was
+          * when it was merged.
+          * @pre isPresent(sat,epoch) */
+      std::shared_ptr<OrbitDataSP3> getRecord(unsigned sat, long epoch) const;
+
+         /// Return a value of an OrbitDataSP3 by column.
+      static double getValue(const OrbitDataSP3& od, unsigned col);
+
+         /// Set a value of an OrbitDataSP3 by column.
+      static void setValue(OrbitDataSP3& od, unsigned col, double val);
+
+   private:
+         /** Return true if d is close enough to an integer that a
+          * time computed from it needs to be checked against the
+          * epoch times. */
+      static bool nearInteger(double d);
+
+         /** Store records that all replace or fill in samples of
+          * satellites and epochs already in the grid, without
+          * rebuilding it.
+          * @param[in] nmt The message type of the records.
+          * @param[in] recs The records to add.
+          * @return true if the records were added, false if any of
+          *   them need the grid to be rebuilt by merge(), in which
+          *   case the grid is unchanged. */
+      bool mergeInPlace(NavMessageType nmt, const NavSatMap& recs);
+
+         /** Implement erase().
+          * @param[in] fromTime The earliest time to be removed.
+          * @param[in] toTime The earliest time that will NOT be removed.
+          * @param[in] satID If not null, only remove samples of
+          *   satellites matching this. */
+      void eraseSamples(const CommonTime& fromTime, const CommonTime& toTime,
+                        const NavSatelliteID *satID);
+
+         /** Remove the epochs before first and after last, and
+          * satellites with no samples, from the grid.
+          * @param[in] first The index of the first epoch to keep.
+          * @param[in] last The index of the last epoch to keep. */
+      void trim(long first, long last);
+
+         /// Information that is constant for all samples of a satellite.
+      struct SatInfo
+      {
+         NavSatelliteID id;        ///< Satellite/signal of the samples.
+            /** A sample with the signal, weekFmt, coordSystem and
+             * frame of all the samples, copied by getRecord(). */
+         OrbitDataSP3 proto;
+         size_t count;             ///< Number of samples.
+      };
+         /// Message type of the samples.
+      NavMessageType msgType;
+         /// Column whose NaN values mark missing samples.
+      Column primary;
+         /// Time of epoch 0.
+      CommonTime t0;
+         /// Time step between epochs in seconds.
+      double step;
+         /// Number of epochs.
+      long nEpochs;
+         /// Satellite information, indexed by satellite.
+      std::vector<SatInfo> sats;
+         /// Satellite index by ID.
+      std::map<NavSatelliteID, unsigned> satIndex;
+         /** Values indexed by [column][sat*nEpochs+epoch].  Columns
+          * that are the same for all samples are empty and their
+          * value is in constant instead. */
+      std::vector<double> values[NumColumns];
+         /// Values of the columns that are the same for all samples.
+      double constant[NumColumns];
+   };
+
+      //@}
+
+}
+
+#endif // GNSSTK_SP3NAVGRID_HPP
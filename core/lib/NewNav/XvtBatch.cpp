@@ -0,0 +1,100 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "XvtBatch.hpp"
+
+namespace gnsstk
+{
+   void XvtBatch ::
+   resize(size_t n)
+   {
+      x.resize(n);
+      y.resize(n);
+      z.resize(n);
+      vx.resize(n);
+      vy.resize(n);
+      vz.resize(n);
+      clkbias.resize(n);
+      clkdrift.resize(n);
+      relcorr.resize(n);
+      frame.resize(n);
+      health.resize(n);
+      status.assign(n, 0);
+   }
+
+
+   void XvtBatch ::
+   setXvt(size_t i, const Xvt& xvt)
+   {
+      x[i] = xvt.x[0];
+      y[i] = xvt.x[1];
+      z[i] = xvt.x[2];
+      vx[i] = xvt.v[0];
+      vy[i] = xvt.v[1];
+      vz[i] = xvt.v[2];
+      clkbias[i] = xvt.clkbias;
+      clkdrift[i] = xvt.clkdrift;
+      relcorr[i] = xvt.relcorr;
+      frame[i] = xvt.frame;
+      health[i] = xvt.health;
+      status[i] = 1;
+   }
+
+
+   bool XvtBatch ::
+   getXvt(size_t i, Xvt& xvt) const
+   {
+      if (!status[i])
+      {
+         return false;
+      }
+      xvt.x[0] = x[i];
+      xvt.x[1] = y[i];
+      xvt.x[2] = z[i];
+      xvt.v[0] = vx[i];
+      xvt.v[1] = vy[i];
+      xvt.v[2] = vz[i];
+      xvt.clkbias = clkbias[i];
+      xvt.clkdrift = clkdrift[i];
+      xvt.relcorr = relcorr[i];
+      xvt.frame = frame[i];
+      xvt.health = health[i];
+      return true;
+   }
+
+} // namespace gnsstk
@@ -0,0 +1,138 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_XVTBATCH_HPP
+#define GNSSTK_XVTBATCH_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Xvt.hpp"
+#include "NavFindCursor.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+      /** Structure-of-arrays storage for the results of the batch
+       * NavLibrary::getXvt() methods.  Element i of each array holds
+       * the result for element i of the request (satellite or time).
+       * Each component is stored in its own contiguous array so that
+       * it can be passed directly to vectorized code or other
+       * languages, rather than as an array of Xvt objects which each
+       * allocate their own Triple storage.
+       *
+       * The contents of the arrays for element i are only meaningful
+       * if status[i] is nonzero.
+       *
+       * The batch also holds the search state (see NavFindCursor)
+       * used by NavLibrary::getXvt() for NavSearchOrder::User
+       * searches.  Reusing the same XvtBatch for successive calls
+       * with the same request lets each search continue from where
+       * the last one ended up rather than starting over.
+       *
+       * @note As the search state is modified by each call, an
+       *   XvtBatch must not be shared between threads. */
+   class XvtBatch
+   {
+   public:
+         /// Create an empty batch.
+      XvtBatch()
+      {}
+
+         /** Resize all of the arrays to hold n elements and reset the
+          * status of all elements to failed.  The search state in
+          * cursors is left alone.
+          * @param[in] n The number of elements to hold. */
+      void resize(size_t n);
+
+         /// Return the number of elements in the batch.
+      size_t size() const
+      { return status.size(); }
+
+         /** Store an Xvt as element i and mark the element as successful.
+          * @param[in] i The index of the element to set.
+          * @param[in] xvt The computed position, velocity etc. to store. */
+      void setXvt(size_t i, const Xvt& xvt);
+
+         /** Get element i of the batch as an Xvt object.
+          * @param[in] i The index of the element to get.
+          * @param[out] xvt The stored position, velocity etc. of
+          *   element i.  Left untouched if the element is not valid.
+          * @return true if element i was successfully computed. */
+      bool getXvt(size_t i, Xvt& xvt) const;
+
+         /// ECEF Cartesian X position in meters.
+      std::vector<double> x;
+         /// ECEF Cartesian Y position in meters.
+      std::vector<double> y;
+         /// ECEF Cartesian Z position in meters.
+      std::vector<double> z;
+         /// ECEF Cartesian X velocity in meters/second.
+      std::vector<double> vx;
+         /// ECEF Cartesian Y velocity in meters/second.
+      std::vector<double> vy;
+         /// ECEF Cartesian Z velocity in meters/second.
+      std::vector<double> vz;
+         /// Satellite clock correction in seconds.
+      std::vector<double> clkbias;
+         /// Satellite clock drift in seconds/second.
+      std::vector<double> clkdrift;
+         /// Relativity correction in seconds.
+      std::vector<double> relcorr;
+         /// Reference frame of the position and velocity.
+      std::vector<RefFrame> frame;
+         /// Health status of the satellite at the time of interest.
+      std::vector<Xvt::HealthStatus> health;
+         /** Nonzero if the element was successfully computed, 0 if
+          * no orbit data was found or the computation failed.  This
+          * is not a std::vector<bool> so that the data is
+          * addressable. */
+      std::vector<uint8_t> status;
+         /** Search state for each element of the request, with one
+          * cursor for each factory searched for that element.  This
+          * is managed by NavLibrary::getXvt() and need not be touched
+          * otherwise. */
+      std::vector<std::vector<NavFindCursor> > cursors;
+   };
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_XVTBATCH_HPP
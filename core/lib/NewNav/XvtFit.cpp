@@ -0,0 +1,250 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <cmath>
+#include "XvtFit.hpp"
+#include "OrbitData.hpp"
+#include "GNSSconstants.hpp"
+
+namespace gnsstk
+{
+   const double XvtFit::defaultSegLength = 3600.0;
+   const double XvtFit::defaultPosTol = 1e-3;
+   const double XvtFit::defaultVelTol = 1e-6;
+   const double XvtFit::defaultClkTol = 1e-12;
+
+
+      /** Copy the fitted quantities of an Xvt into an array in the
+       * order used for XvtFit::coeffs. */
+   static void getComponents(const Xvt& xvt, double *vals)
+   {
+      vals[0] = xvt.x[0];
+      vals[1] = xvt.x[1];
+      vals[2] = xvt.x[2];
+      vals[3] = xvt.v[0];
+      vals[4] = xvt.v[1];
+      vals[5] = xvt.v[2];
+      vals[6] = xvt.clkbias;
+      vals[7] = xvt.clkdrift;
+      vals[8] = xvt.relcorr;
+   }
+
+
+   XvtFit ::
+   XvtFit(double segLength, unsigned degree, double posTol, double velTol,
+          double clkTol)
+         : segLength(segLength),
+           degree(degree),
+           posTol(posTol),
+           velTol(velTol),
+           clkTol(clkTol),
+           valid(false),
+           span(0),
+           segSpan(0),
+           numSegs(0),
+           health(Xvt::Uninitialized),
+           maxPosErr(0),
+           maxVelErr(0),
+           maxClkErr(0)
+   {
+      if (!(segLength > 0))
+      {
+         InvalidParameter exc("XvtFit segment length must be positive");
+         GNSSTK_THROW(exc);
+      }
+   }
+
+
+   bool XvtFit ::
+   fit(OrbitData& orb, const CommonTime& fitBegin, const CommonTime& fitEnd)
+   {
+      valid = false;
+      numSegs = 0;
+      coeffs.clear();
+      maxPosErr = maxVelErr = maxClkErr = 0;
+      begin = fitBegin;
+      end = fitEnd;
+      try
+      {
+         span = end - begin;
+      }
+      catch (Exception&)
+      {
+            // incompatible time systems
+         return false;
+      }
+      if (!(span > 0) || (span > segLength * maxSegments))
+         return false;
+      const unsigned n = degree + 1;
+      numSegs = static_cast<size_t>(std::ceil(span / segLength));
+      segSpan = span / numSegs;
+      coeffs.assign(numSegs * numComp * n, 0.0);
+      std::vector<double> samples(n * numComp);
+      Xvt xvt;
+      bool first = true;
+      for (size_t seg = 0; seg < numSegs; seg++)
+      {
+         CommonTime mid = begin + (seg + 0.5) * segSpan;
+            // Sample the orbit at the Chebyshev nodes (roots of T_n).
+         for (unsigned k = 0; k < n; k++)
+         {
+            double u = std::cos(PI * (k + 0.5) / n);
+            if (!orb.getXvt(mid + u * segSpan / 2.0, xvt))
+               return false;
+            if (first)
+            {
+               frame = xvt.frame;
+               health = xvt.health;
+               first = false;
+            }
+            else if ((xvt.frame != frame) || (xvt.health != health))
+            {
+               return false;
+            }
+            getComponents(xvt, &samples[k * numComp]);
+         }
+            // The discrete orthogonality of the Chebyshev polynomials
+            // over the nodes gives the coefficients directly.
+         double *segCoeffs = &coeffs[seg * numComp * n];
+         for (unsigned j = 0; j < n; j++)
+         {
+            double scale = (j == 0 ? 1.0 : 2.0) / n;
+            for (unsigned k = 0; k < n; k++)
+            {
+               double w = scale * std::cos(PI * j * (k + 0.5) / n);
+               for (unsigned c = 0; c < numComp; c++)
+               {
+                  segCoeffs[c * n + j] += w * samples[k * numComp + c];
+               }
+            }
+         }
+      }
+         // Check the fit against the orbit at the Chebyshev extrema,
+         // which includes the segment end points.
+      Xvt fitted;
+      double truth[numComp], approx[numComp];
+      for (size_t seg = 0; seg < numSegs; seg++)
+      {
+         CommonTime mid = begin + (seg + 0.5) * segSpan;
+         for (unsigned k = 0; k <= degree; k++)
+         {
+            double u = (degree == 0 ? 0.0 : std::cos(PI * k / degree));
+            if (!orb.getXvt(mid + u * segSpan / 2.0, xvt))
+               return false;
+            if ((xvt.frame != frame) || (xvt.health != health))
+               return false;
+            evalSeg(seg, u, fitted);
+            getComponents(xvt, truth);
+            getComponents(fitted, approx);
+            maxPosErr = std::max(maxPosErr, std::sqrt(
+                                    (truth[0]-approx[0])*(truth[0]-approx[0]) +
+                                    (truth[1]-approx[1])*(truth[1]-approx[1]) +
+                                    (truth[2]-approx[2])*(truth[2]-approx[2])));
+            maxVelErr = std::max(maxVelErr, std::sqrt(
+                                    (truth[3]-approx[3])*(truth[3]-approx[3]) +
+                                    (truth[4]-approx[4])*(truth[4]-approx[4]) +
+                                    (truth[5]-approx[5])*(truth[5]-approx[5])));
+            for (unsigned c = 6; c < numComp; c++)
+            {
+               maxClkErr = std::max(maxClkErr,
+                                    std::fabs(truth[c] - approx[c]));
+            }
+         }
+      }
+      valid = ((maxPosErr <= posTol) && (maxVelErr <= velTol) &&
+               (maxClkErr <= clkTol));
+      return valid;
+   }
+
+
+   bool XvtFit ::
+   eval(const CommonTime& when, Xvt& xvt) const
+   {
+      if (!valid)
+         return false;
+      TimeSystem ts = when.getTimeSystem();
+      if ((ts != TimeSystem::Any) &&
+          (begin.getTimeSystem() != TimeSystem::Any) &&
+          (ts != begin.getTimeSystem()))
+      {
+         return false;
+      }
+      double dt = when - begin;
+      if ((dt < 0) || (dt > span))
+         return false;
+      size_t seg = std::min(static_cast<size_t>(dt / segSpan), numSegs-1);
+      evalSeg(seg, 2.0 * (dt - seg * segSpan) / segSpan - 1.0, xvt);
+      xvt.frame = frame;
+      xvt.health = health;
+      return true;
+   }
+
+
+   void XvtFit ::
+   evalSeg(size_t seg, double u, Xvt& xvt) const
+   {
+      const unsigned n = degree + 1;
+      const double *segCoeffs = &coeffs[seg * numComp * n];
+      double vals[numComp];
+      double u2 = 2.0 * u;
+         // Clenshaw's recurrence
+      for (unsigned c = 0; c < numComp; c++)
+      {
+         const double *cc = segCoeffs + c * n;
+         double b1 = 0, b2 = 0;
+         for (unsigned j = degree; j > 0; j--)
+         {
+            double tmp = u2 * b1 - b2 + cc[j];
+            b2 = b1;
+            b1 = tmp;
+         }
+         vals[c] = u * b1 - b2 + cc[0];
+      }
+      xvt.x[0] = vals[0];
+      xvt.x[1] = vals[1];
+      xvt.x[2] = vals[2];
+      xvt.v[0] = vals[3];
+      xvt.v[1] = vals[4];
+      xvt.v[2] = vals[5];
+      xvt.clkbias = vals[6];
+      xvt.clkdrift = vals[7];
+      xvt.relcorr = vals[8];
+   }
+
+}
@@ -0,0 +1,202 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#ifndef GNSSTK_XVTFIT_HPP
+#define GNSSTK_XVTFIT_HPP
+
+#include <vector>
+#include "CommonTime.hpp"
+#include "Xvt.hpp"
+
+namespace gnsstk
+{
+      /// @ingroup NavFactory
+      //@{
+
+   class OrbitData;
+
+      /** Piecewise Chebyshev approximation of an OrbitData object's
+       * Xvt over a fit interval.
+       *
+       * Evaluating broadcast orbits is comparatively expensive
+       * (Kepler's equation for GPS-style ephemerides, numerical
+       * integration for GLONASS), which dominates the cost of
+       * applications that compute the position of the same
+       * satellite many times over, e.g. at every epoch of an
+       * observation file.  XvtFit samples the analytic model at
+       * Chebyshev nodes over fixed-length segments of the fit
+       * interval and afterwards evaluates the resulting
+       * polynomials instead, which costs a few dozen
+       * multiply-adds per component.
+       *
+       * The position, velocity, clock bias, clock drift and
+       * relativity correction are each fit independently.  The
+       * reference frame and health are taken from the analytic
+       * model and must be constant over the fit interval.
+       *
+       * After fitting, the polynomials are checked against the
+       * analytic model at the Chebyshev extrema of each segment,
+       * which is where the approximation error peaks, and the fit
+       * is only used if the largest differences are within the
+       * tolerances given to the constructor.  With the default
+       * segment length and degree, the measured errors are about
+       * 1e-7 m in position and 1e-11 m/s in velocity for GPS LNAV
+       * ephemerides, and about 1e-5 m and 1e-8 m/s for GLONASS
+       * FDMA ephemerides, where the numerical integration of the
+       * analytic model is the limiting factor.  Clock errors are
+       * at the level of double precision rounding.  These are
+       * well below the default tolerances and far below the
+       * accuracy of the broadcast models themselves.
+       *
+       * The cost of fitting is about 2*(degree+1) evaluations of
+       * the analytic model per segment, so a fit pays for itself
+       * when the orbit is evaluated more than that many times.
+       * See OrbitData::getXvtFitted() and NavLibrary::setXvtFit(). */
+   class XvtFit
+   {
+   public:
+         /// Default length of each fitted segment in seconds.
+      static const double defaultSegLength;
+         /// Default degree of the fitted polynomials.
+      static const unsigned defaultDegree = 10;
+         /** Largest number of segments fit() will use, which
+          * protects against fitting nonsensical intervals. */
+      static const size_t maxSegments = 1000;
+         /// Default maximum acceptable position error in meters.
+      static const double defaultPosTol;
+         /// Default maximum acceptable velocity error in meters/second.
+      static const double defaultVelTol;
+         /** Default maximum acceptable clock bias, drift and
+          * relativity correction error in seconds (and s/s). */
+      static const double defaultClkTol;
+
+         /** Set the fit parameters, but don't fit anything yet.
+          * @param[in] segLength The length of each fitted segment
+          *   in seconds.  The fit interval is split into the
+          *   smallest number of equal segments no longer than this.
+          * @param[in] degree The degree of the polynomials.
+          * @param[in] posTol The maximum acceptable position error.
+          * @param[in] velTol The maximum acceptable velocity error.
+          * @param[in] clkTol The maximum acceptable clock error.
+          * @throw InvalidParameter if segLength is not positive. */
+      XvtFit(double segLength = defaultSegLength,
+             unsigned degree = defaultDegree,
+             double posTol = defaultPosTol,
+             double velTol = defaultVelTol,
+             double clkTol = defaultClkTol);
+
+         /** Fit the Xvt of orb over [begin,end].
+          * @param[in] orb The orbit to fit.
+          * @param[in] begin The start of the fit interval.
+          * @param[in] end The end of the fit interval.
+          * @return true if the fit succeeded and is within
+          *   tolerances, false if the interval is empty or would
+          *   need more than maxSegments segments, orb was
+          *   unable to compute an Xvt at any of the samples, the
+          *   frame or health changed over the interval, or the
+          *   fit is not within tolerances.  When false, isValid()
+          *   is false and eval() always fails. */
+      bool fit(OrbitData& orb, const CommonTime& begin,
+               const CommonTime& end);
+
+         /** Evaluate the fit.
+          * @param[in] when The time at which to compute the xvt.
+          * @param[out] xvt The resulting position/velocity.
+          * @return true if successful, false if the fit is not
+          *   valid or when is outside the fit interval or in an
+          *   incompatible time system. */
+      bool eval(const CommonTime& when, Xvt& xvt) const;
+
+         /// Return true if fit() succeeded.
+      bool isValid() const
+      { return valid; }
+         /// Return the start of the fit interval.
+      const CommonTime& getBegin() const
+      { return begin; }
+         /// Return the end of the fit interval.
+      const CommonTime& getEnd() const
+      { return end; }
+         /// Return the number of segments in the fit.
+      size_t getNumSegments() const
+      { return numSegs; }
+         /// Return the largest position error found by fit() in meters.
+      double getMaxPosError() const
+      { return maxPosErr; }
+         /// Return the largest velocity error found by fit() in m/s.
+      double getMaxVelError() const
+      { return maxVelErr; }
+         /// Return the largest clock error found by fit() in seconds.
+      double getMaxClkError() const
+      { return maxClkErr; }
+
+   private:
+         /// Number of fitted quantities (x, v, clkbias, clkdrift, relcorr).
+      static const unsigned numComp = 9;
+
+         /** Evaluate all components of a segment.
+          * @param[in] seg The index of the segment.
+          * @param[in] u The time, scaled to [-1,1] within the segment.
+          * @param[out] xvt The position etc. (not frame or health). */
+      void evalSeg(size_t seg, double u, Xvt& xvt) const;
+
+      double segLength;    ///< Requested maximum segment length.
+      unsigned degree;     ///< Degree of the polynomials.
+      double posTol;       ///< Maximum position error.
+      double velTol;       ///< Maximum velocity error.
+      double clkTol;       ///< Maximum clock error.
+      bool valid;          ///< True if fit() succeeded.
+      CommonTime begin;    ///< Start of the fit interval.
+      CommonTime end;      ///< End of the fit interval.
+      double span;         ///< Length of the fit interval in seconds.
+      double segSpan;      ///< Actual length of each segment.
+      size_t numSegs;      ///< Number of segments.
+      RefFrame frame;      ///< Reference frame of the orbit.
+      Xvt::HealthStatus health; ///< Health from the orbit.
+      double maxPosErr;    ///< Largest position error found in fit().
+      double maxVelErr;    ///< Largest velocity error found in fit().
+      double maxClkErr;    ///< Largest clock error found in fit().
+         /** Chebyshev coefficients, degree+1 for each component of
+          * each segment, in segment then component order. */
+      std::vector<double> coeffs;
+   };
+
+      //@}
+
+}
+
+#endif // GNSSTK_XVTFIT_HPP
@@ -37,6 +37,7 @@
 //
 //==============================================================================
 #include "YumaNavDataFactory.hpp"
+#include "NavDataArena.hpp"
 #include "YumaStream.hpp"
 #include "YumaHeader.hpp"
 #include "GPSLNavHealth.hpp"
@@ -194,7 +195,7 @@ namespace gnsstk
    {
       bool rv = true;
       GPSLNavAlm *gps;
-      navOut = std::make_shared<GPSLNavAlm>();
+      navOut = makeNavData<GPSLNavAlm>();
       gps = dynamic_cast<GPSLNavAlm*>(navOut.get());
          // NavData
       fillNavData(navIn, navOut);
@@ -245,7 +246,7 @@ namespace gnsstk
    {
       bool rv = true;
       GPSLNavHealth *gps;
-      healthOut = std::make_shared<GPSLNavHealth>();
+      healthOut = makeNavData<GPSLNavHealth>();
       gps = dynamic_cast<GPSLNavHealth*>(healthOut.get());
          // NavData
       fillNavData(navIn, healthOut);
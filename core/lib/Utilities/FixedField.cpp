@@ -0,0 +1,267 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file FixedField.cpp
+ * Conversion of fixed-width numeric fields in text records.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include "FixedField.hpp"
+
+namespace gnsstk
+{
+   namespace FixedField
+   {
+         /// Return true if c is white space in the "C" locale.
+      static inline bool isSpace(char c)
+      {
+         return ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') ||
+                 (c == '\f') || (c == '\r'));
+      }
+
+
+         /// Return true if c is a decimal digit.
+      static inline bool isDigit(char c)
+      {
+         return ((c >= '0') && (c <= '9'));
+      }
+
+
+         /// Return true if c marks the start of an exponent.
+      static inline bool isExponent(char c)
+      {
+         return ((c == 'E') || (c == 'e') || (c == 'D') || (c == 'd'));
+      }
+
+
+         /** Powers of ten that are exactly representable as a
+          * double, which means multiplying or dividing an exactly
+          * represented integer by one of them gives a correctly
+          * rounded result (Clinger's fast path). */
+      static const double exactPow10[] =
+      {
+         1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+
+         /// The largest exponent in exactPow10.
+      static const long maxExactPow10 = 22;
+
+         /// The largest integer below which every integer is a double.
+      static const uint64_t maxExactMantissa = UINT64_C(1) << 53;
+
+         /** The number of significant digits that are collected
+          * before giving up on the fast path, which is as many as
+          * will always fit in a uint64_t. */
+      static const int maxDigits = std::numeric_limits<uint64_t>::digits10;
+
+         /// Limit on the exponent, beyond which any value over/underflows.
+      static const long maxExponent = 100000;
+
+
+      long asInt(const char *first, const char *last)
+      {
+         const char *p = first;
+         while ((p != last) && isSpace(*p))
+            p++;
+         bool negative = false;
+         if ((p != last) && ((*p == '-') || (*p == '+')))
+         {
+            negative = (*p == '-');
+            p++;
+         }
+         const char *digits = p;
+         unsigned long value = 0;
+         for (; (p != last) && isDigit(*p); p++)
+         {
+            if (p - digits == std::numeric_limits<long>::digits10)
+            {
+                  // This could overflow, so leave it to strtol to
+                  // get the overflow behavior right.
+               std::string copy(first, last);
+               return std::strtol(copy.c_str(), nullptr, 10);
+            }
+            value = value * 10 + (*p - '0');
+         }
+         return negative ? -static_cast<long>(value)
+            : static_cast<long>(value);
+      }
+
+
+      double asDouble(const char *first, const char *last,
+                      unsigned impliedDecimals)
+      {
+         const char *p = first;
+         while ((p != last) && isSpace(*p))
+            p++;
+         bool negative = false;
+         if ((p != last) && ((*p == '-') || (*p == '+')))
+         {
+            negative = (*p == '-');
+            p++;
+         }
+            // The mantissa, with the decimal point removed, is
+            // mantissa*10^exponent.  Leading zeros aren't significant
+            // and don't count towards the digits limit.
+         const char *mantStart = p;
+         uint64_t mantissa = 0;
+         long exponent = 0;
+         int sigDigits = 0;
+         bool anyDigits = false, point = false;
+         for (; p != last; p++)
+         {
+            if (isDigit(*p))
+            {
+               anyDigits = true;
+               if (point)
+                  exponent--;
+               if ((mantissa != 0) || (*p != '0'))
+               {
+                  if (sigDigits < maxDigits)
+                     mantissa = mantissa * 10 + (*p - '0');
+                  sigDigits++;
+               }
+            }
+            else if ((*p == '.') && !point)
+            {
+               point = true;
+            }
+            else
+            {
+               break;
+            }
+         }
+         const char *mantEnd = p;
+         if (!anyDigits ||
+             ((mantEnd - mantStart == 1) && (*mantStart == '0') &&
+              (p != last) && ((*p == 'x') || (*p == 'X'))))
+         {
+               // Either no number at all, which is zero, or
+               // something like "inf", "nan" or hexadecimal that
+               // is left to strtod.  None of those are ever found
+               // in the file formats this is used for.
+            if ((mantStart != last) && (*mantStart == '.'))
+               return 0;
+            std::string copy(first, last);
+            return std::strtod(copy.c_str(), nullptr);
+         }
+            // The exponent is only used if it contains digits,
+            // otherwise the number ends at the exponent character.
+         if ((p != last) && isExponent(*p))
+         {
+            const char *q = p + 1;
+            bool negExp = false;
+            if ((q != last) && ((*q == '-') || (*q == '+')))
+            {
+               negExp = (*q == '-');
+               q++;
+            }
+            if ((q != last) && isDigit(*q))
+            {
+               long expValue = 0;
+               for (; (q != last) && isDigit(*q); q++)
+               {
+                  if (expValue < maxExponent)
+                     expValue = expValue * 10 + (*q - '0');
+               }
+               exponent += negExp ? -expValue : expValue;
+            }
+         }
+         if (!point)
+            exponent -= impliedDecimals;
+         if (mantissa == 0)
+            return negative ? -0.0 : 0.0;
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+         if ((sigDigits <= maxDigits) && (mantissa <= maxExactMantissa) &&
+             (exponent >= -maxExactPow10) && (exponent <= maxExactPow10))
+         {
+            double value = static_cast<double>(mantissa);
+            if (exponent < 0)
+               value /= exactPow10[-exponent];
+            else
+               value *= exactPow10[exponent];
+            return negative ? -value : value;
+         }
+#endif
+            // Too many digits or too large an exponent to be sure of
+            // rounding correctly, so let strtod do it.  The number is
+            // rewritten as an integer mantissa and exponent, which
+            // has the same value and avoids both the exponent
+            // character and the locale's decimal point.
+         std::string copy;
+         if (negative)
+            copy += '-';
+         for (const char *c = mantStart; c != mantEnd; c++)
+         {
+            if (*c != '.')
+               copy += *c;
+         }
+         copy += 'e';
+         copy += std::to_string(exponent);
+         return std::strtod(copy.c_str(), nullptr);
+      }
+
+
+      long asInt(const std::string& s, std::string::size_type pos,
+                 std::string::size_type n)
+      {
+         if (pos > s.size())
+            throw std::out_of_range("FixedField::asInt");
+         const char *first = s.data() + pos;
+         return asInt(first, first + std::min(n, s.size() - pos));
+      }
+
+
+      double asDouble(const std::string& s, std::string::size_type pos,
+                      std::string::size_type n, unsigned impliedDecimals)
+      {
+         if (pos > s.size())
+            throw std::out_of_range("FixedField::asDouble");
+         const char *first = s.data() + pos;
+         return asDouble(first, first + std::min(n, s.size() - pos),
+                         impliedDecimals);
+      }
+   } // namespace FixedField
+} // namespace gnsstk
@@ -0,0 +1,124 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file FixedField.hpp
+ * Conversion of fixed-width numeric fields in text records.
+ */
+
+#ifndef GNSSTK_FIXEDFIELD_HPP
+#define GNSSTK_FIXEDFIELD_HPP
+
+#include <string>
+
+namespace gnsstk
+{
+      /// @ingroup stringutilsgroup
+      //@{
+
+      /**
+       * Numeric conversions for the fixed-column fields used by
+       * RINEX, SP3, SINEX and similar text formats.  The
+       * conversions work directly on a range of characters, so no
+       * temporary string needs to be made for each field, and do not
+       * depend on the current C locale.
+       *
+       * The syntax accepted is that of strtod() and strtol(), with
+       * leading white space skipped and conversion stopping at the
+       * first character that can't be part of the number.  A field
+       * that is blank, or that otherwise contains no number, is zero.
+       * For floating point values, the FORTRAN exponent characters
+       * 'D' and 'd' are accepted as well as 'E' and 'e'.  For any
+       * value strtod() accepts, the result is bit-for-bit the same.
+       */
+   namespace FixedField
+   {
+         /** Convert a range of characters to an integer, as strtol()
+          * in base 10.
+          * @param[in] first The first character of the field.
+          * @param[in] last One past the last character of the field.
+          * @return The value of the field, or zero if it contains
+          *   no number. */
+      long asInt(const char *first, const char *last);
+
+         /** Convert a range of characters to a double.
+          * @param[in] first The first character of the field.
+          * @param[in] last One past the last character of the field.
+          * @param[in] impliedDecimals The number of digits that
+          *   are to the right of the decimal point when the field
+          *   does not contain one, as with the FORTRAN Fw.d edit
+          *   descriptor.  This is ignored if the field contains a
+          *   decimal point.
+          * @return The value of the field, or zero if it contains
+          *   no number. */
+      double asDouble(const char *first, const char *last,
+                      unsigned impliedDecimals = 0);
+
+         /** Convert the columns of a string to an integer.  The
+          * range of columns is clipped to the string as with
+          * std::string::substr().
+          * @param[in] s The string containing the field.
+          * @param[in] pos The column at which the field starts.
+          * @param[in] n The width of the field.
+          * @return The value of the field.
+          * @throw std::out_of_range if pos is past the end of s. */
+      long asInt(const std::string& s, std::string::size_type pos,
+                 std::string::size_type n = std::string::npos);
+
+         /** Convert the columns of a string to a double.  The
+          * range of columns is clipped to the string as with
+          * std::string::substr().
+          * @param[in] s The string containing the field.
+          * @param[in] pos The column at which the field starts.
+          * @param[in] n The width of the field.
+          * @param[in] impliedDecimals The number of implied digits
+          *   to the right of the decimal point, as with
+          *   asDouble(const char*,const char*,unsigned).
+          * @return The value of the field.
+          * @throw std::out_of_range if pos is past the end of s. */
+      double asDouble(const std::string& s, std::string::size_type pos,
+                      std::string::size_type n = std::string::npos,
+                      unsigned impliedDecimals = 0);
+   } // namespace FixedField
+
+      //@}
+
+} // namespace gnsstk
+
+#endif // GNSSTK_FIXEDFIELD_HPP
@@ -37,6 +37,7 @@
 //==============================================================================
 
 #include "FormattedDouble.hpp"
+#include "FixedField.hpp"
 
 namespace gnsstk
 {
@@ -75,7 +76,14 @@ namespace gnsstk
    FormattedDouble& FormattedDouble ::
    operator=(const std::string& s)
    {
-      if ((exponentChar != 'e') && (exponentChar != 'E'))
+      if ((exponentChar == 'e') || (exponentChar == 'E') ||
+          (exponentChar == 'd') || (exponentChar == 'D'))
+      {
+            // FixedField understands both the standard and FORTRAN
+            // exponent characters, and is much faster than a stream.
+         val = FixedField::asDouble(s.data(), s.data() + s.size());
+      }
+      else
       {
             // If the exponent character is different from standard,
             // we need to do some tweaking.
@@ -89,14 +97,6 @@ namespace gnsstk
          std::istringstream iss(copy);
          iss >> val;
       }
-      else
-      {
-            // If the exponent character is standard, the standard
-            // istream double reading should work fine regardless of
-            // any other tweaks.
-         std::istringstream iss(s);
-         iss >> val;
-      }
       return *this;
    }
 
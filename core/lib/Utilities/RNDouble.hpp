@@ -64,6 +64,10 @@ namespace gnsstk
          /// Assign a value by decoding a string using existing formatting.
       RNDouble& operator=(const std::string& s)
       { FormattedDouble::operator=(s); return *this; }
+
+         /// Assign a value, keeping the existing formatting.
+      RNDouble& operator=(double d)
+      { FormattedDouble::operator=(d); return *this; }
    };
 }
 
@@ -0,0 +1,560 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "FFTextStream.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gnsstk;
+
+class FFTextStream_T
+{
+public:
+      /// How a stream reads its input.
+   enum Input
+   {
+      Plain,   ///< Through std::filebuf.
+      Blocks,  ///< Through FFTextBuf, reading blocks.
+      Mapped   ///< Through FFTextBuf, memory mapped.
+   };
+
+   FFTextStream_T();
+
+      /// Test the FFTextLine view methods.
+   unsigned textLineTest();
+      /// Test formattedGetLine with each kind of Input.
+   unsigned getLineTest();
+      /// Test positioning and reopening of a buffered stream.
+   unsigned bufferInputTest();
+      /** Test reading a file of more than one block, including
+       * positioning and a file that changes while being read. */
+   unsigned blockTest();
+      /// Compare RINEX 3 obs records read with each kind of Input.
+   unsigned rinex3ObsTest();
+      /// Compare RINEX 2 obs records read with each kind of Input.
+   unsigned rinex2ObsTest();
+
+      /** Switch strm to the given kind of Input.
+       * @return true if strm is now reading that way. */
+   static bool setInput(FFTextStream& strm, Input in);
+
+      /** Read the lines of textFile and check them against textLines.
+       * @param[in] in How to read the file.
+       * @param[in] view If true, read lines as FFTextLine views. */
+   void checkLines(Input in, bool view, TestUtil& testFramework);
+
+      /** Read all the records of a RINEX obs file, returning a text
+       * representation of their contents. */
+   string readObs(const string& fn, Input in);
+
+   string textFile;   ///< Plain text test file.
+   string rinex3File; ///< RINEX 3 obs test file.
+   string rinex2File; ///< RINEX 2 obs test file.
+   vector<string> textLines; ///< Expected contents of textFile.
+};
+
+
+FFTextStream_T ::
+FFTextStream_T()
+{
+   string op = getPathTestTemp() + getFileSep();
+   textFile = op + "test_output_FFTextStream.txt";
+   rinex3File = op + "test_output_FFTextStream.rnx";
+   rinex2File = op + "test_output_FFTextStream.06o";
+   textLines.push_back("first line");
+   textLines.push_back("");
+   textLines.push_back("  padded  ");
+   textLines.push_back("last");
+      // a windows line ending and no newline at the end of the file
+   ofstream s(textFile.c_str(), ios::out | ios::binary);
+   s << "first line\r\n\n  padded  \nlast";
+   s.close();
+   s.open(rinex3File.c_str(), ios::out | ios::binary);
+   s << "     3.00           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+     << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+     << "TEST                                                        MARKER NAME\n"
+     << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+     << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+     << "1                   ANT             NONE                    ANT # / TYPE\n"
+     << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+     << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+     << "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+     << "E    3 C1C L1C S1C                                          SYS / # / OBS TYPES\n"
+     << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+     << "                                                            END OF HEADER\n"
+     << "> 2020 01 01 00 00  0.0000000  0  3\n"
+     << "G01  24237168.685 4 109908701.742 9     -2320.362          47.866  \n"
+     << "E05  23037189.981 4 105326611.209\n"
+     << "G03                 110552588.28717     -1234.397\n"
+     << "> 2020 01 01 00 00 30.0000000  4  1\n"
+     << "spliced file                                                COMMENT\n"
+     << "> 2020 01 01 00 01  0.0000000  0  1      -0.000123456789\n"
+     << "G01  24237170.001   109908710.5   \n";
+   s.close();
+   s.open(rinex2File.c_str(), ios::out | ios::binary);
+   s << "     2.11           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+     << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+     << "TEST                                                        MARKER NAME\n"
+     << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+     << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+     << "1                   ANT                                     ANT # / TYPE\n"
+     << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+     << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+     << "     1     1                                                WAVELENGTH FACT L1/2\n"
+     << "     6    C1    L1    L2    P2    S1    S2                  # / TYPES OF OBSERV\n"
+     << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+     << "                                                            END OF HEADER\n"
+     << " 20  1  1  0  0  0.0000000  0  2G 1R 2\n"
+     << "  24237168.685 4 109908701.742 9  85643101.123 8  24237170.556          47.866\n"
+     << "        44.000\n"
+     << "  20576567.763   -24427464.5949  -19023455.680 8\r\n"
+     << "\n"
+     << "\n"
+     << " 20  1  1  0  0 30.0000000  0  1G 1"
+     << "                                 -0.000123456\n"
+     << "  24237170.001                                                 \n"
+     << "        44.250\n";
+   s.close();
+}
+
+
+unsigned FFTextStream_T ::
+textLineTest()
+{
+   TUDEF("FFTextLine", "substr");
+   string text("  12.5D0 -42  ");
+   FFTextLine line(text);
+   TUASSERTE(size_t, 14, line.size());
+   TUASSERTE(string, "12.5D0", line.substr(2,6).str());
+   TUASSERTE(string, "  ", line.substr(12).str());
+      // clipped at the end of the line like std::string::substr
+   TUASSERTE(string, "  ", line.substr(12,16).str());
+   TUASSERT(line.substr(14,3).empty());
+   try
+   {
+      line.substr(15,1);
+      TUFAIL("substr past the end did not throw");
+   }
+   catch (std::out_of_range&)
+   {
+      TUPASS("substr past the end");
+   }
+   TUCSM("stripTrailing");
+   TUASSERTE(string, "  12.5D0 -42", FFTextLine(line).stripTrailing().str());
+   TUASSERT(FFTextLine("    ", 4).stripTrailing().empty());
+   TUCSM("isBlank");
+   TUASSERT(line.substr(0,2).isBlank());
+   TUASSERT(!line.substr(0,3).isBlank());
+   TUASSERT(FFTextLine().isBlank());
+   TUCSM("operator==");
+   TUASSERT(line.substr(9,3) == "-42");
+   TUASSERT(!(line.substr(9,2) == "-42"));
+   TUCSM("asDouble");
+      // same as strtod, which stops at the D
+   TUASSERTFE(StringUtils::asDouble(text.substr(2,6)),
+              line.substr(2,6).asDouble());
+   TUASSERTFE(-42, line.substr(8).asDouble());
+   TUASSERTFE(0, FFTextLine().asDouble());
+   TUCSM("asInt");
+   TUASSERTE(long, -42, line.substr(8).asInt());
+   TUASSERTE(long, 12, line.substr(0,5).asInt());
+   TUASSERTE(long, 0, line.substr(12).asInt());
+   TURETURN();
+}
+
+
+bool FFTextStream_T ::
+setInput(FFTextStream& strm, Input in)
+{
+   switch (in)
+   {
+      case Blocks:
+         return strm.bufferInput() && !strm.isInputMapped();
+      case Mapped:
+#ifdef _WIN32
+            // there's no mmap, so the file is read in blocks
+         return strm.bufferInput(true) && !strm.isInputMapped();
+#else
+         return strm.bufferInput(true) && strm.isInputMapped();
+#endif
+      default:
+         return !strm.isInputBuffered();
+   }
+}
+
+
+void FFTextStream_T ::
+checkLines(Input in, bool view, TestUtil& testFramework)
+{
+   FFTextStream strm(textFile.c_str(), ios::in);
+   TUASSERT(setInput(strm, in));
+   for (unsigned i = 0; i < textLines.size(); i++)
+   {
+      if (view)
+      {
+         FFTextLine line;
+         TUCATCH(strm.formattedGetLine(line, true));
+         TUASSERTE(string, textLines[i], line.str());
+      }
+      else
+      {
+         string line;
+         TUCATCH(strm.formattedGetLine(line, true));
+         TUASSERTE(string, textLines[i], line);
+      }
+      TUASSERTE(unsigned, i+1, strm.lineNumber);
+   }
+      // the last line had no newline
+   TUASSERT(strm.eof());
+   try
+   {
+      FFTextLine line;
+      strm.formattedGetLine(line, true);
+      TUFAIL("EOF not detected");
+   }
+   catch (EndOfFile&)
+   {
+      TUPASS("EOF");
+   }
+   TUASSERT(strm.fail());
+   strm.clear();
+   try
+   {
+      string line;
+      strm.formattedGetLine(line, false);
+      TUFAIL("EOF not detected");
+   }
+   catch (EndOfFile&)
+   {
+      TUFAIL("EOF was expected to be an error");
+   }
+   catch (FFStreamError&)
+   {
+      TUPASS("unexpected EOF");
+   }
+}
+
+
+unsigned FFTextStream_T ::
+getLineTest()
+{
+   TUDEF("FFTextStream", "formattedGetLine");
+   for (Input in : {Plain, Blocks, Mapped})
+   {
+      checkLines(in, false, testFramework);
+      checkLines(in, true, testFramework);
+   }
+   TURETURN();
+}
+
+
+unsigned FFTextStream_T ::
+bufferInputTest()
+{
+   TUDEF("FFTextStream", "bufferInput");
+   for (Input in : {Blocks, Mapped})
+   {
+      FFTextStream strm(textFile.c_str(), ios::in);
+      string line;
+      FFTextLine view;
+         // buffering continues from the current position
+      strm.formattedGetLine(line);
+      TUASSERT(setInput(strm, in));
+      TUASSERT(strm.isInputBuffered());
+      std::streampos pos = strm.tellg();
+      TUASSERTE(long, 12, pos);
+      strm.formattedGetLine(view);
+      TUASSERTE(string, textLines[1], view.str());
+      strm.formattedGetLine(view);
+      TUASSERTE(string, textLines[2], view.str());
+      strm.seekg(pos);
+      TUASSERT(static_cast<bool>(strm));
+      strm.formattedGetLine(line);
+      TUASSERTE(string, textLines[1], line);
+         // the stream buffer works for ordinary reads too
+      TUASSERTE(int, ' ', strm.peek());
+      strm.seekg(-4, ios::end);
+      strm >> line;
+      TUASSERTE(string, "last", line);
+      TUASSERT(strm.eof());
+         // reopening goes back to std::filebuf
+      strm.open(textFile.c_str(), ios::in);
+      TUASSERT(!strm.isInputBuffered());
+      TUASSERT(!strm.isInputMapped());
+      strm.formattedGetLine(line);
+      TUASSERTE(string, textLines[0], line);
+   }
+      // output streams can't be buffered
+   string outFile = textFile + ".out";
+   FFTextStream ostrm(outFile.c_str(), ios::out);
+   TUASSERT(!ostrm.bufferInput());
+   TUASSERT(!ostrm.isInputBuffered());
+      // nor can streams that aren't open
+   FFTextStream nstrm;
+   TUASSERT(!nstrm.bufferInput());
+   TURETURN();
+}
+
+
+unsigned FFTextStream_T ::
+blockTest()
+{
+   TUDEF("FFTextBuf", "getLine");
+   string fn = textFile + ".big";
+   vector<string> lines;
+      // Lines of varying length so they end at different places
+      // relative to the blocks, with one longer than a block.
+   for (unsigned i = 0; i < 20000; i++)
+   {
+      if (i == 15000)
+         lines.push_back(string(FFTextBuf::blockSize + 100, 'x'));
+      else
+         lines.push_back(string(i % 71, 'a' + (i % 26)));
+   }
+   {
+      ofstream s(fn.c_str(), ios::out | ios::binary);
+      for (const auto& i : lines)
+         s << i << "\n";
+   }
+   for (Input in : {Blocks, Mapped})
+   {
+      FFTextStream strm(fn.c_str(), ios::in);
+      TUASSERT(setInput(strm, in));
+      FFTextLine view;
+      std::streampos pos15k;
+      bool same = true;
+      for (unsigned i = 0; i < lines.size(); i++)
+      {
+         if (i == 15000)
+            pos15k = strm.tellg();
+         strm.formattedGetLine(view);
+         same = same && (view.str() == lines[i]);
+      }
+      TUASSERT(same);
+      try
+      {
+         strm.formattedGetLine(view, true);
+         TUFAIL("EOF not detected");
+      }
+      catch (EndOfFile&)
+      {
+         TUPASS("EOF");
+      }
+         // seek back across blocks and read the long line again
+      strm.clear();
+      strm.seekg(pos15k);
+      strm.formattedGetLine(view);
+      TUASSERTE(size_t, lines[15000].size(), view.size());
+      strm.formattedGetLine(view);
+      TUASSERTE(string, lines[15001], view.str());
+   }
+      // Data appended while reading in blocks is seen after
+      // reaching the end, as with std::filebuf.
+   FFTextStream strm(fn.c_str(), ios::in);
+   TUASSERT(setInput(strm, Blocks));
+   string line;
+   for (unsigned i = 0; i < lines.size(); i++)
+      strm.formattedGetLine(line);
+   {
+      ofstream s(fn.c_str(), ios::out | ios::app | ios::binary);
+      s << "appended\n";
+   }
+   strm.formattedGetLine(line, true);
+   TUASSERTE(string, "appended", line);
+      // A file truncated while reading in blocks just ends early.
+   strm.open(fn.c_str(), ios::in);
+   TUASSERT(setInput(strm, Blocks));
+   strm.formattedGetLine(line);
+   {
+      ofstream s(fn.c_str(), ios::out | ios::trunc | ios::binary);
+      s << "short\n";
+   }
+   unsigned count = 0;
+   try
+   {
+      while (true)
+      {
+         strm.formattedGetLine(line, true);
+         count++;
+      }
+   }
+   catch (EndOfFile&)
+   {
+   }
+   TUASSERT(count < lines.size());
+   std::remove(fn.c_str());
+   TURETURN();
+}
+
+
+string FFTextStream_T ::
+readObs(const string& fn, Input in)
+{
+   ostringstream rv;
+   Rinex3ObsStream strm(fn.c_str(), ios::in);
+   setInput(strm, in);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+   rv << setprecision(17);
+   while (strm >> rod)
+   {
+      rv << rod.time << " " << rod.epochFlag << " " << rod.numSVs << " "
+         << rod.clockOffset << " " << rod.auxHeader.commentList.size()
+         << endl;
+      for (const auto& i : rod.obs)
+      {
+         rv << i.first;
+         for (const auto& d : i.second)
+         {
+            rv << " " << d.data << "," << d.dataBlank << "," << d.lli << ","
+               << d.lliBlank << "," << d.ssi << "," << d.ssiBlank;
+         }
+         rv << endl;
+      }
+   }
+   return rv.str();
+}
+
+
+unsigned FFTextStream_T ::
+rinex3ObsTest()
+{
+   TUDEF("Rinex3ObsData", "reallyGetRecord");
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   TUASSERT(strm.bufferInput());
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+   TUASSERT(static_cast<bool>(strm));
+   strm >> rod;
+   TUASSERT(static_cast<bool>(strm));
+   TUASSERTE(size_t, 3, rod.obs.size());
+   RinexSatID g1("G01"), g3("G03"), e5("E05");
+   TUASSERTE(size_t, 4, rod.obs[g1].size());
+   TUASSERTFE(24237168.685, rod.obs[g1][0].data);
+   TUASSERTE(short, 4, rod.obs[g1][0].ssi);
+   TUASSERT(rod.obs[g1][0].lliBlank);
+   TUASSERTFE(47.866, rod.obs[g1][3].data);
+      // the last observation is missing from the short line
+   TUASSERTE(size_t, 3, rod.obs[e5].size());
+   TUASSERTFE(105326611.209, rod.obs[e5][1].data);
+   TUASSERT(rod.obs[e5][1].ssiBlank);
+   TUASSERT(rod.obs[e5][2].dataBlank);
+   TUASSERT(rod.obs[g3][0].dataBlank);
+   TUASSERTE(short, 1, rod.obs[g3][1].lli);
+   TUASSERTE(short, 7, rod.obs[g3][1].ssi);
+   TUASSERT(rod.obs[g3][3].dataBlank);
+   strm >> rod;
+   TUASSERTE(short, 4, rod.epochFlag);
+   TUASSERTE(size_t, 1, rod.auxHeader.commentList.size());
+   strm >> rod;
+   TUASSERTFE(-0.000123456789, rod.clockOffset);
+   TUASSERTFE(109908710.5, rod.obs[g1][1].data);
+   TUASSERT(rod.obs[g1][1].ssiBlank);
+   TUASSERT(!(strm >> rod));
+   TUASSERT(strm.eof());
+      // buffered and unbuffered reads are the same
+   string plain = readObs(rinex3File, Plain);
+   TUASSERT(!plain.empty());
+   TUASSERTE(string, plain, readObs(rinex3File, Blocks));
+   TUASSERTE(string, plain, readObs(rinex3File, Mapped));
+   TURETURN();
+}
+
+
+unsigned FFTextStream_T ::
+rinex2ObsTest()
+{
+   TUDEF("Rinex3ObsData", "reallyGetRecordVer2");
+   Rinex3ObsStream strm(rinex2File.c_str(), ios::in);
+   TUASSERT(strm.bufferInput());
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+   TUASSERT(static_cast<bool>(strm));
+   strm >> rod;
+   TUASSERT(static_cast<bool>(strm));
+   TUASSERTE(size_t, 2, rod.obs.size());
+   RinexSatID g1("G01"), r2("R02");
+   TUASSERTE(size_t, 6, rod.obs[g1].size());
+   TUASSERTFE(85643101.123, rod.obs[g1][2].data);
+   TUASSERTE(short, 8, rod.obs[g1][2].ssi);
+   TUASSERTFE(44, rod.obs[g1][5].data);
+      // the CR is removed and the rest of the line is blank
+   TUASSERTFE(-24427464.594, rod.obs[r2][1].data);
+   TUASSERTE(short, 9, rod.obs[r2][1].lli);
+   TUASSERTE(short, 8, rod.obs[r2][2].ssi);
+   TUASSERT(rod.obs[r2][4].dataBlank);
+      // blank line between epochs is skipped
+   strm >> rod;
+   TUASSERT(static_cast<bool>(strm));
+   TUASSERTFE(-0.000123456, rod.clockOffset);
+   TUASSERTFE(44.25, rod.obs[g1][5].data);
+   TUASSERT(!(strm >> rod));
+   string plain = readObs(rinex2File, Plain);
+   TUASSERT(!plain.empty());
+   TUASSERTE(string, plain, readObs(rinex2File, Blocks));
+   TUASSERTE(string, plain, readObs(rinex2File, Mapped));
+   TURETURN();
+}
+
+
+int main(int argc, char *argv[])
+{
+   int errorTotal = 0;
+   FFTextStream_T testClass;
+
+   errorTotal += testClass.textLineTest();
+   errorTotal += testClass.getLineTest();
+   errorTotal += testClass.bufferInputTest();
+   errorTotal += testClass.blockTest();
+   errorTotal += testClass.rinex3ObsTest();
+   errorTotal += testClass.rinex2ObsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
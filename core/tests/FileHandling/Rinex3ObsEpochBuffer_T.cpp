@@ -0,0 +1,424 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <cmath>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <iomanip>
+#include "Rinex3ObsEpochBuffer.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gnsstk;
+
+class Rinex3ObsEpochBuffer_T
+{
+public:
+   Rinex3ObsEpochBuffer_T();
+
+      /// Compare RINEX 3 records with those read by Rinex3ObsData.
+   unsigned rinex3Test();
+      /// Compare RINEX 2 records with those read by Rinex3ObsData.
+   unsigned rinex2Test();
+      /// Check that reading doesn't reallocate a reserved buffer.
+   unsigned reuseTest();
+      /// Check conversion to and from Rinex3ObsData::DataMap.
+   unsigned dataMapTest();
+      /// Check that writing matches Rinex3ObsData.
+   unsigned writeTest();
+      /// Check that filtering matches Rinex3ObsData.
+   unsigned filterTest();
+
+      /// Return a text representation of the contents of a record.
+   static string dumpRecord(const Rinex3ObsData& rod);
+      /// Read a file with Rinex3ObsData and return its records' text.
+   static string readObsData(const string& fn);
+      /// Read a file with Rinex3ObsEpochBuffer and return its records' text.
+   static string readBuffer(const string& fn);
+
+   string rinex3File;   ///< RINEX 3 obs test file.
+   string rinex2File;   ///< RINEX 2 obs test file.
+};
+
+
+Rinex3ObsEpochBuffer_T ::
+Rinex3ObsEpochBuffer_T()
+{
+   string op = getPathTestTemp() + getFileSep();
+   rinex3File = op + "test_output_Rinex3ObsEpochBuffer.rnx";
+   rinex2File = op + "test_output_Rinex3ObsEpochBuffer.06o";
+   ofstream s3(rinex3File.c_str(), ios::out | ios::binary);
+   s3 << "     3.02           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT             NONE                    ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+      << "E    2 C1C L1C                                              SYS / # / OBS TYPES\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << "> 2020 01 01 00 00  0.0000000  0  3      -0.000123456789\n"
+      << "G01  24237168.685 4 109908701.742 9     -1234.500          41.250\n"
+      << "E03  20576567.763   108127644.59416\n"
+      << "G05  22000001.001\n"
+      << "> 2020 01 01 00 00 30.0000000  4  1\n"
+      << "event comment                                               COMMENT\n"
+      << "> 2020 01 01 00 01  0.0000000  0  2\n"
+      << "E03  20576570.001   108127650.000 7\n"
+      << "G01                 109908710.000      -1235.000          42.000\n";
+   ofstream s2(rinex2File.c_str(), ios::out | ios::binary);
+   s2 << "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT                                     ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "     1     1                                                WAVELENGTH FACT L1/2\n"
+      << "     2    C1    L1                                          # / TYPES OF OBSERV\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << " 20  1  1  0  0  0.0000000  0  2G 1G 2\n"
+      << "  24237168.685 4 109908701.742 9\n"
+      << "  20576567.763   108127644.594  \n"
+      << " 20  1  1  0  0 30.0000000  0  1G 1\n"
+      << "  24237170.001   109908710.5   \n";
+}
+
+
+string Rinex3ObsEpochBuffer_T ::
+dumpRecord(const Rinex3ObsData& rod)
+{
+   ostringstream rv;
+   rv << setprecision(17);
+   rv << rod.time << " " << rod.epochFlag << " " << rod.numSVs << " "
+      << rod.clockOffset << " " << rod.auxHeader.commentList.size()
+      << endl;
+   for (const auto& i : rod.obs)
+   {
+      rv << i.first;
+      for (const auto& d : i.second)
+      {
+         rv << " " << d.data << "," << d.dataBlank << "," << d.lli << ","
+            << d.lliBlank << "," << d.ssi << "," << d.ssiBlank;
+      }
+      rv << endl;
+   }
+   return rv.str();
+}
+
+
+string Rinex3ObsEpochBuffer_T ::
+readObsData(const string& fn)
+{
+   string rv;
+   Rinex3ObsStream strm(fn.c_str(), ios::in);
+   Rinex3ObsData rod;
+   while (strm >> rod)
+   {
+      rv += dumpRecord(rod);
+   }
+   return rv;
+}
+
+
+string Rinex3ObsEpochBuffer_T ::
+readBuffer(const string& fn)
+{
+   string rv;
+   Rinex3ObsStream strm(fn.c_str(), ios::in);
+   Rinex3ObsEpochBuffer buf;
+   Rinex3ObsData rod;
+   while (strm >> buf)
+   {
+      buf.toObsData(rod);
+      rv += dumpRecord(rod);
+   }
+   return rv;
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+rinex3Test()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "reallyGetRecord");
+   string expected(readObsData(rinex3File));
+   TUASSERT(!expected.empty());
+   TUASSERTE(string, expected, readBuffer(rinex3File));
+
+      // check the accessors against the file contents
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   Rinex3ObsEpochBuffer buf;
+   TUASSERT(static_cast<bool>(strm >> buf));
+   TUASSERTE(size_t, 3, buf.getNumSats());
+   TUASSERTE(size_t, 4, buf.getWidth());
+   TUASSERTFE(-0.000123456789, buf.clockOffset);
+   TUASSERTE(RinexSatID, RinexSatID(1, SatelliteSystem::GPS), buf.getSat(0));
+   TUASSERTE(RinexSatID, RinexSatID(3, SatelliteSystem::Galileo),
+             buf.getSat(1));
+   TUASSERTE(long, 1,
+             buf.findSat(RinexSatID(3, SatelliteSystem::Galileo)));
+   TUASSERTE(long, -1, buf.findSat(RinexSatID(2, SatelliteSystem::GPS)));
+   TUASSERTE(size_t, 4, buf.getNumObs(0));
+   TUASSERTE(size_t, 2, buf.getNumObs(1));
+   TUASSERTFE(24237168.685, buf.getData(0, 0));
+   TUASSERTE(unsigned, Rinex3ObsEpochBuffer::blankIndicator,
+             buf.getLLI(0, 0));
+   TUASSERTE(unsigned, 4, buf.getSSI(0, 0));
+   TUASSERTE(unsigned, 9, buf.getSSI(0, 1));
+   TUASSERTFE(-1234.5, buf.getDataRow(0)[2]);
+   TUASSERT(buf.isDataBlank(1, 2));
+   TUASSERTE(unsigned, 1, buf.getLLI(1, 1));
+   TUASSERTE(unsigned, 6, buf.getSSI(1, 1));
+      // G05 only has its first observation
+   TUASSERTFE(22000001.001, buf.getData(2, 0));
+   TUASSERT(buf.isDataBlank(2, 1));
+   TUASSERT(std::isnan(buf.getData(2, 3)));
+   TUASSERTE(unsigned, Rinex3ObsEpochBuffer::blankIndicator,
+             buf.getSSI(2, 3));
+      // the event record
+   TUASSERT(static_cast<bool>(strm >> buf));
+   TUASSERTE(short, 4, buf.epochFlag);
+   TUASSERTE(size_t, 0, buf.getNumSats());
+   TUASSERTE(size_t, 1, buf.auxHeader.commentList.size());
+      // the last record, which must not keep the event's comments
+   TUASSERT(static_cast<bool>(strm >> buf));
+   TUASSERTE(size_t, 2, buf.getNumSats());
+   TUASSERTE(size_t, 0, buf.auxHeader.commentList.size());
+   TUASSERT(buf.isDataBlank(1, 0));
+   TUASSERTFE(109908710.0, buf.getData(1, 1));
+   TUASSERTFE(0., buf.clockOffset);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+rinex2Test()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "reallyGetRecord");
+   string expected(readObsData(rinex2File));
+   TUASSERT(!expected.empty());
+   TUASSERTE(string, expected, readBuffer(rinex2File));
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+reuseTest()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "reserve");
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsEpochBuffer buf;
+   TUASSERT(static_cast<bool>(strm >> hdr));
+   buf.reserve(hdr, 3);
+   TUASSERTE(size_t, 4, buf.getWidth());
+   TUASSERTE(size_t, 0, buf.getNumSats());
+   buf.addSat(RinexSatID(1, SatelliteSystem::GPS), 4);
+   const double *storage = buf.getDataRow(0);
+   unsigned records = 0;
+   while (strm >> buf)
+   {
+      records++;
+      TUASSERTE(const double*, storage, buf.getDataRow(0));
+   }
+   TUASSERTE(unsigned, 3, records);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+dataMapTest()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "fromDataMap");
+   Rinex3ObsData::DataMap dm, dm2;
+   RinexSatID g1(1, SatelliteSystem::GPS), e3(3, SatelliteSystem::Galileo);
+   dm[g1].resize(2);
+   dm[g1][0].fromString("  24237168.685 4");
+   dm[g1][1].fromString("              12");
+   dm[e3].resize(3);
+   dm[e3][0].fromString(string(16, ' '));
+   dm[e3][2].fromString("     -1234.500  ");
+   Rinex3ObsEpochBuffer buf;
+   buf.fromDataMap(dm);
+   TUASSERTE(size_t, 2, buf.getNumSats());
+   TUASSERTE(size_t, 3, buf.getWidth());
+   TUASSERTE(size_t, 2, buf.getNumObs(0));
+   TUASSERTE(size_t, 3, buf.getNumObs(1));
+   TUASSERT(buf.isDataBlank(0, 1));
+   TUASSERTE(unsigned, 1, buf.getLLI(0, 1));
+   TUASSERTE(unsigned, 2, buf.getSSI(0, 1));
+   TUASSERT(buf.isDataBlank(1, 0));
+   TUASSERTFE(-1234.5, buf.getData(1, 2));
+   buf.toDataMap(dm2);
+   Rinex3ObsData rod, rod2;
+   rod.obs = dm;
+   rod2.obs = dm2;
+   TUASSERTE(string, dumpRecord(rod), dumpRecord(rod2));
+
+      // widening keeps the existing rows
+   RinexSatID g7(7, SatelliteSystem::GPS);
+   size_t row = buf.addSat(g7, 5);
+   TUASSERTE(size_t, 2, row);
+   TUASSERTE(size_t, 5, buf.getWidth());
+   TUASSERTFE(24237168.685, buf.getData(0, 0));
+   TUASSERTFE(-1234.5, buf.getData(1, 2));
+   TUASSERT(buf.isDataBlank(2, 4));
+   RinexDatum datum;
+   datum.fromString("      1234.000 3");
+   buf.setDatum(row, 4, datum);
+   TUASSERTFE(1234.0, buf.getData(2, 4));
+   TUASSERTE(unsigned, Rinex3ObsEpochBuffer::blankIndicator,
+             buf.getLLI(2, 4));
+   TUASSERTE(unsigned, 3, buf.getSSI(2, 4));
+   buf.toDataMap(dm2);
+   TUASSERTE(size_t, 3, dm2.size());
+   TUASSERTE(size_t, 5, dm2[g7].size());
+   TUASSERT(dm2[g7][0].dataBlank);
+   TUASSERTFE(1234.0, dm2[g7][4].data);
+   TUASSERT(dm2[g7][4].lliBlank);
+   TUASSERTE(short, 3, dm2[g7][4].ssi);
+   buf.clear();
+   TUASSERTE(size_t, 0, buf.getNumSats());
+   TUASSERTE(size_t, 5, buf.getWidth());
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+writeTest()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "reallyPutRecord");
+   string op = getPathTestTemp() + getFileSep();
+   string fnData = op + "test_output_Rinex3ObsEpochBuffer_data.rnx";
+   string fnBuf = op + "test_output_Rinex3ObsEpochBuffer_buf.rnx";
+   {
+      Rinex3ObsStream in(rinex3File.c_str(), ios::in);
+      Rinex3ObsStream out(fnData.c_str(), ios::out);
+      Rinex3ObsHeader hdr;
+      Rinex3ObsData rod;
+      in >> hdr;
+      out << hdr;
+      while (in >> rod)
+         out << rod;
+   }
+   {
+      Rinex3ObsStream in(rinex3File.c_str(), ios::in);
+      Rinex3ObsStream out(fnBuf.c_str(), ios::out);
+      Rinex3ObsHeader hdr;
+      Rinex3ObsEpochBuffer buf;
+      in >> hdr;
+      out << hdr;
+      while (in >> buf)
+         out << buf;
+   }
+   testFramework.assert_files_equal(__LINE__, fnData, fnBuf,
+                                    "Output of Rinex3ObsEpochBuffer differs "
+                                    "from Rinex3ObsData", 0);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsEpochBuffer_T ::
+filterTest()
+{
+   TUDEF("Rinex3ObsEpochBuffer", "getRecord");
+   RinexSatID g5(5, SatelliteSystem::GPS);
+   Rinex3ObsHeader::RinexObsMap wanted;
+   wanted["G"].push_back(RinexObsID("GC1C", 3.02));
+   wanted["G"].push_back(RinexObsID("GS1C", 3.02));
+   wanted["E"].push_back(RinexObsID("EL1C", 3.02));
+   set<RinexSatID> excluded;
+   excluded.insert(g5);
+
+      // the epoch buffer filters the same way as Rinex3ObsData
+   string expected, got;
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   strm.setWantedObsTypes(wanted);
+   strm.setExcludedSats(excluded);
+   Rinex3ObsData rod;
+   while (strm >> rod)
+      expected += dumpRecord(rod);
+   Rinex3ObsStream bstrm(rinex3File.c_str(), ios::in);
+   Rinex3ObsHeader hdr;
+   bstrm >> hdr;
+   bstrm.setWantedObsTypes(wanted);
+   bstrm.setExcludedSats(excluded);
+   Rinex3ObsEpochBuffer buf;
+   while (bstrm >> buf)
+   {
+      if (got.empty())
+      {
+         TUASSERTE(short, 2, buf.numSVs);
+         TUASSERTE(size_t, 2, buf.getNumSats());
+         TUASSERTE(long, -1, buf.findSat(g5));
+         TUASSERT(buf.isDataBlank(0, 1));
+         TUASSERTFE(41.25, buf.getData(0, 3));
+      }
+      buf.toObsData(rod);
+      got += dumpRecord(rod);
+   }
+   TUASSERT(!expected.empty());
+   TUASSERTE(string, expected, got);
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsEpochBuffer_T testClass;
+
+   errorTotal += testClass.rinex3Test();
+   errorTotal += testClass.rinex2Test();
+   errorTotal += testClass.reuseTest();
+   errorTotal += testClass.dataMapTest();
+   errorTotal += testClass.writeTest();
+   errorTotal += testClass.filterTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,371 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "Rinex3ObsParallelReader.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gnsstk;
+
+class Rinex3ObsParallelReader_T
+{
+public:
+   Rinex3ObsParallelReader_T();
+
+      /// Compare RINEX 3 records with those read by Rinex3ObsStream.
+   unsigned rinex3Test();
+      /// Check that RINEX 2 files are read sequentially.
+   unsigned rinex2Test();
+      /// Check that an error is thrown after the preceding records.
+   unsigned errorTest();
+      /// Check read() and stopping early.
+   unsigned readTest();
+
+      /// Return a text representation of the contents of a record.
+   static string dumpRecord(const Rinex3ObsData& rod);
+      /// Read a file with Rinex3ObsStream and return its records' text.
+   static string readStream(const string& fn);
+      /// Read a file with Rinex3ObsParallelReader and return its text.
+   static string readParallel(const string& fn, unsigned numThreads,
+                              size_t chunkSize);
+
+      /** Write a RINEX 3 obs file.
+       * @param[in] fn The path of the file to write.
+       * @param[in] badEpoch If non-negative, the index of an epoch
+       *   whose epoch line is corrupted. */
+   static void writeRinex3(const string& fn, int badEpoch);
+
+   string rinex3File;   ///< Valid RINEX 3 obs test file.
+   string rinex2File;   ///< RINEX 2 obs test file.
+   string badFile;      ///< RINEX 3 obs test file with an error.
+      /// Number of epoch records written by writeRinex3().
+   static const int numEpochs = 240;
+};
+
+
+Rinex3ObsParallelReader_T ::
+Rinex3ObsParallelReader_T()
+{
+   string op = getPathTestTemp() + getFileSep();
+   rinex3File = op + "test_output_Rinex3ObsParallelReader.rnx";
+   rinex2File = op + "test_output_Rinex3ObsParallelReader.06o";
+   badFile = op + "test_output_Rinex3ObsParallelReader_bad.rnx";
+   writeRinex3(rinex3File, -1);
+   writeRinex3(badFile, 151);
+   ofstream s(rinex2File.c_str(), ios::out | ios::binary);
+   s << "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+     << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+     << "TEST                                                        MARKER NAME\n"
+     << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+     << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+     << "1                   ANT                                     ANT # / TYPE\n"
+     << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+     << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+     << "     1     1                                                WAVELENGTH FACT L1/2\n"
+     << "     2    C1    L1                                          # / TYPES OF OBSERV\n"
+     << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+     << "                                                            END OF HEADER\n"
+     << " 20  1  1  0  0  0.0000000  0  2G 1G 2\n"
+     << "  24237168.685 4 109908701.742 9\n"
+     << "  20576567.763   108127644.594  \n"
+     << " 20  1  1  0  0 30.0000000  0  1G 1\n"
+     << "  24237170.001   109908710.5   \n";
+}
+
+
+void Rinex3ObsParallelReader_T ::
+writeRinex3(const string& fn, int badEpoch)
+{
+   ofstream s(fn.c_str(), ios::out | ios::binary);
+   s << "     3.00           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+     << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+     << "TEST                                                        MARKER NAME\n"
+     << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+     << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+     << "1                   ANT             NONE                    ANT # / TYPE\n"
+     << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+     << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+     << "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+     << "E    3 C1C L1C S1C                                          SYS / # / OBS TYPES\n"
+     << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+     << "                                                            END OF HEADER\n";
+   char buf[128];
+   for (int e = 0; e < numEpochs; e++)
+   {
+      int hr = e / 120, mn = (e / 2) % 60;
+      double sec = 30.0 * (e % 2);
+      if (e % 40 == 39)
+      {
+            // An event whose second comment looks like an epoch line,
+            // to make sure a chunk can't start there.
+         snprintf(buf, sizeof(buf), "> 2020 01 01 %02d %02d%11.7f  4  2\n",
+                  hr, mn, sec);
+         s << buf
+           << "event comment                                               COMMENT\n"
+           << "> 2020 01 01 23 59  0.0000000  0  1                         COMMENT\n";
+         continue;
+      }
+      int numSats = 3 + (e % 3);
+      snprintf(buf, sizeof(buf), "> 2020 01 01 %02d %02d%11.7f  %d%3d",
+               hr, mn, sec, (e == badEpoch ? 9 : 0), numSats);
+      s << buf;
+      if (e % 5 == 0)
+      {
+         snprintf(buf, sizeof(buf), "      %15.12f", -1.25e-4 * e);
+         s << buf;
+      }
+      s << "\n";
+      for (int i = 0; i < numSats; i++)
+      {
+         bool gal = (i == 2);
+         snprintf(buf, sizeof(buf), "%c%02d", (gal ? 'E' : 'G'), 2*i+1);
+         s << buf;
+         double range = 2.0e7 + 1.0e5*i + 0.731*e;
+         snprintf(buf, sizeof(buf), "%14.3f%c%c%14.3f %d", range,
+                  (e % 7 == 0 ? '1' : ' '), '0' + (i+e) % 10,
+                  range / 0.19029367, 5 + i);
+         s << buf;
+         if (!gal)
+         {
+               // leave the doppler blank sometimes
+            if (e % 4 != 1)
+            {
+               snprintf(buf, sizeof(buf), "%14.3f  ", -1234.5 + e);
+               s << buf;
+            }
+            else
+            {
+               s << string(16, ' ');
+            }
+         }
+         if ((e + i) % 6 != 0)
+         {
+            snprintf(buf, sizeof(buf), "%14.3f", 40.0 + 0.25*i);
+            s << buf;
+         }
+         s << "\n";
+      }
+   }
+}
+
+
+string Rinex3ObsParallelReader_T ::
+dumpRecord(const Rinex3ObsData& rod)
+{
+   ostringstream rv;
+   rv << setprecision(17);
+   rv << rod.time << " " << rod.epochFlag << " " << rod.numSVs << " "
+      << rod.clockOffset << " " << rod.auxHeader.commentList.size()
+      << endl;
+   for (const auto& i : rod.obs)
+   {
+      rv << i.first;
+      for (const auto& d : i.second)
+      {
+         rv << " " << d.data << "," << d.dataBlank << "," << d.lli << ","
+            << d.lliBlank << "," << d.ssi << "," << d.ssiBlank;
+      }
+      rv << endl;
+   }
+   return rv.str();
+}
+
+
+string Rinex3ObsParallelReader_T ::
+readStream(const string& fn)
+{
+   string rv;
+   Rinex3ObsStream strm(fn.c_str(), ios::in);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+   while (strm >> rod)
+   {
+      rv += dumpRecord(rod);
+   }
+   return rv;
+}
+
+
+string Rinex3ObsParallelReader_T ::
+readParallel(const string& fn, unsigned numThreads, size_t chunkSize)
+{
+   string rv;
+   Rinex3ObsParallelReader rdr(fn, numThreads, chunkSize);
+   const Rinex3ObsData *rod;
+   while ((rod = rdr.next()) != nullptr)
+   {
+      rv += dumpRecord(*rod);
+   }
+   return rv;
+}
+
+
+unsigned Rinex3ObsParallelReader_T ::
+rinex3Test()
+{
+   TUDEF("Rinex3ObsParallelReader", "next");
+   string expected(readStream(rinex3File));
+   TUASSERT(!expected.empty());
+   {
+      Rinex3ObsParallelReader rdr(rinex3File, 3, 1000);
+      TUASSERTE(unsigned, 3, rdr.getNumThreads());
+      TUASSERTE(double, 3.0, rdr.getHeader().version);
+      TUASSERTE(size_t, 2, rdr.getHeader().mapObsTypes.size());
+   }
+      // Small chunks put a boundary next to every epoch line,
+      // including the ones that are really comments.
+   size_t chunkSizes[] = { 1, 64, 333, 1000, 4096, 1000000 };
+   for (size_t chunkSize : chunkSizes)
+   {
+      for (unsigned numThreads = 1; numThreads <= 4; numThreads++)
+      {
+         string got(readParallel(rinex3File, numThreads, chunkSize));
+         TUASSERTE(string, expected, got);
+      }
+   }
+   TUASSERTE(string, expected,
+             readParallel(rinex3File, 0,
+                          Rinex3ObsParallelReader::defaultChunkSize));
+   TUCSM("Rinex3ObsParallelReader");
+   try
+   {
+      Rinex3ObsParallelReader rdr(getPathTestTemp() + getFileSep() +
+                                  "no_such_file.rnx");
+      TUFAIL("Expected FileMissingException");
+   }
+   catch (FileMissingException&)
+   {
+      TUPASS("FileMissingException");
+   }
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallelReader_T ::
+rinex2Test()
+{
+   TUDEF("Rinex3ObsParallelReader", "next");
+   Rinex3ObsParallelReader rdr(rinex2File, 4, 64);
+   TUASSERTE(unsigned, 0, rdr.getNumThreads());
+   TUASSERTE(double, 2.11, rdr.getHeader().version);
+   TUASSERTE(string, readStream(rinex2File), readParallel(rinex2File, 4, 64));
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallelReader_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "next");
+   string expected(readStream(badFile));
+   TUASSERT(!expected.empty());
+   size_t chunkSizes[] = { 64, 1000, 1000000 };
+   for (size_t chunkSize : chunkSizes)
+   {
+      for (unsigned numThreads = 1; numThreads <= 3; numThreads++)
+      {
+         Rinex3ObsParallelReader rdr(badFile, numThreads, chunkSize);
+         string got;
+         const Rinex3ObsData *rod;
+         try
+         {
+            while ((rod = rdr.next()) != nullptr)
+            {
+               got += dumpRecord(*rod);
+            }
+            TUFAIL("Expected an exception");
+         }
+         catch (Exception& exc)
+         {
+            TUPASS("Exception");
+         }
+         TUASSERTE(string, expected, got);
+            // nothing more after the error
+         TUASSERT(rdr.next() == nullptr);
+      }
+   }
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallelReader_T ::
+readTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "read");
+   string expected(readStream(rinex3File));
+   string got;
+   Rinex3ObsParallelReader rdr(rinex3File, 2, 500);
+   TUASSERT(rdr.read([&got](const Rinex3ObsData& rod)
+                     {
+                        got += dumpRecord(rod);
+                        return true;
+                     }));
+   TUASSERTE(string, expected, got);
+      // stop part way through, leaving the workers with chunks queued
+   Rinex3ObsParallelReader rdr2(rinex3File, 2, 500);
+   unsigned count = 0;
+   TUASSERT(!rdr2.read([&count](const Rinex3ObsData& rod)
+                       {
+                          return (++count < 10);
+                       }));
+   TUASSERTE(unsigned, 10, count);
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsParallelReader_T testClass;
+
+   errorTotal += testClass.rinex3Test();
+   errorTotal += testClass.rinex2Test();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.readTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,274 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <fstream>
+#include <set>
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gnsstk;
+
+class Rinex3ObsStream_T
+{
+public:
+   Rinex3ObsStream_T();
+
+      /// Check filtering of RINEX 3 records by obs type and satellite.
+   unsigned filterRinex3Test();
+      /// Check filtering of RINEX 2 records by obs type and satellite.
+   unsigned filterRinex2Test();
+      /// Check that an empty filter reads everything again.
+   unsigned clearFilterTest();
+      /// Check that a filtered record is written with the kept satellites.
+   unsigned writeFilteredTest();
+
+   string rinex3File;   ///< RINEX 3 obs test file.
+   string rinex2File;   ///< RINEX 2 obs test file.
+   string outputFile;   ///< RINEX 3 obs output file.
+   RinexSatID g1, g2, g5, e3;
+      /// Obs types to read for GPS and Galileo.
+   Rinex3ObsHeader::RinexObsMap wanted;
+};
+
+
+Rinex3ObsStream_T ::
+Rinex3ObsStream_T()
+      : g1(1, SatelliteSystem::GPS), g2(2, SatelliteSystem::GPS),
+        g5(5, SatelliteSystem::GPS), e3(3, SatelliteSystem::Galileo)
+{
+   string op = getPathTestTemp() + getFileSep();
+   rinex3File = op + "test_output_Rinex3ObsStream.rnx";
+   rinex2File = op + "test_output_Rinex3ObsStream.06o";
+   outputFile = op + "test_output_Rinex3ObsStream_filtered.rnx";
+   wanted["G"].push_back(RinexObsID("GC1C", 3.02));
+   wanted["G"].push_back(RinexObsID("GS1C", 3.02));
+   wanted["E"].push_back(RinexObsID("EL1C", 3.02));
+   ofstream s3(rinex3File.c_str(), ios::out | ios::binary);
+   s3 << "     3.02           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT             NONE                    ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+      << "E    2 C1C L1C                                              SYS / # / OBS TYPES\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << "> 2020 01 01 00 00  0.0000000  0  3      -0.000123456789\n"
+      << "G01  24237168.685 4 109908701.742 9     -1234.500          41.250\n"
+      << "E03  20576567.763   108127644.59416\n"
+      << "G05  22000001.001\n"
+      << "> 2020 01 01 00 00 30.0000000  4  1\n"
+      << "event comment                                               COMMENT\n"
+      << "> 2020 01 01 00 01  0.0000000  0  2\n"
+      << "E03  20576570.001   108127650.000 7\n"
+      << "G01                 109908710.000      -1235.000          42.000\n";
+   ofstream s2(rinex2File.c_str(), ios::out | ios::binary);
+   s2 << "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT                                     ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "     1     1                                                WAVELENGTH FACT L1/2\n"
+      << "     2    C1    L1                                          # / TYPES OF OBSERV\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << " 20  1  1  0  0  0.0000000  0  2G 1G 2\n"
+      << "  24237168.685 4 109908701.742 9\n"
+      << "  20576567.763   108127644.594  \n"
+      << " 20  1  1  0  0 30.0000000  0  1G 1\n"
+      << "  24237170.001   109908710.5   \n";
+}
+
+
+unsigned Rinex3ObsStream_T ::
+filterRinex3Test()
+{
+   TUDEF("Rinex3ObsStream", "setWantedObsTypes");
+   set<RinexSatID> excluded;
+   excluded.insert(g5);
+
+      // filters set before the header is read
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   strm.setWantedObsTypes(wanted);
+   strm.setExcludedSats(excluded);
+   Rinex3ObsData rod;
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(short, 2, rod.numSVs);
+   TUASSERTE(size_t, 2, rod.obs.size());
+   TUASSERT(rod.obs.find(g5) == rod.obs.end());
+   TUASSERTE(size_t, 4, rod.obs[g1].size());
+   TUASSERTFE(24237168.685, rod.obs[g1][0].data);
+   TUASSERTE(short, 4, rod.obs[g1][0].ssi);
+   TUASSERT(rod.obs[g1][1].dataBlank);
+   TUASSERT(rod.obs[g1][1].ssiBlank);
+   TUASSERT(rod.obs[g1][2].dataBlank);
+   TUASSERTFE(41.25, rod.obs[g1][3].data);
+   TUASSERTE(size_t, 2, rod.obs[e3].size());
+   TUASSERT(rod.obs[e3][0].dataBlank);
+   TUASSERTFE(108127644.594, rod.obs[e3][1].data);
+   TUASSERTE(short, 1, rod.obs[e3][1].lli);
+      // auxiliary header records are unaffected
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(short, 4, rod.epochFlag);
+   TUASSERTE(short, 1, rod.numSVs);
+   TUASSERTE(size_t, 1, rod.auxHeader.commentList.size());
+
+      // systems without wanted obs types are skipped
+   Rinex3ObsHeader::RinexObsMap gpsOnly;
+   gpsOnly["G"] = wanted["G"];
+   Rinex3ObsStream gstrm(rinex3File.c_str(), ios::in);
+   gstrm.setWantedObsTypes(gpsOnly);
+   TUASSERT(static_cast<bool>(gstrm >> rod));
+   TUASSERTE(short, 2, rod.numSVs);
+   TUASSERTE(size_t, 2, rod.obs.size());
+   TUASSERT(rod.obs.find(g5) != rod.obs.end());
+   TUASSERT(rod.obs.find(e3) == rod.obs.end());
+
+      // excluding satellites alone keeps every column
+   Rinex3ObsStream xstrm(rinex3File.c_str(), ios::in);
+   xstrm.setExcludedSats(excluded);
+   TUASSERT(static_cast<bool>(xstrm >> rod));
+   TUASSERTE(size_t, 2, rod.obs.size());
+   TUASSERTFE(109908701.742, rod.obs[g1][1].data);
+   TUASSERTFE(20576567.763, rod.obs[e3][0].data);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsStream_T ::
+filterRinex2Test()
+{
+   TUDEF("Rinex3ObsStream", "setWantedObsTypes");
+   Rinex3ObsHeader::RinexObsMap c1;
+   c1["G"].push_back(RinexObsID("GC1C", 3.02));
+   set<RinexSatID> excluded;
+   excluded.insert(g2);
+      // RINEX 2 records are filtered after parsing
+   Rinex3ObsStream strm(rinex2File.c_str(), ios::in);
+   strm.setWantedObsTypes(c1);
+   strm.setExcludedSats(excluded);
+   Rinex3ObsData rod;
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(short, 1, rod.numSVs);
+   TUASSERTE(size_t, 1, rod.obs.size());
+   TUASSERTE(size_t, 2, rod.obs[g1].size());
+   TUASSERTFE(24237168.685, rod.obs[g1][0].data);
+   TUASSERT(rod.obs[g1][1].dataBlank);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsStream_T ::
+clearFilterTest()
+{
+   TUDEF("Rinex3ObsStream", "setExcludedSats");
+   set<RinexSatID> excluded;
+   excluded.insert(g1);
+   Rinex3ObsStream strm(rinex2File.c_str(), ios::in);
+   strm.setWantedObsTypes(wanted);
+   strm.setExcludedSats(excluded);
+   Rinex3ObsData rod;
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(size_t, 1, rod.obs.size());
+   TUASSERT(rod.obs.find(g1) == rod.obs.end());
+      // an empty map and set remove the filter
+   strm.setWantedObsTypes(Rinex3ObsHeader::RinexObsMap());
+   strm.setExcludedSats(set<RinexSatID>());
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(short, 1, rod.numSVs);
+   TUASSERTE(size_t, 1, rod.obs.size());
+   TUASSERTFE(24237170.001, rod.obs[g1][0].data);
+   TUASSERTFE(109908710.5, rod.obs[g1][1].data);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsStream_T ::
+writeFilteredTest()
+{
+   TUDEF("Rinex3ObsStream", "setExcludedSats");
+   set<RinexSatID> excluded;
+   excluded.insert(g5);
+   Rinex3ObsStream strm(rinex3File.c_str(), ios::in);
+   strm.setExcludedSats(excluded);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod, rod2;
+   strm >> hdr;
+   TUASSERT(static_cast<bool>(strm >> rod));
+   TUASSERTE(short, 2, rod.numSVs);
+   {
+      Rinex3ObsStream out(outputFile.c_str(), ios::out);
+      out << hdr;
+      out << rod;
+   }
+      // the epoch line of the output counts only the kept satellites
+   Rinex3ObsStream in(outputFile.c_str(), ios::in);
+   in >> hdr;
+   TUASSERT(static_cast<bool>(in >> rod2));
+   TUASSERTE(short, 2, rod2.numSVs);
+   TUASSERTE(size_t, 2, rod2.obs.size());
+   TUASSERT(rod2.obs.find(g5) == rod2.obs.end());
+   TUASSERTFE(rod.obs[g1][3].data, rod2.obs[g1][3].data);
+   TUASSERTFE(rod.obs[e3][1].data, rod2.obs[e3][1].data);
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsStream_T testClass;
+
+   errorTotal += testClass.filterRinex3Test();
+   errorTotal += testClass.filterRinex2Test();
+   errorTotal += testClass.clearFilterTest();
+   errorTotal += testClass.writeFilteredTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,141 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <iostream>
+#include "BDSBCH.hpp"
+#include "PackedNavBits.hpp"
+#include "TestUtil.hpp"
+
+/// Automated tests for gnsstk::BDSBCH
+class BDSBCH_T
+{
+public:
+   BDSBCH_T();
+      /// Compare the parity table with polynomial division.
+   unsigned parityTest();
+      /// Check broadcast subframes and single bit errors.
+   unsigned checkTest();
+
+      /// Broadcast D1 (PRN 6) and D2 subframe 1, as collected.
+   gnsstk::PackedNavBits d1sf1, d2sf1;
+};
+
+
+BDSBCH_T ::
+BDSBCH_T()
+{
+   const unsigned long d1[] =
+   {
+      0x38901541, 0x18000020, 0x0654A846, 0x30052F4E, 0x2D070427,
+      0x3EC1CDC2, 0x30BF8085, 0x1C0028C1, 0x3F47E038, 0x1A8AE13D
+   };
+   const unsigned long d2[] =
+   {
+      0x38901541, 0x18004027, 0x00654A7C, 0x2303C840, 0x39B015EA,
+      0x1555554B, 0x1555554B, 0x1555554B, 0x1555554B, 0x1555554B
+   };
+   for (unsigned i = 0; i < 10; i++)
+   {
+      d1sf1.addUnsignedLong(d1[i], 30, 1);
+      d2sf1.addUnsignedLong(d2[i], 30, 1);
+   }
+   d1sf1.trimsize();
+   d2sf1.trimsize();
+}
+
+
+unsigned BDSBCH_T ::
+parityTest()
+{
+   TUDEF("BDSBCH", "parity");
+   for (uint16_t info = 0; info < 2048; info++)
+   {
+         // remainder of info * x^4 divided by x^4+x+1, bit by bit
+      uint32_t reg = info << 4;
+      for (int bit = 14; bit >= 4; bit--)
+      {
+         if (reg & (1 << bit))
+         {
+            reg ^= gnsstk::BDSBCH::poly << (bit - 4);
+         }
+      }
+      TUASSERTE(unsigned, reg, gnsstk::BDSBCH::parity(info));
+      TUASSERTE(bool, true, gnsstk::BDSBCH::checkCodeWord((info << 4) | reg));
+   }
+   TURETURN();
+}
+
+
+unsigned BDSBCH_T ::
+checkTest()
+{
+   TUDEF("BDSBCH", "check");
+   TUASSERTE(bool, true, gnsstk::BDSBCH::check(d1sf1));
+   TUASSERTE(bool, true, gnsstk::BDSBCH::check(d2sf1));
+      // The first 15 bits (preamble, etc.) aren't protected, every
+      // other single bit error is detected.
+   for (unsigned i = 0; i < 300; i++)
+   {
+      gnsstk::PackedNavBits bad(d1sf1);
+      bad.insertUnsignedLong(bad.asBool(i) ? 0 : 1, i, 1);
+      TUASSERTE(bool, (i < 15), gnsstk::BDSBCH::check(bad));
+   }
+   TUCSM("checkWord");
+   TUASSERTE(bool, true, gnsstk::BDSBCH::checkWord(0x38901541, true));
+   TUASSERTE(bool, true, gnsstk::BDSBCH::checkWord(0x18000020, false));
+   TUASSERTE(bool, false, gnsstk::BDSBCH::checkWord(0x18000021, false));
+   TUASSERTE(bool, false, gnsstk::BDSBCH::checkWord(0x18000030, false));
+   TUCSM("check");
+   TUTHROW(gnsstk::BDSBCH::check(d1sf1, 1));
+   TURETURN();
+}
+
+
+int main()
+{
+   BDSBCH_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.parityTest();
+   errorTotal += testClass.checkTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,214 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "CRC24Q.hpp"
+#include "PackedNavBits.hpp"
+#include "TestUtil.hpp"
+
+/// Automated tests for gnsstk::CRC24Q
+class CRC24Q_T
+{
+public:
+   CRC24Q_T();
+      /// Check against a published check value.
+   unsigned checkValueTest();
+      /** Make sure the table-driven methods give the same results as
+       * processing a bit at a time, for arbitrary lengths and
+       * alignments. */
+   unsigned tableTest();
+      /// Test the PackedNavBits methods.
+   unsigned packedNavBitsTest();
+      /// Check broadcast messages with their own CRCs.
+   unsigned broadcastTest();
+
+      /// Pseudo-random message contents.
+   gnsstk::PackedNavBits msg;
+      /** Broadcast GPS CNAV message type 10 from PRN 63 at
+       * 2015/12/31 00:00:00, and CNAV-2 subframe 3 page 1 from PRN 4
+       * at week 2049 SOW 345600, as collected. */
+   gnsstk::PackedNavBits cnavMsg, cnav2Msg;
+};
+
+
+CRC24Q_T ::
+CRC24Q_T()
+{
+   msg.trimsize();
+   uint32_t seed = 12345;
+   for (unsigned i = 0; i < 20; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      msg.addUnsignedLong(seed, 32, 1);
+   }
+   const unsigned long cnav[] =
+   {
+      0x8B04A708, 0x10EAA60A, 0x6A49007A, 0x2E3FFDAE, 0x42EEB000,
+      0x81B983C7, 0x9A881433, 0x89C04F25, 0xB9F60DD4
+   };
+   for (unsigned i = 0; i < 9; i++)
+   {
+      cnavMsg.addUnsignedLong(cnav[i], 32, 1);
+   }
+   cnavMsg.addUnsignedLong(0xED600000 >> 20, 12, 1);
+   cnavMsg.trimsize();
+   const unsigned long cnav2[] =
+   {
+      0x04040380, 0x0440049E, 0xC0100278, 0x97120B02, 0xFFFE2B02,
+      0xFDFDFF67, 0xC77CD7E6, 0xB000000F
+   };
+   for (unsigned i = 0; i < 8; i++)
+   {
+      cnav2Msg.addUnsignedLong(cnav2[i], 32, 1);
+   }
+   cnav2Msg.addUnsignedLong(0xBA514000 >> 14, 18, 1);
+   cnav2Msg.trimsize();
+}
+
+
+unsigned CRC24Q_T ::
+checkValueTest()
+{
+   TUDEF("CRC24Q", "process_bytes");
+   const char *check = "123456789";
+   gnsstk::CRC24Q uut;
+   uut.process_bytes(check, std::strlen(check));
+   TUASSERTE(uint32_t, 0xCDE703, uut.checksum());
+      // appending the CRC gives zero
+   uint8_t crcBytes[3] = { 0xCD, 0xE7, 0x03 };
+   uut.process_bytes(crcBytes, 3);
+   TUASSERTE(uint32_t, 0, uut.checksum());
+   TUCSM("reset");
+   uut.reset();
+   TUASSERTE(uint32_t, 0, uut.checksum());
+   TURETURN();
+}
+
+
+unsigned CRC24Q_T ::
+tableTest()
+{
+   TUDEF("CRC24Q", "process_bits");
+   for (unsigned start = 0; start < 40; start += 3)
+   {
+      for (unsigned len = 0; len < 600; len += 37)
+      {
+         gnsstk::CRC24Q serial, words, bits;
+         for (unsigned i = start; i < start+len; i++)
+         {
+            serial.process_bit(msg.asBool(i));
+         }
+         words.process(msg, start, len);
+            // odd sized chunks to exercise all of the paths
+         for (unsigned i = start, n = 0; i < start+len; i += n)
+         {
+            n = std::min(start+len-i, 13 + i % 51);
+            bits.process_bits(msg.asUnsignedLong(i, n, 1), n);
+         }
+         TUASSERTE(uint32_t, serial.checksum(), words.checksum());
+         TUASSERTE(uint32_t, serial.checksum(), bits.checksum());
+      }
+   }
+   TURETURN();
+}
+
+
+unsigned CRC24Q_T ::
+packedNavBitsTest()
+{
+   TUDEF("CRC24Q", "check");
+   gnsstk::PackedNavBits withCRC(msg);
+   gnsstk::CRC24Q crc;
+   crc.process(withCRC);
+   withCRC.addUnsignedLong(crc.checksum(), 24, 1);
+   TUASSERTE(bool, true, gnsstk::CRC24Q::check(withCRC, 0, 664));
+   TUASSERTE(bool, false, gnsstk::CRC24Q::check(withCRC, 1, 663));
+      // a single bit error anywhere is detected
+   for (unsigned i = 0; i < 664; i += 7)
+   {
+      gnsstk::PackedNavBits bad(withCRC);
+      bad.insertUnsignedLong(bad.asBool(i) ? 0 : 1, i, 1);
+      TUASSERTE(bool, false, gnsstk::CRC24Q::check(bad, 0, 664));
+   }
+   TUTHROW(gnsstk::CRC24Q::check(withCRC, 0, 665));
+   TURETURN();
+}
+
+
+unsigned CRC24Q_T ::
+broadcastTest()
+{
+   TUDEF("CRC24Q", "check");
+   TUASSERTE(size_t, 300, cnavMsg.getNumBits());
+   TUASSERTE(bool, true, gnsstk::CRC24Q::check(cnavMsg, 0, 300));
+   gnsstk::CRC24Q crc;
+   crc.process(cnavMsg, 0, 276);
+   TUASSERTE(uint32_t, cnavMsg.asUnsignedLong(276, 24, 1), crc.checksum());
+   TUASSERTE(size_t, 274, cnav2Msg.getNumBits());
+   TUASSERTE(bool, true, gnsstk::CRC24Q::check(cnav2Msg, 0, 274));
+   crc.reset();
+   crc.process(cnav2Msg, 0, 250);
+   TUASSERTE(uint32_t, cnav2Msg.asUnsignedLong(250, 24, 1), crc.checksum());
+      // a single bit error anywhere is detected
+   for (unsigned i = 0; i < 300; i++)
+   {
+      gnsstk::PackedNavBits bad(cnavMsg);
+      bad.insertUnsignedLong(bad.asBool(i) ? 0 : 1, i, 1);
+      TUASSERTE(bool, false, gnsstk::CRC24Q::check(bad, 0, 300));
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   CRC24Q_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.checkValueTest();
+   errorTotal += testClass.tableTest();
+   errorTotal += testClass.packedNavBitsTest();
+   errorTotal += testClass.broadcastTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -68,6 +68,7 @@ public:
    unsigned addDataVecByteAlignedTest();
    unsigned overInitialCapacity();
    unsigned addBitVecTest();
+   unsigned wordBoundaryTest();
 
    double eps;
 };
@@ -967,6 +968,73 @@ addBitVecTest()
 }
 
 
+   // Make sure fields that straddle the 64-bit storage words are
+   // handled correctly by the unpacking, appending and comparison
+   // methods.
+unsigned PackedNavBits_T ::
+wordBoundaryTest()
+{
+   TUDEF("PackedNavBits", "asUnsignedLong");
+   PackedNavBits uut;
+   uut.trimsize();
+      // 3-bit prefix pushes everything off byte alignment
+   uut.addUnsignedLong(5, 3, 1);
+   uut.addUnsignedLong(0x3ffffffUL, 26, 1);
+   uut.addLong(-1234567, 40, 1);
+   uut.addUnsignedLong(0xfedcba98UL, 32, 1);
+   uut.addLong(-2, 64, 1);
+   std::vector<int> tail{1,1,0};
+   uut.addBitVec(tail.begin(), tail.end());
+   TUASSERTE(size_t, 168, uut.getNumBits());
+   TUASSERTE(unsigned long, 5, uut.asUnsignedLong(0, 3, 1));
+   TUASSERTE(unsigned long, 0x3ffffffUL, uut.asUnsignedLong(3, 26, 1));
+      // bits 29-68 cross the first word boundary
+   TUASSERTE(long, -1234567, uut.asLong(29, 40, 1));
+   TUASSERTE(unsigned long, 0xfedcba98UL, uut.asUnsignedLong(69, 32, 1));
+      // bits 101-164 cross the second word boundary
+   TUASSERTE(long, -2, uut.asLong(101, 64, 1));
+   TUASSERTFE(-2.0 * 0.125, uut.asSignedDouble(101, 64, -3));
+   TUASSERTE(bool, true, uut.asBool(165));
+   TUASSERTE(bool, false, uut.asBool(167));
+   TUASSERTE(unsigned long, 0x76, uut.asUnsignedLong(161, 7, 1));
+   TUCSM("asUnsignedLong(split)");
+   TUASSERTE(unsigned long, (5UL << 32) | 0xfedcba98UL,
+             uut.asUnsignedLong(0, 3, 69, 32, 1));
+   TUCSM("asUint64_t");
+   TUTHROW(uut.asUnsignedLong(160, 9, 1));
+   TUCSM("addPackedNavBits");
+      // append at an unaligned offset, then compare the two halves
+   PackedNavBits cat;
+   cat.trimsize();
+   cat.addUnsignedLong(1, 1, 1);
+   cat.addPackedNavBits(uut);
+   cat.addPackedNavBits(uut);
+   TUASSERTE(size_t, 337, cat.getNumBits());
+   for (unsigned i = 0; i < 168; i++)
+   {
+      TUASSERTE(bool, uut.asBool(i), cat.asBool(1+i));
+      TUASSERTE(bool, uut.asBool(i), cat.asBool(169+i));
+   }
+   TUCSM("copyBits");
+   PackedNavBits copy(cat);
+   TUASSERTE(bool, true, copy.matchBits(cat));
+   copy.invert();
+   TUASSERTE(bool, false, copy.matchBits(cat, 60, 70));
+   TUASSERT(cat < copy || copy < cat);
+   copy.copyBits(cat, 60, 200);
+   TUASSERTE(bool, true, copy.matchBits(cat, 60, 200));
+   TUASSERTE(bool, false, copy.matchBits(cat, 59, 200));
+   TUASSERTE(bool, false, copy.matchBits(cat, 60, 201));
+   TUASSERTE(unsigned long, 0, copy.asUnsignedLong(0, 1, 1));
+   TUCSM("insertUnsignedLong");
+   copy.insertUnsignedLong(0x1234, 120, 16, 1);
+   TUASSERTE(unsigned long, 0x1234, copy.asUnsignedLong(120, 16, 1));
+   TUASSERTE(bool, true, copy.matchBits(cat, 60, 119));
+   TUASSERTE(bool, true, copy.matchBits(cat, 136, 200));
+   TURETURN();
+}
+
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -981,6 +1049,7 @@ int main()
    errorTotal += testClass.addDataVecByteAlignedTest();
    errorTotal += testClass.overInitialCapacity();
    errorTotal += testClass.addBitVecTest();
+   errorTotal += testClass.wordBoundaryTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -0,0 +1,196 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "Rinex3ObsFileLoader.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gnsstk;
+
+class Rinex3ObsFileLoader_T
+{
+public:
+   Rinex3ObsFileLoader_T();
+
+      /// Check that filtering in the stream doesn't change what is loaded.
+   unsigned filterOnReadTest();
+
+      /** Load a file with the given filtering and return a text
+       * representation of everything that was loaded. */
+   static string load(const string& fn, bool filterOnRead);
+
+   string rinex3File;   ///< RINEX 3 obs test file.
+   string rinex2File;   ///< RINEX 2 obs test file.
+};
+
+
+Rinex3ObsFileLoader_T ::
+Rinex3ObsFileLoader_T()
+{
+   string op = getPathTestTemp() + getFileSep();
+   rinex3File = op + "test_output_Rinex3ObsFileLoader.rnx";
+   rinex2File = op + "test_output_Rinex3ObsFileLoader.06o";
+   ofstream s3(rinex3File.c_str(), ios::out | ios::binary);
+   s3 << "     3.02           OBSERVATION DATA    M (MIXED)           RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT             NONE                    ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "G    6 C1C L1C D1C S1C C2W L2W                              SYS / # / OBS TYPES\n"
+      << "E    2 C1C L1C                                              SYS / # / OBS TYPES\n"
+      << "R    2 C1C L1C                                              SYS / # / OBS TYPES\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << "> 2020 01 01 00 00  0.0000000  0  4      -0.000123456789\n"
+      << "G01  24237168.685 4 109908701.742 9     -1234.500          41.250    24237170.123 4  85643155.101 7\n"
+      << "E03  20576567.763   108127644.59416\n"
+      << "G05  22000001.001    115612345.678 6                                  22000003.125    90087654.321 5\n"
+      << "R07  21000001.001    112345678.901 6\n"
+      << "> 2020 01 01 00 00 30.0000000  4  1\n"
+      << "event comment                                               COMMENT\n"
+      << "> 2020 01 01 00 00 30.0000000  0  3\n"
+      << "E03  20576570.001   108127650.000 7\n"
+      << "G01                 109908710.000      -1235.000          42.000    24237172.456 4  85643160.202 7\n"
+      << "G05  22000011.001    115612395.678 6\n"
+      << "> 2020 01 01 00 01  0.0000000  0  2\n"
+      << "R07  21000011.001    112345728.901 6\n"
+      << "G01  24237175.685 4 109908730.742 9     -1236.500          43.250\n";
+   ofstream s2(rinex2File.c_str(), ios::out | ios::binary);
+   s2 << "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+      << "test                test                20200101 000000 UTC PGM / RUN BY / DATE\n"
+      << "TEST                                                        MARKER NAME\n"
+      << "OBS                 AGENCY                                  OBSERVER / AGENCY\n"
+      << "1                   RCV                 1.0                 REC # / TYPE / VERS\n"
+      << "1                   ANT                                     ANT # / TYPE\n"
+      << "  -740289.8000 -5457071.7000  3207245.6000                  APPROX POSITION XYZ\n"
+      << "        0.0000        0.0000        0.0000                  ANTENNA: DELTA H/E/N\n"
+      << "     1     1                                                WAVELENGTH FACT L1/2\n"
+      << "     4    C1    L1    P2    L2                              # / TYPES OF OBSERV\n"
+      << "  2020     1     1     0     0    0.0000000     GPS         TIME OF FIRST OBS\n"
+      << "                                                            END OF HEADER\n"
+      << " 20  1  1  0  0  0.0000000  0  3G 1G 2G 5\n"
+      << "  24237168.685 4 109908701.742 9  24237170.123 4  85643155.101 7\n"
+      << "  20576567.763   108127644.594    20576569.001    84255221.202  \n"
+      << "  22000001.001    115612345.678 6\n"
+      << " 20  1  1  0  0 30.0000000  0  2G 1G 5\n"
+      << "  24237170.001   109908710.5      24237172.456    85643160.202  \n"
+      << "  22000011.001    115612395.678 6\n";
+}
+
+
+string Rinex3ObsFileLoader_T ::
+load(const string& fn, bool filterOnRead)
+{
+   Rinex3ObsFileLoader rofl(fn);
+   rofl.loadObsID("GC1C");
+   rofl.loadObsID("GL1C");
+   rofl.loadObsID("GC2W");
+   rofl.loadObsID("GL2W");
+   rofl.loadObsID("EL1C");
+   rofl.excludeSat(SatID(5, SatelliteSystem::GPS));
+   rofl.saveTheData(true);
+   rofl.setFilterOnRead(filterOnRead);
+   string errmsg, msg;
+   int iret = rofl.loadFiles(errmsg, msg);
+   ostringstream rv;
+   rv << setprecision(17);
+   rv << iret << " " << errmsg << endl << rofl.asString() << endl;
+   for (const auto& ct : rofl.getWantedSatObsCountMap())
+   {
+      rv << ct.first;
+      for (int count : ct.second)
+         rv << " " << count;
+      rv << endl;
+   }
+   for (const auto& rod : rofl.getStore())
+   {
+      rv << rod.time << " " << rod.epochFlag << " " << rod.numSVs << " "
+         << rod.clockOffset << endl;
+      for (const auto& i : rod.obs)
+      {
+         rv << i.first;
+         for (const auto& d : i.second)
+         {
+            rv << " " << d.data << "," << d.lli << "," << d.ssi;
+         }
+         rv << endl;
+      }
+   }
+   return rv.str();
+}
+
+
+unsigned Rinex3ObsFileLoader_T ::
+filterOnReadTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "setFilterOnRead");
+   string filtered, unfiltered;
+   filtered = load(rinex3File, true);
+   unfiltered = load(rinex3File, false);
+      // make sure something was actually loaded
+   TUASSERT(filtered.find("24237168.68") != string::npos);
+   TUASSERT(filtered.find("E03") != string::npos);
+   TUASSERT(filtered.find("G05") == string::npos);
+   TUASSERTE(string, unfiltered, filtered);
+   filtered = load(rinex2File, true);
+   unfiltered = load(rinex2File, false);
+   TUASSERT(filtered.find("20576567.76") != string::npos);
+   TUASSERT(filtered.find("G05") == string::npos);
+   TUASSERTE(string, unfiltered, filtered);
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsFileLoader_T testClass;
+
+   errorTotal += testClass.filterOnReadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
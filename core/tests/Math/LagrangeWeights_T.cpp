@@ -0,0 +1,192 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <vector>
+#include "LagrangeWeights.hpp"
+#include "MiscMath.hpp"
+#include "TestUtil.hpp"
+
+/// Automated tests for gnsstk::LagrangeWeights
+class LagrangeWeights_T
+{
+public:
+      /// Check parameter checking.
+   unsigned setPointsTest();
+      /// Compare against LagrangeInterpolation.
+   unsigned interpTest();
+      /// Check interpolating at the abscissae.
+   unsigned exactTest();
+      /// Make sure changing inputs recomputes the weights.
+   unsigned cacheTest();
+};
+
+
+unsigned LagrangeWeights_T ::
+setPointsTest()
+{
+   TUDEF("LagrangeWeights", "setPoints");
+   gnsstk::LagrangeWeights uut;
+   double x[gnsstk::LagrangeWeights::maxPoints+1];
+   for (unsigned i = 0; i <= gnsstk::LagrangeWeights::maxPoints; i++)
+   {
+      x[i] = i;
+   }
+   TUASSERTE(unsigned, 0, uut.size());
+   TUTHROW(uut.setPoints(x, 0, 0.5));
+   TUTHROW(uut.setPoints(x, 1, 0.5));
+   TUTHROW(uut.setPoints(x, gnsstk::LagrangeWeights::maxPoints+1, 0.5));
+   TUCATCH(uut.setPoints(x, 2, 0.5));
+   TUASSERTE(unsigned, 2, uut.size());
+   TUASSERTFE(0.5, uut.weight(0));
+   TUASSERTFE(0.5, uut.weight(1));
+   TUCATCH(uut.setPoints(x, gnsstk::LagrangeWeights::maxPoints, 0.5));
+   TUASSERTE(unsigned, gnsstk::LagrangeWeights::maxPoints, uut.size());
+   TURETURN();
+}
+
+
+unsigned LagrangeWeights_T ::
+interpTest()
+{
+   TUDEF("LagrangeWeights", "interp");
+      // 10 samples of a sinusoid 900 seconds apart, like SP3 data
+   const unsigned n = 10;
+   std::vector<double> t(n), y(n);
+   for (unsigned i = 0; i < n; i++)
+   {
+      t[i] = 900.0 * i;
+      y[i] = 26560.0 * std::sin(t[i] / 6800.0 + 0.3);
+   }
+   gnsstk::LagrangeWeights uut;
+   for (double x = 4000.0; x <= 4600.0; x += 37.5)
+   {
+      double expY, expDY, err;
+      uut.setPoints(t.data(), n, x, true);
+      double got = uut.interp(y.data());
+      expY = gnsstk::LagrangeInterpolation(t, y, x, err);
+      TUASSERTFEPS(expY, got, 1e-9);
+      gnsstk::LagrangeInterpolation(t, y, x, expY, expDY);
+      TUASSERTFEPS(expY, got, 1e-9);
+      TUASSERTFEPS(expDY, uut.deriv(y.data()), 1e-12);
+         // the truth
+      TUASSERTFEPS(26560.0 * std::sin(x / 6800.0 + 0.3), got, 1e-6);
+      TUASSERTFEPS(26560.0 / 6800.0 * std::cos(x / 6800.0 + 0.3),
+                   uut.deriv(y.data()), 1e-8);
+   }
+      // Polynomials of degree n-1 are reproduced.
+   for (unsigned i = 0; i < n; i++)
+   {
+      y[i] = 1.0 + 0.5 * t[i] / 900.0 - std::pow(t[i] / 900.0, 3);
+   }
+   uut.setPoints(t.data(), n, 1234.5, true);
+   double u = 1234.5 / 900.0;
+   TUASSERTFEPS(1.0 + 0.5 * u - u*u*u, uut.interp(y.data()), 1e-9);
+   TUASSERTFEPS((0.5 - 3.0*u*u) / 900.0, uut.deriv(y.data()), 1e-12);
+   TURETURN();
+}
+
+
+unsigned LagrangeWeights_T ::
+exactTest()
+{
+   TUDEF("LagrangeWeights", "interp");
+   const unsigned n = 8;
+   double t[n], y[n];
+   for (unsigned i = 0; i < n; i++)
+   {
+      t[i] = 30.0 * i;
+      y[i] = std::exp(t[i] / 100.0);
+   }
+   gnsstk::LagrangeWeights uut;
+   for (unsigned i = 0; i < n; i++)
+   {
+      uut.setPoints(t, n, t[i], true);
+         // exact, not just close.
+      TUASSERTE(double, y[i], uut.interp(y));
+      TUASSERTFEPS(std::exp(t[i] / 100.0) / 100.0, uut.deriv(y), 1e-5);
+   }
+   TURETURN();
+}
+
+
+unsigned LagrangeWeights_T ::
+cacheTest()
+{
+   TUDEF("LagrangeWeights", "setPoints");
+   double t[4] = { 0.0, 1.0, 2.0, 3.0 };
+   double y[4] = { 0.0, 1.0, 4.0, 9.0 };
+   gnsstk::LagrangeWeights uut;
+   uut.setPoints(t, 4, 1.5);
+   TUASSERTFE(2.25, uut.interp(y));
+      // same points, derivative now needed
+   uut.setPoints(t, 4, 1.5, true);
+   TUASSERTFE(3.0, uut.deriv(y));
+      // different x
+   uut.setPoints(t, 4, 2.5, true);
+   TUASSERTFE(6.25, uut.interp(y));
+   TUASSERTFE(5.0, uut.deriv(y));
+      // different abscissae
+   double t2[4] = { 1.0, 2.0, 3.0, 4.0 };
+   double y2[4] = { 1.0, 4.0, 9.0, 16.0 };
+   uut.setPoints(t2, 4, 2.5);
+   TUASSERTFE(6.25, uut.interp(y2));
+      // fewer points
+   uut.setPoints(t2, 3, 2.5);
+   TUASSERTE(unsigned, 3, uut.size());
+   TUASSERTFE(6.25, uut.interp(y2));
+   TURETURN();
+}
+
+
+int main()
+{
+   LagrangeWeights_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.setPointsTest();
+   errorTotal += testClass.interpTest();
+   errorTotal += testClass.exactTest();
+   errorTotal += testClass.cacheTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
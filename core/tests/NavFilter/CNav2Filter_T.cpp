@@ -41,6 +41,7 @@
 #include "CNavFilterData.hpp"
 #include "CNavCrossSourceFilter.hpp"
 #include "CNav2SanityFilter.hpp"
+#include "CRC24Q.hpp"
 #include "CommonTime.hpp"
 #include "GPSWeekSecond.hpp"
 #include "NavFilter.hpp"
@@ -64,6 +65,8 @@ public:
    unsigned noFilterTest();
       /// Test the CNAV-2 sanity filter
    unsigned testCNav2Sanity();
+      /// Test the CRC checks of the CNAV-2 sanity filter
+   unsigned testCNav2CRC();
       /// Test the combination of sanity,and cross-source filters
    unsigned testCNav2Combined();
 
@@ -76,6 +79,22 @@ public:
    list<CNavFilterData> cNavList;
 };
 
+
+   /// Fill in the CRCs of subframes 2 and 3 of a CNAV-2 frame.
+static void setCRC(PackedNavBits* pnb)
+{
+   CRC24Q crc;
+   crc.process(*pnb, CNav2SanityFilter::sf2Start,
+               CNav2SanityFilter::sf2Bits - 24);
+   pnb->insertUnsignedLong(crc.checksum(), CNav2SanityFilter::sf2Start +
+                           CNav2SanityFilter::sf2Bits - 24, 24);
+   crc.reset();
+   crc.process(*pnb, CNav2SanityFilter::sf3Start,
+               CNav2SanityFilter::sf3Bits - 24);
+   pnb->insertUnsignedLong(crc.checksum(), CNav2SanityFilter::sf3Start +
+                           CNav2SanityFilter::sf3Bits - 24, 24);
+}
+
 //-------------------------------------------------------------------
 CNav2Filter_T ::
 CNav2Filter_T()
@@ -100,8 +119,9 @@ CNav2Filter_T ::
 // time.  The following assumputions are made:
 //   1.) Message data are stored one frame to a PackedNavBits message.
 //   2.) The TOI, ITOW, week number, PRN, and page number are generated
-//       via the test algorithm.  The remaining data are zero except where
-//       modified to exercise the change detection.
+//       via the test algorithm.  The CRCs are computed.  The remaining
+//       data are zero except where modified to exercise the change
+//       detection.
 //   3.) The messages cycle through subframe 3 page 1 - subframe 3 page 6.
 //       NOTE:  There is no reason to expect that this will be the
 //       operational pattern.  The goal is to exercise all the
@@ -156,6 +176,7 @@ loadData()
       pnb->addUnsignedLong(zeroes,4,1);
 
       pnb->trimsize();
+      setCRC(pnb);
 
       messageList.push_back(pnb);
 
@@ -234,6 +255,7 @@ testCNav2Sanity()
    PackedNavBits* pnb = p->clone();
    unsigned long wordBad = 0x0000003F;
    pnb->insertUnsignedLong(wordBad,22,8);
+   setCRC(pnb);
    CNavFilterData fd(pnb);
    gnsstk::NavFilter::NavMsgList l = mgr.validate(&fd);
    acceptCount = l.size();
@@ -248,6 +270,7 @@ testCNav2Sanity()
    PackedNavBits* pnb2 = p->clone();
    wordBad = 0x000001FF;
    pnb2->insertUnsignedLong(wordBad,0,9);
+   setCRC(pnb2);
    CNavFilterData fd2(pnb2);
    gnsstk::NavFilter::NavMsgList l2 = mgr.validate(&fd2);
    acceptCount = l2.size();
@@ -262,6 +285,7 @@ testCNav2Sanity()
    PackedNavBits* pnb3 = p->clone();
    wordBad = 0x000007CF;
    pnb3->insertUnsignedLong(wordBad,9,13);
+   setCRC(pnb3);
    CNavFilterData fd3(pnb3);
    gnsstk::NavFilter::NavMsgList l3 = mgr.validate(&fd3);
    acceptCount = l3.size();
@@ -275,6 +299,7 @@ testCNav2Sanity()
    wordBad = 0x00000000;
    unsigned long bitOffset = 609;
    pnb4->insertUnsignedLong(wordBad,bitOffset,8);
+   setCRC(pnb4);
    CNavFilterData fd4(pnb4);
    gnsstk::NavFilter::NavMsgList l4 = mgr.validate(&fd4);
    acceptCount = l4.size();
@@ -287,6 +312,7 @@ testCNav2Sanity()
    PackedNavBits* pnb5 = p->clone();
    bitOffset = 609 + 8;
    pnb5->insertUnsignedLong(wordBad,bitOffset,6);
+   setCRC(pnb5);
    CNavFilterData fd5(pnb5);
    gnsstk::NavFilter::NavMsgList l5 = mgr.validate(&fd5);
    acceptCount = l5.size();
@@ -298,6 +324,43 @@ testCNav2Sanity()
    TURETURN();
 }
 
+//-------------------------------------------------------------------
+unsigned CNav2Filter_T ::
+testCNav2CRC()
+{
+   TUDEF("CNav2SanityFilter", "validate");
+
+   NavFilterMgr mgr;
+   CNav2SanityFilter filtSanity;
+   mgr.addFilter(&filtSanity);
+   PackedNavBits* p = messageList.front();
+
+      // A single bit error in the data or the CRC of either
+      // subframe is rejected.
+   unsigned bits[] = { 9, 300, 584, 585, 608, 609, 800, 858, 859, 882 };
+   for (unsigned bit : bits)
+   {
+      PackedNavBits* pnb = p->clone();
+      pnb->insertUnsignedLong(pnb->asBool(bit) ? 0 : 1, bit, 1);
+      CNavFilterData fd(pnb);
+      gnsstk::NavFilter::NavMsgList l = mgr.validate(&fd);
+      TUASSERTE(unsigned long, 0, l.size());
+      TUASSERTE(unsigned long, 1, filtSanity.rejected.size());
+      delete pnb;
+   }
+
+      // A truncated frame is rejected.
+   PackedNavBits* pnb = p->clone();
+   pnb->reset_num_bits(CNav2SanityFilter::sf3Start);
+   CNavFilterData fd(pnb);
+   gnsstk::NavFilter::NavMsgList l = mgr.validate(&fd);
+   TUASSERTE(unsigned long, 0, l.size());
+   TUASSERTE(unsigned long, 1, filtSanity.rejected.size());
+   delete pnb;
+
+   TURETURN();
+}
+
 /*
 //-------------------------------------------------------------------
 unsigned CNav2Filter_T ::
@@ -410,6 +473,7 @@ int main()
 
    errorTotal += testClass.loadData();
    errorTotal += testClass.testCNav2Sanity();
+   errorTotal += testClass.testCNav2CRC();
    errorTotal += testClass.testCNav2Combined();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
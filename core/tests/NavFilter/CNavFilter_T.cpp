@@ -75,6 +75,8 @@ public:
    unsigned testCNavTOW();
       /// Test the combination of parity, empty and TOW filters
    unsigned testCNavCombined();
+      /// Test the combined filters using validateBatch
+   unsigned testCNavCombinedBatch();
       /// Test the combination of cook,parity, empty, TOW, and cross-source filters
    unsigned testCNavCrossSource();
 
@@ -549,6 +551,63 @@ testCNavCombined()
    TURETURN();
 }
 
+//-------------------------------------------------------------------
+unsigned CNavFilter_T ::
+testCNavCombinedBatch()
+{
+   TUDEF("CNavFilter-Combined", "validateBatch");
+
+   NavFilterMgr mgr;
+   CNavParityFilter filtParity;
+   CNavEmptyFilter filtEmpty;
+   CNavTOWFilter filtTOW;
+
+   mgr.addFilter(&filtParity);
+   mgr.addFilter(&filtEmpty);
+   mgr.addFilter(&filtTOW);
+
+      // A message with a bad CRC to mix in with the good ones.
+   PackedNavBits* pnb = messageList.front()->clone();
+   pnb->insertUnsignedLong(0,276,24);
+   CNavFilterData fdBad(pnb);
+
+   std::vector<NavFilterKey*> batch;
+   unsigned long acceptCount = 0;
+   unsigned long rejectCount = 0;
+   list<CNavFilterData>::iterator it = cNavList.begin();
+   while (it != cNavList.end())
+   {
+      batch.clear();
+      for (unsigned i = 0; (i < 7) && (it != cNavList.end()); i++, it++)
+      {
+         batch.push_back(&(*it));
+      }
+      batch.push_back(&fdBad);
+      const NavFilter::NavMsgList& l = mgr.validateBatch(batch);
+         // The good messages pass, in order.
+      TUASSERTE(size_t, batch.size()-1, l.size());
+      TUASSERT(std::equal(l.begin(), l.end(), batch.begin()));
+         // The bad one is reported by the parity filter only.
+      TUASSERTE(size_t, 1, mgr.rejected.size());
+      TUASSERTE(size_t, 1, mgr.rejected.count(&filtParity));
+      TUASSERTE(size_t, 1, filtParity.rejected.size());
+      TUASSERTE(NavFilterKey*, &fdBad, filtParity.rejected.front());
+      acceptCount += l.size();
+      rejectCount += filtParity.rejected.size();
+   }
+   TUASSERTE(unsigned long, cNavList.size(), acceptCount);
+      // The single-message interface still works after batches.
+   NavFilter::NavMsgList l = mgr.validate(&fdBad);
+   TUASSERTE(size_t, 0, l.size());
+   TUASSERTE(size_t, 1, filtParity.rejected.size());
+   l = mgr.validate(&cNavList.front());
+   TUASSERTE(size_t, 1, l.size());
+   TUASSERTE(size_t, 0, filtParity.rejected.size());
+   TUASSERTE(size_t, 0, mgr.rejected.size());
+   delete pnb;
+   TURETURN();
+}
+
 //-------------------------------------------------------------------
 unsigned CNavFilter_T ::
 testCNavCrossSource()
@@ -796,6 +855,7 @@ int main()
    errorTotal += testClass.testCNavEmpty();
    errorTotal += testClass.testCNavTOW();
    errorTotal += testClass.testCNavCombined();
+   errorTotal += testClass.testCNavCombinedBatch();
    errorTotal += testClass.testCNavCrossSource();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
@@ -0,0 +1,528 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <algorithm>
+#include <sstream>
+#include "LazyNavDataFactory.hpp"
+#include "RinexNavDataFactory.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "NewNavToRinex.hpp"
+#include "FileSpec.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+#include "build_config.h"
+
+/// Automated tests for gnsstk::LazyNavDataFactory
+class LazyNavDataFactory_T
+{
+public:
+   LazyNavDataFactory_T();
+      /// Make sure invalid factories are rejected.
+   unsigned constructorTest();
+      /// Make sure only the files needed for a search are loaded.
+   unsigned loadTest();
+      /** Make sure searches give the same results as a factory with
+       * all of the files loaded. */
+   unsigned findTest();
+      /// Make sure the memory budget is enforced.
+   unsigned evictTest();
+      /// Make sure edits survive eviction of other files.
+   unsigned editTest();
+      /// Make sure nothing is loaded or evicted while frozen.
+   unsigned frozenTest();
+      /// Test explicit loading with preload().
+   unsigned preloadTest();
+
+      /** Write a RINEX nav file for each of numDays days, named
+       * according to spec. */
+   void writeFiles();
+      /// Create a factory with the given days loaded.
+   std::shared_ptr<gnsstk::RinexNavDataFactory>
+   eagerLoad(unsigned firstDay, unsigned lastDay);
+      /// Create a lazy factory for the files written by writeFiles().
+   std::shared_ptr<gnsstk::LazyNavDataFactory> makeLazy();
+      /** Dump the results of searches over the satellites in synth
+       * for times from firstDay to the end of lastDay. */
+   std::string dumpFinds(gnsstk::NavDataFactory& fact, unsigned firstDay,
+                         unsigned lastDay, gnsstk::NavSearchOrder order);
+      /// Sort a list of paths and join them into one string.
+   static std::string sorted(std::vector<std::string> files);
+
+   static const unsigned numDays = 5;
+   SyntheticNavData synth;
+      /// Midnight at the start of the first day of data.
+   gnsstk::CommonTime day0;
+      /// FileSpec of the test files.
+   std::string spec;
+      /// Path of the file for each day.
+   std::vector<std::string> files;
+};
+
+
+LazyNavDataFactory_T ::
+LazyNavDataFactory_T()
+      : day0(gnsstk::GPSWeekSecond(2101, 0.0)),
+        spec(gnsstk::getPathTestTemp() + gnsstk::getFileSep() +
+             "LazyNavDataFactory_T_%04Y%03j.rnx")
+{
+   writeFiles();
+}
+
+
+void LazyNavDataFactory_T ::
+writeFiles()
+{
+   gnsstk::FileSpec fs(spec);
+   for (unsigned day = 0; day < numDays; day++)
+   {
+      gnsstk::NavDataPtrList navList;
+      for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+      {
+         for (unsigned i = 0; i < 12; i++)
+         {
+            gnsstk::CommonTime toe(day0 + 86400.0 * day + 7200.0 * i);
+            navList.push_back(synth.makeEph(prn, toe));
+         }
+      }
+      gnsstk::NewNavToRinex writer;
+      gnsstk::HealthGetter healthGet;
+      writer.header.version = 3.04;
+      writer.header.fileType = "N: GNSS NAV DATA";
+      writer.header.setFileSystem("G");
+      writer.header.fileProgram = "gnsstk test";
+      writer.header.fileAgency = "gnsstk";
+      writer.header.valid = gnsstk::Rinex3NavHeader::validVersion |
+         gnsstk::Rinex3NavHeader::validRunBy |
+         gnsstk::Rinex3NavHeader::validEoH;
+      writer.translate(navList, healthGet);
+      std::string fn = fs.toString(day0 + 86400.0 * day);
+      writer.write(fn);
+      files.push_back(fn);
+   }
+}
+
+
+std::shared_ptr<gnsstk::RinexNavDataFactory> LazyNavDataFactory_T ::
+eagerLoad(unsigned firstDay, unsigned lastDay)
+{
+   std::shared_ptr<gnsstk::RinexNavDataFactory> rv =
+      std::make_shared<gnsstk::RinexNavDataFactory>();
+   for (unsigned day = firstDay; day <= lastDay; day++)
+   {
+      rv->addDataSource(files[day]);
+   }
+   return rv;
+}
+
+
+std::shared_ptr<gnsstk::LazyNavDataFactory> LazyNavDataFactory_T ::
+makeLazy()
+{
+   return std::make_shared<gnsstk::LazyNavDataFactory>(
+      std::make_shared<gnsstk::RinexNavDataFactory>(), spec);
+}
+
+
+std::string LazyNavDataFactory_T ::
+dumpFinds(gnsstk::NavDataFactory& fact, unsigned firstDay, unsigned lastDay,
+          gnsstk::NavSearchOrder order)
+{
+   std::ostringstream s;
+   gnsstk::NavDataPtr ndp;
+   gnsstk::CommonTime end(day0 + 86400.0 * (lastDay+1));
+   for (gnsstk::CommonTime when = day0 + 86400.0 * firstDay; when < end;
+        when += 1800.0)
+   {
+      for (const auto& sat : synth.sats)
+      {
+         gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+         if (fact.find(nmid, when, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly, order))
+         {
+            ndp->dump(s, gnsstk::DumpDetail::Full);
+         }
+         else
+         {
+            s << "not found " << sat << " " << when << std::endl;
+         }
+      }
+   }
+   return s.str();
+}
+
+
+std::string LazyNavDataFactory_T ::
+sorted(std::vector<std::string> files)
+{
+   std::sort(files.begin(), files.end());
+   std::string rv;
+   for (const auto& fn : files)
+   {
+      rv += fn + "\n";
+   }
+   return rv;
+}
+
+
+unsigned LazyNavDataFactory_T ::
+constructorTest()
+{
+   TUDEF("LazyNavDataFactory", "LazyNavDataFactory");
+   TUTHROW(gnsstk::LazyNavDataFactory(nullptr, spec));
+   TUTHROW(gnsstk::LazyNavDataFactory(
+              std::make_shared<gnsstk::MultiFormatNavDataFactory>(), spec));
+   std::shared_ptr<gnsstk::RinexNavDataFactory> rin =
+      std::make_shared<gnsstk::RinexNavDataFactory>();
+   gnsstk::LazyNavDataFactory uut(rin, spec);
+   TUASSERT(rin->supportedSignals == uut.supportedSignals);
+   TUASSERTE(std::string, rin->getFactoryFormats(), uut.getFactoryFormats());
+   TUASSERTE(std::string, spec, uut.getFileSpec());
+   TUASSERTFE(86400.0, uut.getFileSpan());
+   TUASSERTFE(86400.0, uut.getLookBehind());
+   TUASSERTFE(86400.0, uut.getLookAhead());
+   TUASSERTE(size_t, 0, uut.getMaxBytes());
+   TUASSERTE(size_t, 0, uut.getCacheBytes());
+   TUASSERTE(unsigned long, 0, uut.getLoadCount());
+   TUASSERT(uut.getFactory() == rin);
+   TUTHROW(uut.setFileSpan(0));
+   uut.setFileSpan(3600.0);
+   TUASSERTFE(3600.0, uut.getFileSpan());
+   TUASSERTFE(3600.0, uut.getLookBehind());
+   TUASSERTFE(3600.0, uut.getLookAhead());
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+loadTest()
+{
+   TUDEF("LazyNavDataFactory", "find");
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+   gnsstk::NavMessageID nmid(synth.sats[0],
+                             gnsstk::NavMessageType::Ephemeris);
+   gnsstk::NavDataPtr ndp;
+   TUASSERT(uut->getLoadedFiles().empty());
+      // Searching day 2 loads days 1 through 3.
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*2 + 43200.0, ndp,
+                       gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   std::vector<std::string> exp{files[1], files[2], files[3]};
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+   TUASSERTE(unsigned long, 3, uut->getLoadCount());
+   TUASSERT(uut->getCacheBytes() > 0);
+   TUASSERTE(size_t, eagerLoad(1,3)->size(), uut->getFactory()->size());
+      // More searches in the same window don't load anything.
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*2 + 100.0, ndp,
+                       gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, 3, uut->getLoadCount());
+      // The next day only needs one more file.
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*3, ndp,
+                       gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, 4, uut->getLoadCount());
+   exp.push_back(files[4]);
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+      // Most recently used first.
+   TUASSERTE(std::string, files[4], uut->getLoadedFiles().front());
+      // Going back doesn't reload anything.
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*2, ndp,
+                       gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, 4, uut->getLoadCount());
+   TUASSERTE(size_t, eagerLoad(1,4)->size(), uut->getFactory()->size());
+      // Nothing before the archive.
+   TUASSERTE(bool, false,
+             uut->find(nmid, day0 - 86400.0*3, ndp,
+                       gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, 4, uut->getLoadCount());
+      // Files that aren't in the archive can be added directly.
+   TUASSERTE(bool, false, uut->addDataSource(spec + ".missing"));
+   TUASSERTE(unsigned long, 5, uut->getLoadCount());
+   uut->clear();
+   TUASSERT(uut->getLoadedFiles().empty());
+   TUASSERTE(size_t, 0, uut->getCacheBytes());
+   TUASSERTE(size_t, 0, uut->getFactory()->size());
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+findTest()
+{
+   TUDEF("LazyNavDataFactory", "find");
+   std::shared_ptr<gnsstk::RinexNavDataFactory> eager(
+      eagerLoad(0, numDays-1));
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+   TUASSERTE(std::string,
+             dumpFinds(*eager, 1, numDays-1, gnsstk::NavSearchOrder::User),
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   uut = makeLazy();
+   TUASSERTE(std::string,
+             dumpFinds(*eager, 1, numDays-1, gnsstk::NavSearchOrder::Nearest),
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::Nearest));
+      // Searches with the index built.
+   uut = makeLazy();
+   uut->compact();
+   eager->compact();
+   TUASSERTE(std::string,
+             dumpFinds(*eager, 1, numDays-1, gnsstk::NavSearchOrder::User),
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   TUASSERTE(bool, true, uut->getFactory()->isCompact());
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+evictTest()
+{
+   TUDEF("LazyNavDataFactory", "setMaxBytes");
+   std::shared_ptr<gnsstk::RinexNavDataFactory> eager(
+      eagerLoad(0, numDays-1));
+   std::string expUser = dumpFinds(*eager, 1, numDays-1,
+                                   gnsstk::NavSearchOrder::User);
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+      // A budget too small for anything keeps only the current window.
+   uut->setMaxBytes(1);
+   TUASSERTE(size_t, 1, uut->getMaxBytes());
+   TUASSERTE(std::string, expUser,
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   std::vector<std::string> exp{files[numDays-2], files[numDays-1]};
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+   TUASSERTE(size_t, eagerLoad(numDays-2,numDays-1)->size(),
+             uut->getFactory()->size());
+   TUASSERTE(unsigned long, numDays, uut->getLoadCount());
+      // Going back has to reload the evicted files.
+   TUASSERTE(std::string, dumpFinds(*eager, 1, 1, gnsstk::NavSearchOrder::User),
+             dumpFinds(*uut, 1, 1, gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, numDays+3, uut->getLoadCount());
+   size_t fileBytes = uut->getCacheBytes() / 3;
+      // Room for three files.
+   uut = makeLazy();
+   uut->setMaxBytes(fileBytes * 3);
+   TUASSERTE(std::string, expUser,
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   TUASSERT(uut->getCacheBytes() <= fileBytes * 3);
+   exp.insert(exp.begin(), files[numDays-3]);
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+   TUASSERTE(size_t, eagerLoad(numDays-3,numDays-1)->size(),
+             uut->getFactory()->size());
+      // Reducing the budget evicts immediately.
+   uut->setMaxBytes(1);
+   exp.erase(exp.begin());
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+      // Files loaded with addDataSource() are never evicted.
+   uut = makeLazy();
+   uut->setMaxBytes(1);
+   TUASSERTE(bool, true, uut->addDataSource(files[0]));
+   TUASSERTE(std::string, expUser,
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   exp.insert(exp.begin(), files[0]);
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+      // Unlimited again.
+   uut->setMaxBytes(0);
+   TUASSERTE(std::string, expUser,
+             dumpFinds(*uut, 1, numDays-1, gnsstk::NavSearchOrder::User));
+   TUASSERTE(std::string, sorted(files), sorted(uut->getLoadedFiles()));
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+editTest()
+{
+   TUDEF("LazyNavDataFactory", "edit");
+   gnsstk::CommonTime from(day0 + 86400.0 * 2 + 10000.0),
+      to(day0 + 86400.0 * 2 + 30000.0);
+   std::shared_ptr<gnsstk::RinexNavDataFactory> eager(eagerLoad(2, 4));
+   eager->edit(from, to);
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+   gnsstk::NavMessageID nmid(synth.sats[0],
+                             gnsstk::NavMessageType::Ephemeris);
+   gnsstk::NavDataPtr ndp;
+   uut->find(nmid, day0 + 86400.0*2, ndp, gnsstk::SVHealth::Any,
+             gnsstk::NavValidityType::ValidOnly,
+             gnsstk::NavSearchOrder::User);
+   size_t before = uut->getFactory()->size();
+   uut->edit(from, to);
+   TUASSERT(uut->getFactory()->size() < before);
+   uut->find(nmid, day0 + 86400.0*4, ndp, gnsstk::SVHealth::Any,
+             gnsstk::NavValidityType::ValidOnly,
+             gnsstk::NavSearchOrder::User);
+      // Evict only day 1, rebuilding the store from the cached
+      // contents of days 2 through 4.
+   uut->setMaxBytes(uut->getCacheBytes() - uut->getCacheBytes() / 4);
+   std::vector<std::string> exp{files[2], files[3], files[4]};
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+   TUASSERTE(size_t, eager->size(), uut->getFactory()->size());
+      // The store edits the user time map by user time and the
+      // nearest map by time stamp, so an edit starting between the
+      // two removes a record from one map and not the other, which
+      // must still be the case after the store is rebuilt.
+   eager = eagerLoad(1, 4);
+   uut = makeLazy();
+   gnsstk::CommonTime mid(day0 + 86400.0*2 + 43200.0);
+   TUASSERT(eager->find(nmid, mid, ndp, gnsstk::SVHealth::Any,
+                        gnsstk::NavValidityType::ValidOnly,
+                        gnsstk::NavSearchOrder::User));
+   TUASSERT(ndp->timeStamp < ndp->getUserTime());
+   from = ndp->timeStamp + (ndp->getUserTime() - ndp->timeStamp) / 2.0;
+   to = from + 3600.0;
+   uut->find(nmid, mid, ndp, gnsstk::SVHealth::Any,
+             gnsstk::NavValidityType::ValidOnly,
+             gnsstk::NavSearchOrder::User);
+   eager->edit(from, to);
+   uut->edit(from, to);
+   uut->find(nmid, day0 + 86400.0*4, ndp, gnsstk::SVHealth::Any,
+             gnsstk::NavValidityType::ValidOnly,
+             gnsstk::NavSearchOrder::User);
+   uut->setMaxBytes(uut->getCacheBytes() - uut->getCacheBytes() / 4);
+   TUASSERTE(std::string, sorted(exp), sorted(uut->getLoadedFiles()));
+      // Search the wrapped factory directly to avoid loading more.
+   for (auto order : {gnsstk::NavSearchOrder::User,
+                      gnsstk::NavSearchOrder::Nearest})
+   {
+      for (gnsstk::CommonTime when = from - 7200.0; when < to + 7200.0;
+           when += 300.0)
+      {
+         gnsstk::NavDataPtr expNDP, gotNDP;
+         bool expOK = eager->find(nmid, when, expNDP, gnsstk::SVHealth::Any,
+                                  gnsstk::NavValidityType::ValidOnly, order);
+         bool gotOK = uut->getFactory()->find(
+            nmid, when, gotNDP, gnsstk::SVHealth::Any,
+            gnsstk::NavValidityType::ValidOnly, order);
+         TUASSERTE(bool, expOK, gotOK);
+         if (expOK && gotOK)
+         {
+            TUASSERTE(gnsstk::CommonTime, expNDP->timeStamp,
+                      gotNDP->timeStamp);
+         }
+      }
+   }
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+preloadTest()
+{
+   TUDEF("LazyNavDataFactory", "preload");
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+   TUASSERTE(bool, true, uut->preload(day0 + 86400.0 + 3600.0,
+                                      day0 + 86400.0*3 + 3600.0));
+   TUASSERTE(std::string, sorted(files), sorted(uut->getLoadedFiles()));
+   unsigned long loads = uut->getLoadCount();
+      // Searching the preloaded span while frozen finds the data
+      // without loading anything.
+   uut->freeze();
+   TUASSERTE(bool, false, uut->preload(day0, day0 + 86400.0));
+   gnsstk::NavMessageID nmid(synth.sats[0],
+                             gnsstk::NavMessageType::Ephemeris);
+   gnsstk::NavDataPtr ndp;
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*2, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, loads, uut->getLoadCount());
+   TURETURN();
+}
+
+
+unsigned LazyNavDataFactory_T ::
+frozenTest()
+{
+   TUDEF("LazyNavDataFactory", "freeze");
+   std::shared_ptr<gnsstk::LazyNavDataFactory> uut(makeLazy());
+   gnsstk::NavMessageID nmid(synth.sats[0],
+                             gnsstk::NavMessageType::Ephemeris);
+   gnsstk::NavDataPtr ndp;
+   gnsstk::CommonTime later(day0 + 86400.0*4 + 43200.0);
+   TUASSERTE(bool, true,
+             uut->find(nmid, day0 + 86400.0*2, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   uut->freeze();
+   TUASSERTE(bool, true, uut->isFrozen());
+   TUASSERTE(bool, true, uut->getFactory()->isFrozen());
+   TUASSERTE(bool, false,
+             uut->find(nmid, later, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(bool, false, uut->addDataSource(files[4]));
+   uut->setMaxBytes(1);
+   TUASSERTE(unsigned long, 3, uut->getLoadCount());
+   TUASSERTE(size_t, 3, uut->getLoadedFiles().size());
+   uut->thaw();
+   TUASSERTE(bool, true,
+             uut->find(nmid, later, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User));
+   TUASSERTE(unsigned long, 4, uut->getLoadCount());
+   TUASSERTE(size_t, 2, uut->getLoadedFiles().size());
+   TURETURN();
+}
+
+
+int main()
+{
+   LazyNavDataFactory_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.constructorTest();
+   errorTotal += testClass.loadTest();
+   errorTotal += testClass.findTest();
+   errorTotal += testClass.evictTest();
+   errorTotal += testClass.editTest();
+   errorTotal += testClass.preloadTest();
+   errorTotal += testClass.frozenTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
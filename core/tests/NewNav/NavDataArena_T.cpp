@@ -0,0 +1,292 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "NavDataArena.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+
+/// Record that counts how many instances exist.
+class CountedNavData : public gnsstk::GPSLNavHealth
+{
+public:
+   CountedNavData(bool fail = false)
+   {
+      if (fail)
+      {
+         throw std::runtime_error("constructor failed");
+      }
+      live++;
+   }
+   ~CountedNavData()
+   {
+      live--;
+   }
+   static int live;
+};
+
+int CountedNavData::live = 0;
+
+
+class NavDataArena_T : public SyntheticNavData
+{
+public:
+      /// Test the chunk management of create.
+   unsigned createTest();
+      /// Test makeNavData and NavDataArena::Use.
+   unsigned makeNavDataTest();
+      /// Test a store whose data is allocated from its arena.
+   unsigned storeTest();
+      /// Test findRecord compared with find.
+   unsigned findRecordTest();
+};
+
+
+unsigned NavDataArena_T ::
+createTest()
+{
+   TUDEF("NavDataArena", "create");
+   gnsstk::NavDataArenaPtr uut = std::make_shared<gnsstk::NavDataArena>(4096);
+   TUASSERTE(size_t, 0, uut->numChunks());
+   TUASSERTE(size_t, 0, uut->capacity());
+   std::vector<std::shared_ptr<CountedNavData> > recs;
+   for (unsigned i = 0; i < 40; i++)
+   {
+      recs.push_back(uut->create<CountedNavData>());
+      TUASSERTE(uintptr_t, 0,
+                ((uintptr_t)recs.back().get()) % alignof(std::max_align_t));
+      recs.back()->svHealth = i;
+   }
+   TUASSERTE(int, 40, CountedNavData::live);
+      // 40 records won't fit in one 4k chunk
+   TUASSERT(uut->numChunks() > 1);
+   TUASSERTE(size_t, uut->numChunks() * 4096, uut->capacity());
+   for (unsigned i = 0; i < recs.size(); i++)
+   {
+      TUASSERTE(unsigned, i, recs[i]->svHealth);
+   }
+      // Records share the reference count of their chunk, so
+      // releasing one doesn't destroy anything.
+   size_t chunks = uut->numChunks();
+   recs[0].reset();
+   TUASSERTE(int, 40, CountedNavData::live);
+      // Releasing all but the last record frees all but the last
+      // chunk, destroying the records in them.
+   for (unsigned i = 1; i < recs.size()-1; i++)
+   {
+      recs[i].reset();
+   }
+   TUASSERTE(size_t, 1, uut->numChunks());
+   TUASSERT(CountedNavData::live < 40);
+   TUASSERT(CountedNavData::live > 0);
+      // Records may outlive the arena.
+   uut.reset();
+   TUASSERT(CountedNavData::live > 0);
+   TUASSERTE(unsigned, 39, recs.back()->svHealth);
+   recs.clear();
+   TUASSERTE(int, 0, CountedNavData::live);
+      // A record whose constructor throws is not destroyed.
+   uut = std::make_shared<gnsstk::NavDataArena>(4096);
+   std::shared_ptr<CountedNavData> ok = uut->create<CountedNavData>();
+   TUTHROW(uut->create<CountedNavData>(true));
+   TUASSERTE(int, 1, CountedNavData::live);
+      // Records bigger than a chunk get a chunk to themselves.
+   std::shared_ptr<gnsstk::GPSLNavEph> big =
+      std::make_shared<gnsstk::NavDataArena>(64)->create<gnsstk::GPSLNavEph>();
+   big->timeStamp = t0;
+   TUASSERTE(gnsstk::CommonTime, t0, big->timeStamp);
+   uut.reset();
+   ok.reset();
+   TUASSERTE(int, 0, CountedNavData::live);
+   TURETURN();
+}
+
+
+unsigned NavDataArena_T ::
+makeNavDataTest()
+{
+   TUDEF("NavDataArena", "makeNavData");
+   gnsstk::NavDataArenaPtr arena = std::make_shared<gnsstk::NavDataArena>();
+   gnsstk::NavDataArenaPtr arena2 = std::make_shared<gnsstk::NavDataArena>();
+   TUASSERT(!gnsstk::NavDataArena::current());
+      // no arena, regular allocation
+   gnsstk::NavDataPtr heap = gnsstk::makeNavData<gnsstk::GPSLNavEph>();
+   TUASSERT(heap != nullptr);
+   TUASSERTE(size_t, 0, arena->capacity());
+   gnsstk::NavDataPtr fromArena, fromArena2, fromNone;
+   {
+      gnsstk::NavDataArena::Use use(arena);
+      TUASSERT(gnsstk::NavDataArena::current() == arena);
+      fromArena = gnsstk::makeNavData<gnsstk::GPSLNavEph>();
+      TUASSERTE(size_t, 1, arena->numChunks());
+      {
+         gnsstk::NavDataArena::Use use2(arena2);
+         fromArena2 = gnsstk::makeNavData<gnsstk::GPSLNavHealth>();
+         gnsstk::NavDataArena::Use use3(nullptr);
+         fromNone = gnsstk::makeNavData<gnsstk::GPSLNavHealth>();
+      }
+      TUASSERT(gnsstk::NavDataArena::current() == arena);
+   }
+   TUASSERT(!gnsstk::NavDataArena::current());
+   TUASSERTE(size_t, 1, arena->numChunks());
+   TUASSERTE(size_t, 1, arena2->numChunks());
+      // the chunk lives as long as the records allocated from it
+   arena.reset();
+   fromArena->timeStamp = t0;
+   TUASSERTE(gnsstk::CommonTime, t0, fromArena->timeStamp);
+   fromArena.reset();
+      // copies made by clone() are regular allocations
+   gnsstk::NavDataPtr cloned = fromArena2->clone();
+   fromArena2.reset();
+   TUASSERT(cloned != nullptr);
+   TURETURN();
+}
+
+
+unsigned NavDataArena_T ::
+storeTest()
+{
+   TUDEF("NavDataFactoryWithStore", "setUseArena");
+   SyntheticNavFactory fact, plain;
+   TUASSERT(!fact.getArena());
+   fact.setUseArena(true);
+   gnsstk::NavDataArenaPtr arena = fact.getArena();
+   TUASSERT(arena != nullptr);
+   fact.setUseArena(true);
+   TUASSERT(fact.getArena() == arena);
+   {
+      gnsstk::NavDataArena::Use use(fact.getArena());
+      fill(fact);
+   }
+   fill(plain);
+   TUASSERT(arena->numChunks() > 0);
+   TUASSERTE(size_t, plain.size(), fact.size());
+   fact.compact();
+   plain.compact();
+   for (const auto& sat : sats)
+   {
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+      for (const auto& when : times)
+      {
+         gnsstk::NavDataPtr exp, got;
+         bool expOK = plain.find(nmid, when, exp, gnsstk::SVHealth::Healthy,
+                                 gnsstk::NavValidityType::ValidOnly,
+                                 gnsstk::NavSearchOrder::User);
+         bool gotOK = fact.find(nmid, when, got, gnsstk::SVHealth::Healthy,
+                                gnsstk::NavValidityType::ValidOnly,
+                                gnsstk::NavSearchOrder::User);
+         TUASSERTE(bool, expOK, gotOK);
+         if (expOK && gotOK)
+         {
+            TUASSERTE(gnsstk::CommonTime, exp->timeStamp, got->timeStamp);
+            TUASSERTE(gnsstk::NavMessageID, exp->signal, got->signal);
+         }
+      }
+   }
+      // removing the data for all but one of the satellites, which were
+      // loaded one after the other, releases whole chunks
+   size_t chunks = arena->numChunks();
+   for (unsigned long prn = 1; prn < numPRN; prn++)
+   {
+      fact.edit(gnsstk::CommonTime::BEGINNING_OF_TIME,
+                gnsstk::CommonTime::END_OF_TIME, sats[prn-1]);
+   }
+   TUASSERTE(size_t, plain.size() / numPRN, fact.size());
+   TUASSERT(arena->numChunks() < chunks);
+      // clearing the store releases everything but the active chunk
+   fact.clear();
+   TUASSERTE(size_t, 1, arena->numChunks());
+   fact.setUseArena(false);
+   TUASSERT(!fact.getArena());
+   TURETURN();
+}
+
+
+unsigned NavDataArena_T ::
+findRecordTest()
+{
+   TUDEF("NavDataFactoryWithStore", "findRecord");
+   SyntheticNavFactory fact;
+   fact.setUseArena(true);
+   {
+      gnsstk::NavDataArena::Use use(fact.getArena());
+      fill(fact, true);
+   }
+   for (bool compact : {false, true})
+   {
+      if (compact)
+      {
+         fact.compact();
+      }
+      for (const auto& sat : sats)
+      {
+         gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+         gnsstk::NavFindCursor cursor, recCursor;
+         for (const auto& when : times)
+         {
+            gnsstk::NavDataPtr exp;
+            bool expOK = fact.find(nmid, when, exp, gnsstk::SVHealth::Any,
+                                   gnsstk::NavValidityType::ValidOnly,
+                                   cursor);
+            const gnsstk::NavData *got = fact.findRecord(
+               nmid, when, gnsstk::SVHealth::Any,
+               gnsstk::NavValidityType::ValidOnly, recCursor);
+            TUASSERTE(bool, expOK, got != nullptr);
+               // the stored record itself is returned
+            TUASSERT(got == exp.get());
+         }
+      }
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   NavDataArena_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.createTest();
+   errorTotal += testClass.makeNavDataTest();
+   errorTotal += testClass.storeTest();
+   errorTotal += testClass.findRecordTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
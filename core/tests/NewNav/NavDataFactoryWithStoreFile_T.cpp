@@ -0,0 +1,530 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include "RinexNavDataFactory.hpp"
+#include "SP3NavDataFactory.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "NewNavToRinex.hpp"
+#include "SP3Stream.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+#include "build_config.h"
+
+   /** Implement a test class to expose protected members rather than
+    * using friends. */
+class TestClass : public gnsstk::RinexNavDataFactory
+{
+public:
+      /// Grant access to protected data.
+   gnsstk::NavMessageMap& getData()
+   { return data; }
+};
+
+
+   /// Expose the protected members of SP3NavDataFactory.
+class SP3TestClass : public gnsstk::SP3NavDataFactory
+{
+public:
+      /// Grant access to protected data.
+   gnsstk::NavMessageMap& getData()
+   { return data; }
+};
+
+
+   /** A signal that sorts before any real one, so that
+    * MultiFormatNavDataFactory tries factories supporting it first. */
+static const gnsstk::NavSignalID firstSignal(
+   gnsstk::SatelliteSystem::Unknown, gnsstk::CarrierBand::Unknown,
+   gnsstk::TrackingCode::Unknown, gnsstk::NavType::Unknown);
+
+
+   /** SP3 factory that records the threads it reads files on, to be
+    * tried first by MultiFormatNavDataFactory. */
+class SP3Recorder : public SP3TestClass
+{
+public:
+   SP3Recorder()
+   {
+      supportedSignals.clear();
+      supportedSignals.insert(firstSignal);
+   }
+   bool readSource(const std::string& source, SourceDataPtr& srcData)
+      override
+   {
+      {
+         std::lock_guard<std::mutex> lock(threadMutex);
+         threads.insert(std::this_thread::get_id());
+      }
+      return SP3NavDataFactory::readSource(source, srcData);
+   }
+   std::mutex threadMutex;
+      /// The threads that readSource() was called from.
+   std::set<std::thread::id> threads;
+};
+
+
+   /** RINEX factory that can't read files in parallel and records
+    * the threads it loads files on, to be tried first by
+    * MultiFormatNavDataFactory. */
+class SerialRecorder : public TestClass
+{
+public:
+   SerialRecorder()
+   {
+      supportedSignals.clear();
+      supportedSignals.insert(firstSignal);
+   }
+   bool isProcessConcurrent() const override
+   { return false; }
+   bool loadIntoMap(const std::string& filename,
+                    gnsstk::NavMessageMap& navMap,
+                    gnsstk::NavNearMessageMap& navNearMap,
+                    OffsetCvtMap& ofsMap) override
+   {
+      threads.insert(std::this_thread::get_id());
+      return RinexNavDataFactory::loadIntoMap(filename, navMap, navNearMap,
+                                              ofsMap);
+   }
+      /// The threads that loadIntoMap() was called from.
+   std::set<std::thread::id> threads;
+};
+
+
+   /// Expose the protected members of MultiFormatNavDataFactory.
+class MultiFormatTestClass : public gnsstk::MultiFormatNavDataFactory
+{
+public:
+      /// Take fact back out of the factories used by all instances.
+   static void removeFactory(gnsstk::NavDataFactory *fact)
+   {
+      std::shared_ptr<gnsstk::NavDataFactoryMap> facts(factories());
+      for (auto fi = facts->begin(); fi != facts->end();)
+      {
+         if (fi->second.get() == fact)
+         {
+            fi = facts->erase(fi);
+         }
+         else
+         {
+            ++fi;
+         }
+      }
+   }
+};
+
+
+/// Automated tests for gnsstk::NavDataFactoryWithStoreFile::addDataSources
+class NavDataFactoryWithStoreFile_T
+{
+public:
+   NavDataFactoryWithStoreFile_T();
+      /** Make sure loading files in parallel gives exactly the same
+       * store contents and return value as loading them one at a
+       * time. */
+   unsigned addDataSourcesTest();
+      /// Same as addDataSourcesTest but through MultiFormatNavDataFactory.
+   unsigned multiFormatTest();
+      /// Make sure a frozen factory is left unchanged.
+   unsigned frozenTest();
+      /** Make sure SP3NavDataFactory gives the same results in
+       * parallel, including rejecting a file with a different time
+       * system. */
+   unsigned sp3Test();
+      /** Make sure MultiFormatNavDataFactory reads files on worker
+       * threads even when factories that can't are tried first, and
+       * that the first factory to accept a file still gets it. */
+   unsigned workerThreadTest();
+
+      /** Write numFiles RINEX nav files with overlapping data.
+       * Consecutive files share an epoch with different clock data
+       * so that the result depends on the order in which the files
+       * are loaded. */
+   void writeFiles();
+      /** Write an SP3 file with positions computed from the
+       * synthetic ephemerides.
+       * @param[in] fn The path of the file to write.
+       * @param[in] k The index of the file, which determines the
+       *   epochs and offsets the positions.
+       * @param[in] ts The time system of the file. */
+   void writeSP3(const std::string& fn, unsigned k, gnsstk::TimeSystem ts);
+      /// Dump the entire contents of a store for comparison.
+   static std::string dumpStore(gnsstk::NavMessageMap& data);
+      /** Dump the results of User searches over the synthetic grid
+       * of satellites and times. */
+   std::string dumpFinds(gnsstk::NavDataFactory& fact);
+
+   static const unsigned numFiles = 6;
+   SyntheticNavData synth;
+      /// Good files, in load order.
+   std::vector<std::string> goodFiles;
+      /// Good files with a bad and a missing file mixed in.
+   std::vector<std::string> mixedFiles;
+      /// Overlapping SP3 files, the last of which has a different time system.
+   std::vector<std::string> sp3Files;
+};
+
+
+NavDataFactoryWithStoreFile_T ::
+NavDataFactoryWithStoreFile_T()
+{
+   writeFiles();
+}
+
+
+void NavDataFactoryWithStoreFile_T ::
+writeFiles()
+{
+   std::string path = gnsstk::getPathTestTemp() + gnsstk::getFileSep();
+   for (unsigned k = 0; k < numFiles; k++)
+   {
+      gnsstk::NavDataPtrList navList;
+      for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+      {
+         for (unsigned i = 0; i < 3; i++)
+         {
+            gnsstk::CommonTime toe(synth.t0 + 7200.0 * (2*k+i+1));
+            gnsstk::NavDataPtr ndp = synth.makeEph(prn, toe);
+               // Make the overlapping data distinguishable.
+            std::dynamic_pointer_cast<gnsstk::GPSLNavEph>(ndp)->af0 +=
+               1e-6 * k;
+            navList.push_back(ndp);
+         }
+      }
+      gnsstk::NewNavToRinex writer;
+      gnsstk::HealthGetter healthGet;
+      writer.header.version = 3.04;
+      writer.header.fileType = "N: GNSS NAV DATA";
+      writer.header.setFileSystem("G");
+      writer.header.fileProgram = "gnsstk test";
+      writer.header.fileAgency = "gnsstk";
+      writer.header.valid = gnsstk::Rinex3NavHeader::validVersion |
+         gnsstk::Rinex3NavHeader::validRunBy |
+         gnsstk::Rinex3NavHeader::validEoH;
+      writer.translate(navList, healthGet);
+      std::string fn = path + "NavDataFactoryWithStoreFile_T_" +
+         gnsstk::StringUtils::asString(k) + ".rnx";
+      writer.write(fn);
+      goodFiles.push_back(fn);
+      mixedFiles.push_back(fn);
+      if (k == 1)
+      {
+         std::string bad = path + "NavDataFactoryWithStoreFile_T_bad.rnx";
+         std::ofstream s(bad.c_str());
+         s << "This is not a nav file." << std::endl;
+         mixedFiles.push_back(bad);
+      }
+      else if (k == 3)
+      {
+         mixedFiles.push_back(path + "NavDataFactoryWithStoreFile_T_missing");
+      }
+   }
+   for (unsigned k = 0; k < 4; k++)
+   {
+      std::string fn = path + "NavDataFactoryWithStoreFile_T_" +
+         gnsstk::StringUtils::asString(k) + ".sp3";
+      writeSP3(fn, k, (k == 2 ? gnsstk::TimeSystem::GAL
+                       : gnsstk::TimeSystem::GPS));
+      sp3Files.push_back(fn);
+   }
+}
+
+
+void NavDataFactoryWithStoreFile_T ::
+writeSP3(const std::string& fn, unsigned k, gnsstk::TimeSystem ts)
+{
+   const double interval = 900.0;
+   gnsstk::SP3Stream strm(fn.c_str(), std::ios::out);
+   gnsstk::SP3Header head;
+   head.version = gnsstk::SP3Header::SP3c;
+   head.containsVelocity = false;
+   head.time = synth.t0 + 16 * interval * k;
+   head.time.setTimeSystem(ts);
+   head.epochInterval = interval;
+   head.numberOfEpochs = 24;
+   head.dataUsed = "ORBIT";
+   head.coordSystem = "IGS14";
+   head.orbitType = "FIT";
+   head.agency = "TEST";
+   head.system = gnsstk::SP3SatID(-1, gnsstk::SatelliteSystem::GPS);
+   head.timeSystem = ts;
+   for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+   {
+      head.satList[gnsstk::SP3SatID(prn, gnsstk::SatelliteSystem::GPS)] = 0;
+   }
+   strm << head;
+   for (int epoch = 0; epoch < head.numberOfEpochs; epoch++)
+   {
+      gnsstk::SP3Data data;
+      data.time = head.time + epoch * interval;
+      data.RecType = '*';
+      strm << data;
+      data.RecType = 'P';
+      for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+      {
+         gnsstk::NavDataPtr eph = synth.makeEph(prn, synth.t0 + 7200.0);
+         gnsstk::CommonTime when(data.time);
+         when.setTimeSystem(gnsstk::TimeSystem::GPS);
+         gnsstk::Xvt xvt;
+         std::dynamic_pointer_cast<gnsstk::GPSLNavEph>(eph)->getXvt(when, xvt);
+         data.sat = gnsstk::SP3SatID(prn, gnsstk::SatelliteSystem::GPS);
+            // Make the overlapping data distinguishable.
+         data.x[0] = xvt.x[0] / 1000.0 + k;
+         data.x[1] = xvt.x[1] / 1000.0;
+         data.x[2] = xvt.x[2] / 1000.0;
+         data.clk = xvt.clkbias * 1e6 + k;
+         strm << data;
+      }
+   }
+}
+
+
+std::string NavDataFactoryWithStoreFile_T ::
+dumpStore(gnsstk::NavMessageMap& data)
+{
+   std::ostringstream s;
+   for (const auto& mti : data)
+   {
+      for (const auto& sati : mti.second)
+      {
+         for (const auto& ti : sati.second)
+         {
+            ti.second->dump(s, gnsstk::DumpDetail::Full);
+         }
+      }
+   }
+   return s.str();
+}
+
+
+std::string NavDataFactoryWithStoreFile_T ::
+dumpFinds(gnsstk::NavDataFactory& fact)
+{
+   std::ostringstream s;
+   gnsstk::NavDataPtr ndp;
+   for (const auto& sat : synth.sats)
+   {
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+      for (const auto& when : synth.times)
+      {
+         if (fact.find(nmid, when, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User))
+         {
+            ndp->dump(s, gnsstk::DumpDetail::Full);
+         }
+         else
+         {
+            s << "not found " << sat << " " << when << std::endl;
+         }
+      }
+   }
+   return s.str();
+}
+
+
+unsigned NavDataFactoryWithStoreFile_T ::
+addDataSourcesTest()
+{
+   TUDEF("NavDataFactoryWithStoreFile", "addDataSources");
+   const std::vector<std::string> *fileLists[] = { &goodFiles, &mixedFiles };
+   for (unsigned l = 0; l < 2; l++)
+   {
+      const std::vector<std::string>& files(*fileLists[l]);
+      TestClass serial;
+      bool expRV = true;
+      for (const auto& fn : files)
+      {
+         expRV &= serial.addDataSource(fn);
+      }
+      TUASSERTE(bool, (l == 0), expRV);
+      TUASSERT(serial.size() > 0);
+      std::string expDump = dumpStore(serial.getData());
+      for (unsigned numThreads = 0; numThreads <= 4; numThreads++)
+      {
+         TestClass uut;
+         TUASSERTE(bool, expRV, uut.addDataSources(files, numThreads));
+         TUASSERTE(size_t, serial.size(), uut.size());
+         TUASSERTE(std::string, expDump, dumpStore(uut.getData()));
+      }
+   }
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStoreFile_T ::
+multiFormatTest()
+{
+   TUDEF("MultiFormatNavDataFactory", "addDataSources");
+   TestClass serial;
+   for (const auto& fn : mixedFiles)
+   {
+      serial.addDataSource(fn);
+   }
+   std::string expDump = dumpFinds(serial);
+   gnsstk::MultiFormatNavDataFactory uut;
+   TUASSERTE(bool, false, uut.addDataSources(mixedFiles, 3));
+   TUASSERTE(size_t, serial.size(), uut.size());
+   TUASSERTE(std::string, expDump, dumpFinds(uut));
+   uut.clear();
+   TUASSERTE(bool, true, uut.addDataSources(goodFiles, 3));
+   TUASSERTE(size_t, serial.size(), uut.size());
+   TUASSERTE(std::string, expDump, dumpFinds(uut));
+   uut.clear();
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStoreFile_T ::
+frozenTest()
+{
+   TUDEF("NavDataFactoryWithStoreFile", "addDataSources");
+   TestClass uut;
+   TUASSERTE(bool, true, uut.addDataSource(goodFiles[0]));
+   size_t expSize = uut.size();
+   uut.freeze();
+   TUASSERTE(bool, false, uut.addDataSources(goodFiles, 2));
+   TUASSERTE(size_t, expSize, uut.size());
+   uut.thaw();
+   TUASSERTE(bool, true, uut.addDataSources(goodFiles, 2));
+   TUASSERT(uut.size() > expSize);
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStoreFile_T ::
+sp3Test()
+{
+   TUDEF("SP3NavDataFactory", "addDataSources");
+   SP3TestClass serial;
+   TUASSERTE(bool, true, serial.addDataSource(sp3Files[0]));
+   TUASSERTE(bool, true, serial.addDataSource(sp3Files[1]));
+      // different time system
+   TUASSERTE(bool, false, serial.addDataSource(sp3Files[2]));
+   TUASSERTE(bool, true, serial.addDataSource(sp3Files[3]));
+   TUASSERT(serial.size() > 0);
+   std::string expDump = dumpStore(serial.getData());
+   for (unsigned numThreads = 1; numThreads <= 4; numThreads++)
+   {
+      SP3TestClass uut;
+      TUASSERTE(bool, false, uut.addDataSources(sp3Files, numThreads));
+      TUASSERTE(size_t, serial.size(), uut.size());
+      TUASSERTE(std::string, expDump, dumpStore(uut.getData()));
+      TUASSERTE(gnsstk::TimeSystem, gnsstk::TimeSystem::GPS,
+                uut.getTimeSystem());
+   }
+      // SP3 clock data read in parallel is dropped once RINEX clock
+      // data is in use, as it would be when reading serially.
+   SP3TestClass noClock;
+   noClock.useRinexClockData();
+   TUASSERTE(bool, false, noClock.addDataSources(sp3Files, 2));
+   TUASSERT(noClock.size() > 0);
+   TUASSERTE(size_t, serial.size(), 2 * noClock.size());
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStoreFile_T ::
+workerThreadTest()
+{
+   TUDEF("MultiFormatNavDataFactory", "addDataSources");
+   TestClass rinex;
+      // sp3Other stands in for MultiFormatNavDataFactory's own SP3
+      // factory, which gets the file sp3 rejects for its time system.
+   SP3TestClass sp3, sp3Other;
+   bool expRV = true;
+   std::vector<std::string> files(mixedFiles);
+   files.insert(files.end(), sp3Files.begin(), sp3Files.end());
+   for (const auto& fn : files)
+   {
+      expRV &= (rinex.addDataSource(fn) || sp3.addDataSource(fn) ||
+                sp3Other.addDataSource(fn));
+   }
+   TUASSERT(sp3Other.size() > 0);
+   std::shared_ptr<SerialRecorder> serialRec =
+      std::make_shared<SerialRecorder>();
+   std::shared_ptr<SP3Recorder> sp3Rec = std::make_shared<SP3Recorder>();
+   gnsstk::NavDataFactoryPtr ndfp(serialRec);
+   TUASSERT(gnsstk::MultiFormatNavDataFactory::addFactory(ndfp));
+   ndfp = sp3Rec;
+   TUASSERT(gnsstk::MultiFormatNavDataFactory::addFactory(ndfp));
+   MultiFormatTestClass uut;
+   TUASSERTE(bool, expRV, uut.addDataSources(files, 3));
+      // The first factory to accept each file loaded it.
+   TUASSERTE(size_t, rinex.size(), serialRec->size());
+   TUASSERTE(std::string, dumpStore(rinex.getData()),
+             dumpStore(serialRec->getData()));
+   TUASSERTE(size_t, sp3.size(), sp3Rec->size());
+   TUASSERTE(std::string, dumpStore(sp3.getData()),
+             dumpStore(sp3Rec->getData()));
+   TUASSERTE(size_t, rinex.size() + sp3.size() + sp3Other.size(),
+             uut.size());
+      // The factory that can't read in parallel loaded files on this
+      // thread, but didn't stop the rest from reading on workers.
+   std::thread::id mainThread = std::this_thread::get_id();
+   TUASSERTE(size_t, 1, serialRec->threads.size());
+   TUASSERTE(size_t, 1, serialRec->threads.count(mainThread));
+   TUASSERT(!sp3Rec->threads.empty());
+   TUASSERTE(size_t, 0, sp3Rec->threads.count(mainThread));
+   uut.clear();
+   MultiFormatTestClass::removeFactory(serialRec.get());
+   MultiFormatTestClass::removeFactory(sp3Rec.get());
+   TURETURN();
+}
+
+
+int main()
+{
+   NavDataFactoryWithStoreFile_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.addDataSourcesTest();
+   errorTotal += testClass.multiFormatTest();
+   errorTotal += testClass.frozenTest();
+   errorTotal += testClass.sp3Test();
+   errorTotal += testClass.workerThreadTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -36,6 +36,7 @@
 //                            release, distribution is unlimited.
 //
 //==============================================================================
+#include <chrono>
 #include "NavDataFactoryWithStore.hpp"
 #include "GPSWeekSecond.hpp"
 #include "CivilTime.hpp"
@@ -45,6 +46,7 @@
 #include "GPSLNavAlm.hpp"
 #include "GPSLNavHealth.hpp"
 #include "GPSLNavTimeOffset.hpp"
+#include "SyntheticNavData.hpp"
 #include "TestUtil.hpp"
 // #include "BasicTimeSystemConverter.hpp"
 #include "TimeString.hpp"
@@ -128,6 +130,18 @@ public:
       }
       return rv;
    }
+   size_t sizeOffset() const
+   {
+      size_t rv = 0;
+      for (const auto& ocmi : offsetData)
+      {
+         for (const auto& oemi : ocmi.second)
+         {
+            rv += oemi.second.size();
+         }
+      }
+      return rv;
+   }
    size_t numSatellitesNearest() const
    {
       size_t rv = 0;
@@ -164,6 +178,19 @@ public:
    unsigned isPresentTest();
    unsigned countTest();
    unsigned getFirstLastTimeTest();
+      /// Make sure find() gives the same results with the flat index.
+   unsigned compactTest();
+      /// Test the retention policy in FactoryControl.
+   unsigned retentionTest();
+      /** Make sure the cost of adding data under a retention policy
+       * doesn't grow with the number of records retained. */
+   unsigned retentionCostTest();
+      /** Make sure the record counts are kept up to date as data is
+       * added and removed. */
+   unsigned countUpdateTest();
+      /** Make sure repeated edit() calls, with data added in
+       * between, remove exactly the data they should. */
+   unsigned editTimeIndexTest();
 
       /// Fill fact with test data
    void fillFactory(gnsstk::TestUtil& testFramework, TestClass& fact);
@@ -193,6 +220,9 @@ public:
                 gnsstk::NavType nav = gnsstk::NavType::GPSLNAV);
       /// Check to make sure there are no empty maps in fact.
    void checkForEmpty(gnsstk::TestUtil& testFramework, TestClass& fact);
+      /** Compare size(), count(), numSignals() and numSatellites()
+       * against the contents of the store. */
+   void checkCounts(gnsstk::TestUtil& testFramework, TestClass& fact);
 
    gnsstk::GPSWeekSecond gws, gws5;
    gnsstk::CommonTime ct, ct5;
@@ -2144,6 +2174,642 @@ getFirstLastTimeTest()
 }
 
 
+unsigned NavDataFactoryWithStore_T ::
+compactTest()
+{
+   TUDEF("NavDataFactoryWithStore", "compact");
+   TestClass fact;
+   TUCATCH(fillFactory(testFramework, fact));
+   TUCATCH(fillFactoryXmitHealth(testFramework, fact));
+   TUASSERT(!fact.isCompact());
+   std::vector<gnsstk::NavMessageID> nmids;
+   gnsstk::NavMessageID nmid;
+   fillSat(nmid, 23, 32);
+   nmid.messageType = gnsstk::NavMessageType::Ephemeris;
+   nmids.push_back(nmid);
+   fillSat(nmid, 7, 7);
+   nmids.push_back(nmid);
+   fillSat(nmid, 11, 11, gnsstk::SatelliteSystem::GPS,
+           gnsstk::CarrierBand::L1, gnsstk::TrackingCode::Y);
+   nmids.push_back(nmid);
+      // not in the store
+   fillSat(nmid, 12, 12);
+   nmids.push_back(nmid);
+      // wildcard satellite
+   fillSat(nmid, 0, 0);
+   nmid.sat.makeWild();
+   nmid.xmitSat.makeWild();
+   nmids.push_back(nmid);
+      // wildcard transmitting satellite
+   fillSat(nmid, 5, 0);
+   nmid.xmitSat.makeWild();
+   nmid.messageType = gnsstk::NavMessageType::Almanac;
+   nmids.push_back(nmid);
+   fillSat(nmid, 2, 2);
+   nmid.messageType = gnsstk::NavMessageType::Health;
+   nmids.push_back(nmid);
+   std::vector<gnsstk::NavSearchOrder> orders { gnsstk::NavSearchOrder::User,
+         gnsstk::NavSearchOrder::Nearest };
+   std::vector<gnsstk::SVHealth> healths { gnsstk::SVHealth::Any,
+         gnsstk::SVHealth::Healthy, gnsstk::SVHealth::Unhealthy };
+   std::vector<gnsstk::NavValidityType> valids {
+      gnsstk::NavValidityType::Any, gnsstk::NavValidityType::ValidOnly };
+      // Run every combination of the above over a span of times,
+      // collecting the results.
+   auto search = [&](std::vector<gnsstk::NavDataPtr>& results)
+   {
+      for (const auto& id : nmids)
+      {
+         for (double offs = -7200; offs <= 7200; offs += 15)
+         {
+            for (const auto& order : orders)
+            {
+               for (const auto& health : healths)
+               {
+                  for (const auto& valid : valids)
+                  {
+                     gnsstk::NavDataPtr result;
+                     fact.find(id, ct+offs, result, health, valid, order);
+                     results.push_back(result);
+                  }
+               }
+            }
+         }
+      }
+   };
+   std::vector<gnsstk::NavDataPtr> expected, got;
+      // searching in a different time system throws, as it does
+      // for the maps
+   gnsstk::CommonTime utcTime(ct+30);
+   utcTime.setTimeSystem(gnsstk::TimeSystem::UTC);
+   gnsstk::NavDataPtr utcResult;
+   TUTHROW(fact.find(nmids[0], utcTime, utcResult, gnsstk::SVHealth::Any,
+                     gnsstk::NavValidityType::Any,
+                     gnsstk::NavSearchOrder::User));
+   TUCATCH(search(expected));
+   TUCATCH(fact.compact());
+   TUASSERT(fact.isCompact());
+   TUTHROW(fact.find(nmids[0], utcTime, utcResult, gnsstk::SVHealth::Any,
+                     gnsstk::NavValidityType::Any,
+                     gnsstk::NavSearchOrder::User));
+   TUTHROW(fact.find(nmids[0], utcTime, utcResult, gnsstk::SVHealth::Any,
+                     gnsstk::NavValidityType::Any,
+                     gnsstk::NavSearchOrder::Nearest));
+   TUCATCH(search(got));
+   TUASSERTE(size_t, expected.size(), got.size());
+   unsigned found = 0, mismatches = 0;
+   for (unsigned i = 0; i < expected.size(); i++)
+   {
+      if (expected[i])
+         found++;
+      if (expected[i] != got[i])
+         mismatches++;
+   }
+      // make sure the test is actually finding things
+   TUASSERT(found > 0);
+   TUASSERTE(unsigned, 0, mismatches);
+      // changes to the store discard the index
+   TUCATCH(addData(testFramework, fact, ct+120, 23, 32));
+   TUASSERT(!fact.isCompact());
+   TUCATCH(fact.compact());
+   TUASSERT(fact.isCompact());
+   TUCATCH(fact.edit(ct+120, ct+150));
+   TUASSERT(!fact.isCompact());
+   TUCATCH(fact.compact());
+   TUCATCH(fact.clear());
+   TUASSERT(!fact.isCompact());
+   gnsstk::NavDataPtr result;
+   TUASSERT(!fact.find(nmids[0], ct+30, result, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::Any,
+                       gnsstk::NavSearchOrder::User));
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStore_T ::
+retentionTest()
+{
+   TUDEF("NavDataFactoryWithStore", "addNavData");
+   SyntheticNavData synth;
+   gnsstk::FactoryControl ctrl;
+   gnsstk::NavDataPtr ndp, refNdp;
+      // Expire by age.
+   ctrl.retainMaxAge = 4 * 3600.0;
+   TestClass uut, ref;
+   uut.setControl(ctrl);
+   size_t daySize = 0;
+   gnsstk::CommonTime newest;
+   for (unsigned i = 0; i < 24; i++)
+   {
+         // Add the data in time order.
+      gnsstk::CommonTime toe(synth.t0 + 7200.0 * (i+1));
+      std::shared_ptr<gnsstk::GPSLNavTimeOffset> to =
+         std::make_shared<gnsstk::GPSLNavTimeOffset>();
+      to->timeStamp = toe - 7200.0;
+      to->refTime = toe;
+      to->deltatLS = 18;
+      to->signal = gnsstk::NavMessageID(synth.sats[0],
+                                        gnsstk::NavMessageType::TimeOffset);
+      TUASSERT(uut.addNavData(to));
+      TUASSERT(ref.addNavData(to));
+      for (unsigned long prn = 1; prn <= 3; prn++)
+      {
+         gnsstk::NavDataPtr hea(synth.makeHealth(prn, toe - 7200.0));
+         TUASSERT(uut.addNavData(hea));
+         TUASSERT(ref.addNavData(hea));
+      }
+      for (unsigned long prn = 1; prn <= 3; prn++)
+      {
+         gnsstk::NavDataPtr eph(synth.makeEph(prn, toe));
+         TUASSERT(uut.addNavData(eph));
+         TUASSERT(ref.addNavData(eph));
+         newest = eph->getUserTime();
+      }
+      if (i == 11)
+      {
+         daySize = uut.size();
+      }
+   }
+      // The store stops growing once data starts expiring.
+   TUASSERTE(size_t, daySize, uut.size());
+   TUASSERT(uut.size() < ref.size());
+   TUASSERTE(size_t, uut.size(), uut.sizeNearest());
+      // Each GPSLNavTimeOffset is stored for both directions.
+   TUASSERTE(size_t, 48, ref.sizeOffset());
+   TUASSERTE(size_t, 4, uut.sizeOffset());
+   unsigned expired = 0;
+   for (const auto& mti : uut.getData())
+   {
+      for (const auto& sati : mti.second)
+      {
+         for (const auto& ti : sati.second)
+         {
+            if (ti.first < newest - ctrl.retainMaxAge)
+            {
+               expired++;
+            }
+         }
+      }
+   }
+   TUASSERTE(unsigned, 0, expired);
+   TUCATCH(checkForEmpty(testFramework, uut));
+      // Current data is unaffected, old data is gone.
+   for (unsigned long prn = 1; prn <= 3; prn++)
+   {
+      gnsstk::NavMessageID nmid(synth.sats[prn-1],
+                                gnsstk::NavMessageType::Ephemeris);
+      TUASSERT(ref.find(nmid, newest + 60.0, refNdp, gnsstk::SVHealth::Any,
+                        gnsstk::NavValidityType::ValidOnly,
+                        gnsstk::NavSearchOrder::User));
+      TUASSERT(uut.find(nmid, newest + 60.0, ndp, gnsstk::SVHealth::Any,
+                        gnsstk::NavValidityType::ValidOnly,
+                        gnsstk::NavSearchOrder::User));
+      TUASSERT(ndp == refNdp);
+      TUASSERT(ref.find(nmid, synth.t0 + 3600.0, ndp, gnsstk::SVHealth::Any,
+                        gnsstk::NavValidityType::ValidOnly,
+                        gnsstk::NavSearchOrder::User));
+      TUASSERT(!uut.find(nmid, synth.t0 + 3600.0, ndp, gnsstk::SVHealth::Any,
+                         gnsstk::NavValidityType::ValidOnly,
+                         gnsstk::NavSearchOrder::User));
+   }
+      // The time bounds follow the expired data.
+   gnsstk::CommonTime expInitial(gnsstk::CommonTime::END_OF_TIME);
+   gnsstk::CommonTime expFirst(gnsstk::CommonTime::END_OF_TIME);
+   for (const auto& sati :
+           uut.getData()[gnsstk::NavMessageType::Ephemeris])
+   {
+      for (const auto& ti : sati.second)
+      {
+         auto nf = std::dynamic_pointer_cast<gnsstk::NavFit>(ti.second);
+         expInitial = std::min(expInitial, nf->beginFit);
+      }
+   }
+   for (const auto& mti : uut.getData())
+   {
+      for (const auto& sati : mti.second)
+      {
+         if (sati.first.sat == synth.sats[0].sat)
+         {
+            expFirst = std::min(expFirst,
+                                sati.second.begin()->second->timeStamp);
+         }
+      }
+   }
+   TUASSERTE(gnsstk::CommonTime, expInitial, uut.getInitialTime());
+   TUASSERTE(gnsstk::CommonTime, ref.getFinalTime(), uut.getFinalTime());
+   TUASSERTE(gnsstk::CommonTime, expFirst, uut.getFirstTime(synth.sats[0].sat));
+   TUASSERT(ref.getFirstTime(synth.sats[0].sat) < expFirst);
+   TUASSERTE(gnsstk::CommonTime, ref.getLastTime(synth.sats[0].sat),
+             uut.getLastTime(synth.sats[0].sat));
+      // Records removed by edit() aren't kept alive by the policy.
+   std::weak_ptr<gnsstk::NavData> edited;
+   gnsstk::CommonTime editFrom, editTo;
+   {
+      gnsstk::NavDataPtr eph(synth.makeEph(1, newest + 7200.0));
+      edited = eph;
+      editFrom = eph->timeStamp;
+      editTo = eph->getUserTime() + 1.0;
+      TUASSERT(uut.addNavData(eph));
+   }
+   TUASSERT(!edited.expired());
+   TUCATCH(uut.edit(editFrom, editTo));
+   TUASSERT(edited.expired());
+      // Clearing the store resets the policy's state.
+   uut.clear();
+   TUASSERT(uut.addNavData(synth.makeEph(1, synth.t0 + 7200.0)));
+   TUASSERTE(size_t, 1, uut.size());
+
+      // Limit the number of records per satellite.
+   ctrl = gnsstk::FactoryControl();
+   ctrl.retainMaxPerSat = 3;
+   TestClass uut2;
+   uut2.setControl(ctrl);
+   for (unsigned i = 0; i < 12; i++)
+   {
+      for (unsigned long prn = 1; prn <= 3; prn++)
+      {
+         TUASSERT(uut2.addNavData(
+                     synth.makeEph(prn, synth.t0 + 7200.0 * (i+1))));
+      }
+   }
+   TUASSERTE(size_t, 9, uut2.size());
+   TUASSERTE(size_t, 9, uut2.sizeNearest());
+   gnsstk::CommonTime oldest(synth.makeEph(1, synth.t0 + 7200.0 * 10)
+                             ->getUserTime());
+   for (const auto& sati :
+           uut2.getData()[gnsstk::NavMessageType::Ephemeris])
+   {
+      TUASSERTE(size_t, 3, sati.second.size());
+      TUASSERTE(gnsstk::CommonTime, oldest, sati.second.begin()->first);
+   }
+      // Adding something older than what's kept does nothing.
+   TUASSERT(uut2.addNavData(synth.makeEph(1, synth.t0 + 7200.0)));
+   TUASSERTE(size_t, 9, uut2.size());
+   TUASSERTE(size_t, 9, uut2.sizeNearest());
+      // The time bounds follow the trimmed data.
+   gnsstk::NavDataPtr oldestEph(
+      uut2.getData()[gnsstk::NavMessageType::Ephemeris].begin()
+      ->second.begin()->second);
+   TUASSERTE(gnsstk::CommonTime,
+             std::dynamic_pointer_cast<gnsstk::NavFit>(oldestEph)->beginFit,
+             uut2.getInitialTime());
+   TUASSERTE(gnsstk::CommonTime, oldestEph->timeStamp,
+             uut2.getFirstTime(synth.sats[0].sat));
+
+      // Keep the last valid ephemerides, even when they're old.
+   ctrl = gnsstk::FactoryControl();
+   ctrl.retainValidEph = 2;
+   ctrl.retainMaxAge = 3600.0;
+   TestClass uut3;
+   uut3.setControl(ctrl);
+   std::vector<gnsstk::NavDataPtr> prn1;
+   for (unsigned i = 0; i < 6; i++)
+   {
+      gnsstk::NavDataPtr eph(synth.makeEph(1, synth.t0 + 7200.0 * (i+1)));
+      if (i & 1)
+      {
+         std::dynamic_pointer_cast<gnsstk::GPSLNavEph>(eph)->pre2 = 0x22;
+         TUASSERT(!eph->validate());
+      }
+      prn1.push_back(eph);
+      TUASSERT(uut3.addNavData(eph));
+      TUASSERT(uut3.addNavData(synth.makeHealth(1, eph->timeStamp)));
+   }
+      // The newest two valid ones, which are exempt from aging, and
+      // the newest invalid one, which hasn't expired yet.
+   TUASSERTE(size_t, 3,
+             uut3.getData()[gnsstk::NavMessageType::Ephemeris].begin()
+             ->second.size());
+   for (unsigned i = 0; i < 24; i++)
+   {
+      TUASSERT(uut3.addNavData(
+                  synth.makeEph(2, synth.t0 + 7200.0 * (i+7))));
+   }
+      // Only the valid ephemerides survive aging.
+   const gnsstk::NavSatMap& ephs(
+      uut3.getData()[gnsstk::NavMessageType::Ephemeris]);
+   TUASSERTE(size_t, 2, ephs.size());
+   for (const auto& sati : ephs)
+   {
+      TUASSERTE(size_t, 2, sati.second.size());
+   }
+   TUASSERT(ephs.begin()->second.begin()->second == prn1[2]);
+   TUASSERT(ephs.begin()->second.rbegin()->second == prn1[4]);
+   TUASSERTE(size_t, 4, uut3.size());
+   TUASSERTE(size_t, 4, uut3.sizeNearest());
+   gnsstk::NavMessageID nmid(synth.sats[0],
+                             gnsstk::NavMessageType::Ephemeris);
+   TUASSERT(uut3.find(nmid, prn1[4]->getUserTime() + 60.0, ndp,
+                      gnsstk::SVHealth::Any,
+                      gnsstk::NavValidityType::ValidOnly,
+                      gnsstk::NavSearchOrder::User));
+   TUASSERT(ndp == prn1[4]);
+      // Without aging, invalid ephemerides newer than the oldest
+      // kept valid one are kept too.
+   ctrl.retainMaxAge = 0;
+   TestClass uut4;
+   uut4.setControl(ctrl);
+   for (const auto& eph : prn1)
+   {
+      TUASSERT(uut4.addNavData(eph));
+   }
+   TUASSERTE(size_t, 4, uut4.size());
+   TUASSERTE(size_t, 4, uut4.sizeNearest());
+   TUASSERT(uut4.getData()[gnsstk::NavMessageType::Ephemeris].begin()
+            ->second.begin()->second == prn1[2]);
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStore_T ::
+retentionCostTest()
+{
+   TUDEF("NavDataFactoryWithStore", "addNavData");
+   SyntheticNavData synth;
+   const unsigned long numSats = SyntheticNavData::numPRN;
+   const size_t numAdds = 2000;
+      /* Return the best time over a few tries, in seconds, to add
+       * numAdds records to a store that already retains
+       * maxPerSat records for each satellite. */
+   auto timeAdds = [&](size_t maxPerSat)
+   {
+      std::vector<gnsstk::NavDataPtr> ephs;
+      for (size_t i = 0; i < maxPerSat + numAdds / numSats; i++)
+      {
+         for (unsigned long prn = 1; prn <= numSats; prn++)
+         {
+            ephs.push_back(synth.makeEph(prn, synth.t0 + 7200.0 * (i+1)));
+         }
+      }
+      double best = 0;
+      for (unsigned tries = 0; tries < 3; tries++)
+      {
+         gnsstk::FactoryControl ctrl;
+         ctrl.retainMaxPerSat = maxPerSat;
+         TestClass uut;
+         uut.setControl(ctrl);
+         size_t i = 0;
+         for (; i < maxPerSat * numSats; i++)
+         {
+            uut.addNavData(ephs[i]);
+         }
+            // Each of these trims the oldest record of a satellite.
+         auto start = std::chrono::steady_clock::now();
+         for (; i < ephs.size(); i++)
+         {
+            uut.addNavData(ephs[i]);
+         }
+         std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+         TUASSERTE(size_t, maxPerSat * numSats, uut.size());
+         if ((tries == 0) || (elapsed.count() < best))
+         {
+            best = elapsed.count();
+         }
+      }
+      return best;
+   };
+   double small = timeAdds(10);
+   double large = timeAdds(4000);
+      // Rescanning the store on each trim made the large store
+      // several hundred times slower.  Allow for the deeper maps
+      // and for timing noise.
+   TUASSERT(large < 4 * small);
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStore_T ::
+countUpdateTest()
+{
+   TUDEF("NavDataFactoryWithStore", "count");
+   TestClass uut;
+   gnsstk::CommonTime ect(ct-3600); // make the base time match the ephemeris
+   TUCATCH(checkCounts(testFramework, uut));
+   TUCATCH(fillFactory(testFramework, uut));
+   TUCATCH(addData(testFramework, uut, ct+0, 11, 11,
+                   gnsstk::SatelliteSystem::Galileo, gnsstk::CarrierBand::L1,
+                   gnsstk::TrackingCode::E1B, gnsstk::NavType::GalINAV));
+   TUCATCH(addData(testFramework, uut, ct+30, 11, 11,
+                   gnsstk::SatelliteSystem::Galileo, gnsstk::CarrierBand::L1,
+                   gnsstk::TrackingCode::E1B, gnsstk::NavType::GalINAV));
+   TUCATCH(addData(testFramework, uut, ct+0, 7, 7,
+                   gnsstk::SatelliteSystem::GPS, gnsstk::CarrierBand::L1,
+                   gnsstk::TrackingCode::CA, gnsstk::NavType::GPSLNAV,
+                   gnsstk::SVHealth::Healthy, gnsstk::NavMessageType::Almanac));
+   TUASSERTE(size_t, 11, uut.size());
+   TUASSERTE(size_t, 2, uut.count(gnsstk::SatelliteSystem::Galileo));
+   TUASSERTE(size_t, 1, uut.count(gnsstk::NavMessageType::Almanac));
+   TUASSERTE(size_t, 1, uut.count(gnsstk::SatelliteSystem::GPS,
+                                  gnsstk::NavMessageType::Almanac));
+   TUASSERTE(size_t, 3, uut.numSignals());
+   TUASSERTE(size_t, 4, uut.numSatellites());
+   TUCATCH(checkCounts(testFramework, uut));
+      // Replacing a record doesn't change the counts.
+   TUCATCH(addData(testFramework, uut, ct+0, 7, 7));
+   TUASSERTE(size_t, 11, uut.size());
+   TUCATCH(checkCounts(testFramework, uut));
+      // remove messages at ect
+   TUCATCH(uut.edit(gnsstk::CommonTime::BEGINNING_OF_TIME, ect+30));
+   TUASSERTE(size_t, 7, uut.size());
+   TUCATCH(checkCounts(testFramework, uut));
+      // remove the Galileo satellite entirely
+   gnsstk::NavSatelliteID galSat;
+   fillSat(galSat, 11, 11, gnsstk::SatelliteSystem::Galileo,
+           gnsstk::CarrierBand::L1, gnsstk::TrackingCode::E1B,
+           gnsstk::NavType::GalINAV);
+   TUCATCH(uut.edit(gnsstk::CommonTime::BEGINNING_OF_TIME,
+                    gnsstk::CommonTime::END_OF_TIME, galSat));
+   TUASSERTE(size_t, 0, uut.count(gnsstk::SatelliteSystem::Galileo));
+   TUASSERTE(size_t, 2, uut.numSignals());
+   TUCATCH(checkCounts(testFramework, uut));
+      // retention removes records as new ones are added
+   gnsstk::FactoryControl ctrl;
+   ctrl.retainMaxPerSat = 1;
+   uut.setControl(ctrl);
+   TUCATCH(addData(testFramework, uut, ct+120, 23, 32));
+   TUASSERTE(size_t, 1,
+             uut.count(gnsstk::SatID(23,gnsstk::SatelliteSystem::GPS)));
+   TUCATCH(checkCounts(testFramework, uut));
+   TUCATCH(uut.clear());
+   TUASSERTE(size_t, 0, uut.size());
+   TUASSERTE(size_t, 0, uut.numSignals());
+   TUASSERTE(size_t, 0, uut.numSatellites());
+   TUCATCH(checkCounts(testFramework, uut));
+   TURETURN();
+}
+
+
+unsigned NavDataFactoryWithStore_T ::
+editTimeIndexTest()
+{
+   TUDEF("NavDataFactoryWithStore", "edit");
+   SyntheticNavData synth;
+   TestClass uut;
+      // What we expect to be in data and nearestData, respectively.
+   std::list<gnsstk::NavDataPtr> expUser, expNear;
+   auto add = [&](const gnsstk::NavDataPtr& ndp)
+   {
+      TUASSERT(uut.addNavData(ndp));
+         // A record with the same key and user time is replaced.
+      expUser.remove_if([&ndp](const gnsstk::NavDataPtr& old)
+      {
+         return ((old->signal == ndp->signal) &&
+                 (old->getUserTime() == ndp->getUserTime()));
+      });
+      expUser.push_back(ndp);
+      expNear.push_back(ndp);
+   };
+   auto addHours = [&](unsigned first, unsigned last)
+   {
+      for (unsigned i = first; i < last; i++)
+      {
+         gnsstk::CommonTime toe(synth.t0 + 7200.0 * (i+1));
+         std::shared_ptr<gnsstk::GPSLNavTimeOffset> to =
+            std::make_shared<gnsstk::GPSLNavTimeOffset>();
+         to->timeStamp = toe - 7200.0;
+         to->refTime = toe;
+         to->deltatLS = 18;
+         to->signal = gnsstk::NavMessageID(
+            synth.sats[0], gnsstk::NavMessageType::TimeOffset);
+         add(to);
+         for (unsigned long prn = 1; prn <= 3; prn++)
+         {
+            add(synth.makeHealth(prn, toe - 7200.0));
+            add(synth.makeEph(prn, toe));
+         }
+      }
+   };
+   auto edit = [&](const gnsstk::CommonTime& fromTime,
+                   const gnsstk::CommonTime& toTime,
+                   const gnsstk::NavSatelliteID *satID)
+   {
+      if (satID == nullptr)
+      {
+         TUCATCH(uut.edit(fromTime, toTime));
+      }
+      else
+      {
+         TUCATCH(uut.edit(fromTime, toTime, *satID));
+      }
+      auto inRange = [&](const gnsstk::NavDataPtr& ndp,
+                         const gnsstk::CommonTime& t)
+      {
+         const gnsstk::NavSatelliteID& sat(ndp->signal);
+         return (((satID == nullptr) || (sat == *satID)) &&
+                 (t >= fromTime) && (t < toTime));
+      };
+      expUser.remove_if([&](const gnsstk::NavDataPtr& ndp)
+                        { return inRange(ndp, ndp->getUserTime()); });
+      expNear.remove_if([&](const gnsstk::NavDataPtr& ndp)
+                        { return inRange(ndp, ndp->timeStamp); });
+   };
+   auto check = [&]()
+   {
+      TUASSERTE(size_t, expUser.size(), uut.size());
+      TUASSERTE(size_t, expNear.size(), uut.sizeNearest());
+      for (const auto& ndp : expUser)
+      {
+         gnsstk::NavMap& nm(uut.getData()[ndp->signal.messageType]
+                            [ndp->signal]);
+         auto nmi = nm.find(ndp->getUserTime());
+         TUASSERT((nmi != nm.end()) && (nmi->second == ndp));
+      }
+      TUCATCH(checkForEmpty(testFramework, uut));
+   };
+   addHours(0, 12);
+   check();
+      // first edit builds the time index
+   edit(synth.t0, synth.t0 + 4*3600.0, nullptr);
+   check();
+      // remove nothing
+   edit(synth.t0 - 86400.0, synth.t0 - 3600.0, nullptr);
+   check();
+      // add data after the index has been built
+   addHours(12, 24);
+      // replace an existing record
+   add(synth.makeEph(2, synth.t0 + 7200.0 * 20));
+   check();
+      // sliding window edits that don't fall on bucket boundaries
+   for (double sec = 4*3600.0; sec < 12*3600.0; sec += 1800.0)
+   {
+      edit(synth.t0 + sec, synth.t0 + sec + 1800.0 + 17.0, nullptr);
+      check();
+   }
+   edit(synth.t0, gnsstk::CommonTime::END_OF_TIME, &synth.sats[1]);
+   check();
+   TUASSERTE(size_t, 0, uut.count(synth.sats[1].sat));
+   edit(gnsstk::CommonTime::BEGINNING_OF_TIME,
+        gnsstk::CommonTime::END_OF_TIME, nullptr);
+   check();
+   TUASSERTE(size_t, 0, uut.size());
+   TUASSERTE(size_t, 0, uut.sizeOffset());
+      // the store still works after being emptied
+   addHours(0, 2);
+   check();
+   edit(synth.t0, synth.t0 + 3600.0, nullptr);
+   check();
+   TUCATCH(uut.clear());
+   expUser.clear();
+   expNear.clear();
+   addHours(0, 2);
+   edit(synth.t0 + 3600.0, synth.t0 + 7200.0, nullptr);
+   check();
+   TURETURN();
+}
+
+
+void NavDataFactoryWithStore_T ::
+checkCounts(gnsstk::TestUtil& testFramework, TestClass& fact)
+{
+   size_t total = 0;
+   std::map<gnsstk::NavMessageType, size_t> typeCounts;
+   std::map<gnsstk::SatelliteSystem, size_t> sysCounts;
+   std::set<gnsstk::NavSignalID> signals;
+   std::set<gnsstk::NavSatelliteID> sats;
+   for (const auto& mti : fact.getData())
+   {
+      for (const auto& sati : mti.second)
+      {
+         total += sati.second.size();
+         typeCounts[mti.first] += sati.second.size();
+         sysCounts[sati.first.system] += sati.second.size();
+         signals.insert(sati.first);
+         sats.insert(sati.first);
+      }
+   }
+   TUASSERTE(size_t, total, fact.size());
+   TUASSERTE(size_t, total, fact.count(gnsstk::SatelliteSystem::Unknown));
+   TUASSERTE(size_t, signals.size(), fact.numSignals());
+   TUASSERTE(size_t, sats.size(), fact.numSatellites());
+   typeCounts[gnsstk::NavMessageType::Unknown] = total;
+   for (gnsstk::NavMessageType nmt : gnsstk::NavMessageTypeIterator())
+   {
+         // Unknown is a wildcard.
+      TUASSERTE(size_t, typeCounts[nmt], fact.count(nmt));
+   }
+   for (gnsstk::SatelliteSystem sys : {gnsstk::SatelliteSystem::GPS,
+                                       gnsstk::SatelliteSystem::Galileo})
+   {
+      TUASSERTE(size_t, sysCounts[sys], fact.count(sys));
+   }
+   for (const auto& sat : sats)
+   {
+      size_t satCount = 0;
+      for (const auto& mti : fact.getData())
+      {
+         auto sati = mti.second.find(sat);
+         if (sati != mti.second.end())
+         {
+            satCount += sati->second.size();
+         }
+      }
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Unknown);
+      TUASSERTE(size_t, satCount, fact.count(nmid));
+   }
+}
+
+
 int main()
 {
    NavDataFactoryWithStore_T testClass;
@@ -2164,6 +2830,11 @@ int main()
    errorTotal += testClass.isPresentTest();
    errorTotal += testClass.countTest();
    errorTotal += testClass.getFirstLastTimeTest();
+   errorTotal += testClass.compactTest();
+   errorTotal += testClass.retentionTest();
+   errorTotal += testClass.retentionCostTest();
+   errorTotal += testClass.countUpdateTest();
+   errorTotal += testClass.editTimeIndexTest();
 
    std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
              << std::endl;
@@ -0,0 +1,207 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "NavLibrary.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+#include "build_config.h"
+
+class NavFactoryMetrics_T : public SyntheticNavData
+{
+public:
+      /// Test the find and reject counters via NavLibrary.
+   unsigned findTest();
+      /// Test the load statistics and the dump methods.
+   unsigned loadTest();
+};
+
+
+unsigned NavFactoryMetrics_T ::
+findTest()
+{
+   TUDEF("NavLibrary", "getMetrics");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   navLib.addFactory(ndfp);
+   fill(*fact);
+   gnsstk::Xvt xvt;
+   std::vector<gnsstk::NavFactoryMetrics> metrics;
+      // disabled by default
+   TUASSERT(navLib.getXvt(sats[0], t0 + 9000.0, xvt, false));
+   metrics = navLib.getMetrics();
+   TUASSERTE(size_t, 1, metrics.size());
+   TUASSERTE(std::string, "SyntheticNavFactory", metrics[0].factory);
+   TUASSERTE(unsigned long, 0, metrics[0].total().finds);
+   TUASSERT(metrics[0].byType.empty());
+   navLib.setMetricsEnabled(true);
+      // one hit
+   TUASSERT(navLib.getXvt(sats[0], t0 + 9000.0, xvt, false));
+      // one miss, long after the end of the data
+   TUASSERT(!navLib.getXvt(sats[0], t0 + 864000.0, xvt, false));
+      // the bad satellite only has unhealthy data
+   TUASSERT(!navLib.getXvt(sats[badPRN-1], t0 + 9000.0, xvt, false,
+                           gnsstk::SVHealth::Healthy));
+   metrics = navLib.getMetrics();
+   TUASSERTE(size_t, 1, metrics.size());
+   gnsstk::NavFactoryMetrics::Counts total = metrics[0].total();
+   TUASSERTE(unsigned long, 3, total.finds);
+   TUASSERTE(unsigned long, 1, total.hits);
+   TUASSERTE(unsigned long, 2, total.misses);
+   TUASSERT(total.healthRejects > 0);
+   TUASSERT(total.findSeconds >= 0);
+      // only the hit has an Xvt computed, and it is timed separately
+   TUASSERTE(unsigned long, 1, total.xvts);
+   TUASSERT(total.xvtSeconds >= 0);
+   auto eph = metrics[0].byType.find(gnsstk::NavMessageType::Ephemeris);
+   TUASSERT(eph != metrics[0].byType.end());
+   if (eph != metrics[0].byType.end())
+   {
+      TUASSERTE(unsigned long, 3, eph->second.finds);
+      TUASSERTE(unsigned long, 1, eph->second.xvts);
+   }
+      // searching a frozen library still records
+   navLib.freeze();
+   TUASSERT(navLib.getXvt(sats[0], t0 + 9000.0, xvt, false));
+   navLib.thaw();
+   metrics = navLib.getMetrics();
+   TUASSERTE(unsigned long, 4, metrics[0].total().finds);
+   TUASSERTE(unsigned long, 2, metrics[0].total().xvts);
+      // the batch getXvt records one Xvt per satellite found
+   navLib.resetMetrics();
+   gnsstk::XvtBatch xvts;
+   size_t found = navLib.getXvt(sats, t0 + 9000.0, xvts, false);
+   TUASSERT(found > 0);
+   metrics = navLib.getMetrics();
+   TUASSERTE(unsigned long, found, metrics[0].total().xvts);
+   TUASSERTE(unsigned long, sats.size(), metrics[0].total().finds);
+      // reset
+   navLib.resetMetrics();
+   metrics = navLib.getMetrics();
+   TUASSERTE(unsigned long, 0, metrics[0].total().finds);
+   TUASSERTE(unsigned long, 0, metrics[0].total().xvts);
+      // disable again
+   navLib.setMetricsEnabled(false);
+   TUASSERT(navLib.getXvt(sats[0], t0 + 9000.0, xvt, false));
+   metrics = navLib.getMetrics();
+   TUASSERTE(unsigned long, 0, metrics[0].total().finds);
+   TURETURN();
+}
+
+
+unsigned NavFactoryMetrics_T ::
+loadTest()
+{
+   TUDEF("NavFactoryMetricsRecorder", "addLoad");
+   std::string fn = gnsstk::getPathTestTemp() + gnsstk::getFileSep() +
+      "NavFactoryMetrics_T.tmp";
+   {
+      std::ofstream tmp(fn.c_str());
+      tmp << std::string(1000, 'x');
+   }
+   gnsstk::NavFactoryMetricsRecorder rec;
+   gnsstk::NavFactoryMetrics metrics;
+      // disabled, nothing recorded
+   rec.addLoad(fn, 5, std::chrono::milliseconds(10), true);
+   rec.get(metrics);
+   TUASSERT(metrics.sources.empty());
+   rec.setEnabled(true);
+   rec.addLoad(fn, 5, std::chrono::milliseconds(10), true);
+   rec.addLoad("not a file \"quoted\"", 0, std::chrono::milliseconds(0),
+               false);
+   rec.addReject(gnsstk::NavMessageType::Almanac,
+                 gnsstk::NavFactoryMetricsRecorder::Reject::Fit);
+   {
+      gnsstk::NavFactoryMetricsRecorder::XvtTimer timer(
+         rec, gnsstk::NavMessageType::Ephemeris);
+   }
+   rec.get(metrics);
+   TUASSERTE(size_t, 2, metrics.sources.size());
+   if (metrics.sources.size() == 2)
+   {
+      TUASSERTE(std::string, fn, metrics.sources[0].source);
+      TUASSERTE(unsigned long long, 1000, metrics.sources[0].bytes);
+      TUASSERTE(unsigned long, 5, metrics.sources[0].records);
+      TUASSERTFE(0.01, metrics.sources[0].seconds);
+      TUASSERTE(bool, true, metrics.sources[0].success);
+      TUASSERTE(unsigned long long, 0, metrics.sources[1].bytes);
+      TUASSERTE(bool, false, metrics.sources[1].success);
+   }
+   TUASSERTE(unsigned long, 1, metrics.total().fitRejects);
+   TUASSERTE(unsigned long, 1, metrics.total().xvts);
+   TUASSERTE(unsigned long, 0, metrics.total().finds);
+   metrics.factory = "Test";
+   std::ostringstream json;
+   metrics.dumpJSON(json);
+   TUASSERT(json.str().find("{\"factory\":\"Test\"") == 0);
+   TUASSERT(json.str().find("\"Almanac\":{") != std::string::npos);
+   TUASSERT(json.str().find("\"xvtSeconds\":") != std::string::npos);
+   TUASSERT(json.str().find("not a file \\\"quoted\\\"") != std::string::npos);
+   std::ostringstream text;
+   metrics.dump(text);
+   TUASSERT(text.str().find("Test") == 0);
+      // copies are independent
+   gnsstk::NavFactoryMetricsRecorder copy(rec);
+   rec.reset();
+   rec.get(metrics);
+   TUASSERT(metrics.sources.empty());
+   TUASSERTE(unsigned long, 0, metrics.total().fitRejects);
+   copy.get(metrics);
+   TUASSERTE(size_t, 2, metrics.sources.size());
+   std::remove(fn.c_str());
+   TURETURN();
+}
+
+
+int main()
+{
+   NavFactoryMetrics_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.findTest();
+   errorTotal += testClass.loadTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,377 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "NavFindCursor.hpp"
+#include "SyntheticNavData.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "RinexNavDataFactory.hpp"
+#include "TestUtil.hpp"
+
+class NavFindCursor_T : public SyntheticNavData
+{
+public:
+   NavFindCursor_T();
+      /// Test searches stepping forward through time.
+   unsigned forwardTest();
+      /// Test searches going backwards and jumping around in time.
+   unsigned jumpTest();
+      /// Test that changing the store invalidates the cursor.
+   unsigned editTest();
+      /// Test searches through a span with no ephemeris in fit.
+   unsigned gapTest();
+      /// Test searches through MultiFormatNavDataFactory.
+   unsigned multiFormatTest();
+
+      /** Search for nmid at each of times using both the cursor and
+       * the plain User search and count the differences.
+       * @param[in] found Incremented for each successful search.
+       * @return The number of times where the results differ. */
+   unsigned sweep(SyntheticNavFactory& fact, const gnsstk::NavMessageID& nmid,
+                  gnsstk::SVHealth xmitHealth,
+                  const std::vector<gnsstk::CommonTime>& searchTimes,
+                  gnsstk::NavFindCursor& cursor, unsigned& found);
+
+      /// Search times at a finer interval than SyntheticNavData::times.
+   std::vector<gnsstk::CommonTime> fineTimes;
+      /// Transmit health states to search for.
+   std::vector<gnsstk::SVHealth> healths;
+};
+
+
+NavFindCursor_T ::
+NavFindCursor_T()
+{
+   for (double sec = -3600.0; sec < 90000.0; sec += 60.0)
+   {
+      fineTimes.push_back(t0 + sec);
+   }
+   healths.push_back(gnsstk::SVHealth::Any);
+   healths.push_back(gnsstk::SVHealth::Healthy);
+   healths.push_back(gnsstk::SVHealth::Unhealthy);
+}
+
+
+unsigned NavFindCursor_T ::
+sweep(SyntheticNavFactory& fact, const gnsstk::NavMessageID& nmid,
+      gnsstk::SVHealth xmitHealth,
+      const std::vector<gnsstk::CommonTime>& searchTimes,
+      gnsstk::NavFindCursor& cursor, unsigned& found)
+{
+   unsigned rv = 0;
+   for (const auto& when : searchTimes)
+   {
+      gnsstk::NavDataPtr exp, got;
+      bool expOK = fact.find(nmid, when, exp, xmitHealth,
+                             gnsstk::NavValidityType::ValidOnly,
+                             gnsstk::NavSearchOrder::User);
+      bool gotOK = fact.find(nmid, when, got, xmitHealth,
+                             gnsstk::NavValidityType::ValidOnly, cursor);
+      if ((expOK != gotOK) || (exp != got))
+         rv++;
+      found += gotOK;
+   }
+   return rv;
+}
+
+
+unsigned NavFindCursor_T ::
+forwardTest()
+{
+   TUDEF("NavDataFactoryWithStore", "find(cursor)");
+   SyntheticNavFactory fact;
+   fill(fact);
+   fact.compact();
+   unsigned found = 0;
+   for (const auto& sat : sats)
+   {
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+      for (const auto& xmitHealth : healths)
+      {
+         gnsstk::NavFindCursor cursor;
+         TUASSERTE(unsigned, 0, sweep(fact, nmid, xmitHealth, fineTimes,
+                                      cursor, found));
+      }
+   }
+   TUASSERT(found > 0);
+      // any satellite, which matches multiple indices
+   gnsstk::NavMessageID wild(sats[0], gnsstk::NavMessageType::Ephemeris);
+   wild.sat.makeWild();
+   wild.xmitSat.makeWild();
+   for (const auto& xmitHealth : healths)
+   {
+      gnsstk::NavFindCursor cursor;
+      found = 0;
+      TUASSERTE(unsigned, 0, sweep(fact, wild, xmitHealth, fineTimes, cursor,
+                                   found));
+      TUASSERT(found > 0);
+   }
+      // health messages have no fit interval
+   gnsstk::NavMessageID heaID(sats[1], gnsstk::NavMessageType::Health);
+   gnsstk::NavFindCursor heaCursor;
+   found = 0;
+   TUASSERTE(unsigned, 0, sweep(fact, heaID, gnsstk::SVHealth::Any,
+                                fineTimes, heaCursor, found));
+   TUASSERT(found > 0);
+   TURETURN();
+}
+
+
+unsigned NavFindCursor_T ::
+jumpTest()
+{
+   TUDEF("NavDataFactoryWithStore", "find(cursor)");
+   SyntheticNavFactory fact;
+   fill(fact);
+   fact.compact();
+   unsigned found = 0;
+   std::vector<gnsstk::CommonTime> backward(fineTimes.rbegin(),
+                                            fineTimes.rend());
+   std::vector<gnsstk::CommonTime> jumping;
+   unsigned long seed = 12345;
+   for (unsigned i = 0; i < 2000; i++)
+   {
+         // simple LCG so the test is repeatable
+      seed = (seed * 1103515245 + 12345) % 2147483648UL;
+      jumping.push_back(fineTimes[seed % fineTimes.size()]);
+   }
+   for (const auto& sat : sats)
+   {
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+      gnsstk::NavFindCursor cursor;
+      TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Healthy,
+                                   backward, cursor, found));
+      TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Healthy,
+                                   jumping, cursor, found));
+   }
+   TUASSERT(found > 0);
+      // one cursor used for different satellites and search
+      // parameters, which is inefficient but should still work.
+   gnsstk::NavFindCursor shared;
+   unsigned bad = 0;
+   for (const auto& when : times)
+   {
+      for (const auto& sat : sats)
+      {
+         gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+         std::vector<gnsstk::CommonTime> one(1, when);
+         for (const auto& xmitHealth : healths)
+         {
+            bad += sweep(fact, nmid, xmitHealth, one, shared, found);
+         }
+      }
+   }
+   TUASSERTE(unsigned, 0, bad);
+   TURETURN();
+}
+
+
+unsigned NavFindCursor_T ::
+editTest()
+{
+   TUDEF("NavDataFactoryWithStore", "find(cursor)");
+   SyntheticNavFactory fact;
+   fill(fact);
+   fact.compact();
+   unsigned found = 0;
+   size_t half = fineTimes.size() / 2;
+   std::vector<gnsstk::CommonTime> first(fineTimes.begin(),
+                                         fineTimes.begin() + half);
+   std::vector<gnsstk::CommonTime> second(fineTimes.begin() + half,
+                                          fineTimes.end());
+   gnsstk::NavMessageID nmid(sats[0], gnsstk::NavMessageType::Ephemeris);
+   gnsstk::NavFindCursor cursor;
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, first,
+                                cursor, found));
+      // remove the data the cursor is currently pointing to
+   fact.edit(t0, first.back() + 7200.0, sats[0]);
+   TUASSERT(!fact.isCompact());
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, second,
+                                cursor, found));
+   fact.compact();
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, first,
+                                cursor, found));
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, second,
+                                cursor, found));
+      // rebuilding the index after replacing the data must not
+      // return the old records
+   gnsstk::NavDataPtr before, after;
+   TUASSERT(fact.find(nmid, second.back() - 3600.0, before,
+                      gnsstk::SVHealth::Any,
+                      gnsstk::NavValidityType::ValidOnly, cursor));
+   fact.clear();
+   fill(fact);
+   fact.compact();
+   TUASSERT(fact.find(nmid, second.back() - 3600.0, after,
+                      gnsstk::SVHealth::Any,
+                      gnsstk::NavValidityType::ValidOnly, cursor));
+   TUASSERT(before != after);
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, fineTimes,
+                                cursor, found));
+      // nothing left to find
+   fact.clear();
+   found = 0;
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, fineTimes,
+                                cursor, found));
+   TUASSERTE(unsigned, 0, found);
+   fact.compact();
+   TUASSERTE(unsigned, 0, sweep(fact, nmid, gnsstk::SVHealth::Any, fineTimes,
+                                cursor, found));
+   TUASSERTE(unsigned, 0, found);
+   TURETURN();
+}
+
+
+unsigned NavFindCursor_T ::
+gapTest()
+{
+   TUDEF("NavDataFactoryWithStore", "find(cursor)");
+   SyntheticNavFactory fact;
+   fill(fact, true);
+   fact.compact();
+   gnsstk::NavMessageID nmid(sats[gapPRN-1],
+                             gnsstk::NavMessageType::Ephemeris);
+   std::vector<gnsstk::CommonTime> backward(fineTimes.rbegin(),
+                                            fineTimes.rend());
+   unsigned found = 0;
+   for (const auto& xmitHealth : healths)
+   {
+      gnsstk::NavFindCursor cursor;
+      TUASSERTE(unsigned, 0, sweep(fact, nmid, xmitHealth, fineTimes,
+                                   cursor, found));
+      TUASSERTE(unsigned, 0, sweep(fact, nmid, xmitHealth, backward,
+                                   cursor, found));
+   }
+   TUASSERT(found > 0);
+      // the cursor must not keep returning the ephemeris from
+      // before the gap once its fit interval has ended.
+   gnsstk::NavFindCursor cursor;
+   gnsstk::NavDataPtr ndp;
+   TUASSERT(fact.find(nmid, gapBegin - 60.0, ndp, gnsstk::SVHealth::Any,
+                      gnsstk::NavValidityType::ValidOnly, cursor));
+   TUASSERT(!fact.find(nmid, gapBegin + 60.0, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly, cursor));
+   TUASSERT(!fact.find(nmid, gapEnd - 60.0, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly, cursor));
+   TUASSERT(fact.find(nmid, gapEnd + 60.0, ndp, gnsstk::SVHealth::Any,
+                      gnsstk::NavValidityType::ValidOnly, cursor));
+   TURETURN();
+}
+
+
+unsigned NavFindCursor_T ::
+multiFormatTest()
+{
+   TUDEF("MultiFormatNavDataFactory", "find(cursor)");
+      // The first factory has a gap for gapPRN that is filled by
+      // the second, so searches of gapPRN alternate between them.
+      // MultiFormatNavDataFactory only accepts file factories, so
+      // fill a pair of RinexNavDataFactory objects directly.
+   std::shared_ptr<gnsstk::RinexNavDataFactory> first =
+      std::make_shared<gnsstk::RinexNavDataFactory>();
+   std::shared_ptr<gnsstk::RinexNavDataFactory> second =
+      std::make_shared<gnsstk::RinexNavDataFactory>();
+   for (unsigned long prn = 1; prn <= numPRN; prn++)
+   {
+      for (unsigned i = 0; i < 12; i++)
+      {
+         gnsstk::CommonTime toe(t0 + 7200.0 * (i+1));
+         bool inGap = ((prn == gapPRN) && (toe >= gapBegin) &&
+                       (toe <= gapEnd));
+         (inGap ? second : first)->addNavData(makeEph(prn, toe));
+      }
+   }
+   first->compact();
+   second->compact();
+   gnsstk::NavDataFactoryPtr firstPtr(first), secondPtr(second);
+   TUASSERT(gnsstk::MultiFormatNavDataFactory::addFactory(firstPtr));
+   TUASSERT(gnsstk::MultiFormatNavDataFactory::addFactory(secondPtr));
+   gnsstk::MultiFormatNavDataFactory uut;
+   gnsstk::NavMessageID nmid(sats[gapPRN-1],
+                             gnsstk::NavMessageType::Ephemeris);
+   std::vector<gnsstk::CommonTime> backward(fineTimes.rbegin(),
+                                            fineTimes.rend());
+   for (const auto& searchTimes : {fineTimes, backward})
+   {
+      gnsstk::NavFindCursor cursor;
+      unsigned bad = 0, fromFirst = 0, fromSecond = 0;
+      for (const auto& when : searchTimes)
+      {
+         gnsstk::NavDataPtr exp, got;
+         bool expOK = uut.find(nmid, when, exp, gnsstk::SVHealth::Any,
+                               gnsstk::NavValidityType::ValidOnly,
+                               gnsstk::NavSearchOrder::User);
+         bool gotOK = uut.find(nmid, when, got, gnsstk::SVHealth::Any,
+                               gnsstk::NavValidityType::ValidOnly, cursor);
+         if ((expOK != gotOK) || (exp != got))
+            bad++;
+         if (gotOK)
+         {
+            gnsstk::NavDataPtr dummy;
+            if (second->find(nmid, when, dummy, gnsstk::SVHealth::Any,
+                             gnsstk::NavValidityType::ValidOnly,
+                             gnsstk::NavSearchOrder::User) && (dummy == got))
+               fromSecond++;
+            else
+               fromFirst++;
+         }
+      }
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERT(fromFirst > 0);
+      TUASSERT(fromSecond > 0);
+   }
+   uut.clear();
+   TURETURN();
+}
+
+
+int main()
+{
+   NavFindCursor_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.forwardTest();
+   errorTotal += testClass.jumpTest();
+   errorTotal += testClass.editTest();
+   errorTotal += testClass.gapTest();
+   errorTotal += testClass.multiFormatTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,307 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "NavLibrary.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+
+class NavLibraryBatch_T : public SyntheticNavData
+{
+public:
+      /// Test XvtBatch storage and conversion.
+   unsigned xvtBatchTest();
+      /// Test the batch getXvt with multiple satellites at one time.
+   unsigned getXvtSatsTest();
+      /// Test the batch getXvt with one satellite at multiple times.
+   unsigned getXvtTimesTest();
+      /// Test the batch getXvt where orbit data is out of its fit interval.
+   unsigned getXvtGapsTest();
+
+      /** Compare element i of a batch result with the result of the
+       * single-satellite getXvt.
+       * @return true if they match. */
+   bool same(const gnsstk::XvtBatch& batch, size_t i, bool expOK,
+             const gnsstk::Xvt& exp);
+};
+
+
+bool NavLibraryBatch_T ::
+same(const gnsstk::XvtBatch& batch, size_t i, bool expOK,
+     const gnsstk::Xvt& exp)
+{
+   gnsstk::Xvt got;
+   if ((batch.status[i] != 0) != expOK)
+      return false;
+   if (!expOK)
+      return !batch.getXvt(i, got);
+   return (batch.getXvt(i, got) &&
+           (got.x == exp.x) && (got.v == exp.v) &&
+           (got.clkbias == exp.clkbias) && (got.clkdrift == exp.clkdrift) &&
+           (got.relcorr == exp.relcorr) && (got.frame == exp.frame) &&
+           (got.health == exp.health));
+}
+
+
+unsigned NavLibraryBatch_T ::
+xvtBatchTest()
+{
+   TUDEF("XvtBatch", "setXvt");
+   gnsstk::XvtBatch uut;
+   gnsstk::Xvt xvt, got;
+   TUASSERTE(size_t, 0, uut.size());
+   uut.resize(3);
+   TUASSERTE(size_t, 3, uut.size());
+   TUASSERTE(size_t, 3, uut.x.size());
+   TUASSERTE(size_t, 3, uut.vz.size());
+   TUASSERTE(size_t, 3, uut.health.size());
+   TUASSERT(!uut.getXvt(1, got));
+   xvt.x = gnsstk::Triple(1.0, 2.0, 3.0);
+   xvt.v = gnsstk::Triple(4.0, 5.0, 6.0);
+   xvt.clkbias = 7.0;
+   xvt.clkdrift = 8.0;
+   xvt.relcorr = 9.0;
+   xvt.frame = gnsstk::RefFrame(gnsstk::RefFrameRlz::WGS84G1762);
+   xvt.health = gnsstk::Xvt::Degraded;
+   uut.setXvt(1, xvt);
+   TUASSERTE(uint8_t, 0, uut.status[0]);
+   TUASSERT(uut.status[1] != 0);
+   TUASSERTE(uint8_t, 0, uut.status[2]);
+   TUASSERTFE(1.0, uut.x[1]);
+   TUASSERTFE(2.0, uut.y[1]);
+   TUASSERTFE(3.0, uut.z[1]);
+   TUASSERTFE(4.0, uut.vx[1]);
+   TUASSERTFE(5.0, uut.vy[1]);
+   TUASSERTFE(6.0, uut.vz[1]);
+   TUASSERTFE(7.0, uut.clkbias[1]);
+   TUASSERTFE(8.0, uut.clkdrift[1]);
+   TUASSERTFE(9.0, uut.relcorr[1]);
+   TUASSERTE(gnsstk::RefFrame, xvt.frame, uut.frame[1]);
+   TUASSERTE(gnsstk::Xvt::HealthStatus, gnsstk::Xvt::Degraded,
+             uut.health[1]);
+   TUASSERT(uut.getXvt(1, got));
+   TUASSERT(same(uut, 1, true, xvt));
+      // resize resets the status
+   uut.resize(2);
+   TUASSERTE(size_t, 2, uut.size());
+   TUASSERTE(uint8_t, 0, uut.status[1]);
+   TUASSERT(!uut.getXvt(1, got));
+   TURETURN();
+}
+
+
+unsigned NavLibraryBatch_T ::
+getXvtSatsTest()
+{
+   TUDEF("NavLibrary", "getXvt(sats)");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   navLib.addFactory(ndfp);
+   fill(*fact);
+   gnsstk::XvtBatch batch;
+      // check both with and without the flat index
+   for (unsigned pass = 0; pass < 2; pass++)
+   {
+      if (pass == 1)
+      {
+         navLib.compact();
+      }
+      size_t total = 0;
+      for (const auto& when : times)
+      {
+         for (auto health : {gnsstk::SVHealth::Any,
+                             gnsstk::SVHealth::Healthy})
+         {
+            size_t expCount = 0;
+            size_t count = navLib.getXvt(sats, when, batch, false, health);
+            TUASSERTE(size_t, sats.size(), batch.size());
+            for (size_t i = 0; i < sats.size(); i++)
+            {
+               gnsstk::Xvt exp;
+               bool expOK = navLib.getXvt(sats[i], when, exp, false, health);
+               expCount += expOK;
+               TUASSERT(same(batch, i, expOK, exp));
+            }
+            TUASSERTE(size_t, expCount, count);
+            total += count;
+         }
+      }
+         // make sure there's something to compare
+      TUASSERT(total > 0);
+   }
+      // no almanac data, so nothing should be found
+   TUASSERTE(size_t, 0, navLib.getXvt(sats, t0 + 9000.0, batch, true));
+   TUASSERTE(size_t, sats.size(), batch.size());
+      // empty request
+   std::vector<gnsstk::NavSatelliteID> none;
+   TUASSERTE(size_t, 0, navLib.getXvt(none, t0 + 9000.0, batch, false));
+   TUASSERTE(size_t, 0, batch.size());
+   TURETURN();
+}
+
+
+unsigned NavLibraryBatch_T ::
+getXvtTimesTest()
+{
+   TUDEF("NavLibrary", "getXvt(times)");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   navLib.addFactory(ndfp);
+   fill(*fact);
+   navLib.compact();
+   gnsstk::XvtBatch batch;
+   size_t total = 0;
+   for (const auto& sat : sats)
+   {
+      size_t expCount = 0;
+      size_t count = navLib.getXvt(sat, times, batch, false);
+      TUASSERTE(size_t, times.size(), batch.size());
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         gnsstk::Xvt exp;
+         bool expOK = navLib.getXvt(sat, times[i], exp, false);
+         expCount += expOK;
+         TUASSERT(same(batch, i, expOK, exp));
+      }
+      TUASSERTE(size_t, expCount, count);
+      total += count;
+   }
+   TUASSERT(total > 0);
+   TUASSERT(total < sats.size() * times.size());
+   TURETURN();
+}
+
+
+unsigned NavLibraryBatch_T ::
+getXvtGapsTest()
+{
+   TUDEF("NavLibrary", "getXvt(sats)");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   navLib.addFactory(ndfp);
+   fill(*fact, true);
+   navLib.compact();
+   gnsstk::XvtBatch batch;
+   std::vector<gnsstk::NavSatelliteID> reversed(sats.rbegin(), sats.rend());
+   unsigned gapMisses = 0;
+   size_t epoch = 0;
+   for (auto order : {gnsstk::NavSearchOrder::User,
+                      gnsstk::NavSearchOrder::Nearest})
+   {
+      for (const auto& when : times)
+      {
+            // alternate the order of the satellites so the search
+            // state in batch is never for the same satellite.
+         const std::vector<gnsstk::NavSatelliteID>& req(
+            (epoch++ & 1) ? reversed : sats);
+         size_t count = navLib.getXvt(req, when, batch, false,
+                                      gnsstk::SVHealth::Any,
+                                      gnsstk::NavValidityType::ValidOnly,
+                                      order);
+         size_t expCount = 0;
+         for (size_t i = 0; i < req.size(); i++)
+         {
+            gnsstk::Xvt exp;
+            bool expOK = navLib.getXvt(req[i], when, exp, false,
+                                       gnsstk::SVHealth::Any,
+                                       gnsstk::NavValidityType::ValidOnly,
+                                       order);
+            expCount += expOK;
+            TUASSERT(same(batch, i, expOK, exp));
+            if (!expOK && (req[i].sat.id == gapPRN) &&
+                (when > gapBegin) && (when < gapEnd))
+            {
+               gapMisses++;
+            }
+         }
+         TUASSERTE(size_t, expCount, count);
+      }
+         // times batch, going through the gap and then back again
+      gnsstk::NavSatelliteID gapSat(sats[gapPRN-1]);
+      for (const auto& req : {times, std::vector<gnsstk::CommonTime>(
+                                 times.rbegin(), times.rend())})
+      {
+         size_t count = navLib.getXvt(gapSat, req, batch, false,
+                                      gnsstk::SVHealth::Any,
+                                      gnsstk::NavValidityType::ValidOnly,
+                                      order);
+         size_t expCount = 0;
+         for (size_t i = 0; i < req.size(); i++)
+         {
+            gnsstk::Xvt exp;
+            bool expOK = navLib.getXvt(gapSat, req[i], exp, false,
+                                       gnsstk::SVHealth::Any,
+                                       gnsstk::NavValidityType::ValidOnly,
+                                       order);
+            expCount += expOK;
+            TUASSERT(same(batch, i, expOK, exp));
+         }
+         TUASSERTE(size_t, expCount, count);
+      }
+   }
+      // The User search must miss in the gap, where the latest
+      // ephemeris is out of its fit interval.
+   TUASSERT(gapMisses > 0);
+   gnsstk::CommonTime inGap(gapBegin + 3600.0);
+   TUASSERT(navLib.getXvt(sats, inGap, batch, false) > 0);
+   TUASSERTE(uint8_t, 0, batch.status[gapPRN-1]);
+   TUASSERT(batch.status[gapPRN] != 0);
+   TURETURN();
+}
+
+
+int main()
+{
+   NavLibraryBatch_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.xvtBatchTest();
+   errorTotal += testClass.getXvtSatsTest();
+   errorTotal += testClass.getXvtTimesTest();
+   errorTotal += testClass.getXvtGapsTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
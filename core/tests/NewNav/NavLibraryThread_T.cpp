@@ -0,0 +1,424 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "NavLibrary.hpp"
+#include "RinexNavDataFactory.hpp"
+#include "SP3NavDataFactory.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "NewNavToRinex.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "SP3Data.hpp"
+#include "CivilTime.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+
+/// Expected results of a single query, computed before freezing.
+struct QueryResult
+{
+   QueryResult()
+         : xvtOK(false), healthOK(false), health(gnsstk::SVHealth::Unknown)
+   {}
+   bool xvtOK;
+   gnsstk::Triple x;
+   bool healthOK;
+   gnsstk::SVHealth health;
+};
+
+
+class NavLibraryThread_T : public SyntheticNavData
+{
+public:
+      /// Test freeze()/thaw() and the rejection of modifications.
+   unsigned freezeTest();
+      /** Search a frozen NavLibrary from several threads at once,
+       * making sure the results match those of a single thread.
+       * This is most useful when built with THREAD_SANITIZER=ON. */
+   unsigned concurrentTest();
+      /** Search frozen NavLibrary objects using RinexNavDataFactory,
+       * SP3NavDataFactory and MultiFormatNavDataFactory from several
+       * threads at once. */
+   unsigned concurrentFileTest();
+
+      /** Run the queries in the test grid, storing the results in rv.
+       * @param[in] qsats The satellites to query, sats by default. */
+   void query(gnsstk::NavLibrary& navLib, std::vector<QueryResult>& rv,
+              const std::vector<gnsstk::NavSatelliteID>& qsats);
+      /** Run the queries in the test grid nloop times, counting the
+       * results that don't match expected in errors. */
+   void worker(gnsstk::NavLibrary& navLib,
+               const std::vector<QueryResult>& expected,
+               const std::vector<gnsstk::NavSatelliteID>& qsats,
+               unsigned nloop, unsigned& errors);
+      /** Freeze navLib, run worker() in several threads and check
+       * that each matches the results of the unfrozen library.
+       * @return the number of test failures. */
+   unsigned runThreads(gnsstk::TestUtil& testFramework,
+                       gnsstk::NavLibrary& navLib,
+                       const std::vector<gnsstk::NavSatelliteID>& qsats);
+      /// Write the ephemerides loaded by fill() as a RINEX 3 nav file.
+   void writeRinex(const std::string& fn);
+      /// Write the orbits of the data loaded by fill() as an SP3 file.
+   void writeSP3(const std::string& fn);
+};
+
+
+void NavLibraryThread_T ::
+query(gnsstk::NavLibrary& navLib, std::vector<QueryResult>& rv,
+      const std::vector<gnsstk::NavSatelliteID>& qsats)
+{
+   rv.resize(qsats.size() * times.size());
+   unsigned idx = 0;
+   for (const auto& sat : qsats)
+   {
+      for (const auto& when : times)
+      {
+         gnsstk::Xvt xvt;
+         QueryResult& qr(rv[idx++]);
+         qr.xvtOK = navLib.getXvt(sat, when, xvt, false,
+                                  gnsstk::SVHealth::Healthy);
+         if (qr.xvtOK)
+         {
+            qr.x = xvt.x;
+         }
+         qr.healthOK = navLib.getHealth(sat, when, qr.health);
+      }
+   }
+}
+
+
+void NavLibraryThread_T ::
+worker(gnsstk::NavLibrary& navLib, const std::vector<QueryResult>& expected,
+       const std::vector<gnsstk::NavSatelliteID>& qsats,
+       unsigned nloop, unsigned& errors)
+{
+   std::vector<QueryResult> got;
+   errors = 0;
+   for (unsigned loop = 0; loop < nloop; loop++)
+   {
+      query(navLib, got, qsats);
+      for (unsigned i = 0; i < got.size(); i++)
+      {
+         if ((got[i].xvtOK != expected[i].xvtOK) ||
+             (got[i].xvtOK && !(got[i].x == expected[i].x)) ||
+             (got[i].healthOK != expected[i].healthOK) ||
+             (got[i].health != expected[i].health))
+         {
+            errors++;
+         }
+      }
+   }
+}
+
+
+unsigned NavLibraryThread_T ::
+freezeTest()
+{
+   TUDEF("NavLibrary", "freeze");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   gnsstk::CommonTime tEnd(t0 + 86400.0);
+   navLib.addFactory(ndfp);
+   fill(*fact);
+   size_t count = fact->size();
+   TUASSERT(count > 0);
+   TUASSERT(!navLib.isFrozen());
+   TUASSERT(!fact->isFrozen());
+   TUCATCH(navLib.freeze());
+   TUASSERT(navLib.isFrozen());
+   TUASSERT(fact->isFrozen());
+   TUASSERT(fact->isCompact());
+      // modifications via the library
+   TUTHROW(navLib.edit(t0, tEnd));
+   TUTHROW(navLib.edit(t0, tEnd, sats[0]));
+   TUTHROW(navLib.edit(t0, tEnd, gnsstk::NavSignalID(sats[0])));
+   TUTHROW(navLib.clear());
+   TUTHROW(navLib.addFactory(ndfp));
+   TUTHROW(navLib.setValidityFilter(gnsstk::NavValidityType::Any));
+   TUTHROW(navLib.setTypeFilter({gnsstk::NavMessageType::Ephemeris}));
+   TUTHROW(navLib.clearTypeFilter());
+   TUTHROW(navLib.addTypeFilter(gnsstk::NavMessageType::Health));
+      // modifications via the factory
+   TUTHROW(fact->edit(t0, tEnd));
+   TUTHROW(fact->edit(t0, tEnd, sats[0]));
+   TUTHROW(fact->clear());
+   TUASSERT(!fact->addNavData(makeEph(numPRN+1, t0 + 7200.0)));
+   TUASSERT(!fact->addDataSource("nonexistent"));
+      // nothing should have changed, including the index.
+   TUASSERTE(size_t, count, fact->size());
+   TUASSERT(fact->isCompact());
+   gnsstk::Xvt xvt;
+   TUASSERT(navLib.getXvt(sats[0], t0 + 9000.0, xvt, false));
+      // compact() is harmless while frozen
+   TUCATCH(navLib.compact());
+   TUASSERT(fact->isCompact());
+      // back to normal
+   TUCATCH(navLib.thaw());
+   TUASSERT(!navLib.isFrozen());
+   TUASSERT(!fact->isFrozen());
+   TUASSERT(fact->addNavData(makeEph(numPRN+1, t0 + 7200.0)));
+   TUASSERTE(size_t, count+1, fact->size());
+   TUASSERT(!fact->isCompact());
+   TUCATCH(navLib.edit(t0, tEnd, sats[numPRN]));
+   TUASSERTE(size_t, count, fact->size());
+   TUCATCH(navLib.clear());
+   TUASSERTE(size_t, 0, fact->size());
+   TURETURN();
+}
+
+
+unsigned NavLibraryThread_T ::
+runThreads(gnsstk::TestUtil& testFramework, gnsstk::NavLibrary& navLib,
+           const std::vector<gnsstk::NavSatelliteID>& qsats)
+{
+   const unsigned numThreads = 8;
+   const unsigned numLoops = 4;
+   unsigned failBefore = testFramework.countFails();
+      // Get the expected results from the unfrozen library
+   std::vector<QueryResult> expected;
+   query(navLib, expected, qsats);
+      // make sure the test covers both successful and failed queries
+   unsigned numXvt = 0;
+   for (const auto& qr : expected)
+   {
+      numXvt += qr.xvtOK;
+   }
+   TUASSERT(numXvt > 0);
+   TUASSERT(numXvt < expected.size());
+   TUCATCH(navLib.freeze());
+   std::vector<unsigned> errors(numThreads, 0);
+   std::vector<std::thread> threads;
+   for (unsigned i = 0; i < numThreads; i++)
+   {
+      threads.push_back(std::thread(&NavLibraryThread_T::worker, this,
+                                    std::ref(navLib), std::cref(expected),
+                                    std::cref(qsats), numLoops,
+                                    std::ref(errors[i])));
+   }
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+   for (unsigned i = 0; i < numThreads; i++)
+   {
+      TUASSERTE(unsigned, 0, errors[i]);
+   }
+   TUCATCH(navLib.thaw());
+   return testFramework.countFails() - failBefore;
+}
+
+
+unsigned NavLibraryThread_T ::
+concurrentTest()
+{
+   TUDEF("NavLibrary", "getXvt");
+   gnsstk::NavLibrary navLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   navLib.addFactory(ndfp);
+   fill(*fact);
+      // make sure the test covers healthy and unhealthy satellites
+   std::vector<QueryResult> expected;
+   query(navLib, expected, sats);
+   unsigned numXvt = 0, numHealth = 0, numUnhealthy = 0;
+   for (const auto& qr : expected)
+   {
+      numXvt += qr.xvtOK;
+      numHealth += qr.healthOK;
+      numUnhealthy += (qr.health == gnsstk::SVHealth::Unhealthy);
+   }
+   TUASSERT(numHealth > numXvt);
+   TUASSERT(numUnhealthy > 0);
+   runThreads(testFramework, navLib, sats);
+   TURETURN();
+}
+
+
+void NavLibraryThread_T ::
+writeRinex(const std::string& fn)
+{
+      // the same ephemerides as fill()
+   gnsstk::NavDataPtrList navData;
+   for (unsigned i = 0; i < 12; i++)
+   {
+      for (unsigned long prn = 1; prn <= numPRN; prn++)
+      {
+         navData.push_back(makeEph(prn, t0 + 7200.0 * (i+1)));
+      }
+   }
+   gnsstk::NewNavToRinex writer;
+   gnsstk::HealthGetter noHealth;
+   writer.header.version = 3.04;
+   writer.header.fileType = "NAVIGATION";
+   writer.header.fileProgram = "NavLibraryThread_T";
+   writer.header.fileAgency = "gnsstk";
+   writer.header.date =
+      gnsstk::CivilTime(t0).printf("%04Y%02m%02d %02H%02M%02S UTC");
+   writer.header.valid = gnsstk::Rinex3NavHeader::validVersion |
+      gnsstk::Rinex3NavHeader::validRunBy | gnsstk::Rinex3NavHeader::validEoH;
+   if (!writer.translate(navData, noHealth) || !writer.write(fn))
+   {
+      GNSSTK_THROW(gnsstk::Exception("Unable to write " + fn));
+   }
+}
+
+
+void NavLibraryThread_T ::
+writeSP3(const std::string& fn)
+{
+   const double interval = 900.0;
+   gnsstk::SP3Stream strm(fn.c_str(), std::ios::out);
+   gnsstk::SP3Header head;
+   head.version = gnsstk::SP3Header::SP3c;
+   head.containsVelocity = false;
+   head.time = t0;
+   head.epochInterval = interval;
+   head.numberOfEpochs = 96;
+   head.dataUsed = "ORBIT";
+   head.coordSystem = "IGS14";
+   head.orbitType = "FIT";
+   head.agency = "TEST";
+   head.system = gnsstk::SP3SatID(-1, gnsstk::SatelliteSystem::GPS);
+   head.timeSystem = gnsstk::TimeSystem::GPS;
+   for (unsigned long prn = 1; prn <= numPRN; prn++)
+   {
+      head.satList[gnsstk::SP3SatID(prn, gnsstk::SatelliteSystem::GPS)] = 0;
+   }
+   strm << head;
+   for (int epoch = 0; epoch < head.numberOfEpochs; epoch++)
+   {
+      gnsstk::SP3Data data;
+      data.time = t0 + epoch * interval;
+      data.RecType = '*';
+      strm << data;
+      data.RecType = 'P';
+      for (unsigned long prn = 1; prn <= numPRN; prn++)
+      {
+            // use the ephemeris that fill() would have in effect
+         double toeOffs = 7200.0 * (1 + floor(epoch * interval / 7200.0));
+         gnsstk::NavDataPtr ndp = makeEph(prn, t0 + toeOffs);
+         gnsstk::Xvt xvt;
+         dynamic_cast<gnsstk::OrbitDataKepler*>(ndp.get())->getXvt(
+            data.time, xvt);
+         data.sat = gnsstk::SP3SatID(prn, gnsstk::SatelliteSystem::GPS);
+         data.x[0] = xvt.x[0] / 1000.0;
+         data.x[1] = xvt.x[1] / 1000.0;
+         data.x[2] = xvt.x[2] / 1000.0;
+         data.clk = xvt.clkbias * 1e6;
+         strm << data;
+      }
+   }
+   strm.close();
+   if (!strm)
+   {
+      GNSSTK_THROW(gnsstk::Exception("Unable to write " + fn));
+   }
+}
+
+
+unsigned NavLibraryThread_T ::
+concurrentFileTest()
+{
+   TUDEF("NavLibrary", "getXvt");
+   std::string dir = gnsstk::getPathTestTemp() + gnsstk::getFileSep();
+   std::string rinexFile = dir + "test_output_NavLibraryThread.rnx";
+   std::string sp3File = dir + "test_output_NavLibraryThread.sp3";
+   TUCATCH(writeRinex(rinexFile));
+   TUCATCH(writeSP3(sp3File));
+      // SP3 data isn't specific to a signal
+   std::vector<gnsstk::NavSatelliteID> sp3Sats;
+   for (const auto& sat : sats)
+   {
+      sp3Sats.push_back(gnsstk::NavSatelliteID(sat.sat));
+   }
+   {
+      TUCSM("getXvt(RinexNavDataFactory)");
+      gnsstk::NavLibrary navLib;
+      gnsstk::NavDataFactoryPtr ndfp(
+         std::make_shared<gnsstk::RinexNavDataFactory>());
+      navLib.addFactory(ndfp);
+      TUASSERT(ndfp->addDataSource(rinexFile));
+      runThreads(testFramework, navLib, sats);
+   }
+   {
+      TUCSM("getXvt(SP3NavDataFactory)");
+      gnsstk::NavLibrary navLib;
+      gnsstk::NavDataFactoryPtr ndfp(
+         std::make_shared<gnsstk::SP3NavDataFactory>());
+      navLib.addFactory(ndfp);
+      TUASSERT(ndfp->addDataSource(sp3File));
+      runThreads(testFramework, navLib, sp3Sats);
+   }
+   {
+      TUCSM("getXvt(MultiFormatNavDataFactory)");
+      gnsstk::NavLibrary navLib;
+      gnsstk::NavDataFactoryPtr ndfp(
+         std::make_shared<gnsstk::MultiFormatNavDataFactory>());
+      navLib.addFactory(ndfp);
+      TUASSERT(ndfp->addDataSource(rinexFile));
+      TUASSERT(ndfp->addDataSource(sp3File));
+      runThreads(testFramework, navLib, sats);
+      runThreads(testFramework, navLib, sp3Sats);
+      TUCATCH(ndfp->clear());
+   }
+   std::remove(rinexFile.c_str());
+   std::remove(sp3File.c_str());
+   TURETURN();
+}
+
+
+int main()
+{
+   NavLibraryThread_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.freezeTest();
+   errorTotal += testClass.concurrentTest();
+   errorTotal += testClass.concurrentFileTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
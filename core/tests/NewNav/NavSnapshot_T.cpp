@@ -0,0 +1,475 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include "NavSnapshot.hpp"
+#include "MultiFormatNavDataFactory.hpp"
+#include "RinexNavDataFactory.hpp"
+#include "NewNavToRinex.hpp"
+#include "GPSLNavAlm.hpp"
+#include "GPSLNavISC.hpp"
+#include "GPSLNavIono.hpp"
+#include "GPSNavConfig.hpp"
+#include "GalINavEph.hpp"
+#include "GalFNavEph.hpp"
+#include "GalINavHealth.hpp"
+#include "GalFNavHealth.hpp"
+#include "GalINavISC.hpp"
+#include "GalINavIono.hpp"
+#include "BDSD1NavEph.hpp"
+#include "BDSD1NavHealth.hpp"
+#include "BDSD1NavIono.hpp"
+#include "BDSD1NavISC.hpp"
+#include "BDSD2NavEph.hpp"
+#include "BDSD2NavHealth.hpp"
+#include "BDSD2NavISC.hpp"
+#include "GLOFNavEph.hpp"
+#include "GLOFNavHealth.hpp"
+#include "RinexTimeOffset.hpp"
+#include "OrbitDataSP3.hpp"
+#include "GPSCNavEph.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+#include "build_config.h"
+
+   /** Implement a test class to expose protected members rather than
+    * using friends. */
+class TestClass : public SyntheticNavFactory
+{
+public:
+      /// Grant access to protected data.
+   gnsstk::NavMessageMap& getData()
+   { return data; }
+      /// Grant access to protected data.
+   gnsstk::NavNearMessageMap& getNearestData()
+   { return nearestData; }
+};
+
+
+/// Automated tests for gnsstk::NavSnapshot
+class NavSnapshot_T
+{
+public:
+   NavSnapshot_T();
+      /// Make sure each supported type survives encoding and decoding.
+   unsigned encodeDecodeTest();
+      /// Make sure unsupported, truncated and unknown records fail.
+   unsigned encodeDecodeFailTest();
+      /// Write and read back a store.
+   unsigned storeTest();
+      /// Make sure bad files and frozen stores leave the store unchanged.
+   unsigned readFailTest();
+      /// Write and read back RINEX data through MultiFormatNavDataFactory.
+   unsigned multiFormatTest();
+
+      /** Encode nd, decode the result and check that the decoded
+       * record is the same type and encodes identically.
+       * @return The decoded record. */
+   gnsstk::NavDataPtr roundTrip(gnsstk::TestUtil& testFramework,
+                                const gnsstk::NavDataPtr& nd);
+      /// Dump the user and nearest maps of a store.
+   static std::string dumpStore(TestClass& fact);
+      /// Dump the results of User searches over the synthetic grid.
+   std::string dumpFinds(gnsstk::NavDataFactory& fact);
+      /// Get a path in the test output directory.
+   static std::string tempFile(const std::string& name);
+
+   SyntheticNavData synth;
+};
+
+
+NavSnapshot_T ::
+NavSnapshot_T()
+{
+}
+
+
+std::string NavSnapshot_T ::
+tempFile(const std::string& name)
+{
+   return gnsstk::getPathTestTemp() + gnsstk::getFileSep() +
+      "NavSnapshot_T_" + name;
+}
+
+
+gnsstk::NavDataPtr NavSnapshot_T ::
+roundTrip(gnsstk::TestUtil& testFramework, const gnsstk::NavDataPtr& nd)
+{
+   std::string buf1, buf2;
+   size_t used = 0;
+   TUASSERT(gnsstk::NavSnapshot::encode(*nd, buf1));
+   TUASSERTE(size_t, 0, buf1.size() % 8);
+   gnsstk::NavDataPtr rv = gnsstk::NavSnapshot::decode(buf1.data(),
+                                                       buf1.size(), used);
+   TUASSERT(rv != nullptr);
+   if (rv == nullptr)
+      return rv;
+   TUASSERTE(size_t, buf1.size(), used);
+   TUASSERTE(std::string, nd->getClassName(), rv->getClassName());
+   TUASSERT(gnsstk::NavSnapshot::encode(*rv, buf2));
+   TUASSERTE(std::string, buf1, buf2);
+   TUASSERTE(gnsstk::CommonTime, nd->timeStamp, rv->timeStamp);
+   TUASSERTE(gnsstk::NavMessageID, nd->signal, rv->signal);
+   return rv;
+}
+
+
+std::string NavSnapshot_T ::
+dumpStore(TestClass& fact)
+{
+   std::ostringstream s;
+   for (const auto& mti : fact.getData())
+   {
+      for (const auto& sati : mti.second)
+      {
+         for (const auto& ti : sati.second)
+         {
+            s << ti.first << " ";
+            ti.second->dump(s, gnsstk::DumpDetail::Full);
+         }
+      }
+   }
+   for (const auto& mti : fact.getNearestData())
+   {
+      for (const auto& sati : mti.second)
+      {
+         for (const auto& ti : sati.second)
+         {
+            s << ti.first << " " << ti.second.size() << std::endl;
+         }
+      }
+   }
+   return s.str();
+}
+
+
+std::string NavSnapshot_T ::
+dumpFinds(gnsstk::NavDataFactory& fact)
+{
+   std::ostringstream s;
+   gnsstk::NavDataPtr ndp;
+   for (const auto& sat : synth.sats)
+   {
+      gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+      for (const auto& when : synth.times)
+      {
+         if (fact.find(nmid, when, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User))
+         {
+            ndp->dump(s, gnsstk::DumpDetail::Full);
+         }
+         else
+         {
+            s << "not found" << std::endl;
+         }
+      }
+   }
+   return s.str();
+}
+
+
+unsigned NavSnapshot_T ::
+encodeDecodeTest()
+{
+   TUDEF("NavSnapshot", "encode");
+   gnsstk::CommonTime t1 = synth.t0 + 3600.0;
+   gnsstk::NavDataPtr ndp;
+      // LNav ephemeris with all the Kepler fields set.
+   ndp = roundTrip(testFramework, synth.makeEph(1, t1));
+   std::shared_ptr<gnsstk::GPSLNavEph> lnav =
+      std::dynamic_pointer_cast<gnsstk::GPSLNavEph>(ndp);
+   TUASSERT(lnav != nullptr);
+   TUASSERTFE(.515360180473e+04, lnav->Ahalf);
+   TUASSERTE(gnsstk::CommonTime, t1, lnav->Toe);
+   TUASSERTE(gnsstk::CommonTime, t1 - 7200.0 + 12.0, lnav->xmit3);
+   ndp = roundTrip(testFramework, synth.makeHealth(2, t1));
+   TUASSERT(std::dynamic_pointer_cast<gnsstk::GPSLNavHealth>(ndp) != nullptr);
+      // Fields with types needing special handling.
+   std::shared_ptr<gnsstk::GLOFNavHealth> gloh =
+      std::make_shared<gnsstk::GLOFNavHealth>();
+   gloh->timeStamp = t1;
+   gloh->healthBits = 5;
+   gloh->Cn = true;
+   ndp = roundTrip(testFramework, gloh);
+   gloh = std::dynamic_pointer_cast<gnsstk::GLOFNavHealth>(ndp);
+   TUASSERT(gloh != nullptr);
+   TUASSERTE(bool, true, gloh->healthBits.is_valid());
+   TUASSERTE(unsigned, 5, gloh->healthBits.get_value());
+   TUASSERTE(bool, false, gloh->ln.is_valid());
+   TUASSERTE(bool, true, gloh->Cn.get_value());
+   std::shared_ptr<gnsstk::OrbitDataSP3> sp3 =
+      std::make_shared<gnsstk::OrbitDataSP3>();
+   sp3->timeStamp = t1;
+   sp3->pos = gnsstk::Triple(1.5, -2.5, 3.5);
+   sp3->clkBias = 12.25;
+   sp3->coordSystem = "IGS14";
+   sp3->frame = gnsstk::RefFrame(gnsstk::RefFrameRlz::ITRF2014);
+   ndp = roundTrip(testFramework, sp3);
+   sp3 = std::dynamic_pointer_cast<gnsstk::OrbitDataSP3>(ndp);
+   TUASSERT(sp3 != nullptr);
+   TUASSERTE(gnsstk::Triple, gnsstk::Triple(1.5, -2.5, 3.5), sp3->pos);
+   TUASSERTFE(12.25, sp3->clkBias);
+   TUASSERTE(std::string, "IGS14", sp3->coordSystem);
+   TUASSERTE(gnsstk::RefFrame, gnsstk::RefFrame(gnsstk::RefFrameRlz::ITRF2014),
+             sp3->frame);
+   gnsstk::TimeSystemCorrection tsc("GPUT");
+   tsc.A0 = 1e-9;
+   tsc.refTime = t1;
+   tsc.geoProvider = "WAAS";
+   std::shared_ptr<gnsstk::RinexTimeOffset> rto =
+      std::make_shared<gnsstk::RinexTimeOffset>(tsc, 18);
+   ndp = roundTrip(testFramework, rto);
+   rto = std::dynamic_pointer_cast<gnsstk::RinexTimeOffset>(ndp);
+   TUASSERT(rto != nullptr);
+   TUASSERTE(gnsstk::TimeSystem, gnsstk::TimeSystem::GPS, rto->frTS);
+   TUASSERTFE(1e-9, rto->A0);
+   TUASSERTE(std::string, "WAAS", rto->geoProvider);
+   TUASSERTFE(18, rto->deltatLS);
+   std::shared_ptr<gnsstk::GalINavIono> gali =
+      std::make_shared<gnsstk::GalINavIono>();
+   gali->ai[1] = 0.25;
+   gali->idf[3] = true;
+   ndp = roundTrip(testFramework, gali);
+   gali = std::dynamic_pointer_cast<gnsstk::GalINavIono>(ndp);
+   TUASSERT(gali != nullptr);
+   TUASSERTFE(0.25, gali->ai[1]);
+   TUASSERTE(bool, true, gali->idf[3]);
+      // The remaining types, default constructed.
+   gnsstk::NavDataPtrList others {
+      std::make_shared<gnsstk::GPSLNavAlm>(),
+      std::make_shared<gnsstk::GPSLNavISC>(),
+      std::make_shared<gnsstk::GPSLNavIono>(),
+      std::make_shared<gnsstk::GPSNavConfig>(),
+      std::make_shared<gnsstk::GalINavEph>(),
+      std::make_shared<gnsstk::GalFNavEph>(),
+      std::make_shared<gnsstk::GalINavHealth>(),
+      std::make_shared<gnsstk::GalFNavHealth>(),
+      std::make_shared<gnsstk::GalINavISC>(),
+      std::make_shared<gnsstk::BDSD1NavEph>(),
+      std::make_shared<gnsstk::BDSD1NavHealth>(),
+      std::make_shared<gnsstk::BDSD1NavIono>(),
+      std::make_shared<gnsstk::BDSD1NavISC>(),
+      std::make_shared<gnsstk::BDSD2NavEph>(),
+      std::make_shared<gnsstk::BDSD2NavHealth>(),
+      std::make_shared<gnsstk::BDSD2NavISC>(),
+      std::make_shared<gnsstk::GLOFNavEph>() };
+   for (const auto& other : others)
+   {
+      other->timeStamp = t1;
+      roundTrip(testFramework, other);
+   }
+   TURETURN();
+}
+
+
+unsigned NavSnapshot_T ::
+encodeDecodeFailTest()
+{
+   TUDEF("NavSnapshot", "decode");
+   std::string buf("x");
+   size_t used = 0;
+   gnsstk::GPSCNavEph cnav;
+   TUASSERTE(bool, false, gnsstk::NavSnapshot::encode(cnav, buf));
+   TUASSERTE(std::string, "x", buf);
+   buf.clear();
+   TUASSERT(gnsstk::NavSnapshot::encode(*synth.makeEph(1, synth.t0), buf));
+      // truncated
+   TUASSERT(gnsstk::NavSnapshot::decode(buf.data(), buf.size()-8, used) ==
+            nullptr);
+   TUASSERT(gnsstk::NavSnapshot::decode(buf.data(), 4, used) == nullptr);
+      // unknown type
+   buf[0] = 0x7f;
+   TUASSERT(gnsstk::NavSnapshot::decode(buf.data(), buf.size(), used) ==
+            nullptr);
+   TURETURN();
+}
+
+
+unsigned NavSnapshot_T ::
+storeTest()
+{
+   TUDEF("NavDataFactoryWithStore", "writeSnapshot");
+   std::string fn = tempFile("store.snap");
+   TestClass orig;
+   synth.fill(orig);
+      // A record replaced by another with the same user time is only
+      // kept in the nearest map.
+   gnsstk::NavDataPtr dup = synth.makeEph(3, synth.t0 + 7200.0);
+   std::dynamic_pointer_cast<gnsstk::GPSLNavEph>(dup)->af0 = 1e-4;
+   orig.addNavData(dup);
+      // Editing doesn't change the initial/final times, which should
+      // be kept by the snapshot.
+   orig.edit(synth.t0 + 43200.0, gnsstk::CommonTime::END_OF_TIME);
+   TUASSERT(orig.writeSnapshot(fn));
+   TestClass uut;
+   uut.setUseArena(true);
+   TUASSERT(uut.readSnapshot(fn));
+   TUASSERTE(size_t, orig.size(), uut.size());
+   TUASSERTE(std::string, dumpStore(orig), dumpStore(uut));
+   TUASSERTE(gnsstk::CommonTime, orig.getInitialTime(), uut.getInitialTime());
+   TUASSERTE(gnsstk::CommonTime, orig.getFinalTime(), uut.getFinalTime());
+   TUASSERTE(std::string, dumpFinds(orig), dumpFinds(uut));
+   TUASSERT(uut.getArena()->numChunks() > 0);
+      // empty store
+   TestClass empty1, empty2;
+   TUASSERT(empty1.writeSnapshot(fn));
+   TUASSERT(empty2.readSnapshot(fn));
+   TUASSERTE(size_t, 0, empty2.size());
+   TUASSERTE(gnsstk::CommonTime, empty1.getInitialTime(),
+             empty2.getInitialTime());
+   std::remove(fn.c_str());
+   TURETURN();
+}
+
+
+unsigned NavSnapshot_T ::
+readFailTest()
+{
+   TUDEF("NavDataFactoryWithStore", "readSnapshot");
+   std::string fn = tempFile("fail.snap");
+   std::string bad = tempFile("bad.snap");
+   std::string trunc = tempFile("trunc.snap");
+   TestClass orig;
+   synth.fill(orig);
+   TUASSERT(orig.writeSnapshot(fn));
+   TestClass uut;
+   TUASSERTE(bool, false, uut.readSnapshot(tempFile("missing")));
+   {
+      std::ofstream s(bad.c_str());
+      s << "This is not a snapshot file." << std::endl;
+   }
+   TUASSERTE(bool, false, uut.readSnapshot(bad));
+   {
+      std::ifstream in(fn.c_str(), std::ios::binary);
+      std::string contents((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+      std::ofstream out(trunc.c_str(), std::ios::binary);
+      out.write(contents.data(), contents.size() - 100);
+   }
+   TUASSERTE(bool, false, uut.readSnapshot(trunc));
+   TUASSERTE(size_t, 0, uut.size());
+      // different class of factory
+   gnsstk::RinexNavDataFactory rin;
+   TUASSERTE(bool, false, rin.readSnapshot(fn));
+   TUASSERTE(size_t, 0, rin.size());
+   uut.freeze();
+   TUASSERTE(bool, false, uut.readSnapshot(fn));
+   TUASSERTE(size_t, 0, uut.size());
+   uut.thaw();
+   TUASSERTE(bool, true, uut.readSnapshot(fn));
+   TUASSERTE(size_t, orig.size(), uut.size());
+      // unsupported data
+   TestClass unsup;
+   unsup.addNavData(std::make_shared<gnsstk::GPSCNavEph>());
+   TUASSERTE(bool, false, unsup.writeSnapshot(fn));
+   std::remove(fn.c_str());
+   std::remove(bad.c_str());
+   std::remove(trunc.c_str());
+   TURETURN();
+}
+
+
+unsigned NavSnapshot_T ::
+multiFormatTest()
+{
+   TUDEF("MultiFormatNavDataFactory", "readSnapshot");
+   std::string rnx = tempFile("nav.rnx");
+   std::string fn = tempFile("multi.snap");
+   gnsstk::NavDataPtrList navList;
+   for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+   {
+      for (unsigned i = 0; i < 12; i++)
+      {
+         navList.push_back(synth.makeEph(prn, synth.t0 + 7200.0 * (i+1)));
+      }
+   }
+   gnsstk::NewNavToRinex writer;
+   gnsstk::HealthGetter healthGet;
+   writer.header.version = 3.04;
+   writer.header.fileType = "N: GNSS NAV DATA";
+   writer.header.setFileSystem("G");
+   writer.header.fileProgram = "gnsstk test";
+   writer.header.fileAgency = "gnsstk";
+   writer.header.valid = gnsstk::Rinex3NavHeader::validVersion |
+      gnsstk::Rinex3NavHeader::validRunBy |
+      gnsstk::Rinex3NavHeader::validEoH;
+   TUASSERT(writer.translate(navList, healthGet));
+   TUASSERT(writer.write(rnx));
+   gnsstk::MultiFormatNavDataFactory uut;
+   TUASSERT(uut.addDataSource(rnx));
+   size_t expSize = uut.size();
+   std::string expFinds = dumpFinds(uut);
+   gnsstk::CommonTime expInitial = uut.getInitialTime();
+   TUASSERT(expSize > 0);
+   TUASSERT(uut.writeSnapshot(fn));
+   uut.clear();
+   TUASSERTE(size_t, 0, uut.size());
+   TUASSERT(uut.readSnapshot(fn));
+   TUASSERTE(size_t, expSize, uut.size());
+   TUASSERTE(std::string, expFinds, dumpFinds(uut));
+   TUASSERTE(gnsstk::CommonTime, expInitial, uut.getInitialTime());
+      // the snapshot isn't a RINEX file
+   uut.clear();
+   TUASSERTE(bool, false, uut.addDataSource(fn));
+   uut.clear();
+   std::remove(fn.c_str());
+   std::remove(rnx.c_str());
+   TURETURN();
+}
+
+
+int main()
+{
+   NavSnapshot_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.encodeDecodeTest();
+   errorTotal += testClass.encodeDecodeFailTest();
+   errorTotal += testClass.storeTest();
+   errorTotal += testClass.readFailTest();
+   errorTotal += testClass.multiFormatTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,1240 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/** @file NewNavBench.cpp Benchmarks for loading and searching
+ * navigation data using the NavFactory classes.  The input data are
+ * generated by this program, so the results depend only on the
+ * command-line options and the machine. */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include "BasicFramework.hpp"
+#include "RinexNavDataFactory.hpp"
+#include "SP3NavDataFactory.hpp"
+#include "NavLibrary.hpp"
+#include "NewNavToRinex.hpp"
+#include "PNBMultiGNSSNavDataFactory.hpp"
+#include "PNBNavDataPipeline.hpp"
+#include "GPSLNavEph.hpp"
+#include "GPSLNavTimeOffset.hpp"
+#include "BDSD1NavEph.hpp"
+#include "CRC24Q.hpp"
+#include "BDSBCH.hpp"
+#include "EngNav.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "SP3Data.hpp"
+#include "GPSWeekSecond.hpp"
+#include "CivilTime.hpp"
+#include "StringUtils.hpp"
+#include "build_config.h"
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace std;
+using namespace gnsstk;
+
+/// Return the size of the file fileName in bytes.
+static unsigned long long fileSize(const string& fileName)
+{
+   ifstream ifs(fileName.c_str(), ios::in | ios::binary | ios::ate);
+   return (ifs ? static_cast<unsigned long long>(ifs.tellg()) : 0);
+}
+
+/** Return the number of bytes of heap memory in use, including the
+ * allocator's overhead, or 0 if that isn't known on this platform. */
+static long long heapInUse()
+{
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2,33)
+   return static_cast<long long>(mallinfo2().uordblks);
+#endif
+#endif
+   return 0;
+}
+
+
+/// Time and throughput of one benchmark.
+class BenchResult
+{
+public:
+   BenchResult()
+         : count(0), hits(0), bytes(0), memory(0), best(0), total(0),
+           reps(0)
+   {}
+      /// Operations per second for the fastest repetition.
+   double perSecond() const
+   { return (best > 0 ? count / best : 0); }
+      /// Nanoseconds per operation for the fastest repetition.
+   double nsPerOp() const
+   { return (count > 0 ? best * 1e9 / count : 0); }
+      /// Input megabytes (1e6) per second for the fastest repetition.
+   double mbPerSecond() const
+   { return (best > 0 ? bytes / best / 1e6 : 0); }
+      /// Name of the benchmark, e.g. "load.rinex".
+   std::string name;
+      /// Number of operations (records, queries, messages) per repetition.
+   unsigned long count;
+      /// Number of successful searches per repetition, 0 if not a search.
+   unsigned long hits;
+      /// Number of input bytes per repetition, 0 if not applicable.
+   unsigned long long bytes;
+      /** Change in heap memory in use over the last repetition, 0
+       * if not measured. */
+   long long memory;
+      /// Time of the fastest repetition in seconds.
+   double best;
+      /// Total time of all repetitions in seconds.
+   double total;
+      /// Number of repetitions.
+   unsigned reps;
+};
+
+
+/// Discard decoded nav data, keeping a count.
+class CountCallback : public NavDataFactoryCallback
+{
+public:
+   CountCallback()
+         : count(0)
+   {}
+   bool process(const NavDataPtr& navOut) override
+   {
+      count++;
+      return true;
+   }
+   unsigned long count;
+};
+
+
+/** Benchmark the NavFactory load and search paths using
+ * deterministic synthetic data.  A multi-GNSS (GPS LNAV, QZSS LNAV
+ * and BeiDou D1 MEO) RINEX 3 nav file and a matching SP3c file
+ * spanning the requested number of days are written to a temporary
+ * directory, loaded and searched.  PackedNavBits decoding and LNAV
+ * parity checks use the LNAV unit test data, the CNAV CRC-24Q and
+ * BeiDou BCH checks use generated messages.  Loads that keep their
+ * data also report the heap memory it uses, where the platform can
+ * measure it.  Results are printed as a table and may be
+ * written as JSON, optionally compared with the JSON of an earlier
+ * run. */
+class NewNavBench : public BasicFramework
+{
+public:
+   NewNavBench(const string& applName);
+
+   bool initialize(int argc, char *argv[], bool pretty=true) noexcept override;
+
+   void process() override;
+
+      /// Generate the ephemerides, time offsets and search grid.
+   void generate();
+      /// Write the RINEX nav file.
+   void writeRinex();
+      /// Write the SP3 file using positions from the ephemerides.
+   void writeSP3();
+
+      /** Run func reps times, recording the fastest and total time.
+       * @param[in] name The name of the benchmark.
+       * @param[in] func The code to time, returning the number of
+       *   operations performed.
+       * @param[in] bytes Number of input bytes for each call of func.
+       * @param[in] setup If set, untimed code to call before each
+       *   call of func.
+       * @param[in] memory If true, report the change in heap
+       *   memory in use caused by func, which must keep the data
+       *   it loads until the next call of setup. */
+   void bench(const string& name, const std::function<unsigned long()>& func,
+              unsigned long long bytes = 0,
+              const std::function<void()>& setup = nullptr,
+              bool memory = false);
+
+      /// Benchmark loading and searching the RINEX nav data.
+   void benchRinex();
+      /** Benchmark loading, searching and clearing the RINEX nav
+       * data with records allocated individually or from an arena
+       * (see NavDataFactoryWithStore::setUseArena()).
+       * @param[in] arena If true, allocate the records from an arena.
+       * @param[in] suffix Appended to the name of each benchmark. */
+   void benchRinexStore(bool arena, const string& suffix);
+      /// Benchmark loading and searching the SP3 data.
+   void benchSP3();
+      /// Benchmark decoding PackedNavBits.
+   void benchPNB();
+      /// Benchmark CRC and parity checks of PackedNavBits.
+   void benchParity();
+
+      /// Print the results table.
+   void printResults(ostream& s);
+      /// Write the results as JSON, one result per line.
+   void writeJSON(ostream& s);
+      /// Compare the results with those in a JSON file from writeJSON().
+   bool compare(const string& fileName, ostream& s);
+
+      /// Make a GPS LNAV ephemeris.
+   NavDataPtr makeGPS(unsigned long prn, const CommonTime& toe, unsigned iod);
+      /// Make a QZSS LNAV ephemeris.
+   NavDataPtr makeQZSS(unsigned long prn, const CommonTime& toe, unsigned iod);
+      /// Make a BeiDou D1 (MEO) ephemeris.
+   NavDataPtr makeBDS(unsigned long prn, const CommonTime& toe, unsigned iod);
+      /// Fill the Keplerian elements common to all three systems.
+   void fillKepler(OrbitDataKepler& odk, unsigned long prn, double ahalf,
+                   double i0, unsigned orbits);
+      /// Copy pnb, changing the transmitting satellite to prn.
+   PackedNavBitsPtr makeMessage(const PackedNavBitsPtr& pnb, int prn);
+
+   CommandOptionWithDecimalArg daysOpt;
+   CommandOptionWithNumberArg repsOpt;
+   CommandOptionWithNumberArg stepOpt;
+   CommandOptionWithAnyArg dirOpt;
+   CommandOptionWithAnyArg jsonOpt;
+   CommandOptionWithAnyArg baseOpt;
+   CommandOptionNoArg keepOpt;
+
+      /// Number of days of data to generate.
+   double days;
+      /// Number of times to repeat each benchmark.
+   unsigned reps;
+      /// Spacing of the search times in seconds.
+   double step;
+      /// Start of the generated data.
+   CommonTime t0;
+      /// Generated ephemerides and time offsets, in time order.
+   NavDataPtrList navData;
+      /// Ephemerides of each satellite by Toe, for the SP3 file.
+   map<SatID, map<CommonTime, shared_ptr<OrbitDataKepler> > > orbits;
+      /// Satellites to search for, with the complete signal.
+   vector<NavSatelliteID> sats;
+      /// Times to search for, in the time system of each satellite.
+   map<SatelliteSystem, vector<CommonTime> > times;
+   string rinexFile, sp3File;
+   vector<BenchResult> results;
+      /// Successful searches in the repetition being timed.
+   unsigned long hits;
+
+#include "LNavTestDataDecl.hpp"
+};
+
+
+NewNavBench ::
+NewNavBench(const string& applName)
+      : BasicFramework(applName, "Benchmark loading and searching navigation"
+                       " data using synthetic inputs."),
+        daysOpt('D', "days", "Number of days of data to generate"
+                " (default 1, may be fractional)."),
+        repsOpt('r', "reps", "Number of repetitions of each benchmark;"
+                " the fastest is reported (default 3)."),
+        stepOpt('s', "step", "Seconds between search times (default 300)."),
+        dirOpt('t', "tmpdir", "Directory for the generated files (default"
+               " is the test temp directory)."),
+        jsonOpt('j', "json", "Write the results as JSON to this file."),
+        baseOpt('b', "baseline", "Compare the results with this JSON file"
+                " written by an earlier run."),
+        keepOpt('k', "keep", "Keep the generated files."),
+        days(1), reps(3), step(300), t0(GPSWeekSecond(2200, 0.0)), hits(0)
+{
+#include "LNavTestDataDef.hpp"
+   daysOpt.setMaxCount(1);
+   repsOpt.setMaxCount(1);
+   stepOpt.setMaxCount(1);
+   dirOpt.setMaxCount(1);
+   jsonOpt.setMaxCount(1);
+   baseOpt.setMaxCount(1);
+}
+
+
+bool NewNavBench ::
+initialize(int argc, char *argv[], bool pretty) noexcept
+{
+   if (!BasicFramework::initialize(argc, argv, pretty))
+   {
+      return false;
+   }
+   if (daysOpt.getCount())
+   {
+      days = StringUtils::asDouble(daysOpt.getValue()[0]);
+   }
+   if (repsOpt.getCount())
+   {
+      reps = StringUtils::asUnsigned(repsOpt.getValue()[0]);
+   }
+   if (stepOpt.getCount())
+   {
+      step = StringUtils::asDouble(stepOpt.getValue()[0]);
+   }
+   if ((days <= 0) || (reps == 0) || (step <= 0))
+   {
+      cerr << "The number of days, repetitions and the search step must be"
+           << " positive." << endl;
+      exitCode = BasicFramework::OPTION_ERROR;
+      return false;
+   }
+   string dir = (dirOpt.getCount() ? dirOpt.getValue()[0]
+                 : getPathTestTemp());
+   rinexFile = dir + getFileSep() + "NewNavBench.rnx";
+   sp3File = dir + getFileSep() + "NewNavBench.sp3";
+   return true;
+}
+
+
+void NewNavBench ::
+fillKepler(OrbitDataKepler& odk, unsigned long prn, double ahalf, double i0,
+           unsigned orbits)
+{
+   odk.Cuc = .200793147087e-05;
+   odk.Cus = .823289155960e-05;
+   odk.Crc = .214593750000e+03;
+   odk.Crs = .369375000000e+02;
+   odk.Cic = -.175088644028e-06;
+   odk.Cis = .335276126862e-07;
+      // spread the satellites over the planes and within each plane.
+   odk.M0 = fmod(2.0 * PI * (prn % orbits) / orbits + 0.7 * prn, 2.0 * PI);
+   odk.dn = .511592738462e-08;
+   odk.ecc = .422249664553e-02;
+   odk.Ahalf = ahalf;
+   odk.A = ahalf * ahalf;
+   odk.OMEGA0 = -PI + 2.0 * PI * (prn % 3) / 3.0;
+   odk.i0 = i0;
+   odk.w = .374892043461e+00;
+   odk.OMEGAdot = -.823034282681e-08;
+   odk.idot = .492877673191e-09;
+   odk.af0 = -.216379296035e-06 * prn;
+   odk.af1 = .432009983342e-11;
+}
+
+
+NavDataPtr NewNavBench ::
+makeGPS(unsigned long prn, const CommonTime& toe, unsigned iod)
+{
+   shared_ptr<GPSLNavEph> eph = makeNavData<GPSLNavEph>();
+   eph->signal = NavMessageID(
+      NavSatelliteID(prn, prn, SatelliteSystem::GPS, CarrierBand::L1,
+                     TrackingCode::CA, NavType::GPSLNAV),
+      NavMessageType::Ephemeris);
+   eph->xmitTime = toe - 7200.0;
+   eph->timeStamp = eph->xmitTime;
+   eph->Toe = toe;
+   eph->Toc = toe;
+   eph->health = SVHealth::Healthy;
+   fillKepler(*eph, prn, .515360180473e+04, .946122987969e+00, 8);
+   eph->xmit2 = eph->xmitTime + 6.0;
+   eph->xmit3 = eph->xmitTime + 12.0;
+   eph->iodc = iod & 0x3ff;
+   eph->iode = iod & 0xff;
+   eph->fitIntFlag = 0;
+   eph->fixFit();
+   return eph;
+}
+
+
+NavDataPtr NewNavBench ::
+makeQZSS(unsigned long prn, const CommonTime& toe, unsigned iod)
+{
+   shared_ptr<GPSLNavEph> eph = makeNavData<GPSLNavEph>();
+   eph->signal = NavMessageID(
+      NavSatelliteID(prn, prn, SatelliteSystem::QZSS, CarrierBand::L1,
+                     TrackingCode::CA, NavType::GPSLNAV),
+      NavMessageType::Ephemeris);
+   eph->xmitTime = toe - 3600.0;
+   eph->timeStamp = eph->xmitTime;
+   eph->Toe = toe;
+   eph->Toc = toe;
+   eph->health = SVHealth::Healthy;
+   fillKepler(*eph, prn, .649339e+04, .718e+00, 4);
+   eph->ecc = .075;
+   eph->xmit2 = eph->xmitTime + 6.0;
+   eph->xmit3 = eph->xmitTime + 12.0;
+   eph->iodc = iod & 0x3ff;
+   eph->iode = iod & 0xff;
+   eph->fitIntFlag = 0;
+   eph->fixFit();
+   return eph;
+}
+
+
+NavDataPtr NewNavBench ::
+makeBDS(unsigned long prn, const CommonTime& toe, unsigned iod)
+{
+   shared_ptr<BDSD1NavEph> eph = makeNavData<BDSD1NavEph>();
+   eph->signal = NavMessageID(
+      NavSatelliteID(prn, prn, SatelliteSystem::BeiDou, CarrierBand::B1,
+                     TrackingCode::B1I, NavType::BeiDou_D1),
+      NavMessageType::Ephemeris);
+   eph->xmitTime = toe;
+   eph->timeStamp = eph->xmitTime;
+   eph->Toe = toe;
+   eph->Toc = toe;
+   eph->health = SVHealth::Healthy;
+   fillKepler(*eph, prn, .528262e+04, .959931e+00, 8);
+   eph->xmit2 = eph->xmitTime + 6.0;
+   eph->xmit3 = eph->xmitTime + 12.0;
+   eph->aode = eph->aodc = iod % 25;
+   eph->satH1 = false;
+   eph->uraIndex = 2;
+   eph->tgd1 = 1.2e-9;
+   eph->tgd2 = -2.4e-9;
+   eph->fixFit();
+   return eph;
+}
+
+
+void NewNavBench ::
+generate()
+{
+   const unsigned numGPS = 32, numQZSS = 7, firstQZSS = 193, numBDS = 24,
+      firstBDS = 19;
+   double span = days * 86400.0;
+      // Ephemerides are issued every 2 hours for GPS and every hour
+      // for QZSS and BeiDou.
+   map<CommonTime, NavDataPtrList> byTime;
+   for (double sec = 0; sec < span; sec += 3600.0)
+   {
+      CommonTime gps(t0 + sec);
+      CommonTime qzs(gps), bds(gps);
+      qzs.setTimeSystem(TimeSystem::QZS);
+      bds.setTimeSystem(TimeSystem::BDT);
+      unsigned iod = static_cast<unsigned>(sec / 3600.0);
+      for (unsigned prn = firstQZSS; prn < firstQZSS + numQZSS; prn++)
+      {
+         byTime[gps].push_back(makeQZSS(prn, qzs + 3600.0, iod));
+      }
+      for (unsigned prn = firstBDS; prn < firstBDS + numBDS; prn++)
+      {
+         byTime[gps].push_back(makeBDS(prn, bds + 3600.0, iod));
+      }
+      if (fmod(sec, 7200.0) == 0)
+      {
+         for (unsigned prn = 1; prn <= numGPS; prn++)
+         {
+            byTime[gps].push_back(makeGPS(prn, gps + 7200.0, iod));
+         }
+      }
+   }
+   navData.clear();
+   orbits.clear();
+   shared_ptr<GPSLNavTimeOffset> to = make_shared<GPSLNavTimeOffset>();
+   to->signal = NavMessageID(
+      NavSatelliteID(1, 1, SatelliteSystem::GPS, CarrierBand::L1,
+                     TrackingCode::CA, NavType::GPSLNAV),
+      NavMessageType::TimeOffset);
+   to->timeStamp = t0;
+   to->src = TimeSystem::GPS;
+   to->tgt = TimeSystem::UTC;
+   to->a0 = 1.862645149231e-09;
+   to->a1 = 1.065814103640e-14;
+   to->deltatLS = 18;
+   to->deltatLSF = 18;
+   to->refTime = t0;
+   to->wnLSF = 1929;
+   to->dn = 7;
+   navData.push_back(to);
+   for (const auto& bti : byTime)
+   {
+      for (const auto& ndp : bti.second)
+      {
+         navData.push_back(ndp);
+         shared_ptr<OrbitDataKepler> odk =
+            dynamic_pointer_cast<OrbitDataKepler>(ndp);
+         orbits[odk->signal.sat][odk->Toe] = odk;
+      }
+   }
+   sats.clear();
+   times.clear();
+   for (const auto& oi : orbits)
+   {
+      sats.push_back(oi.second.begin()->second->signal);
+   }
+   for (double sec = 0; sec < span; sec += step)
+   {
+      CommonTime when(t0 + sec);
+      times[SatelliteSystem::GPS].push_back(when);
+      when.setTimeSystem(TimeSystem::QZS);
+      times[SatelliteSystem::QZSS].push_back(when);
+      when.setTimeSystem(TimeSystem::BDT);
+      times[SatelliteSystem::BeiDou].push_back(when);
+   }
+}
+
+
+void NewNavBench ::
+writeRinex()
+{
+   NewNavToRinex writer;
+   HealthGetter noHealth;
+   writer.header.version = 3.04;
+   writer.header.fileType = "NAVIGATION";
+   writer.header.fileProgram = "NewNavBench";
+   writer.header.fileAgency = "gnsstk";
+   writer.header.date = CivilTime(t0).printf("%04Y%02m%02d %02H%02M%02S UTC");
+   writer.header.valid = Rinex3NavHeader::validVersion |
+      Rinex3NavHeader::validRunBy | Rinex3NavHeader::validEoH;
+   if (!writer.translate(navData, noHealth) || !writer.write(rinexFile))
+   {
+      GNSSTK_THROW(Exception("Unable to write " + rinexFile));
+   }
+}
+
+
+void NewNavBench ::
+writeSP3()
+{
+   const double interval = 900.0;
+   SP3Stream strm(sp3File.c_str(), ios::out);
+   SP3Header head;
+   head.version = SP3Header::SP3c;
+   head.containsVelocity = false;
+   head.time = t0;
+   head.epochInterval = interval;
+   head.numberOfEpochs = static_cast<int>(ceil(days * 86400.0 / interval));
+   head.dataUsed = "ORBIT";
+   head.coordSystem = "IGS14";
+   head.orbitType = "FIT";
+   head.agency = "BNCH";
+   head.system = SP3SatID(-1, SatelliteSystem::Mixed);
+   head.timeSystem = TimeSystem::GPS;
+   for (const auto& oi : orbits)
+   {
+      head.satList[SP3SatID(oi.first)] = 0;
+   }
+   strm << head;
+   for (int epoch = 0; epoch < head.numberOfEpochs; epoch++)
+   {
+      SP3Data data;
+      data.time = t0 + epoch * interval;
+      data.RecType = '*';
+      strm << data;
+      data.RecType = 'P';
+      for (const auto& oi : orbits)
+      {
+         CommonTime when(data.time);
+         when.setTimeSystem(oi.second.begin()->first.getTimeSystem());
+            // use the most recent ephemeris, or the first
+         auto ephi = oi.second.upper_bound(when);
+         if (ephi != oi.second.begin())
+         {
+            --ephi;
+         }
+         Xvt xvt;
+         ephi->second->getXvt(when, xvt);
+         data.sat = oi.first;
+         data.x[0] = xvt.x[0] / 1000.0;
+         data.x[1] = xvt.x[1] / 1000.0;
+         data.x[2] = xvt.x[2] / 1000.0;
+         data.clk = xvt.clkbias * 1e6;
+         strm << data;
+      }
+   }
+   strm.close();
+   if (!strm)
+   {
+      GNSSTK_THROW(Exception("Unable to write " + sp3File));
+   }
+}
+
+
+void NewNavBench ::
+bench(const string& name, const std::function<unsigned long()>& func,
+      unsigned long long bytes, const std::function<void()>& setup,
+      bool memory)
+{
+   typedef std::chrono::steady_clock Clock;
+   BenchResult res;
+   res.name = name;
+   res.bytes = bytes;
+   for (unsigned rep = 0; rep < reps; rep++)
+   {
+      if (setup)
+      {
+         setup();
+      }
+      hits = 0;
+      long long heapBefore = (memory ? heapInUse() : 0);
+      Clock::time_point start = Clock::now();
+      res.count = func();
+      double secs = std::chrono::duration<double>(Clock::now() - start)
+         .count();
+      if (memory)
+      {
+         res.memory = heapInUse() - heapBefore;
+      }
+      if ((rep == 0) || (secs < res.best))
+      {
+         res.best = secs;
+      }
+      res.total += secs;
+      res.reps++;
+      res.hits = hits;
+   }
+   if (verboseLevel)
+   {
+      cerr << name << ": " << res.count << " in " << res.best << " s" << endl;
+   }
+   results.push_back(res);
+}
+
+
+void NewNavBench ::
+benchRinex()
+{
+   unsigned long long bytes = fileSize(rinexFile);
+   bench("load.rinex", [&]()
+   {
+      RinexNavDataFactory fact;
+      if (!fact.addDataSource(rinexFile))
+      {
+         GNSSTK_THROW(Exception("Unable to load " + rinexFile));
+      }
+      return static_cast<unsigned long>(fact.size());
+   }, bytes);
+
+      // The library used for the searches is the one compacted by
+      // the last repetition.
+   unique_ptr<NavLibrary> libPtr;
+   shared_ptr<RinexNavDataFactory> fact;
+   bench("compact.rinex", [&]()
+   {
+      libPtr->compact();
+      return static_cast<unsigned long>(fact->size());
+   }, 0, [&]()
+   {
+      libPtr.reset(new NavLibrary());
+      fact = make_shared<RinexNavDataFactory>();
+      NavDataFactoryPtr ndfp(fact);
+      libPtr->addFactory(ndfp);
+      if (!fact->addDataSource(rinexFile))
+      {
+         GNSSTK_THROW(Exception("Unable to load " + rinexFile));
+      }
+   });
+   NavLibrary& navLib(*libPtr);
+      // RinexNavDataFactory doesn't set the subframe ID of BeiDou
+      // ephemerides, so they fail validate() and would never be
+      // found using NavValidityType::ValidOnly.
+   const NavValidityType valid = NavValidityType::Any;
+
+   bench("getXvt.eph", [&]()
+   {
+      unsigned long count = 0;
+      Xvt xvt;
+      for (const auto& sat : sats)
+      {
+         for (const auto& when : times[sat.system])
+         {
+            hits += navLib.getXvt(sat, when, xvt, false, SVHealth::Any,
+                                  valid);
+            count++;
+         }
+      }
+      return count;
+   });
+
+   bench("getXvt.eph.batchSats", [&]()
+   {
+      unsigned long count = 0;
+      XvtBatch xvts;
+      map<SatelliteSystem, vector<NavSatelliteID> > bySys;
+      for (const auto& sat : sats)
+      {
+         bySys[sat.system].push_back(sat);
+      }
+      for (const auto& si : bySys)
+      {
+         for (const auto& when : times[si.first])
+         {
+            hits += navLib.getXvt(si.second, when, xvts, false,
+                                  SVHealth::Any, valid);
+            count += si.second.size();
+         }
+      }
+      return count;
+   });
+
+   bench("getXvt.eph.batchTimes", [&]()
+   {
+      unsigned long count = 0;
+      XvtBatch xvts;
+      for (const auto& sat : sats)
+      {
+         hits += navLib.getXvt(sat, times[sat.system], xvts, false,
+                               SVHealth::Any, valid);
+         count += times[sat.system].size();
+      }
+      return count;
+   });
+
+   bench("getHealth", [&]()
+   {
+      unsigned long count = 0;
+      SVHealth health;
+      for (const auto& sat : sats)
+      {
+         for (const auto& when : times[sat.system])
+         {
+            hits += navLib.getHealth(sat, when, health, SVHealth::Any,
+                                     valid);
+            count++;
+         }
+      }
+      return count;
+   });
+
+   bench("getOffset", [&]()
+   {
+      unsigned long count = 0;
+      double offset;
+      for (unsigned i = 0; i < sats.size(); i++)
+      {
+         for (const auto& when : times[SatelliteSystem::GPS])
+         {
+            hits += navLib.getOffset(TimeSystem::GPS, TimeSystem::UTC, when,
+                                     offset);
+            count++;
+         }
+      }
+      return count;
+   });
+
+   struct FindCase
+   {
+      const char *name;
+      bool wild;
+      NavSearchOrder order;
+   };
+   const FindCase findCases[] =
+   {
+      { "find.exact.user", false, NavSearchOrder::User },
+      { "find.exact.nearest", false, NavSearchOrder::Nearest },
+      { "find.wild.user", true, NavSearchOrder::User },
+      { "find.wild.nearest", true, NavSearchOrder::Nearest },
+   };
+   for (const auto& fc : findCases)
+   {
+      bench(fc.name, [&]()
+      {
+         unsigned long count = 0;
+         NavDataPtr ndp;
+         for (const auto& sat : sats)
+         {
+            NavMessageID nmid(fc.wild ? NavSatelliteID(sat.sat) : sat,
+                              NavMessageType::Ephemeris);
+            for (const auto& when : times[sat.system])
+            {
+               hits += navLib.find(nmid, when, ndp, SVHealth::Any, valid,
+                                   fc.order);
+               count++;
+            }
+         }
+         return count;
+      });
+   }
+
+      // Sliding-window reprocessing, which discards the oldest data
+      // an hour at a time.  Each repetition edits a freshly loaded
+      // store so that there's something to remove.
+   shared_ptr<RinexNavDataFactory> editFact;
+   auto loadEdit = [&]()
+   {
+      editFact = make_shared<RinexNavDataFactory>();
+      if (!editFact->addDataSource(rinexFile))
+      {
+         GNSSTK_THROW(Exception("Unable to load " + rinexFile));
+      }
+   };
+      // The store mixes time systems, so edit using Any.
+   CommonTime anyT0(t0);
+   anyT0.setTimeSystem(TimeSystem::Any);
+   const double span = days * 86400.0;
+   bench("edit.window", [&]()
+   {
+      unsigned long count = 0;
+      for (double sec = 3600.0; sec < span + 3600.0; sec += 3600.0)
+      {
+         editFact->edit(CommonTime::BEGINNING_OF_TIME, anyT0 + sec);
+         count++;
+      }
+      return count;
+   }, 0, loadEdit);
+   bench("edit.sat", [&]()
+   {
+      unsigned long count = 0;
+      for (double sec = 0; sec < span; sec += 3600.0)
+      {
+         for (const auto& sat : sats)
+         {
+            editFact->edit(anyT0 + sec, anyT0 + sec + 3600.0, sat);
+            count++;
+         }
+      }
+      return count;
+   }, 0, loadEdit);
+}
+
+
+void NewNavBench ::
+benchRinexStore(bool arena, const string& suffix)
+{
+   unsigned long long bytes = fileSize(rinexFile);
+   shared_ptr<RinexNavDataFactory> fact;
+   auto load = [&]()
+   {
+      fact = make_shared<RinexNavDataFactory>();
+      fact->setUseArena(arena);
+      if (!fact->addDataSource(rinexFile))
+      {
+         GNSSTK_THROW(Exception("Unable to load " + rinexFile));
+      }
+   };
+      // Each repetition keeps its data until the next one starts so
+      // that the memory it uses can be measured.
+   bench("store.load" + suffix, [&]()
+   {
+      load();
+      return static_cast<unsigned long>(fact->size());
+   }, bytes, [&]() { fact.reset(); }, true);
+
+   fact->compact();
+   const NavValidityType valid = NavValidityType::Any;
+      // Step through time for each satellite in turn, which is how
+      // cursors are meant to be used.
+   bench("store.find" + suffix, [&]()
+   {
+      unsigned long count = 0;
+      NavDataPtr ndp;
+      for (const auto& sat : sats)
+      {
+         NavMessageID nmid(sat, NavMessageType::Ephemeris);
+         NavFindCursor cursor;
+         for (const auto& when : times[sat.system])
+         {
+            hits += fact->find(nmid, when, ndp, SVHealth::Any, valid,
+                               cursor);
+            count++;
+         }
+      }
+      return count;
+   });
+   bench("store.findRecord" + suffix, [&]()
+   {
+      unsigned long count = 0;
+      for (const auto& sat : sats)
+      {
+         NavMessageID nmid(sat, NavMessageType::Ephemeris);
+         NavFindCursor cursor;
+         for (const auto& when : times[sat.system])
+         {
+            hits += (fact->findRecord(nmid, when, SVHealth::Any, valid,
+                                      cursor) != nullptr);
+            count++;
+         }
+      }
+      return count;
+   });
+
+   bench("store.clear" + suffix, [&]()
+   {
+      unsigned long count = static_cast<unsigned long>(fact->size());
+      fact->clear();
+      return count;
+   }, 0, load);
+}
+
+
+void NewNavBench ::
+benchSP3()
+{
+   unsigned long long bytes = fileSize(sp3File);
+   bench("load.sp3", [&]()
+   {
+      SP3NavDataFactory fact;
+      if (!fact.addDataSource(sp3File))
+      {
+         GNSSTK_THROW(Exception("Unable to load " + sp3File));
+      }
+      return static_cast<unsigned long>(fact.size());
+   }, bytes);
+
+   NavLibrary navLib;
+   NavDataFactoryPtr ndfp(make_shared<SP3NavDataFactory>());
+   navLib.addFactory(ndfp);
+   if (!ndfp->addDataSource(sp3File))
+   {
+      GNSSTK_THROW(Exception("Unable to load " + sp3File));
+   }
+   navLib.compact();
+   bench("getXvt.sp3", [&]()
+   {
+      unsigned long count = 0;
+      Xvt xvt;
+      for (const auto& sat : sats)
+      {
+         NavSatelliteID sp3sat(sat.sat);
+         for (const auto& when : times[SatelliteSystem::GPS])
+         {
+            hits += navLib.getXvt(sp3sat, when, xvt, false);
+            count++;
+         }
+      }
+      return count;
+   });
+}
+
+
+PackedNavBitsPtr NewNavBench ::
+makeMessage(const PackedNavBitsPtr& pnb, int prn)
+{
+   PackedNavBitsPtr rv(pnb->clone());
+   rv->setSatID(SatID(prn, SatelliteSystem::GPS));
+   return rv;
+}
+
+
+void NewNavBench ::
+benchPNB()
+{
+      // A receiver's worth of LNAV subframes, repeated for each hour
+      // of data, to a maximum of a day.
+   vector<PackedNavBitsPtr> stream;
+   vector<PackedNavBitsPtr> sfs { ephLNAVGPSSF1, ephLNAVGPSSF2,
+                                  ephLNAVGPSSF3, almLNAVGPS25,
+                                  almLNAVGPS26, pg51LNAVGPS,
+                                  pg56LNAVGPS, pg63LNAVGPS };
+   unsigned hours = static_cast<unsigned>(ceil(min(days, 1.0) * 24));
+   for (unsigned rep = 0; rep < hours * 15; rep++)
+   {
+      for (const auto& sf : sfs)
+      {
+         for (int prn = 1; prn <= 32; prn++)
+         {
+            stream.push_back(makeMessage(sf, prn));
+         }
+      }
+   }
+   unsigned long long bytes = stream.size() * 300 / 8;
+   bench("decode.pnb", [&]()
+   {
+      PNBMultiGNSSNavDataFactory fact;
+      NavDataPtrList navOut;
+      for (const auto& pnb : stream)
+      {
+         fact.addData(pnb, navOut);
+         navOut.clear();
+      }
+      return static_cast<unsigned long>(stream.size());
+   }, bytes);
+
+   bench("decode.pnb.pipeline", [&]()
+   {
+      CountCallback cb;
+      PNBNavDataPipeline pipe(cb);
+      for (const auto& pnb : stream)
+      {
+         pipe.addData(pnb);
+      }
+      pipe.flush();
+      return static_cast<unsigned long>(stream.size());
+   }, bytes);
+}
+
+
+void NewNavBench ::
+benchParity()
+{
+      // As many messages of each kind as benchPNB() decodes, all
+      // with good parity so that every check runs to the end.
+   unsigned hours = static_cast<unsigned>(ceil(min(days, 1.0) * 24));
+   size_t numMsgs = hours * 15 * 8 * 32;
+   vector<PackedNavBitsPtr> lnav, cnav, bds;
+   vector<PackedNavBitsPtr> sfs { ephLNAVGPSSF1, ephLNAVGPSSF2,
+                                  ephLNAVGPSSF3, almLNAVGPS25,
+                                  almLNAVGPS26, pg51LNAVGPS,
+                                  pg56LNAVGPS, pg63LNAVGPS };
+   uint32_t seed = 12345;
+   auto random = [&seed]()
+   {
+      seed = seed * 1103515245 + 12345;
+      return seed;
+   };
+   for (size_t i = 0; i < numMsgs; i++)
+   {
+      lnav.push_back(sfs[i % sfs.size()]);
+         // CNAV message, 276 data bits and the CRC.
+      PackedNavBitsPtr msg = make_shared<PackedNavBits>();
+      for (unsigned word = 0; word < 8; word++)
+      {
+         msg->addUnsignedLong(random(), 32, 1);
+      }
+      msg->addUnsignedLong(random() >> 12, 20, 1);
+      CRC24Q crc;
+      crc.process(*msg);
+      msg->addUnsignedLong(crc.checksum(), 24, 1);
+      msg->trimsize();
+      cnav.push_back(msg);
+         // BeiDou D1/D2 subframe, 15 unprotected bits then one code
+         // word, followed by nine words of two code words each.
+      PackedNavBitsPtr sf = make_shared<PackedNavBits>();
+      uint32_t bits = random();
+      uint16_t info = (bits >> 4) & 0x7ff;
+      sf->addUnsignedLong(bits >> 17, 15, 1);
+      sf->addUnsignedLong(info, 11, 1);
+      sf->addUnsignedLong(BDSBCH::parity(info), 4, 1);
+      for (unsigned word = 1; word < 10; word++)
+      {
+         bits = random();
+         uint16_t info1 = (bits >> 8) & 0x7ff, info2 = (bits >> 19) & 0x7ff;
+         sf->addUnsignedLong(info1, 11, 1);
+         sf->addUnsignedLong(info2, 11, 1);
+         sf->addUnsignedLong(BDSBCH::parity(info1), 4, 1);
+         sf->addUnsignedLong(BDSBCH::parity(info2), 4, 1);
+      }
+      sf->trimsize();
+      bds.push_back(sf);
+   }
+   unsigned long long bytes = numMsgs * 300 / 8;
+   bench("parity.lnav", [&]()
+   {
+      for (const auto& pnb : lnav)
+      {
+         hits += EngNav::checkParity(*pnb);
+      }
+      return static_cast<unsigned long>(lnav.size());
+   }, bytes);
+
+   bench("parity.cnav.crc24q", [&]()
+   {
+      for (const auto& pnb : cnav)
+      {
+         hits += CRC24Q::check(*pnb, 0, 300);
+      }
+      return static_cast<unsigned long>(cnav.size());
+   }, bytes);
+
+   bench("parity.bds.bch", [&]()
+   {
+      for (const auto& pnb : bds)
+      {
+         hits += BDSBCH::check(*pnb);
+      }
+      return static_cast<unsigned long>(bds.size());
+   }, bytes);
+}
+
+
+void NewNavBench ::
+printResults(ostream& s)
+{
+   s << left << setw(24) << "benchmark" << right << setw(10) << "count"
+     << setw(10) << "found" << setw(12) << "best s" << setw(14) << "ops/s"
+     << setw(12) << "ns/op" << setw(10) << "MB/s" << setw(10) << "heap MB"
+     << endl;
+   for (const auto& res : results)
+   {
+      s << left << setw(24) << res.name << right << setw(10) << res.count
+        << setw(10) << res.hits << fixed << setprecision(6) << setw(12)
+        << res.best << setprecision(0) << setw(14) << res.perSecond()
+        << setprecision(1) << setw(12) << res.nsPerOp();
+      if (res.bytes || res.memory)
+      {
+         s << setprecision(2) << setw(10) << res.mbPerSecond();
+      }
+      if (res.memory)
+      {
+         s << setprecision(2) << setw(10) << (res.memory / 1e6);
+      }
+      s << endl;
+   }
+}
+
+
+void NewNavBench ::
+writeJSON(ostream& s)
+{
+   s << "{\"program\":\"NewNavBench\",\"days\":" << days
+     << ",\"reps\":" << reps << ",\"step\":" << step
+     << ",\"results\":[" << endl;
+   for (unsigned i = 0; i < results.size(); i++)
+   {
+      const BenchResult& res(results[i]);
+      s << "{\"name\":\"" << res.name << "\",\"count\":" << res.count
+        << ",\"hits\":" << res.hits << ",\"bytes\":" << res.bytes
+        << ",\"memory\":" << res.memory
+        << setprecision(9)
+        << ",\"seconds\":" << res.best
+        << ",\"meanSeconds\":" << (res.total / res.reps)
+        << ",\"perSecond\":" << res.perSecond()
+        << ",\"nsPerOp\":" << res.nsPerOp()
+        << ",\"mbPerSecond\":" << res.mbPerSecond()
+        << "}" << (i+1 < results.size() ? "," : "") << endl;
+   }
+   s << "]}" << endl;
+}
+
+
+/** Get the value of "key": from a line of writeJSON() output.
+ * @return an empty string if key is not present. */
+static string jsonValue(const string& line, const string& key)
+{
+   string tag("\"" + key + "\":");
+   string::size_type pos = line.find(tag);
+   if (pos == string::npos)
+   {
+      return string();
+   }
+   pos += tag.length();
+   string::size_type end = line.find_first_of(",}", pos);
+   string rv(line.substr(pos, end - pos));
+   if (!rv.empty() && (rv[0] == '"'))
+   {
+      rv = rv.substr(1, rv.length() - 2);
+   }
+   return rv;
+}
+
+
+bool NewNavBench ::
+compare(const string& fileName, ostream& s)
+{
+   ifstream ifs(fileName.c_str());
+   if (!ifs)
+   {
+      cerr << "Unable to open \"" << fileName << "\"" << endl;
+      return false;
+   }
+   map<string, double> baseline;
+   string line;
+   while (getline(ifs, line))
+   {
+      string name(jsonValue(line, "name"));
+      string ns(jsonValue(line, "nsPerOp"));
+      if (!name.empty() && !ns.empty())
+      {
+         baseline[name] = StringUtils::asDouble(ns);
+      }
+   }
+   s << endl << left << setw(24) << "benchmark" << right << setw(14)
+     << "baseline ns" << setw(14) << "ns/op" << setw(10) << "speedup"
+     << endl;
+   for (const auto& res : results)
+   {
+      auto bi = baseline.find(res.name);
+      if ((bi == baseline.end()) || (res.nsPerOp() <= 0))
+      {
+         continue;
+      }
+      s << left << setw(24) << res.name << right << fixed
+        << setprecision(1) << setw(14) << bi->second << setw(14)
+        << res.nsPerOp() << setprecision(2) << setw(10)
+        << (bi->second / res.nsPerOp()) << endl;
+   }
+   return true;
+}
+
+
+void NewNavBench ::
+process()
+{
+   generate();
+   writeRinex();
+   writeSP3();
+   if (verboseLevel)
+   {
+      cerr << navData.size() << " nav records for " << sats.size()
+           << " satellites" << endl;
+   }
+   benchRinex();
+   benchRinexStore(false, ".heap");
+   benchRinexStore(true, ".arena");
+   benchSP3();
+   benchPNB();
+   benchParity();
+   printResults(cout);
+   if (jsonOpt.getCount())
+   {
+      ofstream ofs(jsonOpt.getValue()[0].c_str());
+      writeJSON(ofs);
+      if (!ofs)
+      {
+         cerr << "Unable to write \"" << jsonOpt.getValue()[0] << "\""
+              << endl;
+         exitCode = BasicFramework::EXIST_ERROR;
+      }
+   }
+   if (baseOpt.getCount() && !compare(baseOpt.getValue()[0], cout))
+   {
+      exitCode = BasicFramework::EXIST_ERROR;
+   }
+   if (!keepOpt.getCount())
+   {
+      std::remove(rinexFile.c_str());
+      std::remove(sp3File.c_str());
+   }
+}
+
+
+int main(int argc, char *argv[])
+{
+   try
+   {
+      NewNavBench app(argv[0]);
+      if (!app.initialize(argc, argv))
+      {
+         return app.exitCode;
+      }
+      app.run();
+      return app.exitCode;
+   }
+   catch(gnsstk::Exception& e)
+   {
+      cout << e << endl;
+   }
+   catch(std::exception& e)
+   {
+      cout << e.what() << endl;
+   }
+   catch(...)
+   {
+      cout << "unknown error" << endl;
+   }
+      // only reach this point if an exception was caught
+   return BasicFramework::EXCEPTION_ERROR;
+}
@@ -231,7 +231,34 @@ unsigned PNBBDSD1NavDataFactory_T ::
 addDataValidityTest()
 {
    TUDEF("PNBBDSD1NavDataFactory", "addData");
-      /// @todo implement some tests after we have parity checking and such.
+   BDSFactoryCounter fc(testFramework);
+   gnsstk::PNBBDSD1NavDataFactory uut;
+   gnsstk::NavDataPtrList navOut;
+      // make a copy of subframe 1 and flip an information bit in
+      // the second word for bad parity
+   gnsstk::PackedNavBitsPtr sf1Bad = std::make_shared<gnsstk::PackedNavBits>(
+      *ephD1NAVSF1);
+   sf1Bad->insertUnsignedLong(sf1Bad->asBool(35) ? 0 : 1, 35, 1);
+      // default = all validity
+      // add subframe 1, expect 1 health, 1 ISC and 1 iono
+   TUASSERTE(bool, true, uut.addData(ephD1NAVSF1, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
+      // check valid only
+   uut.setValidityFilter(gnsstk::NavValidityType::ValidOnly);
+      // add subframe 1, expect 1 health, 1 ISC and 1 iono
+   TUASSERTE(bool, true, uut.addData(ephD1NAVSF1, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
+      // add BAD subframe 1, expect nothing
+   TUASSERTE(bool, true, uut.addData(sf1Bad, navOut));
+   fc.validateResults(navOut, __LINE__);
+      // check invalid only
+   uut.setValidityFilter(gnsstk::NavValidityType::InvalidOnly);
+      // add subframe 1, expect nothing
+   TUASSERTE(bool, true, uut.addData(ephD1NAVSF1, navOut));
+   fc.validateResults(navOut, __LINE__);
+      // add BAD subframe 1, expect 1 health, 1 ISC and 1 iono
+   TUASSERTE(bool, true, uut.addData(sf1Bad, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
    TURETURN();
 }
 
@@ -79,6 +79,8 @@ public:
    PNBGalFNavDataFactory_T();
 
    unsigned addDataAllTest();
+      /// Test addData with CRC validity filtering
+   unsigned addDataValidityTest();
       /// Test addData with ephemeris selected only
    unsigned addDataEphemerisTest();
       /// Test addData with almanac selected only
@@ -146,6 +148,36 @@ addDataAllTest()
 }
 
 
+unsigned PNBGalFNavDataFactory_T ::
+addDataValidityTest()
+{
+   TUDEF("PNBGalFNavDataFactory", "addData");
+   GalFactoryCounter fc(testFramework);
+   gnsstk::PNBGalFNavDataFactory uut;
+   gnsstk::NavDataPtrList navOut;
+      // make a copy of page type 1 and tweak a bit for a bad CRC
+   gnsstk::PackedNavBitsPtr pt1Bad = std::make_shared<gnsstk::PackedNavBits>(
+      *navFNAVGalPT1);
+   pt1Bad->insertUnsignedLong(!pt1Bad->asBool(29), 29, 1);
+      // default = all validity
+   TUASSERTE(bool, true, uut.addData(pt1Bad, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
+      // check valid only
+   uut.setValidityFilter(gnsstk::NavValidityType::ValidOnly);
+   TUASSERTE(bool, true, uut.addData(navFNAVGalPT1, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
+   TUASSERTE(bool, true, uut.addData(pt1Bad, navOut));
+   fc.validateResults(navOut, __LINE__);
+      // check invalid only
+   uut.setValidityFilter(gnsstk::NavValidityType::InvalidOnly);
+   TUASSERTE(bool, true, uut.addData(navFNAVGalPT1, navOut));
+   fc.validateResults(navOut, __LINE__);
+   TUASSERTE(bool, true, uut.addData(pt1Bad, navOut));
+   fc.validateResults(navOut, __LINE__, 3, 0, 0, 0, 1, 1, 1);
+   TURETURN();
+}
+
+
 unsigned PNBGalFNavDataFactory_T ::
 addDataEphemerisTest()
 {
@@ -633,6 +665,7 @@ int main()
    unsigned errorTotal = 0;
 
    errorTotal += testClass.addDataAllTest();
+   errorTotal += testClass.addDataValidityTest();
    errorTotal += testClass.addDataAlmanacTest();
    errorTotal += testClass.addDataEphemerisTest();
    errorTotal += testClass.addDataHealthTest();
@@ -38,6 +38,7 @@
 //==============================================================================
 #include "FactoryCounter.hpp"
 #include "PNBGalINavDataFactory.hpp"
+#include "CRC24Q.hpp"
 #include "TestUtil.hpp"
 #include "GalINavTimeOffset.hpp"
 #include "GalINavHealth.hpp"
@@ -80,6 +81,8 @@ public:
    PNBGalINavDataFactory_T();
 
    unsigned addDataAllTest();
+      /// Test addData with CRC validity filtering of page pairs
+   unsigned addDataValidityTest();
       /// Test addData with ephemeris selected only
    unsigned addDataEphemerisTest();
       /// Test addData with almanac selected only
@@ -165,6 +168,58 @@ addDataAllTest()
 }
 
 
+unsigned PNBGalINavDataFactory_T ::
+addDataValidityTest()
+{
+   TUDEF("PNBGalINavDataFactory", "addData");
+   GalFactoryCounter fc(testFramework);
+   std::vector<gnsstk::PackedNavBitsPtr> bad{
+      ephINAVGalPP1, ephINAVGalPP2, ephINAVGalPP3, ephINAVGalPP4,
+      ephINAVGalPP5 };
+      // The test page pairs don't have a CRC, so make copies with
+      // the CRC filled in.
+   std::vector<gnsstk::PackedNavBitsPtr> good;
+   for (const auto& pp : bad)
+   {
+      gnsstk::PackedNavBitsPtr fixed =
+         std::make_shared<gnsstk::PackedNavBits>(*pp);
+      gnsstk::CRC24Q crc;
+      crc.process(*fixed, 0, 114);
+      crc.process(*fixed, 120, 82);
+      fixed->insertUnsignedLong(crc.checksum(), 202, 24);
+      TUASSERTE(bool, true,
+                gnsstk::PNBGalINavDataFactory::checkPagePairCRC(*fixed));
+      TUASSERTE(bool, false,
+                gnsstk::PNBGalINavDataFactory::checkPagePairCRC(*pp));
+      good.push_back(fixed);
+   }
+   gnsstk::NavDataPtrList navOut;
+   for (auto validity : { gnsstk::NavValidityType::ValidOnly,
+                          gnsstk::NavValidityType::InvalidOnly })
+   {
+      gnsstk::PNBGalINavDataFactory uut;
+      uut.setValidityFilter(validity);
+      bool validOnly = (validity == gnsstk::NavValidityType::ValidOnly);
+      std::vector<gnsstk::PackedNavBitsPtr>& accepted(validOnly ? good : bad);
+      std::vector<gnsstk::PackedNavBitsPtr>& rejected(validOnly ? bad : good);
+         // rejected pages shouldn't contribute to the ephemeris
+      for (unsigned i = 0; i < rejected.size(); i++)
+      {
+         TUASSERTE(bool, true, uut.addData(rejected[i], navOut));
+         fc.validateResults(navOut, __LINE__);
+      }
+      for (unsigned i = 0; i < 4; i++)
+      {
+         TUASSERTE(bool, true, uut.addData(accepted[i], navOut));
+         fc.validateResults(navOut, __LINE__);
+      }
+      TUASSERTE(bool, true, uut.addData(accepted[4], navOut));
+      fc.validateResults(navOut, __LINE__, 5, 0, 1, 0, 2, 1, 1);
+   }
+   TURETURN();
+}
+
+
 unsigned PNBGalINavDataFactory_T ::
 addDataEphemerisTest()
 {
@@ -831,6 +886,7 @@ int main()
    unsigned errorTotal = 0;
 
    errorTotal += testClass.addDataAllTest();
+   errorTotal += testClass.addDataValidityTest();
    errorTotal += testClass.addDataAlmanacTest();
    errorTotal += testClass.addDataEphemerisTest();
    errorTotal += testClass.addDataHealthTest();
@@ -0,0 +1,266 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include "PNBNavDataPipeline.hpp"
+#include "PNBMultiGNSSNavDataFactory.hpp"
+#include "NavDataFactoryListCallback.hpp"
+#include "GPSLNavEph.hpp"
+#include "GPSWeekSecond.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+/// Factory that fails or throws on messages with specific PRNs.
+class FailFactory : public gnsstk::PNBNavDataFactory
+{
+public:
+   bool addData(const gnsstk::PackedNavBitsPtr& navIn,
+                gnsstk::NavDataPtrList& navOut, double cadence) override
+   {
+      int prn = navIn->getsatSys().id;
+      if (prn == 13)
+      {
+         GNSSTK_THROW(gnsstk::InvalidParameter("unlucky"));
+      }
+      navOut.push_back(std::make_shared<gnsstk::GPSLNavEph>());
+      navOut.back()->signal.sat = navIn->getsatSys();
+      return prn != 7;
+   }
+   void resetState() override
+   {}
+};
+
+
+class PNBNavDataPipeline_T
+{
+public:
+   PNBNavDataPipeline_T();
+
+      /// Make sure the output doesn't depend on the number of threads.
+   unsigned orderTest();
+      /// Make sure the factory settings are given to the workers.
+   unsigned setTypeFilterTest();
+      /// Test reporting of failures and exceptions.
+   unsigned errorTest();
+
+      /// Copy pnb, changing the transmitting satellite to prn.
+   gnsstk::PackedNavBitsPtr makeMessage(const gnsstk::PackedNavBitsPtr& pnb,
+                                        int prn);
+      /** Create a stream of LNAV subframes from several satellites,
+       * interleaved as they would be by a receiver. */
+   vector<gnsstk::PackedNavBitsPtr> makeStream();
+
+#include "LNavTestDataDecl.hpp"
+};
+
+
+PNBNavDataPipeline_T ::
+PNBNavDataPipeline_T()
+{
+#include "LNavTestDataDef.hpp"
+}
+
+
+gnsstk::PackedNavBitsPtr PNBNavDataPipeline_T ::
+makeMessage(const gnsstk::PackedNavBitsPtr& pnb, int prn)
+{
+   gnsstk::PackedNavBitsPtr rv(pnb->clone());
+   rv->setSatID(gnsstk::SatID(prn, gnsstk::SatelliteSystem::GPS));
+   return rv;
+}
+
+
+vector<gnsstk::PackedNavBitsPtr> PNBNavDataPipeline_T ::
+makeStream()
+{
+   vector<gnsstk::PackedNavBitsPtr> rv;
+   vector<gnsstk::PackedNavBitsPtr> sfs { ephLNAVGPSSF1, ephLNAVGPSSF2,
+                                          ephLNAVGPSSF3, almLNAVGPS25,
+                                          almLNAVGPS26, pg51LNAVGPS,
+                                          pg56LNAVGPS, pg63LNAVGPS };
+   for (int rep = 0; rep < 3; rep++)
+   {
+      for (const auto& sf : sfs)
+      {
+         for (int prn = 1; prn <= 24; prn++)
+         {
+            rv.push_back(makeMessage(sf, prn));
+         }
+      }
+   }
+   return rv;
+}
+
+
+unsigned PNBNavDataPipeline_T ::
+orderTest()
+{
+   TUDEF("PNBNavDataPipeline", "addData");
+   vector<gnsstk::PackedNavBitsPtr> stream(makeStream());
+   gnsstk::NavDataPtrList expList, gotList;
+   gnsstk::PNBMultiGNSSNavDataFactory
+      serial(gnsstk::PNBMultiGNSSNavDataFactory::newFactories());
+   for (const auto& pnb : stream)
+   {
+      TUASSERTE(bool, true, serial.addData(pnb, expList));
+   }
+   TUASSERT(!expList.empty());
+   for (unsigned numThreads : {1, 2, 5})
+   {
+      gotList.clear();
+      gnsstk::NavDataFactoryListCallback cb(gotList);
+      gnsstk::PNBNavDataPipeline uut(cb, numThreads);
+      TUASSERTE(unsigned, (numThreads == 1 ? 0 : numThreads),
+                uut.getNumThreads());
+      for (const auto& pnb : stream)
+      {
+         TUASSERTE(bool, true, uut.addData(pnb));
+      }
+      TUASSERTE(bool, true, uut.flush());
+      TUASSERTE(size_t, expList.size(), gotList.size());
+      auto ei = expList.begin();
+      auto gi = gotList.begin();
+      for (; ei != expList.end() && gi != gotList.end(); ++ei, ++gi)
+      {
+         TUASSERTE(gnsstk::NavMessageID, (*ei)->signal, (*gi)->signal);
+         TUASSERTE(gnsstk::CommonTime, (*ei)->timeStamp, (*gi)->timeStamp);
+         TUASSERTE(std::string, typeid(*(ei->get())).name(),
+                   typeid(*(gi->get())).name());
+      }
+   }
+   TURETURN();
+}
+
+
+unsigned PNBNavDataPipeline_T ::
+setTypeFilterTest()
+{
+   TUDEF("PNBNavDataPipeline", "setTypeFilter");
+   vector<gnsstk::PackedNavBitsPtr> stream(makeStream());
+   gnsstk::NavDataPtrList gotList;
+   gnsstk::NavDataFactoryListCallback cb(gotList);
+   gnsstk::PNBNavDataPipeline uut(cb, 3);
+   uut.setTypeFilter({gnsstk::NavMessageType::Ephemeris});
+   for (const auto& pnb : stream)
+   {
+      TUASSERTE(bool, true, uut.addData(pnb));
+   }
+   TUASSERTE(bool, true, uut.flush());
+      // one ephemeris per satellite per repetition
+   TUASSERTE(size_t, 72, gotList.size());
+   for (const auto& ndp : gotList)
+   {
+      TUASSERT(dynamic_cast<gnsstk::GPSLNavEph*>(ndp.get()) != nullptr);
+   }
+      // Nothing left to complete an ephemeris after resetting.
+   gotList.clear();
+   uut.addData(stream[0]);
+   uut.addData(stream[24]);
+   uut.resetState();
+   uut.addData(stream[48]);
+   TUASSERTE(bool, true, uut.flush());
+   TUASSERTE(size_t, 0, gotList.size());
+   TURETURN();
+}
+
+
+unsigned PNBNavDataPipeline_T ::
+errorTest()
+{
+   TUDEF("PNBNavDataPipeline", "flush");
+   gnsstk::NavDataPtrList gotList;
+   gnsstk::NavDataFactoryListCallback cb(gotList);
+   gnsstk::PNBNavDataPipeline uut(
+      cb, 4, []() { return std::make_shared<FailFactory>(); });
+   for (int prn = 1; prn <= 12; prn++)
+   {
+      uut.addData(makeMessage(ephLNAVGPSSF1, prn));
+   }
+      // prn 7 returns false
+   TUASSERTE(bool, false, uut.flush());
+   TUASSERTE(size_t, 12, gotList.size());
+      // the error state is cleared by flush
+   gotList.clear();
+   uut.addData(makeMessage(ephLNAVGPSSF1, 1));
+   TUASSERTE(bool, true, uut.flush());
+   TUASSERTE(size_t, 1, gotList.size());
+      // Everything before the exception is delivered first.  The
+      // exception may come from either addData or flush, depending
+      // on when the worker gets to it.
+   gotList.clear();
+   int prn = 10;
+   bool threw = false;
+   try
+   {
+      for (; prn <= 16; prn++)
+      {
+         uut.addData(makeMessage(ephLNAVGPSSF1, prn));
+      }
+      uut.flush();
+   }
+   catch (gnsstk::InvalidParameter& exc)
+   {
+      threw = true;
+   }
+   TUASSERTE(bool, true, threw);
+   TUASSERTE(size_t, 3, gotList.size());
+      // and the rest afterwards
+   for (prn++; prn <= 16; prn++)
+   {
+      uut.addData(makeMessage(ephLNAVGPSSF1, prn));
+   }
+   TUASSERTE(bool, true, uut.flush());
+   TUASSERTE(size_t, 6, gotList.size());
+   TURETURN();
+}
+
+
+int main()
+{
+   PNBNavDataPipeline_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.orderTest();
+   errorTotal += testClass.setTypeFilterTest();
+   errorTotal += testClass.errorTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,511 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include "SP3NavGrid.hpp"
+#include "SP3NavDataFactory.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+
+   /** Implement a test class to expose protected members rather than
+    * using friends. */
+class TestClass : public gnsstk::SP3NavDataFactory
+{
+public:
+   using SP3NavDataFactory::setSignal;
+      /// Grant access to protected data.
+   gnsstk::NavMessageMap& getData()
+   { return data; }
+};
+
+/// Automated tests for gnsstk::SP3NavGrid and SP3NavDataFactory dense storage
+class SP3NavGrid_T
+{
+public:
+   SP3NavGrid_T();
+      /// Test merging records into a grid.
+   unsigned mergeTest();
+      /// Make sure merge rejects data that doesn't fit in a grid.
+   unsigned mergeFailTest();
+      /// Test the epoch search methods.
+   unsigned boundTest();
+      /// Test removing samples from a grid.
+   unsigned eraseTest();
+      /** Make sure dense storage gives the same search results as
+       * the maps. */
+   unsigned denseFindTest();
+      /// Test the store queries and edits in dense mode.
+   unsigned denseStoreTest();
+
+      /** Create an SP3 record for prn at offset sec seconds from
+       * synth.t0, with position computed from an LNav ephemeris. */
+   gnsstk::NavDataPtr makeSP3(unsigned long prn, double sec,
+                              gnsstk::NavMessageType nmt);
+      /** Add a day of 900s ephemeris and clock records to fact,
+       * leaving a few gaps. */
+   void fill(TestClass& fact);
+      /// Dump every column of an OrbitDataSP3.
+   static std::string dumpValues(const gnsstk::NavDataPtr& ndp);
+      /// Dump the results of searches over a day in fact.
+   std::string dumpFinds(gnsstk::NavDataFactory& fact);
+
+   SyntheticNavData synth;
+};
+
+
+SP3NavGrid_T ::
+SP3NavGrid_T()
+{
+}
+
+
+gnsstk::NavDataPtr SP3NavGrid_T ::
+makeSP3(unsigned long prn, double sec, gnsstk::NavMessageType nmt)
+{
+   gnsstk::NavDataPtr eph = synth.makeEph(prn, synth.t0 + 43200.0);
+   gnsstk::OrbitData *od = dynamic_cast<gnsstk::OrbitData*>(eph.get());
+   gnsstk::Xvt xvt;
+   gnsstk::CommonTime when(synth.t0 + sec);
+   od->getXvt(when, xvt);
+   std::shared_ptr<gnsstk::OrbitDataSP3> rv =
+      std::make_shared<gnsstk::OrbitDataSP3>();
+   TestClass::setSignal(gnsstk::SatID(prn, gnsstk::SatelliteSystem::GPS),
+                        rv->signal);
+   rv->signal.messageType = nmt;
+   rv->timeStamp = when;
+   rv->coordSystem = "IGS14";
+   for (unsigned i = 0; i < 3; i++)
+   {
+      rv->pos[i] = xvt.x[i] / 1000.0;
+      rv->posSig[i] = 0.01;
+      rv->vel[i] = xvt.v[i] * 10.0;
+   }
+   rv->clkBias = xvt.clkbias * 1e6 + 1e-3 * std::sin(sec / 5000.0);
+   rv->biasSig = 0.1 + sec * 1e-7;
+   return rv;
+}
+
+
+void SP3NavGrid_T ::
+fill(TestClass& fact)
+{
+   for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+   {
+      for (double sec = 0; sec < 86400.0; sec += 900.0)
+      {
+            // a gap in the middle of the day for PRN 2 and late
+            // start for PRN 3
+         if (((prn == 2) && (sec >= 20000.0) && (sec < 24000.0)) ||
+             ((prn == 3) && (sec < 10000.0)))
+         {
+            continue;
+         }
+         fact.addNavData(makeSP3(prn, sec, gnsstk::NavMessageType::Ephemeris));
+         fact.addNavData(makeSP3(prn, sec, gnsstk::NavMessageType::Clock));
+      }
+   }
+}
+
+
+std::string SP3NavGrid_T ::
+dumpValues(const gnsstk::NavDataPtr& ndp)
+{
+   std::ostringstream s;
+   gnsstk::OrbitDataSP3 *od = dynamic_cast<gnsstk::OrbitDataSP3*>(ndp.get());
+   s << od->signal << " " << od->timeStamp << " " << od->coordSystem
+     << std::setprecision(17);
+   for (unsigned col = 0; col < gnsstk::SP3NavGrid::NumColumns; col++)
+   {
+      s << " " << gnsstk::SP3NavGrid::getValue(*od, col);
+   }
+   s << std::endl;
+   return s.str();
+}
+
+
+std::string SP3NavGrid_T ::
+dumpFinds(gnsstk::NavDataFactory& fact)
+{
+   std::ostringstream s;
+   gnsstk::NavDataPtr ndp;
+   for (double sec = -1000.0; sec < 88000.0; sec += 337.5)
+   {
+      for (const auto& sat : synth.sats)
+      {
+         gnsstk::NavMessageID nmid(sat, gnsstk::NavMessageType::Ephemeris);
+         if (fact.find(nmid, synth.t0 + sec, ndp, gnsstk::SVHealth::Any,
+                       gnsstk::NavValidityType::ValidOnly,
+                       gnsstk::NavSearchOrder::User))
+         {
+            s << dumpValues(ndp);
+         }
+         else
+         {
+            s << "not found " << sat << " " << sec << std::endl;
+         }
+      }
+   }
+   return s.str();
+}
+
+
+unsigned SP3NavGrid_T ::
+mergeTest()
+{
+   TUDEF("SP3NavGrid", "merge");
+   gnsstk::SP3NavGrid uut;
+   gnsstk::NavSatMap recs;
+   TUASSERTE(bool, true, uut.empty());
+   for (double sec = 0; sec < 3600.0; sec += 900.0)
+   {
+      if (sec != 1800.0)
+      {
+         gnsstk::NavDataPtr ndp = makeSP3(1, sec,
+                                          gnsstk::NavMessageType::Ephemeris);
+         recs[ndp->signal][ndp->timeStamp] = ndp;
+      }
+      gnsstk::NavDataPtr ndp = makeSP3(2, sec,
+                                       gnsstk::NavMessageType::Ephemeris);
+      recs[ndp->signal][ndp->timeStamp] = ndp;
+   }
+   TUASSERTE(bool, true, uut.merge(gnsstk::NavMessageType::Ephemeris, recs));
+   TUASSERTE(bool, false, uut.empty());
+   TUASSERTE(size_t, 7, uut.size());
+   TUASSERTE(unsigned, 2, uut.numSats());
+   TUASSERTE(long, 4, uut.numEpochs());
+   TUASSERTFE(900.0, uut.getStep());
+   TUASSERTE(gnsstk::CommonTime, synth.t0, uut.getTime(0));
+      // constant sigmas and the empty acceleration are stored once
+   TUASSERT(uut.storedValues() < 7 * gnsstk::SP3NavGrid::NumColumns);
+   long sat1 = uut.findSat(recs.begin()->first);
+   TUASSERT(sat1 >= 0);
+   TUASSERTE(size_t, 3, uut.count(sat1));
+   TUASSERTE(bool, false, uut.isPresent(sat1, 2));
+   TUASSERTE(long, 3, uut.nextPresent(sat1, 2));
+   TUASSERTE(long, 1, uut.prevPresent(sat1, 2));
+   TUASSERTE(long, -1, uut.nextPresent(sat1, 4));
+      // every stored record comes back unchanged
+   for (const auto& sati : recs)
+   {
+      long sat = uut.findSat(sati.first);
+      for (const auto& ti : sati.second)
+      {
+         long epoch = uut.findEpoch(ti.first);
+         TUASSERT(epoch >= 0);
+         TUASSERTE(std::string, dumpValues(ti.second),
+                   dumpValues(uut.getRecord(sat, epoch)));
+      }
+   }
+      // merging more data extends the existing grid
+   gnsstk::NavSatMap more;
+   gnsstk::NavDataPtr ndp = makeSP3(1, 4500.0,
+                                    gnsstk::NavMessageType::Ephemeris);
+   more[ndp->signal][ndp->timeStamp] = ndp;
+   TUASSERTE(bool, true, uut.merge(gnsstk::NavMessageType::Ephemeris, more));
+   TUASSERTE(size_t, 8, uut.size());
+   TUASSERTE(long, 6, uut.numEpochs());
+   TUASSERTE(long, -1, uut.findSat(gnsstk::NavSatelliteID()));
+   uut.clear();
+   TUASSERTE(bool, true, uut.empty());
+   TUASSERTE(size_t, 0, uut.size());
+   TURETURN();
+}
+
+
+unsigned SP3NavGrid_T ::
+mergeFailTest()
+{
+   TUDEF("SP3NavGrid", "merge");
+   gnsstk::SP3NavGrid uut;
+   gnsstk::NavSatMap recs;
+   for (double sec = 0; sec < 3600.0; sec += 900.0)
+   {
+      gnsstk::NavDataPtr ndp = makeSP3(1, sec,
+                                       gnsstk::NavMessageType::Ephemeris);
+      recs[ndp->signal][ndp->timeStamp] = ndp;
+   }
+   TUASSERTE(bool, true, uut.merge(gnsstk::NavMessageType::Ephemeris, recs));
+      // a time between grid epochs
+   gnsstk::NavSatMap offGrid;
+   gnsstk::NavDataPtr ndp = makeSP3(1, 1000.0,
+                                    gnsstk::NavMessageType::Ephemeris);
+   offGrid[ndp->signal][ndp->timeStamp] = ndp;
+   TUASSERTE(bool, false,
+             uut.merge(gnsstk::NavMessageType::Ephemeris, offGrid));
+      // a failed merge leaves the grid unchanged
+   TUASSERTE(size_t, 4, uut.size());
+   TUASSERTE(long, 4, uut.numEpochs());
+      // wrong message type
+   gnsstk::NavSatMap clk;
+   ndp = makeSP3(1, 900.0, gnsstk::NavMessageType::Clock);
+   clk[ndp->signal][ndp->timeStamp] = ndp;
+   TUASSERTE(bool, false, uut.merge(gnsstk::NavMessageType::Ephemeris, clk));
+      // not an SP3 record
+   gnsstk::NavSatMap eph;
+   ndp = synth.makeEph(1, synth.t0 + 7200.0);
+   eph[ndp->signal][ndp->timeStamp] = ndp;
+   TUASSERTE(bool, false, uut.merge(gnsstk::NavMessageType::Ephemeris, eph));
+      // different coordinate system for the same satellite
+   gnsstk::NavSatMap coord;
+   ndp = makeSP3(1, 3600.0, gnsstk::NavMessageType::Ephemeris);
+   dynamic_cast<gnsstk::OrbitDataSP3*>(ndp.get())->coordSystem = "IGb08";
+   coord[ndp->signal][ndp->timeStamp] = ndp;
+   TUASSERTE(bool, false,
+             uut.merge(gnsstk::NavMessageType::Ephemeris, coord));
+   TUASSERTE(size_t, 4, uut.size());
+   TURETURN();
+}
+
+
+unsigned SP3NavGrid_T ::
+boundTest()
+{
+   TUDEF("SP3NavGrid", "lowerBound");
+   gnsstk::SP3NavGrid uut;
+   gnsstk::NavSatMap recs;
+   for (double sec = 0; sec < 3600.0; sec += 900.0)
+   {
+      gnsstk::NavDataPtr ndp = makeSP3(1, sec,
+                                       gnsstk::NavMessageType::Clock);
+      recs[ndp->signal][ndp->timeStamp] = ndp;
+   }
+   TUASSERTE(bool, true, uut.merge(gnsstk::NavMessageType::Clock, recs));
+   TUASSERTE(long, 0, uut.lowerBound(synth.t0 - 1.0));
+   TUASSERTE(long, 0, uut.lowerBound(synth.t0));
+   TUASSERTE(long, 1, uut.lowerBound(synth.t0 + 1.0));
+   TUASSERTE(long, 1, uut.lowerBound(synth.t0 + 900.0));
+   TUASSERTE(long, 4, uut.lowerBound(synth.t0 + 3600.0));
+   TUCSM("upperBound");
+   TUASSERTE(long, 0, uut.upperBound(synth.t0 - 1.0));
+   TUASSERTE(long, 1, uut.upperBound(synth.t0));
+   TUASSERTE(long, 2, uut.upperBound(synth.t0 + 900.0));
+   TUASSERTE(long, 2, uut.upperBound(synth.t0 + 1799.0));
+   TUASSERTE(long, 4, uut.upperBound(synth.t0 + 2700.0));
+   TUCSM("findEpoch");
+   TUASSERTE(long, 2, uut.findEpoch(synth.t0 + 1800.0));
+   TUASSERTE(long, -1, uut.findEpoch(synth.t0 + 1800.5));
+   TUASSERTE(long, -1, uut.findEpoch(synth.t0 + 3600.0));
+   TUCSM("hasData");
+   TUASSERTE(bool, true, uut.hasData(0, synth.t0 + 100.0, synth.t0 + 1000.0));
+   TUASSERTE(bool, false,
+             uut.hasData(0, synth.t0 + 100.0, synth.t0 + 800.0));
+   TURETURN();
+}
+
+
+unsigned SP3NavGrid_T ::
+eraseTest()
+{
+   TUDEF("SP3NavGrid", "erase");
+   gnsstk::SP3NavGrid uut;
+   gnsstk::NavSatMap recs;
+   for (double sec = 0; sec < 5400.0; sec += 900.0)
+   {
+      for (unsigned long prn = 1; prn <= 3; prn++)
+      {
+         gnsstk::NavDataPtr ndp = makeSP3(prn, sec,
+                                          gnsstk::NavMessageType::Clock);
+         recs[ndp->signal][ndp->timeStamp] = ndp;
+      }
+   }
+   TUASSERTE(bool, true, uut.merge(gnsstk::NavMessageType::Clock, recs));
+   TUASSERTE(size_t, 18, uut.size());
+   TUASSERTE(long, 6, uut.numEpochs());
+      // a hole in the middle doesn't change the shape of the grid
+   uut.erase(synth.t0 + 1800.0, synth.t0 + 2700.0);
+   TUASSERTE(size_t, 15, uut.size());
+   TUASSERTE(long, 6, uut.numEpochs());
+   TUASSERTE(bool, false, uut.isPresent(0, 2));
+   TUASSERTE(bool, true, uut.isPresent(0, 3));
+      // removing the start trims the leading epochs
+   uut.erase(synth.t0 - 900.0, synth.t0 + 1000.0);
+   TUASSERTE(size_t, 9, uut.size());
+   TUASSERTE(long, 3, uut.numEpochs());
+   TUASSERTE(gnsstk::CommonTime, synth.t0 + 2700.0, uut.getTime(0));
+      // samples are unchanged by trimming
+   for (const auto& sati : recs)
+   {
+      long sat = uut.findSat(sati.first);
+      TUASSERT(sat >= 0);
+      for (const auto& ti : sati.second)
+      {
+         long epoch = uut.findEpoch(ti.first);
+         if (epoch >= 0)
+         {
+            TUASSERTE(std::string, dumpValues(ti.second),
+                      dumpValues(uut.getRecord(sat, epoch)));
+         }
+      }
+   }
+      // removing all of a satellite drops it from the grid
+   gnsstk::NavSatelliteID sat2(recs.begin()->first);
+   sat2.sat.id = sat2.xmitSat.id = 2;
+   uut.erase(synth.t0, synth.t0 + 86400.0, sat2);
+   TUASSERTE(unsigned, 2, uut.numSats());
+   TUASSERTE(long, -1, uut.findSat(sat2));
+   TUASSERTE(size_t, 6, uut.size());
+      // removing the end of one satellite leaves the other's
+   gnsstk::NavSatelliteID sat3(sat2);
+   sat3.sat.id = sat3.xmitSat.id = 3;
+   uut.erase(synth.t0 + 4500.0, synth.t0 + 86400.0, sat3);
+   TUASSERTE(long, 3, uut.numEpochs());
+   TUASSERTE(size_t, 5, uut.size());
+      // nothing left at the end trims the trailing epochs
+   uut.erase(synth.t0 + 4500.0, synth.t0 + 86400.0);
+   TUASSERTE(long, 2, uut.numEpochs());
+   TUASSERTE(size_t, 4, uut.size());
+   uut.erase(synth.t0, synth.t0 + 86400.0);
+   TUASSERTE(bool, true, uut.empty());
+   TUASSERTE(size_t, 0, uut.size());
+   TURETURN();
+}
+
+
+unsigned SP3NavGrid_T ::
+denseFindTest()
+{
+   TUDEF("SP3NavDataFactory", "setDenseStorage");
+   TestClass mapped, dense;
+   fill(mapped);
+   fill(dense);
+   TUASSERTE(bool, false, dense.getDenseStorage());
+   dense.setDenseStorage(true);
+   TUASSERTE(bool, true, dense.getDenseStorage());
+      // everything has been moved out of the maps
+   TUASSERTE(size_t, 0, dense.getData().size());
+   std::string expFinds = dumpFinds(mapped);
+   TUASSERTE(std::string, expFinds, dumpFinds(dense));
+      // also with different interpolation settings
+   mapped.setPositionInterpOrder(4);
+   dense.setPositionInterpOrder(4);
+   mapped.setClockLinearInterp();
+   dense.setClockLinearInterp();
+   mapped.setPosGapInterval(1000);
+   dense.setPosGapInterval(1000);
+   TUASSERTE(std::string, dumpFinds(mapped), dumpFinds(dense));
+      // and back again
+   dense.setDenseStorage(false);
+   TUASSERTE(size_t, 2, dense.getData().size());
+   TUASSERTE(std::string, dumpFinds(mapped), dumpFinds(dense));
+   TURETURN();
+}
+
+
+unsigned SP3NavGrid_T ::
+denseStoreTest()
+{
+   TUDEF("SP3NavDataFactory", "size");
+   TestClass mapped, dense;
+   dense.setDenseStorage(true);
+   fill(mapped);
+   fill(dense);
+      // addNavData goes to the maps until the next compact.
+   TUASSERTE(size_t, 2, dense.getData().size());
+   dense.compact();
+   TUASSERTE(size_t, 0, dense.getData().size());
+   TUASSERTE(size_t, mapped.size(), dense.size());
+   TUASSERTE(size_t, mapped.count(gnsstk::NavMessageType::Clock),
+             dense.count(gnsstk::NavMessageType::Clock));
+   TUASSERTE(size_t, mapped.numSatellites(), dense.numSatellites());
+   TUASSERTE(size_t, mapped.numSignals(), dense.numSignals());
+   TUCSM("getAvailableSats");
+   gnsstk::CommonTime fromTime(synth.t0 + 1000.0), toTime(synth.t0 + 5000.0);
+   TUASSERT(mapped.getAvailableSats(fromTime, toTime) ==
+            dense.getAvailableSats(fromTime, toTime));
+   TUASSERT(mapped.getAvailableMsgs(fromTime, toTime) ==
+            dense.getAvailableMsgs(fromTime, toTime));
+   TUCSM("getPositionTimeStep");
+   gnsstk::SatID sat3(3, gnsstk::SatelliteSystem::GPS);
+   TUASSERTFE(mapped.getPositionTimeStep(sat3),
+              dense.getPositionTimeStep(sat3));
+   TUCSM("edit");
+   mapped.edit(synth.t0, synth.t0 + 43200.0);
+   dense.edit(synth.t0, synth.t0 + 43200.0);
+   TUASSERTE(size_t, mapped.size(), dense.size());
+   TUASSERTE(size_t, 0, dense.getData().size());
+   TUASSERTE(std::string, dumpFinds(mapped), dumpFinds(dense));
+   gnsstk::NavSatelliteID nsid3(synth.sats[2]);
+   mapped.edit(synth.t0 + 50000.0, synth.t0 + 60000.0, nsid3);
+   dense.edit(synth.t0 + 50000.0, synth.t0 + 60000.0, nsid3);
+   TUASSERTE(size_t, mapped.size(), dense.size());
+   TUASSERTE(size_t, 0, dense.getData().size());
+   TUASSERTE(std::string, dumpFinds(mapped), dumpFinds(dense));
+   TUCSM("addNavData");
+      // Once there's a grid, new data goes straight into it,
+      // whether it replaces a sample, fills a hole or extends it.
+   for (double sec : {45000.0, 54000.0, 87300.0})
+   {
+      for (gnsstk::NavMessageType nmt : {gnsstk::NavMessageType::Ephemeris,
+                                         gnsstk::NavMessageType::Clock})
+      {
+         gnsstk::NavDataPtr ndp = makeSP3(3, sec, nmt);
+         dynamic_cast<gnsstk::OrbitDataSP3*>(ndp.get())->pos[0] += 0.5;
+         mapped.addNavData(ndp);
+         dense.addNavData(ndp);
+      }
+   }
+   TUASSERTE(size_t, 0, dense.getData().size());
+   TUASSERTE(size_t, mapped.size(), dense.size());
+   TUASSERTE(std::string, dumpFinds(mapped), dumpFinds(dense));
+   TUCSM("clear");
+   dense.clear();
+   TUASSERTE(size_t, 0, dense.size());
+   TUASSERTE(size_t, 0, dense.numSatellites());
+   TURETURN();
+}
+
+
+int main()
+{
+   SP3NavGrid_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.mergeTest();
+   errorTotal += testClass.mergeFailTest();
+   errorTotal += testClass.boundTest();
+   errorTotal += testClass.eraseTest();
+   errorTotal += testClass.denseFindTest();
+   errorTotal += testClass.denseStoreTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,206 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/** @file SyntheticNavData.hpp Synthetic GPS LNav ephemeris and
+ * health data for testing NavLibrary without depending on data
+ * files. */
+
+#ifndef GNSSTK_TEST_SYNTHETICNAVDATA_HPP
+#define GNSSTK_TEST_SYNTHETICNAVDATA_HPP
+
+#include <vector>
+#include "NavDataFactoryWithStore.hpp"
+#include "GPSLNavEph.hpp"
+#include "GPSLNavHealth.hpp"
+#include "GPSWeekSecond.hpp"
+
+/** Simple in-memory factory filled with synthetic LNav data, used in
+ * place of a file-reading factory so the test is self-contained. */
+class SyntheticNavFactory : public gnsstk::NavDataFactoryWithStore
+{
+public:
+   SyntheticNavFactory()
+   {
+      supportedSignals.insert(
+         gnsstk::NavSignalID(gnsstk::SatelliteSystem::GPS,
+                             gnsstk::CarrierBand::L1,
+                             gnsstk::TrackingCode::CA,
+                             gnsstk::NavType::GPSLNAV));
+   }
+   bool addDataSource(const std::string& source) override
+   { return false; }
+   std::string getFactoryFormats() const override
+   { return ""; }
+};
+
+
+/** Generate 2-hourly GPS LNav ephemerides and health for a day for
+ * PRNs 1 through numPRN, along with a grid of satellites (including
+ * one with no data) and times (starting before and ending after the
+ * data) to search. */
+class SyntheticNavData
+{
+public:
+   SyntheticNavData();
+      /** Load synthetic ephemeris and health data into fact.
+       * @param[in] gaps If true, leave out the ephemerides for
+       *   gapPRN with Toe at gapBegin and gapEnd, so that between
+       *   gapBegin and gapEnd the latest ephemeris for gapPRN is
+       *   past its fit interval and searches fail. */
+   void fill(SyntheticNavFactory& fact, bool gaps = false);
+      /// Make an ephemeris for prn with Toe at toe.
+   gnsstk::NavDataPtr makeEph(unsigned long prn, const gnsstk::CommonTime& toe);
+      /// Make a health message for prn transmitted at xmit.
+   gnsstk::NavDataPtr makeHealth(unsigned long prn,
+                                 const gnsstk::CommonTime& xmit);
+
+      /// Satellite used for the unhealthy data.
+   static const unsigned long badPRN = 5;
+      /// Number of satellites loaded.
+   static const unsigned long numPRN = 8;
+      /// Satellite missing some ephemerides when fill() is given gaps.
+   static const unsigned long gapPRN = 3;
+      /// Start of the data.
+   gnsstk::CommonTime t0;
+      /// Span of time with no ephemeris for gapPRN in fit.
+   gnsstk::CommonTime gapBegin, gapEnd;
+      /// Satellites and times to query.
+   std::vector<gnsstk::NavSatelliteID> sats;
+   std::vector<gnsstk::CommonTime> times;
+};
+
+
+inline SyntheticNavData ::
+SyntheticNavData()
+      : t0(gnsstk::GPSWeekSecond(2101, 7200.0)),
+        gapBegin(t0 + 43200.0),
+        gapEnd(t0 + 50400.0)
+{
+   for (unsigned long prn = 1; prn <= numPRN+1; prn++)
+   {
+      sats.push_back(gnsstk::NavSatelliteID(prn, prn,
+                                            gnsstk::SatelliteSystem::GPS,
+                                            gnsstk::CarrierBand::L1,
+                                            gnsstk::TrackingCode::CA,
+                                            gnsstk::NavType::GPSLNAV));
+   }
+      // start before the data and end after it.
+   for (double sec = -3600.0; sec < 90000.0; sec += 450.0)
+   {
+      times.push_back(t0 + sec);
+   }
+}
+
+
+inline gnsstk::NavDataPtr SyntheticNavData ::
+makeEph(unsigned long prn, const gnsstk::CommonTime& toe)
+{
+   std::shared_ptr<gnsstk::GPSLNavEph> eph =
+      gnsstk::makeNavData<gnsstk::GPSLNavEph>();
+   eph->signal = gnsstk::NavMessageID(sats[prn-1],
+                                      gnsstk::NavMessageType::Ephemeris);
+   eph->xmitTime = toe - 7200.0;
+   eph->xmit2 = eph->xmitTime + 6.0;
+   eph->xmit3 = eph->xmitTime + 12.0;
+   eph->timeStamp = eph->xmitTime;
+   eph->Toe = toe;
+   eph->Toc = toe;
+   eph->health = (prn == badPRN ? gnsstk::SVHealth::Unhealthy
+                  : gnsstk::SVHealth::Healthy);
+   eph->healthBits = (prn == badPRN ? 0x3f : 0);
+   eph->Cuc = .200793147087e-05;
+   eph->Cus = .823289155960e-05;
+   eph->Crc = .214593750000e+03;
+   eph->Crs = .369375000000e+02;
+   eph->Cic = -.175088644028e-06;
+   eph->Cis = .335276126862e-07;
+      // spread the satellites out a bit.
+   eph->M0 = .218771233916e+01 + 0.7 * prn;
+   eph->dn = .511592738462e-08;
+   eph->ecc = .422249664553e-02;
+   eph->Ahalf =.515360180473e+04;
+   eph->A = eph->Ahalf * eph->Ahalf;
+   eph->OMEGA0 = -.189462874179e+01 + 0.3 * prn;
+   eph->i0 = .946122987969e+00;
+   eph->w = .374892043461e+00;
+   eph->OMEGAdot = -.823034282681e-08;
+   eph->idot = .492877673191e-09;
+   eph->af0 = -.216379296035e-03;
+   eph->af1 = .432009983342e-11;
+   eph->fitIntFlag = 0;
+   eph->fixFit();
+   return eph;
+}
+
+
+inline gnsstk::NavDataPtr SyntheticNavData ::
+makeHealth(unsigned long prn, const gnsstk::CommonTime& xmit)
+{
+   std::shared_ptr<gnsstk::GPSLNavHealth> hea =
+      gnsstk::makeNavData<gnsstk::GPSLNavHealth>();
+   hea->signal = gnsstk::NavMessageID(sats[prn-1],
+                                      gnsstk::NavMessageType::Health);
+   hea->timeStamp = xmit;
+   hea->svHealth = (prn == badPRN ? 0x3f : 0);
+   return hea;
+}
+
+
+inline void SyntheticNavData ::
+fill(SyntheticNavFactory& fact, bool gaps)
+{
+      // 2-hourly ephemerides for a day, leaving out the last satellite
+   for (unsigned long prn = 1; prn <= numPRN; prn++)
+   {
+      for (unsigned i = 0; i < 12; i++)
+      {
+         gnsstk::CommonTime toe(t0 + 7200.0 * (i+1));
+            // Each ephemeris is fit from Toe-2h to Toe+2h, so
+            // two have to be left out to make a 2h gap.
+         if (gaps && (prn == gapPRN) && (toe >= gapBegin) &&
+             (toe <= gapEnd))
+         {
+            continue;
+         }
+         fact.addNavData(makeEph(prn, toe));
+         fact.addNavData(makeHealth(prn, toe - 7200.0));
+      }
+   }
+}
+
+#endif // GNSSTK_TEST_SYNTHETICNAVDATA_HPP
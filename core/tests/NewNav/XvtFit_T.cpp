@@ -0,0 +1,379 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2021, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+#include <cmath>
+#include "XvtFit.hpp"
+#include "GLOFNavEph.hpp"
+#include "NavLibrary.hpp"
+#include "CivilTime.hpp"
+#include "SyntheticNavData.hpp"
+#include "TestUtil.hpp"
+
+/// Largest differences between fitted and analytic Xvt.
+class XvtErrors
+{
+public:
+   XvtErrors()
+         : pos(0), vel(0), clk(0)
+   {}
+      /// Update the errors with the difference between exp and got.
+   void add(const gnsstk::Xvt& exp, const gnsstk::Xvt& got)
+   {
+      pos = std::max(pos, range(exp.x, got.x));
+      vel = std::max(vel, range(exp.v, got.v));
+      clk = std::max(clk, std::fabs(exp.clkbias - got.clkbias));
+      clk = std::max(clk, std::fabs(exp.clkdrift - got.clkdrift));
+      clk = std::max(clk, std::fabs(exp.relcorr - got.relcorr));
+   }
+   double pos, vel, clk;
+};
+
+
+/// Automated tests for gnsstk::XvtFit and the fitted Xvt in OrbitData.
+class XvtFit_T
+{
+public:
+   XvtFit_T();
+      /// Check the default state and parameter checking.
+   unsigned constructorTest();
+      /// Check the fit of a GPS LNAV ephemeris against the analytic model.
+   unsigned fitGPSTest();
+      /// Check the fit of a GLONASS FDMA ephemeris.
+   unsigned fitGLOTest();
+      /// Make sure fits outside the tolerances aren't used.
+   unsigned toleranceTest();
+      /// Check OrbitData::getXvtFitted() and clearXvtFit().
+   unsigned getXvtFittedTest();
+      /// Check NavLibrary::setXvtFit().
+   unsigned navLibraryTest();
+
+      /** Compare fitted against analytic Xvt for orb every step
+       * seconds over the fit interval.
+       * @return false if any time failed. */
+   bool compare(gnsstk::OrbitData& orb, const gnsstk::XvtFit& fit,
+                double step, XvtErrors& errs);
+      /// Make a GLONASS ephemeris (from GLOFNavEph_T).
+   std::shared_ptr<gnsstk::GLOFNavEph> makeGLO();
+
+   SyntheticNavData synth;
+};
+
+
+XvtFit_T ::
+XvtFit_T()
+{
+}
+
+
+bool XvtFit_T ::
+compare(gnsstk::OrbitData& orb, const gnsstk::XvtFit& fit, double step,
+        XvtErrors& errs)
+{
+   double span = fit.getEnd() - fit.getBegin();
+   for (double sec = 0; sec <= span; sec += step)
+   {
+      gnsstk::CommonTime when(fit.getBegin() + sec);
+      gnsstk::Xvt exp, got;
+      if (!orb.getXvt(when, exp) || !fit.eval(when, got) ||
+          (exp.frame != got.frame) || (exp.health != got.health))
+      {
+         return false;
+      }
+      errs.add(exp, got);
+   }
+   return true;
+}
+
+
+std::shared_ptr<gnsstk::GLOFNavEph> XvtFit_T ::
+makeGLO()
+{
+   std::shared_ptr<gnsstk::GLOFNavEph> eph =
+      std::make_shared<gnsstk::GLOFNavEph>();
+   eph->pos[0] = 15553.6342773;
+   eph->pos[1] = -19901.1298828;
+   eph->pos[2] = 3553.3354492200001;
+   eph->vel[0] = -0.41938495636000001;
+   eph->vel[1] = 0.32419204711900002;
+   eph->vel[2] = 3.5266609191899998;
+   eph->acc[0] = 0;
+   eph->acc[1] = -9.3132257461499999e-10;
+   eph->acc[2] = -1.86264514923e-09;
+   eph->clkBias = 5.0653703510800001e-05;
+   eph->freqBias = 1.8189894035500001e-12;
+   eph->health = gnsstk::SVHealth::Healthy;
+   eph->Toe = gnsstk::CivilTime(2006,10,1,0,15,0,gnsstk::TimeSystem::GLO);
+   eph->timeStamp = eph->Toe - 900.0;
+   eph->interval = 30;
+   eph->fixFit();
+   return eph;
+}
+
+
+unsigned XvtFit_T ::
+constructorTest()
+{
+   TUDEF("XvtFit", "XvtFit");
+   gnsstk::XvtFit uut;
+   gnsstk::Xvt xvt;
+   TUASSERTE(bool, false, uut.isValid());
+   TUASSERTE(size_t, 0, uut.getNumSegments());
+   TUASSERTE(bool, false, uut.eval(synth.t0, xvt));
+   TUTHROW(gnsstk::XvtFit(0.0));
+   TUTHROW(gnsstk::XvtFit(-1.0));
+   TURETURN();
+}
+
+
+unsigned XvtFit_T ::
+fitGPSTest()
+{
+   TUDEF("XvtFit", "fit");
+   for (unsigned long prn = 1; prn <= SyntheticNavData::numPRN; prn++)
+   {
+      gnsstk::NavDataPtr ndp = synth.makeEph(prn, synth.t0 + 7200.0);
+      gnsstk::GPSLNavEph *eph = dynamic_cast<gnsstk::GPSLNavEph*>(ndp.get());
+      gnsstk::XvtFit uut;
+      TUASSERTE(bool, true, uut.fit(*eph, eph->beginFit, eph->endFit));
+      TUASSERTE(bool, true, uut.isValid());
+      TUASSERTE(gnsstk::CommonTime, eph->beginFit, uut.getBegin());
+      TUASSERTE(gnsstk::CommonTime, eph->endFit, uut.getEnd());
+         // 4 hour fit interval in one hour segments
+      TUASSERTE(size_t, 4, uut.getNumSegments());
+      TUASSERT(uut.getMaxPosError() <= gnsstk::XvtFit::defaultPosTol);
+      TUASSERT(uut.getMaxVelError() <= gnsstk::XvtFit::defaultVelTol);
+      TUASSERT(uut.getMaxClkError() <= gnsstk::XvtFit::defaultClkTol);
+         // Check at times other than the ones fit() checked.
+      XvtErrors errs;
+      TUASSERTE(bool, true, compare(*eph, uut, 7.3, errs));
+      TUASSERT(errs.pos <= gnsstk::XvtFit::defaultPosTol);
+      TUASSERT(errs.vel <= gnsstk::XvtFit::defaultVelTol);
+      TUASSERT(errs.clk <= gnsstk::XvtFit::defaultClkTol);
+         // The documented typical accuracy.
+      TUASSERT(errs.pos < 1e-6);
+      TUASSERT(errs.vel < 1e-10);
+         // outside the fit interval
+      gnsstk::Xvt xvt;
+      TUASSERTE(bool, false, uut.eval(eph->beginFit - 1.0, xvt));
+      TUASSERTE(bool, false, uut.eval(eph->endFit + 1.0, xvt));
+      TUASSERTE(bool, true, uut.eval(eph->endFit, xvt));
+         // wrong time system
+      gnsstk::CommonTime when(eph->Toe);
+      when.setTimeSystem(gnsstk::TimeSystem::UTC);
+      TUASSERTE(bool, false, uut.eval(when, xvt));
+      when.setTimeSystem(gnsstk::TimeSystem::Any);
+      TUASSERTE(bool, true, uut.eval(when, xvt));
+   }
+      // empty and mismatched intervals
+   gnsstk::NavDataPtr ndp = synth.makeEph(1, synth.t0 + 7200.0);
+   gnsstk::GPSLNavEph *eph = dynamic_cast<gnsstk::GPSLNavEph*>(ndp.get());
+   gnsstk::XvtFit uut;
+   gnsstk::CommonTime utc(eph->endFit);
+   utc.setTimeSystem(gnsstk::TimeSystem::UTC);
+   TUASSERTE(bool, false, uut.fit(*eph, eph->endFit, eph->beginFit));
+   TUASSERTE(bool, false, uut.fit(*eph, eph->beginFit, eph->beginFit));
+   TUASSERTE(bool, false, uut.fit(*eph, eph->beginFit, utc));
+   TUASSERTE(bool, false, uut.isValid());
+      // unreasonably long interval
+   TUASSERTE(bool, false,
+             uut.fit(*eph, gnsstk::CommonTime::BEGINNING_OF_TIME,
+                     eph->endFit));
+   TUASSERTE(bool, false, uut.isValid());
+   TURETURN();
+}
+
+
+unsigned XvtFit_T ::
+fitGLOTest()
+{
+   TUDEF("XvtFit", "fit");
+   std::shared_ptr<gnsstk::GLOFNavEph> eph = makeGLO();
+   gnsstk::XvtFit uut;
+   TUASSERTE(bool, true, uut.fit(*eph, eph->beginFit, eph->endFit));
+   TUASSERTE(size_t, 1, uut.getNumSegments());
+   XvtErrors errs;
+   TUASSERTE(bool, true, compare(*eph, uut, 3.1, errs));
+   TUASSERT(errs.pos <= gnsstk::XvtFit::defaultPosTol);
+   TUASSERT(errs.vel <= gnsstk::XvtFit::defaultVelTol);
+   TUASSERT(errs.clk <= gnsstk::XvtFit::defaultClkTol);
+   TUASSERT(errs.pos < 1e-4);
+   TUASSERT(errs.vel < 1e-7);
+   TURETURN();
+}
+
+
+unsigned XvtFit_T ::
+toleranceTest()
+{
+   TUDEF("XvtFit", "fit");
+   gnsstk::NavDataPtr ndp = synth.makeEph(2, synth.t0 + 7200.0);
+   gnsstk::GPSLNavEph *eph = dynamic_cast<gnsstk::GPSLNavEph*>(ndp.get());
+   gnsstk::Xvt xvt;
+      // A low degree over long segments isn't accurate enough.
+   gnsstk::XvtFit coarse(7200.0, 6);
+   TUASSERTE(bool, false, coarse.fit(*eph, eph->beginFit, eph->endFit));
+   TUASSERTE(bool, false, coarse.isValid());
+   TUASSERT(coarse.getMaxPosError() > gnsstk::XvtFit::defaultPosTol);
+   TUASSERTE(bool, false, coarse.eval(eph->Toe, xvt));
+      // Accepted with a looser tolerance.
+   gnsstk::XvtFit loose(7200.0, 6, 10.0, 1e-2);
+   TUASSERTE(bool, true, loose.fit(*eph, eph->beginFit, eph->endFit));
+   TUASSERTE(bool, true, loose.eval(eph->Toe, xvt));
+   TURETURN();
+}
+
+
+unsigned XvtFit_T ::
+getXvtFittedTest()
+{
+   TUDEF("OrbitData", "getXvtFitted");
+   gnsstk::NavDataPtr ndp = synth.makeEph(3, synth.t0 + 7200.0);
+   gnsstk::GPSLNavEph *eph = dynamic_cast<gnsstk::GPSLNavEph*>(ndp.get());
+   gnsstk::Xvt exp, got;
+   XvtErrors errs;
+   for (double sec = 0; sec <= 14400.0; sec += 11.0)
+   {
+      gnsstk::CommonTime when(eph->beginFit + sec);
+      TUASSERTE(bool, true, eph->getXvt(when, exp));
+      TUASSERTE(bool, true, eph->getXvtFitted(when, got));
+      errs.add(exp, got);
+   }
+   TUASSERT(errs.pos <= gnsstk::XvtFit::defaultPosTol);
+   TUASSERT(errs.vel <= gnsstk::XvtFit::defaultVelTol);
+   TUASSERT(errs.clk <= gnsstk::XvtFit::defaultClkTol);
+   TUASSERT(errs.pos > 0);
+      // Outside the fit interval, the analytic model is used as is.
+   gnsstk::CommonTime outside(eph->endFit + 3600.0);
+   TUASSERTE(bool, true, eph->getXvt(outside, exp));
+   TUASSERTE(bool, true, eph->getXvtFitted(outside, got));
+   TUASSERTE(gnsstk::Triple, exp.x, got.x);
+      // Likewise for a non-default ObsID.
+   gnsstk::ObsID oid(gnsstk::ObservationType::Phase, gnsstk::CarrierBand::L1,
+                     gnsstk::TrackingCode::Y);
+   TUASSERTE(bool, true, eph->getXvt(eph->Toe + 1.5, exp, oid));
+   TUASSERTE(bool, true, eph->getXvtFitted(eph->Toe + 1.5, got, oid));
+   TUASSERTE(gnsstk::Triple, exp.x, got.x);
+      // Copies don't share the fit, so changing the orbit of a copy
+      // changes its fitted Xvt.
+   gnsstk::CommonTime when(eph->Toe + 1234.5);
+   TUASSERTE(bool, true, eph->getXvtFitted(when, exp));
+   gnsstk::NavDataPtr copy = ndp->clone();
+   gnsstk::GPSLNavEph *eph2 = dynamic_cast<gnsstk::GPSLNavEph*>(copy.get());
+   eph2->M0 += 0.1;
+   TUASSERTE(bool, true, eph2->getXvtFitted(when, got));
+   TUASSERT(range(exp.x, got.x) > 1000.0);
+      // The fit isn't updated until it's cleared.
+   eph->M0 += 0.1;
+   TUASSERTE(bool, true, eph->getXvtFitted(when, exp));
+   TUASSERT(range(exp.x, got.x) > 1000.0);
+   eph->clearXvtFit();
+   TUASSERTE(bool, true, eph->getXvtFitted(when, exp));
+   TUASSERT(range(exp.x, got.x) < gnsstk::XvtFit::defaultPosTol);
+      // Assignment discards the fit as well.
+   eph->M0 -= 0.1;
+   *eph = *eph2;
+   TUASSERTE(bool, true, eph->getXvtFitted(when, exp));
+   TUASSERT(range(exp.x, got.x) < gnsstk::XvtFit::defaultPosTol);
+      // GLONASS
+   std::shared_ptr<gnsstk::GLOFNavEph> glo = makeGLO();
+   TUASSERTE(bool, true, glo->getXvt(glo->Toe + 300.0, exp));
+   TUASSERTE(bool, true, glo->getXvtFitted(glo->Toe + 300.0, got));
+   TUASSERT(range(exp.x, got.x) < gnsstk::XvtFit::defaultPosTol);
+   TURETURN();
+}
+
+
+unsigned XvtFit_T ::
+navLibraryTest()
+{
+   TUDEF("NavLibrary", "setXvtFit");
+   gnsstk::NavLibrary navLib, fitLib;
+   std::shared_ptr<SyntheticNavFactory> fact =
+      std::make_shared<SyntheticNavFactory>();
+   gnsstk::NavDataFactoryPtr ndfp(fact);
+   synth.fill(*fact);
+   navLib.addFactory(ndfp);
+   fitLib.addFactory(ndfp);
+   TUASSERTE(bool, false, fitLib.getXvtFit());
+   fitLib.setXvtFit(true);
+   TUASSERTE(bool, true, fitLib.getXvtFit());
+   XvtErrors errs;
+   gnsstk::XvtBatch batch;
+   size_t count = 0;
+   for (const auto& when : synth.times)
+   {
+      for (const auto& sat : synth.sats)
+      {
+         gnsstk::Xvt exp, got;
+         bool expOK = navLib.getXvt(sat, when, exp);
+         TUASSERTE(bool, expOK, fitLib.getXvt(sat, when, got));
+         if (expOK)
+         {
+            errs.add(exp, got);
+            count++;
+         }
+      }
+      TUASSERTE(size_t, navLib.getXvt(synth.sats, when, batch, false),
+                fitLib.getXvt(synth.sats, when, batch, false));
+   }
+   TUASSERT(count > 0);
+   TUASSERT(errs.pos <= gnsstk::XvtFit::defaultPosTol);
+   TUASSERT(errs.vel <= gnsstk::XvtFit::defaultVelTol);
+   TUASSERT(errs.clk <= gnsstk::XvtFit::defaultClkTol);
+   TUASSERT(errs.pos > 0);
+   TURETURN();
+}
+
+
+int main()
+{
+   XvtFit_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.constructorTest();
+   errorTotal += testClass.fitGPSTest();
+   errorTotal += testClass.fitGLOTest();
+   errorTotal += testClass.toleranceTest();
+   errorTotal += testClass.getXvtFittedTest();
+   errorTotal += testClass.navLibraryTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
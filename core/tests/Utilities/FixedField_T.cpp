@@ -0,0 +1,320 @@
+//==============================================================================
+//
+//  This file is part of GNSSTk, the ARL:UT GNSS Toolkit.
+//
+//  The GNSSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GNSSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GNSSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2022, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "FixedField.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+   /// Return the bits of a double, so that -0.0 and 0.0 differ.
+static uint64_t bits(double d)
+{
+   uint64_t rv;
+   memcpy(&rv, &d, sizeof(rv));
+   return rv;
+}
+
+   /// Return the strtod value of s with any FORTRAN exponent replaced.
+static double cDouble(const string& s)
+{
+   string copy(s);
+   string::size_type pos = copy.find_first_of("Dd");
+   if (pos != string::npos)
+      copy[pos] = 'e';
+   return strtod(copy.c_str(), nullptr);
+}
+
+   /// Assert that FixedField and strtod give exactly the same double.
+#define DBLASSERT(STR)                                                  \
+   {                                                                    \
+      string str(STR);                                                  \
+      TUASSERTE(uint64_t, bits(cDouble(str)),                           \
+                bits(gnsstk::FixedField::asDouble(                      \
+                        str.data(), str.data()+str.size())));           \
+   }
+
+   /// Assert that FixedField and strtol give the same integer.
+#define INTASSERT(STR)                                                  \
+   {                                                                    \
+      string str(STR);                                                  \
+      TUASSERTE(long, strtol(str.c_str(), nullptr, 10),                 \
+                gnsstk::FixedField::asInt(str.data(),                   \
+                                          str.data()+str.size()));      \
+   }
+
+
+class FixedField_T
+{
+public:
+   unsigned asIntTest();
+   unsigned asDoubleTest();
+   unsigned impliedTest();
+   unsigned stringTest();
+   unsigned randomTest();
+};
+
+
+unsigned FixedField_T ::
+asIntTest()
+{
+   TUDEF("FixedField", "asInt");
+   INTASSERT("");
+   INTASSERT("     ");
+   INTASSERT("   12");
+   INTASSERT("  -12");
+   INTASSERT("  +12");
+   INTASSERT("12   ");
+   INTASSERT(" 1 2 ");
+   INTASSERT("0012");
+   INTASSERT("12.7");
+   INTASSERT("-");
+   INTASSERT("x12");
+   INTASSERT("\t 7");
+   INTASSERT("123456789012345678");
+   INTASSERT("-9223372036854775808");
+   INTASSERT("9223372036854775807");
+   INTASSERT("99999999999999999999999");
+   INTASSERT("-99999999999999999999999");
+      // only the characters in the range are used
+   string s("  1234");
+   TUASSERTE(long, 12, gnsstk::FixedField::asInt(s.data(), s.data()+4));
+   TURETURN();
+}
+
+
+unsigned FixedField_T ::
+asDoubleTest()
+{
+   TUDEF("FixedField", "asDouble");
+      // blank-as-zero and other things that aren't numbers
+   DBLASSERT("");
+   DBLASSERT("              ");
+   DBLASSERT("-");
+   DBLASSERT(".");
+   DBLASSERT("-.");
+   DBLASSERT("  abc");
+   DBLASSERT("E5");
+      // typical fields
+   DBLASSERT("  23619095.450");
+   DBLASSERT(" -1234567.891");
+   DBLASSERT("        -0.000");
+   DBLASSERT("  -0");
+   DBLASSERT("   0.000D+00");
+   DBLASSERT("  -12345.678901");
+   DBLASSERT("  0.39580259472D-08");
+   DBLASSERT(" -.318323145621D-11");
+   DBLASSERT(" .123456789012D+05");
+   DBLASSERT("-1.234567890123E-09");
+   DBLASSERT("0.000000000000E+00");
+   DBLASSERT("    1.75d+2");
+   DBLASSERT("5.153651277542D+03");
+      // termination the same as strtod
+   DBLASSERT("1.5e");
+   DBLASSERT("1.5D+");
+   DBLASSERT("1.5e+-3");
+   DBLASSERT("1.2.3");
+   DBLASSERT("1.5 e3");
+   DBLASSERT("12 34");
+      // values that need more than the fast path
+   DBLASSERT("0.1234567890123456789012345");
+   DBLASSERT("12345678901234567890123456789");
+   DBLASSERT("9007199254740993");
+   DBLASSERT("1.7976931348623157e308");
+   DBLASSERT("1e309");
+   DBLASSERT("-1e309");
+   DBLASSERT("4.9406564584124654e-324");
+   DBLASSERT("1e-400");
+   DBLASSERT("1D99999999999999");
+   DBLASSERT("0e99999999999999");
+   DBLASSERT("-inf");
+   DBLASSERT("nan");
+   DBLASSERT("0x1p3");
+   TURETURN();
+}
+
+
+unsigned FixedField_T ::
+impliedTest()
+{
+   TUDEF("FixedField", "asDouble");
+   string s;
+   s = "   12345";
+   TUASSERTE(uint64_t, bits(12.345),
+             bits(gnsstk::FixedField::asDouble(s.data(), s.data()+s.size(),
+                                               3)));
+   s = "  -12345";
+   TUASSERTE(uint64_t, bits(-1.2345),
+             bits(gnsstk::FixedField::asDouble(s.data(), s.data()+s.size(),
+                                               4)));
+      // an explicit decimal point overrides the implied one
+   s = "  12.345";
+   TUASSERTE(uint64_t, bits(12.345),
+             bits(gnsstk::FixedField::asDouble(s.data(), s.data()+s.size(),
+                                               1)));
+      // the implied decimal applies before the exponent
+   s = "  12345E2";
+   TUASSERTE(uint64_t, bits(1234.5),
+             bits(gnsstk::FixedField::asDouble(s.data(), s.data()+s.size(),
+                                               3)));
+   s = "        ";
+   TUASSERTE(uint64_t, bits(0.0),
+             bits(gnsstk::FixedField::asDouble(s.data(), s.data()+s.size(),
+                                               3)));
+   TURETURN();
+}
+
+
+unsigned FixedField_T ::
+stringTest()
+{
+   TUDEF("FixedField", "asInt(string)");
+   string line(" 12 345 -6.5D+01");
+   TUASSERTE(long, 12, gnsstk::FixedField::asInt(line, 0, 3));
+   TUASSERTE(long, 345, gnsstk::FixedField::asInt(line, 3, 4));
+   TUASSERTE(long, 0, gnsstk::FixedField::asInt(line, line.size(), 4));
+   TUASSERTE(long, 12, gnsstk::FixedField::asInt(line, 0));
+   try
+   {
+      gnsstk::FixedField::asInt(line, line.size()+1, 2);
+      TUFAIL("Expected std::out_of_range");
+   }
+   catch (std::out_of_range&)
+   {
+      TUPASS("std::out_of_range");
+   }
+   TUCSM("asDouble(string)");
+   TUASSERTFE(-65.0, gnsstk::FixedField::asDouble(line, 7, 9));
+      // clipped at the end of the string
+   TUASSERTFE(-65.0, gnsstk::FixedField::asDouble(line, 7, 19));
+   TUASSERTFE(345.0, gnsstk::FixedField::asDouble(line, 3, 4));
+   TUASSERTFE(3.45, gnsstk::FixedField::asDouble(line, 3, 4, 2));
+   try
+   {
+      gnsstk::FixedField::asDouble(line, line.size()+1, 2);
+      TUFAIL("Expected std::out_of_range");
+   }
+   catch (std::out_of_range&)
+   {
+      TUPASS("std::out_of_range");
+   }
+   TURETURN();
+}
+
+
+unsigned FixedField_T ::
+randomTest()
+{
+   TUDEF("FixedField", "asDouble");
+      // Compare with strtod for values formatted the way the
+      // supported file formats do, plus random junk.
+   std::mt19937_64 rng(20221017);
+   const char junk[] = "0123456789000.   -+eEdD";
+   const char *formats[] = { "%*.*e", "%*.*f", "%*.*g" };
+   unsigned failures = 0;
+   for (unsigned i = 0; i < 200000; i++)
+   {
+      char buf[128];
+      if (i % 4 == 0)
+      {
+         unsigned len = rng() % 25;
+         for (unsigned j = 0; j < len; j++)
+            buf[j] = junk[rng() % (sizeof(junk)-1)];
+         buf[len] = 0;
+      }
+      else
+      {
+         double val = ldexp(static_cast<double>(rng() >> 11),
+                            static_cast<int>(rng() % 200) - 150);
+         if (rng() & 1)
+            val = -val;
+         snprintf(buf, sizeof(buf), formats[rng() % 3],
+                  static_cast<int>(rng() % 20),
+                  static_cast<int>(rng() % 20), val);
+         if (rng() & 1)
+         {
+            char *e = strchr(buf, 'e');
+            if (e)
+               *e = 'D';
+         }
+      }
+      string str(buf);
+      double expect = cDouble(str);
+      double got = gnsstk::FixedField::asDouble(str.data(),
+                                                str.data()+str.size());
+      if ((bits(expect) != bits(got)) ||
+          (strtol(buf, nullptr, 10) !=
+           gnsstk::FixedField::asInt(str.data(), str.data()+str.size())))
+      {
+         failures++;
+            // just report the first one
+         if (failures == 1)
+         {
+            TUFAIL("Mismatch converting \"" + str + "\"");
+         }
+      }
+   }
+   TUASSERTE(unsigned, 0, failures);
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   FixedField_T testClass;
+
+   errorTotal += testClass.asIntTest();
+   errorTotal += testClass.asDoubleTest();
+   errorTotal += testClass.impliedTest();
+   errorTotal += testClass.stringTest();
+   errorTotal += testClass.randomTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}